@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier: GPL-2.0-only WITH Linux-syscall-note */
+/*
+ * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _UAPI_IPA_HW_STATS_SNAP_H_
+#define _UAPI_IPA_HW_STATS_SNAP_H_
+
+#include <linux/types.h>
+#include <linux/msm_ipa.h>
+
+/*
+ * Layout of the IPA HW statistics snapshots, as mmapped read-only from the
+ * hw_stats/snapshot debugfs file. All the members are naturally aligned so
+ * the layout is the same for 32 and 64 bit readers.
+ */
+
+#define IPA_HW_STATS_SNAP_VER 2
+
+/* pipes covered by the per pipe arrays, indexed by IPA pipe number */
+#define IPA_HW_STATS_SNAP_PIPES_NUM 36
+
+/**
+ * struct ipa_hw_stats_snap_cnt - quota or tethering counters
+ * @num_ipv4_bytes: IPv4 bytes
+ * @num_ipv6_bytes: IPv6 bytes
+ * @num_ipv4_pkts: IPv4 packets
+ * @num_ipv6_pkts: IPv6 packets
+ */
+struct ipa_hw_stats_snap_cnt {
+	__u64 num_ipv4_bytes;
+	__u64 num_ipv6_bytes;
+	__u64 num_ipv4_pkts;
+	__u64 num_ipv6_pkts;
+};
+
+/**
+ * struct ipa_hw_stats_snap_drop - drop counters
+ * @drop_packet_cnt: dropped packets
+ * @drop_byte_cnt: dropped bytes
+ */
+struct ipa_hw_stats_snap_drop {
+	__u32 drop_packet_cnt;
+	__u32 drop_byte_cnt;
+};
+
+/**
+ * struct ipa_hw_stats_snap - HW statistics snapshot
+ * @seq: snapshot sequence number, starts at 1
+ * @ts_ns: CLOCK_MONOTONIC time the snapshot was read, in ns
+ * @quota: per pipe quota stats accumulated since the first snapshot
+ * @teth: per producer, consumer pipes tethering stats accumulated since the
+ *	first snapshot
+ * @drop: per pipe drop stats accumulated since the first snapshot
+ * @fnr: FnR counters as read from HW, entry n is counter id n + 1
+ */
+struct ipa_hw_stats_snap {
+	__u64 seq;
+	__u64 ts_ns;
+	struct ipa_hw_stats_snap_cnt quota[IPA_HW_STATS_SNAP_PIPES_NUM];
+	struct ipa_hw_stats_snap_cnt
+		teth[IPA_HW_STATS_SNAP_PIPES_NUM][IPA_HW_STATS_SNAP_PIPES_NUM];
+	struct ipa_hw_stats_snap_drop drop[IPA_HW_STATS_SNAP_PIPES_NUM];
+	struct ipa_flt_rt_stats fnr[IPA_MAX_FLT_RT_CNT_INDEX];
+};
+
+/**
+ * struct ipa_hw_stats_snap_map - snapshots double buffer
+ * @version: IPA_HW_STATS_SNAP_VER
+ * @size: size of this structure
+ * @seq: sequence of the last published snapshot, stored in @snap[@seq & 1]
+ * @snap: snapshot buffers
+ *
+ * Readers load @seq, copy @snap[@seq & 1] and retry if @seq changed
+ * meanwhile, the writer only updates the other buffer before bumping @seq.
+ */
+struct ipa_hw_stats_snap_map {
+	__u32 version;
+	__u32 size;
+	__u64 seq;
+	struct ipa_hw_stats_snap snap[2];
+};
+
+#endif /* _UAPI_IPA_HW_STATS_SNAP_H_ */
@@ -4961,6 +4961,14 @@ static int ipa3_q6_clean_q6_tables(void)
 		return -EFAULT;
 	}
 
+	/*
+	 * The flt/rt headers were rewritten behind the commit shadows, the
+	 * next commit must write the full image again.
+	 */
+	mutex_lock(&ipa3_ctx->lock);
+	ipa3_fltrt_shadow_invalidate_all();
+	mutex_unlock(&ipa3_ctx->lock);
+
 	/*
 	 * SRAM memory not allocated to hash tables. Cleaning the of hash table
 	 * operation not supported.
@@ -6016,6 +6024,9 @@ static int ipa3_setup_apps_pipes(void)
 	}
 	IPADBG("Apps to IPA cmd pipe is connected\n");
 
+	/* flt/rt SRAM is re-initialized, previously committed images are lost */
+	ipa3_fltrt_shadow_invalidate_all();
+
 	IPADBG("Will initialize SRAM\n");
 	ipa3_ctx->ctrl->ipa_init_sram();
 	IPADBG("SRAM initialized\n");
@@ -7788,6 +7799,7 @@ static int ipa3_post_init(const struct ipa3_plat_drv_res *resource_p,
 				WARN_ON(lcl_tbl);
 				if (likely(lcl_tbl)) {
 					lcl_tbl->tbl = flt_tbl;
+					lcl_tbl->pipe = i;
 					/* Add to the head of the list, to be pulled first */
 					list_add(&lcl_tbl->link,
 						 &ipa3_ctx->flt_tbl_nhash_lcl_list[ip]);
@@ -7798,6 +7810,7 @@ static int ipa3_post_init(const struct ipa3_plat_drv_res *resource_p,
 			/* Init force sys to false */
 			flt_tbl->force_sys[IPA_RULE_HASHABLE] = false;
 			flt_tbl->force_sys[IPA_RULE_NON_HASHABLE] = false;
+			flt_tbl->dirty = true;
 
 			flt_tbl->rule_ids = &ipa3_ctx->flt_rule_ids[ip];
 		}
@@ -8944,11 +8957,6 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	ipa3_ctx->stats.page_recycle_stats[1].tmp_alloc = 0;
 	memset(ipa3_ctx->stats.page_recycle_cnt, 0,
 		sizeof(ipa3_ctx->stats.page_recycle_cnt));
-	ipa3_ctx->stats.num_sort_tasklet_sched[0] = 0;
-	ipa3_ctx->stats.num_sort_tasklet_sched[1] = 0;
-	ipa3_ctx->stats.num_sort_tasklet_sched[2] = 0;
-	ipa3_ctx->stats.num_of_times_wq_reschd = 0;
-	ipa3_ctx->stats.page_recycle_cnt_in_tasklet = 0;
 	ipa3_ctx->skip_uc_pipe_reset = resource_p->skip_uc_pipe_reset;
 	ipa3_ctx->tethered_flow_control = resource_p->tethered_flow_control;
 	ipa3_ctx->ee = resource_p->ee;
@@ -9165,9 +9173,12 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	/* Initialize Page poll threshold. */
 	ipa3_ctx->page_poll_threshold = IPA_PAGE_POLL_DEFAULT_THRESHOLD;
 
-	/*Initialize number napi without prealloc buff*/
-	ipa3_ctx->ipa_max_napi_sort_page_thrshld = IPA_MAX_NAPI_SORT_PAGE_THRSHLD;
-	ipa3_ctx->page_wq_reschd_time = IPA_MAX_PAGE_WQ_RESCHED_TIME;
+	/* Initialize TX doorbell batching policy. */
+	ipa3_ctx->tx_db_batch_max = IPA_TX_DB_BATCH_DEFAULT;
+	ipa3_ctx->tx_db_deadline_us = IPA_TX_DB_DEADLINE_DEFAULT_US;
+
+	/* Under budget NAPI polls before going back to interrupt mode. */
+	ipa3_ctx->rx_intr_hyst_us = IPA_RX_INTR_HYST_DEFAULT_US;
 
 	/* Use common page pool for Def/Coal pipe. */
 	if (ipa3_ctx->ipa_hw_type >= IPA_HW_v5_1)
@@ -9360,8 +9371,10 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 			&ipa3_ctx->hdr_proc_ctx_tbl.head_free_offset_list[i]);
 	}
 	INIT_LIST_HEAD(&ipa3_ctx->rt_tbl_set[IPA_IP_v4].head_rt_tbl_list);
+	hash_init(ipa3_ctx->rt_tbl_set[IPA_IP_v4].name_ht);
 	idr_init(&ipa3_ctx->rt_tbl_set[IPA_IP_v4].rule_ids);
 	INIT_LIST_HEAD(&ipa3_ctx->rt_tbl_set[IPA_IP_v6].head_rt_tbl_list);
+	hash_init(ipa3_ctx->rt_tbl_set[IPA_IP_v6].name_ht);
 	idr_init(&ipa3_ctx->rt_tbl_set[IPA_IP_v6].rule_ids);
 
 	rset = &ipa3_ctx->reap_rt_tbl_set[IPA_IP_v4];
@@ -12028,6 +12041,7 @@ static void __exit ipa_module_exit(void)
 		pci_unregister_driver(&ipa_pci_driver);
 	platform_driver_unregister(&ipa_plat_drv);
 	if(ipa3_ctx->hw_stats) {
+		ipa_hw_stats_snap_cleanup();
 		kfree(ipa3_ctx->hw_stats);
 		ipa3_ctx->hw_stats = NULL;
 	}
@@ -1502,6 +1502,77 @@ bail:
 	return res;
 }
 
+/* non-hash filter tables SRAM placement, lowest priority first */
+static int ipa3_print_flt_sram_placement(enum ipa_ip_type ip,
+	struct ipa3_fltrt_cmt_shadow *shadow, int ofst)
+{
+	struct ipa3_flt_tbl_nhash_lcl *lcl_tbl;
+	struct ipa3_flt_tbl *tbl;
+	u64 total = 0, lcl = 0;
+	bool in_sram;
+	int nbytes = 0;
+
+	list_for_each_entry(lcl_tbl, &ipa3_ctx->flt_tbl_nhash_lcl_list[ip],
+		link) {
+		tbl = lcl_tbl->tbl;
+		in_sram = !tbl->in_sys[IPA_RULE_NON_HASHABLE] &&
+			!tbl->force_sys[IPA_RULE_NON_HASHABLE];
+		total += lcl_tbl->hits;
+		if (in_sram)
+			lcl += lcl_tbl->hits;
+		nbytes += scnprintf(dbg_buff + ofst + nbytes,
+			IPA_MAX_MSG_LEN - ofst - nbytes,
+			"  pipe=%d sz=%u hits=%llu %s%s\n",
+			lcl_tbl->pipe, tbl->sz[IPA_RULE_NON_HASHABLE],
+			lcl_tbl->hits, in_sram ? "sram" : "ddr",
+			lcl_tbl->pinned ? " pinned" : "");
+	}
+
+	nbytes += scnprintf(dbg_buff + ofst + nbytes,
+		IPA_MAX_MSG_LEN - ofst - nbytes,
+		"  sram_ranks=%u sram_demoted=%u sram_hit_pct=%llu\n",
+		shadow->sram_ranks, shadow->sram_demoted,
+		total ? div64_u64(lcl * 100, total) : 0);
+
+	return nbytes;
+}
+
+static ssize_t ipa3_read_fltrt_cmt_stats(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa3_fltrt_cmt_shadow *shadow;
+	u32 pool_cnt, pool_hit, pool_miss;
+	int nbytes = 0;
+	int ip, is_flt;
+
+	mutex_lock(&ipa3_ctx->lock);
+	for (is_flt = 1; is_flt >= 0; is_flt--) {
+		for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+			shadow = is_flt ? &ipa3_ctx->flt_cmt_shadow[ip] :
+				&ipa3_ctx->rt_cmt_shadow[ip];
+			nbytes += scnprintf(dbg_buff + nbytes,
+				IPA_MAX_MSG_LEN - nbytes,
+				"%s v%d: commits=%u tbls_gen=%u tbls_reused=%u dma_skipped=%u last_usec=%u max_usec=%u\n",
+				is_flt ? "flt" : "rt",
+				(ip == IPA_IP_v4) ? 4 : 6,
+				shadow->commits, shadow->tbls_gen,
+				shadow->tbls_reused, shadow->dma_skipped,
+				shadow->last_usec, shadow->max_usec);
+			if (is_flt)
+				nbytes += ipa3_print_flt_sram_placement(ip,
+					shadow, nbytes);
+		}
+	}
+	mutex_unlock(&ipa3_ctx->lock);
+
+	ipahal_fltrt_sys_tbl_pool_stats(&pool_cnt, &pool_hit, &pool_miss);
+	nbytes += scnprintf(dbg_buff + nbytes, IPA_MAX_MSG_LEN - nbytes,
+		"sys tbl pool: cnt=%u hit=%u miss=%u\n",
+		pool_cnt, pool_hit, pool_miss);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+}
+
 static ssize_t ipa3_read_stats(struct file *file, char __user *ubuf,
 		size_t count, loff_t *ppos)
 {
@@ -1613,32 +1684,30 @@ static ssize_t ipa3_read_odlstats(struct file *file, char __user *ubuf,
 static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		char __user *ubuf, size_t count, loff_t *ppos)
 {
+	static const char * const pipe_str[] = { "COAL", "DEF", "LL" };
+	struct ipa3_page_recycle_stats *stats;
 	int nbytes;
 	int cnt = 0, i = 0, k = 0;
 
-	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
-			"COAL : Total number of packets replenished =%llu\n"
-			"COAL : Number of page recycled packets  =%llu\n"
-			"COAL : Number of tmp alloc packets  =%llu\n"
-			"COAL  : Number of times tasklet scheduled  =%llu\n"
-			"DEF  : Total number of packets replenished =%llu\n"
-			"DEF  : Number of page recycled packets =%llu\n"
-			"DEF  : Number of tmp alloc packets  =%llu\n"
-			"DEF  : Number of times tasklet scheduled  =%llu\n"
-			"COMMON  : Number of page recycled in tasklet  =%llu\n"
-			"COMMON  : Number of times free pages not found in tasklet =%llu\n",
-			ipa3_ctx->stats.page_recycle_stats[0].total_replenished,
-			ipa3_ctx->stats.page_recycle_stats[0].page_recycled,
-			ipa3_ctx->stats.page_recycle_stats[0].tmp_alloc,
-			ipa3_ctx->stats.num_sort_tasklet_sched[0],
-			ipa3_ctx->stats.page_recycle_stats[1].total_replenished,
-			ipa3_ctx->stats.page_recycle_stats[1].page_recycled,
-			ipa3_ctx->stats.page_recycle_stats[1].tmp_alloc,
-			ipa3_ctx->stats.num_sort_tasklet_sched[1],
-			ipa3_ctx->stats.page_recycle_cnt_in_tasklet,
-			ipa3_ctx->stats.num_of_times_wq_reschd);
-
-	cnt += nbytes;
+	for (k = 0; k < ARRAY_SIZE(pipe_str); k++) {
+		stats = &ipa3_ctx->stats.page_recycle_stats[k];
+		nbytes = scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+			"%s : Total number of packets replenished =%llu\n"
+			"%s : Number of page recycled packets =%llu (%llu%%)\n"
+			"%s : Number of tmp alloc packets =%llu (%llu%%)\n"
+			"%s : Number of times ring head was busy =%llu\n",
+			pipe_str[k], stats->total_replenished,
+			pipe_str[k], stats->page_recycled,
+			stats->total_replenished ?
+			div64_u64(stats->page_recycled * 100,
+				stats->total_replenished) : 0,
+			pipe_str[k], stats->tmp_alloc,
+			stats->total_replenished ?
+			div64_u64(stats->tmp_alloc * 100,
+				stats->total_replenished) : 0,
+			pipe_str[k], stats->ring_busy);
+		cnt += nbytes;
+	}
 
 	for (k = 0; k < 2; k++) {
 		for (i = 0; i < ipa3_ctx->page_poll_threshold; i++) {
@@ -2590,6 +2659,42 @@ ret:
 	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
 }
 
+static ssize_t ipa3_pm_read_governor(struct file *file, char __user *ubuf,
+		size_t count, loff_t *ppos)
+{
+	int result, cnt = 0;
+
+	result = ipa_pm_gov_stat(dbg_buff, IPA_MAX_MSG_LEN);
+	if (result < 0) {
+		cnt += scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+				"Error in printing PM governor stat %d\n", result);
+		goto ret;
+	}
+	cnt += result;
+ret:
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
+static ssize_t ipa3_pm_write_governor(struct file *file,
+	const char __user *buf, size_t count, loff_t *ppos)
+{
+	int ret;
+	bool enable;
+
+	if (count >= sizeof(dbg_buff))
+		return -EFAULT;
+
+	ret = kstrtobool_from_user(buf, count, &enable);
+	if (ret)
+		return ret;
+
+	ret = ipa_pm_set_predictive(enable);
+	if (ret)
+		return ret;
+
+	return count;
+}
+
 static ssize_t ipa3_read_ipahal_regs(struct file *file, char __user *ubuf,
 		size_t count, loff_t *ppos)
 {
@@ -3080,98 +3185,186 @@ static ssize_t ipa3_enable_ipc_low(struct file *file,
 	return count;
 }
 
-static ssize_t ipa3_read_ipa_max_napi_sort_page_thrshld(struct file *file,
+static ssize_t ipa3_read_page_poll_threshold(struct file *file,
 	char __user *buf, size_t count, loff_t *ppos) {
 
 	int nbytes;
 	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
-				"page max napi without free page = %d\n",
-				ipa3_ctx->ipa_max_napi_sort_page_thrshld);
+				"Page Poll Threshold = %d\n",
+				ipa3_ctx->page_poll_threshold);
 	return simple_read_from_buffer(buf, count, ppos, dbg_buff, nbytes);
 
 }
-
-static ssize_t ipa3_write_ipa_max_napi_sort_page_thrshld(struct file *file,
+static ssize_t ipa3_write_page_poll_threshold(struct file *file,
 	const char __user *buf, size_t count, loff_t *ppos) {
 
 	int ret;
-	u8 ipa_max_napi_sort_page_thrshld = 0;
+	u8 page_poll_threshold =0;
 
 	if (count >= sizeof(dbg_buff))
 		return -EFAULT;
 
-	ret = kstrtou8_from_user(buf, count, 0, &ipa_max_napi_sort_page_thrshld);
+	ret = kstrtou8_from_user(buf, count, 0, &page_poll_threshold);
 	if(ret)
 		return ret;
 
-	ipa3_ctx->ipa_max_napi_sort_page_thrshld = ipa_max_napi_sort_page_thrshld;
+	if(page_poll_threshold != 0 &&
+		page_poll_threshold <= IPA_PAGE_POLL_THRESHOLD_MAX)
+		ipa3_ctx->page_poll_threshold = page_poll_threshold;
+	else
+		IPAERR("Invalid value \n");
 
-	IPADBG("napi cnt without prealloc pages = %d", ipa3_ctx->ipa_max_napi_sort_page_thrshld);
+	IPADBG("Updated page poll threshold = %d", ipa3_ctx->page_poll_threshold);
 
 	return count;
 }
 
-static ssize_t ipa3_read_page_wq_reschd_time(struct file *file,
-	char __user *buf, size_t count, loff_t *ppos) {
+static ssize_t ipa3_read_tx_db_stats(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa3_tx_db_stats *stats;
+	struct ipa3_ep_context *ep;
+	int nbytes;
+	int cnt = 0;
+	int i, b;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		ep = &ipa3_ctx->ep[i];
+		if (!ep->valid || !ep->sys || !IPA_CLIENT_IS_PROD(ep->client))
+			continue;
+
+		stats = &ep->sys->db_stats;
+		nbytes = scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+			"%s : pkts=%llu db=%llu (%llu per 100 pkts) deadline=%llu\n",
+			ipa_clients_strings[ep->client], stats->pkts, stats->db,
+			stats->pkts ? div64_u64(stats->db * 100, stats->pkts) : 0,
+			stats->db_deadline);
+		cnt += nbytes;
 
+		for (b = 0; b < IPA_TX_DB_BATCH_MAX; b++) {
+			if (!stats->batch_hist[b])
+				continue;
+			nbytes = scnprintf(dbg_buff + cnt,
+				IPA_MAX_MSG_LEN - cnt,
+				"%s :   batch[%d]=%llu\n",
+				ipa_clients_strings[ep->client], b + 1,
+				stats->batch_hist[b]);
+			cnt += nbytes;
+		}
+	}
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
+static ssize_t ipa3_read_tx_db_batch(struct file *file,
+	char __user *buf, size_t count, loff_t *ppos)
+{
 	int nbytes;
+
 	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
-				"Page WQ reschduule time = %d\n",
-				ipa3_ctx->page_wq_reschd_time);
+		"TX doorbell batch max = %u deadline = %u usec\n",
+		ipa3_ctx->tx_db_batch_max, ipa3_ctx->tx_db_deadline_us);
 	return simple_read_from_buffer(buf, count, ppos, dbg_buff, nbytes);
-
 }
 
-static ssize_t ipa3_write_page_wq_reschd_time(struct file *file,
-	const char __user *buf, size_t count, loff_t *ppos) {
-
-	int ret;
-	u8 page_wq_reschd_time = 0;
+/* "<batch_max> <deadline_us>", batch_max of 1 rings per packet */
+static ssize_t ipa3_write_tx_db_batch(struct file *file,
+	const char __user *buf, size_t count, loff_t *ppos)
+{
+	u32 batch_max;
+	u32 deadline_us;
 
 	if (count >= sizeof(dbg_buff))
 		return -EFAULT;
 
-	ret = kstrtou8_from_user(buf, count, 0, &page_wq_reschd_time);
-	if(ret)
-		return ret;
+	if (copy_from_user(dbg_buff, buf, count))
+		return -EFAULT;
+	dbg_buff[count] = '\0';
 
-	ipa3_ctx->page_wq_reschd_time = page_wq_reschd_time;
+	if (sscanf(dbg_buff, "%u %u", &batch_max, &deadline_us) != 2 ||
+		!batch_max || batch_max > IPA_TX_DB_BATCH_MAX ||
+		!deadline_us || deadline_us > USEC_PER_MSEC) {
+		IPAERR("Invalid value\n");
+		return -EINVAL;
+	}
 
-	IPADBG("Updated page WQ reschedule time = %d", ipa3_ctx->page_wq_reschd_time);
+	ipa3_ctx->tx_db_batch_max = batch_max;
+	ipa3_ctx->tx_db_deadline_us = deadline_us;
+	IPADBG("Updated TX doorbell batch max = %u deadline = %u usec\n",
+		batch_max, deadline_us);
 
 	return count;
 }
 
-static ssize_t ipa3_read_page_poll_threshold(struct file *file,
-	char __user *buf, size_t count, loff_t *ppos) {
+static ssize_t ipa3_read_rx_lat_stats(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa3_rx_lat_stats *stats;
+	struct ipa3_ep_context *ep;
+	int nbytes;
+	int cnt = 0;
+	int i, b;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		ep = &ipa3_ctx->ep[i];
+		if (!ep->valid || !ep->sys || !IPA_CLIENT_IS_CONS(ep->client))
+			continue;
+
+		stats = &ep->sys->rx_lat;
+		nbytes = scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+			"%s : busy_poll=%llu hyst_polls=%llu\n",
+			ipa_clients_strings[ep->client], stats->busy_poll,
+			stats->hyst_polls);
+		cnt += nbytes;
+
+		for (b = 0; b < IPA_RX_LAT_HIST_BINS; b++) {
+			if (!stats->hist[b])
+				continue;
+			nbytes = scnprintf(dbg_buff + cnt,
+				IPA_MAX_MSG_LEN - cnt,
+				"%s :   irq_to_skb %s %lu usec =%llu\n",
+				ipa_clients_strings[ep->client],
+				b < IPA_RX_LAT_HIST_BINS - 1 ? "<" : ">=",
+				b < IPA_RX_LAT_HIST_BINS - 1 ? BIT(b) : BIT(b - 1),
+				stats->hist[b]);
+			cnt += nbytes;
+		}
+	}
 
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
+static ssize_t ipa3_read_rx_intr_hyst(struct file *file,
+	char __user *buf, size_t count, loff_t *ppos)
+{
 	int nbytes;
+
 	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
-				"Page Poll Threshold = %d\n",
-				ipa3_ctx->page_poll_threshold);
+		"RX interrupt re-enable hysteresis = %u usec\n",
+		ipa3_ctx->rx_intr_hyst_us);
 	return simple_read_from_buffer(buf, count, ppos, dbg_buff, nbytes);
-
 }
-static ssize_t ipa3_write_page_poll_threshold(struct file *file,
-	const char __user *buf, size_t count, loff_t *ppos) {
 
+static ssize_t ipa3_write_rx_intr_hyst(struct file *file,
+	const char __user *buf, size_t count, loff_t *ppos)
+{
 	int ret;
-	u8 page_poll_threshold =0;
+	u32 hyst_us;
 
 	if (count >= sizeof(dbg_buff))
 		return -EFAULT;
 
-	ret = kstrtou8_from_user(buf, count, 0, &page_poll_threshold);
-	if(ret)
+	ret = kstrtou32_from_user(buf, count, 0, &hyst_us);
+	if (ret)
 		return ret;
 
-	if(page_poll_threshold != 0 &&
-		page_poll_threshold <= IPA_PAGE_POLL_THRESHOLD_MAX)
-		ipa3_ctx->page_poll_threshold = page_poll_threshold;
-	else
-		IPAERR("Invalid value \n");
+	if (hyst_us > IPA_RX_INTR_HYST_MAX_US) {
+		IPAERR("Invalid value\n");
+		return -EINVAL;
+	}
 
-	IPADBG("Updated page poll threshold = %d", ipa3_ctx->page_poll_threshold);
+	WRITE_ONCE(ipa3_ctx->rx_intr_hyst_us, hyst_us);
+	IPADBG("Updated RX interrupt hysteresis = %u usec\n", hyst_us);
 
 	return count;
 }
@@ -3349,6 +3542,10 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 			.read = ipa3_read_flt_hw,
 			.open = ipa3_open_dbg,
 		}
+	}, {
+		"fltrt_cmt_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_fltrt_cmt_stats,
+		}
 	}, {
 		"stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_stats,
@@ -3398,6 +3595,11 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 		"pm_ex_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_pm_ex_read_stats,
 		}
+	}, {
+		"pm_governor", IPA_READ_WRITE_MODE, NULL, {
+			.read = ipa3_pm_read_governor,
+			.write = ipa3_pm_write_governor,
+		}
 	}, {
 		"status_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa_status_stats_read,
@@ -3444,18 +3646,26 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 			.write = ipa3_write_page_poll_threshold,
 		}
 	}, {
-		"move_nat_table_to_ddr", IPA_WRITE_ONLY_MODE, NULL,{
-			.write = ipa3_write_nat_table_move,
+		"tx_db_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_tx_db_stats,
+		}
+	}, {
+		"tx_db_batch", IPA_READ_WRITE_MODE, NULL, {
+			.read = ipa3_read_tx_db_batch,
+			.write = ipa3_write_tx_db_batch,
+		}
+	}, {
+		"rx_lat_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_rx_lat_stats,
 		}
 	}, {
-		"page_wq_reschd_time", IPA_READ_WRITE_MODE, NULL, {
-			.read = ipa3_read_page_wq_reschd_time,
-			.write = ipa3_write_page_wq_reschd_time,
+		"rx_intr_hyst", IPA_READ_WRITE_MODE, NULL, {
+			.read = ipa3_read_rx_intr_hyst,
+			.write = ipa3_write_rx_intr_hyst,
 		}
 	}, {
-		"ipa_max_napi_sort_page_thrshld", IPA_READ_WRITE_MODE, NULL, {
-			.read = ipa3_read_ipa_max_napi_sort_page_thrshld,
-			.write = ipa3_write_ipa_max_napi_sort_page_thrshld,
+		"move_nat_table_to_ddr", IPA_WRITE_ONLY_MODE, NULL,{
+			.write = ipa3_write_nat_table_move,
 		}
 	},
 };
@@ -111,6 +111,7 @@ static void ipa3_fast_replenish_rx_cache(struct ipa3_sys_context *sys);
 static void ipa3_replenish_rx_page_cache(struct ipa3_sys_context *sys);
 static void ipa3_wq_page_repl(struct work_struct *work);
 static void ipa3_replenish_rx_page_recycle(struct ipa3_sys_context *sys);
+static void ipa3_first_replenish_rx_page_shared(struct ipa3_sys_context *sys);
 static struct ipa3_rx_pkt_wrapper *ipa3_alloc_rx_pkt_page(gfp_t flag,
 	bool is_tmp_alloc, struct ipa3_sys_context *sys);
 static void ipa3_wq_handle_rx(struct work_struct *work);
@@ -148,9 +149,9 @@ static int ipa_poll_gsi_n_pkt(struct ipa3_sys_context *sys,
 static unsigned long tag_to_pointer_wa(uint64_t tag);
 static uint64_t pointer_to_tag_wa(struct ipa3_tx_pkt_wrapper *tx_pkt);
 static void ipa3_tasklet_rx_notify(unsigned long data);
-static void ipa3_tasklet_find_freepage(unsigned long data);
 static u32 ipa_adjust_ra_buff_base_sz(u32 aggr_byte_limit);
 static int ipa3_rmnet_ll_rx_poll(struct napi_struct *napi_rx, int budget);
+static enum hrtimer_restart ipa3_rx_intr_hyst_timer_fn(struct hrtimer *param);
 
 struct gsi_chan_xfer_notify g_lan_rx_notify[IPA_LAN_NAPI_MAX_FRAMES];
 
@@ -336,6 +337,7 @@ static int ipa3_write_done_common(struct ipa3_sys_context *sys,
 		next_pkt = list_next_entry(tx_pkt, link);
 		list_del(&tx_pkt->link);
 		sys->len--;
+		sys->pm_bytes += tx_pkt->mem.size;
 		if (!tx_pkt->no_unmap_dma) {
 			if (tx_pkt->type != IPA_DATA_DESC_SKB_PAGED) {
 				dma_unmap_single(ipa3_ctx->pdev,
@@ -587,13 +589,84 @@ static void ipa3_send_nop_desc(struct work_struct *work)
 	ipa3_ctx->tag_process_before_gating = true;
 }
 
+/*
+ * Doorbell batching: a packet queued with xmit_more set does not ring the
+ * channel doorbell as long as HW still has earlier descriptors to process,
+ * the batch is below tx_db_batch_max and the deadline timer did not fire.
+ * An idle channel is always kicked right away so sparse traffic does not
+ * pay for the batching. All helpers are called with sys->spinlock held.
+ */
+static bool ipa3_tx_db_needed(struct ipa3_sys_context *sys, u32 num_desc,
+	bool xmit_more)
+{
+	if (!xmit_more || ipa3_ctx->tx_db_batch_max <= 1)
+		return true;
+
+	/* only the descriptors of this packet are queued, HW is idle */
+	if (sys->len == num_desc)
+		return true;
+
+	return sys->db_pending + 1 >= ipa3_ctx->tx_db_batch_max;
+}
+
+static void ipa3_tx_db_rung(struct ipa3_sys_context *sys, u32 batch)
+{
+	batch = clamp_t(u32, batch, 1, IPA_TX_DB_BATCH_MAX);
+	sys->db_stats.db++;
+	sys->db_stats.batch_hist[batch - 1]++;
+	sys->db_pending = 0;
+}
+
+static void ipa3_tx_db_account(struct ipa3_sys_context *sys, bool ring_db)
+{
+	ktime_t time;
+
+	sys->db_stats.pkts++;
+	if (ring_db) {
+		ipa3_tx_db_rung(sys, sys->db_pending + 1);
+		hrtimer_try_to_cancel(&sys->db_batch_timer);
+		return;
+	}
+
+	if (!sys->db_pending++) {
+		time = ktime_set(0, ipa3_ctx->tx_db_deadline_us * NSEC_PER_USEC);
+		hrtimer_start(&sys->db_batch_timer, time,
+			HRTIMER_MODE_REL_SOFT);
+	}
+}
+
+static void ipa3_tx_db_flush(struct ipa3_sys_context *sys)
+{
+	if (!sys->db_pending)
+		return;
+
+	gsi_start_xfer(sys->ep->gsi_chan_hdl);
+	ipa3_tx_db_rung(sys, sys->db_pending);
+}
+
+static enum hrtimer_restart ipa3_tx_db_deadline_timer_fn(
+	struct hrtimer *param)
+{
+	struct ipa3_sys_context *sys = container_of(param,
+		struct ipa3_sys_context, db_batch_timer);
+
+	spin_lock_bh(&sys->spinlock);
+	if (sys->db_pending) {
+		sys->db_stats.db_deadline++;
+		ipa3_tx_db_flush(sys);
+	}
+	spin_unlock_bh(&sys->spinlock);
+
+	return HRTIMER_NORESTART;
+}
 
 /**
- * ipa3_send() - Send multiple descriptors in one HW transaction
+ * __ipa3_send() - Send multiple descriptors in one HW transaction
  * @sys: system pipe context
  * @num_desc: number of packets
  * @desc: packets to send (may be immediate command or data)
  * @in_atomic:  whether caller is in atomic context
+ * @xmit_more: more packets follow, the doorbell may be deferred
  *
  * This function is used for GPI connection.
  * - ipa3_tx_pkt_wrapper will be used for each ipa
@@ -605,10 +678,11 @@ static void ipa3_send_nop_desc(struct work_struct *work)
  *
  * Return codes: 0: success, -EFAULT: failure
  */
-int ipa3_send(struct ipa3_sys_context *sys,
+static int __ipa3_send(struct ipa3_sys_context *sys,
 		u32 num_desc,
 		struct ipa3_desc *desc,
-		bool in_atomic)
+		bool in_atomic,
+		bool xmit_more)
 {
 	struct ipa3_tx_pkt_wrapper *tx_pkt, *tx_pkt_first = NULL;
 	struct ipahal_imm_cmd_pyld *tag_pyld_ret = NULL;
@@ -620,6 +694,7 @@ int ipa3_send(struct ipa3_sys_context *sys,
 	u32 mem_flag = GFP_ATOMIC;
 	const struct ipa_gsi_ep_config *gsi_ep_cfg;
 	bool send_nop = false;
+	bool ring_db;
 	unsigned int max_desc;
 
 	if (unlikely(!in_atomic))
@@ -780,14 +855,17 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		}
 	}
 
-	IPADBG_LOW("ch:%lu queue xfer\n", sys->ep->gsi_chan_hdl);
+	ring_db = ipa3_tx_db_needed(sys, num_desc, xmit_more);
+	IPADBG_LOW("ch:%lu queue xfer ring_db=%d\n", sys->ep->gsi_chan_hdl,
+		ring_db);
 	result = gsi_queue_xfer(sys->ep->gsi_chan_hdl, num_desc,
-			gsi_xfer, true);
+			gsi_xfer, ring_db);
 	if (result != GSI_STATUS_SUCCESS) {
 		IPAERR_RL("GSI xfer failed.\n");
 		result = -EFAULT;
 		goto failure;
 	}
+	ipa3_tx_db_account(sys, ring_db);
 
 	if (send_nop && !sys->nop_pending)
 		sys->nop_pending = true;
@@ -842,6 +920,25 @@ failure:
 	return result;
 }
 
+/**
+ * ipa3_send() - Send multiple descriptors in one HW transaction
+ * @sys: system pipe context
+ * @num_desc: number of packets
+ * @desc: packets to send (may be immediate command or data)
+ * @in_atomic:  whether caller is in atomic context
+ *
+ * Same as __ipa3_send(), the channel doorbell is rung right away.
+ *
+ * Return codes: 0: success, -EFAULT: failure
+ */
+int ipa3_send(struct ipa3_sys_context *sys,
+		u32 num_desc,
+		struct ipa3_desc *desc,
+		bool in_atomic)
+{
+	return __ipa3_send(sys, num_desc, desc, in_atomic, false);
+}
+
 /**
  * ipa3_send_one() - Send a single descriptor
  * @sys:	system pipe context
@@ -1171,6 +1268,21 @@ static int ipa3_rx_switch_to_intr_mode(struct ipa3_sys_context *sys)
 	return ret;
 }
 
+/* account the IRQ to delivery latency of the first poll after an IRQ */
+static void ipa3_rx_lat_record(struct ipa3_sys_context *sys)
+{
+	s64 usec;
+	u32 bin;
+
+	if (!sys->rx_irq_ts)
+		return;
+
+	usec = ktime_us_delta(ktime_get(), sys->rx_irq_ts);
+	sys->rx_irq_ts = 0;
+	bin = usec > 0 ? min_t(u32, fls64(usec), IPA_RX_LAT_HIST_BINS - 1) : 0;
+	sys->rx_lat.hist[bin]++;
+}
+
 /**
  * ipa3_handle_rx() - handle packet reception. This function is executed in the
  * context of a work queue.
@@ -1352,62 +1464,6 @@ fail_setup:
 	return result;
 }
 
-static void ipa3_schd_freepage_work(struct work_struct *work)
-{
-	struct delayed_work *dwork;
-	struct ipa3_sys_context *sys;
-
-	dwork = container_of(work, struct delayed_work, work);
-	sys = container_of(dwork, struct ipa3_sys_context, freepage_work);
-
-	IPADBG_LOW("WQ scheduled, reschedule sort tasklet\n");
-
-	tasklet_schedule(&sys->tasklet_find_freepage);
-}
-
-static void ipa3_tasklet_find_freepage(unsigned long data)
-{
-	struct ipa3_sys_context *sys;
-	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
-	struct ipa3_rx_pkt_wrapper *tmp = NULL;
-	struct page *cur_page;
-	int found_free_page = 0;
-	struct list_head temp_head;
-
-	sys = (struct ipa3_sys_context *)data;
-
-	if(sys->page_recycle_repl == NULL)
-		return;
-	INIT_LIST_HEAD(&temp_head);
-	spin_lock_bh(&sys->common_sys->spinlock);
-	list_for_each_entry_safe(rx_pkt, tmp,
-		&sys->page_recycle_repl->page_repl_head, link) {
-		cur_page = rx_pkt->page_data.page;
-		if (page_ref_count(cur_page) == 1) {
-			/* Found a free page. */
-			list_del_init(&rx_pkt->link);
-			list_add(&rx_pkt->link, &temp_head);
-			found_free_page++;
-		}
-	}
-	if (!found_free_page) {
-		/*Not found free page rescheduling tasklet after 2msec*/
-		IPADBG_LOW("Scheduling WQ not found free pages\n");
-		++ipa3_ctx->stats.num_of_times_wq_reschd;
-		queue_delayed_work(sys->freepage_wq,
-				&sys->freepage_work,
-				msecs_to_jiffies(ipa3_ctx->page_wq_reschd_time));
-	} else {
-		/*Allow to use pre-allocated buffers*/
-		list_splice(&temp_head, &sys->page_recycle_repl->page_repl_head);
-		ipa3_ctx->stats.page_recycle_cnt_in_tasklet += found_free_page;
-		IPADBG_LOW("found free pages count = %d\n", found_free_page);
-		atomic_set(&sys->common_sys->page_avilable, 1);
-	}
-	spin_unlock_bh(&sys->common_sys->spinlock);
-
-}
-
 /**
  * ipa3_setup_sys_pipe() - Setup an IPA GPI pipe and perform
  * IPA EP configuration
@@ -1500,9 +1556,6 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 			goto fail_wq2;
 		}
 
-		snprintf(buff, IPA_RESOURCE_NAME_MAX, "ipafreepagewq%d",
-				sys_in->client);
-
 		INIT_LIST_HEAD(&ep->sys->head_desc_list);
 		INIT_LIST_HEAD(&ep->sys->rcycl_list);
 		INIT_LIST_HEAD(&ep->sys->avail_tx_wrapper_list);
@@ -1511,6 +1564,13 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 		hrtimer_init(&ep->sys->db_timer, CLOCK_MONOTONIC,
 			HRTIMER_MODE_REL);
 		ep->sys->db_timer.function = ipa3_ring_doorbell_timer_fn;
+		hrtimer_init(&ep->sys->db_batch_timer, CLOCK_MONOTONIC,
+			HRTIMER_MODE_REL_SOFT);
+		ep->sys->db_batch_timer.function =
+			ipa3_tx_db_deadline_timer_fn;
+		hrtimer_init(&ep->sys->rx_hyst_timer, CLOCK_MONOTONIC,
+			HRTIMER_MODE_REL);
+		ep->sys->rx_hyst_timer.function = ipa3_rx_intr_hyst_timer_fn;
 
 		/* create IPA PM resources for handling polling mode */
 		if (sys_in->client == IPA_CLIENT_APPS_WAN_CONS &&
@@ -1519,16 +1579,6 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 			/* Use coalescing pipe PM handle for default pipe also*/
 			ep->sys->pm_hdl = ipa3_ctx->ep[coal_ep_id].sys->pm_hdl;
 		} else if (IPA_CLIENT_IS_CONS(sys_in->client)) {
-			ep->sys->freepage_wq = alloc_workqueue(buff,
-					WQ_MEM_RECLAIM | WQ_UNBOUND | WQ_SYSFS |
-					WQ_HIGHPRI, 1);
-			if (!ep->sys->freepage_wq) {
-				IPAERR("failed to create freepage wq for client %d\n",
-						sys_in->client);
-				result = -EFAULT;
-				goto fail_wq3;
-			}
-
 			pm_reg.name = ipa_clients_strings[sys_in->client];
 			pm_reg.callback = ipa_pm_sys_pipe_cb;
 			pm_reg.user_data = ep->sys;
@@ -1697,7 +1747,6 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 				result = -ENOMEM;
 				goto fail_napi;
 			}
-			atomic_set(&ep->sys->page_recycle_repl->pending, 0);
 			/* For common page pool double the pool size. */
 			if (ipa3_ctx->wan_common_page_pool &&
 				sys_in->client == IPA_CLIENT_APPS_WAN_COAL_CONS)
@@ -1710,7 +1759,16 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 						IPA_GENERIC_RX_PAGE_POOL_SZ_FACTOR;
 			IPADBG("Page repl capacity for client:%d, value:%d\n",
 					   sys_in->client, ep->sys->page_recycle_repl->capacity);
-			INIT_LIST_HEAD(&ep->sys->page_recycle_repl->page_repl_head);
+			/* one slot more than pages so a full ring is not empty */
+			ep->sys->page_recycle_repl->cache = kcalloc(
+				ep->sys->page_recycle_repl->capacity + 1,
+				sizeof(void *), GFP_KERNEL);
+			if (!ep->sys->page_recycle_repl->cache) {
+				IPAERR("failed to alloc page ring for client %d\n",
+					   sys_in->client);
+				result = -ENOMEM;
+				goto fail_page_recycle_repl;
+			}
 			ep->sys->repl = kzalloc(sizeof(*ep->sys->repl), GFP_KERNEL);
 			if (!ep->sys->repl) {
 				IPAERR("failed to alloc repl for client %d\n",
@@ -1733,10 +1791,6 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 			atomic_set(&ep->sys->repl->head_idx, 0);
 			atomic_set(&ep->sys->repl->tail_idx, 0);
 
-			tasklet_init(&ep->sys->tasklet_find_freepage,
-					ipa3_tasklet_find_freepage, (unsigned long) ep->sys);
-			INIT_DELAYED_WORK(&ep->sys->freepage_work, ipa3_schd_freepage_work);
-			ep->sys->napi_sort_page_thrshld_cnt = 0;
 			ipa3_replenish_rx_page_cache(ep->sys);
 			ipa3_wq_page_repl(&ep->sys->repl_work);
 		} else {
@@ -1754,7 +1808,10 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 			sys_in->client ==
 			IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS) &&
 			ipa3_ctx->ipa_wan_skb_page) {
-			ipa3_replenish_rx_page_recycle(ep->sys);
+			if (ep->sys->common_buff_pool)
+				ipa3_first_replenish_rx_page_shared(ep->sys);
+			else
+				ipa3_replenish_rx_page_recycle(ep->sys);
 		} else
 			ipa3_first_replenish_rx_cache(ep->sys);
 		for (i = 0; i < GSI_VEID_MAX; i++)
@@ -1832,6 +1889,7 @@ fail_repl:
 	}
 fail_page_recycle_repl:
 	if (ep->sys->page_recycle_repl && !ep->sys->common_buff_pool) {
+		kfree(ep->sys->page_recycle_repl->cache);
 		kfree(ep->sys->page_recycle_repl);
 		ep->sys->page_recycle_repl = NULL;
 	}
@@ -1847,9 +1905,6 @@ fail_napi:
 fail_gen2:
 	ipa_pm_deregister(ep->sys->pm_hdl);
 fail_pm:
-	if (ep->sys->freepage_wq)
-		destroy_workqueue(ep->sys->freepage_wq);
-fail_wq3:
 	destroy_workqueue(ep->sys->repl_wq);
 fail_wq2:
 	destroy_workqueue(ep->sys->wq);
@@ -1909,6 +1964,8 @@ int ipa3_teardown_sys_pipe(u32 clnt_hdl)
 		do {
 			spin_lock_bh(&ep->sys->spinlock);
 			atomic_set(&ep->disconnect_in_progress, 1);
+			/* let HW complete descriptors waiting for a doorbell */
+			ipa3_tx_db_flush(ep->sys);
 			empty = list_empty(&ep->sys->head_desc_list);
 			spin_unlock_bh(&ep->sys->spinlock);
 			if (!empty)
@@ -1916,6 +1973,7 @@ int ipa3_teardown_sys_pipe(u32 clnt_hdl)
 			else
 				break;
 		} while (1);
+		hrtimer_cancel(&ep->sys->db_batch_timer);
 
 		delete_avail_tx_wrapper_list(ep);
 		/* Delete NAPI TX object. For WAN_PROD, it is deleted
@@ -1931,6 +1989,9 @@ int ipa3_teardown_sys_pipe(u32 clnt_hdl)
 		netif_napi_del(&ep->sys->napi_rx);
 	}
 
+	if (IPA_CLIENT_IS_CONS(ep->client))
+		hrtimer_cancel(&ep->sys->rx_hyst_timer);
+
 	/* channel stop might fail on timeout if IPA is busy */
 	for (i = 0; i < IPA_GSI_CHANNEL_STOP_MAX_RETRY; i++) {
 		result = ipa3_stop_gsi_channel(clnt_hdl);
@@ -2027,11 +2088,6 @@ int ipa3_teardown_sys_pipe(u32 clnt_hdl)
 	if (ep->sys->repl_wq)
 		flush_workqueue(ep->sys->repl_wq);
 
-	if (ep->sys->repl_hdlr == ipa3_replenish_rx_page_recycle) {
-		cancel_delayed_work_sync(&ep->sys->common_sys->freepage_work);
-		tasklet_kill(&ep->sys->common_sys->tasklet_find_freepage);
-	}
-
 	if (IPA_CLIENT_IS_CONS(ep->client) && !ep->sys->common_buff_pool)
 		ipa3_cleanup_rx(ep->sys);
 
@@ -2160,10 +2216,12 @@ void ipa3_tx_cmd_comp(void *user1, int user2)
 }
 
 /**
- * ipa3_tx_dp() - Data-path tx handler
+ * ipa3_tx_dp_xmit_more() - Data-path tx handler with doorbell batching
  * @dst:	[in] which IPA destination to route tx packets to
  * @skb:	[in] the packet to send
  * @metadata:	[in] TX packet meta-data
+ * @xmit_more:	[in] more packets follow right after this one, the GSI
+ *		doorbell may be deferred until the end of the batch
  *
  * Data-path tx handler, this is used for both SW data-path which by-passes most
  * IPA HW blocks AND the regular HW data-path for WLAN AMPDU traffic only. If
@@ -2183,8 +2241,8 @@ void ipa3_tx_cmd_comp(void *user1, int user2)
  *
  * Returns:	0 on success, negative on failure
  */
-int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
-		struct ipa_tx_meta *meta)
+int ipa3_tx_dp_xmit_more(enum ipa_client_type dst, struct sk_buff *skb,
+		struct ipa_tx_meta *meta, bool xmit_more)
 {
 	struct ipa3_desc *desc;
 	struct ipa3_desc _desc[3];
@@ -2358,7 +2416,8 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[skb_idx].callback = NULL;
 		}
 
-		if (ipa3_send(sys, num_frags + data_idx, desc, true)) {
+		if (__ipa3_send(sys, num_frags + data_idx, desc, true,
+			xmit_more)) {
 			IPAERR_RL("fail to send skb %pK num_frags %u SWP\n",
 				skb, num_frags);
 			goto fail_send;
@@ -2389,7 +2448,8 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[data_idx].dma_address = meta->dma_address;
 		}
 		if (num_frags == 0) {
-			if (ipa3_send(sys, data_idx + 1, desc, true)) {
+			if (__ipa3_send(sys, data_idx + 1, desc, true,
+				xmit_more)) {
 				IPAERR("fail to send skb %pK HWP\n", skb);
 				goto fail_mem;
 			}
@@ -2408,8 +2468,8 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[data_idx+f].user2 = desc[data_idx].user2;
 			desc[data_idx].callback = NULL;
 
-			if (ipa3_send(sys, num_frags + data_idx + 1,
-				desc, true)) {
+			if (__ipa3_send(sys, num_frags + data_idx + 1,
+				desc, true, xmit_more)) {
 				IPAERR("fail to send skb %pK num_frags %u\n",
 					skb, num_frags);
 				goto fail_mem;
@@ -2435,6 +2495,22 @@ fail_pipe_not_valid:
 	return -EPIPE;
 }
 
+/**
+ * ipa3_tx_dp() - Data-path tx handler
+ * @dst:	[in] which IPA destination to route tx packets to
+ * @skb:	[in] the packet to send
+ * @metadata:	[in] TX packet meta-data
+ *
+ * Same as ipa3_tx_dp_xmit_more() with the doorbell rung for every packet.
+ *
+ * Returns:	0 on success, negative on failure
+ */
+int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
+		struct ipa_tx_meta *meta)
+{
+	return ipa3_tx_dp_xmit_more(dst, skb, meta, false);
+}
+
 static void ipa3_wq_handle_rx(struct work_struct *work)
 {
 	struct ipa3_sys_context *sys;
@@ -2616,6 +2692,57 @@ fail_page_alloc:
 	return NULL;
 }
 
+/*
+ * The page ring is filled at setup before the owning pipe gets buffers,
+ * then fed and drained only from the NAPI context polling the pipes of the
+ * pool, and emptied on teardown once that has stopped. The pipes sharing
+ * the pool never touch it from process context, see
+ * ipa3_first_replenish_rx_page_shared(), so no lock is needed.
+ */
+static inline bool ipa3_page_ring_put(struct ipa3_page_repl_ctx *ring,
+	struct ipa3_rx_pkt_wrapper *rx_pkt)
+{
+	u32 next = (ring->tail_idx + 1) % (ring->capacity + 1);
+
+	if (unlikely(next == ring->head_idx))
+		return false;
+
+	ring->cache[ring->tail_idx] = rx_pkt;
+	ring->tail_idx = next;
+	return true;
+}
+
+static inline struct ipa3_rx_pkt_wrapper *ipa3_page_ring_get(
+	struct ipa3_page_repl_ctx *ring)
+{
+	struct ipa3_rx_pkt_wrapper *rx_pkt;
+
+	if (ring->head_idx == ring->tail_idx)
+		return NULL;
+
+	rx_pkt = ring->cache[ring->head_idx];
+	ring->head_idx = (ring->head_idx + 1) % (ring->capacity + 1);
+	return rx_pkt;
+}
+
+/**
+ * ipa3_recycle_rx_page() - give a pool page back to its recycle ring
+ * @rx_pkt: the page wrapper, the page may still be referenced by the stack
+ *
+ * Pages are put back as they are handed to the stack, so the ring stays in
+ * hand-off order and the oldest one, the most likely to be released, is at
+ * the head. The ring has room for all the pages of the pool.
+ */
+static void ipa3_recycle_rx_page(struct ipa3_rx_pkt_wrapper *rx_pkt)
+{
+	if (unlikely(!ipa3_page_ring_put(rx_pkt->sys->page_recycle_repl,
+		rx_pkt))) {
+		/* we don't expect this will happen */
+		IPAERR("page ring full\n");
+		ipa_assert();
+	}
+}
+
 static void ipa3_replenish_rx_page_cache(struct ipa3_sys_context *sys)
 {
 	struct ipa3_rx_pkt_wrapper *rx_pkt;
@@ -2628,15 +2755,9 @@ static void ipa3_replenish_rx_page_cache(struct ipa3_sys_context *sys)
 			ipa_assert();
 			break;
 		}
-		INIT_LIST_HEAD(&rx_pkt->link);
 		rx_pkt->sys = sys;
-		list_add_tail(&rx_pkt->link,
-			&sys->page_recycle_repl->page_repl_head);
+		ipa3_recycle_rx_page(rx_pkt);
 	}
-	atomic_set(&sys->common_sys->page_avilable, 1);
-
-	return;
-
 }
 
 static void ipa3_wq_page_repl(struct work_struct *work)
@@ -2702,46 +2823,34 @@ static inline void __trigger_repl_work(struct ipa3_sys_context *sys)
 	}
 }
 
-static struct ipa3_rx_pkt_wrapper * ipa3_get_free_page
-(
-	struct ipa3_sys_context *sys,
-	u32 stats_i
-)
+/*
+ * Take the page at the head of the recycle ring if the stack has released
+ * it (only the pool reference is left). A page still in use is moved to
+ * the tail so the next one gets checked, up to page_poll_threshold times.
+ */
+static struct ipa3_rx_pkt_wrapper *ipa3_get_free_page(
+	struct ipa3_sys_context *sys, u32 stats_i)
 {
-	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
-	struct ipa3_rx_pkt_wrapper *tmp = NULL;
+	struct ipa3_page_repl_ctx *ring = sys->page_recycle_repl;
+	struct ipa3_rx_pkt_wrapper *rx_pkt;
 	struct page *cur_page;
-	int i = 0;
-	u8 LOOP_THRESHOLD = ipa3_ctx->page_poll_threshold;
+	int i;
 
-	spin_lock_bh(&sys->common_sys->spinlock);
-	list_for_each_entry_safe(rx_pkt, tmp,
-		&sys->page_recycle_repl->page_repl_head, link) {
-		if (i == LOOP_THRESHOLD)
+	for (i = 0; i < ipa3_ctx->page_poll_threshold; i++) {
+		rx_pkt = ipa3_page_ring_get(ring);
+		if (!rx_pkt)
 			break;
 		cur_page = rx_pkt->page_data.page;
 		if (page_ref_count(cur_page) == 1) {
 			/* Found a free page. */
 			page_ref_inc(cur_page);
-			list_del_init(&rx_pkt->link);
 			++ipa3_ctx->stats.page_recycle_cnt[stats_i][i];
-			sys->common_sys->napi_sort_page_thrshld_cnt = 0;
-			spin_unlock_bh(&sys->common_sys->spinlock);
 			return rx_pkt;
 		}
-		i++;
-	}
-	spin_unlock_bh(&sys->common_sys->spinlock);
-	IPADBG_LOW("napi_sort_page_thrshld_cnt = %d ipa_max_napi_sort_page_thrshld = %d\n",
-			sys->common_sys->napi_sort_page_thrshld_cnt,
-			ipa3_ctx->ipa_max_napi_sort_page_thrshld);
-	/*Scheduling tasklet to find the free page*/
-	if (sys->common_sys->napi_sort_page_thrshld_cnt >=
-			ipa3_ctx->ipa_max_napi_sort_page_thrshld) {
-		atomic_set(&sys->common_sys->page_avilable, 0);
-		tasklet_schedule(&sys->common_sys->tasklet_find_freepage);
-		++ipa3_ctx->stats.num_sort_tasklet_sched[stats_i];
+		/* slot was just freed, cannot fail */
+		ipa3_page_ring_put(ring, rx_pkt);
 	}
+	++ipa3_ctx->stats.page_recycle_stats[stats_i].ring_busy;
 	return NULL;
 }
 
@@ -2814,10 +2923,9 @@ static void ipa3_replenish_rx_page_recycle(struct ipa3_sys_context *sys)
 
 	while (rx_len_cached < sys->rx_pool_sz) {
 		/* check for an idle page that can be used */
-		if (atomic_read(&sys->common_sys->page_avilable) &&
-			((rx_pkt = ipa3_get_free_page(sys,stats_i)) != NULL)) {
+		rx_pkt = ipa3_get_free_page(sys, stats_i);
+		if (rx_pkt) {
 			ipa3_ctx->stats.page_recycle_stats[stats_i].page_recycled++;
-
 		} else {
 			/*
 			 * Could not find idle page at curr index.
@@ -2949,6 +3057,63 @@ static void ipa3_replenish_rx_page_recycle(struct ipa3_sys_context *sys)
 	return;
 }
 
+/*
+ * First replenish of a pipe sharing the page pool of the coal pipe. It runs
+ * from process context while the pool may be in use by the NAPI, so it
+ * leaves the recycle ring and the temp page cache alone and fills the pipe
+ * with newly allocated temp pages. Pool pages are taken from the NAPI
+ * replenish on.
+ */
+static void ipa3_first_replenish_rx_page_shared(struct ipa3_sys_context *sys)
+{
+	struct ipa3_rx_pkt_wrapper *rx_pkt;
+	struct gsi_xfer_elem gsi_xfer_elem_array[IPA_REPL_XFER_MAX];
+	int rx_len_cached = sys->len;
+	int idx = 0;
+	int ret;
+
+	while (rx_len_cached < sys->rx_pool_sz) {
+		rx_pkt = ipa3_alloc_rx_pkt_page(GFP_KERNEL, true, sys);
+		if (!rx_pkt) {
+			IPAERR("ipa3_alloc_rx_pkt_page fails\n");
+			break;
+		}
+		rx_pkt->sys = sys;
+
+		gsi_xfer_elem_array[idx].addr = rx_pkt->page_data.dma_addr;
+		gsi_xfer_elem_array[idx].len = rx_pkt->len;
+		gsi_xfer_elem_array[idx].flags = GSI_XFER_FLAG_EOT;
+		gsi_xfer_elem_array[idx].flags |= GSI_XFER_FLAG_EOB;
+		gsi_xfer_elem_array[idx].flags |= GSI_XFER_FLAG_BEI;
+		gsi_xfer_elem_array[idx].type = GSI_XFER_ELEM_DATA;
+		gsi_xfer_elem_array[idx].xfer_user_data = rx_pkt;
+		rx_len_cached++;
+		idx++;
+		if (idx == IPA_REPL_XFER_MAX) {
+			ret = gsi_queue_xfer(sys->ep->gsi_chan_hdl, idx,
+				gsi_xfer_elem_array, false);
+			if (ret != GSI_STATUS_SUCCESS) {
+				/* we don't expect this will happen */
+				IPAERR("failed to provide buffer: %d\n", ret);
+				ipa_assert();
+				return;
+			}
+			sys->len += idx;
+			idx = 0;
+		}
+	}
+	/* only ring doorbell once here */
+	ret = gsi_queue_xfer(sys->ep->gsi_chan_hdl, idx,
+			gsi_xfer_elem_array, true);
+	if (ret != GSI_STATUS_SUCCESS) {
+		/* we don't expect this will happen */
+		IPAERR("failed to provide buffer: %d\n", ret);
+		ipa_assert();
+		return;
+	}
+	sys->len += idx;
+}
+
 static void ipa3_replenish_wlan_rx_cache(struct ipa3_sys_context *sys)
 {
 	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
@@ -3586,10 +3751,8 @@ static void free_rx_page(void *chan_user_data, void *xfer_user_data)
 	struct ipa3_rx_pkt_wrapper *rx_pkt = (struct ipa3_rx_pkt_wrapper *)
 		xfer_user_data;
 
-	if (!rx_pkt->page_data.is_tmp_alloc) {
-		list_del_init(&rx_pkt->link);
+	if (!rx_pkt->page_data.is_tmp_alloc)
 		page_ref_dec(rx_pkt->page_data.page);
-	}
 	dma_unmap_page(ipa3_ctx->pdev, rx_pkt->page_data.dma_addr,
 		rx_pkt->len, DMA_FROM_DEVICE);
 	__free_pages(rx_pkt->page_data.page, rx_pkt->page_data.page_order);
@@ -3662,9 +3825,7 @@ static void ipa3_cleanup_rx(struct ipa3_sys_context *sys)
 		sys->repl = NULL;
 	}
 	if (sys->page_recycle_repl) {
-		list_for_each_entry_safe(rx_pkt, r,
-		&sys->page_recycle_repl->page_repl_head, link) {
-			list_del(&rx_pkt->link);
+		while ((rx_pkt = ipa3_page_ring_get(sys->page_recycle_repl))) {
 			dma_unmap_page(dev,
 				rx_pkt->page_data.dma_addr,
 				rx_pkt->len,
@@ -3675,6 +3836,7 @@ static void ipa3_cleanup_rx(struct ipa3_sys_context *sys)
 				ipa3_ctx->rx_pkt_wrapper_cache,
 				rx_pkt);
 		}
+		kfree(sys->page_recycle_repl->cache);
 		kfree(sys->page_recycle_repl);
 		sys->page_recycle_repl = NULL;
 	}
@@ -4560,11 +4722,7 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 		IPAERR("notify->veid > GSI_VEID_MAX\n");
 		if (!rx_page.is_tmp_alloc) {
 			init_page_count(rx_page.page);
-			spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-			/* Add the element to head. */
-			list_add(&rx_pkt->link,
-				&rx_pkt->sys->page_recycle_repl->page_repl_head);
-			spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
+			ipa3_recycle_rx_page(rx_pkt);
 		} else {
 			dma_unmap_page(ipa3_ctx->pdev, rx_page.dma_addr,
 					rx_pkt->len, DMA_FROM_DEVICE);
@@ -4592,11 +4750,7 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 				list_del_init(&rx_pkt->link);
 				if (!rx_page.is_tmp_alloc) {
 					init_page_count(rx_page.page);
-					spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-					/* Add the element to head. */
-					list_add(&rx_pkt->link,
-						&rx_pkt->sys->page_recycle_repl->page_repl_head);
-					spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
+					ipa3_recycle_rx_page(rx_pkt);
 				} else {
 					dma_unmap_page(ipa3_ctx->pdev, rx_page.dma_addr,
 						rx_pkt->len, DMA_FROM_DEVICE);
@@ -4616,14 +4770,11 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 				dma_unmap_page(ipa3_ctx->pdev, rx_page.dma_addr,
 					rx_pkt->len, DMA_FROM_DEVICE);
 			} else {
-				spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-				/* Add the element back to tail. */
-				list_add_tail(&rx_pkt->link,
-					&rx_pkt->sys->page_recycle_repl->page_repl_head);
-				spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
 				dma_sync_single_for_cpu(ipa3_ctx->pdev,
 					rx_page.dma_addr,
 					rx_pkt->len, DMA_FROM_DEVICE);
+				/* Back to the ring tail, reused once released. */
+				ipa3_recycle_rx_page(rx_pkt);
 			}
 			rx_pkt->sys->free_rx_wrapper(rx_pkt);
 
@@ -4654,6 +4805,7 @@ static void ipa3_wq_rx_common(struct ipa3_sys_context *sys,
 		IPAERR_RL("gsi_chan_xfer_notify is null\n");
 		return;
 	}
+	sys->pm_bytes += notify->bytes_xfered;
 	rx_skb = handle_skb_completion(notify, true);
 
 	if (rx_skb) {
@@ -4684,6 +4836,9 @@ static void ipa3_rx_napi_chain(struct ipa3_sys_context *sys,
 	int i, ipa_ep_idx;
 	struct sk_buff *rx_skb, *first_skb = NULL, *prev_skb = NULL;
 
+	for (i = 0; i < num; i++)
+		sys->pm_bytes += notify[i].bytes_xfered;
+
 	/* non-coalescing case (SKB chaining enabled) */
 	if (sys->ep->client != IPA_CLIENT_APPS_WAN_COAL_CONS) {
 		for (i = 0; i < num; i++) {
@@ -4707,6 +4862,11 @@ static void ipa3_rx_napi_chain(struct ipa3_sys_context *sys,
 							 prev_skb,
 							 rx_skb);
 
+				/* lets SO_BUSY_POLL sockets find napi_rx */
+				if (sys->ep->client ==
+					IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS)
+					skb_mark_napi_id(rx_skb, &sys->napi_rx);
+
 				prev_skb = rx_skb;
 			}
 		}
@@ -5294,7 +5454,8 @@ int ipa3_tx_dp_mul(enum ipa_client_type src,
 		}
 
 		IPADBG_LOW("calling ipa3_send()\n");
-		if (ipa3_send(sys, 2, desc, true)) {
+		/* ring the doorbell once for the whole list */
+		if (__ipa3_send(sys, 2, desc, true, cnt != num_desc)) {
 			IPAERR("fail to send skb\n");
 			sys->ep->wstats.rx_pkt_leak += (cnt-1);
 			sys->ep->wstats.rx_dp_fail++;
@@ -5664,6 +5825,7 @@ static void ipa_gsi_irq_rx_notify_cb(struct gsi_chan_xfer_notify *notify)
 	case GSI_CHAN_EVT_EOB:
 		atomic_set(&ipa3_ctx->transport_pm.eot_activity, 1);
 		if (!atomic_read(&sys->curr_polling_state)) {
+			sys->rx_irq_ts = ktime_get();
 			/* put the gsi channel into polling mode */
 			gsi_config_channel_mode(sys->ep->gsi_chan_hdl,
 				GSI_CHAN_MODE_POLL);
@@ -6304,6 +6466,8 @@ start_poll:
 			else
 				ipa3_wq_rx_common(ep->sys, g_lan_rx_notify + i);
 		}
+		if (num)
+			ipa3_rx_lat_record(ep->sys);
 
 		remain_aggr_weight -= num;
 		if (ep->sys->len == 0) {
@@ -6327,6 +6491,49 @@ start_poll:
 	return cnt;
 }
 
+static enum hrtimer_restart ipa3_rx_intr_hyst_timer_fn(struct hrtimer *param)
+{
+	struct ipa3_sys_context *sys = container_of(param,
+		struct ipa3_sys_context, rx_hyst_timer);
+
+	napi_schedule(sys->napi_obj);
+
+	return HRTIMER_NORESTART;
+}
+
+/**
+ * ipa3_rx_intr_hyst_defer() - hold off the IRQ re-enable of an idle pipe
+ * @sys: sys context of the pipe
+ * @cnt: work done by the poll, under budget
+ * @hyst_poll: the poll was run by the hysteresis timer
+ *
+ * Completes the NAPI with the IRQ still masked and re-polls it once
+ * rx_intr_hyst_us later, so bursty traffic does not take one IRQ per
+ * burst. A re-poll which finds no work lets the pipe go back to
+ * interrupt mode.
+ *
+ * Return: true if the IRQ re-enable was deferred
+ */
+static bool ipa3_rx_intr_hyst_defer(struct ipa3_sys_context *sys, int cnt,
+	bool hyst_poll)
+{
+	u32 hyst_us = READ_ONCE(ipa3_ctx->rx_intr_hyst_us);
+
+	if (!hyst_us || (hyst_poll && !cnt))
+		return false;
+
+	/* a busy poller owns the NAPI and polls it again */
+	if (!napi_complete_done(sys->napi_obj, cnt))
+		return true;
+
+	sys->rx_hyst_pending = true;
+	sys->rx_lat.hyst_polls++;
+	hrtimer_start(&sys->rx_hyst_timer,
+		ns_to_ktime(hyst_us * NSEC_PER_USEC), HRTIMER_MODE_REL);
+
+	return true;
+}
+
 /**
  * ipa3_rx_poll() - Poll the WAN rx packets from IPA HW. This
  * function is exectued in the softirq context
@@ -6345,6 +6552,7 @@ int ipa3_rx_poll(u32 clnt_hdl, int weight)
 	int num = 0;
 	int remain_aggr_weight;
 	int ipa_ep_idx;
+	bool hyst_poll;
 	struct ipa_active_client_logging_info log;
 	static struct gsi_chan_xfer_notify notify[IPA_WAN_NAPI_MAX_FRAMES];
 
@@ -6376,7 +6584,9 @@ int ipa3_rx_poll(u32 clnt_hdl, int weight)
 		return -EINVAL;
 	}
 
-	ep->sys->common_sys->napi_sort_page_thrshld_cnt++;
+	hyst_poll = ep->sys->rx_hyst_pending;
+	ep->sys->rx_hyst_pending = false;
+
 start_poll:
 	/*
 	 * it is guaranteed we already have clock here.
@@ -6398,6 +6608,8 @@ start_poll:
 
 		trace_ipa3_rx_poll_num(num);
 		ipa3_rx_napi_chain(ep->sys, notify, num);
+		if (num)
+			ipa3_rx_lat_record(ep->sys);
 		remain_aggr_weight -= num;
 
 		trace_ipa3_rx_poll_cnt(ep->sys->len);
@@ -6419,6 +6631,10 @@ start_poll:
 	 */
 	if (cnt < weight && ep->sys->len > IPA_DEFAULT_SYS_YELLOW_WM &&
 		wan_def_sys->len > IPA_DEFAULT_SYS_YELLOW_WM) {
+		if (ipa3_rx_intr_hyst_defer(ep->sys, cnt, hyst_poll)) {
+			trace_ipa3_napi_poll_exit(ep->client);
+			return cnt;
+		}
 		napi_complete(ep->sys->napi_obj);
 		IPA_STATS_INC_CNT(ep->sys->napi_comp_cnt);
 		ret = ipa3_rx_switch_to_intr_mode(ep->sys);
@@ -6603,6 +6819,17 @@ static int ipa3_rmnet_ll_rx_poll(struct napi_struct *napi_rx, int budget)
 
 	IPA_ACTIVE_CLIENTS_PREP_SPECIAL(log, "NAPI_LL");
 
+	/*
+	 * A SO_BUSY_POLL socket may poll while the channel is still in
+	 * interrupt mode. No clock vote was taken for it then, leave the
+	 * channel alone and let the next IRQ move it to polling mode.
+	 */
+	if (!atomic_read(&sys->curr_polling_state)) {
+		napi_complete_done(napi_rx, 0);
+		return 0;
+	}
+	if (test_bit(NAPI_STATE_IN_BUSY_POLL, &napi_rx->state))
+		sys->rx_lat.busy_poll++;
 
 	remain_aggr_weight = budget / ipa3_ctx->ipa_wan_aggr_pkt_cnt;
 	if (remain_aggr_weight > IPA_WAN_NAPI_MAX_FRAMES) {
@@ -6612,7 +6839,6 @@ static int ipa3_rmnet_ll_rx_poll(struct napi_struct *napi_rx, int budget)
 		return -EINVAL;
 	}
 
-	sys->napi_sort_page_thrshld_cnt++;
 start_poll:
 	/*
 	 * it is guaranteed we already have clock here.
@@ -6627,6 +6853,8 @@ start_poll:
 		if (ret)
 			break;
 		ipa3_rx_napi_chain(sys, notify, num);
+		if (num)
+			ipa3_rx_lat_record(sys);
 		remain_aggr_weight -= num;
 
 		if (sys->len == 0) {
@@ -6645,7 +6873,12 @@ start_poll:
 	 * mode, wait for napi-poll and replenish again.
 	 */
 	if (cnt < budget && (sys->len > IPA_DEFAULT_SYS_YELLOW_WM)) {
-		napi_complete(napi_rx);
+		/*
+		 * While a busy polling socket owns the NAPI keep the channel
+		 * in polling mode, the last busy poll completes it for real.
+		 */
+		if (!napi_complete_done(napi_rx, cnt))
+			return cnt;
 		IPA_STATS_INC_CNT(sys->napi_comp_cnt);
 		ret = ipa3_rx_switch_to_intr_mode(sys);
 		if (ret == -GSI_STATUS_PENDING_IRQ &&
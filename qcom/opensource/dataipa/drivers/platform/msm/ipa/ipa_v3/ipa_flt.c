@@ -6,6 +6,10 @@
 #include "ipa_i.h"
 #include "ipahal.h"
 #include "ipahal_fltrt.h"
+#include "ipa_trace.h"
+
+/* minimal interval between two rankings of the SRAM non-hash tables */
+#define IPA_FLT_SRAM_RANK_INTERVAL_MSEC 1000
 
 #define IPA_FLT_STATUS_OF_ADD_FAILED		(-1)
 #define IPA_FLT_STATUS_OF_DEL_FAILED		(-1)
@@ -98,19 +102,58 @@ static void __ipa_reap_sys_flt_tbls(enum ipa_ip_type ip, enum ipa_rule_type rlt)
 		tbl = &ipa3_ctx->flt_tbl[i][ip];
 		if (tbl->prev_mem[rlt].phys_base) {
 			IPADBG_LOW("reaping flt tbl (prev) pipe=%d\n", i);
-			ipahal_free_dma_mem(&tbl->prev_mem[rlt]);
+			ipahal_fltrt_release_hw_sys_tbl(&tbl->prev_mem[rlt]);
 		}
 
 		if (list_empty(&tbl->head_flt_rule_list)) {
 			if (tbl->curr_mem[rlt].phys_base) {
 				IPADBG_LOW("reaping flt tbl (curr) pipe=%d\n",
 					i);
-				ipahal_free_dma_mem(&tbl->curr_mem[rlt]);
+				ipahal_fltrt_release_hw_sys_tbl(
+					&tbl->curr_mem[rlt]);
 			}
 		}
 	}
 }
 
+/**
+ * __ipa_retire_sys_flt_tbl() - stop using the sys memory body of a table
+ *  which is now empty or placed in local memory. The body is released by
+ *  the reap once the new headers are committed.
+ * @tbl: the flt tbl
+ * @rlt: the rule type (hashable or non-hashable)
+ */
+static void __ipa_retire_sys_flt_tbl(struct ipa3_flt_tbl *tbl,
+	enum ipa_rule_type rlt)
+{
+	if (!tbl->curr_mem[rlt].phys_base)
+		return;
+
+	WARN_ON(tbl->prev_mem[rlt].phys_base);
+	tbl->prev_mem[rlt] = tbl->curr_mem[rlt];
+	memset(&tbl->curr_mem[rlt], 0, sizeof(tbl->curr_mem[rlt]));
+}
+
+/**
+ * ipa3_flt_set_tbls_dirty() - force regeneration of all flt tables of an
+ *  ip family on the next commit
+ * @ip: the ip address family type
+ *
+ * Used when something the flt rules encoding depends on, other than the
+ * rules themselves, has changed (e.g. a referenced rt table was removed).
+ * caller needs to hold ipa3_ctx->lock
+ */
+void ipa3_flt_set_tbls_dirty(enum ipa_ip_type ip)
+{
+	int i;
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		ipa3_ctx->flt_tbl[i][ip].dirty = true;
+	}
+}
+
 /**
  * ipa_prep_flt_tbl_for_cmt() - preparing the flt table for commit
  *  assign priorities to the rules, calculate their sizes and calculate
@@ -192,6 +235,10 @@ static int ipa_prep_flt_tbl_for_cmt(enum ipa_ip_type ip,
  * @body_ofst: the offset of the rules body from the rules header at
  *  ipa sram
  *
+ * Sys tables that are not dirty keep their committed body, only their
+ * address is written to the header. Local bodies are always regenerated
+ * as they are packed back-to-back.
+ *
  * Returns: 0 on success, negative on failure
  *
  * caller needs to hold any needed locks to ensure integrity
@@ -216,10 +263,24 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			continue;
 		tbl = &ipa3_ctx->flt_tbl[i][ip];
 		if (tbl->sz[rlt] == 0) {
+			__ipa_retire_sys_flt_tbl(tbl, rlt);
 			hdr_idx++;
 			continue;
 		}
 		if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
+			if (!tbl->dirty && tbl->curr_mem[rlt].phys_base) {
+				/* rules unchanged, re-use the committed body */
+				if (ipahal_fltrt_write_addr_to_hdr(
+					tbl->curr_mem[rlt].phys_base,
+					hdr, hdr_idx, true)) {
+					IPAERR("fail to wrt sys tbl addr to hdr\n");
+					goto err;
+				}
+				ipa3_ctx->flt_cmt_shadow[ip].tbls_reused++;
+				hdr_idx++;
+				continue;
+			}
+
 			/* only body (no header) */
 			tbl_mem.size = tbl->sz[rlt] -
 				ipahal_get_hw_tbl_hdr_width();
@@ -260,6 +321,7 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			}
 			tbl->curr_mem[rlt] = tbl_mem;
 		} else {
+			__ipa_retire_sys_flt_tbl(tbl, rlt);
 			offset = body_i - base + body_ofst;
 
 			/* update the hdr at the right index */
@@ -470,11 +532,139 @@ static bool ipa_flt_skip_pipe_config(int pipe)
 	return false;
 }
 
+/**
+ * ipa_flt_sram_rank_tbls() - order the SRAM non-hash tables by their hits
+ * @ip: the ip address family type
+ *
+ * Sums the FnR counters of the non-hash rules of each table allowed in SRAM
+ * and sorts the tables having counters in ipa3_ctx->flt_tbl_nhash_lcl_list[ip]
+ * among themselves, so the coldest of them are the first to be moved to DDR
+ * when SRAM is too small. Hits decay by half on each ranking so the order
+ * follows the recent traffic. Tables without counters and tables pinned by
+ * ipa_flt_sram_set_client_prio_high() are not ranked and keep their place.
+ * The counters are read at most once per IPA_FLT_SRAM_RANK_INTERVAL_MSEC and
+ * are not cleared.
+ */
+static void ipa_flt_sram_rank_tbls(enum ipa_ip_type ip)
+{
+	struct ipa3_fltrt_cmt_shadow *shadow = &ipa3_ctx->flt_cmt_shadow[ip];
+	struct list_head *list = &ipa3_ctx->flt_tbl_nhash_lcl_list[ip];
+	struct ipa3_flt_tbl_nhash_lcl *lcl_tbl, *cur;
+	struct ipa3_flt_tbl_nhash_lcl **tbls;
+	struct ipa3_flt_entry *entry;
+	struct ipa_ioc_flt_rt_query query;
+	struct ipa_flt_rt_stats *stats;
+	u8 max_cnt_idx = 0;
+	int num_tbls = 0, num_ranked = 0;
+	int i, j, hole;
+	u64 pkts;
+
+	if (ipa3_ctx->ipa_hw_type < IPA_HW_v4_5 ||
+		!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return;
+
+	if (list_empty(list) || list_is_singular(list))
+		return;
+
+	if (shadow->sram_ranks && time_before(jiffies,
+		shadow->sram_rank_jiffies +
+		msecs_to_jiffies(IPA_FLT_SRAM_RANK_INTERVAL_MSEC)))
+		return;
+
+	list_for_each_entry(lcl_tbl, list, link) {
+		lcl_tbl->counted = false;
+		list_for_each_entry(entry, &lcl_tbl->tbl->head_flt_rule_list,
+			link) {
+			if (entry->rule.hashable || !entry->cnt_idx)
+				continue;
+			lcl_tbl->counted = true;
+			if (entry->cnt_idx > max_cnt_idx)
+				max_cnt_idx = entry->cnt_idx;
+		}
+		if (lcl_tbl->counted && !lcl_tbl->pinned)
+			num_ranked++;
+		num_tbls++;
+	}
+	/* a single table with counters has nothing to be ranked against */
+	if (num_ranked < 2)
+		return;
+
+	stats = kcalloc(max_cnt_idx, sizeof(*stats), GFP_KERNEL);
+	tbls = kcalloc(num_tbls, sizeof(*tbls), GFP_KERNEL);
+	if (!stats || !tbls) {
+		IPAERR_RL("no mem\n");
+		goto bail;
+	}
+
+	memset(&query, 0, sizeof(query));
+	query.start_id = 1;
+	query.end_id = max_cnt_idx;
+	query.stats_size = sizeof(*stats);
+	query.stats = (u64)(uintptr_t)stats;
+	if (ipa_get_flt_rt_stats(&query)) {
+		IPAERR_RL("fail to read flt counters, keep SRAM order\n");
+		goto bail;
+	}
+
+	i = 0;
+	list_for_each_entry(lcl_tbl, list, link) {
+		tbls[i++] = lcl_tbl;
+		if (!lcl_tbl->counted)
+			continue;
+		pkts = 0;
+		list_for_each_entry(entry, &lcl_tbl->tbl->head_flt_rule_list,
+			link) {
+			if (!entry->rule.hashable && entry->cnt_idx)
+				pkts += stats[entry->cnt_idx - 1].num_pkts;
+		}
+		/* counters were reset by their owner */
+		if (pkts < lcl_tbl->last_pkts)
+			lcl_tbl->last_pkts = 0;
+		lcl_tbl->hits = (lcl_tbl->hits >> 1) +
+			(pkts - lcl_tbl->last_pkts);
+		lcl_tbl->last_pkts = pkts;
+		IPADBG_LOW("ip %d pipe %d hits %llu\n", ip, lcl_tbl->pipe,
+			lcl_tbl->hits);
+	}
+
+	/*
+	 * Stable insertion sort of the ranked tables by ascending hits, done
+	 * over the positions they already hold so the other tables stay put.
+	 */
+	for (i = 1; i < num_tbls; i++) {
+		cur = tbls[i];
+		if (!cur->counted || cur->pinned)
+			continue;
+		hole = i;
+		for (j = i - 1; j >= 0; j--) {
+			if (!tbls[j]->counted || tbls[j]->pinned)
+				continue;
+			if (tbls[j]->hits <= cur->hits)
+				break;
+			tbls[hole] = tbls[j];
+			hole = j;
+		}
+		tbls[hole] = cur;
+	}
+
+	INIT_LIST_HEAD(list);
+	for (i = 0; i < num_tbls; i++)
+		list_add_tail(&tbls[i]->link, list);
+
+	shadow->sram_ranks++;
+	shadow->sram_rank_jiffies = jiffies;
+bail:
+	kfree(tbls);
+	kfree(stats);
+}
+
 /**
  * __ipa_commit_flt_v3() - commit flt tables to the hw
  *  commit the headers and the bodies if are local with internal cache flushing.
  *  The headers (and local bodies) will first be created into dma buffers and
- *  then written via IC to the SRAM
+ *  then written via IC to the SRAM.
+ *  Only dirty tables are regenerated, and header entries or local bodies
+ *  which are identical to the last committed image are not written again.
  * @ipt: the ip address family type
  *
  * Return: 0 on success, negative on failure
@@ -499,11 +689,17 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 	struct ipa3_flt_tbl_nhash_lcl *lcl_tbl;
 	u16 entries;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	struct ipa3_fltrt_cmt_shadow *shadow = &ipa3_ctx->flt_cmt_shadow[ip];
+	u32 dirty_tbls = 0, dma_skipped = 0, reused_base, usec;
+	u64 hdr_skip_bmap = 0;
+	bool hdr_known;
+	ktime_t start = ktime_get();
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(&alloc_params, 0, sizeof(alloc_params));
 	alloc_params.ipt = ip;
 	alloc_params.tbls_num = ipa3_ctx->ep_flt_num;
+	reused_base = shadow->tbls_reused;
 
 	if (ip == IPA_IP_v4) {
 		lcl_hash_hdr = ipa3_ctx->smem_restricted_bytes +
@@ -537,9 +733,13 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		if (!ipa_is_ep_support_flt(i))
 			continue;
 		tbl = &ipa3_ctx->flt_tbl[i][ip];
-		if (ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
-			rc = -EPERM;
-			goto prep_failed;
+		/* clean tables keep their sizes from the last commit */
+		if (tbl->dirty) {
+			if (ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
+				rc = -EPERM;
+				goto prep_failed;
+			}
+			dirty_tbls++;
 		}
 
 		/* First try fitting tables in lcl memory if allowed */
@@ -572,6 +772,8 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 	}
 
 	/* Check Non-Hash filter tables fits in SRAM, if it is not - move some tables to DDR */
+	ipa_flt_sram_rank_tbls(ip);
+	shadow->sram_demoted = 0;
 	list_for_each_entry(lcl_tbl, &ipa3_ctx->flt_tbl_nhash_lcl_list[ip], link) {
 		if (ipa_flt_valid_lcl_tbl_size(ip, IPA_RULE_NON_HASHABLE,
 			ipa_fltrt_get_aligned_lcl_bdy_size(alloc_params.num_lcl_nhash_tbls,
@@ -587,6 +789,7 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			lcl_tbl->tbl->sz[IPA_RULE_NON_HASHABLE]) {
 			/* Move lowest priority Eth client to DDR */
 			lcl_tbl->tbl->force_sys[IPA_RULE_NON_HASHABLE] = true;
+			shadow->sram_demoted++;
 
 			alloc_params.num_lcl_nhash_tbls--;
 			alloc_params.total_sz_lcl_nhash_tbls -= lcl_tbl->tbl->sz[IPA_RULE_NON_HASHABLE];
@@ -694,6 +897,7 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		}
 
 		if (ipa_flt_skip_pipe_config(i)) {
+			hdr_skip_bmap |= BIT_ULL(i);
 			hdr_idx++;
 			continue;
 		}
@@ -708,30 +912,46 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		IPADBG_LOW("Prepare imm cmd for hdr at index %d for pipe %d\n",
 			hdr_idx, i);
 
-		mem_cmd.is_read = false;
-		mem_cmd.skip_pipeline_clear = false;
-		mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		mem_cmd.size = tbl_hdr_width;
-		mem_cmd.system_addr = alloc_params.nhash_hdr.phys_base +
-			hdr_idx * tbl_hdr_width;
-		mem_cmd.local_addr = lcl_nhash_hdr +
-			hdr_idx * tbl_hdr_width;
-		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-			IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("fail construct dma_shared_mem cmd: IP = %d\n",
-				ip);
-			rc = -ENOMEM;
-			goto fail_imm_cmd_construct;
+		hdr_known = !(shadow->hdr_skip_bmap & BIT_ULL(i));
+		if (hdr_known && ipa3_fltrt_shadow_match(shadow, true,
+			IPA_RULE_NON_HASHABLE, hdr_idx * tbl_hdr_width,
+			&alloc_params.nhash_hdr, tbl_hdr_width)) {
+			IPADBG_LOW("nhash hdr of pipe %d unchanged\n", i);
+			dma_skipped++;
+		} else {
+			mem_cmd.is_read = false;
+			mem_cmd.skip_pipeline_clear = false;
+			mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+			mem_cmd.size = tbl_hdr_width;
+			mem_cmd.system_addr = alloc_params.nhash_hdr.phys_base +
+				hdr_idx * tbl_hdr_width;
+			mem_cmd.local_addr = lcl_nhash_hdr +
+				hdr_idx * tbl_hdr_width;
+			cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+				IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
+			if (!cmd_pyld[num_cmd]) {
+				IPAERR(
+				"fail construct dma_shared_mem cmd: IP = %d\n",
+					ip);
+				rc = -ENOMEM;
+				goto fail_imm_cmd_construct;
+			}
+			ipa3_init_imm_cmd_desc(&desc[num_cmd],
+				cmd_pyld[num_cmd]);
+			++num_cmd;
 		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
 
 		/*
 		 * SRAM memory not allocated to hash tables. Sending command
 		 * to hash tables(filer/routing) operation not supported.
 		 */
-		if (!ipa3_ctx->ipa_fltrt_not_hashable) {
+		if (!ipa3_ctx->ipa_fltrt_not_hashable && hdr_known &&
+			ipa3_fltrt_shadow_match(shadow, true,
+			IPA_RULE_HASHABLE, hdr_idx * tbl_hdr_width,
+			&alloc_params.hash_hdr, tbl_hdr_width)) {
+			IPADBG_LOW("hash hdr of pipe %d unchanged\n", i);
+			dma_skipped++;
+		} else if (!ipa3_ctx->ipa_fltrt_not_hashable) {
 			mem_cmd.is_read = false;
 			mem_cmd.skip_pipeline_clear = false;
 			mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
@@ -757,7 +977,13 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		++hdr_idx;
 	}
 
-	if (lcl_nhash && alloc_params.num_lcl_nhash_tbls > 0) {
+	if (lcl_nhash && alloc_params.num_lcl_nhash_tbls > 0 &&
+		ipa3_fltrt_shadow_match(shadow, false, IPA_RULE_NON_HASHABLE,
+			0, &alloc_params.nhash_bdy,
+			alloc_params.nhash_bdy.size)) {
+		IPADBG_LOW("nhash lcl bodies unchanged: IP = %d\n", ip);
+		dma_skipped++;
+	} else if (lcl_nhash && alloc_params.num_lcl_nhash_tbls > 0) {
 		if (num_cmd >= entries) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -782,7 +1008,12 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
 		++num_cmd;
 	}
-	if (lcl_hash) {
+	if (lcl_hash && ipa3_fltrt_shadow_match(shadow, false,
+		IPA_RULE_HASHABLE, 0, &alloc_params.hash_bdy,
+		alloc_params.hash_bdy.size)) {
+		IPADBG_LOW("hash lcl bodies unchanged: IP = %d\n", ip);
+		dma_skipped++;
+	} else if (lcl_hash) {
 		if (num_cmd >= entries) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -823,12 +1054,25 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 
 		if (ipa3_send_cmd(num_cmd_to_send, desc_to_send)) {
 			IPAERR("fail to send immediate command batch\n");
+			/* SRAM may be partially written */
+			ipa3_fltrt_shadow_invalidate(shadow);
 			rc = -EFAULT;
 			goto fail_imm_cmd_construct;
 		}
 		desc_to_send += num_cmd_to_send;
 	}
 
+	ipa3_fltrt_shadow_update(shadow, &alloc_params);
+	shadow->hdr_skip_bmap = hdr_skip_bmap;
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		ipa3_ctx->flt_tbl[i][ip].dirty = false;
+	}
+	shadow->commits++;
+	shadow->tbls_gen += dirty_tbls;
+	shadow->dma_skipped += dma_skipped;
+
 	IPADBG_LOW("Hashable HEAD\n");
 	IPA_DUMP_BUFF(alloc_params.hash_hdr.base,
 		alloc_params.hash_hdr.phys_base, alloc_params.hash_hdr.size);
@@ -869,6 +1113,12 @@ fail_size_valid:
 	if (alloc_params.nhash_bdy.size)
 		ipahal_free_dma_mem(&alloc_params.nhash_bdy);
 prep_failed:
+	usec = ktime_us_delta(ktime_get(), start);
+	shadow->last_usec = usec;
+	if (usec > shadow->max_usec)
+		shadow->max_usec = usec;
+	trace_ipa3_fltrt_commit(true, ip, dirty_tbls,
+		shadow->tbls_reused - reused_base, dma_skipped, usec, rc);
 	return rc;
 }
 
@@ -1023,6 +1273,7 @@ static int __ipa_finish_flt_rule_add(struct ipa3_flt_tbl *tbl,
 	}
 	*rule_hdl = id;
 	entry->id = id;
+	tbl->dirty = true;
 	IPADBG_LOW("add flt rule rule_cnt=%d\n", tbl->rule_cnt);
 
 	return 0;
@@ -1140,6 +1391,7 @@ static int __ipa_del_flt_rule(u32 rule_hdl)
 
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	entry->tbl->dirty = true;
 	if (entry->rt_tbl && !ipa3_check_idr_if_freed(entry->rt_tbl))
 		entry->rt_tbl->ref_cnt--;
 	IPADBG("del flt rule rule_cnt=%d rule_id=%d\n",
@@ -1191,6 +1443,7 @@ static int __ipa_mdfy_flt_rule(struct ipa_flt_rule_mdfy_i *frule,
 		entry->cnt_idx = frule->rule.cnt_idx;
 	else
 		entry->cnt_idx = 0;
+	entry->tbl->dirty = true;
 
 	return 0;
 
@@ -1919,6 +2172,7 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 					entry->ipacm_installed) {
 				list_del(&entry->link);
 				entry->tbl->rule_cnt--;
+				entry->tbl->dirty = true;
 				if (entry->rt_tbl &&
 					(!ipa3_check_idr_if_freed(
 						entry->rt_tbl)))
@@ -2251,6 +2505,7 @@ int ipa_flt_sram_set_client_prio_high(enum ipa_client_type client)
 		list_for_each_entry_safe(
 			lcl_tbl, tmp, &ipa3_ctx->flt_tbl_nhash_lcl_list[ip], link) {
 			if (lcl_tbl->tbl == flt_tbl) {
+				lcl_tbl->pinned = true;
 				list_del(&lcl_tbl->link);
 				list_add_tail(&lcl_tbl->link,
 					&ipa3_ctx->flt_tbl_nhash_lcl_list[ip]);
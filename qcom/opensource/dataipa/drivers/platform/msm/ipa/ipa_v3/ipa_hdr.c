@@ -780,6 +780,10 @@ static int __ipa3_del_hdr_proc_ctx(u32 proc_ctx_hdl,
 	entry->cookie = 0;
 	kmem_cache_free(ipa3_ctx->hdr_proc_ctx_cache, entry);
 
+	/* rt rules referring to the proc ctx have to be regenerated */
+	ipa3_rt_set_tbls_dirty(IPA_IP_v4);
+	ipa3_rt_set_tbls_dirty(IPA_IP_v6);
+
 	/* remove the handle from the database */
 	ipa3_id_remove(proc_ctx_hdl);
 
@@ -870,6 +874,10 @@ int __ipa3_del_hdr(u32 hdr_hdl, bool by_user)
 	entry->cookie = 0;
 	kmem_cache_free(ipa3_ctx->hdr_cache, entry);
 
+	/* rt rules referring to the header have to be regenerated */
+	ipa3_rt_set_tbls_dirty(IPA_IP_v4);
+	ipa3_rt_set_tbls_dirty(IPA_IP_v6);
+
 	/* remove the handle from the database */
 	ipa3_id_remove(hdr_hdl);
 
@@ -1420,6 +1428,10 @@ int ipa3_reset_hdr(bool user_only)
 		htbl_proc->proc_ctx_cnt = 0;
 	}
 
+	/* header offsets may have been released, regenerate all rt rules */
+	ipa3_rt_set_tbls_dirty(IPA_IP_v4);
+	ipa3_rt_set_tbls_dirty(IPA_IP_v6);
+
 	/* commit the change to IPA-HW */
 	if (ipa3_ctx->ctrl->ipa3_commit_hdr()) {
 		IPAERR("fail to commit hdr\n");
@@ -7,6 +7,7 @@
 #include <linux/debugfs.h>
 #include <linux/kernel.h>
 #include <linux/delay.h>
+#include <linux/vmalloc.h>
 #include "ipa_i.h"
 #include "ipahal.h"
 #include "ipahal_hw_stats.h"
@@ -471,6 +472,591 @@ static void ipa_close_coal_frame(struct ipahal_imm_cmd_pyld **coal_cmd_pyld)
 		&reg_write_coal_close, false);
 }
 
+static bool ipa_hw_stats_need_coal_close(void)
+{
+	return ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
+		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa;
+}
+
+static struct ipahal_imm_cmd_pyld *ipa_hw_stats_read_cmd(u32 smem_ofst,
+	u32 size, dma_addr_t phys_base, bool clear, bool skip_pipeline_clear)
+{
+	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
+
+	cmd.is_read = true;
+	cmd.clear_after_read = clear;
+	cmd.skip_pipeline_clear = skip_pipeline_clear;
+	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+	cmd.size = size;
+	cmd.system_addr = phys_base;
+	cmd.local_addr = ipa3_ctx->smem_restricted_bytes + smem_ofst;
+	return ipahal_construct_imm_cmd(IPA_IMM_CMD_DMA_SHARED_MEM, &cmd,
+		false);
+}
+
+/**
+ * ipa_hw_stats_read() - read one stats region from SRAM and parse it
+ * @type: stats type
+ * @get_offset: hal get offset parameters of @type
+ * @init: hal init parameters of @type, passed to the parser
+ * @smem_ofst: offset of @type stats region in SRAM
+ * @clear: clear the HW counters after reading them
+ * @parsed: parsed stats, left untouched if there is nothing to read
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_hw_stats_read(enum ipahal_hw_stats_type type, void *get_offset,
+	void *init, u32 smem_ofst, bool clear, void *parsed)
+{
+	struct ipahal_stats_offset offset = { 0 };
+	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
+	struct ipa_mem_buffer mem;
+	struct ipa3_desc desc[2];
+	int num_cmd = 0;
+	int ret;
+	int i;
+
+	memset(desc, 0, sizeof(desc));
+	memset(cmd_pyld, 0, sizeof(cmd_pyld));
+
+	ret = ipahal_stats_get_offset(type, get_offset, &offset);
+	if (ret) {
+		IPAERR("failed to get offset from hal %d\n", ret);
+		return ret;
+	}
+
+	IPADBG_LOW("type %d offset = %d size = %d\n", type, offset.offset,
+		offset.size);
+
+	if (offset.size == 0)
+		return 0;
+
+	mem.size = offset.size;
+	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
+		mem.size,
+		&mem.phys_base,
+		GFP_KERNEL);
+	if (!mem.base) {
+		IPAERR("fail to alloc DMA memory\n");
+		return -ENOMEM;
+	}
+
+	/* IC to close the coal frame before HPS Clear if coal is enabled */
+	if (ipa_hw_stats_need_coal_close()) {
+		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct coal close IC\n");
+			ret = -ENOMEM;
+			goto free_dma_mem;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	cmd_pyld[num_cmd] = ipa_hw_stats_read_cmd(smem_ofst + offset.offset,
+		mem.size, mem.phys_base, clear, false);
+	if (!cmd_pyld[num_cmd]) {
+		IPAERR("failed to construct dma_shared_mem imm cmd\n");
+		ret = -ENOMEM;
+		goto destroy_imm;
+	}
+	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+	++num_cmd;
+
+	ret = ipa3_send_cmd(num_cmd, desc);
+	if (ret) {
+		IPAERR("failed to send immediate command (error %d)\n", ret);
+		goto destroy_imm;
+	}
+
+	ret = ipahal_parse_stats(type, init, mem.base, parsed);
+	if (ret)
+		IPAERR("failed to parse stats (error %d)\n", ret);
+
+destroy_imm:
+	for (i = 0; i < num_cmd; i++)
+		ipahal_destroy_imm_cmd(cmd_pyld[i]);
+free_dma_mem:
+	dma_free_coherent(ipa3_ctx->pdev, mem.size, mem.base, mem.phys_base);
+	return ret;
+}
+
+static void ipa_hw_stats_add_quota(struct ipahal_stats_quota_all *to,
+	struct ipahal_stats_quota_all *from)
+{
+	int i;
+
+	for (i = 0; i < IPAHAL_IPA5_PIPES_NUM; i++) {
+		to->stats[i].num_ipv4_bytes += from->stats[i].num_ipv4_bytes;
+		to->stats[i].num_ipv6_bytes += from->stats[i].num_ipv6_bytes;
+		to->stats[i].num_ipv4_pkts += from->stats[i].num_ipv4_pkts;
+		to->stats[i].num_ipv6_pkts += from->stats[i].num_ipv6_pkts;
+	}
+}
+
+static void ipa_hw_stats_add_teth(struct ipahal_stats_tethering_all *to,
+	struct ipahal_stats_tethering_all *from)
+{
+	struct ipahal_stats_tethering *t, *f;
+	int i, j;
+
+	for (i = 0; i < IPAHAL_IPA5_PIPES_NUM; i++) {
+		for (j = 0; j < IPAHAL_IPA5_PIPES_NUM; j++) {
+			t = &to->stats[i][j];
+			f = &from->stats[i][j];
+			t->num_ipv4_bytes += f->num_ipv4_bytes;
+			t->num_ipv6_bytes += f->num_ipv6_bytes;
+			t->num_ipv4_pkts += f->num_ipv4_pkts;
+			t->num_ipv6_pkts += f->num_ipv6_pkts;
+		}
+	}
+}
+
+static void ipa_hw_stats_add_drop(struct ipahal_stats_drop_all *to,
+	struct ipahal_stats_drop_all *from)
+{
+	int i;
+
+	for (i = 0; i < IPAHAL_IPA5_PIPES_NUM; i++) {
+		to->stats[i].drop_packet_cnt += from->stats[i].drop_packet_cnt;
+		to->stats[i].drop_byte_cnt += from->stats[i].drop_byte_cnt;
+	}
+}
+
+static void ipa_hw_stats_snap_add_cnt(struct ipa_hw_stats_snap_cnt *to,
+	u64 ipv4_bytes, u64 ipv6_bytes, u64 ipv4_pkts, u64 ipv6_pkts)
+{
+	to->num_ipv4_bytes += ipv4_bytes;
+	to->num_ipv6_bytes += ipv6_bytes;
+	to->num_ipv4_pkts += ipv4_pkts;
+	to->num_ipv6_pkts += ipv6_pkts;
+}
+
+/* accumulate the deltas read by a snapshot into the published layout */
+static void ipa_hw_stats_snap_publish(struct ipa_hw_stats_snap *to,
+	struct ipa_hw_stats_snap_ctx *snap)
+{
+	struct ipahal_stats_tethering *t;
+	struct ipahal_stats_quota *q;
+	int i, j;
+
+	BUILD_BUG_ON(IPA_HW_STATS_SNAP_PIPES_NUM != IPAHAL_IPA5_PIPES_NUM);
+
+	for (i = 0; i < IPAHAL_IPA5_PIPES_NUM; i++) {
+		q = &snap->quota.stats[i];
+		ipa_hw_stats_snap_add_cnt(&to->quota[i], q->num_ipv4_bytes,
+			q->num_ipv6_bytes, q->num_ipv4_pkts, q->num_ipv6_pkts);
+		for (j = 0; j < IPAHAL_IPA5_PIPES_NUM; j++) {
+			t = &snap->teth.stats[i][j];
+			ipa_hw_stats_snap_add_cnt(&to->teth[i][j],
+				t->num_ipv4_bytes, t->num_ipv6_bytes,
+				t->num_ipv4_pkts, t->num_ipv6_pkts);
+		}
+		to->drop[i].drop_packet_cnt +=
+			snap->drop.stats[i].drop_packet_cnt;
+		to->drop[i].drop_byte_cnt += snap->drop.stats[i].drop_byte_cnt;
+	}
+}
+
+static struct ipa_hw_stats_snap_ctx *ipa_hw_stats_snap_ctx(void)
+{
+	if (!ipa3_ctx->hw_stats)
+		return NULL;
+
+	/* pairs with smp_store_release() in ipa_hw_stats_snap_set_period() */
+	return smp_load_acquire(&ipa3_ctx->hw_stats->snap);
+}
+
+/**
+ * ipa_hw_stats_snap_take() - read all stats regions and publish a snapshot
+ * @snap: snapshots context, snap->lock must be held
+ *
+ * All the regions are read by one batch of immediate commands. Only the
+ * first read clears the HPS pipeline, the following ones run right after it.
+ * Quota, tethering and drop counters are cleared by the read, their deltas
+ * are accumulated in the published snapshot and kept in snap->pend_* until
+ * the getters move them to the driver cache. FnR counters are not cleared
+ * as they are owned by their users.
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_hw_stats_snap_take(struct ipa_hw_stats_snap_ctx *snap)
+{
+	struct ipa_hw_stats *hw_stats = ipa3_ctx->hw_stats;
+	struct ipahal_stats_get_offset_quota quota_ofst = { { 0 } };
+	struct ipahal_stats_get_offset_tethering teth_ofst;
+	struct ipahal_stats_get_offset_drop drop_ofst = { { 0 } };
+	struct ipahal_stats_get_offset_flt_rt_v4_5 fnr_ofst = { 0 };
+	struct ipahal_stats_offset offset[IPAHAL_HW_STATS_MAX];
+	void *get_offset[IPAHAL_HW_STATS_MAX] = { NULL };
+	void *init[IPAHAL_HW_STATS_MAX] = { NULL };
+	u32 smem_ofst[IPAHAL_HW_STATS_MAX] = { 0 };
+	u32 buf_ofst[IPAHAL_HW_STATS_MAX] = { 0 };
+	struct ipahal_imm_cmd_pyld *cmd_pyld[IPAHAL_HW_STATS_MAX + 1];
+	struct ipa3_desc desc[IPAHAL_HW_STATS_MAX + 1];
+	struct ipa_hw_stats_snap *cur, *next;
+	struct ipa_ioc_flt_rt_query query;
+	u64 seq = snap->map->seq;
+	int num_cmd = 0;
+	u32 size = 0;
+	int ret = 0;
+	int type;
+	int i;
+
+	memset(desc, 0, sizeof(desc));
+	memset(cmd_pyld, 0, sizeof(cmd_pyld));
+	memset(offset, 0, sizeof(offset));
+	memset(&teth_ofst, 0, sizeof(teth_ofst));
+
+	quota_ofst.init = hw_stats->quota.init;
+	get_offset[IPAHAL_HW_STATS_QUOTA] = &quota_ofst;
+	init[IPAHAL_HW_STATS_QUOTA] = &hw_stats->quota.init;
+	smem_ofst[IPAHAL_HW_STATS_QUOTA] = IPA_MEM_PART(stats_quota_ap_ofst);
+
+	if (hw_stats->teth_stats_enabled) {
+		teth_ofst.init = hw_stats->teth.init;
+		get_offset[IPAHAL_HW_STATS_TETHERING] = &teth_ofst;
+		init[IPAHAL_HW_STATS_TETHERING] = &hw_stats->teth.init;
+		smem_ofst[IPAHAL_HW_STATS_TETHERING] =
+			IPA_MEM_PART(stats_tethering_ofst);
+	}
+
+	if (ipa3_ctx->ipa_hw_type >= IPA_HW_v4_5) {
+		fnr_ofst.start_id = 1;
+		fnr_ofst.end_id = IPA_MAX_FLT_RT_CNT_INDEX;
+		get_offset[IPAHAL_HW_STATS_FNR] = &fnr_ofst;
+		smem_ofst[IPAHAL_HW_STATS_FNR] = IPA_MEM_PART(stats_fnr_ofst);
+	}
+
+	drop_ofst.init = hw_stats->drop.init;
+	get_offset[IPAHAL_HW_STATS_DROP] = &drop_ofst;
+	init[IPAHAL_HW_STATS_DROP] = &hw_stats->drop.init;
+	smem_ofst[IPAHAL_HW_STATS_DROP] = IPA_MEM_PART(stats_drop_ofst);
+
+	for (type = 0; type < IPAHAL_HW_STATS_MAX; type++) {
+		if (!get_offset[type])
+			continue;
+		ret = ipahal_stats_get_offset(type, get_offset[type],
+			&offset[type]);
+		if (ret) {
+			IPAERR("failed to get offset of %d from hal %d\n",
+				type, ret);
+			return ret;
+		}
+		buf_ofst[type] = size;
+		size += ALIGN(offset[type].size, 8);
+	}
+
+	if (size > snap->mem.size) {
+		if (snap->mem.base)
+			dma_free_coherent(ipa3_ctx->pdev, snap->mem.size,
+				snap->mem.base, snap->mem.phys_base);
+		snap->mem.size = size;
+		snap->mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
+			snap->mem.size, &snap->mem.phys_base, GFP_KERNEL);
+		if (!snap->mem.base) {
+			IPAERR("fail to alloc DMA memory\n");
+			snap->mem.size = 0;
+			return -ENOMEM;
+		}
+	}
+
+	/* IC to close the coal frame before HPS Clear if coal is enabled */
+	if (ipa_hw_stats_need_coal_close()) {
+		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct coal close IC\n");
+			return -ENOMEM;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	for (type = 0; type < IPAHAL_HW_STATS_MAX; type++) {
+		if (!offset[type].size)
+			continue;
+		cmd_pyld[num_cmd] = ipa_hw_stats_read_cmd(
+			smem_ofst[type] + offset[type].offset,
+			offset[type].size,
+			snap->mem.phys_base + buf_ofst[type],
+			type != IPAHAL_HW_STATS_FNR,
+			num_cmd > 0);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct dma_shared_mem imm cmd\n");
+			ret = -ENOMEM;
+			goto destroy_imm;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	ret = ipa3_send_cmd(num_cmd, desc);
+	if (ret) {
+		IPAERR("failed to send immediate command (error %d)\n", ret);
+		goto destroy_imm;
+	}
+
+	cur = &snap->map->snap[seq & 1];
+	next = &snap->map->snap[(seq + 1) & 1];
+	if (seq) {
+		memcpy(next->quota, cur->quota, sizeof(next->quota));
+		memcpy(next->teth, cur->teth, sizeof(next->teth));
+		memcpy(next->drop, cur->drop, sizeof(next->drop));
+	} else {
+		memset(next, 0, sizeof(*next));
+	}
+
+	memset(&snap->quota, 0, sizeof(snap->quota));
+	memset(&snap->teth, 0, sizeof(snap->teth));
+	memset(&snap->drop, 0, sizeof(snap->drop));
+	memset(next->fnr, 0, sizeof(next->fnr));
+
+	memset(&query, 0, sizeof(query));
+	query.start_id = fnr_ofst.start_id;
+	query.end_id = fnr_ofst.end_id;
+	query.stats_size = sizeof(next->fnr[0]);
+	query.stats = (u64)(uintptr_t)next->fnr;
+
+	for (type = 0; type < IPAHAL_HW_STATS_MAX && !ret; type++) {
+		if (!offset[type].size)
+			continue;
+		switch (type) {
+		case IPAHAL_HW_STATS_QUOTA:
+			ret = ipahal_parse_stats(type, init[type],
+				(u8 *)snap->mem.base + buf_ofst[type],
+				&snap->quota);
+			break;
+		case IPAHAL_HW_STATS_TETHERING:
+			ret = ipahal_parse_stats(type, init[type],
+				(u8 *)snap->mem.base + buf_ofst[type],
+				&snap->teth);
+			break;
+		case IPAHAL_HW_STATS_FNR:
+			ret = ipahal_parse_stats(type, NULL,
+				(u8 *)snap->mem.base + buf_ofst[type],
+				&query);
+			break;
+		case IPAHAL_HW_STATS_DROP:
+			ret = ipahal_parse_stats(type, init[type],
+				(u8 *)snap->mem.base + buf_ofst[type],
+				&snap->drop);
+			break;
+		default:
+			break;
+		}
+	}
+	if (ret) {
+		/*
+		 * the cleared counters are lost, as they would be for a
+		 * getter failing to parse them
+		 */
+		IPAERR("failed to parse stats (error %d)\n", ret);
+		goto destroy_imm;
+	}
+
+	ipa_hw_stats_snap_publish(next, snap);
+	ipa_hw_stats_add_quota(&snap->pend_quota, &snap->quota);
+	ipa_hw_stats_add_teth(&snap->pend_teth, &snap->teth);
+	ipa_hw_stats_add_drop(&snap->pend_drop, &snap->drop);
+
+	next->seq = seq + 1;
+	next->ts_ns = ktime_get_ns();
+	/* make the snapshot visible before publishing it */
+	smp_wmb();
+	WRITE_ONCE(snap->map->seq, seq + 1);
+
+	snap->last_jiffies = jiffies;
+	snap->fnr_stale = false;
+	snap->taken++;
+
+destroy_imm:
+	for (i = 0; i < num_cmd; i++)
+		ipahal_destroy_imm_cmd(cmd_pyld[i]);
+	return ret;
+}
+
+/*
+ * Bring the pending deltas up to date from a snapshot if snapshots are
+ * enabled. @force takes a snapshot even if the last one is recent, for the
+ * resets which must clear what the HW counted up to now.
+ * Returns true if the getter does not need to read the HW.
+ */
+static bool ipa_hw_stats_snap_sync(bool force)
+{
+	struct ipa_hw_stats_snap_ctx *snap = ipa_hw_stats_snap_ctx();
+	bool synced = false;
+
+	if (!snap)
+		return false;
+
+	mutex_lock(&snap->lock);
+	if (!snap->period_ms)
+		goto unlock;
+
+	if (force || !snap->map->seq || time_after_eq(jiffies,
+		snap->last_jiffies + msecs_to_jiffies(snap->period_ms))) {
+		if (ipa_hw_stats_snap_take(snap)) {
+			snap->failed++;
+			goto unlock;
+		}
+	}
+	synced = true;
+unlock:
+	mutex_unlock(&snap->lock);
+	return synced;
+}
+
+/* move the deltas read by the snapshots into @parsed */
+static void ipa_hw_stats_snap_drain(enum ipahal_hw_stats_type type,
+	void *parsed)
+{
+	struct ipa_hw_stats_snap_ctx *snap = ipa_hw_stats_snap_ctx();
+
+	if (!snap)
+		return;
+
+	mutex_lock(&snap->lock);
+	switch (type) {
+	case IPAHAL_HW_STATS_QUOTA:
+		ipa_hw_stats_add_quota(parsed, &snap->pend_quota);
+		memset(&snap->pend_quota, 0, sizeof(snap->pend_quota));
+		break;
+	case IPAHAL_HW_STATS_TETHERING:
+		ipa_hw_stats_add_teth(parsed, &snap->pend_teth);
+		memset(&snap->pend_teth, 0, sizeof(snap->pend_teth));
+		break;
+	case IPAHAL_HW_STATS_DROP:
+		ipa_hw_stats_add_drop(parsed, &snap->pend_drop);
+		memset(&snap->pend_drop, 0, sizeof(snap->pend_drop));
+		break;
+	default:
+		break;
+	}
+	mutex_unlock(&snap->lock);
+}
+
+static void ipa_hw_stats_snap_work(struct work_struct *work)
+{
+	struct ipa_hw_stats_snap_ctx *snap = container_of(to_delayed_work(work),
+		struct ipa_hw_stats_snap_ctx, work);
+	IPA_ACTIVE_CLIENTS_PREP_SIMPLE(log_info);
+
+	mutex_lock(&snap->lock);
+	if (!snap->period_ms)
+		goto unlock;
+
+	/* counters do not move while IPA is clocked off, do not wake it up */
+	if (ipa3_inc_client_enable_clks_no_block(&log_info)) {
+		snap->skipped++;
+	} else {
+		if (ipa_hw_stats_snap_take(snap))
+			snap->failed++;
+		ipa3_dec_client_disable_clks(&log_info);
+	}
+
+	schedule_delayed_work(&snap->work, msecs_to_jiffies(snap->period_ms));
+unlock:
+	mutex_unlock(&snap->lock);
+}
+
+/**
+ * ipa_hw_stats_snap_set_period() - start, re-time or stop the snapshots
+ * @period_ms: snapshot period, 0 stops the snapshots
+ *
+ * While snapshots run, the stats getters take their counters from the last
+ * snapshot if it is younger than @period_ms instead of reading the HW.
+ *
+ * Return: 0 on success, negative on failure
+ */
+int ipa_hw_stats_snap_set_period(u32 period_ms)
+{
+	struct ipa_hw_stats_snap_ctx *snap;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return -EPERM;
+
+	snap = ipa_hw_stats_snap_ctx();
+	if (!snap) {
+		if (!period_ms)
+			return 0;
+
+		snap = vzalloc(sizeof(*snap));
+		if (!snap)
+			return -ENOMEM;
+		snap->map = vmalloc_user(sizeof(*snap->map));
+		if (!snap->map) {
+			vfree(snap);
+			return -ENOMEM;
+		}
+		snap->map->version = IPA_HW_STATS_SNAP_VER;
+		snap->map->size = sizeof(*snap->map);
+		mutex_init(&snap->lock);
+		INIT_DELAYED_WORK(&snap->work, ipa_hw_stats_snap_work);
+		smp_store_release(&ipa3_ctx->hw_stats->snap, snap);
+	}
+
+	mutex_lock(&snap->lock);
+	snap->period_ms = period_ms;
+	if (period_ms)
+		mod_delayed_work(system_wq, &snap->work, 0);
+	mutex_unlock(&snap->lock);
+
+	if (!period_ms)
+		cancel_delayed_work_sync(&snap->work);
+
+	IPADBG("hw stats snapshot period %u ms\n", period_ms);
+	return 0;
+}
+
+/**
+ * ipa_hw_stats_snap_read() - copy the last published snapshot
+ * @out: the snapshot
+ *
+ * Does not take any lock nor access the HW.
+ *
+ * Return: 0 on success, -ENODATA if no snapshot was taken yet
+ */
+int ipa_hw_stats_snap_read(struct ipa_hw_stats_snap *out)
+{
+	struct ipa_hw_stats_snap_ctx *snap = ipa_hw_stats_snap_ctx();
+	u64 seq;
+
+	if (!snap)
+		return -ENODATA;
+
+	do {
+		seq = READ_ONCE(snap->map->seq);
+		if (!seq)
+			return -ENODATA;
+		/* pairs with smp_wmb() in ipa_hw_stats_snap_take() */
+		smp_rmb();
+		memcpy(out, &snap->map->snap[seq & 1], sizeof(*out));
+		smp_rmb();
+	} while (READ_ONCE(snap->map->seq) != seq);
+
+	return 0;
+}
+
+void ipa_hw_stats_snap_cleanup(void)
+{
+	struct ipa_hw_stats_snap_ctx *snap = ipa_hw_stats_snap_ctx();
+
+	if (!snap)
+		return;
+
+	mutex_lock(&snap->lock);
+	snap->period_ms = 0;
+	mutex_unlock(&snap->lock);
+	cancel_delayed_work_sync(&snap->work);
+
+	ipa3_ctx->hw_stats->snap = NULL;
+	if (snap->mem.base)
+		dma_free_coherent(ipa3_ctx->pdev, snap->mem.size,
+			snap->mem.base, snap->mem.phys_base);
+	vfree(snap->map);
+	vfree(snap);
+}
+
 static bool ipa_validate_quota_stats_sram_size(u32 needed_len)
 {
 	u32 sram_size;
@@ -674,97 +1260,35 @@ destroy_init_pyld:
 	return ret;
 }
 
-int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
+/*
+ * @reset: the caller resets the counters, read the HW even if a recent
+ * snapshot exists so that nothing counted before the reset survives it
+ */
+static int __ipa_get_quota_stats(struct ipa_quota_stats_all *out,
+	bool reset)
 {
 	int i;
 	int ret;
 	struct ipahal_stats_get_offset_quota get_offset = { { 0 } };
-	struct ipahal_stats_offset offset = { 0 };
-	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
-	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
-	struct ipa_mem_buffer mem;
-	struct ipa3_desc desc[2];
 	struct ipahal_stats_quota_all *stats;
-	int num_cmd = 0;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
-	memset(desc, 0, sizeof(desc));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
-
-	get_offset.init = ipa3_ctx->hw_stats->quota.init;
-	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_QUOTA, &get_offset,
-		&offset);
-	if (ret) {
-		IPAERR("failed to get offset from hal %d\n", ret);
-		return ret;
-	}
-
-	IPADBG_LOW("offset = %d size = %d\n", offset.offset, offset.size);
-
-	if (offset.size == 0)
-		return 0;
-
-	mem.size = offset.size;
-	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
-		mem.size,
-		&mem.phys_base,
-		GFP_KERNEL);
-	if (!mem.base) {
-		IPAERR("fail to alloc DMA memory");
-		return ret;
-	}
-
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
-		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
-		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			ret = -ENOMEM;
-			goto free_dma_mem;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
-
-	cmd.is_read = true;
-	cmd.clear_after_read = true;
-	cmd.skip_pipeline_clear = false;
-	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-	cmd.size = mem.size;
-	cmd.system_addr = mem.phys_base;
-	cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
-		IPA_MEM_PART(stats_quota_ap_ofst) + offset.offset;
-	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-		IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("failed to construct dma_shared_mem imm cmd\n");
-		ret = -ENOMEM;
-		goto free_dma_mem;
-	}
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-	++num_cmd;
-
-	ret = ipa3_send_cmd(num_cmd, desc);
-	if (ret) {
-		IPAERR("failed to send immediate command (error %d)\n", ret);
-		goto destroy_imm;
-	}
-
 	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
-	if (!stats) {
-		ret = -ENOMEM;
-		goto destroy_imm;
-	}
+	if (!stats)
+		return -ENOMEM;
 
-	ret = ipahal_parse_stats(IPAHAL_HW_STATS_QUOTA,
-		&ipa3_ctx->hw_stats->quota.init, mem.base, stats);
-	if (ret) {
-		IPAERR("failed to parse stats (error %d)\n", ret);
-		goto free_stats;
+	/* a recent snapshot already read the counters */
+	if (!ipa_hw_stats_snap_sync(reset)) {
+		get_offset.init = ipa3_ctx->hw_stats->quota.init;
+		ret = ipa_hw_stats_read(IPAHAL_HW_STATS_QUOTA, &get_offset,
+			&ipa3_ctx->hw_stats->quota.init,
+			IPA_MEM_PART(stats_quota_ap_ofst), true, stats);
+		if (ret)
+			goto free_stats;
 	}
+	ipa_hw_stats_snap_drain(IPAHAL_HW_STATS_QUOTA, stats);
 
 	/*
 	 * update driver cache.
@@ -796,13 +1320,12 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 	ret = 0;
 free_stats:
 	kfree(stats);
-destroy_imm:
-	for (i = 0; i < num_cmd; i++)
-		ipahal_destroy_imm_cmd(cmd_pyld[i]);
-free_dma_mem:
-	dma_free_coherent(ipa3_ctx->pdev, mem.size, mem.base, mem.phys_base);
 	return ret;
+}
 
+int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
+{
+	return __ipa_get_quota_stats(out, false);
 }
 
 int ipa_reset_quota_stats(enum ipa_client_type client)
@@ -819,7 +1342,7 @@ int ipa_reset_quota_stats(enum ipa_client_type client)
 	}
 
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_quota_stats(NULL);
+	ret = __ipa_get_quota_stats(NULL, true);
 	if (ret) {
 		IPAERR("ipa_get_quota_stats failed %d\n", ret);
 		return ret;
@@ -840,7 +1363,7 @@ int ipa_reset_all_quota_stats(void)
 		return 0;
 
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_quota_stats(NULL);
+	ret = __ipa_get_quota_stats(NULL, true);
 	if (ret) {
 		IPAERR("ipa_get_quota_stats failed %d\n", ret);
 		return ret;
@@ -1071,109 +1594,50 @@ destroy_init_pyld:
 	return ret;
 }
 
-int ipa_get_teth_stats(void)
+/*
+ * @reset: the caller resets the counters, read the HW even if a recent
+ * snapshot exists so that nothing counted before the reset survives it
+ */
+static int __ipa_get_teth_stats(bool reset)
 {
 	int i, j;
 	int prod_reg, cons_reg;
 	int ret;
 	struct ipahal_stats_get_offset_tethering get_offset;
-	struct ipahal_stats_offset offset = {0};
-	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
-	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
-	struct ipa_mem_buffer mem;
-	struct ipa3_desc desc[2];
 	struct ipahal_stats_tethering_all *stats_all;
 	struct ipa_hw_stats_teth *sw_stats;
-	struct ipahal_stats_tethering *stats;
-	struct ipa_quota_stats *quota_stats;
-	struct ipahal_stats_init_tethering *init;
-	int num_cmd = 0;
-
-	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled &&
-		ipa3_ctx->hw_stats->teth_stats_enabled))
-		return 0;
-
-	sw_stats = &ipa3_ctx->hw_stats->teth;
-	init = (struct ipahal_stats_init_tethering *)
-			&ipa3_ctx->hw_stats->teth.init;
-
-	memset(desc, 0, sizeof(desc));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
-	memset(&get_offset, 0, sizeof(get_offset));
-
-	get_offset.init = ipa3_ctx->hw_stats->teth.init;
-	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_TETHERING, &get_offset,
-		&offset);
-	if (ret) {
-		IPAERR("failed to get offset from hal %d\n", ret);
-		return ret;
-	}
-
-	IPADBG_LOW("offset = %d size = %d\n", offset.offset, offset.size);
-
-	if (offset.size == 0)
-		return 0;
-
-	mem.size = offset.size;
-	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
-		mem.size,
-		&mem.phys_base,
-		GFP_KERNEL);
-	if (!mem.base) {
-		IPAERR("fail to alloc DMA memory\n");
-		return ret;
-	}
-
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
-		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
-		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			ret = -ENOMEM;
-			goto free_dma_mem;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
+	struct ipahal_stats_tethering *stats;
+	struct ipa_quota_stats *quota_stats;
+	struct ipahal_stats_init_tethering *init;
 
-	cmd.is_read = true;
-	cmd.clear_after_read = true;
-	cmd.skip_pipeline_clear = false;
-	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-	cmd.size = mem.size;
-	cmd.system_addr = mem.phys_base;
-	cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
-		IPA_MEM_PART(stats_tethering_ofst) + offset.offset;
-	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-		IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("failed to construct dma_shared_mem imm cmd\n");
-		ret = -ENOMEM;
-		goto destroy_imm;
-	}
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-	++num_cmd;
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled &&
+		ipa3_ctx->hw_stats->teth_stats_enabled))
+		return 0;
 
-	ret = ipa3_send_cmd(num_cmd, desc);
-	if (ret) {
-		IPAERR("failed to send immediate command (error %d)\n", ret);
-		goto destroy_imm;
-	}
+	sw_stats = &ipa3_ctx->hw_stats->teth;
+	init = (struct ipahal_stats_init_tethering *)
+			&ipa3_ctx->hw_stats->teth.init;
 
 	stats_all = kzalloc(sizeof(*stats_all), GFP_KERNEL);
 	if (!stats_all) {
 		IPADBG("failed to alloc memory\n");
-		ret = -ENOMEM;
-		goto destroy_imm;
+		return -ENOMEM;
 	}
 
-	ret = ipahal_parse_stats(IPAHAL_HW_STATS_TETHERING,
-		&ipa3_ctx->hw_stats->teth.init, mem.base, stats_all);
-	if (ret) {
-		IPAERR("failed to parse stats_all (error %d)\n", ret);
-		goto free_stats;
+	/*
+	 * a recent snapshot already read the counters, prod_stats then
+	 * holds all the deltas read since the last call
+	 */
+	if (!ipa_hw_stats_snap_sync(reset)) {
+		memset(&get_offset, 0, sizeof(get_offset));
+		get_offset.init = ipa3_ctx->hw_stats->teth.init;
+		ret = ipa_hw_stats_read(IPAHAL_HW_STATS_TETHERING, &get_offset,
+			&ipa3_ctx->hw_stats->teth.init,
+			IPA_MEM_PART(stats_tethering_ofst), true, stats_all);
+		if (ret)
+			goto free_stats;
 	}
+	ipa_hw_stats_snap_drain(IPAHAL_HW_STATS_TETHERING, stats_all);
 
 	/* reset prod_stats cache */
 	for (i = 0; i < IPA_CLIENT_MAX; i++) {
@@ -1250,13 +1714,12 @@ int ipa_get_teth_stats(void)
 free_stats:
 	kfree(stats_all);
 	stats = NULL;
-destroy_imm:
-	for (i = 0; i < num_cmd; i++)
-		ipahal_destroy_imm_cmd(cmd_pyld[i]);
-free_dma_mem:
-	dma_free_coherent(ipa3_ctx->pdev, mem.size, mem.base, mem.phys_base);
 	return ret;
+}
 
+int ipa_get_teth_stats(void)
+{
+	return __ipa_get_teth_stats(false);
 }
 
 int ipa_query_teth_stats(enum ipa_client_type prod,
@@ -1294,7 +1757,7 @@ int ipa_reset_teth_stats(enum ipa_client_type prod, enum ipa_client_type cons)
 	}
 
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_teth_stats();
+	ret = __ipa_get_teth_stats(true);
 	if (ret) {
 		IPAERR("ipa_get_teth_stats failed %d\n", ret);
 		return ret;
@@ -1322,7 +1785,7 @@ int ipa_reset_all_cons_teth_stats(enum ipa_client_type prod)
 	}
 
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_teth_stats();
+	ret = __ipa_get_teth_stats(true);
 	if (ret) {
 		IPAERR("ipa_get_teth_stats failed %d\n", ret);
 		return ret;
@@ -1350,7 +1813,7 @@ int ipa_reset_all_teth_stats(void)
 	/* reading stats will reset them in hardware */
 	for (i = 0; i < IPA_CLIENT_MAX; i++) {
 		if (IPA_CLIENT_IS_PROD(i) && ipa3_get_ep_mapping(i) != -1) {
-			ret = ipa_get_teth_stats();
+			ret = __ipa_get_teth_stats(true);
 			if (ret) {
 				IPAERR("ipa_get_teth_stats failed %d\n", ret);
 				return ret;
@@ -1570,113 +2033,60 @@ destroy_init_pyld:
 
 static int __ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query)
 {
-	int ret;
-	int smem_ofst;
-	bool clear = query->reset;
-	struct ipahal_stats_get_offset_flt_rt_v4_5 *get_offset;
-	struct ipahal_stats_offset offset = { 0 };
-	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
-	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
-	struct ipa_mem_buffer mem;
-	struct ipa3_desc desc[2];
-	int num_cmd = 0;
-	int i;
-
-	memset(desc, 0, sizeof(desc));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
+	struct ipahal_stats_get_offset_flt_rt_v4_5 get_offset = { 0 };
 
-	get_offset = kzalloc(sizeof(*get_offset), GFP_KERNEL);
-	if (!get_offset) {
-		IPADBG("no mem\n");
-		return -ENOMEM;
-	}
+	get_offset.start_id = query->start_id;
+	get_offset.end_id = query->end_id;
 
-	smem_ofst = IPA_MEM_PART(stats_fnr_ofst);
+	return ipa_hw_stats_read(IPAHAL_HW_STATS_FNR, &get_offset, NULL,
+		IPA_MEM_PART(stats_fnr_ofst), query->reset, query);
+}
 
-	get_offset->start_id = query->start_id;
-	get_offset->end_id = query->end_id;
+/*
+ * FnR counters were cleared behind the last snapshot, queries go to the HW
+ * until the next snapshot reads them again.
+ */
+static void ipa_hw_stats_snap_fnr_reset(void)
+{
+	struct ipa_hw_stats_snap_ctx *snap = ipa_hw_stats_snap_ctx();
 
-	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_FNR, get_offset,
-		&offset);
-	if (ret) {
-		IPAERR("failed to get offset from hal %d\n", ret);
-		goto free_offset;
-	}
+	if (!snap)
+		return;
 
-	IPADBG("offset = %d size = %d\n", offset.offset, offset.size);
+	mutex_lock(&snap->lock);
+	snap->fnr_stale = true;
+	mutex_unlock(&snap->lock);
+}
 
-	if (offset.size == 0) {
+/* serve a query not resetting the counters from a recent snapshot */
+static int ipa_get_flt_rt_stats_snap(struct ipa_ioc_flt_rt_query *query)
+{
+	struct ipa_hw_stats_snap_ctx *snap = ipa_hw_stats_snap_ctx();
+	struct ipa_hw_stats_snap *last;
+	int ret = -ENODATA;
+
+	if (query->reset || !ipa_hw_stats_snap_sync(false))
+		return -ENODATA;
+
+	/* the snapshot cannot change while its writer lock is held */
+	mutex_lock(&snap->lock);
+	if (snap->map->seq && !snap->fnr_stale) {
+		last = &snap->map->snap[snap->map->seq & 1];
+		memcpy((void *)(uintptr_t)query->stats,
+			&last->fnr[query->start_id - 1],
+			(query->end_id - query->start_id + 1) *
+			sizeof(last->fnr[0]));
 		ret = 0;
-		goto free_offset;
-	}
-
-	mem.size = offset.size;
-	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
-		mem.size,
-		&mem.phys_base,
-		GFP_KERNEL);
-	if (!mem.base) {
-		IPAERR("fail to alloc DMA memory\n");
-		goto free_offset;
-	}
-
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
-		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
-		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			ret = -ENOMEM;
-			goto free_dma_mem;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
-
-	cmd.is_read = true;
-	cmd.clear_after_read = clear;
-	cmd.skip_pipeline_clear = false;
-	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-	cmd.size = mem.size;
-	cmd.system_addr = mem.phys_base;
-	cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
-		smem_ofst + offset.offset;
-	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-		IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("failed to construct dma_shared_mem imm cmd\n");
-		ret = -ENOMEM;
-		goto destroy_imm;
-	}
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-	++num_cmd;
-
-	ret = ipa3_send_cmd(num_cmd, desc);
-	if (ret) {
-		IPAERR("failed to send immediate command (error %d)\n", ret);
-		goto destroy_imm;
-	}
-
-	ret = ipahal_parse_stats(IPAHAL_HW_STATS_FNR,
-		NULL, mem.base, query);
-	if (ret) {
-		IPAERR("failed to parse stats (error %d)\n", ret);
-		goto destroy_imm;
 	}
-	ret = 0;
+	mutex_unlock(&snap->lock);
 
-destroy_imm:
-	for (i = 0; i < num_cmd; i++)
-		ipahal_destroy_imm_cmd(cmd_pyld[i]);
-free_dma_mem:
-	dma_free_coherent(ipa3_ctx->pdev, mem.size, mem.base, mem.phys_base);
-free_offset:
-	kfree(get_offset);
 	return ret;
 }
 
 int ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query)
 {
+	int ret;
+
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled)) {
 		IPAERR("hw_stats is not enabled\n");
 		return 0;
@@ -1717,7 +2127,14 @@ int ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query)
 		return -EINVAL;
 	}
 
-	return __ipa_get_flt_rt_stats(query);
+	if (!ipa_get_flt_rt_stats_snap(query))
+		return 0;
+
+	ret = __ipa_get_flt_rt_stats(query);
+	if (!ret && query->reset)
+		ipa_hw_stats_snap_fnr_reset();
+
+	return ret;
 }
 
 
@@ -2084,97 +2501,34 @@ fail_free_desc:
 	return ret;
 }
 
-int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
+/*
+ * @reset: the caller resets the counters, read the HW even if a recent
+ * snapshot exists so that nothing counted before the reset survives it
+ */
+static int __ipa_get_drop_stats(struct ipa_drop_stats_all *out, bool reset)
 {
 	int i;
 	int ret;
 	struct ipahal_stats_get_offset_drop get_offset = { { 0 } };
-	struct ipahal_stats_offset offset = { 0 };
-	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
-	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
-	struct ipa_mem_buffer mem;
-	struct ipa3_desc desc[2];
 	struct ipahal_stats_drop_all *stats;
-	int num_cmd = 0;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
-	memset(desc, 0, sizeof(desc));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
-
-	get_offset.init = ipa3_ctx->hw_stats->drop.init;
-	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_DROP, &get_offset,
-		&offset);
-	if (ret) {
-		IPAERR("failed to get offset from hal %d\n", ret);
-		return ret;
-	}
-
-	IPADBG_LOW("offset = %d size = %d\n", offset.offset, offset.size);
-
-	if (offset.size == 0)
-		return 0;
-
-	mem.size = offset.size;
-	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
-		mem.size,
-		&mem.phys_base,
-		GFP_KERNEL);
-	if (!mem.base) {
-		IPAERR("fail to alloc DMA memory\n");
-		return ret;
-	}
-
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
-		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
-		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			ret = -ENOMEM;
-			goto free_dma_mem;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
-
-	cmd.is_read = true;
-	cmd.clear_after_read = true;
-	cmd.skip_pipeline_clear = false;
-	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-	cmd.size = mem.size;
-	cmd.system_addr = mem.phys_base;
-	cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
-		IPA_MEM_PART(stats_drop_ofst) + offset.offset;
-	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-		IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("failed to construct dma_shared_mem imm cmd\n");
-		ret = -ENOMEM;
-		goto destroy_imm;
-	}
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-	++num_cmd;
-
-	ret = ipa3_send_cmd(num_cmd, desc);
-	if (ret) {
-		IPAERR("failed to send immediate command (error %d)\n", ret);
-		goto destroy_imm;
-	}
-
 	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
-	if (!stats) {
-		ret = -ENOMEM;
-		goto destroy_imm;
-	}
+	if (!stats)
+		return -ENOMEM;
 
-	ret = ipahal_parse_stats(IPAHAL_HW_STATS_DROP,
-		&ipa3_ctx->hw_stats->drop.init, mem.base, stats);
-	if (ret) {
-		IPAERR("failed to parse stats (error %d)\n", ret);
-		goto free_stats;
+	/* a recent snapshot already read the counters */
+	if (!ipa_hw_stats_snap_sync(reset)) {
+		get_offset.init = ipa3_ctx->hw_stats->drop.init;
+		ret = ipa_hw_stats_read(IPAHAL_HW_STATS_DROP, &get_offset,
+			&ipa3_ctx->hw_stats->drop.init,
+			IPA_MEM_PART(stats_drop_ofst), true, stats);
+		if (ret)
+			goto free_stats;
 	}
+	ipa_hw_stats_snap_drain(IPAHAL_HW_STATS_DROP, stats);
 
 	/*
 	 * update driver cache.
@@ -2208,13 +2562,12 @@ int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 	ret = 0;
 free_stats:
 	kfree(stats);
-destroy_imm:
-	for (i = 0; i < num_cmd; i++)
-		ipahal_destroy_imm_cmd(cmd_pyld[i]);
-free_dma_mem:
-	dma_free_coherent(ipa3_ctx->pdev, mem.size, mem.base, mem.phys_base);
 	return ret;
+}
 
+int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
+{
+	return __ipa_get_drop_stats(out, false);
 }
 
 int ipa_reset_drop_stats(enum ipa_client_type client)
@@ -2231,7 +2584,7 @@ int ipa_reset_drop_stats(enum ipa_client_type client)
 	}
 
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_drop_stats(NULL);
+	ret = __ipa_get_drop_stats(NULL, true);
 	if (ret) {
 		IPAERR("ipa_get_drop_stats failed %d\n", ret);
 		return ret;
@@ -2252,7 +2605,7 @@ int ipa_reset_all_drop_stats(void)
 		return 0;
 
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_drop_stats(NULL);
+	ret = __ipa_get_drop_stats(NULL, true);
 	if (ret) {
 		IPAERR("ipa_get_drop_stats failed %d\n", ret);
 		return ret;
@@ -2793,6 +3146,73 @@ bail:
 	return ret;
 }
 
+static ssize_t ipa_debugfs_set_snapshot_period(struct file *file,
+	const char __user *ubuf, size_t count, loff_t *ppos)
+{
+	u32 period_ms;
+	int ret;
+
+	ret = kstrtou32_from_user(ubuf, count, 0, &period_ms);
+	if (ret)
+		return ret;
+
+	mutex_lock(&ipa3_ctx->lock);
+	ret = ipa_hw_stats_snap_set_period(period_ms);
+	mutex_unlock(&ipa3_ctx->lock);
+
+	return ret ? ret : count;
+}
+
+static ssize_t ipa_debugfs_print_snapshot(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa_hw_stats_snap_ctx *snap = ipa_hw_stats_snap_ctx();
+	int nbytes = 0;
+
+	if (!snap) {
+		nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+			"snapshots disabled\n");
+		return simple_read_from_buffer(ubuf, count, ppos, dbg_buff,
+			nbytes);
+	}
+
+	mutex_lock(&snap->lock);
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"period_ms=%u\n"
+		"seq=%llu\n"
+		"ts_ns=%llu\n"
+		"taken=%u\n"
+		"skipped=%u\n"
+		"failed=%u\n"
+		"map_size=%u\n",
+		snap->period_ms,
+		snap->map->seq,
+		snap->map->seq ?
+			snap->map->snap[snap->map->seq & 1].ts_ns : 0,
+		snap->taken,
+		snap->skipped,
+		snap->failed,
+		snap->map->size);
+	mutex_unlock(&snap->lock);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+}
+
+static int ipa_debugfs_mmap_snapshot(struct file *file,
+	struct vm_area_struct *vma)
+{
+	struct ipa_hw_stats_snap_ctx *snap = ipa_hw_stats_snap_ctx();
+
+	if (!snap)
+		return -ENODEV;
+
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	return remap_vmalloc_range(vma, snap->map, vma->vm_pgoff);
+}
+
 static const struct file_operations ipa3_quota_ops = {
 	.read = ipa_debugfs_print_quota_stats,
 	.write = ipa_debugfs_reset_quota_stats,
@@ -2803,6 +3223,13 @@ static const struct file_operations ipa3_tethering_ops = {
 	.write = ipa_debugfs_reset_tethering_stats,
 };
 
+static const struct file_operations ipa3_snapshot_ops = {
+	.owner = THIS_MODULE,
+	.read = ipa_debugfs_print_snapshot,
+	.write = ipa_debugfs_set_snapshot_period,
+	.mmap = ipa_debugfs_mmap_snapshot,
+};
+
 static const struct file_operations ipa3_flt_rt_ops = {
 	.read = ipa_debugfs_print_flt_rt_stats,
 	.write = ipa_debugfs_control_flt_rt_stats,
@@ -2868,6 +3295,14 @@ int ipa_debugfs_init_stats(struct dentry *parent)
 		goto fail;
 	}
 
+	/* the debugfs proxy fops have no mmap, use the real ones */
+	file = debugfs_create_file_unsafe("snapshot", read_write_mode, dent,
+		NULL, &ipa3_snapshot_ops);
+	if (IS_ERR_OR_NULL(file)) {
+		IPAERR("fail to create file snapshot\n");
+		goto fail;
+	}
+
 	return 0;
 fail:
 	debugfs_remove_recursive(dent);
@@ -12,6 +12,8 @@
 #include <linux/cdev.h>
 #include <linux/export.h>
 #include <linux/idr.h>
+#include <linux/hashtable.h>
+#include <linux/jhash.h>
 #include <linux/list.h>
 #include <linux/mutex.h>
 #include <linux/skbuff.h>
@@ -41,6 +43,7 @@
 #include <linux/mailbox/qmp.h>
 #include <linux/rmnet_ipa_fd_ioctl.h>
 #include <linux/ipa_fmwk.h>
+#include <linux/ipa_hw_stats_snap.h>
 #include "ipa_uc_holb_monitor.h"
 #include <soc/qcom/minidump.h>
 
@@ -64,6 +67,9 @@
 
 #define MTU_BYTE 1500
 
+/* rt tables per ip family are bounded by the 32 entries index bitmap */
+#define IPA_RT_TBL_NAME_HASH_BITS 5
+
 #define IPA_EP_NOT_ALLOCATED (-1)
 #define IPA3_MAX_NUM_PIPES 31
 #define IPA5_PIPES_NUM 36
@@ -132,10 +138,15 @@ enum {
 #define IPA_PAGE_POLL_DEFAULT_THRESHOLD 15
 #define IPA_PAGE_POLL_THRESHOLD_MAX 30
 
-#define NTN3_CLIENTS_NUM 2
+#define IPA_TX_DB_BATCH_DEFAULT 8
+#define IPA_TX_DB_BATCH_MAX 32
+#define IPA_TX_DB_DEADLINE_DEFAULT_US 100
 
-#define IPA_MAX_NAPI_SORT_PAGE_THRSHLD 3
-#define IPA_MAX_PAGE_WQ_RESCHED_TIME 2
+#define IPA_RX_INTR_HYST_DEFAULT_US 100
+#define IPA_RX_INTR_HYST_MAX_US 2000
+#define IPA_RX_LAT_HIST_BINS 16
+
+#define NTN3_CLIENTS_NUM 2
 
 #define IPA_WDI2_OVER_GSI() (ipa3_ctx->ipa_wdi2_over_gsi \
 		&& (ipa_get_wdi_version() == IPA_WDI_2))
@@ -788,6 +799,7 @@ struct ipa3_flt_entry {
 /**
  * struct ipa3_rt_tbl - IPA routing table
  * @link: table's link in global routing tables list
+ * @name_node: table's node in the set name hash
  * @head_rt_rule_list: head of routing rules list
  * @name: routing table name
  * @idx: routing table index
@@ -801,9 +813,12 @@ struct ipa3_flt_entry {
  * @prev_mem: previous routing table block in sys memory
  * @id: routing table id
  * @rule_ids: common idr structure that holds the rule_id for each rule
+ * @dirty: rules changed since the last successful commit, the table
+ *  has to be regenerated. Clean sys tables re-use curr_mem as is.
  */
 struct ipa3_rt_tbl {
 	struct list_head link;
+	struct hlist_node name_node;
 	u32 cookie;
 	struct list_head head_rt_rule_list;
 	char name[IPA_RESOURCE_NAME_MAX];
@@ -817,6 +832,44 @@ struct ipa3_rt_tbl {
 	struct ipa_mem_buffer prev_mem[IPA_RULE_TYPE_MAX];
 	int id;
 	struct idr *rule_ids;
+	bool dirty;
+};
+
+/**
+ * struct ipa3_fltrt_cmt_shadow - last flt/rt image committed to SRAM
+ * @hdr: copy of the committed tables headers, NULL if SRAM content unknown
+ * @hdr_sz: size of @hdr
+ * @bdy: copy of the committed local tables bodies
+ * @bdy_sz: size of @bdy
+ * @hdr_skip_bmap: flt only, pipes whose header entries were not written
+ *  by the last commit and so are not known to match @hdr
+ * @commits: number of successful commits
+ * @tbls_gen: number of tables regenerated since they were dirty
+ * @tbls_reused: number of clean sys tables whose DDR body was re-used
+ * @dma_skipped: number of DMA commands skipped as SRAM was up to date
+ * @last_usec: duration of the last commit
+ * @max_usec: longest commit duration
+ * @sram_demoted: flt only, non-hash tables the last commit moved to DDR
+ *  since SRAM was too small
+ * @sram_ranks: flt only, number of times the non-hash tables were re-ranked
+ *  by their hit counters
+ * @sram_rank_jiffies: flt only, time of the last re-ranking
+ */
+struct ipa3_fltrt_cmt_shadow {
+	u8 *hdr[IPA_RULE_TYPE_MAX];
+	u32 hdr_sz[IPA_RULE_TYPE_MAX];
+	u8 *bdy[IPA_RULE_TYPE_MAX];
+	u32 bdy_sz[IPA_RULE_TYPE_MAX];
+	u64 hdr_skip_bmap;
+	u32 commits;
+	u32 tbls_gen;
+	u32 tbls_reused;
+	u32 dma_skipped;
+	u32 last_usec;
+	u32 max_usec;
+	u32 sram_demoted;
+	u32 sram_ranks;
+	unsigned long sram_rank_jiffies;
 };
 
 /**
@@ -945,6 +998,8 @@ struct ipa3_hdr_proc_ctx_tbl {
  * @rule_ids: common idr structure that holds the rule_id for each rule
  * @force_sys: flag indicating if filter table is forced to be
 			located in system memory
+ * @dirty: rules changed since the last successful commit, the table
+ *  has to be regenerated. Clean sys tables re-use curr_mem as is.
  */
 struct ipa3_flt_tbl {
 	struct list_head head_flt_rule_list;
@@ -956,11 +1011,27 @@ struct ipa3_flt_tbl {
 	bool sticky_rear;
 	struct idr *rule_ids;
 	bool force_sys[IPA_RULE_TYPE_MAX];
+	bool dirty;
 };
 
+/**
+ * struct ipa3_flt_tbl_nhash_lcl - non-hash filter table allowed in SRAM
+ * @link: entry's link in the SRAM priority list, head is moved to DDR first
+ * @tbl: filter table
+ * @pipe: pipe the table belongs to
+ * @pinned: SRAM priority was set by ipa_flt_sram_set_client_prio_high()
+ * @counted: table has non-hash rules with FnR counters, so it is ranked
+ * @hits: decayed number of packets hitting the table non-hash rules
+ * @last_pkts: counters sum seen by the last ranking
+ */
 struct ipa3_flt_tbl_nhash_lcl {
 	struct list_head link;
 	struct ipa3_flt_tbl *tbl;
+	int pipe;
+	bool pinned;
+	bool counted;
+	u64 hits;
+	u64 last_pkts;
 };
 
 /**
@@ -999,11 +1070,13 @@ struct ipa3_rt_entry {
 /**
  * struct ipa3_rt_tbl_set - collection of routing tables
  * @head_rt_tbl_list: collection of routing tables
+ * @name_ht: the tables of @head_rt_tbl_list hashed by name
  * @tbl_cnt: number of routing tables
  * @rule_ids: idr structure that holds the rule_id for each rule
  */
 struct ipa3_rt_tbl_set {
 	struct list_head head_rt_tbl_list;
+	DECLARE_HASHTABLE(name_ht, IPA_RT_TBL_NAME_HASH_BITS);
 	u32 tbl_cnt;
 	struct idr rule_ids;
 };
@@ -1175,10 +1248,52 @@ struct ipa3_repl_ctx {
 	atomic_t pending;
 };
 
+/**
+ * struct ipa3_tx_db_stats - TX doorbell batching statistics of a pipe
+ * @pkts: packets queued on the channel
+ * @db: doorbells rung for those packets
+ * @db_deadline: doorbells rung by the batch deadline timer
+ * @batch_hist: doorbells per number of packets they covered, bin i is
+ *  for i + 1 packets
+ */
+struct ipa3_tx_db_stats {
+	u64 pkts;
+	u64 db;
+	u64 db_deadline;
+	u64 batch_hist[IPA_TX_DB_BATCH_MAX];
+};
+
+/**
+ * struct ipa3_rx_lat_stats - RX interrupt to poll statistics of a pipe
+ * @hist: IRQ to first skb delivery latency, bin 0 is under 1 usec, bin i
+ *  covers [2^(i-1), 2^i) usec and the last bin everything above
+ * @busy_poll: NAPI polls run by a busy polling socket
+ * @hyst_polls: under budget polls which deferred the IRQ re-enable to the
+ *  hysteresis timer
+ */
+struct ipa3_rx_lat_stats {
+	u64 hist[IPA_RX_LAT_HIST_BINS];
+	u64 busy_poll;
+	u64 hyst_polls;
+};
+
+/**
+ * struct ipa3_page_repl_ctx - recycle ring of the pipe own rx pages
+ * @cache: capacity + 1 slots, pages handed to the stack in hand-off order
+ * @head_idx: next page to check for reuse
+ * @tail_idx: where pages are put back when handed to the stack
+ * @capacity: number of pages owned by the pool
+ *
+ * Pages being filled by HW are out of the ring. Once the pipe owning the
+ * pool is running, both ends are only used from its NAPI context, which
+ * the pipes sharing the pool poll from too, so no lock is taken.
+ * A page is free for reuse once page_ref_count() is back to 1.
+ */
 struct ipa3_page_repl_ctx {
-	struct list_head page_repl_head;
+	struct ipa3_rx_pkt_wrapper **cache;
+	u32 head_idx;
+	u32 tail_idx;
 	u32 capacity;
-	atomic_t pending;
 };
 
 /**
@@ -1198,6 +1313,12 @@ struct ipa3_page_repl_ctx {
  * @buff_size: rx packet length
  * @page_order: page order of the rx pipe based on the ioctl version
  * @ext_ioctl_v2: specifies if it's new version of ingress/egress ioctl
+ * @rx_irq_ts: time of the IRQ that moved the pipe to polling mode
+ * @rx_hyst_timer: re-polls the NAPI rx_intr_hyst_us after it ran out of
+ *  work, with the IRQ still masked
+ * @rx_hyst_pending: the next poll is the one run by @rx_hyst_timer
+ * @rx_lat: interrupt to poll statistics
+ * @pm_bytes: bytes completed on the pipe, sampled by the PM clock governor
  *
  * IPA context specific to the GPI pipes a.k.a LAN IN/OUT and WAN
  */
@@ -1209,6 +1330,8 @@ struct ipa3_sys_context {
 	enum ipa3_sys_pipe_policy policy;
 	bool use_comm_evt_ring;
 	bool nop_pending;
+	u32 db_pending;
+	struct ipa3_tx_db_stats db_stats;
 	int (*pyld_hdlr)(struct sk_buff *skb, struct ipa3_sys_context *sys);
 	struct sk_buff * (*get_skb)(unsigned int len, gfp_t flags);
 	void (*free_skb)(struct sk_buff *skb);
@@ -1245,9 +1368,11 @@ struct ipa3_sys_context {
 	bool ext_ioctl_v2;
 	bool common_buff_pool;
 	struct ipa3_sys_context *common_sys;
-	struct tasklet_struct tasklet_find_freepage;
-	atomic_t page_avilable;
-	u32 napi_sort_page_thrshld_cnt;
+	ktime_t rx_irq_ts;
+	struct hrtimer rx_hyst_timer;
+	bool rx_hyst_pending;
+	struct ipa3_rx_lat_stats rx_lat;
+	u64 pm_bytes;
 
 	/* ordering is important - mutable fields go above */
 	struct ipa3_ep_context *ep;
@@ -1257,14 +1382,13 @@ struct ipa3_sys_context {
 	u32 avail_tx_wrapper;
 	spinlock_t spinlock;
 	struct hrtimer db_timer;
+	struct hrtimer db_batch_timer;
 	struct workqueue_struct *wq;
 	struct workqueue_struct *repl_wq;
 	struct ipa3_status_stats *status_stat;
 	u32 pm_hdl;
-	struct workqueue_struct *freepage_wq;
 	unsigned int napi_sch_cnt;
 	unsigned int napi_comp_cnt;
-	struct delayed_work freepage_work;
 	/* ordering is important - other immutable fields go below */
 };
 
@@ -1579,6 +1703,7 @@ struct ipa3_page_recycle_stats {
 	u64 total_replenished;
 	u64 page_recycled;
 	u64 tmp_alloc;
+	u64 ring_busy;
 };
 
 struct ipa3_stats {
@@ -1615,9 +1740,6 @@ struct ipa3_stats {
 	atomic_t num_buff_above_thresh_for_coal_pipe_notified;
 	atomic_t num_buff_below_thresh_for_def_pipe_notified;
 	atomic_t num_buff_below_thresh_for_coal_pipe_notified;
-	u64 num_sort_tasklet_sched[3];
-	u64 num_of_times_wq_reschd;
-	u64 page_recycle_cnt_in_tasklet;
 };
 
 /* offset for each stats */
@@ -1948,6 +2070,44 @@ struct ipa_hw_stats_drop {
 	struct ipa_drop_stats_all stats;
 };
 
+/**
+ * struct ipa_hw_stats_snap_ctx - periodic HW statistics snapshots
+ * @lock: serializes the snapshots and the getters consuming @pend_*
+ * @work: periodic snapshot work
+ * @period_ms: snapshot period, 0 when disabled
+ * @last_jiffies: time of the last snapshot
+ * @fnr_stale: FnR counters were reset after the last snapshot read them
+ * @map: published snapshots
+ * @mem: DMA buffer all the stats regions are read into
+ * @quota: quota stats read by the last snapshot
+ * @teth: tethering stats read by the last snapshot
+ * @drop: drop stats read by the last snapshot
+ * @pend_quota: quota stats read by snapshots, not yet in the driver cache
+ * @pend_teth: tethering stats read by snapshots, not yet in the driver cache
+ * @pend_drop: drop stats read by snapshots, not yet in the driver cache
+ * @taken: number of snapshots taken
+ * @skipped: number of periods skipped since IPA was clocked off
+ * @failed: number of snapshots which failed
+ */
+struct ipa_hw_stats_snap_ctx {
+	struct mutex lock;
+	struct delayed_work work;
+	u32 period_ms;
+	unsigned long last_jiffies;
+	bool fnr_stale;
+	struct ipa_hw_stats_snap_map *map;
+	struct ipa_mem_buffer mem;
+	struct ipahal_stats_quota_all quota;
+	struct ipahal_stats_tethering_all teth;
+	struct ipahal_stats_drop_all drop;
+	struct ipahal_stats_quota_all pend_quota;
+	struct ipahal_stats_tethering_all pend_teth;
+	struct ipahal_stats_drop_all pend_drop;
+	u32 taken;
+	u32 skipped;
+	u32 failed;
+};
+
 struct ipa_hw_stats {
 	bool enabled;
 	struct ipa_hw_stats_quota quota;
@@ -1955,6 +2115,7 @@ struct ipa_hw_stats {
 	struct ipa_hw_stats_flt_rt flt_rt;
 	struct ipa_hw_stats_drop drop;
 	bool teth_stats_enabled;
+	struct ipa_hw_stats_snap_ctx *snap;
 };
 
 struct ipa_cne_evt {
@@ -2190,6 +2351,8 @@ struct ipa_minidump_data {
  * @hdr_proc_ctx_tbl: IPA processing context table
  * @rt_tbl_set: list of routing tables each of which is a list of rules
  * @reap_rt_tbl_set: list of sys mem routing tables waiting to be reaped
+ * @flt_cmt_shadow: last filter tables image committed, per ip
+ * @rt_cmt_shadow: last routing tables image committed, per ip
  * @flt_rule_cache: filter rule cache
  * @rt_rule_cache: routing rule cache
  * @hdr_cache: header cache
@@ -2314,6 +2477,8 @@ struct ipa3_context {
 	struct ipa3_hdr_proc_ctx_tbl hdr_proc_ctx_tbl;
 	struct ipa3_rt_tbl_set rt_tbl_set[IPA_IP_MAX];
 	struct ipa3_rt_tbl_set reap_rt_tbl_set[IPA_IP_MAX];
+	struct ipa3_fltrt_cmt_shadow flt_cmt_shadow[IPA_IP_MAX];
+	struct ipa3_fltrt_cmt_shadow rt_cmt_shadow[IPA_IP_MAX];
 	struct kmem_cache *flt_rule_cache;
 	struct kmem_cache *rt_rule_cache;
 	struct kmem_cache *hdr_cache;
@@ -2523,6 +2688,9 @@ struct ipa3_context {
 	u16 ulso_ip_id_max;
 	bool use_pm_wrapper;
 	u8 page_poll_threshold;
+	u32 tx_db_batch_max;
+	u32 tx_db_deadline_us;
+	u32 rx_intr_hyst_us;
 	bool wan_common_page_pool;
 	bool use_tput_est_ep;
 	struct ipa_ioc_eogre_info eogre_cache;
@@ -2549,8 +2717,6 @@ struct ipa3_context {
 	int ipa_pil_load;
 	phys_addr_t per_stats_smem_pa;
 	void *per_stats_smem_va;
-	u32 ipa_max_napi_sort_page_thrshld;
-	u32 page_wq_reschd_time;
 	struct list_head minidump_list_head;
 	bool is_dual_pine_config;
 	struct workqueue_struct *collect_recycle_stats_wq;
@@ -3113,6 +3279,9 @@ int ipa3_set_single_ndp_per_mbim(bool enable);
 int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 		struct ipa_tx_meta *metadata);
 
+int ipa3_tx_dp_xmit_more(enum ipa_client_type dst, struct sk_buff *skb,
+		struct ipa_tx_meta *metadata, bool xmit_more);
+
 /*
  * To transfer multiple data packets
  * While passing the data descriptor list, the anchor node
@@ -3389,6 +3558,15 @@ int _ipa_init_flt6_v3(void);
 
 int __ipa_commit_flt_v3(enum ipa_ip_type ip);
 int __ipa_commit_rt_v3(enum ipa_ip_type ip);
+void ipa3_flt_set_tbls_dirty(enum ipa_ip_type ip);
+void ipa3_rt_set_tbls_dirty(enum ipa_ip_type ip);
+bool ipa3_fltrt_shadow_match(struct ipa3_fltrt_cmt_shadow *shadow,
+	bool is_hdr, enum ipa_rule_type rlt, u32 ofst,
+	struct ipa_mem_buffer *mem, u32 size);
+void ipa3_fltrt_shadow_update(struct ipa3_fltrt_cmt_shadow *shadow,
+	struct ipahal_fltrt_alloc_imgs_params *params);
+void ipa3_fltrt_shadow_invalidate(struct ipa3_fltrt_cmt_shadow *shadow);
+void ipa3_fltrt_shadow_invalidate_all(void);
 
 int __ipa_commit_hdr_v3_0(void);
 void ipa3_skb_recycle(struct sk_buff *skb);
@@ -3526,6 +3704,12 @@ int ipa_get_flt_rt_stats(struct ipa_ioc_flt_rt_query *query);
 
 int ipa_set_flt_rt_stats(int index, struct ipa_flt_rt_stats stats);
 
+int ipa_hw_stats_snap_set_period(u32 period_ms);
+
+int ipa_hw_stats_snap_read(struct ipa_hw_stats_snap *out);
+
+void ipa_hw_stats_snap_cleanup(void);
+
 bool ipa_get_fnr_info(struct ipacm_fnr_info *fnr_info);
 
 u32 ipa3_get_max_num_pipes(void);
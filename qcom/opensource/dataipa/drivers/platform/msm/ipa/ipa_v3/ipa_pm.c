@@ -49,6 +49,19 @@
 	IPA_PM_DBG_LOW("Client[%d] %s: %s\n", hdl, name, \
 		client_state_to_str[state])
 
+/* predictive governor tunables */
+#define IPA_PM_GOV_PERIOD_MSEC 20
+/* rates are kept in 1/16 Mbps, EWMA weight is 1/4 */
+#define IPA_PM_GOV_FIXP 4
+#define IPA_PM_GOV_EWMA_SHIFT 2
+/* number of sample periods the rising slope is extrapolated over */
+#define IPA_PM_GOV_LOOKAHEAD 4
+/* ring occupancy percentage that asks for a faster clock */
+#define IPA_PM_GOV_OCC_HIGH 75
+/* demand must drop below this percentage of the threshold to scale down */
+#define IPA_PM_GOV_HYST_PCT 85
+#define IPA_PM_GOV_DWELL_MSEC 200
+
 /*
  * struct ipa_pm_exception_list - holds information about an exception
  * @pending: number of clients in exception that have not yet been adctivated
@@ -71,7 +84,9 @@ struct ipa_pm_exception_list {
  * contain non-null client
  * @threshold_size: size of the throughput threshold
  * @exception_size: size of the exception list
- * @cur_vote: idx of the threshold
+ * @cur_vote: idx of the threshold, written under client_mutex and @lock
+ * @manual_idx: @cur_vote was set by ipa_pm_set_clock_index(), the governor
+ *	leaves it alone until the next do_clk_scaling()
  * @default_threshold: the thresholds used if no exception passes
  * @current_threshold: the current threshold of the clock plan
  */
@@ -83,6 +98,7 @@ struct clk_scaling_db {
 	int threshold_size;
 	int exception_size;
 	int cur_vote;
+	bool manual_idx;
 	int default_threshold[IPA_PM_THRESHOLD_MAX];
 	int *current_threshold;
 };
@@ -166,6 +182,11 @@ struct ipa_pm_client {
  * @client_mutex: global mutex to  lock the client arrays
  * @aggragated_tput: aggragated tput value of all valid activated clients
  * @group_tput: combined throughput for the groups
+ * @gov: predictive clock scaling governor, protected by client_mutex
+ * @gov_work: periodic datapath sampling for the governor
+ * @gov_ts: time of the previous datapath sample
+ * @gov_bytes: pipe byte counters at the previous datapath sample
+ * @gov_pipe_rate: per pipe EWMA of the byte rate in 1/16 Mbps
  */
 struct ipa_pm_ctx {
 	struct ipa_pm_client *clients[IPA_PM_MAX_CLIENTS];
@@ -175,6 +196,11 @@ struct ipa_pm_ctx {
 	struct mutex client_mutex;
 	int aggregated_tput;
 	int group_tput[IPA_PM_GROUP_MAX];
+	struct ipa_pm_gov gov;
+	struct delayed_work gov_work;
+	ktime_t gov_ts;
+	u64 gov_bytes[IPA5_PIPES_NUM];
+	int gov_pipe_rate[IPA5_PIPES_NUM];
 };
 
 static struct ipa_pm_ctx *ipa_pm_ctx;
@@ -195,6 +221,16 @@ static const char *ipa_pm_group_to_str[IPA_PM_GROUP_MAX] = {
 	__stringify(IPA_PM_GROUP_MODEM),
 };
 
+static const char *ipa_pm_gov_reason_to_str[IPA_PM_GOV_REASON_MAX] = {
+	__stringify(IPA_PM_GOV_STEADY),
+	__stringify(IPA_PM_GOV_UP_DEMAND),
+	__stringify(IPA_PM_GOV_UP_TREND),
+	__stringify(IPA_PM_GOV_UP_OCCUPANCY),
+	__stringify(IPA_PM_GOV_DOWN),
+	__stringify(IPA_PM_GOV_HOLD_HYST),
+	__stringify(IPA_PM_GOV_HOLD_DWELL),
+};
+
 static int dummy_hdl_1, dummy_hdl_2, tput_modem, tput_apps;
 
 /**
@@ -347,6 +383,155 @@ static void set_current_threshold(void)
 	spin_unlock_irqrestore(&ipa_pm_ctx->clk_scaling.lock, flags);
 }
 
+/**
+ * ipa_pm_gov_level() - clock vote index needed for a given demand
+ * @threshold: throughput thresholds of the clock plan
+ * @threshold_size: size of @threshold
+ * @demand: demand in Mbps
+ *
+ * Returns: vote index, same scale as do_clk_scaling()
+ */
+static int ipa_pm_gov_level(const int *threshold, int threshold_size,
+	int demand)
+{
+	int i, idx = 1;
+
+	for (i = 0; i < threshold_size; i++) {
+		if (demand >= threshold[i])
+			idx++;
+	}
+
+	return idx;
+}
+
+static void ipa_pm_gov_log(struct ipa_pm_gov *gov,
+	const struct ipa_pm_gov_sample *s, int predicted, int old_vote,
+	enum ipa_pm_gov_reason reason)
+{
+	struct ipa_pm_gov_trace *t;
+
+	if (old_vote == gov->vote && reason == gov->last_reason)
+		return;
+	gov->last_reason = reason;
+
+	t = &gov->trace[gov->trace_idx++ % IPA_PM_GOV_TRACE_LEN];
+	t->ts_ms = s->ts_ms;
+	t->rate = s->rate;
+	t->predicted = predicted;
+	t->occupancy = s->occupancy;
+	t->old_vote = old_vote;
+	t->new_vote = gov->vote;
+	t->reason = reason;
+
+	if (old_vote != gov->vote)
+		IPA_PM_DBG("vote %d->%d %s rate %d pred %d occ %d%%\n",
+			old_vote, gov->vote, ipa_pm_gov_reason_to_str[reason],
+			s->rate, predicted, s->occupancy);
+}
+
+/**
+ * ipa_pm_gov_reset() - restart the predictive governor from a given vote
+ * @gov: governor state
+ * @vote: the clock vote currently applied
+ * @ts_ms: current time in msec
+ *
+ * Statistics and the decision trace are kept.
+ */
+void ipa_pm_gov_reset(struct ipa_pm_gov *gov, int vote, u32 ts_ms)
+{
+	gov->ewma = 0;
+	gov->vote = vote;
+	gov->vote_ts_ms = ts_ms;
+	gov->low = false;
+	gov->last_reason = IPA_PM_GOV_STEADY;
+}
+
+/**
+ * ipa_pm_gov_step() - feed one sample to the predictive governor
+ * @gov: governor state
+ * @threshold: throughput thresholds of the clock plan
+ * @threshold_size: size of @threshold
+ * @s: the new sample
+ *
+ * The measured rate is smoothed by an EWMA and extrapolated along its rising
+ * slope, so a ramp is voted for before it crosses a threshold. Ring occupancy
+ * above IPA_PM_GOV_OCC_HIGH raises the vote even when the rate does not ask
+ * for it. Raising is immediate; lowering needs the demand to stay under the
+ * hysteresis band for IPA_PM_GOV_DWELL_MSEC and the current vote to be at
+ * least that old, which keeps the clock from following every dip.
+ *
+ * Returns: the new clock vote index
+ */
+int ipa_pm_gov_step(struct ipa_pm_gov *gov, const int *threshold,
+	int threshold_size, const struct ipa_pm_gov_sample *s)
+{
+	enum ipa_pm_gov_reason reason = IPA_PM_GOV_STEADY;
+	int old_vote = gov->vote;
+	int ewma, slope, predicted, demand, target;
+
+	ewma = gov->ewma + (((s->rate << IPA_PM_GOV_FIXP) - gov->ewma) >>
+		IPA_PM_GOV_EWMA_SHIFT);
+	slope = max(ewma - gov->ewma, 0);
+	gov->ewma = ewma;
+	predicted = (ewma + slope * IPA_PM_GOV_LOOKAHEAD) >> IPA_PM_GOV_FIXP;
+	demand = max3(s->client_tput, s->rate, predicted);
+
+	target = ipa_pm_gov_level(threshold, threshold_size, demand);
+	if (target > gov->vote) {
+		if (ipa_pm_gov_level(threshold, threshold_size,
+			max(s->client_tput, s->rate)) > gov->vote)
+			reason = IPA_PM_GOV_UP_DEMAND;
+		else
+			reason = IPA_PM_GOV_UP_TREND;
+	} else if (s->occupancy >= IPA_PM_GOV_OCC_HIGH) {
+		/* never scale down while the rings are backing up */
+		target = min(gov->vote + 1, threshold_size + 1);
+		reason = IPA_PM_GOV_UP_OCCUPANCY;
+	}
+
+	if (target > gov->vote) {
+		gov->vote = target;
+		gov->vote_ts_ms = s->ts_ms;
+		gov->low = false;
+		gov->ups++;
+		ipa_pm_gov_log(gov, s, demand, old_vote, reason);
+		return gov->vote;
+	}
+
+	if (target == gov->vote) {
+		gov->low = false;
+		ipa_pm_gov_log(gov, s, demand, old_vote, IPA_PM_GOV_STEADY);
+		return gov->vote;
+	}
+
+	/* threshold[vote - 2] is the one the current vote was taken for */
+	if (demand * 100 >= threshold[gov->vote - 2] * IPA_PM_GOV_HYST_PCT) {
+		gov->low = false;
+		reason = IPA_PM_GOV_HOLD_HYST;
+	} else {
+		if (!gov->low) {
+			gov->low = true;
+			gov->low_since_ms = s->ts_ms;
+		}
+		if (s->ts_ms - gov->low_since_ms >= IPA_PM_GOV_DWELL_MSEC &&
+			s->ts_ms - gov->vote_ts_ms >= IPA_PM_GOV_DWELL_MSEC) {
+			gov->vote = target;
+			gov->vote_ts_ms = s->ts_ms;
+			gov->low = false;
+			gov->downs++;
+			reason = IPA_PM_GOV_DOWN;
+		} else {
+			reason = IPA_PM_GOV_HOLD_DWELL;
+		}
+	}
+
+	if (reason != IPA_PM_GOV_DOWN)
+		gov->holds++;
+	ipa_pm_gov_log(gov, s, demand, old_vote, reason);
+
+	return gov->vote;
+}
+
 /**
  * do_clk_scaling() - set the clock based on the activated clients
  *
@@ -357,6 +542,7 @@ static int do_clk_scaling(void)
 	int i, tput;
 	int new_th_idx = 1;
 	struct clk_scaling_db *clk_scaling;
+	unsigned long flags;
 
 	if (atomic_read(&ipa3_ctx->ipa_clk_vote) == 0) {
 		IPA_PM_DBG("IPA clock is gated\n");
@@ -371,8 +557,6 @@ static int do_clk_scaling(void)
 	ipa_pm_ctx->aggregated_tput = tput;
 	set_current_threshold();
 
-	mutex_unlock(&ipa_pm_ctx->client_mutex);
-
 	for (i = 0; i < clk_scaling->threshold_size; i++) {
 		if (tput >= clk_scaling->current_threshold[i])
 			new_th_idx++;
@@ -380,13 +564,27 @@ static int do_clk_scaling(void)
 
 	IPA_PM_DBG_LOW("old idx was at %d\n", ipa_pm_ctx->clk_scaling.cur_vote);
 
-
-	if (ipa_pm_ctx->clk_scaling.cur_vote != new_th_idx) {
-		ipa_pm_ctx->clk_scaling.cur_vote = new_th_idx;
-		ipa3_set_clock_plan_from_pm(ipa_pm_ctx->clk_scaling.cur_vote);
+	/* the governor decides when to scale down */
+	if (READ_ONCE(ipa_pm_ctx->gov.enabled)) {
+		new_th_idx = max(new_th_idx, clk_scaling->cur_vote);
+		queue_delayed_work(ipa_pm_ctx->wq, &ipa_pm_ctx->gov_work, 0);
 	}
 
+
+	spin_lock_irqsave(&clk_scaling->lock, flags);
+	clk_scaling->manual_idx = false;
+	if (clk_scaling->cur_vote == new_th_idx)
+		new_th_idx = 0;
+	else
+		clk_scaling->cur_vote = new_th_idx;
+	spin_unlock_irqrestore(&clk_scaling->lock, flags);
+
+	/* under client_mutex so the governor cannot reorder the plans */
+	if (new_th_idx)
+		ipa3_set_clock_plan_from_pm(new_th_idx);
+
 	IPA_PM_DBG_LOW("new idx is at %d\n", ipa_pm_ctx->clk_scaling.cur_vote);
+	mutex_unlock(&ipa_pm_ctx->client_mutex);
 
 	return 0;
 }
@@ -399,6 +597,138 @@ static void clock_scaling_func(struct work_struct *work)
 	do_clk_scaling();
 }
 
+/**
+ * ipa_pm_gov_sample_pipes() - measure the datapath since the previous sample
+ * @ms: [out] time elapsed since the previous sample
+ * @occupancy: [out] highest ring occupancy over the pipes in percent
+ *
+ * The byte counters are updated by the datapath on TX and RX completions.
+ * TX occupancy is the share of the ring holding in flight descriptors, RX
+ * occupancy is the share of the buffer pool waiting to be replenished.
+ *
+ * Returns: aggregated rate in Mbps, the larger of the two directions
+ */
+static int ipa_pm_gov_sample_pipes(u32 *ms, int *occupancy)
+{
+	struct ipa3_ep_context *ep;
+	struct ipa3_sys_context *sys;
+	u64 prod_bytes = 0, cons_bytes = 0;
+	u64 bytes, delta;
+	u32 ring, occ;
+	ktime_t now;
+	int i, rate;
+
+	now = ktime_get();
+	*ms = ktime_to_ns(ipa_pm_ctx->gov_ts) ?
+		ktime_ms_delta(now, ipa_pm_ctx->gov_ts) : 0;
+	*occupancy = 0;
+
+	for (i = 0; i < ipa3_get_max_num_pipes(); i++) {
+		ep = &ipa3_ctx->ep[i];
+		sys = ep->sys;
+		if (!ep->valid || !sys || ep->client == IPA_CLIENT_APPS_CMD_PROD)
+			continue;
+
+		bytes = READ_ONCE(sys->pm_bytes);
+		delta = bytes - ipa_pm_ctx->gov_bytes[i];
+		ipa_pm_ctx->gov_bytes[i] = bytes;
+		if (!*ms)
+			continue;
+
+		/* bytes per msec * 8 / 1000 = Mbps */
+		rate = (int)div_u64(delta * 8 << IPA_PM_GOV_FIXP, *ms * 1000);
+		ipa_pm_ctx->gov_pipe_rate[i] += (rate -
+			ipa_pm_ctx->gov_pipe_rate[i]) >> IPA_PM_GOV_EWMA_SHIFT;
+
+		if (IPA_CLIENT_IS_PROD(ep->client)) {
+			prod_bytes += delta;
+			ring = ep->gsi_mem_info.chan_ring_len /
+				GSI_CHAN_RE_SIZE_16B;
+			occ = READ_ONCE(sys->len);
+		} else {
+			cons_bytes += delta;
+			ring = sys->rx_pool_sz;
+			occ = ring - min(READ_ONCE(sys->len), ring);
+		}
+		if (ring)
+			*occupancy = max_t(int, *occupancy, occ * 100 / ring);
+	}
+	ipa_pm_ctx->gov_ts = now;
+
+	if (!*ms)
+		return 0;
+
+	return (int)div_u64(max(prod_bytes, cons_bytes) * 8, *ms * 1000);
+}
+
+/**
+ * ipa_pm_gov_work_func() - sample the datapath and run the governor
+ *
+ * Runs every IPA_PM_GOV_PERIOD_MSEC while the IPA clock is on. Once the clock
+ * is gated, or the vote is set by ipa_pm_set_clock_index(), it stops until
+ * do_clk_scaling() kicks it again.
+ */
+static void ipa_pm_gov_work_func(struct work_struct *work)
+{
+	struct clk_scaling_db *clk = &ipa_pm_ctx->clk_scaling;
+	struct ipa_pm_gov *gov = &ipa_pm_ctx->gov;
+	struct ipa_pm_gov_sample s;
+	int old_vote, new_vote;
+	unsigned long flags;
+	u32 ms;
+
+	if (atomic_read(&ipa3_ctx->ipa_clk_vote) == 0) {
+		IPA_PM_DBG_LOW("IPA clock is gated, governor idle\n");
+		ipa_pm_ctx->gov_ts = 0;
+		return;
+	}
+
+	mutex_lock(&ipa_pm_ctx->client_mutex);
+	if (!gov->enabled) {
+		mutex_unlock(&ipa_pm_ctx->client_mutex);
+		return;
+	}
+
+	s.rate = ipa_pm_gov_sample_pipes(&ms, &s.occupancy);
+	s.ts_ms = jiffies_to_msecs(jiffies);
+	old_vote = clk->cur_vote;
+	/* restart after a gap, or when do_clk_scaling() raised the vote */
+	if (!ms || ms > 10 * IPA_PM_GOV_PERIOD_MSEC || gov->vote != old_vote)
+		ipa_pm_gov_reset(gov, old_vote, s.ts_ms);
+	if (!ms) {
+		mutex_unlock(&ipa_pm_ctx->client_mutex);
+		goto resched;
+	}
+
+	s.client_tput = calculate_throughput();
+	ipa_pm_ctx->aggregated_tput = s.client_tput;
+	set_current_threshold();
+	new_vote = ipa_pm_gov_step(gov, clk->current_threshold,
+		clk->threshold_size, &s);
+
+	spin_lock_irqsave(&clk->lock, flags);
+	if (clk->manual_idx) {
+		spin_unlock_irqrestore(&clk->lock, flags);
+		mutex_unlock(&ipa_pm_ctx->client_mutex);
+		IPA_PM_DBG_LOW("manual clock index, governor idle\n");
+		ipa_pm_ctx->gov_ts = 0;
+		return;
+	}
+	if (new_vote != clk->cur_vote)
+		clk->cur_vote = new_vote;
+	else
+		new_vote = 0;
+	spin_unlock_irqrestore(&clk->lock, flags);
+
+	if (new_vote)
+		ipa3_set_clock_plan_from_pm(new_vote);
+	mutex_unlock(&ipa_pm_ctx->client_mutex);
+
+resched:
+	queue_delayed_work(ipa_pm_ctx->wq, &ipa_pm_ctx->gov_work,
+		msecs_to_jiffies(IPA_PM_GOV_PERIOD_MSEC));
+}
+
 /**
  * activate_work_func - activate a client and vote for clock on a work queue
  */
@@ -663,6 +993,7 @@ int ipa_pm_init(struct ipa_pm_init_params *params)
 	clk_scaling->threshold_size = params->threshold_size;
 	clk_scaling->exception_size = params->exception_size;
 	INIT_WORK(&clk_scaling->work, clock_scaling_func);
+	INIT_DEFERRABLE_WORK(&ipa_pm_ctx->gov_work, ipa_pm_gov_work_func);
 
 	for (i = 0; i < params->threshold_size; i++)
 		clk_scaling->default_threshold[i] =
@@ -718,6 +1049,8 @@ int ipa_pm_destroy(void)
 		return -EPERM;
 	}
 
+	WRITE_ONCE(ipa_pm_ctx->gov.enabled, false);
+	cancel_delayed_work_sync(&ipa_pm_ctx->gov_work);
 	destroy_workqueue(ipa_pm_ctx->wq);
 
 	kfree(ipa_pm_ctx);
@@ -1339,10 +1672,20 @@ int ipa_pm_set_throughput(u32 hdl, int throughput)
 }
 EXPORT_SYMBOL(ipa_pm_set_throughput);
 
+/*
+ * Called with the IPA active clients mutex held, so cannot take client_mutex.
+ * The governor backs off until do_clk_scaling() recomputes the vote.
+ */
 void ipa_pm_set_clock_index(int index)
 {
-	if (ipa_pm_ctx && index >= 0)
+	unsigned long flags;
+
+	if (ipa_pm_ctx && index >= 0) {
+		spin_lock_irqsave(&ipa_pm_ctx->clk_scaling.lock, flags);
 		ipa_pm_ctx->clk_scaling.cur_vote = index;
+		ipa_pm_ctx->clk_scaling.manual_idx = true;
+		spin_unlock_irqrestore(&ipa_pm_ctx->clk_scaling.lock, flags);
+	}
 
 	IPA_PM_DBG("Setting pm clock vote to %d\n", index);
 }
@@ -1472,6 +1815,93 @@ int ipa_pm_exceptions_stat(char *buf, int size)
 	return cnt;
 }
 
+/**
+ * ipa_pm_set_predictive() - hand clock scaling over to the predictive governor
+ * @enable: true to let the governor own the vote, false for threshold scaling
+ *
+ * Returns: 0 on success, negative on failure
+ */
+int ipa_pm_set_predictive(bool enable)
+{
+	if (ipa_pm_ctx == NULL) {
+		IPA_PM_ERR("PM_ctx is null\n");
+		return -EINVAL;
+	}
+
+	mutex_lock(&ipa_pm_ctx->client_mutex);
+	if (ipa_pm_ctx->gov.enabled == enable) {
+		mutex_unlock(&ipa_pm_ctx->client_mutex);
+		return 0;
+	}
+	ipa_pm_gov_reset(&ipa_pm_ctx->gov, ipa_pm_ctx->clk_scaling.cur_vote,
+		jiffies_to_msecs(jiffies));
+	ipa_pm_ctx->gov_ts = 0;
+	WRITE_ONCE(ipa_pm_ctx->gov.enabled, enable);
+	mutex_unlock(&ipa_pm_ctx->client_mutex);
+
+	IPA_PM_DBG("predictive clock scaling %s\n",
+		enable ? "enabled" : "disabled");
+
+	if (enable)
+		queue_delayed_work(ipa_pm_ctx->wq, &ipa_pm_ctx->gov_work, 0);
+	else
+		cancel_delayed_work_sync(&ipa_pm_ctx->gov_work);
+
+	/* without the governor the thresholds alone set the vote again */
+	do_clk_scaling();
+
+	return 0;
+}
+
+/**
+ * ipa_pm_gov_stat() - print the predictive governor state and decision trace
+ * @buf: [in] The user buff used to print
+ * @size: [in] The size of buf
+ * Returns: number of bytes used on success, negative on failure
+ */
+int ipa_pm_gov_stat(char *buf, int size)
+{
+	struct ipa_pm_gov *gov;
+	struct ipa_pm_gov_trace *t;
+	int i, cnt = 0;
+	u32 first;
+
+	if (!buf || size < 0 || ipa_pm_ctx == NULL)
+		return -EINVAL;
+
+	gov = &ipa_pm_ctx->gov;
+	mutex_lock(&ipa_pm_ctx->client_mutex);
+	cnt += scnprintf(buf + cnt, size - cnt,
+		"enabled: %d vote: %d rate ewma: %d Mbps\n",
+		gov->enabled, gov->vote, gov->ewma >> IPA_PM_GOV_FIXP);
+	cnt += scnprintf(buf + cnt, size - cnt,
+		"ups: %u downs: %u holds: %u\n\nPipe rates (Mbps):\n",
+		gov->ups, gov->downs, gov->holds);
+
+	for (i = 0; i < ipa3_get_max_num_pipes(); i++) {
+		if (!(ipa_pm_ctx->gov_pipe_rate[i] >> IPA_PM_GOV_FIXP))
+			continue;
+		cnt += scnprintf(buf + cnt, size - cnt, "%d: %s %d\n", i,
+			ipa_clients_strings[ipa3_ctx->ep[i].client],
+			ipa_pm_ctx->gov_pipe_rate[i] >> IPA_PM_GOV_FIXP);
+	}
+
+	cnt += scnprintf(buf + cnt, size - cnt,
+		"\nDecisions (ts_ms rate pred occ vote reason):\n");
+	first = gov->trace_idx > IPA_PM_GOV_TRACE_LEN ?
+		gov->trace_idx - IPA_PM_GOV_TRACE_LEN : 0;
+	for (; first < gov->trace_idx; first++) {
+		t = &gov->trace[first % IPA_PM_GOV_TRACE_LEN];
+		cnt += scnprintf(buf + cnt, size - cnt,
+			"%u %d %d %d%% %d->%d %s\n", t->ts_ms, t->rate,
+			t->predicted, t->occupancy, t->old_vote, t->new_vote,
+			ipa_pm_gov_reason_to_str[t->reason]);
+	}
+	mutex_unlock(&ipa_pm_ctx->client_mutex);
+
+	return cnt;
+}
+
 int ipa_pm_get_scaling_bw_levels(struct ipa_lnx_clock_stats *clock_stats)
 {
 	struct clk_scaling_db *clk;
@@ -16,6 +16,7 @@
 #define IPA_PM_THRESHOLD_MAX 5
 #define IPA_PM_EXCEPTION_MAX 5
 #define IPA_PM_DEFERRED_TIMEOUT 100
+#define IPA_PM_GOV_TRACE_LEN 64
 
 /*
  * ipa_pm group names
@@ -84,6 +85,91 @@ struct ipa_pm_register_params {
 	bool skip_clk_vote;
 };
 
+/*
+ * ipa_pm_gov_reason - why the predictive governor kept or moved its vote
+ * @IPA_PM_GOV_STEADY: demand matches the current vote
+ * @IPA_PM_GOV_UP_DEMAND: measured or client reported demand crossed a threshold
+ * @IPA_PM_GOV_UP_TREND: the rate trend is predicted to cross a threshold
+ * @IPA_PM_GOV_UP_OCCUPANCY: rings are backing up at the current clock
+ * @IPA_PM_GOV_DOWN: demand stayed below the hysteresis band long enough
+ * @IPA_PM_GOV_HOLD_HYST: demand dropped but is still inside the band
+ * @IPA_PM_GOV_HOLD_DWELL: demand is low but the dwell time did not pass yet
+ */
+enum ipa_pm_gov_reason {
+	IPA_PM_GOV_STEADY,
+	IPA_PM_GOV_UP_DEMAND,
+	IPA_PM_GOV_UP_TREND,
+	IPA_PM_GOV_UP_OCCUPANCY,
+	IPA_PM_GOV_DOWN,
+	IPA_PM_GOV_HOLD_HYST,
+	IPA_PM_GOV_HOLD_DWELL,
+	IPA_PM_GOV_REASON_MAX,
+};
+
+/*
+ * struct ipa_pm_gov_sample - one input sample of the predictive governor
+ * @ts_ms: sample time in msec
+ * @client_tput: aggregated throughput reported by the PM clients in Mbps
+ * @rate: measured datapath rate in Mbps
+ * @occupancy: highest ring occupancy over the pipes in percent
+ */
+struct ipa_pm_gov_sample {
+	u32 ts_ms;
+	int client_tput;
+	int rate;
+	int occupancy;
+};
+
+/*
+ * struct ipa_pm_gov_trace - one scaling decision of the predictive governor
+ * @ts_ms: sample time in msec
+ * @rate: measured datapath rate in Mbps
+ * @predicted: demand the decision was based on in Mbps
+ * @occupancy: highest ring occupancy in percent
+ * @old_vote: clock vote before the decision
+ * @new_vote: clock vote after the decision
+ * @reason: see ipa_pm_gov_reason
+ */
+struct ipa_pm_gov_trace {
+	u32 ts_ms;
+	int rate;
+	int predicted;
+	int occupancy;
+	int old_vote;
+	int new_vote;
+	enum ipa_pm_gov_reason reason;
+};
+
+/*
+ * struct ipa_pm_gov - predictive clock scaling governor state
+ * @enabled: governor owns the clock vote
+ * @ewma: EWMA of the measured rate, fixed point
+ * @vote: current clock vote index
+ * @vote_ts_ms: time the current vote was taken
+ * @low: demand is below the hysteresis band of the current vote
+ * @low_since_ms: time demand went below the band
+ * @last_reason: reason of the previous decision
+ * @ups: number of times the vote was raised
+ * @downs: number of times the vote was lowered
+ * @holds: number of samples a lower vote was held back
+ * @trace: ring of the latest decisions
+ * @trace_idx: total number of decisions written to @trace
+ */
+struct ipa_pm_gov {
+	bool enabled;
+	int ewma;
+	int vote;
+	u32 vote_ts_ms;
+	bool low;
+	u32 low_since_ms;
+	enum ipa_pm_gov_reason last_reason;
+	u32 ups;
+	u32 downs;
+	u32 holds;
+	struct ipa_pm_gov_trace trace[IPA_PM_GOV_TRACE_LEN];
+	u32 trace_idx;
+};
+
 #if IS_ENABLED(CONFIG_IPA3)
 
 int ipa_pm_register(struct ipa_pm_register_params *params, u32 *hdl);
@@ -105,6 +191,11 @@ int ipa_pm_exceptions_stat(char *buf, int size);
 void ipa_pm_set_clock_index(int index);
 int ipa_pm_add_dummy_clients(s8 power_plan);
 int ipa_pm_remove_dummy_clients(void);
+int ipa_pm_set_predictive(bool enable);
+int ipa_pm_gov_stat(char *buf, int size);
+void ipa_pm_gov_reset(struct ipa_pm_gov *gov, int vote, u32 ts_ms);
+int ipa_pm_gov_step(struct ipa_pm_gov *gov, const int *threshold,
+	int threshold_size, const struct ipa_pm_gov_sample *s);
 
 #else /* IS_ENABLED(CONFIG_IPA3) */
 
@@ -190,6 +281,16 @@ static inline int ipa_pm_remove_dummy_clients(void);
 {
 	return -EPERM;
 }
+
+static inline int ipa_pm_set_predictive(bool enable)
+{
+	return -EPERM;
+}
+
+static inline int ipa_pm_gov_stat(char *buf, int size)
+{
+	return -EPERM;
+}
 #endif /* IS_ENABLED(CONFIG_IPA3) */
 
 #endif /* _IPA_PM_H_ */
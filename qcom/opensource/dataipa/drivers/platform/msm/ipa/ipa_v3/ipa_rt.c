@@ -8,6 +8,7 @@
 #include "ipa_i.h"
 #include "ipahal.h"
 #include "ipahal_fltrt.h"
+#include "ipa_trace.h"
 
 #define IPA_RT_INDEX_BITMAP_SIZE	(32)
 #define IPA_RT_STATUS_OF_ADD_FAILED	(-1)
@@ -132,6 +133,42 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
 	return res;
 }
 
+/**
+ * __ipa_retire_sys_rt_tbl() - stop using the sys memory body of a table
+ *  which is now empty. The body is released by the reap once the new
+ *  headers are committed.
+ * @tbl: the rt tbl
+ * @rlt: the rule type (hashable or non-hashable)
+ */
+static void __ipa_retire_sys_rt_tbl(struct ipa3_rt_tbl *tbl,
+	enum ipa_rule_type rlt)
+{
+	if (!tbl->curr_mem[rlt].phys_base)
+		return;
+
+	WARN_ON(tbl->prev_mem[rlt].phys_base);
+	tbl->prev_mem[rlt] = tbl->curr_mem[rlt];
+	memset(&tbl->curr_mem[rlt], 0, sizeof(tbl->curr_mem[rlt]));
+}
+
+/**
+ * ipa3_rt_set_tbls_dirty() - force regeneration of all rt tables of an
+ *  ip family on the next commit
+ * @ip: the ip address family type
+ *
+ * Used when something the rt rules encoding depends on, other than the
+ * rules themselves, has changed (e.g. a header entry was removed).
+ * caller needs to hold ipa3_ctx->lock
+ */
+void ipa3_rt_set_tbls_dirty(enum ipa_ip_type ip)
+{
+	struct ipa3_rt_tbl *tbl;
+
+	list_for_each_entry(tbl, &ipa3_ctx->rt_tbl_set[ip].head_rt_tbl_list,
+		link)
+		tbl->dirty = true;
+}
+
 /**
  * ipa_translate_rt_tbl_to_hw_fmt() - translate the routing driver structures
  *  (rules and tables) to HW format and fill it in the given buffers
@@ -143,6 +180,10 @@ static int ipa_generate_rt_hw_rule(enum ipa_ip_type ip,
  *  ipa sram (for local body usage)
  * @apps_start_idx: the first rt table index of apps tables
  *
+ * Sys tables that are not dirty keep their committed body, only their
+ * address is written to the header. Local bodies are always regenerated
+ * as they are packed back-to-back.
+ *
  * Returns: 0 on success, negative on failure
  *
  * caller needs to hold any needed locks to ensure integrity
@@ -164,9 +205,23 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 	set = &ipa3_ctx->rt_tbl_set[ip];
 	body_i = base;
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
-		if (tbl->sz[rlt] == 0)
+		if (tbl->sz[rlt] == 0) {
+			__ipa_retire_sys_rt_tbl(tbl, rlt);
 			continue;
+		}
 		if (tbl->in_sys[rlt]) {
+			if (!tbl->dirty && tbl->curr_mem[rlt].phys_base) {
+				/* rules unchanged, re-use the committed body */
+				if (ipahal_fltrt_write_addr_to_hdr(
+					tbl->curr_mem[rlt].phys_base, hdr,
+					tbl->idx - apps_start_idx, true)) {
+					IPAERR_RL("fail to wrt sys tbl addr to hdr\n");
+					goto err;
+				}
+				ipa3_ctx->rt_cmt_shadow[ip].tbls_reused++;
+				continue;
+			}
+
 			/* only body (no header) */
 			tbl_mem.size = tbl->sz[rlt] -
 				ipahal_get_hw_tbl_hdr_width();
@@ -263,9 +318,8 @@ static void __ipa_reap_sys_rt_tbls(enum ipa_ip_type ip)
 				IPADBG_LOW(
 				"reaping sys rt tbl name=%s ip=%d rlt=%d\n",
 				tbl->name, ip, i);
-				ipahal_free_dma_mem(&tbl->prev_mem[i]);
-				memset(&tbl->prev_mem[i], 0,
-					sizeof(tbl->prev_mem[i]));
+				ipahal_fltrt_release_hw_sys_tbl(
+					&tbl->prev_mem[i]);
 			}
 		}
 	}
@@ -278,7 +332,8 @@ static void __ipa_reap_sys_rt_tbls(enum ipa_ip_type ip)
 				IPADBG_LOW(
 				"reaping sys rt tbl name=%s ip=%d rlt=%d\n",
 				tbl->name, ip, i);
-				ipahal_free_dma_mem(&tbl->curr_mem[i]);
+				ipahal_fltrt_release_hw_sys_tbl(
+					&tbl->curr_mem[i]);
 			}
 		}
 		list_del(&tbl->link);
@@ -455,7 +510,9 @@ static bool ipa_rt_valid_lcl_tbl_size(enum ipa_ip_type ipt,
 
 /**
  * __ipa_commit_rt_v3() - commit rt tables to the hw
- * commit the headers and the bodies if are local with internal cache flushing
+ * commit the headers and the bodies if are local with internal cache flushing.
+ * Only dirty tables are regenerated, and headers or local bodies which are
+ * identical to the last committed image are not written again.
  * @ipt: the ip address family type
  *
  * Return: 0 on success, negative on failure
@@ -480,12 +537,16 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 	struct ipa3_rt_tbl *tbl;
 	u32 tbl_hdr_width;
 	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	struct ipa3_fltrt_cmt_shadow *shadow = &ipa3_ctx->rt_cmt_shadow[ip];
+	u32 dirty_tbls = 0, dma_skipped = 0, reused_base, usec;
+	ktime_t start = ktime_get();
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(desc, 0, sizeof(desc));
 	memset(cmd_pyld, 0, sizeof(cmd_pyld));
 	memset(&alloc_params, 0, sizeof(alloc_params));
 	alloc_params.ipt = ip;
+	reused_base = shadow->tbls_reused;
 
 	if (ip == IPA_IP_v4) {
 		num_modem_rt_index =
@@ -533,9 +594,13 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
 	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
-		if (ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
-			rc = -EPERM;
-			goto no_rt_tbls;
+		/* clean tables keep their sizes from the last commit */
+		if (tbl->dirty) {
+			if (ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
+				rc = -EPERM;
+				goto no_rt_tbls;
+			}
+			dirty_tbls++;
 		}
 		if (!tbl->in_sys[IPA_RULE_HASHABLE] &&
 			tbl->sz[IPA_RULE_HASHABLE]) {
@@ -643,26 +708,38 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		num_cmd++;
 	}
 
-	mem_cmd.is_read = false;
-	mem_cmd.skip_pipeline_clear = false;
-	mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-	mem_cmd.size = alloc_params.nhash_hdr.size;
-	mem_cmd.system_addr = alloc_params.nhash_hdr.phys_base;
-	mem_cmd.local_addr = lcl_nhash_hdr;
-	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-		IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("fail construct dma_shared_mem imm cmd. IP %d\n", ip);
-		goto fail_imm_cmd_construct;
+	if (ipa3_fltrt_shadow_match(shadow, true, IPA_RULE_NON_HASHABLE, 0,
+		&alloc_params.nhash_hdr, alloc_params.nhash_hdr.size)) {
+		IPADBG_LOW("nhash hdrs unchanged. IP %d\n", ip);
+		dma_skipped++;
+	} else {
+		mem_cmd.is_read = false;
+		mem_cmd.skip_pipeline_clear = false;
+		mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+		mem_cmd.size = alloc_params.nhash_hdr.size;
+		mem_cmd.system_addr = alloc_params.nhash_hdr.phys_base;
+		mem_cmd.local_addr = lcl_nhash_hdr;
+		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+			IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("fail construct dma_shared_mem imm cmd. IP %d\n",
+				ip);
+			goto fail_imm_cmd_construct;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		num_cmd++;
 	}
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-	num_cmd++;
 
 	/*
 	 * SRAM memory not allocated to hash tables. Sending
 	 * command to hash tables(filer/routing) operation not supported.
 	 */
-	if (!ipa3_ctx->ipa_fltrt_not_hashable) {
+	if (!ipa3_ctx->ipa_fltrt_not_hashable &&
+		ipa3_fltrt_shadow_match(shadow, true, IPA_RULE_HASHABLE, 0,
+		&alloc_params.hash_hdr, alloc_params.hash_hdr.size)) {
+		IPADBG_LOW("hash hdrs unchanged. IP %d\n", ip);
+		dma_skipped++;
+	} else if (!ipa3_ctx->ipa_fltrt_not_hashable) {
 		mem_cmd.is_read = false;
 		mem_cmd.skip_pipeline_clear = false;
 		mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
@@ -680,7 +757,12 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		num_cmd++;
 	}
 
-	if (lcl_nhash) {
+	if (lcl_nhash && ipa3_fltrt_shadow_match(shadow, false,
+		IPA_RULE_NON_HASHABLE, 0, &alloc_params.nhash_bdy,
+		alloc_params.nhash_bdy.size)) {
+		IPADBG_LOW("nhash lcl bodies unchanged. IP %d\n", ip);
+		dma_skipped++;
+	} else if (lcl_nhash) {
 		if (num_cmd >= IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -704,7 +786,12 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
 		num_cmd++;
 	}
-	if (lcl_hash) {
+	if (lcl_hash && ipa3_fltrt_shadow_match(shadow, false,
+		IPA_RULE_HASHABLE, 0, &alloc_params.hash_bdy,
+		alloc_params.hash_bdy.size)) {
+		IPADBG_LOW("hash lcl bodies unchanged. IP %d\n", ip);
+		dma_skipped++;
+	} else if (lcl_hash) {
 		if (num_cmd >= IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC) {
 			IPAERR("number of commands is out of range: IP = %d\n",
 				ip);
@@ -731,10 +818,19 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 
 	if (ipa3_send_cmd(num_cmd, desc)) {
 		IPAERR_RL("fail to send immediate command\n");
+		/* SRAM may be partially written */
+		ipa3_fltrt_shadow_invalidate(shadow);
 		rc = -EFAULT;
 		goto fail_imm_cmd_construct;
 	}
 
+	ipa3_fltrt_shadow_update(shadow, &alloc_params);
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link)
+		tbl->dirty = false;
+	shadow->commits++;
+	shadow->tbls_gen += dirty_tbls;
+	shadow->dma_skipped += dma_skipped;
+
 	IPADBG_LOW("Hashable HEAD\n");
 	IPA_DUMP_BUFF(alloc_params.hash_hdr.base,
 		alloc_params.hash_hdr.phys_base, alloc_params.hash_hdr.size);
@@ -772,15 +868,30 @@ fail_size_valid:
 		ipahal_free_dma_mem(&alloc_params.nhash_bdy);
 
 no_rt_tbls:
+	usec = ktime_us_delta(ktime_get(), start);
+	shadow->last_usec = usec;
+	if (usec > shadow->max_usec)
+		shadow->max_usec = usec;
+	trace_ipa3_fltrt_commit(false, ip, dirty_tbls,
+		shadow->tbls_reused - reused_base, dma_skipped, usec, rc);
 	return rc;
 }
 
+static inline u32 __ipa_rt_tbl_name_hash(const char *name)
+{
+	return jhash(name, strlen(name), 0);
+}
+
 /**
  * __ipa3_find_rt_tbl() - find the routing table
  *			which name is given as parameter
  * @ip:	[in] the ip address family type of the wanted routing table
  * @name:	[in] the name of the wanted routing table
  *
+ * Tables are looked up through the set name hash which is kept in sync
+ * with head_rt_tbl_list, a table is unhashed before it is moved to the
+ * reap list or freed.
+ *
  * Returns: the routing table which name is given as parameter, or NULL if it
  * doesn't exist
  */
@@ -795,8 +906,9 @@ struct ipa3_rt_tbl *__ipa3_find_rt_tbl(enum ipa_ip_type ip, const char *name)
 	}
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
-	list_for_each_entry(entry, &set->head_rt_tbl_list, link) {
-		if (!ipa3_check_idr_if_freed(entry) &&
+	hash_for_each_possible(set->name_ht, entry, name_node,
+		__ipa_rt_tbl_name_hash(name)) {
+		if (entry->cookie == IPA_RT_TBL_COOKIE &&
 			!strcmp(name, entry->name))
 			return entry;
 	}
@@ -893,9 +1005,12 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 		entry->cookie = IPA_RT_TBL_COOKIE;
 		entry->in_sys[IPA_RULE_HASHABLE] = !ipa3_ctx->rt_tbl_hash_lcl[ip];
 		entry->in_sys[IPA_RULE_NON_HASHABLE] = !ipa3_ctx->rt_tbl_nhash_lcl[ip];
+		entry->dirty = true;
 		set->tbl_cnt++;
 		entry->rule_ids = &set->rule_ids;
 		list_add(&entry->link, &set->head_rt_tbl_list);
+		hash_add(set->name_ht, &entry->name_node,
+			__ipa_rt_tbl_name_hash(entry->name));
 
 		IPADBG("add rt tbl idx=%d tbl_cnt=%d ip=%d\n", entry->idx,
 				set->tbl_cnt, ip);
@@ -912,6 +1027,7 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 	return entry;
 ipa_insert_failed:
 	set->tbl_cnt--;
+	hash_del(&entry->name_node);
 	list_del(&entry->link);
 	idr_destroy(entry->rule_ids);
 fail_rt_idx_alloc:
@@ -949,6 +1065,7 @@ static int __ipa_del_rt_tbl(struct ipa3_rt_tbl *entry)
 	rset = &ipa3_ctx->reap_rt_tbl_set[ip];
 
 	entry->rule_ids = NULL;
+	hash_del(&entry->name_node);
 	if (entry->in_sys[IPA_RULE_HASHABLE] ||
 		entry->in_sys[IPA_RULE_NON_HASHABLE]) {
 		list_move(&entry->link, &rset->head_rt_tbl_list);
@@ -965,6 +1082,9 @@ static int __ipa_del_rt_tbl(struct ipa3_rt_tbl *entry)
 		kmem_cache_free(ipa3_ctx->rt_tbl_cache, entry);
 	}
 
+	/* flt rules pointing to this table are encoded differently now */
+	ipa3_flt_set_tbls_dirty(ip);
+
 	/* remove the handle from the database */
 	ipa3_id_remove(id);
 	return 0;
@@ -1115,6 +1235,7 @@ static int __ipa_finish_rt_rule_add(struct ipa3_rt_entry *entry, u32 *rule_hdl,
 		tbl->idx, tbl->rule_cnt, entry->rule_id);
 	*rule_hdl = id;
 	entry->id = id;
+	tbl->dirty = true;
 
 	return 0;
 
@@ -1129,9 +1250,15 @@ ipa_insert_failed:
 	return -EPERM;
 }
 
+/*
+ * @tbl_cache: table the rule goes to, resolved from @name on first use
+ * and then re-used for the rest of the batch. All the rules of an add
+ * ioctl share the same table name and the table cannot go away while
+ * ipa3_ctx->lock is held.
+ */
 static int __ipa_add_rt_rule(enum ipa_ip_type ip, const char *name,
 		const struct ipa_rt_rule_i *rule, u8 at_rear, u32 *rule_hdl,
-		u16 rule_id, bool user)
+		u16 rule_id, bool user, struct ipa3_rt_tbl **tbl_cache)
 {
 	struct ipa3_rt_tbl *tbl;
 	struct ipa3_rt_entry *entry;
@@ -1144,11 +1271,15 @@ static int __ipa_add_rt_rule(enum ipa_ip_type ip, const char *name,
 	if (__ipa_rt_validate_rule_id(rule_id))
 		goto error;
 
-	tbl = __ipa_add_rt_tbl(ip, name);
-	if (tbl == NULL || (tbl->cookie != IPA_RT_TBL_COOKIE)) {
-		IPAERR_RL("failed adding rt tbl name = %s\n",
-			name ? name : "");
-		goto error;
+	tbl = *tbl_cache;
+	if (!tbl) {
+		tbl = __ipa_add_rt_tbl(ip, name);
+		if (tbl == NULL || (tbl->cookie != IPA_RT_TBL_COOKIE)) {
+			IPAERR_RL("failed adding rt tbl name = %s\n",
+				name ? name : "");
+			goto error;
+		}
+		*tbl_cache = tbl;
 	}
 	/*
 	 * do not allow any rule to be added at "default" routing
@@ -1319,6 +1450,7 @@ int ipa3_add_rt_rule_usr(struct ipa_ioc_add_rt_rule *rules, bool user_only)
 {
 	int i;
 	int ret;
+	struct ipa3_rt_tbl *tbl = NULL;
 	struct ipa_rt_rule_i rule;
 
 	if (rules == NULL || rules->num_rules == 0 || rules->ip >= IPA_IP_MAX) {
@@ -1338,7 +1470,7 @@ int ipa3_add_rt_rule_usr(struct ipa_ioc_add_rt_rule *rules, bool user_only)
 					rules->rules[i].at_rear,
 					&rules->rules[i].rt_rule_hdl,
 					0,
-					user_only)) {
+					user_only, &tbl)) {
 			IPAERR_RL("failed to add rt rule %d\n", i);
 			rules->rules[i].status = IPA_RT_STATUS_OF_ADD_FAILED;
 		} else {
@@ -1375,6 +1507,7 @@ int ipa3_add_rt_rule_usr_v2(struct ipa_ioc_add_rt_rule_v2 *rules,
 {
 	int i;
 	int ret;
+	struct ipa3_rt_tbl *tbl = NULL;
 
 	if (rules == NULL || rules->num_rules == 0 || rules->ip >= IPA_IP_MAX) {
 		IPAERR_RL("bad param\n");
@@ -1396,7 +1529,7 @@ int ipa3_add_rt_rule_usr_v2(struct ipa_ioc_add_rt_rule_v2 *rules,
 					&(((struct ipa_rt_rule_add_i *)
 					rules->rules)[i].rt_rule_hdl),
 					0,
-					user_only)) {
+					user_only, &tbl)) {
 			IPAERR_RL("failed to add rt rule %d\n", i);
 			((struct ipa_rt_rule_add_i *)rules->rules)[i].status
 				= IPA_RT_STATUS_OF_ADD_FAILED;
@@ -1432,6 +1565,7 @@ int ipa3_add_rt_rule_ext(struct ipa_ioc_add_rt_rule_ext *rules)
 {
 	int i;
 	int ret;
+	struct ipa3_rt_tbl *tbl = NULL;
 	struct ipa_rt_rule_i rule;
 
 	if (rules == NULL || rules->num_rules == 0 || rules->ip >= IPA_IP_MAX) {
@@ -1450,7 +1584,7 @@ int ipa3_add_rt_rule_ext(struct ipa_ioc_add_rt_rule_ext *rules)
 					&rule,
 					rules->rules[i].at_rear,
 					&rules->rules[i].rt_rule_hdl,
-					rules->rules[i].rule_id, true)) {
+					rules->rules[i].rule_id, true, &tbl)) {
 			IPAERR_RL("failed to add rt rule %d\n", i);
 			rules->rules[i].status = IPA_RT_STATUS_OF_ADD_FAILED;
 		} else {
@@ -1486,6 +1620,7 @@ int ipa3_add_rt_rule_ext_v2(struct ipa_ioc_add_rt_rule_ext_v2 *rules,
 {
 	int i;
 	int ret;
+	struct ipa3_rt_tbl *tbl = NULL;
 
 	if (rules == NULL || rules->num_rules == 0 || rules->ip >= IPA_IP_MAX) {
 		IPAERR_RL("bad param\n");
@@ -1506,7 +1641,7 @@ int ipa3_add_rt_rule_ext_v2(struct ipa_ioc_add_rt_rule_ext_v2 *rules,
 					&(((struct ipa_rt_rule_add_ext_i *)
 					rules->rules)[i].rt_rule_hdl),
 					((struct ipa_rt_rule_add_ext_i *)
-					rules->rules)[i].rule_id, user)) {
+					rules->rules)[i].rule_id, user, &tbl)) {
 			IPAERR_RL("failed to add rt rule %d\n", i);
 			((struct ipa_rt_rule_add_ext_i *)
 			rules->rules)[i].status = IPA_RT_STATUS_OF_ADD_FAILED;
@@ -1805,6 +1940,7 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 		__ipa3_release_hdr_proc_ctx(entry->proc_ctx->id);
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	entry->tbl->dirty = true;
 	IPADBG("del rt rule tbl_idx=%d rule_cnt=%d rule_id=%d\n ref_cnt=%u",
 		entry->tbl->idx, entry->tbl->rule_cnt,
 		entry->rule_id, entry->tbl->ref_cnt);
@@ -1997,6 +2133,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					}
 				}
 				tbl->rule_cnt--;
+				tbl->dirty = true;
 				list_del(&rule->link);
 				if (rule->hdr &&
 					(!ipa3_check_idr_if_freed(
@@ -2030,6 +2167,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 		if (tbl->idx != apps_start_idx) {
 			if (!user_only || tbl_user) {
 				tbl->rule_ids = NULL;
+				hash_del(&tbl->name_node);
 				if (tbl->in_sys[IPA_RULE_HASHABLE] ||
 					tbl->in_sys[IPA_RULE_NON_HASHABLE]) {
 					list_move(&tbl->link,
@@ -2049,6 +2187,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 					kmem_cache_free(ipa3_ctx->rt_tbl_cache,
 						tbl);
 				}
+				ipa3_flt_set_tbls_dirty(ip);
 				/* remove the handle from the database */
 				ipa3_id_remove(id);
 			}
@@ -2238,6 +2377,7 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 		entry->cnt_idx = rtrule->rule.cnt_idx;
 	else
 		entry->cnt_idx = 0;
+	entry->tbl->dirty = true;
 	return 0;
 
 error:
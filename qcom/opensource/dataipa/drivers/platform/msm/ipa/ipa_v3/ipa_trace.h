@@ -381,6 +381,40 @@ TRACE_EVENT(
 		__entry->first_skb, __entry->prev_skb, __entry->rx_skb)
 );
 
+TRACE_EVENT(
+	ipa3_fltrt_commit,
+
+	TP_PROTO(bool is_flt, enum ipa_ip_type ip, u32 dirty_tbls,
+		 u32 reused_tbls, u32 dma_skipped, u32 usec, int rc),
+
+	TP_ARGS(is_flt, ip, dirty_tbls, reused_tbls, dma_skipped, usec, rc),
+
+	TP_STRUCT__entry(
+		__field(bool,			is_flt)
+		__field(enum ipa_ip_type,	ip)
+		__field(u32,			dirty_tbls)
+		__field(u32,			reused_tbls)
+		__field(u32,			dma_skipped)
+		__field(u32,			usec)
+		__field(int,			rc)
+	),
+
+	TP_fast_assign(
+		__entry->is_flt = is_flt;
+		__entry->ip = ip;
+		__entry->dirty_tbls = dirty_tbls;
+		__entry->reused_tbls = reused_tbls;
+		__entry->dma_skipped = dma_skipped;
+		__entry->usec = usec;
+		__entry->rc = rc;
+	),
+
+	TP_printk("%s ip=%d dirty=%u reused=%u dma_skipped=%u usec=%u rc=%d",
+		__entry->is_flt ? "flt" : "rt", __entry->ip,
+		__entry->dirty_tbls, __entry->reused_tbls,
+		__entry->dma_skipped, __entry->usec, __entry->rc)
+);
+
 #endif /* _IPA_TRACE_H */
 
 /* This part must be outside protection */
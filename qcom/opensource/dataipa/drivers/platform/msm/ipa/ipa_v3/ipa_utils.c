@@ -8429,6 +8429,109 @@ bool ipa_is_ep_support_flt(int pipe_idx)
 	return ipa3_ctx->ep_flt_bitmap & (1ULL<<pipe_idx);
 }
 
+/**
+ * ipa3_fltrt_shadow_match() - check if a part of a flt/rt image is already
+ *  present in SRAM as of the last successful commit
+ * @shadow: the commit shadow of the table type and ip family
+ * @is_hdr: compare against the headers (true) or the local bodies (false)
+ * @rlt: the rule type (hashable or non-hashable)
+ * @ofst: offset of the compared part inside the image
+ * @mem: the newly generated image
+ * @size: size of the compared part
+ *
+ * The image layout must be the same as the committed one, so a change of
+ * the image size never matches.
+ *
+ * Return: true if the DMA of this part can be skipped
+ */
+bool ipa3_fltrt_shadow_match(struct ipa3_fltrt_cmt_shadow *shadow,
+	bool is_hdr, enum ipa_rule_type rlt, u32 ofst,
+	struct ipa_mem_buffer *mem, u32 size)
+{
+	u8 *copy = is_hdr ? shadow->hdr[rlt] : shadow->bdy[rlt];
+	u32 copy_sz = is_hdr ? shadow->hdr_sz[rlt] : shadow->bdy_sz[rlt];
+
+	if (!copy || !mem->base || copy_sz != mem->size ||
+		ofst + size > copy_sz)
+		return false;
+
+	return !memcmp(copy + ofst, (u8 *)mem->base + ofst, size);
+}
+
+static void ipa3_fltrt_shadow_copy(u8 **copy, u32 *copy_sz,
+	struct ipa_mem_buffer *mem)
+{
+	if (!mem->size || !mem->base) {
+		kfree(*copy);
+		*copy = NULL;
+		*copy_sz = 0;
+		return;
+	}
+
+	if (*copy_sz != mem->size) {
+		kfree(*copy);
+		*copy = kmalloc(mem->size, GFP_KERNEL);
+		*copy_sz = *copy ? mem->size : 0;
+	}
+
+	if (*copy)
+		memcpy(*copy, mem->base, mem->size);
+}
+
+/**
+ * ipa3_fltrt_shadow_update() - record the image that was just committed
+ * @shadow: the commit shadow of the table type and ip family
+ * @params: the images sent to SRAM by the commit
+ *
+ * If a copy cannot be allocated that part stays unknown and the next
+ * commit writes it in full.
+ */
+void ipa3_fltrt_shadow_update(struct ipa3_fltrt_cmt_shadow *shadow,
+	struct ipahal_fltrt_alloc_imgs_params *params)
+{
+	ipa3_fltrt_shadow_copy(&shadow->hdr[IPA_RULE_HASHABLE],
+		&shadow->hdr_sz[IPA_RULE_HASHABLE], &params->hash_hdr);
+	ipa3_fltrt_shadow_copy(&shadow->hdr[IPA_RULE_NON_HASHABLE],
+		&shadow->hdr_sz[IPA_RULE_NON_HASHABLE], &params->nhash_hdr);
+	ipa3_fltrt_shadow_copy(&shadow->bdy[IPA_RULE_HASHABLE],
+		&shadow->bdy_sz[IPA_RULE_HASHABLE], &params->hash_bdy);
+	ipa3_fltrt_shadow_copy(&shadow->bdy[IPA_RULE_NON_HASHABLE],
+		&shadow->bdy_sz[IPA_RULE_NON_HASHABLE], &params->nhash_bdy);
+}
+
+/**
+ * ipa3_fltrt_shadow_invalidate() - forget the committed image, the next
+ *  commit writes all headers and bodies to SRAM
+ * @shadow: the commit shadow of the table type and ip family
+ */
+void ipa3_fltrt_shadow_invalidate(struct ipa3_fltrt_cmt_shadow *shadow)
+{
+	int rlt;
+
+	for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+		kfree(shadow->hdr[rlt]);
+		shadow->hdr[rlt] = NULL;
+		shadow->hdr_sz[rlt] = 0;
+		kfree(shadow->bdy[rlt]);
+		shadow->bdy[rlt] = NULL;
+		shadow->bdy_sz[rlt] = 0;
+	}
+}
+
+/**
+ * ipa3_fltrt_shadow_invalidate_all() - forget all committed flt/rt images
+ *  Called whenever the flt/rt SRAM partitions are re-initialized.
+ */
+void ipa3_fltrt_shadow_invalidate_all(void)
+{
+	int ip;
+
+	for (ip = IPA_IP_v4; ip < IPA_IP_MAX; ip++) {
+		ipa3_fltrt_shadow_invalidate(&ipa3_ctx->flt_cmt_shadow[ip]);
+		ipa3_fltrt_shadow_invalidate(&ipa3_ctx->rt_cmt_shadow[ip]);
+	}
+}
+
 /**
  * ipa3_cfg_ep_seq() - IPA end-point HPS/DPS sequencer type configuration
  * @clnt_hdl:	[in] opaque client handle assigned by IPA to client
@@ -4166,6 +4166,8 @@ int ipahal_fltrt_init(enum ipa_hw_type ipa_hw_type)
 		return -EFAULT;
 	}
 
+	mutex_init(&ipahal_ctx->sys_tbl_pool.lock);
+
 	memset(&zero_obj, 0, sizeof(zero_obj));
 	for (i = IPA_HW_v3_0 ; i < ipa_hw_type ; i++) {
 		if (!memcmp(&ipahal_fltrt_objs[i+1], &zero_obj,
@@ -4338,8 +4340,18 @@ clear_empty_tbl:
 
 void ipahal_fltrt_destroy(void)
 {
+	struct ipahal_fltrt_sys_tbl_pool *pool;
+
 	IPAHAL_DBG("Entry\n");
 
+	if (ipahal_ctx) {
+		pool = &ipahal_ctx->sys_tbl_pool;
+		mutex_lock(&pool->lock);
+		while (pool->cnt)
+			ipahal_free_dma_mem(&pool->buf[--pool->cnt]);
+		mutex_unlock(&pool->lock);
+	}
+
 	if (ipahal_ctx && ipahal_ctx->empty_fltrt_tbl.base)
 		dma_free_coherent(ipahal_ctx->ipa_pdev,
 			ipahal_ctx->empty_fltrt_tbl.size,
@@ -4852,6 +4864,91 @@ bdy_alloc_fail:
 	return -ENOMEM;
 }
 
+/*
+ * ipahal_fltrt_sys_tbl_pool_get() - Take a released sys tbl buffer from the
+ *  pool. Best fit of at least tbl_mem->size and no more than twice of it,
+ *  so a small table does not pin a large buffer.
+ * @tbl_mem: IN/OUT param. size for the needed size (terminator included).
+ *  On success overwritten with the pool buffer, which is zeroed.
+ *
+ * Return: 0 if a buffer was taken from the pool, -ENOMEM otherwise
+ */
+static int ipahal_fltrt_sys_tbl_pool_get(struct ipa_mem_buffer *tbl_mem)
+{
+	struct ipahal_fltrt_sys_tbl_pool *pool = &ipahal_ctx->sys_tbl_pool;
+	int best = -1;
+	u32 i;
+
+	mutex_lock(&pool->lock);
+	for (i = 0; i < pool->cnt; i++) {
+		if (pool->buf[i].size < tbl_mem->size ||
+			pool->buf[i].size > 2 * tbl_mem->size)
+			continue;
+		if (best < 0 || pool->buf[i].size < pool->buf[best].size)
+			best = i;
+	}
+
+	if (best < 0) {
+		pool->miss++;
+		mutex_unlock(&pool->lock);
+		return -ENOMEM;
+	}
+
+	*tbl_mem = pool->buf[best];
+	pool->buf[best] = pool->buf[--pool->cnt];
+	memset(&pool->buf[pool->cnt], 0, sizeof(pool->buf[pool->cnt]));
+	pool->hit++;
+	mutex_unlock(&pool->lock);
+
+	memset(tbl_mem->base, 0, tbl_mem->size);
+	IPAHAL_DBG_LOW("sys tbl of size %d re-used from pool\n",
+		tbl_mem->size);
+
+	return 0;
+}
+
+/*
+ * ipahal_fltrt_release_hw_sys_tbl() - Release H/W flt/rt sys tbl DMA mem
+ *  The buffer is kept in a small pool for the next commits and only freed
+ *  when the pool is full. Must be called only after H/W stopped using it.
+ * @tbl_mem: the table memory to release. Zeroed on return.
+ */
+void ipahal_fltrt_release_hw_sys_tbl(struct ipa_mem_buffer *tbl_mem)
+{
+	struct ipahal_fltrt_sys_tbl_pool *pool = &ipahal_ctx->sys_tbl_pool;
+
+	if (!tbl_mem || !tbl_mem->base)
+		return;
+
+	mutex_lock(&pool->lock);
+	if (pool->cnt < IPAHAL_FLTRT_SYS_TBL_POOL_SIZE) {
+		pool->buf[pool->cnt++] = *tbl_mem;
+		mutex_unlock(&pool->lock);
+		memset(tbl_mem, 0, sizeof(*tbl_mem));
+		return;
+	}
+	mutex_unlock(&pool->lock);
+
+	ipahal_free_dma_mem(tbl_mem);
+}
+
+/*
+ * ipahal_fltrt_sys_tbl_pool_stats() - Get the sys tbl pool counters
+ * @cnt: [OUT] number of buffers currently held by the pool
+ * @hit: [OUT] allocations served from the pool
+ * @miss: [OUT] allocations that needed a new DMA buffer
+ */
+void ipahal_fltrt_sys_tbl_pool_stats(u32 *cnt, u32 *hit, u32 *miss)
+{
+	struct ipahal_fltrt_sys_tbl_pool *pool = &ipahal_ctx->sys_tbl_pool;
+
+	mutex_lock(&pool->lock);
+	*cnt = pool->cnt;
+	*hit = pool->hit;
+	*miss = pool->miss;
+	mutex_unlock(&pool->lock);
+}
+
 /*
  * ipahal_fltrt_allocate_hw_sys_tbl() - Allocate DMA mem for H/W flt/rt sys tbl
  * @tbl_mem: IN/OUT param. size for effective table size. Pointer, for the
@@ -4880,6 +4977,9 @@ int ipahal_fltrt_allocate_hw_sys_tbl(struct ipa_mem_buffer *tbl_mem)
 
 	/* add word for rule-set terminator */
 	tbl_mem->size += obj->tbl_width;
+
+	if (!ipahal_fltrt_sys_tbl_pool_get(tbl_mem))
+		return 0;
 alloc:
 	tbl_mem->base = dma_alloc_coherent(ipahal_ctx->ipa_pdev, tbl_mem->size,
 		&tbl_mem->phys_base, flag);
@@ -234,6 +234,21 @@ int ipahal_fltrt_allocate_hw_tbl_imgs(
  */
 int ipahal_fltrt_allocate_hw_sys_tbl(struct ipa_mem_buffer *tbl_mem);
 
+/*
+ * ipahal_fltrt_release_hw_sys_tbl() - Release H/W flt/rt sys tbl DMA mem
+ *  The buffer is kept in a small pool for re-use by the next commits.
+ * @tbl_mem: the table memory to release. Zeroed on return.
+ */
+void ipahal_fltrt_release_hw_sys_tbl(struct ipa_mem_buffer *tbl_mem);
+
+/*
+ * ipahal_fltrt_sys_tbl_pool_stats() - Get the sys tbl pool counters
+ * @cnt: [OUT] number of buffers currently held by the pool
+ * @hit: [OUT] allocations served from the pool
+ * @miss: [OUT] allocations that needed a new DMA buffer
+ */
+void ipahal_fltrt_sys_tbl_pool_stats(u32 *cnt, u32 *hit, u32 *miss);
+
 /*
  * ipahal_fltrt_write_addr_to_hdr() - Fill table header with table address
  *  Given table addr/offset, adapt it to IPA H/W format and write it
@@ -66,6 +66,24 @@
 
 #define IPAHAL_PKT_STATUS_FLTRT_RULE_MISS_ID 0x3ff
 
+#define IPAHAL_FLTRT_SYS_TBL_POOL_SIZE 16
+
+/*
+ * struct ipahal_fltrt_sys_tbl_pool - cache of released flt/rt sys tables
+ * @lock: protects the pool entries
+ * @buf: DMA buffers released by previous commits, kept for re-use
+ * @cnt: number of valid entries in @buf
+ * @hit: sys table allocations served from the pool
+ * @miss: sys table allocations that needed a new DMA buffer
+ */
+struct ipahal_fltrt_sys_tbl_pool {
+	struct mutex lock;
+	struct ipa_mem_buffer buf[IPAHAL_FLTRT_SYS_TBL_POOL_SIZE];
+	u32 cnt;
+	u32 hit;
+	u32 miss;
+};
+
 /*
  * struct ipahal_context - HAL global context data
  * @hw_type: IPA H/W type/version.
@@ -75,6 +93,7 @@
  * @dent: Debugfs folder dir entry
  * @ipa_pdev: IPA Platform Device. Will be used for DMA memory
  * @empty_fltrt_tbl: Empty table to be used at tables init.
+ * @sys_tbl_pool: Released flt/rt sys tables re-used by later commits
  */
 struct ipahal_context {
 	enum ipa_hw_type hw_type;
@@ -83,6 +102,7 @@ struct ipahal_context {
 	struct dentry *dent;
 	struct device *ipa_pdev;
 	struct ipa_mem_buffer empty_fltrt_tbl;
+	struct ipahal_fltrt_sys_tbl_pool sys_tbl_pool;
 	void *regdumpbuf;
 };
 
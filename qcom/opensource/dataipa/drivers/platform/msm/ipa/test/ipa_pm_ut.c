@@ -1755,6 +1755,276 @@ static int ipa_pm_ut_simple_exception(void *priv)
 	return rc;
 }
 
+/*
+ * Predictive governor traffic simulation
+ *
+ * Synthetic traffic patterns are fed to the governor one sample per governor
+ * period and compared to the threshold scaling of do_clk_scaling(), which
+ * votes for the demand it saw on the previous period. Energy is the sum of
+ * the votes over the run, a late sample is one served by a vote lower than
+ * its rate needs.
+ */
+#define IPA_PM_UT_GOV_PERIOD_MSEC 20
+#define IPA_PM_UT_GOV_TH_SIZE 2
+
+static const int ipa_pm_ut_gov_th[IPA_PM_UT_GOV_TH_SIZE] = {600, 1000};
+
+struct ipa_pm_ut_gov_result {
+	int energy;
+	int late;
+	int switches;
+};
+
+static int ipa_pm_ut_gov_level(int rate)
+{
+	int i, idx = 1;
+
+	for (i = 0; i < IPA_PM_UT_GOV_TH_SIZE; i++) {
+		if (rate >= ipa_pm_ut_gov_th[i])
+			idx++;
+	}
+
+	return idx;
+}
+
+static void ipa_pm_ut_gov_run(struct ipa_pm_gov *gov,
+	int (*rate)(int i), int (*occupancy)(int i), int samples,
+	struct ipa_pm_ut_gov_result *pred, struct ipa_pm_ut_gov_result *react)
+{
+	struct ipa_pm_gov_sample s;
+	int i, need, vote;
+	int react_vote = 1;
+
+	memset(gov, 0, sizeof(*gov));
+	memset(pred, 0, sizeof(*pred));
+	memset(react, 0, sizeof(*react));
+	ipa_pm_gov_reset(gov, 1, 0);
+
+	for (i = 0; i < samples; i++) {
+		s.ts_ms = i * IPA_PM_UT_GOV_PERIOD_MSEC;
+		s.client_tput = 0;
+		s.rate = rate(i);
+		s.occupancy = occupancy ? occupancy(i) : 0;
+		need = ipa_pm_ut_gov_level(s.rate);
+
+		pred->energy += gov->vote;
+		if (need > gov->vote)
+			pred->late++;
+		vote = gov->vote;
+		if (ipa_pm_gov_step(gov, ipa_pm_ut_gov_th,
+			IPA_PM_UT_GOV_TH_SIZE, &s) != vote)
+			pred->switches++;
+
+		react->energy += react_vote;
+		if (need > react_vote)
+			react->late++;
+		if (need != react_vote)
+			react->switches++;
+		react_vote = need;
+	}
+
+	IPA_UT_LOG("predictive: energy %d late %d switches %d\n",
+		pred->energy, pred->late, pred->switches);
+	IPA_UT_LOG("reactive: energy %d late %d switches %d\n",
+		react->energy, react->late, react->switches);
+}
+
+/* ramp up to 1400 Mbps over a second, hold, ramp down, then idle */
+static int ipa_pm_ut_gov_ramp_rate(int i)
+{
+	if (i < 50)
+		return i * 28;
+	if (i < 100)
+		return 1400;
+	if (i < 150)
+		return 1400 - (i - 100) * 28;
+	return 0;
+}
+
+/* rate jitters around the first threshold */
+static int ipa_pm_ut_gov_osc_rate(int i)
+{
+	return (i & 1) ? 640 : 570;
+}
+
+/* 200 msec bursts every second on top of background traffic */
+static int ipa_pm_ut_gov_burst_rate(int i)
+{
+	if (i < 500 && (i % 50) < 10)
+		return 1200;
+	return 100;
+}
+
+static int ipa_pm_ut_gov_steady_rate(int i)
+{
+	return 300;
+}
+
+/* rings back up for 400 msec while the rate stays low */
+static int ipa_pm_ut_gov_backlog(int i)
+{
+	return (i >= 20 && i < 40) ? 90 : 0;
+}
+
+static int ipa_pm_ut_gov_ramp(void *priv)
+{
+	struct ipa_pm_ut_gov_result pred, react;
+	struct ipa_pm_gov *gov;
+	int rc = 0;
+
+	gov = kzalloc(sizeof(*gov), GFP_KERNEL);
+	if (!gov)
+		return -ENOMEM;
+
+	ipa_pm_ut_gov_run(gov, ipa_pm_ut_gov_ramp_rate, NULL, 200,
+		&pred, &react);
+
+	if (pred.late >= react.late) {
+		IPA_UT_ERR("late samples %d reactive %d\n", pred.late,
+			react.late);
+		IPA_UT_TEST_FAIL_REPORT("ramp not anticipated");
+		rc = -EINVAL;
+		goto free;
+	}
+
+	if (pred.energy * 100 > react.energy * 110) {
+		IPA_UT_ERR("energy %d reactive %d\n", pred.energy,
+			react.energy);
+		IPA_UT_TEST_FAIL_REPORT("too much energy on ramp");
+		rc = -EINVAL;
+		goto free;
+	}
+
+	if (gov->vote != 1) {
+		IPA_UT_ERR("vote is at %d after idle\n", gov->vote);
+		IPA_UT_TEST_FAIL_REPORT("no scale down");
+		rc = -EINVAL;
+	}
+
+free:
+	kfree(gov);
+	return rc;
+}
+
+static int ipa_pm_ut_gov_oscillation(void *priv)
+{
+	struct ipa_pm_ut_gov_result pred, react;
+	struct ipa_pm_gov *gov;
+	int rc = 0;
+
+	gov = kzalloc(sizeof(*gov), GFP_KERNEL);
+	if (!gov)
+		return -ENOMEM;
+
+	ipa_pm_ut_gov_run(gov, ipa_pm_ut_gov_osc_rate, NULL, 200,
+		&pred, &react);
+
+	if (pred.switches * 10 > react.switches) {
+		IPA_UT_ERR("switches %d reactive %d\n", pred.switches,
+			react.switches);
+		IPA_UT_TEST_FAIL_REPORT("clock oscillates");
+		rc = -EINVAL;
+		goto free;
+	}
+
+	if (pred.late > react.late) {
+		IPA_UT_ERR("late samples %d reactive %d\n", pred.late,
+			react.late);
+		IPA_UT_TEST_FAIL_REPORT("more late samples");
+		rc = -EINVAL;
+		goto free;
+	}
+
+	/* holding the higher vote costs energy, but bounded */
+	if (pred.energy * 100 > react.energy * 140) {
+		IPA_UT_ERR("energy %d reactive %d\n", pred.energy,
+			react.energy);
+		IPA_UT_TEST_FAIL_REPORT("too much energy on oscillation");
+		rc = -EINVAL;
+	}
+
+free:
+	kfree(gov);
+	return rc;
+}
+
+static int ipa_pm_ut_gov_burst(void *priv)
+{
+	struct ipa_pm_ut_gov_result pred, react;
+	struct ipa_pm_gov *gov;
+	int rc = 0;
+
+	gov = kzalloc(sizeof(*gov), GFP_KERNEL);
+	if (!gov)
+		return -ENOMEM;
+
+	ipa_pm_ut_gov_run(gov, ipa_pm_ut_gov_burst_rate, NULL, 550,
+		&pred, &react);
+
+	if (pred.late > react.late || pred.switches > react.switches) {
+		IPA_UT_ERR("late %d/%d switches %d/%d\n", pred.late,
+			react.late, pred.switches, react.switches);
+		IPA_UT_TEST_FAIL_REPORT("worse than reactive on bursts");
+		rc = -EINVAL;
+		goto free;
+	}
+
+	/* each burst keeps the clock up for one dwell time */
+	if (pred.energy * 100 > react.energy * 140) {
+		IPA_UT_ERR("energy %d reactive %d\n", pred.energy,
+			react.energy);
+		IPA_UT_TEST_FAIL_REPORT("too much energy on bursts");
+		rc = -EINVAL;
+		goto free;
+	}
+
+	if (gov->vote != 1 || !gov->downs || !gov->trace_idx) {
+		IPA_UT_ERR("vote %d downs %u trace %u\n", gov->vote,
+			gov->downs, gov->trace_idx);
+		IPA_UT_TEST_FAIL_REPORT("no scale down after bursts");
+		rc = -EINVAL;
+	}
+
+free:
+	kfree(gov);
+	return rc;
+}
+
+static int ipa_pm_ut_gov_occupancy(void *priv)
+{
+	struct ipa_pm_ut_gov_result pred, react;
+	struct ipa_pm_gov *gov;
+	int rc = 0;
+
+	gov = kzalloc(sizeof(*gov), GFP_KERNEL);
+	if (!gov)
+		return -ENOMEM;
+
+	/* stop while the rings are still backed up */
+	ipa_pm_ut_gov_run(gov, ipa_pm_ut_gov_steady_rate,
+		ipa_pm_ut_gov_backlog, 40, &pred, &react);
+
+	if (gov->vote != IPA_PM_UT_GOV_TH_SIZE + 1 || gov->downs) {
+		IPA_UT_ERR("vote %d downs %u\n", gov->vote, gov->downs);
+		IPA_UT_TEST_FAIL_REPORT("backlog did not hold max clock");
+		rc = -EINVAL;
+		goto free;
+	}
+
+	ipa_pm_ut_gov_run(gov, ipa_pm_ut_gov_steady_rate,
+		ipa_pm_ut_gov_backlog, 100, &pred, &react);
+
+	if (gov->vote != 1) {
+		IPA_UT_ERR("vote is at %d after backlog\n", gov->vote);
+		IPA_UT_TEST_FAIL_REPORT("no scale down after backlog");
+		rc = -EINVAL;
+	}
+
+free:
+	kfree(gov);
+	return rc;
+}
+
 /* Suite definition block */
 IPA_UT_DEFINE_SUITE_START(pm, "PM for IPA",
 	ipa_pm_ut_setup, ipa_pm_ut_teardown)
@@ -1807,4 +2077,20 @@ IPA_UT_DEFINE_SUITE_START(pm, "PM for IPA",
 		"throughput while passing simple exception",
 		ipa_pm_ut_simple_exception,
 		true, IPA_HW_v4_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(gov_ramp,
+		"Predictive governor on a traffic ramp",
+		ipa_pm_ut_gov_ramp,
+		true, IPA_HW_v4_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(gov_oscillation,
+		"Predictive governor around a threshold",
+		ipa_pm_ut_gov_oscillation,
+		true, IPA_HW_v4_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(gov_burst,
+		"Predictive governor on traffic bursts",
+		ipa_pm_ut_gov_burst,
+		true, IPA_HW_v4_0, IPA_HW_MAX),
+	IPA_UT_ADD_TEST(gov_occupancy,
+		"Predictive governor on ring backlog",
+		ipa_pm_ut_gov_occupancy,
+		true, IPA_HW_v4_0, IPA_HW_MAX),
 } IPA_UT_DEFINE_SUITE_END(pm);
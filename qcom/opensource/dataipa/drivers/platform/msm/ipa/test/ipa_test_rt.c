@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+#include <linux/ktime.h>
+#include "ipa_ut_framework.h"
+#include "ipa_i.h"
+
+/**
+ * Routing rules install benchmark
+ * Installs IPA_TEST_RT_ROUTES routes spread over IPA_TEST_RT_TBLS per-client
+ * tables, the way a tethering setup with many clients does, and reports the
+ * time spent adding, looking up the tables and removing them.
+ * Rules are only committed to HW once the whole set is in place so the
+ * numbers reflect the SW rules database.
+ */
+
+#define IPA_TEST_RT_ROUTES 5000
+#define IPA_TEST_RT_TBLS 10
+/* num_rules of the add/del ioctls is 8 bits wide */
+#define IPA_TEST_RT_BATCH 250
+#define IPA_TEST_RT_LOOKUPS 10000
+#define IPA_TEST_RT_TBL_NAME "ut_rt_bench_%d"
+
+struct ipa_test_rt_ctx {
+	u32 *hdls;
+	u32 installed;
+	struct ipa_ioc_add_rt_rule_v2 *add;
+	struct ipa_rt_rule_add_i *add_rules;
+	struct ipa_ioc_del_rt_rule *del;
+};
+
+static struct ipa_test_rt_ctx *ctx;
+
+static int ipa_test_rt_suite_setup(void **ppriv)
+{
+	IPA_UT_DBG("Start Setup\n");
+
+	ctx = kzalloc(sizeof(*ctx), GFP_KERNEL);
+	if (!ctx)
+		return -ENOMEM;
+
+	ctx->hdls = kcalloc(IPA_TEST_RT_ROUTES, sizeof(*ctx->hdls),
+		GFP_KERNEL);
+	ctx->add = kzalloc(sizeof(*ctx->add), GFP_KERNEL);
+	ctx->add_rules = kcalloc(IPA_TEST_RT_BATCH,
+		sizeof(*ctx->add_rules), GFP_KERNEL);
+	ctx->del = kzalloc(sizeof(*ctx->del) + IPA_TEST_RT_BATCH *
+		sizeof(struct ipa_rt_rule_del), GFP_KERNEL);
+	if (!ctx->hdls || !ctx->add || !ctx->add_rules || !ctx->del) {
+		IPA_UT_ERR("no mem\n");
+		kfree(ctx->del);
+		kfree(ctx->add_rules);
+		kfree(ctx->add);
+		kfree(ctx->hdls);
+		kfree(ctx);
+		ctx = NULL;
+		return -ENOMEM;
+	}
+	ctx->add->rules = (uint64_t)ctx->add_rules;
+
+	return 0;
+}
+
+static int ipa_test_rt_suite_teardown(void *priv)
+{
+	IPA_UT_DBG("Start Teardown\n");
+
+	if (!ctx)
+		return 0;
+
+	kfree(ctx->del);
+	kfree(ctx->add_rules);
+	kfree(ctx->add);
+	kfree(ctx->hdls);
+	kfree(ctx);
+	ctx = NULL;
+
+	return 0;
+}
+
+static void ipa_test_rt_fill_rule(enum ipa_ip_type ip, u32 route,
+	struct ipa_rt_rule_i *rule)
+{
+	memset(rule, 0, sizeof(*rule));
+	rule->dst = IPA_CLIENT_APPS_LAN_CONS;
+	rule->hashable = true;
+	rule->attrib.attrib_mask = IPA_FLT_DST_ADDR;
+	if (ip == IPA_IP_v4) {
+		rule->attrib.u.v4.dst_addr = 0x0a000000 | route;
+		rule->attrib.u.v4.dst_addr_mask = 0xffffffff;
+	} else {
+		rule->attrib.u.v6.dst_addr[0] = 0xfd000000;
+		rule->attrib.u.v6.dst_addr[3] = route;
+		memset(rule->attrib.u.v6.dst_addr_mask, 0xff,
+			sizeof(rule->attrib.u.v6.dst_addr_mask));
+	}
+}
+
+/* install all routes, @batch rules per ipa3_add_rt_rule_v2() call */
+static int ipa_test_rt_install(enum ipa_ip_type ip, u32 batch, s64 *usec)
+{
+	u32 per_tbl = IPA_TEST_RT_ROUTES / IPA_TEST_RT_TBLS;
+	u32 route;
+	u32 i;
+	int tbl;
+	ktime_t start;
+
+	*usec = 0;
+	ctx->installed = 0;
+	for (tbl = 0; tbl < IPA_TEST_RT_TBLS; tbl++) {
+		for (route = tbl * per_tbl; route < (tbl + 1) * per_tbl;
+			route += batch) {
+			memset(ctx->add_rules, 0,
+				batch * sizeof(*ctx->add_rules));
+			for (i = 0; i < batch; i++) {
+				ctx->add_rules[i].at_rear = 1;
+				ipa_test_rt_fill_rule(ip, route + i,
+					&ctx->add_rules[i].rule);
+			}
+			ctx->add->commit = 0;
+			ctx->add->ip = ip;
+			ctx->add->num_rules = batch;
+			snprintf(ctx->add->rt_tbl_name, IPA_RESOURCE_NAME_MAX,
+				IPA_TEST_RT_TBL_NAME, tbl);
+
+			start = ktime_get();
+			if (ipa3_add_rt_rule_v2(ctx->add)) {
+				IPA_UT_ERR("add failed tbl %d route %u\n",
+					tbl, route);
+				return -EFAULT;
+			}
+			*usec += ktime_us_delta(ktime_get(), start);
+
+			for (i = 0; i < batch; i++) {
+				if (ctx->add_rules[i].status) {
+					IPA_UT_ERR("rule %u not added\n",
+						route + i);
+					return -EFAULT;
+				}
+				ctx->hdls[route + i] =
+					ctx->add_rules[i].rt_rule_hdl;
+				ctx->installed++;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int ipa_test_rt_lookup(enum ipa_ip_type ip, s64 *usec)
+{
+	struct ipa_ioc_get_rt_tbl_indx indx;
+	ktime_t start;
+	int i;
+
+	memset(&indx, 0, sizeof(indx));
+	indx.ip = ip;
+	start = ktime_get();
+	for (i = 0; i < IPA_TEST_RT_LOOKUPS; i++) {
+		snprintf(indx.name, IPA_RESOURCE_NAME_MAX,
+			IPA_TEST_RT_TBL_NAME, i % IPA_TEST_RT_TBLS);
+		if (ipa3_query_rt_index(&indx)) {
+			IPA_UT_ERR("tbl %d not found\n", i % IPA_TEST_RT_TBLS);
+			return -EFAULT;
+		}
+	}
+	*usec = ktime_us_delta(ktime_get(), start);
+
+	return 0;
+}
+
+/* remove all installed routes, tables go away with their last rule */
+static int ipa_test_rt_remove(enum ipa_ip_type ip, s64 *usec)
+{
+	u32 num = ctx->installed;
+	ktime_t start;
+	u32 route;
+	u32 batch;
+	u32 i;
+	int ret = 0;
+
+	*usec = 0;
+	for (route = 0; route < num; route += batch) {
+		batch = min_t(u32, IPA_TEST_RT_BATCH, num - route);
+		ctx->del->commit = (route + batch == num);
+		ctx->del->ip = ip;
+		ctx->del->num_hdls = batch;
+		for (i = 0; i < batch; i++) {
+			ctx->del->hdl[i].hdl = ctx->hdls[route + i];
+			ctx->del->hdl[i].status = 0;
+		}
+
+		start = ktime_get();
+		if (ipa3_del_rt_rule(ctx->del)) {
+			IPA_UT_ERR("del failed route %u\n", route);
+			ret = -EFAULT;
+		}
+		*usec += ktime_us_delta(ktime_get(), start);
+
+		for (i = 0; i < batch; i++) {
+			if (ctx->del->hdl[i].status) {
+				IPA_UT_ERR("rule %u not deleted\n", route + i);
+				ret = -EFAULT;
+			}
+		}
+	}
+
+	return ret;
+}
+
+static int ipa_test_rt_bench(enum ipa_ip_type ip, u32 batch)
+{
+	s64 add_usec;
+	s64 lookup_usec;
+	s64 commit_usec;
+	s64 del_usec;
+	ktime_t start;
+	int ret;
+
+	ret = ipa_test_rt_install(ip, batch, &add_usec);
+	if (ret) {
+		IPA_UT_TEST_FAIL_REPORT("fail to install routes");
+		goto remove;
+	}
+
+	ret = ipa_test_rt_lookup(ip, &lookup_usec);
+	if (ret) {
+		IPA_UT_TEST_FAIL_REPORT("fail to lookup tables");
+		goto remove;
+	}
+
+	start = ktime_get();
+	ret = ipa3_commit_rt(ip);
+	commit_usec = ktime_us_delta(ktime_get(), start);
+	if (ret) {
+		IPA_UT_TEST_FAIL_REPORT("fail to commit routes");
+		goto remove;
+	}
+
+	IPA_UT_LOG("ip=%d routes=%d tbls=%d batch=%u\n", ip,
+		IPA_TEST_RT_ROUTES, IPA_TEST_RT_TBLS, batch);
+	IPA_UT_LOG("add %lld usec (%lld nsec/route)\n", add_usec,
+		add_usec * 1000 / IPA_TEST_RT_ROUTES);
+	IPA_UT_LOG("%d lookups %lld usec\n", IPA_TEST_RT_LOOKUPS,
+		lookup_usec);
+	IPA_UT_LOG("commit %lld usec\n", commit_usec);
+
+remove:
+	if (ipa_test_rt_remove(ip, &del_usec)) {
+		IPA_UT_TEST_FAIL_REPORT("fail to remove routes");
+		return -EFAULT;
+	}
+	IPA_UT_LOG("del %lld usec\n", del_usec);
+
+	return ret;
+}
+
+static int ipa_test_rt_bench_v4_batch(void *priv)
+{
+	return ipa_test_rt_bench(IPA_IP_v4, IPA_TEST_RT_BATCH);
+}
+
+static int ipa_test_rt_bench_v4_single(void *priv)
+{
+	return ipa_test_rt_bench(IPA_IP_v4, 1);
+}
+
+static int ipa_test_rt_bench_v6_batch(void *priv)
+{
+	return ipa_test_rt_bench(IPA_IP_v6, IPA_TEST_RT_BATCH);
+}
+
+/* Suite definition block */
+IPA_UT_DEFINE_SUITE_START(rt, "Routing rules install benchmark",
+	ipa_test_rt_suite_setup, ipa_test_rt_suite_teardown)
+{
+	IPA_UT_ADD_TEST(bench_v4_batch, "Install 5k v4 routes in batches",
+		ipa_test_rt_bench_v4_batch, false, IPA_HW_v3_0, IPA_HW_MAX),
+
+	IPA_UT_ADD_TEST(bench_v4_single, "Install 5k v4 routes one by one",
+		ipa_test_rt_bench_v4_single, false, IPA_HW_v3_0, IPA_HW_MAX),
+
+	IPA_UT_ADD_TEST(bench_v6_batch, "Install 5k v6 routes in batches",
+		ipa_test_rt_bench_v6_batch, false, IPA_HW_v3_0, IPA_HW_MAX),
+} IPA_UT_DEFINE_SUITE_END(rt);
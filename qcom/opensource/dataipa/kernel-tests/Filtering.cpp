@@ -35,12 +35,13 @@
 
 #include "Filtering.h"
 #include "Constants.h"
+#include "IPADevice.h"
 
 const char* Filtering::DEVICE_NAME = "/dev/ipa";
 
 Filtering::Filtering()
 {
-	fd = open(DEVICE_NAME, O_RDWR);
+	fd = IPADeviceOpen(DEVICE_NAME, O_RDWR);
 	if (0 == fd) {
 		printf("Failed opening %s.\n", DEVICE_NAME);
 	}
@@ -48,7 +49,7 @@ Filtering::Filtering()
 
 Filtering::~Filtering()
 {
-	close(fd);
+	IPADeviceClose(fd);
 }
 
 bool Filtering::DeviceNodeIsOpened()
@@ -60,7 +61,7 @@ bool Filtering::AddFilteringRule(struct ipa_ioc_add_flt_rule const * ruleTable)
 {
 	int retval = 0;
 
-	retval = ioctl(fd, IPA_IOC_ADD_FLT_RULE, ruleTable);
+	retval = IPADeviceIoctl(fd, IPA_IOC_ADD_FLT_RULE, ruleTable);
 	if (retval) {
 		printf("%s(), failed adding Filtering rule table %p\n", __FUNCTION__, ruleTable);
 		return false;
@@ -74,7 +75,7 @@ bool Filtering::AddFilteringRule(struct ipa_ioc_add_flt_rule_v2 const * ruleTabl
 {
 	int retval = 0;
 
-	retval = ioctl(fd, IPA_IOC_ADD_FLT_RULE_V2, ruleTable);
+	retval = IPADeviceIoctl(fd, IPA_IOC_ADD_FLT_RULE_V2, ruleTable);
 	if (retval) {
 		printf("%s(), failed adding Filtering rule table %p\n", __FUNCTION__, ruleTable);
 		return false;
@@ -88,7 +89,7 @@ bool Filtering::DeleteFilteringRule(struct ipa_ioc_del_flt_rule *ruleTable)
 {
 	int retval = 0;
 
-	retval = ioctl(fd, IPA_IOC_DEL_FLT_RULE, ruleTable);
+	retval = IPADeviceIoctl(fd, IPA_IOC_DEL_FLT_RULE, ruleTable);
 	if (retval) {
 		printf("%s(), failed deleting Filtering rule in table %p\n", __FUNCTION__, ruleTable);
 		return false;
@@ -135,7 +136,7 @@ bool Filtering::AddEoGREMap(
 	einfo.map_info.dscp[0][PCP_VAL] = DSCP_VAL;
 	einfo.map_info.num_vlan         = 1;
 
-	retval = ioctl(fd, IPA_IOC_ADD_EoGRE_MAPPING, &einfo);
+	retval = IPADeviceIoctl(fd, IPA_IOC_ADD_EoGRE_MAPPING, &einfo);
 
 	if (retval) {
 		printf("%s(), Failed adding eogre mapping data\n", __FUNCTION__);
@@ -151,7 +152,7 @@ bool Filtering::ClrEoGREMap()
 {
 	int retval = 0;
 
-	retval = ioctl(fd, IPA_IOC_DEL_EoGRE_MAPPING, 0);
+	retval = IPADeviceIoctl(fd, IPA_IOC_DEL_EoGRE_MAPPING, 0);
 
 	if (retval) {
 		printf("%s(), Failed clearing eogre mapping data\n", __FUNCTION__);
@@ -167,7 +168,7 @@ bool Filtering::Commit(enum ipa_ip_type ip)
 {
 	int retval = 0;
 
-	retval = ioctl(fd, IPA_IOC_COMMIT_FLT, ip);
+	retval = IPADeviceIoctl(fd, IPA_IOC_COMMIT_FLT, ip);
 	if (retval) {
 		printf("%s(), failed committing Filtering rules.\n", __FUNCTION__);
 		return false;
@@ -181,8 +182,8 @@ bool Filtering::Reset(enum ipa_ip_type ip)
 {
 	int retval = 0;
 
-	retval = ioctl(fd, IPA_IOC_RESET_FLT, ip);
-	retval |= ioctl(fd, IPA_IOC_COMMIT_FLT, ip);
+	retval = IPADeviceIoctl(fd, IPA_IOC_RESET_FLT, ip);
+	retval |= IPADeviceIoctl(fd, IPA_IOC_COMMIT_FLT, ip);
 	if (retval) {
 		printf("%s(), failed resetting Filtering block.\n", __FUNCTION__);
 		return false;
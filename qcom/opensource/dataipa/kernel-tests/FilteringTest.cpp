@@ -43,6 +43,7 @@
 #include "Filtering.h"
 #include "RoutingDriverWrapper.h"
 #include "IPAFilteringTable.h"
+#include "IPADevice.h"
 
 //TODO Add Enum for IP/TCP/UDP Fields
 
@@ -8806,7 +8807,7 @@ public:
 		int fd;
 
 		// Open ipa_test device node
-		fd = open("/dev/ipa_test", O_RDONLY);
+		fd = IPADeviceOpen("/dev/ipa_test", O_RDONLY);
 		if (fd < 0) {
 			printf("Failed opening %s. errno %d: %s\n", "/dev/ipa_test", errno, strerror(errno));
 			return false;
@@ -8815,12 +8816,12 @@ public:
 		printf("%s(), fd is %d\n", __FUNCTION__, fd);
 
 		while (FilterTable0.size() < MAX_RULES_NUM &&
-			ioctl(fd, IPA_TEST_IOC_IS_TEST_PROD_FLT_IN_SRAM, m_IpaIPType)) {
+			IPADeviceIoctl(fd, IPA_TEST_IOC_IS_TEST_PROD_FLT_IN_SRAM, m_IpaIPType)) {
 			if (!AddRuleToEnd())
 				return false;
 			printf("%s, %s() Added rule #%d sucessfully \n", __FUNCTION__, __FILE__, FilterTable0.size() - 1);
 		}
-		close(fd);
+		IPADeviceClose(fd);
 
 		printf("Leaving %s, %s()\n", __FUNCTION__, __FILE__);
 		return true;
@@ -8850,7 +8851,7 @@ public:
 		int fd;
 
 		// Open ipa_test device node
-		fd = open("/dev/ipa_test", O_RDONLY);
+		fd = IPADeviceOpen("/dev/ipa_test", O_RDONLY);
 		if (fd < 0) {
 			printf("Failed opening %s. errno %d: %s\n", "/dev/ipa_test", errno, strerror(errno));
 			return false;
@@ -8858,10 +8859,10 @@ public:
 
 		printf("%s(), fd is %d\n", __FUNCTION__, fd);
 		while (FilterTable0.size() > MIN_RULES_NUM &&
-			!ioctl(fd, IPA_TEST_IOC_IS_TEST_PROD_FLT_IN_SRAM, m_IpaIPType))
+			!IPADeviceIoctl(fd, IPA_TEST_IOC_IS_TEST_PROD_FLT_IN_SRAM, m_IpaIPType))
 			if (!RemoveLastRule())
 				return false;
-		close(fd);
+		IPADeviceClose(fd);
 
 		printf("Leaving %s, %s()\n", __FUNCTION__, __FILE__);
 		return true;
@@ -36,6 +36,7 @@
 
 #include "HeaderInsertion.h"
 #include "TestsUtils.h"
+#include "IPADevice.h"
 
 /*All interaction through the driver are
  * made through this inode.
@@ -48,7 +49,7 @@ static const char* DEVICE_NAME = "/dev/ipa";
 
 HeaderInsertion::HeaderInsertion()
 {
-	m_fd = open(DEVICE_NAME, O_RDWR);
+	m_fd = IPADeviceOpen(DEVICE_NAME, O_RDWR);
 	if (-1 == m_fd)
 	{
 		printf(
@@ -61,7 +62,7 @@ HeaderInsertion::~HeaderInsertion()
 {
 	if (-1 != m_fd)
 	{
-		close(m_fd);
+		IPADeviceClose(m_fd);
 	}
 }
 
@@ -74,7 +75,7 @@ bool HeaderInsertion::AddHeader(struct ipa_ioc_add_hdr *pHeaderTableToAdd)
 {
 	int nRetVal = 0;
 	/*call the Driver ioctl in order to add header*/
-	nRetVal = ioctl(m_fd, IPA_IOC_ADD_HDR, pHeaderTableToAdd);
+	nRetVal = IPADeviceIoctl(m_fd, IPA_IOC_ADD_HDR, pHeaderTableToAdd);
 	LOG_IOCTL_RETURN_VALUE(nRetVal);
 	return (-1 != nRetVal);
 }
@@ -83,7 +84,7 @@ bool HeaderInsertion::addHeaderHpc(const string& name, uint8_t* header, const si
 	if(name.empty() || name.size() >= IPA_RESOURCE_NAME_MAX){
 		return false;
 	}
-	int fd = open(CONFIGURATION_NODE_PATH, O_RDONLY);
+	int fd = IPADeviceOpen(CONFIGURATION_NODE_PATH, O_RDONLY);
 	if (fd < 0) {
 		cout << "failed to open " << CONFIGURATION_NODE_PATH << endl;
 		return false;
@@ -102,24 +103,24 @@ bool HeaderInsertion::addHeaderHpc(const string& name, uint8_t* header, const si
 	h->status = -1;
 	h->is_partial = isPartial;
 	cout << "h->name=" << h->name << ", h->is_partial=" << h->is_partial << endl;
-	int result = ioctl(fd, IPA_TEST_IOC_ADD_HDR_HPC, iocH);
+	int result = IPADeviceIoctl(fd, IPA_TEST_IOC_ADD_HDR_HPC, iocH);
 	if(result || h->status){
 		free(iocH);
-		close(fd);
+		IPADeviceClose(fd);
 		return false;
 	}
 	cout << "result=" << result << ", status=" << h->status << ", ipaClient=" << ipaClient << endl;
     struct ipa_pkt_init_ex_hdr_ofst_set lookup;
     lookup.ep = ipaClient;
     strlcpy(lookup.name, name.c_str(), IPA_RESOURCE_NAME_MAX);
-    result = ioctl(fd, IPA_TEST_IOC_PKT_INIT_EX_SET_HDR_OFST , &lookup);
+    result = IPADeviceIoctl(fd, IPA_TEST_IOC_PKT_INIT_EX_SET_HDR_OFST , &lookup);
     if (result) {
 		free(iocH);
-		close(fd);
+		IPADeviceClose(fd);
 		return false;
     }
 	free(iocH);
-	close(fd);
+	IPADeviceClose(fd);
 	return true;
 }
 
@@ -127,7 +128,7 @@ bool HeaderInsertion::DeleteHeader(struct ipa_ioc_del_hdr *pHeaderTableToDelete)
 {
 	int nRetVal = 0;
 	/*call the Driver ioctl in order to remove header*/
-	nRetVal = ioctl(m_fd, IPA_IOC_DEL_HDR , pHeaderTableToDelete);
+	nRetVal = IPADeviceIoctl(m_fd, IPA_IOC_DEL_HDR , pHeaderTableToDelete);
 	LOG_IOCTL_RETURN_VALUE(nRetVal);
 	return (-1 != nRetVal);
 }
@@ -162,7 +163,7 @@ bool HeaderInsertion::AddProcCtx(struct ipa_ioc_add_hdr_proc_ctx *procCtxTable)
 {
 	int retval = 0;
 
-	retval = ioctl(m_fd, IPA_IOC_ADD_HDR_PROC_CTX, procCtxTable);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_ADD_HDR_PROC_CTX, procCtxTable);
 	if (retval) {
 		printf("%s(), failed adding ProcCtx rule table %p\n", __FUNCTION__, procCtxTable);
 		return false;
@@ -176,7 +177,7 @@ bool HeaderInsertion::DeleteProcCtx(struct ipa_ioc_del_hdr_proc_ctx *procCtxTabl
 {
 	int retval = 0;
 
-	retval = ioctl(m_fd, IPA_IOC_DEL_HDR_PROC_CTX, procCtxTable);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_DEL_HDR_PROC_CTX, procCtxTable);
 	if (retval) {
 		printf("%s(), failed deleting ProcCtx rule in table %p\n", __FUNCTION__, procCtxTable);
 		return false;
@@ -189,7 +190,7 @@ bool HeaderInsertion::DeleteProcCtx(struct ipa_ioc_del_hdr_proc_ctx *procCtxTabl
 bool HeaderInsertion::Commit()
 {
 	int nRetVal = 0;
-	nRetVal = ioctl(m_fd, IPA_IOC_COMMIT_HDR);
+	nRetVal = IPADeviceIoctl(m_fd, IPA_IOC_COMMIT_HDR);
 	LOG_IOCTL_RETURN_VALUE(nRetVal);
 	return true;
 }
@@ -198,8 +199,8 @@ bool HeaderInsertion::Reset()
 {
 	int nRetVal = 0;
 
-	nRetVal = ioctl(m_fd, IPA_IOC_RESET_HDR);
-	nRetVal |= ioctl(m_fd, IPA_IOC_COMMIT_HDR);
+	nRetVal = IPADeviceIoctl(m_fd, IPA_IOC_RESET_HDR);
+	nRetVal |= IPADeviceIoctl(m_fd, IPA_IOC_COMMIT_HDR);
 	LOG_IOCTL_RETURN_VALUE(nRetVal);
 	return true;
 }
@@ -211,7 +212,7 @@ bool HeaderInsertion::GetHeaderHandle(struct ipa_ioc_get_hdr *pHeaderStruct)
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_GET_HDR, pHeaderStruct);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_GET_HDR, pHeaderStruct);
 	if (retval) {
 		printf(
 		"%s(), IPA_IOC_GET_HDR ioctl failed, routingTable =0x%p, retval=0x%x.\n"
@@ -251,7 +252,7 @@ bool HeaderInsertion::CopyHeader(struct ipa_ioc_copy_hdr *pCopyHeaderStruct)
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_COPY_HDR, pCopyHeaderStruct);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_COPY_HDR, pCopyHeaderStruct);
 	if (retval) {
 		printf(
 		"%s(), IPA_IOC_COPY_HDR ioctl failed, retval=0x%x.\n",
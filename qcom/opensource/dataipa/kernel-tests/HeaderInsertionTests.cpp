@@ -33,6 +33,7 @@
 #include "IPAFilteringTable.h"
 #include "hton.h" // for htonl
 #include "TestsUtils.h"
+#include "IPADevice.h"
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
@@ -131,21 +132,21 @@ public:
 		int fd;
 		struct ipa_test_mem_partition mem_part;
 
-		fd = open("/dev/ipa_test", O_RDONLY);
+		fd = IPADeviceOpen("/dev/ipa_test", O_RDONLY);
 		if (fd < 0) {
 			printf("Failed opening %s. errno %d: %s\n", "/dev/ipa_test",
 				errno, strerror(errno));
 			return 0;
 		}
 
-		if (ioctl(fd, IPA_TEST_IOC_GET_MEM_PART, &mem_part) < 0) {
+		if (IPADeviceIoctl(fd, IPA_TEST_IOC_GET_MEM_PART, &mem_part) < 0) {
 			printf("Failed ioctl IPA_TEST_IOC_GET_MEM_PART. errno %d: %s\n",
 				errno, strerror(errno));
-			close(fd);
+			IPADeviceClose(fd);
 			return 0;
 		}
 
-		close(fd);
+		IPADeviceClose(fd);
 
 		return mem_part.apps_hdr_size;
 	}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+
+#include "IPADevice.h"
+#ifdef IPA_SIMULATOR
+#include "IPASimulator.h"
+#endif
+
+int IPADeviceOpen(const char *path, int flags)
+{
+#ifdef IPA_SIMULATOR
+	if (IPASimulator::IsSimulatedPath(path))
+		return IPASimulator::GetInstance()->Open(path, flags);
+#endif
+	return open(path, flags);
+}
+
+int IPADeviceClose(int fd)
+{
+#ifdef IPA_SIMULATOR
+	if (IPASimulator::IsSimulatedFd(fd))
+		return IPASimulator::GetInstance()->Close(fd);
+#endif
+	return close(fd);
+}
+
+ssize_t IPADeviceRead(int fd, void *buf, size_t count)
+{
+#ifdef IPA_SIMULATOR
+	if (IPASimulator::IsSimulatedFd(fd))
+		return IPASimulator::GetInstance()->Read(fd, buf, count);
+#endif
+	return read(fd, buf, count);
+}
+
+ssize_t IPADeviceWrite(int fd, const void *buf, size_t count)
+{
+#ifdef IPA_SIMULATOR
+	if (IPASimulator::IsSimulatedFd(fd))
+		return IPASimulator::GetInstance()->Write(fd, buf, count);
+#endif
+	return write(fd, buf, count);
+}
+
+int IPADeviceFcntl(int fd, int cmd, int arg)
+{
+#ifdef IPA_SIMULATOR
+	if (IPASimulator::IsSimulatedFd(fd))
+		return IPASimulator::GetInstance()->Fcntl(fd, cmd, arg);
+#endif
+	return fcntl(fd, cmd, arg);
+}
+
+int IPADeviceIoctl(int fd, unsigned long request, unsigned long arg)
+{
+#ifdef IPA_SIMULATOR
+	if (IPASimulator::IsSimulatedFd(fd))
+		return IPASimulator::GetInstance()->Ioctl(fd, request, arg);
+#endif
+	return ioctl(fd, request, arg);
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef IPA_DEVICE_H_
+#define IPA_DEVICE_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/*
+ * Every access of the test application to the IPA driver (/dev/ipa), to
+ * the test module configuration node (/dev/ipa_test) and to the test
+ * module pipes (/dev/to_ipa_N, /dev/from_ipa_N, /dev/ipa_exception_pipe)
+ * goes through these calls.
+ * On target they are plain open/ioctl/read/write/close/fcntl. When built
+ * with IPA_SIMULATOR the IPA device nodes are served by IPASimulator, so
+ * the same fixtures run on a build host.
+ */
+
+int IPADeviceOpen(const char *path, int flags);
+int IPADeviceClose(int fd);
+ssize_t IPADeviceRead(int fd, void *buf, size_t count);
+ssize_t IPADeviceWrite(int fd, const void *buf, size_t count);
+int IPADeviceFcntl(int fd, int cmd, int arg = 0);
+int IPADeviceIoctl(int fd, unsigned long request, unsigned long arg = 0);
+
+template <typename T>
+inline int IPADeviceIoctl(int fd, unsigned long request, T *arg)
+{
+	return IPADeviceIoctl(fd, request, (unsigned long)arg);
+}
+
+#endif
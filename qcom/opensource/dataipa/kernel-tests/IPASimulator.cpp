@@ -0,0 +1,1796 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "IPASimulator.h"
+
+/* Simulated descriptors live far above anything the process opens */
+#define IPA_SIM_FD_BASE 0x40000000
+
+#define IPA_SIM_HW_TYPE_ENV "IPA_SIM_HW_TYPE"
+#define IPA_SIM_DFLT_HW_TYPE IPA_HW_v4_5
+
+/* Status opcode of a packet status in the HW status format */
+#define IPA_SIM_STATUS_OPCODE_PACKET 0x1
+
+/* A test pipe read gives up after 10 polls of 5 msec, like the test module */
+#define IPA_SIM_READ_POLL_USEC 50000
+
+/*
+ * Non hashable filtering table space of the test producer in SRAM.
+ * Each rule is accounted at a fixed size; once the table outgrows the
+ * space it is reported as residing in DDR.
+ */
+#define IPA_SIM_FLT_NHASH_SRAM_SIZE 2048
+#define IPA_SIM_FLT_RULE_SIZE 32
+
+#define IPA_SIM_APPS_HDR_SIZE 2048
+
+/* Flows held by each of the filtering and routing hash caches */
+#define IPA_SIM_CACHE_ENTRIES 64
+
+#define MBIM_NTH16_SIZE 12
+#define MBIM_NDP16_HDR_SIZE 8
+
+static const uint8_t MBIM_NTH16_SIGNATURE[] = {'N', 'C', 'M', 'H'};
+static const uint8_t MBIM_DFLT_NDP16_SIGNATURE[] = {'I', 'P', 'S', 0};
+
+#define IPA_SIM_V4_ATTRIBS (IPA_FLT_TOS | IPA_FLT_PROTOCOL | IPA_FLT_TOS_MASKED)
+#define IPA_SIM_V6_ATTRIBS (IPA_FLT_TC | IPA_FLT_FLOW_LABEL | IPA_FLT_NEXT_HDR)
+#define IPA_SIM_COMMON_ATTRIBS (IPA_FLT_SRC_ADDR | IPA_FLT_DST_ADDR | \
+	IPA_FLT_SRC_PORT_RANGE | IPA_FLT_DST_PORT_RANGE | IPA_FLT_TYPE | \
+	IPA_FLT_CODE | IPA_FLT_SPI | IPA_FLT_SRC_PORT | IPA_FLT_DST_PORT | \
+	IPA_FLT_META_DATA | IPA_FLT_FRAGMENT | IPA_FLT_TCP_SYN | \
+	IPA_FLT_IS_PURE_ACK | IPA_FLT_MAC_ETHER_TYPE | IPA_FLT_VLAN_ID | \
+	IPA_FLT_MAC_DST_ADDR_ETHER_II | IPA_FLT_MAC_SRC_ADDR_ETHER_II | \
+	IPA_FLT_MAC_DST_ADDR_802_3 | IPA_FLT_MAC_SRC_ADDR_802_3 | \
+	IPA_FLT_MAC_DST_ADDR_802_1Q | IPA_FLT_MAC_SRC_ADDR_802_1Q)
+
+static uint16_t GetBe16(const uint8_t *p)
+{
+	return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t GetBe32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+		((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint16_t GetLe16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t GetLe32(const uint8_t *p)
+{
+	return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+		((uint32_t)p[3] << 24);
+}
+
+static void PutLe16(uint8_t *p, uint16_t val)
+{
+	p[0] = val & 0xFF;
+	p[1] = val >> 8;
+}
+
+static void Put16(uint8_t *p, uint16_t val, bool littleEndian)
+{
+	if (littleEndian) {
+		PutLe16(p, val);
+	} else {
+		p[0] = val >> 8;
+		p[1] = val & 0xFF;
+	}
+}
+
+static uint64_t NowUsec()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static size_t Align4(size_t len)
+{
+	return (len + 3) & ~(size_t)3;
+}
+
+static int ParseNodeIndex(const char *path, const char *prefix)
+{
+	size_t len = strlen(prefix);
+	char *end;
+	long index;
+
+	if (strncmp(path, prefix, len) || !path[len])
+		return -1;
+	index = strtol(path + len, &end, 10);
+	if (*end || index < 0)
+		return -1;
+	return (int)index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+IPASimulator *IPASimulator::GetInstance()
+{
+	static IPASimulator instance;
+
+	return &instance;
+}
+
+IPASimulator::IPASimulator() :
+	m_hwType(IPA_SIM_DFLT_HW_TYPE),
+	m_nextFd(IPA_SIM_FD_BASE),
+	m_configuration(-1),
+	m_nextHdl(1)
+{
+	const char *hwType = getenv(IPA_SIM_HW_TYPE_ENV);
+
+	if (hwType && *hwType)
+		m_hwType = (enum ipa_hw_type)atoi(hwType);
+	LOG_MSG_DEBUG("IPA simulator, HW type %d", m_hwType);
+}
+
+bool IPASimulator::IsSimulatedPath(const char *path)
+{
+	if (!path)
+		return false;
+
+	return !strcmp(path, "/dev/ipa") ||
+		!strcmp(path, CONFIGURATION_NODE_PATH) ||
+		!strcmp(path, INTERFACE_FROM_IPA_EXCEPTION_PATH) ||
+		ParseNodeIndex(path, "/dev/to_ipa_") >= 0 ||
+		ParseNodeIndex(path, "/dev/from_ipa_") >= 0;
+}
+
+bool IPASimulator::IsSimulatedFd(int fd)
+{
+	return fd >= IPA_SIM_FD_BASE;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// File operations
+
+int IPASimulator::Open(const char *path, int flags)
+{
+	OpenFile file;
+
+	file.index = -1;
+	file.flags = flags;
+	if (!strcmp(path, "/dev/ipa")) {
+		file.type = NODE_IPA;
+	} else if (!strcmp(path, CONFIGURATION_NODE_PATH)) {
+		file.type = NODE_TEST;
+	} else if (!strcmp(path, INTERFACE_FROM_IPA_EXCEPTION_PATH)) {
+		file.type = NODE_EXCEPTION;
+	} else if ((file.index = ParseNodeIndex(path, "/dev/to_ipa_")) >= 0) {
+		file.type = NODE_TO_IPA;
+		if (!ProducerByIndex(file.index)) {
+			errno = ENOENT;
+			return -1;
+		}
+	} else if ((file.index = ParseNodeIndex(path, "/dev/from_ipa_")) >= 0) {
+		file.type = NODE_FROM_IPA;
+		if (!ConsumerByIndex(file.index)) {
+			errno = ENOENT;
+			return -1;
+		}
+	} else {
+		errno = ENOENT;
+		return -1;
+	}
+
+	m_files[m_nextFd] = file;
+	return m_nextFd++;
+}
+
+int IPASimulator::Close(int fd)
+{
+	if (!m_files.erase(fd)) {
+		errno = EBADF;
+		return -1;
+	}
+	return 0;
+}
+
+ssize_t IPASimulator::Read(int fd, void *buf, size_t count)
+{
+	map<int, OpenFile>::iterator file = m_files.find(fd);
+	deque< vector<uint8_t> > *queue;
+	Endpoint *cons = NULL;
+
+	if (file == m_files.end()) {
+		errno = EBADF;
+		return -1;
+	}
+
+	switch (file->second.type) {
+	case NODE_TEST:
+		return TestNodeRead(buf, count);
+	case NODE_FROM_IPA:
+		cons = ConsumerByIndex(file->second.index);
+		if (!cons) {
+			errno = ENODEV;
+			return -1;
+		}
+		queue = &cons->rxQueue;
+		break;
+	case NODE_EXCEPTION:
+		queue = &m_exceptionQueue;
+		break;
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* An open aggregation frame is closed by its time limit */
+	if (queue->empty() && cons && !cons->aggrPkts.empty() &&
+		AggrTimeLimitUsec(cons)) {
+		uint64_t deadline = cons->aggrOpenUsec + AggrTimeLimitUsec(cons);
+		uint64_t now = NowUsec();
+
+		if (deadline > now) {
+			if (file->second.flags & O_NONBLOCK) {
+				errno = EAGAIN;
+				return -1;
+			}
+			if (deadline - now <= IPA_SIM_READ_POLL_USEC) {
+				usleep(deadline - now);
+				now = deadline;
+			}
+		}
+		if (deadline <= now)
+			CloseAggregation(cons);
+	}
+
+	if (queue->empty()) {
+		if (file->second.flags & O_NONBLOCK) {
+			errno = EAGAIN;
+			return -1;
+		}
+		return 0;
+	}
+
+	/* like the test module, a test pipe hands out the whole transfer */
+	vector<uint8_t> &pkt = queue->front();
+	size_t len = (pkt.size() < count || cons) ? pkt.size() : count;
+
+	memcpy(buf, pkt.data(), len);
+	queue->pop_front();
+	return len;
+}
+
+ssize_t IPASimulator::Write(int fd, const void *buf, size_t count)
+{
+	map<int, OpenFile>::iterator file = m_files.find(fd);
+	Endpoint *prod;
+
+	if (file == m_files.end()) {
+		errno = EBADF;
+		return -1;
+	}
+
+	switch (file->second.type) {
+	case NODE_TEST:
+		return TestNodeWrite(buf, count);
+	case NODE_TO_IPA:
+		prod = ProducerByIndex(file->second.index);
+		if (!prod) {
+			errno = ENODEV;
+			return -1;
+		}
+		if (prod->cfg.aggr.aggr_en == IPA_ENABLE_DEAGGR)
+			Deaggregate(prod, (const uint8_t *)buf, count);
+		else
+			ProcessPacket(prod, (const uint8_t *)buf, count);
+		return count;
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+}
+
+int IPASimulator::Fcntl(int fd, int cmd, int arg)
+{
+	map<int, OpenFile>::iterator file = m_files.find(fd);
+
+	if (file == m_files.end()) {
+		errno = EBADF;
+		return -1;
+	}
+
+	switch (cmd) {
+	case F_GETFL:
+		return file->second.flags;
+	case F_SETFL:
+		file->second.flags = (file->second.flags & ~O_NONBLOCK) |
+			(arg & O_NONBLOCK);
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+int IPASimulator::Ioctl(int fd, unsigned long request, unsigned long arg)
+{
+	map<int, OpenFile>::iterator file = m_files.find(fd);
+	int ret;
+
+	if (file == m_files.end()) {
+		errno = EBADF;
+		return -1;
+	}
+
+	switch (file->second.type) {
+	case NODE_IPA:
+		ret = IpaIoctl(request, arg);
+		break;
+	case NODE_TEST:
+		ret = TestIoctl(request, arg);
+		break;
+	default:
+		ret = -ENOTTY;
+		break;
+	}
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+	return ret;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Test module configuration
+
+void IPASimulator::ClearConfiguration()
+{
+	m_producers.clear();
+	m_consumers.clear();
+	m_exceptionQueue.clear();
+	m_configuration = -1;
+}
+
+void IPASimulator::AddEndpoint(vector<Endpoint> &eps,
+	enum ipa_client_type client, int index,
+	const struct test_ipa_ep_cfg &cfg, bool enStatus)
+{
+	Endpoint ep;
+
+	ep.client = client;
+	ep.index = index;
+	ep.cfg = cfg;
+	ep.enStatus = enStatus;
+	ep.aggrBytes = 0;
+	ep.aggrOpenUsec = 0;
+	ep.aggrSeq = 0;
+	eps.push_back(ep);
+}
+
+void IPASimulator::ApplyGenericConfiguration(
+	const struct ipa_test_config_header *header)
+{
+	struct test_ipa_ep_cfg cfg;
+	const struct ipa_channel_config *channel;
+	size_t size;
+
+	ClearConfiguration();
+
+	for (int i = 0; i < header->to_ipa_channels_num; i++) {
+		channel = header->to_ipa_channel_config[i];
+		size = channel->config_size < sizeof(cfg) ?
+			channel->config_size : sizeof(cfg);
+		memset(&cfg, 0, sizeof(cfg));
+		memcpy(&cfg, channel->cfg, size);
+		AddEndpoint(m_producers, channel->client, channel->index, cfg,
+			channel->en_status);
+	}
+
+	for (int i = 0; i < header->from_ipa_channels_num; i++) {
+		channel = header->from_ipa_channel_config[i];
+		size = channel->config_size < sizeof(cfg) ?
+			channel->config_size : sizeof(cfg);
+		memset(&cfg, 0, sizeof(cfg));
+		memcpy(&cfg, channel->cfg, size);
+		AddEndpoint(m_consumers, channel->client, channel->index, cfg,
+			channel->en_status);
+	}
+
+	m_configuration = GENERIC_TEST_CONFIGURATION_IDX;
+}
+
+/*
+ * Legacy configurations are hard coded in the test module. Only the TLP
+ * aggregation one (8) is modeled:
+ *  to_ipa_0   TEST3_PROD DMA -> TEST_CONS
+ *  to_ipa_1   TEST_PROD  TLP de-aggregation, DMA -> TEST3_CONS
+ *  to_ipa_2   TEST2_PROD TLP de-aggregation, DMA -> TEST_CONS
+ *  to_ipa_3   TEST4_PROD DMA -> TEST2_CONS
+ *  from_ipa_0 TEST_CONS  TLP aggregation, 1KB
+ *  from_ipa_1 TEST3_CONS
+ *  from_ipa_2 TEST2_CONS TLP aggregation, 1KB, 30 msec
+ */
+bool IPASimulator::ApplyLegacyConfiguration(int configuration)
+{
+	struct test_ipa_ep_cfg cfg;
+
+	if (configuration != 8)
+		return false;
+
+	ClearConfiguration();
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.mode.mode = IPA_DMA;
+	cfg.mode.dst = IPA_CLIENT_TEST_CONS;
+	AddEndpoint(m_producers, IPA_CLIENT_TEST3_PROD, 0, cfg, false);
+
+	cfg.aggr.aggr_en = IPA_ENABLE_DEAGGR;
+	cfg.aggr.aggr = IPA_TLP;
+	cfg.mode.dst = IPA_CLIENT_TEST3_CONS;
+	AddEndpoint(m_producers, IPA_CLIENT_TEST_PROD, 1, cfg, false);
+
+	cfg.mode.dst = IPA_CLIENT_TEST_CONS;
+	AddEndpoint(m_producers, IPA_CLIENT_TEST2_PROD, 2, cfg, false);
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.mode.mode = IPA_DMA;
+	cfg.mode.dst = IPA_CLIENT_TEST2_CONS;
+	AddEndpoint(m_producers, IPA_CLIENT_TEST4_PROD, 3, cfg, false);
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.aggr.aggr_en = IPA_ENABLE_AGGR;
+	cfg.aggr.aggr = IPA_TLP;
+	cfg.aggr.aggr_byte_limit = 1;
+	AddEndpoint(m_consumers, IPA_CLIENT_TEST_CONS, 0, cfg, false);
+
+	memset(&cfg, 0, sizeof(cfg));
+	AddEndpoint(m_consumers, IPA_CLIENT_TEST3_CONS, 1, cfg, false);
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.aggr.aggr_en = IPA_ENABLE_AGGR;
+	cfg.aggr.aggr = IPA_TLP;
+	cfg.aggr.aggr_byte_limit = 1;
+	cfg.aggr.aggr_time_limit = 30;
+	if (m_hwType >= IPA_HW_v4_2)
+		cfg.aggr.aggr_time_limit *= 1000;
+	AddEndpoint(m_consumers, IPA_CLIENT_TEST2_CONS, 2, cfg, false);
+
+	m_configuration = configuration;
+	return true;
+}
+
+/*
+ * ConfigureSystem() writes the requested configuration number and polls
+ * the node until it reads back. The writer passes the size of its buffer
+ * pointer, so only parse what fits.
+ */
+ssize_t IPASimulator::TestNodeWrite(const void *buf, size_t count)
+{
+	char str[32];
+	size_t len = count < sizeof(str) - 1 ? count : sizeof(str) - 1;
+	int configuration;
+
+	memcpy(str, buf, len);
+	str[len] = '\0';
+	configuration = atoi(str);
+
+	if (configuration == -1) {
+		ClearConfiguration();
+		return count;
+	}
+
+	if (!ApplyLegacyConfiguration(configuration)) {
+		LOG_MSG_ERROR("configuration %d is not modeled", configuration);
+		errno = EINVAL;
+		return -1;
+	}
+
+	return count;
+}
+
+ssize_t IPASimulator::TestNodeRead(void *buf, size_t count)
+{
+	char str[32];
+	size_t len;
+
+	snprintf(str, sizeof(str), "%d", m_configuration);
+	len = strlen(str) + 1;
+	if (len > count)
+		len = count;
+	memcpy(buf, str, len);
+	return len;
+}
+
+int IPASimulator::TestIoctl(unsigned long request, unsigned long arg)
+{
+	switch (request) {
+	case IPA_TEST_IOC_GET_HW_TYPE:
+		return m_hwType;
+	case IPA_TEST_IOC_CONFIGURE:
+	case IPA_TEST_IOC_ULSO_CONFIGURE:
+		ApplyGenericConfiguration((struct ipa_test_config_header *)arg);
+		return 0;
+	case IPA_TEST_IOC_CLEAN:
+		ClearConfiguration();
+		return 0;
+	case IPA_TEST_IOC_EP_CTRL:
+	case IPA_TEST_IOC_HOLB_CONFIG:
+	case IPA_TEST_IOC_REG_SUSPEND_HNDL:
+		return 0;
+	case IPA_TEST_IOC_IS_TEST_PROD_FLT_IN_SRAM: {
+		map<FltKey, vector<FltRule> >::iterator tbl = m_fltTables.find(
+			FltKey(IPA_CLIENT_TEST_PROD, (int)arg));
+		size_t nhash = 0;
+
+		if (tbl != m_fltTables.end())
+			for (size_t i = 0; i < tbl->second.size(); i++)
+				nhash += !tbl->second[i].hashable;
+		return nhash * IPA_SIM_FLT_RULE_SIZE <=
+			IPA_SIM_FLT_NHASH_SRAM_SIZE;
+	}
+	case IPA_TEST_IOC_GET_MEM_PART: {
+		struct ipa_test_mem_partition *mem =
+			(struct ipa_test_mem_partition *)arg;
+
+		memset(mem, 0, sizeof(*mem));
+		mem->v4_flt_nhash_size = IPA_SIM_FLT_NHASH_SRAM_SIZE;
+		mem->v6_flt_nhash_size = IPA_SIM_FLT_NHASH_SRAM_SIZE;
+		mem->apps_hdr_size = IPA_SIM_APPS_HDR_SIZE;
+		return 0;
+	}
+	case IPA_TEST_IOC_ADD_HDR_HPC:
+		return AddHeaders((struct ipa_ioc_add_hdr *)arg);
+	case IPA_TEST_IOC_PKT_INIT_EX_SET_HDR_OFST: {
+		struct ipa_pkt_init_ex_hdr_ofst_set *ofst =
+			(struct ipa_pkt_init_ex_hdr_ofst_set *)arg;
+		struct ipa_ioc_get_hdr get;
+
+		memset(&get, 0, sizeof(get));
+		memcpy(get.name, ofst->name, sizeof(get.name));
+		return GetHeader(&get);
+	}
+	default:
+		return -ENOTTY;
+	}
+}
+
+int IPASimulator::IpaIoctl(unsigned long request, unsigned long arg)
+{
+	switch (request) {
+	case IPA_IOC_ADD_HDR:
+		return AddHeaders((struct ipa_ioc_add_hdr *)arg);
+	case IPA_IOC_DEL_HDR:
+		return DelHeaders((struct ipa_ioc_del_hdr *)arg);
+	case IPA_IOC_GET_HDR:
+		return GetHeader((struct ipa_ioc_get_hdr *)arg);
+	case IPA_IOC_COPY_HDR:
+		return CopyHeader((struct ipa_ioc_copy_hdr *)arg);
+	case IPA_IOC_RESET_HDR:
+		m_headers.clear();
+		m_procCtxs.clear();
+		ResetRt(IPA_IP_v4);
+		ResetRt(IPA_IP_v6);
+		return 0;
+	case IPA_IOC_ADD_HDR_PROC_CTX:
+		return AddProcCtxs((struct ipa_ioc_add_hdr_proc_ctx *)arg);
+	case IPA_IOC_DEL_HDR_PROC_CTX:
+		return DelProcCtxs((struct ipa_ioc_del_hdr_proc_ctx *)arg);
+	case IPA_IOC_ADD_RT_RULE: {
+		struct ipa_ioc_add_rt_rule *add = (struct ipa_ioc_add_rt_rule *)arg;
+
+		for (int i = 0; i < add->num_rules; i++)
+			add->rules[i].status = AddRtRule(add->ip, add->rt_tbl_name,
+				&add->rules[i].rule, false, add->rules[i].at_rear,
+				&add->rules[i].rt_rule_hdl) ? -1 : 0;
+		if (add->commit)
+			FlushCaches();
+		return 0;
+	}
+	case IPA_IOC_ADD_RT_RULE_V2: {
+		struct ipa_ioc_add_rt_rule_v2 *add =
+			(struct ipa_ioc_add_rt_rule_v2 *)arg;
+		uint8_t *rules = (uint8_t *)(uintptr_t)add->rules;
+
+		for (int i = 0; i < add->num_rules; i++) {
+			struct ipa_rt_rule_add_v2 *entry =
+				(struct ipa_rt_rule_add_v2 *)
+				(rules + i * add->rule_add_size);
+			struct ipa_rt_rule rule;
+
+			memset(&rule, 0, sizeof(rule));
+			rule.dst = entry->rule.dst;
+			rule.hdr_hdl = entry->rule.hdr_hdl;
+			rule.hdr_proc_ctx_hdl = entry->rule.hdr_proc_ctx_hdl;
+			rule.attrib = entry->rule.attrib;
+			rule.max_prio = entry->rule.max_prio;
+			rule.hashable = entry->rule.hashable;
+			rule.retain_hdr = entry->rule.retain_hdr;
+			rule.rule_id = entry->rule.rule_id;
+			entry->status = AddRtRule(add->ip, add->rt_tbl_name, &rule,
+				entry->rule.close_aggr_irq_mod, entry->at_rear,
+				&entry->rt_rule_hdl) ? -1 : 0;
+		}
+		if (add->commit)
+			FlushCaches();
+		return 0;
+	}
+	case IPA_IOC_DEL_RT_RULE: {
+		struct ipa_ioc_del_rt_rule *del = (struct ipa_ioc_del_rt_rule *)arg;
+		int ret = 0;
+
+		for (int i = 0; i < del->num_hdls; i++) {
+			del->hdl[i].status = DelRtRule(del->hdl[i].hdl) ? -1 : 0;
+			if (del->hdl[i].status)
+				ret = -EPERM;
+		}
+		if (del->commit)
+			FlushCaches();
+		return ret;
+	}
+	case IPA_IOC_RESET_RT:
+		return ResetRt((enum ipa_ip_type)arg);
+	case IPA_IOC_GET_RT_TBL:
+		return GetRtTable((struct ipa_ioc_get_rt_tbl *)arg);
+	case IPA_IOC_PUT_RT_TBL:
+		return PutRtTable((uint32_t)arg);
+	case IPA_IOC_ADD_FLT_RULE: {
+		struct ipa_ioc_add_flt_rule *add =
+			(struct ipa_ioc_add_flt_rule *)arg;
+
+		if (add->global)
+			return -EPERM;
+		for (int i = 0; i < add->num_rules; i++)
+			add->rules[i].status = AddFltRule(add->ep, add->ip,
+				&add->rules[i].rule, false,
+				add->rules[i].at_rear,
+				&add->rules[i].flt_rule_hdl) ? -1 : 0;
+		if (add->commit)
+			FlushCaches();
+		return 0;
+	}
+	case IPA_IOC_ADD_FLT_RULE_V2: {
+		struct ipa_ioc_add_flt_rule_v2 *add =
+			(struct ipa_ioc_add_flt_rule_v2 *)arg;
+		uint8_t *rules = (uint8_t *)(uintptr_t)add->rules;
+
+		if (add->global)
+			return -EPERM;
+		for (int i = 0; i < add->num_rules; i++) {
+			struct ipa_flt_rule_add_v2 *entry =
+				(struct ipa_flt_rule_add_v2 *)
+				(rules + i * add->flt_rule_size);
+			struct ipa_flt_rule rule;
+
+			memset(&rule, 0, sizeof(rule));
+			rule.retain_hdr = entry->rule.retain_hdr;
+			rule.action = entry->rule.action;
+			rule.rt_tbl_hdl = entry->rule.rt_tbl_hdl;
+			rule.attrib = entry->rule.attrib;
+			rule.eq_attrib_type = entry->rule.eq_attrib_type;
+			rule.max_prio = entry->rule.max_prio;
+			rule.hashable = entry->rule.hashable;
+			rule.rule_id = entry->rule.rule_id;
+			entry->status = AddFltRule(add->ep, add->ip, &rule,
+				entry->rule.close_aggr_irq_mod, entry->at_rear,
+				&entry->flt_rule_hdl) ? -1 : 0;
+		}
+		if (add->commit)
+			FlushCaches();
+		return 0;
+	}
+	case IPA_IOC_DEL_FLT_RULE: {
+		struct ipa_ioc_del_flt_rule *del =
+			(struct ipa_ioc_del_flt_rule *)arg;
+		int ret = 0;
+
+		for (int i = 0; i < del->num_hdls; i++) {
+			del->hdl[i].status = DelFltRule(del->hdl[i].hdl) ? -1 : 0;
+			if (del->hdl[i].status)
+				ret = -EPERM;
+		}
+		if (del->commit)
+			FlushCaches();
+		return ret;
+	}
+	case IPA_IOC_RESET_FLT:
+		return ResetFlt((enum ipa_ip_type)arg);
+	case IPA_IOC_COMMIT_HDR:
+	case IPA_IOC_COMMIT_RT:
+	case IPA_IOC_COMMIT_FLT:
+		FlushCaches();
+		return 0;
+	default:
+		return -ENOTTY;
+	}
+}
+
+int IPASimulator::AddHeaders(struct ipa_ioc_add_hdr *hdrs)
+{
+	for (int i = 0; i < hdrs->num_hdrs; i++) {
+		struct ipa_hdr_add *add = &hdrs->hdr[i];
+		Header hdr;
+
+		if (add->hdr_len > IPA_HDR_MAX_SIZE ||
+			!strnlen(add->name, IPA_RESOURCE_NAME_MAX)) {
+			add->status = -1;
+			continue;
+		}
+
+		hdr.name.assign(add->name,
+			strnlen(add->name, IPA_RESOURCE_NAME_MAX));
+		hdr.data.assign(add->hdr, add->hdr + add->hdr_len);
+		add->hdr_hdl = m_nextHdl++;
+		m_headers[add->hdr_hdl] = hdr;
+		add->status = 0;
+	}
+
+	return 0;
+}
+
+int IPASimulator::DelHeaders(struct ipa_ioc_del_hdr *hdls)
+{
+	int ret = 0;
+
+	for (int i = 0; i < hdls->num_hdls; i++) {
+		if (m_headers.erase(hdls->hdl[i].hdl)) {
+			hdls->hdl[i].status = 0;
+		} else {
+			hdls->hdl[i].status = -1;
+			ret = -EPERM;
+		}
+	}
+
+	return ret;
+}
+
+int IPASimulator::GetHeader(struct ipa_ioc_get_hdr *get)
+{
+	string name(get->name, strnlen(get->name, IPA_RESOURCE_NAME_MAX));
+
+	for (map<uint32_t, Header>::iterator it = m_headers.begin();
+		it != m_headers.end(); ++it) {
+		if (it->second.name == name) {
+			get->hdl = it->first;
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+int IPASimulator::CopyHeader(struct ipa_ioc_copy_hdr *copy)
+{
+	string name(copy->name, strnlen(copy->name, IPA_RESOURCE_NAME_MAX));
+
+	for (map<uint32_t, Header>::iterator it = m_headers.begin();
+		it != m_headers.end(); ++it) {
+		if (it->second.name == name) {
+			memcpy(copy->hdr, it->second.data.data(),
+				it->second.data.size());
+			copy->hdr_len = it->second.data.size();
+			copy->type = IPA_HDR_L2_NONE;
+			copy->is_partial = 0;
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+int IPASimulator::AddProcCtxs(struct ipa_ioc_add_hdr_proc_ctx *ctxs)
+{
+	for (int i = 0; i < ctxs->num_proc_ctxs; i++) {
+		struct ipa_hdr_proc_ctx_add *add = &ctxs->proc_ctx[i];
+		ProcCtx ctx;
+
+		if (add->type != IPA_HDR_PROC_NONE ||
+			(add->hdr_hdl && !m_headers.count(add->hdr_hdl))) {
+			add->status = -1;
+			continue;
+		}
+
+		ctx.type = add->type;
+		ctx.hdrHdl = add->hdr_hdl;
+		add->proc_ctx_hdl = m_nextHdl++;
+		m_procCtxs[add->proc_ctx_hdl] = ctx;
+		add->status = 0;
+	}
+
+	return 0;
+}
+
+int IPASimulator::DelProcCtxs(struct ipa_ioc_del_hdr_proc_ctx *hdls)
+{
+	int ret = 0;
+
+	for (int i = 0; i < hdls->num_hdls; i++) {
+		if (m_procCtxs.erase(hdls->hdl[i].hdl)) {
+			hdls->hdl[i].status = 0;
+		} else {
+			hdls->hdl[i].status = -1;
+			ret = -EPERM;
+		}
+	}
+
+	return ret;
+}
+
+int IPASimulator::AddRtRule(enum ipa_ip_type ip, const char *tblName,
+	const struct ipa_rt_rule *rule, bool closeAggr, bool atRear,
+	uint32_t *hdl)
+{
+	string name(tblName, strnlen(tblName, IPA_RESOURCE_NAME_MAX));
+	map<uint32_t, RtTable>::iterator tbl;
+	vector<RtRule>::iterator pos;
+	RtRule entry;
+
+	if ((rule->hdr_hdl && !m_headers.count(rule->hdr_hdl)) ||
+		(rule->hdr_proc_ctx_hdl &&
+		!m_procCtxs.count(rule->hdr_proc_ctx_hdl)) ||
+		rule->attrib.attrib_mask & ~(IPA_SIM_COMMON_ATTRIBS |
+		(ip == IPA_IP_v4 ? IPA_SIM_V4_ATTRIBS : IPA_SIM_V6_ATTRIBS)) ||
+		rule->attrib.ext_attrib_mask) {
+		LOG_MSG_ERROR("rule is not supported");
+		return -EINVAL;
+	}
+
+	for (tbl = m_rtTables.begin(); tbl != m_rtTables.end(); ++tbl)
+		if (tbl->second.ip == ip && tbl->second.name == name)
+			break;
+	if (tbl == m_rtTables.end()) {
+		RtTable newTbl;
+
+		newTbl.name = name;
+		newTbl.ip = ip;
+		newTbl.idx = AllocRtTblIdx(ip);
+		newTbl.refCount = 0;
+		tbl = m_rtTables.insert(make_pair(m_nextHdl++, newTbl)).first;
+	}
+
+	entry.hdl = m_nextHdl++;
+	entry.dst = rule->dst;
+	entry.hdrHdl = rule->hdr_hdl;
+	entry.procCtxHdl = rule->hdr_proc_ctx_hdl;
+	entry.attrib = rule->attrib;
+	entry.maxPrio = rule->max_prio;
+	entry.hashable = rule->hashable;
+	entry.retainHdr = rule->retain_hdr;
+	entry.ruleId = rule->rule_id ? rule->rule_id : entry.hdl & 0x3ff;
+	entry.closeAggr = closeAggr;
+
+	/* max_prio rules stay ahead of all the others */
+	vector<RtRule> &rules = tbl->second.rules;
+	pos = rules.begin();
+	while (pos != rules.end() && pos->maxPrio)
+		++pos;
+	if (atRear && !entry.maxPrio)
+		pos = rules.end();
+	rules.insert(pos, entry);
+
+	m_rtRuleTable[entry.hdl] = tbl->first;
+	*hdl = entry.hdl;
+	return 0;
+}
+
+int IPASimulator::DelRtRule(uint32_t hdl)
+{
+	map<uint32_t, uint32_t>::iterator it = m_rtRuleTable.find(hdl);
+
+	if (it == m_rtRuleTable.end())
+		return -EINVAL;
+
+	RtTable &tbl = m_rtTables[it->second];
+	for (size_t i = 0; i < tbl.rules.size(); i++) {
+		if (tbl.rules[i].hdl == hdl) {
+			tbl.rules.erase(tbl.rules.begin() + i);
+			break;
+		}
+	}
+
+	/* tables go away with their last rule once nobody holds them */
+	if (tbl.rules.empty() && !tbl.refCount)
+		m_rtTables.erase(it->second);
+	m_rtRuleTable.erase(it);
+	return 0;
+}
+
+int IPASimulator::ResetRt(enum ipa_ip_type ip)
+{
+	ResetFlt(ip);
+
+	for (map<uint32_t, RtTable>::iterator it = m_rtTables.begin();
+		it != m_rtTables.end();) {
+		if (it->second.ip != ip) {
+			++it;
+			continue;
+		}
+		for (size_t i = 0; i < it->second.rules.size(); i++)
+			m_rtRuleTable.erase(it->second.rules[i].hdl);
+		m_rtTables.erase(it++);
+	}
+
+	FlushCaches();
+	return 0;
+}
+
+int IPASimulator::GetRtTable(struct ipa_ioc_get_rt_tbl *get)
+{
+	string name(get->name, strnlen(get->name, IPA_RESOURCE_NAME_MAX));
+
+	for (map<uint32_t, RtTable>::iterator it = m_rtTables.begin();
+		it != m_rtTables.end(); ++it) {
+		if (it->second.ip == get->ip && it->second.name == name) {
+			it->second.refCount++;
+			get->hdl = it->first;
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+int IPASimulator::PutRtTable(uint32_t hdl)
+{
+	map<uint32_t, RtTable>::iterator it = m_rtTables.find(hdl);
+
+	if (it == m_rtTables.end() || !it->second.refCount)
+		return -EINVAL;
+
+	if (!--it->second.refCount && it->second.rules.empty())
+		m_rtTables.erase(it);
+	return 0;
+}
+
+/* Like the driver, a new table takes the lowest index free in its family */
+uint32_t IPASimulator::AllocRtTblIdx(enum ipa_ip_type ip)
+{
+	set<uint32_t> used;
+	uint32_t idx = 0;
+
+	for (map<uint32_t, RtTable>::iterator it = m_rtTables.begin();
+		it != m_rtTables.end(); ++it)
+		if (it->second.ip == ip)
+			used.insert(it->second.idx);
+	while (used.count(idx))
+		idx++;
+
+	return idx;
+}
+
+int IPASimulator::AddFltRule(enum ipa_client_type ep, enum ipa_ip_type ip,
+	const struct ipa_flt_rule *rule, bool closeAggr, bool atRear,
+	uint32_t *hdl)
+{
+	map<uint32_t, RtTable>::iterator tbl = m_rtTables.find(rule->rt_tbl_hdl);
+	vector<FltRule>::iterator pos;
+	FltRule entry;
+
+	if (rule->action != IPA_PASS_TO_EXCEPTION &&
+		(tbl == m_rtTables.end() || tbl->second.ip != ip)) {
+		LOG_MSG_ERROR("invalid routing table handle %u",
+			rule->rt_tbl_hdl);
+		return -EINVAL;
+	}
+
+	if (rule->eq_attrib_type ||
+		rule->attrib.attrib_mask & ~(IPA_SIM_COMMON_ATTRIBS |
+		(ip == IPA_IP_v4 ? IPA_SIM_V4_ATTRIBS : IPA_SIM_V6_ATTRIBS)) ||
+		rule->attrib.ext_attrib_mask) {
+		LOG_MSG_ERROR("rule is not supported");
+		return -EINVAL;
+	}
+
+	entry.hdl = m_nextHdl++;
+	entry.action = rule->action;
+	entry.rtTblHdl = rule->action == IPA_PASS_TO_EXCEPTION ?
+		0 : rule->rt_tbl_hdl;
+	entry.attrib = rule->attrib;
+	entry.maxPrio = rule->max_prio;
+	entry.hashable = rule->hashable;
+	entry.retainHdr = rule->retain_hdr;
+	entry.ruleId = rule->rule_id ? rule->rule_id : entry.hdl & 0x3ff;
+	entry.closeAggr = closeAggr;
+	if (entry.rtTblHdl)
+		tbl->second.refCount++;
+
+	vector<FltRule> &rules = m_fltTables[FltKey(ep, ip)];
+	pos = rules.begin();
+	while (pos != rules.end() && pos->maxPrio)
+		++pos;
+	if (atRear && !entry.maxPrio)
+		pos = rules.end();
+	rules.insert(pos, entry);
+
+	m_fltRuleTable[entry.hdl] = FltKey(ep, ip);
+	*hdl = entry.hdl;
+	return 0;
+}
+
+int IPASimulator::DelFltRule(uint32_t hdl)
+{
+	map<uint32_t, FltKey>::iterator it = m_fltRuleTable.find(hdl);
+
+	if (it == m_fltRuleTable.end())
+		return -EINVAL;
+
+	vector<FltRule> &rules = m_fltTables[it->second];
+	for (size_t i = 0; i < rules.size(); i++) {
+		if (rules[i].hdl == hdl) {
+			if (rules[i].rtTblHdl)
+				PutRtTable(rules[i].rtTblHdl);
+			rules.erase(rules.begin() + i);
+			break;
+		}
+	}
+
+	m_fltRuleTable.erase(it);
+	return 0;
+}
+
+int IPASimulator::ResetFlt(enum ipa_ip_type ip)
+{
+	for (map<FltKey, vector<FltRule> >::iterator it = m_fltTables.begin();
+		it != m_fltTables.end(); ++it) {
+		if (it->first.second != ip)
+			continue;
+		for (size_t i = 0; i < it->second.size(); i++) {
+			if (it->second[i].rtTblHdl)
+				PutRtTable(it->second[i].rtTblHdl);
+			m_fltRuleTable.erase(it->second[i].hdl);
+		}
+		it->second.clear();
+	}
+
+	FlushCaches();
+	return 0;
+}
+
+void IPASimulator::FlushCaches()
+{
+	m_fltCache.Clear();
+	m_rtCache.Clear();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Data path
+
+IPASimulator::Endpoint *IPASimulator::FindEndpoint(enum ipa_client_type client)
+{
+	for (size_t i = 0; i < m_consumers.size(); i++)
+		if (m_consumers[i].client == client)
+			return &m_consumers[i];
+	for (size_t i = 0; i < m_producers.size(); i++)
+		if (m_producers[i].client == client)
+			return &m_producers[i];
+	return NULL;
+}
+
+IPASimulator::Endpoint *IPASimulator::ProducerByIndex(int index)
+{
+	for (size_t i = 0; i < m_producers.size(); i++)
+		if (m_producers[i].index == index)
+			return &m_producers[i];
+	return NULL;
+}
+
+IPASimulator::Endpoint *IPASimulator::ConsumerByIndex(int index)
+{
+	for (size_t i = 0; i < m_consumers.size(); i++)
+		if (m_consumers[i].index == index)
+			return &m_consumers[i];
+	return NULL;
+}
+
+void IPASimulator::Deaggregate(Endpoint *prod, const uint8_t *buf, size_t len)
+{
+	const struct ipa_ep_cfg_deaggr &deaggr = prod->cfg.deaggr;
+	size_t pos = 0;
+
+	switch (prod->cfg.aggr.aggr) {
+	case IPA_TLP:
+		while (pos + 2 <= len) {
+			size_t pktLen = GetLe16(buf + pos);
+
+			if (!pktLen || pos + 2 + pktLen > len)
+				break;
+			ProcessPacket(prod, buf + pos + 2, pktLen);
+			pos += 2 + pktLen;
+		}
+		break;
+	case IPA_MBIM_16: {
+		size_t ndp;
+
+		if (len < MBIM_NTH16_SIZE ||
+			memcmp(buf, MBIM_NTH16_SIGNATURE, sizeof(MBIM_NTH16_SIGNATURE)))
+			break;
+		ndp = GetLe16(buf + 10);
+		while (ndp && ndp + MBIM_NDP16_HDR_SIZE <= len) {
+			size_t ndpLen = GetLe16(buf + ndp + 4);
+
+			for (size_t i = ndp + MBIM_NDP16_HDR_SIZE;
+				i + 4 <= ndp + ndpLen && i + 4 <= len; i += 4) {
+				size_t idx = GetLe16(buf + i);
+				size_t pktLen = GetLe16(buf + i + 2);
+
+				if (!idx || !pktLen || idx + pktLen > len)
+					break;
+				ProcessPacket(prod, buf + idx, pktLen);
+			}
+			ndp = GetLe16(buf + ndp + 6);
+		}
+		break;
+	}
+	case IPA_GENERIC: {
+		size_t totalOfst = prod->cfg.hdr_ext.hdr_total_len_or_pad_offset;
+
+		while (pos + totalOfst + 4 <= len) {
+			size_t total = GetLe32(buf + pos + totalOfst);
+			size_t start = pos + deaggr.deaggr_hdr_len;
+
+			if (!total || pos + total > len)
+				break;
+			if (deaggr.packet_offset_valid &&
+				pos + deaggr.packet_offset_location + 4 <= len)
+				start = pos + deaggr.packet_offset_location +
+					GetLe32(buf + pos + deaggr.packet_offset_location);
+			if (start < pos + total)
+				ProcessPacket(prod, buf + start, pos + total - start);
+			pos += total;
+		}
+		break;
+	}
+	default:
+		LOG_MSG_ERROR("de-aggregation type %d is not modeled",
+			prod->cfg.aggr.aggr);
+		break;
+	}
+}
+
+void IPASimulator::ProcessPacket(Endpoint *prod, const uint8_t *buf,
+	size_t len)
+{
+	const struct ipa_ep_cfg_hdr &hdr = prod->cfg.hdr;
+	IPASimVerdict verdict;
+	PacketView view;
+	Endpoint *cons;
+	uint32_t metadata = 0;
+	uint32_t ndpSignature;
+	size_t ofst;
+	vector<uint8_t> pkt;
+
+	memset(&verdict, 0, sizeof(verdict));
+
+	if (prod->cfg.mode.mode == IPA_DMA) {
+		cons = FindEndpoint(prod->cfg.mode.dst);
+		if (!cons)
+			return;
+		pkt.assign(buf, buf + len);
+		if (cons->enStatus)
+			AddStatus(prod, cons, verdict, 0, pkt);
+		Deliver(cons, pkt, 0, false);
+		return;
+	}
+
+	if (hdr.hdr_ofst_metadata_valid && hdr.hdr_ofst_metadata + 4 <= len) {
+		metadata = GetBe32(buf + hdr.hdr_ofst_metadata);
+		if (prod->cfg.metadata_mask.metadata_mask)
+			metadata &= prod->cfg.metadata_mask.metadata_mask;
+	}
+	if (!ParsePacket(buf, len, hdr.hdr_len, &view)) {
+		m_exceptionQueue.push_back(vector<uint8_t>(buf, buf + len));
+		return;
+	}
+
+	view.metadata = metadata;
+	if (!Lookup(prod->client, view, true, &verdict)) {
+		m_exceptionQueue.push_back(vector<uint8_t>(buf, buf + len));
+		return;
+	}
+
+	cons = FindEndpoint(verdict.dst);
+	if (!cons)
+		return;
+
+	/* header insertion, processing contexts only carry a header */
+	if (verdict.procCtxHdl && m_procCtxs.count(verdict.procCtxHdl))
+		verdict.hdrHdl = m_procCtxs[verdict.procCtxHdl].hdrHdl;
+	/* the consumer's HDR_LEN, not the header entry, sets how much goes in */
+	if (verdict.hdrHdl && m_headers.count(verdict.hdrHdl)) {
+		pkt = m_headers[verdict.hdrHdl].data;
+		pkt.resize(cons->cfg.hdr.hdr_len);
+	}
+
+	/* MBIM takes the NDP signature out of the header instead */
+	ndpSignature = 0;
+	if (cons->cfg.aggr.aggr_en == IPA_ENABLE_AGGR &&
+		cons->cfg.aggr.aggr == IPA_MBIM_16) {
+		memcpy(&ndpSignature, MBIM_DFLT_NDP16_SIGNATURE,
+			sizeof(ndpSignature));
+		if (pkt.size() == sizeof(ndpSignature))
+			memcpy(&ndpSignature, pkt.data(), sizeof(ndpSignature));
+		else if (pkt.size() == 1)
+			((uint8_t *)&ndpSignature)[3] = pkt[0];
+		pkt.clear();
+	}
+
+	ofst = verdict.retainHdr ? 0 : hdr.hdr_len;
+	FillConsumerHeader(cons, pkt.data(), pkt.size(), len - ofst);
+	pkt.insert(pkt.end(), buf + ofst, buf + len);
+	if (cons->enStatus)
+		AddStatus(prod, cons, verdict, metadata, pkt);
+	Deliver(cons, pkt, ndpSignature, verdict.closeAggr);
+}
+
+bool IPASimulator::ParsePacket(const uint8_t *buf, size_t len, size_t hdrLen,
+	PacketView *view)
+{
+	const uint8_t *ip;
+	size_t ipLen;
+	size_t ofst;
+
+	memset(view, 0, sizeof(*view));
+	if (len <= hdrLen)
+		return false;
+
+	view->l2 = buf;
+	view->l2Len = hdrLen;
+	ip = view->l3 = buf + hdrLen;
+	ipLen = view->l3Len = len - hdrLen;
+
+	switch (ip[0] >> 4) {
+	case 4:
+		ofst = (ip[0] & 0xF) * 4;
+		if (ipLen < 20 || ofst < 20 || ofst > ipLen)
+			return false;
+		view->ip = IPA_IP_v4;
+		view->tos = ip[1];
+		view->proto = ip[9];
+		view->srcAddr[0] = GetBe32(ip + 12);
+		view->dstAddr[0] = GetBe32(ip + 16);
+		view->fragment = (GetBe16(ip + 6) & 0x3FFF) != 0;
+		break;
+	case 6:
+		if (ipLen < 40)
+			return false;
+		view->ip = IPA_IP_v6;
+		view->tos = (GetBe16(ip) >> 4) & 0xFF;
+		view->flowLabel = GetBe32(ip) & 0xFFFFF;
+		for (int i = 0; i < 4; i++) {
+			view->srcAddr[i] = GetBe32(ip + 8 + 4 * i);
+			view->dstAddr[i] = GetBe32(ip + 24 + 4 * i);
+		}
+		/* hop by hop, routing, fragment and destination options */
+		view->proto = ip[6];
+		ofst = 40;
+		while (view->proto == 0 || view->proto == 43 ||
+			view->proto == 44 || view->proto == 60) {
+			if (ofst + 8 > ipLen)
+				return false;
+			if (view->proto == 44) {
+				/* an atomic fragment (offset 0, no MF) is whole */
+				view->fragment =
+					(GetBe16(ip + ofst + 2) & 0xFFF9) != 0;
+				view->proto = ip[ofst];
+				ofst += 8;
+			} else {
+				view->proto = ip[ofst];
+				ofst += (ip[ofst + 1] + 1) * 8;
+			}
+		}
+		if (ofst > ipLen)
+			return false;
+		break;
+	default:
+		return false;
+	}
+
+	view->l4 = ip + ofst;
+	view->l4Len = ipLen - ofst;
+	if ((view->proto == IPPROTO_TCP || view->proto == IPPROTO_UDP) &&
+		view->l4Len >= 4) {
+		view->srcPort = GetBe16(view->l4);
+		view->dstPort = GetBe16(view->l4 + 2);
+	}
+
+	return true;
+}
+
+/* A MAC address rule looks back from the IP header */
+static bool MatchMac(const uint8_t *l3, size_t l2Len, size_t back,
+	const uint8_t *addr, const uint8_t *mask)
+{
+	if (l2Len < back)
+		return false;
+	for (int i = 0; i < ETH_ALEN; i++)
+		if (((l3 - back)[i] & mask[i]) != (addr[i] & mask[i]))
+			return false;
+	return true;
+}
+
+bool IPASimulator::MatchAttrib(const struct ipa_rule_attrib &attrib,
+	const PacketView &view)
+{
+	uint32_t mask = attrib.attrib_mask;
+
+	if (view.ip == IPA_IP_v4) {
+		if ((mask & IPA_FLT_TOS) && view.tos != attrib.u.v4.tos)
+			return false;
+		if ((mask & IPA_FLT_PROTOCOL) && view.proto != attrib.u.v4.protocol)
+			return false;
+		if ((mask & IPA_FLT_SRC_ADDR) &&
+			(view.srcAddr[0] & attrib.u.v4.src_addr_mask) !=
+			(attrib.u.v4.src_addr & attrib.u.v4.src_addr_mask))
+			return false;
+		if ((mask & IPA_FLT_DST_ADDR) &&
+			(view.dstAddr[0] & attrib.u.v4.dst_addr_mask) !=
+			(attrib.u.v4.dst_addr & attrib.u.v4.dst_addr_mask))
+			return false;
+	} else {
+		if ((mask & IPA_FLT_TC) && view.tos != attrib.u.v6.tc)
+			return false;
+		if ((mask & IPA_FLT_FLOW_LABEL) &&
+			view.flowLabel != attrib.u.v6.flow_label)
+			return false;
+		if ((mask & IPA_FLT_NEXT_HDR) && view.proto != attrib.u.v6.next_hdr)
+			return false;
+		for (int i = 0; i < 4; i++) {
+			if ((mask & IPA_FLT_SRC_ADDR) &&
+				(view.srcAddr[i] & attrib.u.v6.src_addr_mask[i]) !=
+				(attrib.u.v6.src_addr[i] &
+				attrib.u.v6.src_addr_mask[i]))
+				return false;
+			if ((mask & IPA_FLT_DST_ADDR) &&
+				(view.dstAddr[i] & attrib.u.v6.dst_addr_mask[i]) !=
+				(attrib.u.v6.dst_addr[i] &
+				attrib.u.v6.dst_addr_mask[i]))
+				return false;
+		}
+	}
+
+	if ((mask & IPA_FLT_TOS_MASKED) &&
+		(view.tos & attrib.tos_mask) != attrib.tos_value)
+		return false;
+	if ((mask & IPA_FLT_SRC_PORT_RANGE) &&
+		(view.srcPort < attrib.src_port_lo ||
+		view.srcPort > attrib.src_port_hi))
+		return false;
+	if ((mask & IPA_FLT_DST_PORT_RANGE) &&
+		(view.dstPort < attrib.dst_port_lo ||
+		view.dstPort > attrib.dst_port_hi))
+		return false;
+	if ((mask & IPA_FLT_SRC_PORT) && view.srcPort != attrib.src_port)
+		return false;
+	if ((mask & IPA_FLT_DST_PORT) && view.dstPort != attrib.dst_port)
+		return false;
+	if ((mask & IPA_FLT_TYPE) &&
+		(view.l4Len < 1 || view.l4[0] != attrib.type))
+		return false;
+	if ((mask & IPA_FLT_CODE) &&
+		(view.l4Len < 2 || view.l4[1] != attrib.code))
+		return false;
+	if ((mask & IPA_FLT_SPI) &&
+		(view.l4Len < 4 || GetBe32(view.l4) != attrib.spi))
+		return false;
+	if ((mask & IPA_FLT_META_DATA) &&
+		(view.metadata & attrib.meta_data_mask) !=
+		(attrib.meta_data & attrib.meta_data_mask))
+		return false;
+	if ((mask & IPA_FLT_FRAGMENT) && !view.fragment)
+		return false;
+	if (mask & (IPA_FLT_TCP_SYN | IPA_FLT_IS_PURE_ACK)) {
+		size_t tcpHdrLen;
+
+		if (view.proto != IPPROTO_TCP || view.l4Len < 20)
+			return false;
+		tcpHdrLen = (view.l4[12] >> 4) * 4;
+		if ((mask & IPA_FLT_TCP_SYN) && !(view.l4[13] & 0x02))
+			return false;
+		if ((mask & IPA_FLT_IS_PURE_ACK) &&
+			(!(view.l4[13] & 0x10) || view.l4Len != tcpHdrLen))
+			return false;
+	}
+	if ((mask & IPA_FLT_MAC_ETHER_TYPE) &&
+		(view.l2Len < 2 || GetBe16(view.l3 - 2) != attrib.ether_type))
+		return false;
+	if ((mask & IPA_FLT_VLAN_ID) &&
+		(view.l2Len < 16 || GetBe16(view.l2 + 12) != 0x8100 ||
+		(GetBe16(view.l2 + 14) & 0xFFF) != attrib.vlan_id))
+		return false;
+	if ((mask & IPA_FLT_MAC_DST_ADDR_ETHER_II) &&
+		!MatchMac(view.l3, view.l2Len, 14, attrib.dst_mac_addr,
+		attrib.dst_mac_addr_mask))
+		return false;
+	if ((mask & IPA_FLT_MAC_SRC_ADDR_ETHER_II) &&
+		!MatchMac(view.l3, view.l2Len, 8, attrib.src_mac_addr,
+		attrib.src_mac_addr_mask))
+		return false;
+	if ((mask & IPA_FLT_MAC_DST_ADDR_802_3) &&
+		!MatchMac(view.l3, view.l2Len, 22, attrib.dst_mac_addr,
+		attrib.dst_mac_addr_mask))
+		return false;
+	if ((mask & IPA_FLT_MAC_SRC_ADDR_802_3) &&
+		!MatchMac(view.l3, view.l2Len, 16, attrib.src_mac_addr,
+		attrib.src_mac_addr_mask))
+		return false;
+	if ((mask & IPA_FLT_MAC_DST_ADDR_802_1Q) &&
+		!MatchMac(view.l3, view.l2Len, 18, attrib.dst_mac_addr,
+		attrib.dst_mac_addr_mask))
+		return false;
+	if ((mask & IPA_FLT_MAC_SRC_ADDR_802_1Q) &&
+		!MatchMac(view.l3, view.l2Len, 12, attrib.src_mac_addr,
+		attrib.src_mac_addr_mask))
+		return false;
+
+	return true;
+}
+
+/*
+ * The hash caches are keyed by the 5-tuple and the source pipe, the same
+ * fields the HW hashes on; routing also keys on the table.
+ */
+static string FlowKey(int src, const void *view, size_t len, uint32_t tbl)
+{
+	string key((const char *)&src, sizeof(src));
+
+	key.append((const char *)view, len);
+	key.append((const char *)&tbl, sizeof(tbl));
+	return key;
+}
+
+/* Returns whether key was cached, and makes it the most recent flow */
+bool IPASimulator::FlowCache::Lookup(const string &key)
+{
+	map<string, list<string>::iterator>::iterator flow = flows.find(key);
+
+	if (flow != flows.end()) {
+		lru.splice(lru.begin(), lru, flow->second);
+		return true;
+	}
+
+	if (flows.size() == IPA_SIM_CACHE_ENTRIES) {
+		flows.erase(lru.back());
+		lru.pop_back();
+	}
+	lru.push_front(key);
+	flows[key] = lru.begin();
+	return false;
+}
+
+void IPASimulator::FlowCache::Clear()
+{
+	lru.clear();
+	flows.clear();
+}
+
+bool IPASimulator::Lookup(enum ipa_client_type src, const PacketView &view,
+	bool useCache, IPASimVerdict *verdict)
+{
+	map<FltKey, vector<FltRule> >::iterator fltTbl;
+	map<uint32_t, RtTable>::iterator rtTbl;
+	const FltRule *flt = NULL;
+	const RtRule *rt = NULL;
+	string key;
+	struct {
+		uint8_t proto;
+		uint32_t srcAddr[4];
+		uint32_t dstAddr[4];
+		uint16_t srcPort;
+		uint16_t dstPort;
+	} tuple;
+
+	memset(verdict, 0, sizeof(*verdict));
+	verdict->exception = true;
+
+	memset(&tuple, 0, sizeof(tuple));
+	tuple.proto = view.proto;
+	memcpy(tuple.srcAddr, view.srcAddr, sizeof(tuple.srcAddr));
+	memcpy(tuple.dstAddr, view.dstAddr, sizeof(tuple.dstAddr));
+	tuple.srcPort = view.srcPort;
+	tuple.dstPort = view.dstPort;
+
+	fltTbl = m_fltTables.find(FltKey(src, view.ip));
+	if (fltTbl == m_fltTables.end())
+		return false;
+	for (size_t i = 0; i < fltTbl->second.size(); i++) {
+		if (MatchAttrib(fltTbl->second[i].attrib, view)) {
+			flt = &fltTbl->second[i];
+			break;
+		}
+	}
+	if (!flt)
+		return false;
+
+	verdict->fltMatch = true;
+	verdict->fltRuleId = flt->ruleId;
+	if (useCache && flt->hashable) {
+		key = FlowKey(src, &tuple, sizeof(tuple), 0);
+		verdict->fltHash = m_fltCache.Lookup(key);
+	}
+	if (flt->action == IPA_PASS_TO_EXCEPTION)
+		return false;
+
+	rtTbl = m_rtTables.find(flt->rtTblHdl);
+	if (rtTbl == m_rtTables.end())
+		return false;
+	for (size_t i = 0; i < rtTbl->second.rules.size(); i++) {
+		if (MatchAttrib(rtTbl->second.rules[i].attrib, view)) {
+			rt = &rtTbl->second.rules[i];
+			break;
+		}
+	}
+	if (!rt)
+		return false;
+
+	verdict->rtMatch = true;
+	verdict->rtRuleId = rt->ruleId;
+	verdict->rtTblHdl = rtTbl->first;
+	verdict->rtTblIdx = rtTbl->second.idx;
+	if (useCache && rt->hashable) {
+		key = FlowKey(src, &tuple, sizeof(tuple), rtTbl->first);
+		verdict->rtHash = m_rtCache.Lookup(key);
+	}
+
+	verdict->exception = false;
+	verdict->dst = rt->dst;
+	verdict->hdrHdl = rt->hdrHdl;
+	verdict->procCtxHdl = rt->procCtxHdl;
+	verdict->retainHdr = flt->retainHdr || rt->retainHdr;
+	verdict->closeAggr = flt->closeAggr || rt->closeAggr;
+	return true;
+}
+
+bool IPASimulator::Classify(enum ipa_client_type src, enum ipa_ip_type ip,
+	const uint8_t *pkt, size_t len, uint32_t metadata,
+	IPASimVerdict *verdict)
+{
+	PacketView view;
+
+	memset(verdict, 0, sizeof(*verdict));
+	verdict->exception = true;
+	if (!ParsePacket(pkt, len, 0, &view) || view.ip != ip)
+		return false;
+	view.metadata = metadata;
+
+	return Lookup(src, view, false, verdict);
+}
+
+void IPASimulator::FillConsumerHeader(const Endpoint *cons, uint8_t *hdr,
+	size_t hdrLen, size_t payloadLen)
+{
+	const struct ipa_ep_cfg_hdr &cfg = cons->cfg.hdr;
+	const struct ipa_ep_cfg_hdr_ext &ext = cons->cfg.hdr_ext;
+
+	if (cfg.hdr_ofst_pkt_size_valid && cfg.hdr_ofst_pkt_size + 2 <= hdrLen)
+		Put16(hdr + cfg.hdr_ofst_pkt_size,
+			payloadLen + cfg.hdr_additional_const_len,
+			ext.hdr_little_endian);
+
+	if (ext.hdr_total_len_or_pad_valid &&
+		ext.hdr_total_len_or_pad == IPA_HDR_TOTAL_LEN &&
+		ext.hdr_total_len_or_pad_offset + 2 <= hdrLen)
+		PutLe16(hdr + ext.hdr_total_len_or_pad_offset,
+			hdrLen + payloadLen);
+}
+
+void IPASimulator::AddStatus(const Endpoint *prod, const Endpoint *cons,
+	const IPASimVerdict &verdict, uint32_t metadata, vector<uint8_t> &pkt)
+{
+	uint8_t status[sizeof(struct ipa3_hw_pkt_status_hw_v5_0) >
+		sizeof(struct ipa3_hw_pkt_status) ?
+		sizeof(struct ipa3_hw_pkt_status_hw_v5_0) :
+		sizeof(struct ipa3_hw_pkt_status)];
+	size_t len;
+
+	memset(status, 0, sizeof(status));
+	if (m_hwType >= IPA_HW_v5_0) {
+		struct ipa3_hw_pkt_status_hw_v5_0 *s =
+			(struct ipa3_hw_pkt_status_hw_v5_0 *)status;
+
+		s->status_opcode = IPA_SIM_STATUS_OPCODE_PACKET;
+		s->pkt_len = pkt.size();
+		s->endp_src_idx = prod->index;
+		s->endp_dest_idx = cons->index;
+		s->metadata = metadata;
+		s->filt_hash = verdict.fltHash;
+		s->filt_rule_id = verdict.fltRuleId;
+		s->ret_hdr = verdict.retainHdr;
+		s->route_hash = verdict.rtHash;
+		s->route_tbl_idx = verdict.rtTblIdx;
+		s->route_rule_id = verdict.rtRuleId;
+		len = sizeof(*s);
+	} else {
+		struct ipa3_hw_pkt_status *s = (struct ipa3_hw_pkt_status *)status;
+
+		s->status_opcode = IPA_SIM_STATUS_OPCODE_PACKET;
+		s->pkt_len = pkt.size();
+		s->endp_src_idx = prod->index;
+		s->endp_dest_idx = cons->index;
+		s->metadata = metadata;
+		s->filt_hash = verdict.fltHash;
+		s->filt_rule_id = verdict.fltRuleId;
+		s->ret_hdr = verdict.retainHdr;
+		s->route_hash = verdict.rtHash;
+		s->route_tbl_idx = verdict.rtTblIdx;
+		s->route_rule_id = verdict.rtRuleId;
+		len = sizeof(*s);
+	}
+
+	pkt.insert(pkt.begin(), status, status + len);
+}
+
+void IPASimulator::Deliver(Endpoint *cons, vector<uint8_t> &pkt,
+	uint32_t ndpSignature, bool closeAggr)
+{
+	const struct ipa_ep_cfg_aggr &aggr = cons->cfg.aggr;
+	size_t limit = aggr.aggr_byte_limit * 1024;
+	size_t size;
+	AggrPkt entry;
+
+	if (aggr.aggr_en != IPA_ENABLE_AGGR) {
+		cons->rxQueue.push_back(pkt);
+		return;
+	}
+
+	switch (aggr.aggr) {
+	case IPA_TLP:
+		size = 2 + pkt.size();
+		break;
+	case IPA_MBIM_16:
+		/*
+		 * The byte limit counts the NTH16 and NDP16s as well. NDPs are
+		 * not interleaved, a new one opens each time the signature
+		 * differs from the previous datagram's.
+		 */
+		size = pkt.size() + 4;
+		if (cons->aggrPkts.empty())
+			size += MBIM_NTH16_SIZE;
+		if (cons->aggrPkts.empty() ||
+			cons->aggrPkts.back().ndpSignature != ndpSignature)
+			size += MBIM_NDP16_HDR_SIZE + 4;
+		break;
+	default:
+		size = pkt.size();
+		break;
+	}
+
+	/* the packet crossing the byte limit still goes into the frame */
+	if (cons->aggrPkts.empty())
+		cons->aggrOpenUsec = NowUsec();
+	entry.data.swap(pkt);
+	entry.ndpSignature = ndpSignature;
+	cons->aggrPkts.push_back(entry);
+	cons->aggrBytes += size;
+
+	if (closeAggr ||
+		(!limit && !aggr.aggr_time_limit && !aggr.aggr_pkt_limit) ||
+		(limit && cons->aggrBytes >= limit) ||
+		(aggr.aggr_pkt_limit &&
+		cons->aggrPkts.size() >= aggr.aggr_pkt_limit))
+		CloseAggregation(cons);
+}
+
+void IPASimulator::CloseAggregation(Endpoint *cons)
+{
+	vector<AggrPkt> &pkts = cons->aggrPkts;
+	vector<uint8_t> frame;
+
+	if (pkts.empty())
+		return;
+
+	switch (cons->cfg.aggr.aggr) {
+	case IPA_TLP:
+		for (size_t i = 0; i < pkts.size(); i++) {
+			size_t pos = frame.size();
+
+			frame.resize(pos + 2);
+			PutLe16(&frame[pos], pkts[i].data.size());
+			frame.insert(frame.end(), pkts[i].data.begin(),
+				pkts[i].data.end());
+		}
+		break;
+	case IPA_MBIM_16: {
+		vector<size_t> ofst(pkts.size());
+		size_t ndp;
+
+		/*
+		 * NTH16, the datagrams back to back and a 4 byte aligned
+		 * NDP16 per run of a signature
+		 */
+		frame.resize(MBIM_NTH16_SIZE);
+		for (size_t i = 0; i < pkts.size(); i++) {
+			ofst[i] = frame.size();
+			frame.insert(frame.end(), pkts[i].data.begin(),
+				pkts[i].data.end());
+		}
+
+		frame.resize(Align4(frame.size()));
+		ndp = frame.size();
+		memcpy(&frame[0], MBIM_NTH16_SIGNATURE,
+			sizeof(MBIM_NTH16_SIGNATURE));
+		PutLe16(&frame[4], MBIM_NTH16_SIZE);
+		PutLe16(&frame[6], cons->aggrSeq++);
+		PutLe16(&frame[10], ndp);
+
+		for (size_t first = 0, last; first < pkts.size(); first = last) {
+			size_t pos;
+
+			last = first + 1;
+			while (last < pkts.size() &&
+				pkts[last].ndpSignature == pkts[first].ndpSignature)
+				last++;
+
+			pos = frame.size();
+			frame.resize(pos + MBIM_NDP16_HDR_SIZE +
+				4 * (last - first + 1));
+			memcpy(&frame[pos], &pkts[first].ndpSignature,
+				sizeof(pkts[first].ndpSignature));
+			PutLe16(&frame[pos + 4], MBIM_NDP16_HDR_SIZE +
+				4 * (last - first + 1));
+			if (last < pkts.size())
+				PutLe16(&frame[pos + 6], frame.size());
+
+			pos += MBIM_NDP16_HDR_SIZE;
+			for (size_t i = first; i < last; i++) {
+				PutLe16(&frame[pos], ofst[i]);
+				PutLe16(&frame[pos + 2], pkts[i].data.size());
+				pos += 4;
+			}
+		}
+		PutLe16(&frame[8], frame.size());
+		break;
+	}
+	default:
+		for (size_t i = 0; i < pkts.size(); i++)
+			frame.insert(frame.end(), pkts[i].data.begin(),
+				pkts[i].data.end());
+		break;
+	}
+	cons->rxQueue.push_back(frame);
+	pkts.clear();
+	cons->aggrBytes = 0;
+}
+
+uint64_t IPASimulator::AggrTimeLimitUsec(const Endpoint *cons)
+{
+	uint64_t limit = cons->cfg.aggr.aggr_time_limit;
+
+	/* usec granularity from IPA v4.2, msec before */
+	return m_hwType >= IPA_HW_v4_2 ? limit : limit * 1000;
+}
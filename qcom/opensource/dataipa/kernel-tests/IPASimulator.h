@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef IPA_SIMULATOR_H_
+#define IPA_SIMULATOR_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "linux/msm_ipa.h"
+
+#include "TestsUtils.h"
+
+using namespace std;
+
+/*
+ * Software model of the IPA data path used by the kernel tests when they
+ * run on a build host.
+ * It serves the IPA driver node (/dev/ipa), the test module configuration
+ * node (/dev/ipa_test) and the test module pipes, keeps the header,
+ * routing and filtering tables the tests install through the driver
+ * ioctls (same uapi structures), and runs every packet written to a
+ * producer pipe through:
+ *   de-aggregation -> header removal -> filtering -> routing ->
+ *   header insertion -> status -> aggregation
+ * into the consumer pipe the test reads from.
+ * NAT/IPv6CT, processing contexts other than IPA_HDR_PROC_NONE and the
+ * legacy test configurations other than 8 are not modeled.
+ */
+
+/* Result of the filtering and routing lookup of one packet */
+struct IPASimVerdict {
+	bool fltMatch;
+	bool fltHash;
+	uint16_t fltRuleId;
+	bool exception;
+	bool rtMatch;
+	bool rtHash;
+	uint16_t rtRuleId;
+	uint32_t rtTblHdl;
+	uint32_t rtTblIdx;
+	enum ipa_client_type dst;
+	uint32_t hdrHdl;
+	uint32_t procCtxHdl;
+	bool retainHdr;
+	bool closeAggr;
+};
+
+class IPASimulator /* Singleton */
+{
+public:
+	static IPASimulator *GetInstance();
+	static bool IsSimulatedPath(const char *path);
+	static bool IsSimulatedFd(int fd);
+
+	int Open(const char *path, int flags);
+	int Close(int fd);
+	ssize_t Read(int fd, void *buf, size_t count);
+	ssize_t Write(int fd, const void *buf, size_t count);
+	int Fcntl(int fd, int cmd, int arg);
+	int Ioctl(int fd, unsigned long request, unsigned long arg);
+
+	/*
+	 * Run the filtering and routing lookup of an IP packet entering on
+	 * the src producer, without forwarding it. Used by the rule table
+	 * benchmark. The flow caches are not updated.
+	 */
+	bool Classify(enum ipa_client_type src, enum ipa_ip_type ip,
+		const uint8_t *pkt, size_t len, uint32_t metadata,
+		IPASimVerdict *verdict);
+
+	enum ipa_hw_type GetHwType() {return m_hwType;}
+
+private:
+	enum NodeType {
+		NODE_IPA,
+		NODE_TEST,
+		NODE_TO_IPA,
+		NODE_FROM_IPA,
+		NODE_EXCEPTION
+	};
+
+	struct OpenFile {
+		NodeType type;
+		int index;
+		int flags;
+	};
+
+	/* A packet queued for aggregation on a consumer */
+	struct AggrPkt {
+		vector<uint8_t> data;
+		uint32_t ndpSignature;
+	};
+
+	struct Endpoint {
+		enum ipa_client_type client;
+		int index;
+		struct test_ipa_ep_cfg cfg;
+		bool enStatus;
+		deque< vector<uint8_t> > rxQueue;
+		vector<AggrPkt> aggrPkts;
+		size_t aggrBytes;
+		uint64_t aggrOpenUsec;
+		uint16_t aggrSeq;
+	};
+
+	struct Header {
+		string name;
+		vector<uint8_t> data;
+	};
+
+	struct ProcCtx {
+		enum ipa_hdr_proc_type type;
+		uint32_t hdrHdl;
+	};
+
+	struct RtRule {
+		uint32_t hdl;
+		enum ipa_client_type dst;
+		uint32_t hdrHdl;
+		uint32_t procCtxHdl;
+		struct ipa_rule_attrib attrib;
+		bool maxPrio;
+		bool hashable;
+		bool retainHdr;
+		uint16_t ruleId;
+		bool closeAggr;
+	};
+
+	struct RtTable {
+		string name;
+		enum ipa_ip_type ip;
+		uint32_t idx;
+		uint32_t refCount;
+		vector<RtRule> rules;
+	};
+
+	struct FltRule {
+		uint32_t hdl;
+		enum ipa_flt_action action;
+		uint32_t rtTblHdl;
+		struct ipa_rule_attrib attrib;
+		bool maxPrio;
+		bool hashable;
+		bool retainHdr;
+		uint16_t ruleId;
+		bool closeAggr;
+	};
+
+	/*
+	 * Flow hash cache, IPA_SIM_CACHE_ENTRIES flows with the least
+	 * recently used one reclaimed first, like the HW cache.
+	 */
+	struct FlowCache {
+		list<string> lru;
+		map<string, list<string>::iterator> flows;
+
+		bool Lookup(const string &key);
+		void Clear();
+	};
+
+	/* Filtering tables are per producer and IP family */
+	typedef pair<int, int> FltKey;
+
+	/* Parsed view of the packet the rules are evaluated on */
+	struct PacketView {
+		const uint8_t *l2;
+		size_t l2Len;
+		const uint8_t *l3;
+		size_t l3Len;
+		enum ipa_ip_type ip;
+		uint8_t tos;
+		uint32_t flowLabel;
+		uint8_t proto;
+		uint32_t srcAddr[4];
+		uint32_t dstAddr[4];
+		bool fragment;
+		const uint8_t *l4;
+		size_t l4Len;
+		uint16_t srcPort;
+		uint16_t dstPort;
+		uint32_t metadata;
+	};
+
+	IPASimulator();
+	IPASimulator(const IPASimulator &);
+	IPASimulator &operator=(const IPASimulator &);
+
+	/* Configuration (test module) */
+	void ClearConfiguration();
+	void AddEndpoint(vector<Endpoint> &eps, enum ipa_client_type client,
+		int index, const struct test_ipa_ep_cfg &cfg, bool enStatus);
+	void ApplyGenericConfiguration(const struct ipa_test_config_header *header);
+	bool ApplyLegacyConfiguration(int configuration);
+	ssize_t TestNodeWrite(const void *buf, size_t count);
+	ssize_t TestNodeRead(void *buf, size_t count);
+	int TestIoctl(unsigned long request, unsigned long arg);
+
+	/* Driver ioctls */
+	int IpaIoctl(unsigned long request, unsigned long arg);
+	int AddHeaders(struct ipa_ioc_add_hdr *hdrs);
+	int DelHeaders(struct ipa_ioc_del_hdr *hdls);
+	int GetHeader(struct ipa_ioc_get_hdr *get);
+	int CopyHeader(struct ipa_ioc_copy_hdr *copy);
+	int AddProcCtxs(struct ipa_ioc_add_hdr_proc_ctx *ctxs);
+	int DelProcCtxs(struct ipa_ioc_del_hdr_proc_ctx *hdls);
+	int AddRtRule(enum ipa_ip_type ip, const char *tblName,
+		const struct ipa_rt_rule *rule, bool closeAggr, bool atRear,
+		uint32_t *hdl);
+	int DelRtRule(uint32_t hdl);
+	int ResetRt(enum ipa_ip_type ip);
+	int GetRtTable(struct ipa_ioc_get_rt_tbl *get);
+	int PutRtTable(uint32_t hdl);
+	uint32_t AllocRtTblIdx(enum ipa_ip_type ip);
+	int AddFltRule(enum ipa_client_type ep, enum ipa_ip_type ip,
+		const struct ipa_flt_rule *rule, bool closeAggr, bool atRear,
+		uint32_t *hdl);
+	int DelFltRule(uint32_t hdl);
+	int ResetFlt(enum ipa_ip_type ip);
+	void FlushCaches();
+
+	/* Data path */
+	Endpoint *FindEndpoint(enum ipa_client_type client);
+	Endpoint *ProducerByIndex(int index);
+	Endpoint *ConsumerByIndex(int index);
+	void Deaggregate(Endpoint *prod, const uint8_t *buf, size_t len);
+	void ProcessPacket(Endpoint *prod, const uint8_t *buf, size_t len);
+	bool ParsePacket(const uint8_t *buf, size_t len, size_t hdrLen,
+		PacketView *view);
+	bool MatchAttrib(const struct ipa_rule_attrib &attrib,
+		const PacketView &view);
+	bool Lookup(enum ipa_client_type src, const PacketView &view,
+		bool useCache, IPASimVerdict *verdict);
+	void FillConsumerHeader(const Endpoint *cons, uint8_t *hdr,
+		size_t hdrLen, size_t payloadLen);
+	void AddStatus(const Endpoint *prod, const Endpoint *cons,
+		const IPASimVerdict &verdict, uint32_t metadata,
+		vector<uint8_t> &pkt);
+	void Deliver(Endpoint *cons, vector<uint8_t> &pkt,
+		uint32_t ndpSignature, bool closeAggr);
+	void CloseAggregation(Endpoint *cons);
+	uint64_t AggrTimeLimitUsec(const Endpoint *cons);
+
+	enum ipa_hw_type m_hwType;
+	int m_nextFd;
+	map<int, OpenFile> m_files;
+
+	int m_configuration;
+	vector<Endpoint> m_producers;
+	vector<Endpoint> m_consumers;
+	deque< vector<uint8_t> > m_exceptionQueue;
+
+	uint32_t m_nextHdl;
+	map<uint32_t, Header> m_headers;
+	map<uint32_t, ProcCtx> m_procCtxs;
+	map<uint32_t, RtTable> m_rtTables;
+	map<uint32_t, uint32_t> m_rtRuleTable;
+	map<FltKey, vector<FltRule> > m_fltTables;
+	map<uint32_t, FltKey> m_fltRuleTable;
+	FlowCache m_fltCache;
+	FlowCache m_rtCache;
+};
+
+#endif
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "Constants.h"
+#include "Logger.h"
+#include "TestsUtils.h"
+#include "linux/msm_ipa.h"
+#include "RoutingDriverWrapper.h"
+#include "Filtering.h"
+#include "IPASimulator.h"
+
+/*
+ * Rule table evaluation benchmark, runs on the IPA simulator only.
+ * Installs a filtering table on the test producer and a routing table
+ * of the same size through the driver ioctls, then times the lookup of
+ * a packet that only matches the last rule of both tables, which is the
+ * worst case of the in order evaluation.
+ */
+
+#define IPA_SIM_BENCH_TBL_NAME "sim_bench"
+/* num_rules of the add ioctls is 8 bits wide */
+#define IPA_SIM_BENCH_BATCH 200
+/* lookups are scaled so every size evaluates about as many rules */
+#define IPA_SIM_BENCH_RULE_EVALS (16 * 1024 * 1024)
+#define IPA_SIM_BENCH_MIN_LOOKUPS 1000
+
+#define IPA_SIM_BENCH_V4_DST_ADDR 0x0A000000
+#define IPA_SIM_BENCH_V6_DST_ADDR 0xFD000000
+#define IPV4_DST_ADDR_OFFSET (16)
+#define IPV6_DST_ADDR_OFFSET (24)
+
+extern Logger g_Logger;
+
+static uint64_t BenchNowNsec()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+class IpaSimulatorRuleTableBench : public TestBase
+{
+public:
+	IpaSimulatorRuleTableBench(const char *name, enum ipa_ip_type ip,
+		unsigned int numRules) :
+		m_ip(ip),
+		m_numRules(numRules)
+	{
+		char description[128];
+
+		snprintf(description, sizeof(description),
+			"Evaluate %u %s filtering and routing rules on the simulator",
+			numRules, ip == IPA_IP_v4 ? "IPv4" : "IPv6");
+		m_name = name;
+		m_description = description;
+		m_testSuiteName.push_back("Simulator");
+		m_runInRegression = false;
+		Register(*this);
+	}
+
+	bool Setup()
+	{
+		struct ipa_channel_config from_ipa_channels[1];
+		struct test_ipa_ep_cfg from_ipa_cfg[1];
+		struct ipa_channel_config to_ipa_channels[1];
+		struct test_ipa_ep_cfg to_ipa_cfg[1];
+		struct ipa_test_config_header header = {0};
+		struct ipa_channel_config *to_ipa_array[1];
+		struct ipa_channel_config *from_ipa_array[1];
+
+		memset(&from_ipa_cfg[0], 0, sizeof(from_ipa_cfg[0]));
+		prepare_channel_struct(&from_ipa_channels[0],
+				header.from_ipa_channels_num++,
+				IPA_CLIENT_TEST2_CONS,
+				(void *)&from_ipa_cfg[0],
+				sizeof(from_ipa_cfg[0]));
+		from_ipa_array[0] = &from_ipa_channels[0];
+
+		memset(&to_ipa_cfg[0], 0, sizeof(to_ipa_cfg[0]));
+		prepare_channel_struct(&to_ipa_channels[0],
+				header.to_ipa_channels_num++,
+				IPA_CLIENT_TEST_PROD,
+				(void *)&to_ipa_cfg[0],
+				sizeof(to_ipa_cfg[0]));
+		to_ipa_array[0] = &to_ipa_channels[0];
+
+		prepare_header_struct(&header, from_ipa_array, to_ipa_array);
+
+		if (!GenericConfigureScenario(&header)) {
+			LOG_MSG_ERROR("Failed configuring the simulator");
+			return false;
+		}
+
+		if (!m_routing.DeviceNodeIsOpened() ||
+			!m_filtering.DeviceNodeIsOpened()) {
+			LOG_MSG_ERROR("IPA device node is not opened");
+			return false;
+		}
+
+		return m_routing.Reset(m_ip) && m_filtering.Reset(m_ip);
+	}
+
+	bool Teardown()
+	{
+		return m_routing.Reset(m_ip) && m_filtering.Reset(m_ip);
+	}
+
+	void FillAttrib(unsigned int rule, struct ipa_rule_attrib *attrib)
+	{
+		attrib->attrib_mask = IPA_FLT_DST_ADDR;
+		if (m_ip == IPA_IP_v4) {
+			attrib->u.v4.dst_addr = IPA_SIM_BENCH_V4_DST_ADDR | rule;
+			attrib->u.v4.dst_addr_mask = 0xFFFFFFFF;
+		} else {
+			attrib->u.v6.dst_addr[0] = IPA_SIM_BENCH_V6_DST_ADDR;
+			attrib->u.v6.dst_addr[3] = rule;
+			memset(attrib->u.v6.dst_addr_mask, 0xFF,
+				sizeof(attrib->u.v6.dst_addr_mask));
+		}
+	}
+
+	bool InstallRoutingTable(uint64_t *nsec)
+	{
+		struct ipa_ioc_add_rt_rule *rt;
+		bool ret = true;
+
+		rt = (struct ipa_ioc_add_rt_rule *)calloc(1, sizeof(*rt) +
+			IPA_SIM_BENCH_BATCH * sizeof(struct ipa_rt_rule_add));
+		if (!rt) {
+			LOG_MSG_ERROR("Memory allocation error");
+			return false;
+		}
+
+		*nsec = 0;
+		for (unsigned int rule = 0; ret && rule < m_numRules;
+			rule += IPA_SIM_BENCH_BATCH) {
+			unsigned int batch = m_numRules - rule;
+			uint64_t start;
+
+			if (batch > IPA_SIM_BENCH_BATCH)
+				batch = IPA_SIM_BENCH_BATCH;
+			memset(rt, 0, sizeof(*rt) +
+				batch * sizeof(struct ipa_rt_rule_add));
+			rt->commit = (rule + batch == m_numRules);
+			rt->ip = m_ip;
+			rt->num_rules = batch;
+			strlcpy(rt->rt_tbl_name, IPA_SIM_BENCH_TBL_NAME,
+				sizeof(rt->rt_tbl_name));
+			for (unsigned int i = 0; i < batch; i++) {
+				rt->rules[i].at_rear = 1;
+				rt->rules[i].rule.dst = IPA_CLIENT_TEST2_CONS;
+				FillAttrib(rule + i, &rt->rules[i].rule.attrib);
+			}
+
+			start = BenchNowNsec();
+			ret = m_routing.AddRoutingRule(rt);
+			*nsec += BenchNowNsec() - start;
+			for (unsigned int i = 0; ret && i < batch; i++)
+				ret = !rt->rules[i].status;
+		}
+
+		free(rt);
+		return ret;
+	}
+
+	bool InstallFilteringTable(uint32_t rtTblHdl, uint64_t *nsec)
+	{
+		struct ipa_ioc_add_flt_rule *flt;
+		bool ret = true;
+
+		flt = (struct ipa_ioc_add_flt_rule *)calloc(1, sizeof(*flt) +
+			IPA_SIM_BENCH_BATCH * sizeof(struct ipa_flt_rule_add));
+		if (!flt) {
+			LOG_MSG_ERROR("Memory allocation error");
+			return false;
+		}
+
+		*nsec = 0;
+		for (unsigned int rule = 0; ret && rule < m_numRules;
+			rule += IPA_SIM_BENCH_BATCH) {
+			unsigned int batch = m_numRules - rule;
+			uint64_t start;
+
+			if (batch > IPA_SIM_BENCH_BATCH)
+				batch = IPA_SIM_BENCH_BATCH;
+			memset(flt, 0, sizeof(*flt) +
+				batch * sizeof(struct ipa_flt_rule_add));
+			flt->commit = (rule + batch == m_numRules);
+			flt->ip = m_ip;
+			flt->ep = IPA_CLIENT_TEST_PROD;
+			flt->num_rules = batch;
+			for (unsigned int i = 0; i < batch; i++) {
+				flt->rules[i].at_rear = 1;
+				flt->rules[i].rule.action = IPA_PASS_TO_ROUTING;
+				flt->rules[i].rule.rt_tbl_hdl = rtTblHdl;
+				FillAttrib(rule + i, &flt->rules[i].rule.attrib);
+			}
+
+			start = BenchNowNsec();
+			ret = m_filtering.AddFilteringRule(flt);
+			*nsec += BenchNowNsec() - start;
+			for (unsigned int i = 0; ret && i < batch; i++)
+				ret = !flt->rules[i].status;
+		}
+
+		free(flt);
+		return ret;
+	}
+
+	bool Run()
+	{
+		IPASimulator *sim = IPASimulator::GetInstance();
+		struct ipa_ioc_get_rt_tbl rtTbl;
+		IPASimVerdict verdict;
+		uint8_t pkt[BUFF_MAX_SIZE];
+		size_t pktSize = sizeof(pkt);
+		unsigned int lookups;
+		uint64_t rtNsec, fltNsec, nsec, start;
+		uint32_t last = m_numRules - 1;
+		bool ret;
+
+		if (!InstallRoutingTable(&rtNsec)) {
+			LOG_MSG_ERROR("Failed installing the routing table");
+			return false;
+		}
+
+		memset(&rtTbl, 0, sizeof(rtTbl));
+		rtTbl.ip = m_ip;
+		strlcpy(rtTbl.name, IPA_SIM_BENCH_TBL_NAME, sizeof(rtTbl.name));
+		if (!m_routing.GetRoutingTable(&rtTbl)) {
+			LOG_MSG_ERROR("Failed getting the routing table");
+			return false;
+		}
+
+		ret = InstallFilteringTable(rtTbl.hdl, &fltNsec);
+		m_routing.PutRoutingTable(rtTbl.hdl);
+		if (!ret) {
+			LOG_MSG_ERROR("Failed installing the filtering table");
+			return false;
+		}
+
+		/* only the last rule of each table matches */
+		if (!LoadDefaultPacket(m_ip, pkt, pktSize)) {
+			LOG_MSG_ERROR("Failed loading default packet");
+			return false;
+		}
+		if (m_ip == IPA_IP_v4) {
+			pkt[IPV4_DST_ADDR_OFFSET] = IPA_SIM_BENCH_V4_DST_ADDR >> 24;
+			pkt[IPV4_DST_ADDR_OFFSET + 1] = last >> 16;
+			pkt[IPV4_DST_ADDR_OFFSET + 2] = last >> 8;
+			pkt[IPV4_DST_ADDR_OFFSET + 3] = last;
+		} else {
+			memset(&pkt[IPV6_DST_ADDR_OFFSET], 0, 16);
+			pkt[IPV6_DST_ADDR_OFFSET] = IPA_SIM_BENCH_V6_DST_ADDR >> 24;
+			pkt[IPV6_DST_ADDR_OFFSET + 12] = last >> 24;
+			pkt[IPV6_DST_ADDR_OFFSET + 13] = last >> 16;
+			pkt[IPV6_DST_ADDR_OFFSET + 14] = last >> 8;
+			pkt[IPV6_DST_ADDR_OFFSET + 15] = last;
+		}
+
+		if (!sim->Classify(IPA_CLIENT_TEST_PROD, m_ip, pkt, pktSize, 0,
+			&verdict) || verdict.dst != IPA_CLIENT_TEST2_CONS) {
+			LOG_MSG_ERROR("Packet did not match the last rules");
+			return false;
+		}
+
+		lookups = IPA_SIM_BENCH_RULE_EVALS / m_numRules;
+		if (lookups < IPA_SIM_BENCH_MIN_LOOKUPS)
+			lookups = IPA_SIM_BENCH_MIN_LOOKUPS;
+
+		start = BenchNowNsec();
+		for (unsigned int i = 0; i < lookups; i++)
+			sim->Classify(IPA_CLIENT_TEST_PROD, m_ip, pkt, pktSize, 0,
+				&verdict);
+		nsec = BenchNowNsec() - start;
+		if (!nsec)
+			nsec = 1;
+
+		printf("%s: %u rules\n", m_name.c_str(), m_numRules);
+		printf("install: routing %llu usec, filtering %llu usec\n",
+			(unsigned long long)rtNsec / 1000,
+			(unsigned long long)fltNsec / 1000);
+		printf("lookup: %u packets, %llu nsec/packet, %llu packets/sec\n",
+			lookups, (unsigned long long)nsec / lookups,
+			(unsigned long long)lookups * 1000000000 / nsec);
+
+		return true;
+	}
+
+private:
+	static const size_t BUFF_MAX_SIZE = 1024;
+	enum ipa_ip_type m_ip;
+	unsigned int m_numRules;
+	RoutingDriverWrapper m_routing;
+	Filtering m_filtering;
+};
+
+static IpaSimulatorRuleTableBench ipaSimulatorRuleTableBenchV4_64(
+	"IpaSimulatorRuleTableBenchV4_64", IPA_IP_v4, 64);
+static IpaSimulatorRuleTableBench ipaSimulatorRuleTableBenchV4_512(
+	"IpaSimulatorRuleTableBenchV4_512", IPA_IP_v4, 512);
+static IpaSimulatorRuleTableBench ipaSimulatorRuleTableBenchV4_4096(
+	"IpaSimulatorRuleTableBenchV4_4096", IPA_IP_v4, 4096);
+static IpaSimulatorRuleTableBench ipaSimulatorRuleTableBenchV6_64(
+	"IpaSimulatorRuleTableBenchV6_64", IPA_IP_v6, 64);
+static IpaSimulatorRuleTableBench ipaSimulatorRuleTableBenchV6_512(
+	"IpaSimulatorRuleTableBenchV6_512", IPA_IP_v6, 512);
+static IpaSimulatorRuleTableBench ipaSimulatorRuleTableBenchV6_4096(
+	"IpaSimulatorRuleTableBenchV6_4096", IPA_IP_v6, 4096);
@@ -33,6 +33,7 @@
 #include <string.h>
 #include <iostream>
 #include "InterfaceAbstraction.h"
+#include "IPADevice.h"
 
 #define MAX_OPEN_RETRY 10000
 
@@ -67,7 +68,7 @@ bool InterfaceAbstraction::Open(
 
 		for ( cnt = 1; cnt <= MAX_OPEN_RETRY; cnt++ ) {
 
-			if ( (m_toIPADescriptor = open(toIPAPath, O_WRONLY)) != -1 ) {
+			if ( (m_toIPADescriptor = IPADeviceOpen(toIPAPath, O_WRONLY)) != -1 ) {
 				printf(
 					"Succeeded opening %s on attempt %d\n",
 					toIPAPath, cnt);
@@ -101,7 +102,7 @@ bool InterfaceAbstraction::Open(
 
 		for ( cnt = 1; cnt <= MAX_OPEN_RETRY; cnt++ ) {
 
-			if ( (m_fromIPADescriptor = open(fromIPAPath, O_RDONLY)) != -1 ) {
+			if ( (m_fromIPADescriptor = IPADeviceOpen(fromIPAPath, O_RDONLY)) != -1 ) {
 				printf("Open success on attempt %d\n", cnt);
 				break;
 			}
@@ -129,8 +130,8 @@ bool InterfaceAbstraction::Open(
 
 void InterfaceAbstraction::Close()
 {
-	close(m_toIPADescriptor);
-	close(m_fromIPADescriptor);
+	IPADeviceClose(m_toIPADescriptor);
+	IPADeviceClose(m_fromIPADescriptor);
 }
 
 long InterfaceAbstraction::SendData(unsigned char *buf, size_t size)
@@ -139,7 +140,7 @@ long InterfaceAbstraction::SendData(unsigned char *buf, size_t size)
 
 	printf("Trying to write %zu bytes to fd(%d)\n", size, m_toIPADescriptor);
 
-	bytesWritten = write(m_toIPADescriptor, buf, size);
+	bytesWritten = IPADeviceWrite(m_toIPADescriptor, buf, size);
 	if (-1 == bytesWritten)
 	{
 		int err = errno;
@@ -171,7 +172,7 @@ int InterfaceAbstraction::ReceiveData(unsigned char *buf, size_t size)
 	{
 		printf("Trying to read %zu bytes from fd(%d)\n", size, m_fromIPADescriptor);
 
-		bytesRead = read(m_fromIPADescriptor, (void*)buf, size);
+		bytesRead = IPADeviceRead(m_fromIPADescriptor, (void*)buf, size);
 		printf("Read %zu bytes.\n", bytesRead);
 		totalBytesRead += bytesRead;
 		if (bytesRead == size)
@@ -186,32 +187,32 @@ int InterfaceAbstraction::ReceiveData(unsigned char *buf, size_t size)
 int InterfaceAbstraction::ReceiveSingleDataChunk(unsigned char *buf, size_t size){
 	size_t bytesRead = 0;
 	printf("Trying to read %zu bytes from %d.\n", size, m_fromIPADescriptor);
-	bytesRead = read(m_fromIPADescriptor, (void*)buf, size);
+	bytesRead = IPADeviceRead(m_fromIPADescriptor, (void*)buf, size);
 	printf("Read %zu bytes.\n", bytesRead);
 	return bytesRead;
 }
 
 int InterfaceAbstraction::setReadNoBlock(){
-	int flags = fcntl(m_fromIPADescriptor, F_GETFL, 0);
+	int flags = IPADeviceFcntl(m_fromIPADescriptor, F_GETFL, 0);
 	if(flags == -1){
 		return -1;
 	}
-	return fcntl(m_fromIPADescriptor, F_SETFL, flags | O_NONBLOCK);
+	return IPADeviceFcntl(m_fromIPADescriptor, F_SETFL, flags | O_NONBLOCK);
 }
 
 int InterfaceAbstraction::clearReadNoBlock(){
-	int flags = fcntl(m_fromIPADescriptor, F_GETFL, 0);
+	int flags = IPADeviceFcntl(m_fromIPADescriptor, F_GETFL, 0);
 	if(flags == -1){
 		return -1;
 	}
-	return fcntl(m_fromIPADescriptor, F_SETFL, flags & ~O_NONBLOCK);
+	return IPADeviceFcntl(m_fromIPADescriptor, F_SETFL, flags & ~O_NONBLOCK);
 }
 
 InterfaceAbstraction::~InterfaceAbstraction()
 {
-	close(m_fromIPADescriptor);
+	IPADeviceClose(m_fromIPADescriptor);
 	m_fromChannelName = "";
 
-	close(m_toIPADescriptor);
+	IPADeviceClose(m_toIPADescriptor);
 	m_toChannelName = "";
 }
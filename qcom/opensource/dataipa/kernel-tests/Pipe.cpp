@@ -29,6 +29,7 @@
 
 #include "Pipe.h"
 #include "TestsUtils.h"
+#include "IPADevice.h"
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 //Do not change those default values due to the fact that some test may relay on those default values.
@@ -73,7 +74,7 @@ bool Pipe::Init() {
 	SetSpecificClientParameters(m_nClientType, m_eConfiguration);
 	//By examining the Client type we will map the inode device name
 	while (tries_cnt <= 10000) {
-		m_Fd = open(m_pInodePath, O_RDWR);
+		m_Fd = IPADeviceOpen(m_pInodePath, O_RDWR);
 		if (-1 != m_Fd)
 			break;
 
@@ -97,7 +98,7 @@ void Pipe::Destroy() {
 		LOG_MSG_ERROR("Pipe is being used without being initialized!");
 		return;
 	}
-	close(m_Fd);
+	IPADeviceClose(m_Fd);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -108,7 +109,7 @@ int Pipe::Send(unsigned char * pBuffer, size_t nBytesToSend) {
 		return 0;
 	}
 	size_t nBytesWritten = 0;
-	nBytesWritten = write(m_Fd, pBuffer, nBytesToSend);
+	nBytesWritten = IPADeviceWrite(m_Fd, pBuffer, nBytesToSend);
 	return nBytesWritten;
 }
 
@@ -149,7 +150,7 @@ int Pipe::Receive(unsigned char *pBuffer, size_t nBytesToReceive) {
 		return 0;
 	}
 	size_t nBytesRead = 0;
-	nBytesRead = read(m_Fd, (void*) pBuffer, nBytesToReceive);
+	nBytesRead = IPADeviceRead(m_Fd, (void*) pBuffer, nBytesToReceive);
 	return nBytesRead;
 }
 
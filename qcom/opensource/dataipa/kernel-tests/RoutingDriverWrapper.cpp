@@ -34,12 +34,13 @@
 
 #include "RoutingDriverWrapper.h"
 #include "TestsUtils.h"
+#include "IPADevice.h"
 
 const char* RoutingDriverWrapper::DEVICE_NAME = "/dev/ipa";
 
 RoutingDriverWrapper::RoutingDriverWrapper()
 {
-	m_fd = open(DEVICE_NAME, O_RDWR);
+	m_fd = IPADeviceOpen(DEVICE_NAME, O_RDWR);
 	if (0 == m_fd) {
 		printf("Failed opening %s.\n", DEVICE_NAME);
 	}
@@ -47,12 +48,12 @@ RoutingDriverWrapper::RoutingDriverWrapper()
 
 RoutingDriverWrapper::~RoutingDriverWrapper()
 {
-	close(m_fd);
+	IPADeviceClose(m_fd);
 }
 
 bool RoutingDriverWrapper::DeviceNodeIsOpened()
 {
-	int res = fcntl(m_fd, F_GETFL);
+	int res = IPADeviceFcntl(m_fd, F_GETFL);
 
 	if (m_fd > 0 && res >=0)
 		return true;
@@ -68,7 +69,7 @@ bool RoutingDriverWrapper::AddRoutingRule(struct ipa_ioc_add_rt_rule *ruleTable)
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_ADD_RT_RULE, ruleTable);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_ADD_RT_RULE, ruleTable);
 	if (retval) {
 		printf("%s(), failed adding routing rule table %p\n", __FUNCTION__, ruleTable);
 		return false;
@@ -85,7 +86,7 @@ bool RoutingDriverWrapper::AddRoutingRule(struct ipa_ioc_add_rt_rule_v2 *ruleTab
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_ADD_RT_RULE_V2, ruleTable_v2);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_ADD_RT_RULE_V2, ruleTable_v2);
 	if (retval) {
 		printf("%s(), failed adding routing rule table %p\n", __FUNCTION__, ruleTable_v2);
 		return false;
@@ -102,7 +103,7 @@ bool RoutingDriverWrapper::DeleteRoutingRule(struct ipa_ioc_del_rt_rule *ruleTab
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_DEL_RT_RULE, ruleTable);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_DEL_RT_RULE, ruleTable);
 	if (retval) {
 		printf("%s(), failed deleting routing rule table %p\n", __FUNCTION__, ruleTable);
 		return false;
@@ -119,7 +120,7 @@ bool RoutingDriverWrapper::Commit(enum ipa_ip_type ip)
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_COMMIT_RT, ip);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_COMMIT_RT, ip);
 	if (retval) {
 		printf("%s(), failed commiting routing rules.\n", __FUNCTION__);
 		return false;
@@ -136,8 +137,8 @@ bool RoutingDriverWrapper::Reset(enum ipa_ip_type ip)
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_RESET_RT, ip);
-	retval |= ioctl(m_fd, IPA_IOC_COMMIT_RT, ip);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_RESET_RT, ip);
+	retval |= IPADeviceIoctl(m_fd, IPA_IOC_COMMIT_RT, ip);
 	if (retval) {
 		printf("%s(), failed reseting routing block.\n", __FUNCTION__);
 		return false;
@@ -154,7 +155,7 @@ bool RoutingDriverWrapper::GetRoutingTable(struct ipa_ioc_get_rt_tbl *routingTab
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_GET_RT_TBL, routingTable);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_GET_RT_TBL, routingTable);
 	if (retval) {
 		printf("%s(), IPA_IOCTL_GET_RT_TBL ioctl failed, routingTable =0x%p, retval=0x%x.\n", __FUNCTION__, routingTable, retval);
 		return false;
@@ -171,7 +172,7 @@ bool RoutingDriverWrapper::PutRoutingTable(uint32_t routingTableHandle)
 	if (!DeviceNodeIsOpened())
 		return false;
 
-	retval = ioctl(m_fd, IPA_IOC_PUT_RT_TBL, routingTableHandle);
+	retval = IPADeviceIoctl(m_fd, IPA_IOC_PUT_RT_TBL, routingTableHandle);
 	if (retval) {
 		printf("%s(), IPA_IOCTL_PUT_RT_TBL ioctl failed.\n", __FUNCTION__);
 		return false;
@@ -36,6 +36,7 @@
 #include <sstream>
 #include "TestManager.h"
 #include "TestsUtils.h"
+#include "IPADevice.h"
 #include <fcntl.h>
 #include <unistd.h>
 #include "ipa_test_module.h"
@@ -373,7 +374,7 @@ void TestManager::FetchIPAHwType()
 	int fd;
 
 	// Open ipa_test device node
-	fd = open("/dev/ipa_test" , O_RDONLY);
+	fd = IPADeviceOpen("/dev/ipa_test" , O_RDONLY);
 	if (fd < 0) {
 		printf("Failed opening %s. errno %d: %s\n", "/dev/ipa_test", errno, strerror(errno));
 		m_IPAHwType = IPA_HW_None;
@@ -382,14 +383,14 @@ void TestManager::FetchIPAHwType()
 
 	printf("%s(), fd is %d\n", __FUNCTION__, fd);
 
-	m_IPAHwType = (enum ipa_hw_type)ioctl(fd, IPA_TEST_IOC_GET_HW_TYPE);
+	m_IPAHwType = (enum ipa_hw_type)IPADeviceIoctl(fd, IPA_TEST_IOC_GET_HW_TYPE);
 	if (-1 == m_IPAHwType) {
 		printf("%s(), IPA_TEST_IOC_GET_HW_TYPE ioctl failed\n", __FUNCTION__);
 		m_IPAHwType = IPA_HW_None;
 	}
 
 	printf("%s(), IPA HW type (version) = %d\n", __FUNCTION__, m_IPAHwType);
-	close(fd);
+	IPADeviceClose(fd);
 }
 
 
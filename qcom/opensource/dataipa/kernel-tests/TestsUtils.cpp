@@ -40,6 +40,7 @@
 #include "InterfaceAbstraction.h"
 #include "Constants.h"
 #include "Pipe.h"
+#include "IPADevice.h"
 
 using namespace std;
 ///////////////////////////////////////////////////////////////////////////////
@@ -549,7 +550,7 @@ bool SendReceiveAndCompare(InterfaceAbstraction *pSink, uint8_t* pSendBuffer, si
 	}
 
 bail:
-	delete (pRxBuff);
+	delete[] pRxBuff;
 	LOG_MSG_STACK("Leaving Function (Returning %s)",bRetVal?"True":"False");
 	return bRetVal;
 }
@@ -751,7 +752,7 @@ int ConfigureSystem(int testConfiguration, int fd, const char* params)
 	else
 		snprintf(pSendBuffer, 10, "%d", testConfiguration);
 
-	ret = write(fd, pSendBuffer, sizeof(pSendBuffer) );
+	ret = IPADeviceWrite(fd, pSendBuffer, sizeof(pSendBuffer) );
 	if (ret < 0) {
 		g_Logger.AddMessage(LOG_ERROR, "%s Write operation failed.\n", __FUNCTION__);
 		goto bail;
@@ -763,7 +764,7 @@ int ConfigureSystem(int testConfiguration, int fd, const char* params)
 	snprintf(testConfigurationStr, sizeof(testConfigurationStr), "%d", testConfiguration);
 
 	// Read the configuration index from the device node
-	ret = read(fd, str, sizeof(str));
+	ret = IPADeviceRead(fd, str, sizeof(str));
 	if (ret < 0) {
 		g_Logger.AddMessage(LOG_ERROR, "%s Read operation failed.\n", __FUNCTION__);
 		goto bail;
@@ -775,7 +776,7 @@ int ConfigureSystem(int testConfiguration, int fd, const char* params)
 		time.tv_sec = 0;
 		time.tv_nsec = 50e6;
 		nanosleep(&time, NULL);
-		ret = read(fd, str, sizeof(str));
+		ret = IPADeviceRead(fd, str, sizeof(str));
 		if (ret < 0) {
 			g_Logger.AddMessage(LOG_ERROR, "%s Read operation failed.\n", __FUNCTION__);
 			goto bail;
@@ -804,14 +805,14 @@ void ConfigureScenario(int testConfiguration, const char* params)
 
 	// Open /dev/ipa_test device node. This will allow to configure the system
 	// and read its current configuration.
-	fd = open(CONFIGURATION_NODE_PATH, O_RDWR);
+	fd = IPADeviceOpen(CONFIGURATION_NODE_PATH, O_RDWR);
 	if (fd < 0) {
 		g_Logger.AddMessage(LOG_ERROR, "%s Could not open configuration device node.\n", __FUNCTION__);
 		exit(0);
 	}
 
 	// Read the current configuration.
-	ret = read(fd, str, sizeof(str));
+	ret = IPADeviceRead(fd, str, sizeof(str));
 	if (ret < 0) {
 		g_Logger.AddMessage(LOG_ERROR, "%s Read operation failed.\n", __FUNCTION__);
 		return;
@@ -852,7 +853,7 @@ void ConfigureScenario(int testConfiguration, const char* params)
 				__FUNCTION__, ret);
 	}
 
-	close(fd);
+	IPADeviceClose(fd);
 }//func
 
 void clean_old_stashed_config()
@@ -925,14 +926,14 @@ bool is_prev_configuration_generic()
 	int retval;
 	int current_conf_num;
 
-	fd = open(CONFIGURATION_NODE_PATH, O_RDWR);
+	fd = IPADeviceOpen(CONFIGURATION_NODE_PATH, O_RDWR);
 	if (fd < 0) {
 		g_Logger.AddMessage(LOG_ERROR ,"%s Could not open configuration device node.\n", __FUNCTION__);
 		exit(0);
 	}
 
-	retval = read(fd, str, sizeof(str));
-	close(fd);
+	retval = IPADeviceRead(fd, str, sizeof(str));
+	IPADeviceClose(fd);
 	if (retval < 0) {
 		g_Logger.AddMessage(LOG_ERROR ,"%s Read operation failed.\n", __FUNCTION__);
 		return true;
@@ -1066,7 +1067,7 @@ int GenericConfigureScenario(struct ipa_test_config_header *header, bool isUlso)
 				header->to_ipa_channel_config[i]->en_status);
 	}
 
-	fd = open(CONFIGURATION_NODE_PATH, O_RDWR);
+	fd = IPADeviceOpen(CONFIGURATION_NODE_PATH, O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
 				"%s - open %s failed (fd=%d,errno=%s)\n",
@@ -1075,19 +1076,19 @@ int GenericConfigureScenario(struct ipa_test_config_header *header, bool isUlso)
 	}
 
 	if(isUlso){
-		retval = ioctl(fd, IPA_TEST_IOC_ULSO_CONFIGURE, header);
+		retval = IPADeviceIoctl(fd, IPA_TEST_IOC_ULSO_CONFIGURE, header);
 	} else {
-		retval = ioctl(fd, IPA_TEST_IOC_CONFIGURE, header);
+		retval = IPADeviceIoctl(fd, IPA_TEST_IOC_CONFIGURE, header);
 	}
 	if (retval) {
 		g_Logger.AddMessage(LOG_ERROR, "fail to configure the system (%d)\n", retval);
-		close(fd);
+		IPADeviceClose(fd);
 		return false;
 	} else {
 		g_Logger.AddMessage(LOG_DEVELOPMENT, "system was successfully configured\n");
 	}
 
-	retval = close(fd);
+	retval = IPADeviceClose(fd);
 	if (retval) {
 		g_Logger.AddMessage(LOG_ERROR,
 				"%s - fail to close the fd (path=%s,retval=%d,fd=%d,errno=%s)\n",
@@ -1117,7 +1118,7 @@ int GenericConfigureScenarioDestory(void)
 
 	g_Logger.AddMessage(LOG_DEVELOPMENT, "cleanup started\n");
 
-	fd = open(CONFIGURATION_NODE_PATH,  O_RDWR);
+	fd = IPADeviceOpen(CONFIGURATION_NODE_PATH,  O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
 			"%s - open %s failed (retval=%d,fd=%d,errno=%s)\n",
@@ -1125,13 +1126,13 @@ int GenericConfigureScenarioDestory(void)
 		return false;
 	}
 
-	retval = ioctl(fd, IPA_TEST_IOC_CLEAN);
+	retval = IPADeviceIoctl(fd, IPA_TEST_IOC_CLEAN);
 	if (retval)
 		g_Logger.AddMessage(LOG_ERROR, "fail to clean the system (%d)\n", retval);
 	else
 		g_Logger.AddMessage(LOG_DEVELOPMENT, "system was successfully cleaned\n");
 
-	retval = close(fd);
+	retval = IPADeviceClose(fd);
 	if (retval) {
 		g_Logger.AddMessage(LOG_ERROR, "fail to close the fd - %d\n", retval);
 		return false;
@@ -1147,7 +1148,7 @@ bool configure_ep_ctrl(struct ipa_test_ep_ctrl *ep_ctrl)
 
 	g_Logger.AddMessage(LOG_DEVELOPMENT, "ep ctrl started \n");
 
-	fd = open(CONFIGURATION_NODE_PATH,  O_RDWR);
+	fd = IPADeviceOpen(CONFIGURATION_NODE_PATH,  O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
 			"%s - open %s failed (retval=%d,fd=%d,errno=%s)\n",
@@ -1155,13 +1156,13 @@ bool configure_ep_ctrl(struct ipa_test_ep_ctrl *ep_ctrl)
 		return false;
 	}
 
-	retval = ioctl(fd, IPA_TEST_IOC_EP_CTRL, ep_ctrl);
+	retval = IPADeviceIoctl(fd, IPA_TEST_IOC_EP_CTRL, ep_ctrl);
 	if (retval)
 		g_Logger.AddMessage(LOG_ERROR, "fail to perform ep ctrl (%d)\n", retval);
 	else
 		g_Logger.AddMessage(LOG_DEVELOPMENT, "ep ctrl was successfully executed\n");
 
-	retval = close(fd);
+	retval = IPADeviceClose(fd);
 	if (retval) {
 		g_Logger.AddMessage(LOG_ERROR, "fail to close the fd - %d\n", retval);
 	}
@@ -1181,7 +1182,7 @@ bool configure_holb(struct ipa_test_holb_config *test_holb_config)
 		return false;
 	}
 
-	fd = open(CONFIGURATION_NODE_PATH,  O_RDWR);
+	fd = IPADeviceOpen(CONFIGURATION_NODE_PATH,  O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
 			"%s - open %s failed (retval=%d,fd=%d,errno=%s)\n",
@@ -1189,7 +1190,7 @@ bool configure_holb(struct ipa_test_holb_config *test_holb_config)
 		return false;
 	}
 
-	retval = ioctl(fd, IPA_TEST_IOC_HOLB_CONFIG, test_holb_config);
+	retval = IPADeviceIoctl(fd, IPA_TEST_IOC_HOLB_CONFIG, test_holb_config);
 	if (retval)
 		g_Logger.AddMessage(LOG_ERROR,
 							"fail to perform holb config (%d)\n",
@@ -1198,7 +1199,7 @@ bool configure_holb(struct ipa_test_holb_config *test_holb_config)
 		g_Logger.AddMessage(LOG_DEVELOPMENT,
 							"holb config was successfully executed\n");
 
-	retval = close(fd);
+	retval = IPADeviceClose(fd);
 	if (retval) {
 		g_Logger.AddMessage(LOG_ERROR, "fail to close the fd - %d\n", retval);
 	}
@@ -1330,7 +1331,7 @@ bool RegSuspendHandler(bool deferred_flag, bool reg, int DevNum)
 	int retval = 0;
 	struct ipa_test_reg_suspend_handler RegData;
 
-	fd = open(CONFIGURATION_NODE_PATH,  O_RDWR);
+	fd = IPADeviceOpen(CONFIGURATION_NODE_PATH,  O_RDWR);
 	if (fd == -1) {
 		g_Logger.AddMessage(LOG_ERROR,
 				"%s - open %s failed (fd=%d,errno=%s)\n",
@@ -1342,16 +1343,16 @@ bool RegSuspendHandler(bool deferred_flag, bool reg, int DevNum)
 	RegData.reg = reg;
 	RegData.deferred_flag = deferred_flag;
 
-	retval = ioctl(fd, IPA_TEST_IOC_REG_SUSPEND_HNDL, &RegData);
+	retval = IPADeviceIoctl(fd, IPA_TEST_IOC_REG_SUSPEND_HNDL, &RegData);
 	if (retval) {
 		g_Logger.AddMessage(LOG_ERROR, "fail to reg suspend handler (%d)\n", retval);
-		close(fd);
+		IPADeviceClose(fd);
 		return false;
 	} else {
 		g_Logger.AddMessage(LOG_DEVELOPMENT, "suspend handler was successfully configured\n");
 	}
 
-	close(fd);
+	IPADeviceClose(fd);
 
 	return true;
 }
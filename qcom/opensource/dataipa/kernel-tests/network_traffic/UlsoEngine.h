@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef NETWORK_TRAFFIC_ULSOENGINE_H
+#define NETWORK_TRAFFIC_ULSOENGINE_H
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using std::vector;
+
+/**
+ * Internet checksum kernels.
+ * Partial sums are accumulated on host order 16 bit words, the same way Header::computeChecksum() does, so a folded
+ * and inverted sum can be stored into the packet with memcpy as is.
+ */
+namespace UlsoChecksum {
+
+inline uint16_t fold(uint64_t sum){
+    while(sum >> 16u){
+        sum = (sum & 0xffffu) + (sum >> 16u);
+    }
+    return static_cast<uint16_t>(sum);
+}
+
+/**
+ * Reference kernel, one 16 bit word at a time.
+ */
+inline uint64_t partialScalar(const uint8_t *buf, size_t len, uint64_t sum=0){
+    uint16_t word;
+
+    while(len > 1){
+        memcpy(&word, buf, sizeof(word));
+        sum += word;
+        buf += sizeof(word);
+        len -= sizeof(word);
+    }
+    if(len > 0){
+        word = 0;
+        memcpy(&word, buf, 1);
+        sum += word;
+    }
+    return sum;
+}
+
+/**
+ * Vector kernel, 16 bytes per step on SSE2 and NEON, 32 bit words elsewhere.
+ * The 32 bit lanes take at most 2 * 0xffff per step, they are flushed to the 64 bit sum every maxSteps steps so
+ * they never wrap.
+ */
+inline uint64_t partialSimd(const uint8_t *buf, size_t len, uint64_t sum=0){
+    constexpr size_t maxSteps {16384};
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t lanes[4];
+
+    while(len >= 16){
+        size_t steps = std::min<size_t>(len / 16, maxSteps);
+        __m128i acc = zero;
+
+        for(size_t i = 0; i < steps; i++){
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+            acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+            acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+            buf += 16;
+        }
+        len -= steps * 16;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        sum += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    while(len >= 16){
+        size_t steps = std::min<size_t>(len / 16, maxSteps);
+        uint32x4_t acc = vdupq_n_u32(0);
+
+        for(size_t i = 0; i < steps; i++){
+            acc = vpadalq_u16(acc, vreinterpretq_u16_u8(vld1q_u8(buf)));
+            buf += 16;
+        }
+        len -= steps * 16;
+        sum += vaddlvq_u32(acc);
+    }
+#else
+    uint32_t word;
+
+    /* 2^16 == 1 in ones' complement arithmetic, 32 bit words fold to the same 16 bit sum */
+    while(len >= sizeof(word)){
+        memcpy(&word, buf, sizeof(word));
+        sum += word;
+        buf += sizeof(word);
+        len -= sizeof(word);
+    }
+#endif
+    return partialScalar(buf, len, sum);
+}
+
+} // namespace UlsoChecksum
+
+class UlsoEngine {
+/**
+ * class UlsoEngine is a software implementation of the IPA ULSO segmentation working on raw buffers.
+ * It takes a QMAP framed super packet, the same bytes UlsoPacket::asArray() produces and the HW gets on the ULSO
+ * producer pipe, and writes the segments the HW sends out: QMAP header removed, payload cut to the QMAP segment size,
+ * IPv4 total length / IPv6 payload length, IPv4 ID and header checksum, TCP sequence number and flags, UDP length and
+ * L4 checksum fixed per segment. The rules follow UlsoPacket::segment() which is the model the HW is tested against.
+ */
+public:
+
+    enum class Checksum {Scalar, Simd};
+
+    struct Segment {
+        size_t offset;
+        size_t size;
+    };
+
+    static constexpr size_t qmapSize {8};
+    static constexpr size_t ethernetSize {14};
+
+    explicit UlsoEngine(bool ethernetHeaderValid=true, Checksum checksum=Checksum::Simd, unsigned int minId=0,
+            unsigned int maxId=65535):
+        mEthernetHeaderValid(ethernetHeaderValid),
+        mChecksum(checksum),
+        mMinId(minId),
+        mMaxId(maxId) {
+        if(minId > maxId || maxId > UINT16_MAX){
+            throw std::invalid_argument("Bad IPv4 ID range");
+        }
+    }
+
+    /**
+     * Segments one ULSO packet.
+     * @param in - QMAP header, optional Ethernet 2 header, IP header, TCP/UDP header and payload.
+     * @param inSize - size of in.
+     * @param out - buffer the segments are written to back to back.
+     * @param outSize - size of out.
+     * @param segments - filled with the position of every segment in out.
+     * @return the number of bytes written to out.
+     */
+    size_t segment(const uint8_t *in, size_t inSize, uint8_t *out, size_t outSize, vector<Segment>& segments) const {
+        segments.clear();
+        if(inSize < qmapSize){
+            throw std::invalid_argument("Truncated QMAP header");
+        }
+        bool zeroChecksum = in[5] & 0x40u;
+        bool ipIdCfg = in[5] & 0x80u;
+        size_t segmentSize = getBe16(in + 6);
+        if(segmentSize == 0){
+            throw std::invalid_argument("Zero segment size");
+        }
+
+        const uint8_t *hdr = in + qmapSize;
+        size_t l2Size = mEthernetHeaderValid * ethernetSize;
+        size_t ipSize = 0;
+        size_t l4Size = 0;
+        uint8_t protocol = 0;
+        size_t avail = inSize - qmapSize;
+        if(avail < l2Size + 1){
+            throw std::invalid_argument("Truncated L2 header");
+        }
+        const uint8_t *ip = hdr + l2Size;
+        bool isIpv4 = (ip[0] >> 4u) == 4;
+        if(isIpv4){
+            ipSize = (ip[0] & 0xfu) * 4u;
+            protocol = ip[9];
+        } else if((ip[0] >> 4u) == 6){
+            ipSize = 40;
+            protocol = ip[6];
+        } else {
+            throw std::invalid_argument("Unknown IP version");
+        }
+        if(avail < l2Size + ipSize + udpHeaderSize){
+            throw std::invalid_argument("Truncated IP header");
+        }
+        const uint8_t *l4 = ip + ipSize;
+        if(protocol == tcpProtocol){
+            if(avail < l2Size + ipSize + tcpMinHeaderSize){
+                throw std::invalid_argument("Truncated TCP header");
+            }
+            l4Size = (l4[12] >> 4u) * 4u;
+            if(l4Size < tcpMinHeaderSize){
+                throw std::invalid_argument("Bad TCP data offset");
+            }
+        } else if(protocol == udpProtocol){
+            l4Size = udpHeaderSize;
+        } else {
+            throw std::invalid_argument("ULSO supports TCP and UDP only");
+        }
+        size_t hdrSize = l2Size + ipSize + l4Size;
+        if(avail < hdrSize){
+            throw std::invalid_argument("Truncated L4 header");
+        }
+
+        const uint8_t *payload = hdr + hdrSize;
+        size_t payloadSize = avail - hdrSize;
+        size_t numSegments = (payloadSize + segmentSize - 1) / segmentSize;
+        if(outSize < numSegments * hdrSize + payloadSize){
+            throw std::length_error("Output buffer too small");
+        }
+
+        unsigned int id = isIpv4 ? std::max<unsigned int>(getBe16(ip + 4), mMinId) % (mMaxId + 1) : 0;
+        uint32_t seqNum = protocol == tcpProtocol ? getBe32(l4 + 4) : 0;
+        uint64_t addrSum = isIpv4 ? partial(ip + 12, 8) : partial(ip + 8, 32);
+        size_t pos = 0;
+
+        for(size_t off = 0; off < payloadSize; off += segmentSize){
+            size_t n = std::min(segmentSize, payloadSize - off);
+            bool last = off + n == payloadSize;
+            uint8_t *seg = out + pos;
+            uint8_t *segIp = seg + l2Size;
+            uint8_t *segL4 = segIp + ipSize;
+            size_t l4Len = l4Size + n;
+
+            memcpy(seg, hdr, hdrSize);
+            memcpy(seg + hdrSize, payload + off, n);
+
+            if(isIpv4){
+                putBe16(segIp + 2, ipSize + l4Len);
+                if(!ipIdCfg){
+                    putBe16(segIp + 4, id);
+                    id = id == mMaxId ? mMinId : id + 1;
+                }
+                putBe16(segIp + 10, 0);
+                storeChecksum(segIp + 10, partial(segIp, ipSize));
+            } else {
+                putBe16(segIp + 4, l4Len);
+            }
+
+            /* pseudo header: addresses, zero, protocol, L4 length */
+            uint8_t pseudo[4] = {0, protocol, static_cast<uint8_t>(l4Len >> 8u), static_cast<uint8_t>(l4Len)};
+            if(protocol == tcpProtocol){
+                putBe32(segL4 + 4, seqNum + off);
+                if(!last){
+                    segL4[13] &= ~(tcpFin | tcpPsh | tcpRst | tcpCwr);
+                }
+                putBe16(segL4 + 16, 0);
+                storeChecksum(segL4 + 16, partial(segL4, l4Len, addrSum + partial(pseudo, sizeof(pseudo))));
+            } else {
+                putBe16(segL4 + 4, l4Len);
+                putBe16(segL4 + 6, 0);
+                if(!zeroChecksum){
+                    storeChecksum(segL4 + 6, partial(segL4, l4Len, addrSum + partial(pseudo, sizeof(pseudo))));
+                }
+            }
+
+            segments.push_back({pos, hdrSize + n});
+            pos += hdrSize + n;
+        }
+        return pos;
+    }
+
+private:
+
+    static constexpr uint8_t tcpProtocol {6};
+    static constexpr uint8_t udpProtocol {17};
+    static constexpr size_t tcpMinHeaderSize {20};
+    static constexpr size_t udpHeaderSize {8};
+    static constexpr uint8_t tcpFin {0x01};
+    static constexpr uint8_t tcpRst {0x04};
+    static constexpr uint8_t tcpPsh {0x08};
+    static constexpr uint8_t tcpCwr {0x80};
+
+    bool mEthernetHeaderValid;
+    Checksum mChecksum;
+    unsigned int mMinId;
+    unsigned int mMaxId;
+
+    uint64_t partial(const uint8_t *buf, size_t len, uint64_t sum=0) const {
+        if(mChecksum == Checksum::Simd){
+            return UlsoChecksum::partialSimd(buf, len, sum);
+        }
+        return UlsoChecksum::partialScalar(buf, len, sum);
+    }
+
+    static void storeChecksum(uint8_t *dst, uint64_t sum){
+        uint16_t checksum = ~UlsoChecksum::fold(sum);
+
+        memcpy(dst, &checksum, sizeof(checksum));
+    }
+
+    static uint16_t getBe16(const uint8_t *p){
+        return static_cast<uint16_t>((p[0] << 8u) | p[1]);
+    }
+
+    static uint32_t getBe32(const uint8_t *p){
+        return (static_cast<uint32_t>(getBe16(p)) << 16u) | getBe16(p + 2);
+    }
+
+    static void putBe16(uint8_t *p, size_t val){
+        p[0] = static_cast<uint8_t>(val >> 8u);
+        p[1] = static_cast<uint8_t>(val);
+    }
+
+    static void putBe32(uint8_t *p, uint32_t val){
+        putBe16(p, val >> 16u);
+        putBe16(p + 2, val & 0xffffu);
+    }
+};
+
+#endif //NETWORK_TRAFFIC_ULSOENGINE_H
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include "UlsoPacket.h"
+#include "UlsoEngine.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+
+/**
+ * Host side checks of UlsoEngine.
+ * validate - compare the engine with the UlsoPacket model for all the packet types and ULSO configurations, and the
+ *            vector checksum kernel with the scalar one.
+ * bench    - segmentation and checksum throughput, i.e. what a software fallback costs on a CPU without ULSO.
+ */
+
+static uint8_t inBuf[UlsoPacket<>::maxSize];
+static uint8_t outBuf[4 * UlsoPacket<>::maxSize];
+static uint8_t goldBuf[4 * UlsoPacket<>::maxSize];
+
+static constexpr size_t segmentSizes[] = {1, 10, 19, 100, 512, 1220, 1460};
+static constexpr float segmentsNums[] = {0.5, 0.99, 1, 1.01, 4, 10};
+
+template<typename Transport, typename Internet>
+static bool validateOne(std::mt19937& rng, size_t segmentSize, size_t payloadSize, bool ethernet, bool ipIdCfg,
+        bool zeroChecksum){
+    using PacketType = UlsoPacket<Transport, Internet>;
+    PacketType p(segmentSize, payloadSize, ethernet);
+    vector<UlsoEngine::Segment> segments;
+
+    for(auto& b: p.mPayload){
+        b = static_cast<uint8_t>(rng());
+    }
+    p.mQmapHeader.setmIpIdCfg(ipIdCfg);
+    p.mQmapHeader.setmZeroChecksum(zeroChecksum);
+    size_t inSize = p.asArray(inBuf);
+
+    size_t goldSize = 0;
+    vector<PacketType> goldVec = p.segment();
+    for(auto& s: goldVec){
+        goldSize += s.asArray(goldBuf + goldSize);
+    }
+
+    for(auto checksum: {UlsoEngine::Checksum::Scalar, UlsoEngine::Checksum::Simd}){
+        UlsoEngine engine(ethernet, checksum);
+        size_t outSize = engine.segment(inBuf, inSize, outBuf, sizeof(outBuf), segments);
+        if(segments.size() != goldVec.size() || outSize != goldSize || memcmp(outBuf, goldBuf, goldSize)){
+            cout << "Mismatch: " << Internet().name() << " " << Transport().name() << " segment size=" << segmentSize
+                 << " payload=" << payloadSize << " ethernet=" << ethernet << " IPID cfg=" << ipIdCfg
+                 << " zero checksum=" << zeroChecksum << " simd=" << (checksum == UlsoEngine::Checksum::Simd) << endl;
+            cout << "Expected " << goldVec.size() << " segments, " << goldSize << " bytes, got " << segments.size()
+                 << " segments, " << outSize << " bytes" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Transport, typename Internet>
+static bool validateType(std::mt19937& rng){
+    size_t count = 0;
+
+    for(auto segmentSize: segmentSizes){
+        for(auto segmentsNum: segmentsNums){
+            size_t payloadSize = static_cast<size_t>(segmentSize * segmentsNum);
+            for(int cfg = 0; cfg < 8; cfg++){
+                if(!validateOne<Transport, Internet>(rng, segmentSize, payloadSize, cfg & 1, cfg & 2, cfg & 4)){
+                    return false;
+                }
+                count++;
+            }
+        }
+    }
+    cout << Internet().name() << " " << Transport().name() << ": " << count << " packets match the model" << endl;
+    return true;
+}
+
+static bool validateChecksum(std::mt19937& rng){
+    for(size_t len = 0; len < 4096; len++){
+        size_t off = rng() % 16;
+        for(size_t i = 0; i < len + off; i++){
+            inBuf[i] = static_cast<uint8_t>(rng());
+        }
+        uint16_t ref = UlsoChecksum::fold(UlsoChecksum::partialScalar(inBuf + off, len));
+        uint16_t simd = UlsoChecksum::fold(UlsoChecksum::partialSimd(inBuf + off, len));
+        if(ref != simd){
+            cout << "Checksum mismatch: len=" << len << " offset=" << off << " scalar=" << ref << " simd=" << simd
+                 << endl;
+            return false;
+        }
+    }
+    /* all ones stresses the lane flushing */
+    memset(inBuf, 0xff, sizeof(inBuf));
+    if(UlsoChecksum::fold(UlsoChecksum::partialScalar(inBuf, sizeof(inBuf))) !=
+            UlsoChecksum::fold(UlsoChecksum::partialSimd(inBuf, sizeof(inBuf)))){
+        cout << "Checksum mismatch on all ones buffer" << endl;
+        return false;
+    }
+    cout << "Checksum kernels match" << endl;
+    return true;
+}
+
+static int validate(){
+    std::mt19937 rng(1);
+
+    bool ok = validateChecksum(rng) &&
+              validateType<UdpHeader, IPv4Header>(rng) &&
+              validateType<TcpHeader, IPv4Header>(rng) &&
+              validateType<UdpHeader, IPv6Header>(rng) &&
+              validateType<TcpHeader, IPv6Header>(rng);
+    cout << (ok ? "PASS" : "FAIL") << endl;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+template<typename Transport, typename Internet>
+static void benchType(size_t segmentSize, size_t payloadSize, unsigned int iterations){
+    using Clock = std::chrono::steady_clock;
+    UlsoPacket<Transport, Internet> p(segmentSize, payloadSize, false);
+    vector<UlsoEngine::Segment> segments;
+    size_t inSize = p.asArray(inBuf);
+
+    for(auto checksum: {UlsoEngine::Checksum::Scalar, UlsoEngine::Checksum::Simd}){
+        UlsoEngine engine(false, checksum);
+        auto start = Clock::now();
+        for(unsigned int i = 0; i < iterations; i++){
+            engine.segment(inBuf, inSize, outBuf, sizeof(outBuf), segments);
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        cout << Internet().name() << " " << Transport().name() << " "
+             << (checksum == UlsoEngine::Checksum::Simd ? "simd  " : "scalar") << ": "
+             << segments.size() << " segments, " << ns / iterations << " ns/packet, "
+             << ns / iterations / segments.size() << " ns/segment, "
+             << payloadSize * 8.0 * iterations / ns << " Gbps" << endl;
+    }
+}
+
+static void benchChecksum(size_t len, unsigned int iterations){
+    using Clock = std::chrono::steady_clock;
+    volatile uint16_t sink;
+
+    for(size_t i = 0; i < len; i++){
+        inBuf[i] = static_cast<uint8_t>(i);
+    }
+    auto start = Clock::now();
+    for(unsigned int i = 0; i < iterations; i++){
+        sink = UlsoChecksum::fold(UlsoChecksum::partialScalar(inBuf, len));
+    }
+    double scalarNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    start = Clock::now();
+    for(unsigned int i = 0; i < iterations; i++){
+        sink = UlsoChecksum::fold(UlsoChecksum::partialSimd(inBuf, len));
+    }
+    double simdNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    (void)sink;
+    cout << "Checksum " << len << " bytes: scalar " << len * iterations / scalarNs << " GB/s, simd "
+         << len * iterations / simdNs << " GB/s" << endl;
+}
+
+static int bench(size_t segmentSize, size_t payloadSize, unsigned int iterations){
+    benchChecksum(payloadSize, iterations);
+    benchType<UdpHeader, IPv4Header>(segmentSize, payloadSize, iterations);
+    benchType<TcpHeader, IPv4Header>(segmentSize, payloadSize, iterations);
+    benchType<UdpHeader, IPv6Header>(segmentSize, payloadSize, iterations);
+    benchType<TcpHeader, IPv6Header>(segmentSize, payloadSize, iterations);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+    string mode = argc > 1 ? argv[1] : "validate";
+
+    if(mode == "validate"){
+        return validate();
+    }
+    if(mode == "bench"){
+        size_t segmentSize = argc > 2 ? std::stoul(argv[2]) : 1460;
+        size_t payloadSize = argc > 3 ? std::stoul(argv[3]) : 64000;
+        unsigned int iterations = argc > 4 ? std::stoul(argv[4]) : 2000;
+        return bench(segmentSize, payloadSize, iterations);
+    }
+    cout << "Usage: " << argv[0] << " [validate | bench [segment size] [payload size] [iterations]]" << endl;
+    return EXIT_FAILURE;
+}
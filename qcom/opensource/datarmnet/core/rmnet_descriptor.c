@@ -638,6 +638,7 @@ static int rmnet_frag_deaggregate_one(struct sk_buff *skb,
 		return -1;
 
 	frag_desc->priority = priority;
+	frag_desc->napi_id = skb_napi_id(skb);
 	pkt_len += sizeof(*maph);
 	if (port->data_format & RMNET_FLAGS_INGRESS_MAP_CKSUMV4) {
 		pkt_len += sizeof(struct rmnet_map_dl_csum_trailer);
@@ -993,6 +994,7 @@ skip_frags:
 
 	/* Propagate original priority value */
 	head_skb->priority = frag_desc->priority;
+	rmnet_map_set_napi_id(head_skb, frag_desc->napi_id);
 
 	if (trace_print_tcp_rx_enabled()) {
 		char saddr[INET6_ADDRSTRLEN], daddr[INET6_ADDRSTRLEN];
@@ -42,6 +42,7 @@ struct rmnet_frag_descriptor {
 	u32 len;
 	u32 hash;
 	u32 priority;
+	unsigned int napi_id;
 	__be32 tcp_seq;
 	__be16 ip_id;
 	__be16 tcp_flags;
@@ -15,6 +15,7 @@
 #define _RMNET_MAP_H_
 
 #include <linux/skbuff.h>
+#include <net/busy_poll.h>
 #include "rmnet_config.h"
 
 struct rmnet_map_control_command {
@@ -232,6 +233,17 @@ static inline unsigned char *rmnet_map_data_ptr(struct sk_buff *skb)
 	return skb->data;
 }
 
+/* Carry the NAPI id of the HW buffer over to the packets built from it,
+ * so SO_BUSY_POLL sockets can find and poll the IPA NAPI.
+ */
+static inline void rmnet_map_set_napi_id(struct sk_buff *skb,
+					 unsigned int napi_id)
+{
+#ifdef CONFIG_NET_RX_BUSY_POLL
+	skb->napi_id = napi_id;
+#endif
+}
+
 static inline struct rmnet_map_control_command *
 rmnet_map_get_cmd_start(struct sk_buff *skb)
 {
@@ -400,6 +400,7 @@ struct sk_buff *rmnet_map_deaggregate(struct sk_buff *skb,
 	}
 
 	skbn->priority = skb->priority;
+	rmnet_map_set_napi_id(skbn, skb_napi_id(skb));
 	pskb_pull(skb, packet_len);
 
 	return skbn;
@@ -867,6 +868,7 @@ __rmnet_map_segment_coal_skb(struct sk_buff *coal_skb,
 
 	/* Propagate priority value */
 	skbn->priority = coal_skb->priority;
+	rmnet_map_set_napi_id(skbn, skb_napi_id(coal_skb));
 
 	__skb_queue_tail(list, skbn);
 
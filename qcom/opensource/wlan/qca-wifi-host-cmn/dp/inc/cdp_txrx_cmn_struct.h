@@ -2403,6 +2403,20 @@ struct cdp_rx_indication_ppdu {
 #endif
 };
 
+/**
+ * struct cdp_rx_indication_ppdu_batch - Vector of Rx PPDU indications
+ * @num_ppdu: number of valid entries in @ppdu
+ * @ppdu: array of PPDU indications collected in one status ring pass
+ *
+ * Delivered with WDI_EVENT_RX_PPDU_DESC_BATCH. The array is owned by the
+ * datapath and is reused once the event returns, subscribers must copy
+ * out whatever they need to keep.
+ */
+struct cdp_rx_indication_ppdu_batch {
+	uint32_t num_ppdu;
+	struct cdp_rx_indication_ppdu *ppdu;
+};
+
 /**
  * struct cdp_rx_indication_msdu - Rx MSDU info
  * @ppdu_id: PPDU to which the MSDU belongs
@@ -231,6 +231,19 @@ enum {
  * @dest_ppdu_drop: Number of ppdu dropped from monitor destination ring
  * @mon_link_desc_invalid: msdu link desc invalid count
  * @mon_rx_desc_invalid: rx_desc invalid count
+ * @mon_nbuf_sanity_err: status nbuf sanity check failure count
+ * @status_ring_overrun: status ring reaps which found every posted
+ *  buffer filled, HW had caught up with SW and had nothing left to DMA into
+ * @status_quota_exhausted: status ring reaps which ran out of quota with
+ *  completed entries left on the ring
+ * @status_dma_not_done: status ring reaps which spent their quota waiting
+ *  for the DMA done bit of the next entry
+ * @ppdu_batch_flush: number of PPDU indication vectors delivered
+ * @ppdu_batch_overrun: vectors flushed early because the batch was full
+ * @ppdu_batch_nbuf_alloc_fail: batched PPDU indications not delivered to
+ *  WDI_EVENT_RX_PPDU_DESC subscribers because their nbuf alloc failed
+ * @status_buf_recycled: status buffers returned to the recycle pool
+ * @status_buf_pool_miss: status buffer replenish that missed the pool
  */
 struct cdp_pdev_mon_stats {
 #ifndef REMOVE_MON_DBG_STATS
@@ -262,5 +275,13 @@ struct cdp_pdev_mon_stats {
 	uint32_t mon_link_desc_invalid;
 	uint32_t mon_rx_desc_invalid;
 	uint32_t mon_nbuf_sanity_err;
+	uint32_t status_ring_overrun;
+	uint32_t status_quota_exhausted;
+	uint32_t status_dma_not_done;
+	uint32_t ppdu_batch_flush;
+	uint32_t ppdu_batch_overrun;
+	uint32_t ppdu_batch_nbuf_alloc_fail;
+	uint32_t status_buf_recycled;
+	uint32_t status_buf_pool_miss;
 };
 #endif
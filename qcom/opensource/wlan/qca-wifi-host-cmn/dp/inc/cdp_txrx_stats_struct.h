@@ -572,6 +572,9 @@ enum WDI_EVENT {
 #endif
 #ifdef WLAN_FEATURE_11BE_MLO
 	WDI_EVENT_MLO_TSTMP,
+#endif
+#ifdef DP_MON_PPDU_BATCH
+	WDI_EVENT_RX_PPDU_DESC_BATCH,
 #endif
 	/* End of new event items */
 	WDI_EVENT_LAST
@@ -287,7 +287,8 @@ void dp_tx_process_htt_completion_be(struct dp_soc *soc,
 						peer,
 						qdf_nbuf_len(tx_desc->nbuf),
 						tx_status,
-						pdev->enhanced_stats_en);
+						pdev->enhanced_stats_en,
+						ring_id);
 
 		dp_tx_comp_process_tx_status(soc, tx_desc, &ts, peer, ring_id);
 		dp_tx_comp_process_desc(soc, tx_desc, &ts, peer);
@@ -769,6 +769,119 @@ void DP_PRINT_STATS(const char *fmt, ...);
 #define DP_STATS_AGGR_PKT(_handle_a, _handle_b, _field)
 #endif
 
+#if defined(DP_PEER_RING_STATS) && !defined(DISABLE_DP_STATS)
+/**
+ * dp_peer_ring_stats_init() - initialize the per ring peer stats shadow
+ * @peer: DP peer handle
+ *
+ * Return: None
+ */
+static inline void dp_peer_ring_stats_init(struct dp_peer *peer)
+{
+	qdf_spinlock_create(&peer->ring_stats.lock);
+}
+
+/**
+ * dp_peer_ring_stats_deinit() - deinitialize the per ring peer stats shadow
+ * @peer: DP peer handle
+ *
+ * Return: None
+ */
+static inline void dp_peer_ring_stats_deinit(struct dp_peer *peer)
+{
+	qdf_spinlock_destroy(&peer->ring_stats.lock);
+}
+
+/**
+ * dp_peer_rx_ring_stats_update() - account one rx MSDU on its REO ring
+ * @peer: DP peer handle
+ * @ring_id: REO destination ring the MSDU was reaped from
+ * @len: MSDU length
+ * @is_not_amsdu: MSDU was not part of an AMSDU
+ * @is_retry: MSDU had the retry bit set
+ *
+ * Return: None
+ */
+static inline void
+dp_peer_rx_ring_stats_update(struct dp_peer *peer, uint8_t ring_id,
+			     uint32_t len, bool is_not_amsdu, bool is_retry)
+{
+	struct dp_peer_rx_ring_stats *rs = &peer->ring_stats.rx[ring_id];
+
+	rs->rcvd.num++;
+	rs->rcvd.bytes += len;
+	if (is_not_amsdu)
+		rs->non_amsdu_cnt++;
+	else
+		rs->amsdu_cnt++;
+	if (is_retry)
+		rs->rx_retries++;
+}
+
+/**
+ * dp_peer_tx_ring_stats_update() - account one tx completion on its ring
+ * @peer: DP peer handle
+ * @ring_id: tx completion ring the descriptor was reaped from
+ * @length: frame length
+ * @failed: completion carried a failure status
+ *
+ * Return: None
+ */
+static inline void
+dp_peer_tx_ring_stats_update(struct dp_peer *peer, uint8_t ring_id,
+			     uint32_t length, bool failed)
+{
+	struct dp_peer_tx_ring_stats *ts = &peer->ring_stats.tx[ring_id];
+
+	ts->comp_pkt.num++;
+	ts->comp_pkt.bytes += length;
+	if (failed)
+		ts->tx_failed++;
+}
+
+/**
+ * dp_peer_ring_stats_fold() - fold the per ring shadow into peer->stats
+ * @peer: DP peer handle
+ *
+ * Adds what the rings accumulated since the previous fold. Must be called
+ * before peer->stats is read, copied or cleared; the cost is bounded by
+ * the number of rings, not by the traffic.
+ *
+ * Return: None
+ */
+void dp_peer_ring_stats_fold(struct dp_peer *peer);
+#else
+static inline void dp_peer_ring_stats_init(struct dp_peer *peer)
+{
+}
+
+static inline void dp_peer_ring_stats_deinit(struct dp_peer *peer)
+{
+}
+
+static inline void
+dp_peer_rx_ring_stats_update(struct dp_peer *peer, uint8_t ring_id,
+			     uint32_t len, bool is_not_amsdu, bool is_retry)
+{
+	DP_STATS_INC_PKT(peer, rx.rcvd_reo[ring_id], 1, len);
+	DP_STATS_INCC(peer, rx.non_amsdu_cnt, 1, is_not_amsdu);
+	DP_STATS_INCC(peer, rx.amsdu_cnt, 1, !is_not_amsdu);
+	DP_STATS_INCC(peer, rx.rx_retries, 1, is_retry);
+}
+
+static inline void
+dp_peer_tx_ring_stats_update(struct dp_peer *peer, uint8_t ring_id,
+			     uint32_t length, bool failed)
+{
+	DP_STATS_INC_PKT(peer, tx.comp_pkt, 1, length);
+	DP_STATS_INCC(peer, tx.tx_failed, 1, failed);
+}
+
+static inline void dp_peer_ring_stats_fold(struct dp_peer *peer)
+{
+}
+#endif
+
 #if defined(QCA_VDEV_STATS_HW_OFFLOAD_SUPPORT) && \
 	defined(QCA_ENHANCED_STATS_SUPPORT)
 #define DP_PEER_TO_STACK_INCC_PKT(_handle, _count, _bytes, _cond) \
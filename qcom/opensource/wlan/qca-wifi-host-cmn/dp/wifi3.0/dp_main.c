@@ -2159,6 +2159,10 @@ QDF_STATUS dp_srng_init(struct dp_soc *soc, struct dp_srng *srng,
 
 	dp_srng_set_nf_thresholds(soc, srng, &ring_params);
 
+	srng->intr_timer_thres_us = ring_params.intr_timer_thres_us;
+	srng->intr_batch_cntr_thres_entries =
+		ring_params.intr_batch_cntr_thres_entries;
+
 	if (srng->cached)
 		ring_params.flags |= HAL_SRNG_CACHED_DESC;
 
@@ -3115,6 +3119,78 @@ static void dp_soc_interrupt_detach(struct cdp_soc_t *txrx_soc)
 		    DP_MON_INVALID_LMAC_ID);
 }
 
+/*
+ * dp_intr_moderation_scale() - Scale the configured interrupt thresholds
+ *				of a ring and program them
+ * @soc: DP SOC handle
+ * @srng: DP srng
+ * @timer_pct: timer threshold in percent of the configured value
+ * @batch_pct: batch counter threshold in percent of the configured value
+ *
+ * A threshold configured as 0 (disabled) stays disabled at every level.
+ *
+ * Return: none
+ */
+static void dp_intr_moderation_scale(struct dp_soc *soc, struct dp_srng *srng,
+				     uint32_t timer_pct, uint32_t batch_pct)
+{
+	uint32_t timer_us = srng->intr_timer_thres_us * timer_pct / 100;
+	uint32_t batch_cnt = srng->intr_batch_cntr_thres_entries *
+			     batch_pct / 100;
+
+	if (srng->intr_timer_thres_us && !timer_us)
+		timer_us = 1;
+	if (srng->intr_batch_cntr_thres_entries && !batch_cnt)
+		batch_cnt = 1;
+
+	hal_srng_set_intr_thresholds(soc->hal_soc, srng->hal_srng,
+				     timer_us, batch_cnt);
+}
+
+/*
+ * dp_intr_moderation_update() - Program interrupt moderation of the REO
+ *				 destination and TX completion rings of an
+ *				 interrupt context
+ * @dp_ctx: DP interrupt context
+ * @timer_pct: timer threshold in percent of each ring's configured value
+ * @batch_pct: batch counter threshold in percent of each ring's configured
+ *	       value
+ *
+ * Registered with HIF, which calls it from the poll context of the group
+ * when its adaptive moderation level changes. Each ring is scaled from the
+ * thresholds it was set up with in dp_srng_init(), so level 0 (100 percent)
+ * restores exactly the per ring type configuration.
+ *
+ * Return: none
+ */
+static void dp_intr_moderation_update(void *dp_ctx, uint32_t timer_pct,
+				      uint32_t batch_pct)
+{
+	struct dp_intr *int_ctx = (struct dp_intr *)dp_ctx;
+	struct dp_soc *soc = int_ctx->soc;
+	uint8_t tx_mask = int_ctx->tx_ring_mask;
+	uint8_t rx_mask = int_ctx->rx_ring_mask;
+	int i;
+
+	if (int_ctx->rx_near_full_grp_1_mask |
+	    int_ctx->rx_near_full_grp_2_mask |
+	    int_ctx->tx_ring_near_full_mask)
+		return;
+
+	for (i = 0; rx_mask && i < soc->num_reo_dest_rings; i++) {
+		if (rx_mask & (1 << i))
+			dp_intr_moderation_scale(soc, &soc->reo_dest_ring[i],
+						 timer_pct, batch_pct);
+	}
+
+	for (i = 0; tx_mask && i < soc->num_tcl_data_rings; i++) {
+		if ((1 << wlan_cfg_get_wbm_ring_num_for_index(soc->wlan_cfg_ctx,
+							       i)) & tx_mask)
+			dp_intr_moderation_scale(soc, &soc->tx_comp_ring[i],
+						 timer_pct, batch_pct);
+	}
+}
+
 /*
  * dp_soc_interrupt_attach() - Register handlers for DP interrupts
  * @txrx_soc: DP SOC handle
@@ -3233,6 +3309,8 @@ static QDF_STATUS dp_soc_interrupt_attach(struct cdp_soc_t *txrx_soc)
 		}
 	}
 
+	hif_exec_register_moderation_cb(soc->hif_handle,
+					dp_intr_moderation_update);
 	hif_configure_ext_group_interrupts(soc->hif_handle);
 	if (rx_err_ring_intr_ctxt_id != HIF_MAX_GROUP)
 		hif_config_irq_clear_cpu_affinity(soc->hif_handle,
@@ -6867,6 +6945,7 @@ dp_peer_create_wifi3(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
 		dp_local_peer_id_alloc(pdev, peer);
 
 		qdf_spinlock_create(&peer->peer_info_lock);
+		dp_peer_ring_stats_init(peer);
 		dp_peer_rx_bufq_resources_init(peer);
 
 		DP_STATS_INIT(peer);
@@ -6931,6 +7010,7 @@ dp_peer_create_wifi3(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
 	qdf_spinlock_create(&peer->peer_state_lock);
 	dp_peer_add_ast(soc, peer, peer_mac_addr, ast_type, 0);
 	qdf_spinlock_create(&peer->peer_info_lock);
+	dp_peer_ring_stats_init(peer);
 	dp_wds_ext_peer_init(peer);
 	dp_peer_hw_txrx_stats_init(soc, peer);
 	dp_peer_rx_bufq_resources_init(peer);
@@ -8030,6 +8110,7 @@ static QDF_STATUS dp_peer_delete_wifi3(struct cdp_soc_t *soc_hdl,
 	dp_peer_rx_bufq_resources_deinit(peer);
 
 	qdf_spinlock_destroy(&peer->peer_info_lock);
+	dp_peer_ring_stats_deinit(peer);
 	dp_peer_multipass_list_remove(peer);
 
 	/* remove the reference to the peer from the hash table */
@@ -8777,6 +8858,7 @@ dp_txrx_host_peer_stats_clr(struct dp_soc *soc,
 		DP_STATS_CLR(rx_tid);
 	}
 
+	dp_peer_ring_stats_fold(peer);
 	DP_STATS_CLR(peer);
 
 	dp_txrx_host_peer_ext_stats_clr(peer);
@@ -10077,6 +10159,7 @@ dp_txrx_get_peer_stats(struct cdp_soc_t *soc, uint8_t vdev_id,
 	if (!peer)
 		return QDF_STATUS_E_FAILURE;
 
+	dp_peer_ring_stats_fold(peer);
 	qdf_mem_copy(peer_stats, &peer->stats,
 		     sizeof(struct cdp_peer_stats));
 
@@ -10185,6 +10268,8 @@ dp_txrx_reset_peer_stats(struct cdp_soc_t *soc, uint8_t vdev_id,
 	if (!peer)
 		return QDF_STATUS_E_FAILURE;
 
+	/* Absorb what the rings counted so far before clearing */
+	dp_peer_ring_stats_fold(peer);
 	qdf_mem_zero(&peer->stats, sizeof(peer->stats));
 
 	dp_peer_unref_delete(peer, DP_MOD_ID_CDP);
@@ -2779,6 +2779,7 @@ dp_rx_peer_unmap_handler(struct dp_soc *soc, uint16_t peer_id,
 	}
 
 	vdev = peer->vdev;
+	dp_peer_ring_stats_fold(peer);
 	DP_UPDATE_STATS(vdev, peer);
 
 	dp_peer_update_state(soc, peer, DP_PEER_STATE_INACTIVE);
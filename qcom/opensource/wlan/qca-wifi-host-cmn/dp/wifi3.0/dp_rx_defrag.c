@@ -646,6 +646,129 @@ static void dp_rx_defrag_michdr(const struct ieee80211_frame *wh0,
 	hdr[13] = hdr[14] = hdr[15] = 0;	/* reserved */
 }
 
+/**
+ * struct dp_rx_michael_state - running Michael MIC state
+ * @l: left half of the Michael state
+ * @r: right half of the Michael state
+ * @carry: bytes of an incomplete word left at a buffer boundary
+ * @carry_len: number of valid bytes in @carry
+ */
+struct dp_rx_michael_state {
+	uint32_t l;
+	uint32_t r;
+	uint32_t carry;
+	uint8_t carry_len;
+};
+
+/*
+ * dp_rx_michael_init(): Initialize the Michael state with the key
+ * @s: Michael state
+ * @key: Pointer to the 8 byte Michael key
+ *
+ * Returns: None
+ */
+static inline void dp_rx_michael_init(struct dp_rx_michael_state *s,
+				      const uint8_t *key)
+{
+	s->l = dp_rx_get_le32(key);
+	s->r = dp_rx_get_le32(key + 4);
+	s->carry = 0;
+	s->carry_len = 0;
+}
+
+/*
+ * dp_rx_michael_update(): Feed a contiguous byte range to Michael
+ * @s: Michael state
+ * @data: Pointer to the data
+ * @len: Length of the data
+ *
+ * Words are consumed straight from the buffer, four at a time when the
+ * pointer is word aligned. Bytes of a word split across two buffers are
+ * carried in @s until the next call completes it, so a fragment chain
+ * can be fed one buffer at a time without copying it.
+ *
+ * Returns: None
+ */
+static void dp_rx_michael_update(struct dp_rx_michael_state *s,
+				 const uint8_t *data, uint32_t len)
+{
+	uint32_t l, r;
+
+	/* complete the word left over from the previous buffer */
+	while (s->carry_len && len) {
+		s->carry |= (uint32_t)(*data++) << (8 * s->carry_len);
+		len--;
+		if (++s->carry_len == sizeof(uint32_t)) {
+			s->l ^= s->carry;
+			dp_rx_michael_block(s->l, s->r);
+			s->carry = 0;
+			s->carry_len = 0;
+		}
+	}
+
+	l = s->l;
+	r = s->r;
+
+	if (!((uintptr_t)data & (sizeof(uint32_t) - 1))) {
+		const uint32_t *w = (const uint32_t *)data;
+
+		while (len >= 4 * sizeof(uint32_t)) {
+			l ^= qdf_le32_to_cpu(w[0]);
+			dp_rx_michael_block(l, r);
+			l ^= qdf_le32_to_cpu(w[1]);
+			dp_rx_michael_block(l, r);
+			l ^= qdf_le32_to_cpu(w[2]);
+			dp_rx_michael_block(l, r);
+			l ^= qdf_le32_to_cpu(w[3]);
+			dp_rx_michael_block(l, r);
+			w += 4;
+			len -= 4 * sizeof(uint32_t);
+		}
+
+		while (len >= sizeof(uint32_t)) {
+			l ^= qdf_le32_to_cpu(*w++);
+			dp_rx_michael_block(l, r);
+			len -= sizeof(uint32_t);
+		}
+		data = (const uint8_t *)w;
+	} else {
+		while (len >= sizeof(uint32_t)) {
+			l ^= dp_rx_get_le32(data);
+			dp_rx_michael_block(l, r);
+			data += sizeof(uint32_t);
+			len -= sizeof(uint32_t);
+		}
+	}
+
+	s->l = l;
+	s->r = r;
+
+	/* stash the tail, it is completed by the next buffer */
+	while (len--) {
+		s->carry |= (uint32_t)(*data++) << (8 * s->carry_len);
+		s->carry_len++;
+	}
+}
+
+/*
+ * dp_rx_michael_final(): Pad the message and produce the MIC
+ * @s: Michael state
+ * @mic: Array to hold the 8 byte MIC
+ *
+ * Returns: None
+ */
+static void dp_rx_michael_final(struct dp_rx_michael_state *s, uint8_t mic[])
+{
+	uint32_t l = s->l, r = s->r;
+
+	/* Last block and padding (0x5a, 4..7 x 0) */
+	l ^= s->carry | ((uint32_t)0x5a << (8 * s->carry_len));
+	dp_rx_michael_block(l, r);
+	dp_rx_michael_block(l, r);
+	dp_rx_put_le32(mic, l);
+	dp_rx_put_le32(mic + 4, r);
+}
+
 /*
  * dp_rx_defrag_mic(): Calculate MIC header
  * @key: Pointer to the key
@@ -654,7 +777,8 @@ static void dp_rx_defrag_michdr(const struct ieee80211_frame *wh0,
  * @data_len: Data length
  * @mic: Array to hold MIC
  *
- * Calculate a pseudo MIC header
+ * Calculate the Michael MIC over the fragment chain in a single pass,
+ * feeding each fragment's payload in place.
  *
  * Returns: QDF_STATUS
  */
@@ -663,111 +787,31 @@ static QDF_STATUS dp_rx_defrag_mic(struct dp_soc *soc, const uint8_t *key,
 				   uint16_t data_len, uint8_t mic[])
 {
 	uint8_t hdr[16] = { 0, };
-	uint32_t l, r;
-	const uint8_t *data;
+	struct dp_rx_michael_state s;
 	uint32_t space;
 	int rx_desc_len = soc->rx_pkt_tlv_size;
 
 	dp_rx_defrag_michdr((struct ieee80211_frame *)(qdf_nbuf_data(wbuf)
 		+ rx_desc_len), hdr);
 
-	l = dp_rx_get_le32(key);
-	r = dp_rx_get_le32(key + 4);
-
 	/* Michael MIC pseudo header: DA, SA, 3 x 0, Priority */
-	l ^= dp_rx_get_le32(hdr);
-	dp_rx_michael_block(l, r);
-	l ^= dp_rx_get_le32(&hdr[4]);
-	dp_rx_michael_block(l, r);
-	l ^= dp_rx_get_le32(&hdr[8]);
-	dp_rx_michael_block(l, r);
-	l ^= dp_rx_get_le32(&hdr[12]);
-	dp_rx_michael_block(l, r);
+	dp_rx_michael_init(&s, key);
+	dp_rx_michael_update(&s, hdr, sizeof(hdr));
 
-	/* first buffer has special handling */
-	data = (uint8_t *)qdf_nbuf_data(wbuf) + off;
-	space = qdf_nbuf_len(wbuf) - off;
+	while (data_len) {
+		if (!wbuf || qdf_nbuf_len(wbuf) < off)
+			return QDF_STATUS_E_DEFRAG_ERROR;
 
-	for (;; ) {
+		space = qdf_nbuf_len(wbuf) - off;
 		if (space > data_len)
 			space = data_len;
 
-		/* collect 32-bit blocks from current buffer */
-		while (space >= sizeof(uint32_t)) {
-			l ^= dp_rx_get_le32(data);
-			dp_rx_michael_block(l, r);
-			data += sizeof(uint32_t);
-			space -= sizeof(uint32_t);
-			data_len -= sizeof(uint32_t);
-		}
-		if (data_len < sizeof(uint32_t))
-			break;
-
+		dp_rx_michael_update(&s, qdf_nbuf_data(wbuf) + off, space);
+		data_len -= space;
 		wbuf = qdf_nbuf_next(wbuf);
-		if (!wbuf)
-			return QDF_STATUS_E_DEFRAG_ERROR;
-
-		if (space != 0) {
-			const uint8_t *data_next;
-			/*
-			 * Block straddles buffers, split references.
-			 */
-			data_next =
-				(uint8_t *)qdf_nbuf_data(wbuf) + off;
-			if ((qdf_nbuf_len(wbuf)) <
-				sizeof(uint32_t) - space) {
-				return QDF_STATUS_E_DEFRAG_ERROR;
-			}
-			switch (space) {
-			case 1:
-				l ^= dp_rx_get_le32_split(data[0],
-					data_next[0], data_next[1],
-					data_next[2]);
-				data = data_next + 3;
-				space = (qdf_nbuf_len(wbuf) - off) - 3;
-				break;
-			case 2:
-				l ^= dp_rx_get_le32_split(data[0], data[1],
-						    data_next[0], data_next[1]);
-				data = data_next + 2;
-				space = (qdf_nbuf_len(wbuf) - off) - 2;
-				break;
-			case 3:
-				l ^= dp_rx_get_le32_split(data[0], data[1],
-					data[2], data_next[0]);
-				data = data_next + 1;
-				space = (qdf_nbuf_len(wbuf) - off) - 1;
-				break;
-			}
-			dp_rx_michael_block(l, r);
-			data_len -= sizeof(uint32_t);
-		} else {
-			/*
-			 * Setup for next buffer.
-			 */
-			data = (uint8_t *)qdf_nbuf_data(wbuf) + off;
-			space = qdf_nbuf_len(wbuf) - off;
-		}
-	}
-	/* Last block and padding (0x5a, 4..7 x 0) */
-	switch (data_len) {
-	case 0:
-		l ^= dp_rx_get_le32_split(0x5a, 0, 0, 0);
-		break;
-	case 1:
-		l ^= dp_rx_get_le32_split(data[0], 0x5a, 0, 0);
-		break;
-	case 2:
-		l ^= dp_rx_get_le32_split(data[0], data[1], 0x5a, 0);
-		break;
-	case 3:
-		l ^= dp_rx_get_le32_split(data[0], data[1], data[2], 0x5a);
-		break;
 	}
-	dp_rx_michael_block(l, r);
-	dp_rx_michael_block(l, r);
-	dp_rx_put_le32(mic, l);
-	dp_rx_put_le32(mic + 4, r);
+
+	dp_rx_michael_final(&s, mic);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -1433,6 +1477,43 @@ static QDF_STATUS dp_rx_defrag_gcmp_demic(struct dp_soc *soc, qdf_nbuf_t nbuf,
 	return QDF_STATUS_SUCCESS;
 }
 
+/*
+ * dp_rx_defrag_decap_frag(): Strip the security trailer from a fragment
+ * @soc: Datapath soc structure
+ * @sec_type: Security type of the peer
+ * @nbuf: Pointer to the fragment buffer
+ * @hdrlen: 802.11 header length
+ *
+ * Validate and remove the per fragment security trailer. CCMP and GCMP
+ * payloads have already been decrypted by the target, only the IV and
+ * MIC need to be dropped here.
+ *
+ * Returns: QDF_STATUS
+ */
+static QDF_STATUS dp_rx_defrag_decap_frag(struct dp_soc *soc,
+					  enum cdp_sec_type sec_type,
+					  qdf_nbuf_t nbuf, uint16_t hdrlen)
+{
+	switch (sec_type) {
+	case cdp_sec_type_tkip:
+	case cdp_sec_type_tkip_nomic:
+		return dp_rx_defrag_tkip_decap(soc, nbuf, hdrlen);
+	case cdp_sec_type_aes_ccmp:
+		if (dp_rx_defrag_ccmp_demic(soc, nbuf, hdrlen))
+			return QDF_STATUS_E_DEFRAG_ERROR;
+		return dp_rx_defrag_ccmp_decap(soc, nbuf, hdrlen);
+	case cdp_sec_type_wep40:
+	case cdp_sec_type_wep104:
+	case cdp_sec_type_wep128:
+		return dp_rx_defrag_wep_decap(soc, nbuf, hdrlen);
+	case cdp_sec_type_aes_gcmp:
+	case cdp_sec_type_aes_gcmp_256:
+		return dp_rx_defrag_gcmp_demic(soc, nbuf, hdrlen);
+	default:
+		return QDF_STATUS_SUCCESS;
+	}
+}
+
 /*
  * dp_rx_defrag(): Defragment the fragment chain
  * @peer: Pointer to the peer
@@ -1447,9 +1528,9 @@ static QDF_STATUS dp_rx_defrag_gcmp_demic(struct dp_soc *soc, qdf_nbuf_t nbuf,
 static QDF_STATUS dp_rx_defrag(struct dp_peer *peer, unsigned tid,
 			qdf_nbuf_t frag_list_head, qdf_nbuf_t frag_list_tail)
 {
-	qdf_nbuf_t tmp_next, prev;
 	qdf_nbuf_t cur = frag_list_head, msdu;
 	uint32_t index, tkip_demic = 0;
+	enum cdp_sec_type sec_type;
 	uint16_t hdr_space;
 	uint8_t key[DEFRAG_IEEE80211_KEY_LEN];
 	struct dp_vdev *vdev = peer->vdev;
@@ -1463,102 +1544,43 @@ static QDF_STATUS dp_rx_defrag(struct dp_peer *peer, unsigned tid,
 	index = hal_rx_msdu_is_wlan_mcast(soc->hal_soc, cur) ?
 		dp_sec_mcast : dp_sec_ucast;
 
-	/* Remove FCS from all fragments */
-	while (cur) {
-		tmp_next = qdf_nbuf_next(cur);
-		qdf_nbuf_set_next(cur, NULL);
-		qdf_nbuf_trim_tail(cur, DEFRAG_IEEE80211_FCS_LEN);
-		prev = cur;
-		qdf_nbuf_set_next(cur, tmp_next);
-		cur = tmp_next;
-	}
-	cur = frag_list_head;
+	sec_type = peer->security[index].sec_type;
 
 	QDF_TRACE(QDF_MODULE_ID_TXRX, QDF_TRACE_LEVEL_DEBUG,
 		  "%s: index %d Security type: %d", __func__,
-		  index, peer->security[index].sec_type);
+		  index, sec_type);
+
+	/* Remove FCS and the security trailer in one walk of the chain */
+	while (cur) {
+		qdf_nbuf_trim_tail(cur, DEFRAG_IEEE80211_FCS_LEN);
+		if (dp_rx_defrag_decap_frag(soc, sec_type, cur, hdr_space)) {
+			QDF_TRACE(QDF_MODULE_ID_TXRX, QDF_TRACE_LEVEL_ERROR,
+				  "dp_rx_defrag: decap failed sec_type %d",
+				  sec_type);
 
-	switch (peer->security[index].sec_type) {
+			return QDF_STATUS_E_DEFRAG_ERROR;
+		}
+		cur = qdf_nbuf_next(cur);
+	}
+
+	/* If success, increment header to be stripped later */
+	switch (sec_type) {
 	case cdp_sec_type_tkip:
 		tkip_demic = 1;
 		fallthrough;
 	case cdp_sec_type_tkip_nomic:
-		while (cur) {
-			tmp_next = qdf_nbuf_next(cur);
-			if (dp_rx_defrag_tkip_decap(soc, cur, hdr_space)) {
-
-				QDF_TRACE(QDF_MODULE_ID_TXRX,
-					QDF_TRACE_LEVEL_ERROR,
-					"dp_rx_defrag: TKIP decap failed");
-
-				return QDF_STATUS_E_DEFRAG_ERROR;
-			}
-			cur = tmp_next;
-		}
-
-		/* If success, increment header to be stripped later */
 		hdr_space += dp_f_tkip.ic_header;
 		break;
-
 	case cdp_sec_type_aes_ccmp:
-		while (cur) {
-			tmp_next = qdf_nbuf_next(cur);
-			if (dp_rx_defrag_ccmp_demic(soc, cur, hdr_space)) {
-
-				QDF_TRACE(QDF_MODULE_ID_TXRX,
-					QDF_TRACE_LEVEL_ERROR,
-					"dp_rx_defrag: CCMP demic failed");
-
-				return QDF_STATUS_E_DEFRAG_ERROR;
-			}
-			if (dp_rx_defrag_ccmp_decap(soc, cur, hdr_space)) {
-
-				QDF_TRACE(QDF_MODULE_ID_TXRX,
-					QDF_TRACE_LEVEL_ERROR,
-					"dp_rx_defrag: CCMP decap failed");
-
-				return QDF_STATUS_E_DEFRAG_ERROR;
-			}
-			cur = tmp_next;
-		}
-
-		/* If success, increment header to be stripped later */
 		hdr_space += dp_f_ccmp.ic_header;
 		break;
-
 	case cdp_sec_type_wep40:
 	case cdp_sec_type_wep104:
 	case cdp_sec_type_wep128:
-		while (cur) {
-			tmp_next = qdf_nbuf_next(cur);
-			if (dp_rx_defrag_wep_decap(soc, cur, hdr_space)) {
-
-				QDF_TRACE(QDF_MODULE_ID_TXRX,
-					QDF_TRACE_LEVEL_ERROR,
-					"dp_rx_defrag: WEP decap failed");
-
-				return QDF_STATUS_E_DEFRAG_ERROR;
-			}
-			cur = tmp_next;
-		}
-
-		/* If success, increment header to be stripped later */
 		hdr_space += dp_f_wep.ic_header;
 		break;
 	case cdp_sec_type_aes_gcmp:
 	case cdp_sec_type_aes_gcmp_256:
-		while (cur) {
-			tmp_next = qdf_nbuf_next(cur);
-			if (dp_rx_defrag_gcmp_demic(soc, cur, hdr_space)) {
-				QDF_TRACE(QDF_MODULE_ID_TXRX,
-					  QDF_TRACE_LEVEL_ERROR,
-					  "dp_rx_defrag: GCMP demic failed");
-
-				return QDF_STATUS_E_DEFRAG_ERROR;
-			}
-			cur = tmp_next;
-		}
-
 		hdr_space += dp_f_gcmp.ic_header;
 		break;
 	default:
@@ -2168,3 +2190,7 @@ QDF_STATUS dp_rx_defrag_add_last_frag(struct dp_soc *soc,
 fail:
 	return QDF_STATUS_E_DEFRAG_ERROR;
 }
+
+#ifdef WLAN_DP_RX_DEFRAG_TEST
+#include "dp_rx_defrag_test.c"
+#endif
@@ -5838,6 +5838,7 @@ void dp_print_peer_stats(struct dp_peer *peer)
 	struct cdp_rx_mu *rx_mu;
 
 	pdev = peer->vdev->pdev;
+	dp_peer_ring_stats_fold(peer);
 
 	DP_PRINT_STATS("Node Tx Stats:\n");
 	DP_PRINT_STATS("Total Packet Completions = %d",
@@ -7125,6 +7126,45 @@ static bool dp_is_wds_extended(struct dp_peer *peer)
 }
 #endif /* QCA_SUPPORT_WDS_EXTENDED */
 
+#if defined(DP_PEER_RING_STATS) && !defined(DISABLE_DP_STATS)
+void dp_peer_ring_stats_fold(struct dp_peer *peer)
+{
+	struct dp_peer_ring_stats *rs = &peer->ring_stats;
+	struct dp_peer_rx_ring_stats rx;
+	struct dp_peer_tx_ring_stats tx;
+	uint8_t i;
+
+	qdf_spin_lock_bh(&rs->lock);
+	for (i = 0; i < CDP_MAX_RX_RINGS; i++) {
+		/* Snapshot once, the ring context keeps counting */
+		rx = rs->rx[i];
+		peer->stats.rx.rcvd_reo[i].num +=
+			rx.rcvd.num - rs->rx_folded[i].rcvd.num;
+		peer->stats.rx.rcvd_reo[i].bytes +=
+			rx.rcvd.bytes - rs->rx_folded[i].rcvd.bytes;
+		peer->stats.rx.non_amsdu_cnt +=
+			rx.non_amsdu_cnt - rs->rx_folded[i].non_amsdu_cnt;
+		peer->stats.rx.amsdu_cnt +=
+			rx.amsdu_cnt - rs->rx_folded[i].amsdu_cnt;
+		peer->stats.rx.rx_retries +=
+			rx.rx_retries - rs->rx_folded[i].rx_retries;
+		rs->rx_folded[i] = rx;
+	}
+
+	for (i = 0; i < CDP_MAX_TX_COMP_RINGS; i++) {
+		tx = rs->tx[i];
+		peer->stats.tx.comp_pkt.num +=
+			tx.comp_pkt.num - rs->tx_folded[i].comp_pkt.num;
+		peer->stats.tx.comp_pkt.bytes +=
+			tx.comp_pkt.bytes - rs->tx_folded[i].comp_pkt.bytes;
+		peer->stats.tx.tx_failed +=
+			tx.tx_failed - rs->tx_folded[i].tx_failed;
+		rs->tx_folded[i] = tx;
+	}
+	qdf_spin_unlock_bh(&rs->lock);
+}
+#endif
+
 void dp_update_vdev_stats(struct dp_soc *soc,
 			  struct dp_peer *srcobj,
 			  void *arg)
@@ -7136,6 +7176,8 @@ void dp_update_vdev_stats(struct dp_soc *soc,
 	if (qdf_unlikely(dp_is_wds_extended(srcobj)))
 		return;
 
+	dp_peer_ring_stats_fold(srcobj);
+
 	for (pream_type = 0; pream_type < DOT11_MAX; pream_type++) {
 		for (i = 0; i < MAX_MCS; i++) {
 			tgtobj->tx.pkt_type[pream_type].
@@ -3718,15 +3718,6 @@ inline void dp_update_no_ack_stats(qdf_nbuf_t nbuf, struct dp_peer *peer,
 		DP_STATS_INC(peer, tx.dropped.invalid_rr, 1);
 		break;
 	}
-
-	/*
-	 * tx_failed is ideally supposed to be updated from HTT ppdu completion
-	 * stats. But in IPQ807X/IPQ6018 chipsets owing to hw limitation there
-	 * are no completions for failed cases. Hence updating tx_failed from
-	 * data path. Please note that if tx_failed is fixed to be from ppdu,
-	 * then this has to be removed
-	 */
-	DP_STATS_INC(peer, tx.tx_failed, 1);
 }
 #endif
 
@@ -3816,7 +3807,16 @@ dp_tx_update_peer_stats(struct dp_tx_desc_s *tx_desc,
 	}
 
 	length = qdf_nbuf_len(tx_desc->nbuf);
-	DP_STATS_INC_PKT(peer, tx.comp_pkt, 1, length);
+
+	/*
+	 * tx_failed is ideally supposed to be updated from HTT ppdu completion
+	 * stats. But in IPQ807X/IPQ6018 chipsets owing to hw limitation there
+	 * are no completions for failed cases. Hence updating tx_failed from
+	 * data path. Please note that if tx_failed is fixed to be from ppdu,
+	 * then this has to be removed
+	 */
+	dp_peer_tx_ring_stats_update(peer, ring_id, length,
+				     ts->status != HAL_TX_TQM_RR_FRAME_ACKED);
 
 	if (qdf_unlikely(pdev->delay_stats_flag) ||
 	    qdf_unlikely(dp_is_vdev_tx_delay_stats_enabled(peer->vdev)))
@@ -4387,36 +4387,37 @@ out:
  * @length: Length of the packet
  * @tx_status: Tx status from TQM/FW
  * @update: enhanced flag value present in dp_pdev
+ * @ring_id: tx completion ring number
  *
  * Return: none
  */
 void dp_tx_update_peer_basic_stats(struct dp_peer *peer, uint32_t length,
-				   uint8_t tx_status, bool update)
+				   uint8_t tx_status, bool update,
+				   uint8_t ring_id)
 {
-	if ((!peer->hw_txrx_stats_en) || update) {
-		DP_STATS_INC_PKT(peer, tx.comp_pkt, 1, length);
-		DP_STATS_INCC(peer, tx.tx_failed, 1,
-			      tx_status != HAL_TX_TQM_RR_FRAME_ACKED);
-	}
+	if ((!peer->hw_txrx_stats_en) || update)
+		dp_peer_tx_ring_stats_update(peer, ring_id, length,
+					     tx_status !=
+					     HAL_TX_TQM_RR_FRAME_ACKED);
 }
 #elif defined(QCA_VDEV_STATS_HW_OFFLOAD_SUPPORT)
 void dp_tx_update_peer_basic_stats(struct dp_peer *peer, uint32_t length,
-				   uint8_t tx_status, bool update)
+				   uint8_t tx_status, bool update,
+				   uint8_t ring_id)
 {
-	if (!peer->hw_txrx_stats_en) {
-		DP_STATS_INC_PKT(peer, tx.comp_pkt, 1, length);
-		DP_STATS_INCC(peer, tx.tx_failed, 1,
-			      tx_status != HAL_TX_TQM_RR_FRAME_ACKED);
-	}
+	if (!peer->hw_txrx_stats_en)
+		dp_peer_tx_ring_stats_update(peer, ring_id, length,
+					     tx_status !=
+					     HAL_TX_TQM_RR_FRAME_ACKED);
 }
 
 #else
 void dp_tx_update_peer_basic_stats(struct dp_peer *peer, uint32_t length,
-				   uint8_t tx_status, bool update)
+				   uint8_t tx_status, bool update,
+				   uint8_t ring_id)
 {
-	DP_STATS_INC_PKT(peer, tx.comp_pkt, 1, length);
-	DP_STATS_INCC(peer, tx.tx_failed, 1,
-		      tx_status != HAL_TX_TQM_RR_FRAME_ACKED);
+	dp_peer_tx_ring_stats_update(peer, ring_id, length,
+				     tx_status != HAL_TX_TQM_RR_FRAME_ACKED);
 }
 #endif
 
@@ -4460,7 +4461,8 @@ dp_tx_comp_process_desc_list(struct dp_soc *soc,
 				dp_tx_update_peer_basic_stats(peer,
 							      desc->length,
 							      desc->tx_status,
-							      false);
+							      false,
+							      ring_id);
 			qdf_assert(pdev);
 			dp_tx_outstanding_dec(pdev);
 
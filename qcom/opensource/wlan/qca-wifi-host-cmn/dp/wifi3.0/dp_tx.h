@@ -257,7 +257,8 @@ void dp_tx_inspect_handler(struct dp_soc *soc,
 			   struct dp_tx_desc_s *tx_desc,
 			   uint8_t *status);
 void dp_tx_update_peer_basic_stats(struct dp_peer *peer, uint32_t length,
-				   uint8_t tx_status, bool update);
+				   uint8_t tx_status, bool update,
+				   uint8_t ring_id);
 
 #ifndef QCA_HOST_MODE_WIFI_DISABLED
 /**
@@ -733,6 +733,9 @@ struct dp_srng {
 	uint8_t cached;
 	int irq;
 	uint32_t num_entries;
+	/* interrupt thresholds the ring was set up with */
+	uint32_t intr_timer_thres_us;
+	uint32_t intr_batch_cntr_thres_entries;
 #ifdef DP_MEM_PRE_ALLOC
 	uint8_t is_mem_prealloc;
 #endif
@@ -3361,6 +3364,54 @@ struct dp_mld_link_peers {
 };
 #endif
 
+#if defined(DP_PEER_RING_STATS) && !defined(DISABLE_DP_STATS)
+/**
+ * struct dp_peer_rx_ring_stats - hot peer rx counters of one REO ring
+ * @rcvd: MSDUs received on the ring
+ * @non_amsdu_cnt: MSDUs with no MSDU level aggregation
+ * @amsdu_cnt: MSDUs part of an AMSDU
+ * @rx_retries: MSDUs with the retry bit set
+ *
+ * A REO ring is reaped from one context at a time, so the counters are
+ * updated without locking and kept on a cache line of their own.
+ */
+struct dp_peer_rx_ring_stats {
+	struct cdp_pkt_info rcvd;
+	uint32_t non_amsdu_cnt;
+	uint32_t amsdu_cnt;
+	uint32_t rx_retries;
+} __attribute__((aligned(QDF_CACHE_LINE_SZ)));
+
+/**
+ * struct dp_peer_tx_ring_stats - hot peer tx counters of one completion ring
+ * @comp_pkt: completions received on the ring
+ * @tx_failed: completions with a failure status
+ */
+struct dp_peer_tx_ring_stats {
+	struct cdp_pkt_info comp_pkt;
+	uint32_t tx_failed;
+} __attribute__((aligned(QDF_CACHE_LINE_SZ)));
+
+/**
+ * struct dp_peer_ring_stats - per ring shadow of the hot peer counters
+ * @rx: counters written from the REO destination ring contexts
+ * @tx: counters written from the tx completion ring contexts
+ * @rx_folded: rx values already folded into dp_peer::stats
+ * @tx_folded: tx values already folded into dp_peer::stats
+ * @lock: serializes dp_peer_ring_stats_fold()
+ *
+ * The per packet paths only touch @rx / @tx of their own ring; the deltas
+ * since the last fold are added to dp_peer::stats when the stats are read.
+ */
+struct dp_peer_ring_stats {
+	struct dp_peer_rx_ring_stats rx[CDP_MAX_RX_RINGS];
+	struct dp_peer_tx_ring_stats tx[CDP_MAX_TX_COMP_RINGS];
+	struct dp_peer_rx_ring_stats rx_folded[CDP_MAX_RX_RINGS];
+	struct dp_peer_tx_ring_stats tx_folded[CDP_MAX_TX_COMP_RINGS];
+	qdf_spinlock_t lock;
+};
+#endif
+
 /* Peer structure for data path state */
 struct dp_peer {
 	/* VDEV to which this peer is associated */
@@ -3422,6 +3473,11 @@ struct dp_peer {
 	/* Peer Stats */
 	struct cdp_peer_stats stats;
 
+#if defined(DP_PEER_RING_STATS) && !defined(DISABLE_DP_STATS)
+	/* Per ring shadow of the hot counters, folded into stats on read */
+	struct dp_peer_ring_stats ring_stats;
+#endif
+
 	/* Peer extended stats */
 	struct cdp_peer_ext_stats *pext_stats;
 
@@ -3593,6 +3649,10 @@ struct dp_fisa_stats {
 	uint32_t invalid_flow_index;
 	uint32_t reo_mismatch;
 	uint32_t incorrect_rdi;
+	/* cold flows evicted from FST to make room for a new flow */
+	uint32_t lru_evict;
+	/* new flows not added as no flow in the skid range was cold */
+	uint32_t lru_evict_skipped;
 };
 
 enum fisa_aggr_ret {
@@ -3601,6 +3661,44 @@ enum fisa_aggr_ret {
 	FISA_FLUSH_FLOW
 };
 
+/**
+ * enum dp_fisa_flush_reason - reason for flushing a FISA aggregate
+ * @DP_FISA_FLUSH_NEW_AGGR: HW started a new aggregation for the flow
+ * @DP_FISA_FLUSH_HW_INVALID: HW aggregation TLVs inconsistent
+ * @DP_FISA_FLUSH_AGGR_LIMIT: adaptive per flow aggregate limit reached
+ * @DP_FISA_FLUSH_GSO_SIZE: msdu size differs from the aggregate gso size
+ * @DP_FISA_FLUSH_NAPI: end of NAPI poll or FISA skipped for the context
+ * @DP_FISA_FLUSH_VDEV: vdev flush or FISA disallowed for the vdev
+ * @DP_FISA_FLUSH_FRAG: fragmented msdu received for the flow
+ * @DP_FISA_FLUSH_EVICT: flow evicted from the flow search table
+ * @DP_FISA_FLUSH_REASON_MAX: max value (size of counters array)
+ */
+enum dp_fisa_flush_reason {
+	DP_FISA_FLUSH_NEW_AGGR,
+	DP_FISA_FLUSH_HW_INVALID,
+	DP_FISA_FLUSH_AGGR_LIMIT,
+	DP_FISA_FLUSH_GSO_SIZE,
+	DP_FISA_FLUSH_NAPI,
+	DP_FISA_FLUSH_VDEV,
+	DP_FISA_FLUSH_FRAG,
+	DP_FISA_FLUSH_EVICT,
+	DP_FISA_FLUSH_REASON_MAX,
+};
+
+/**
+ * enum dp_fisa_rate_class - measured rate class of a FISA flow
+ * @DP_FISA_RATE_CLASS_UNKNOWN: rate not measured yet
+ * @DP_FISA_RATE_CLASS_LOW: low rate, latency sensitive flow
+ * @DP_FISA_RATE_CLASS_MEDIUM: medium rate flow
+ * @DP_FISA_RATE_CLASS_HIGH: high rate bulk flow
+ */
+enum dp_fisa_rate_class {
+	DP_FISA_RATE_CLASS_UNKNOWN,
+	DP_FISA_RATE_CLASS_LOW,
+	DP_FISA_RATE_CLASS_MEDIUM,
+	DP_FISA_RATE_CLASS_HIGH,
+};
+
 /**
  * struct fisa_pkt_hist - FISA Packet history structure
  * @tlv_hist: array of TLV history
@@ -3660,6 +3758,14 @@ struct dp_fisa_rx_sw_ft {
 	uint32_t reo_dest_indication;
 	qdf_time_t flow_init_ts;
 	qdf_time_t last_accessed_ts;
+	/* adaptive aggregation, rate measured over a window */
+	qdf_time_t rate_win_start_ts;
+	uint32_t rate_win_bytes;
+	uint32_t rate_mbps;
+	enum dp_fisa_rate_class rate_class;
+	/* max msdus per aggregate for the current rate class */
+	uint16_t aggr_limit;
+	uint32_t flush_reason[DP_FISA_FLUSH_REASON_MAX];
 #ifdef WLAN_SUPPORT_RX_FISA_HIST
 	struct fisa_pkt_hist pkt_hist;
 #endif
@@ -202,12 +202,11 @@ void dp_tx_process_htt_completion_li(struct dp_soc *soc,
 
 		peer = dp_peer_get_ref_by_id(soc, ts.peer_id,
 					     DP_MOD_ID_HTT_COMP);
-		if (qdf_likely(peer)) {
-			DP_STATS_INC_PKT(peer, tx.comp_pkt, 1,
-					 qdf_nbuf_len(tx_desc->nbuf));
-			DP_STATS_INCC(peer, tx.tx_failed, 1,
-				      tx_status != HTT_TX_FW2WBM_TX_STATUS_OK);
-		}
+		if (qdf_likely(peer))
+			dp_peer_tx_ring_stats_update(
+					peer, ring_id,
+					qdf_nbuf_len(tx_desc->nbuf),
+					tx_status != HTT_TX_FW2WBM_TX_STATUS_OK);
 
 		dp_tx_comp_process_tx_status(soc, tx_desc, &ts, peer, ring_id);
 		dp_tx_comp_process_desc(soc, tx_desc, &ts, peer);
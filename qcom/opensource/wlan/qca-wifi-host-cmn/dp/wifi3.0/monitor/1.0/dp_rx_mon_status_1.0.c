@@ -343,7 +343,7 @@ dp_rx_mon_status_process_tlv(struct dp_soc *soc, struct dp_intr *int_ctx,
 		status_nbuf = qdf_nbuf_queue_remove(&mon_pdev->rx_status_q);
 
 		if (!status_nbuf)
-			return;
+			break;
 
 		rx_tlv = qdf_nbuf_data(status_nbuf);
 		rx_tlv_start = rx_tlv;
@@ -411,14 +411,14 @@ dp_rx_mon_status_process_tlv(struct dp_soc *soc, struct dp_intr *int_ctx,
 						 status_nbuf);
 		} else if (rx_enh_capture_mode != CDP_RX_ENH_CAPTURE_DISABLED) {
 			if (!nbuf_used)
-				qdf_nbuf_free(status_nbuf);
+				dp_rx_mon_status_buf_recycle(pdev, status_nbuf);
 
 			if (tlv_status == HAL_TLV_STATUS_PPDU_DONE)
 				enh_log_status =
 				dp_rx_handle_enh_capture(soc,
 							 pdev, ppdu_info);
 		} else {
-			qdf_nbuf_free(status_nbuf);
+			dp_rx_mon_status_buf_recycle(pdev, status_nbuf);
 		}
 
 		if (tlv_status == HAL_TLV_STATUS_PPDU_NON_STD_DONE) {
@@ -469,7 +469,8 @@ dp_rx_mon_status_process_tlv(struct dp_soc *soc, struct dp_intr *int_ctx,
 			mon_pdev->mon_ppdu_status = DP_PPDU_STATUS_START;
 		}
 	}
-	return;
+
+	dp_rx_mon_ppdu_batch_flush(soc, pdev);
 }
 
 /*
@@ -497,6 +498,7 @@ dp_rx_mon_status_srng_process(struct dp_soc *soc, struct dp_intr *int_ctx,
 	enum dp_mon_reap_status reap_status;
 	uint32_t work_done = 0;
 	struct dp_mon_pdev *mon_pdev;
+	bool dma_not_done = false;
 
 	if (!pdev) {
 		dp_rx_mon_status_debug("%pK: pdev is null for mac_id = %d",
@@ -524,12 +526,16 @@ dp_rx_mon_status_srng_process(struct dp_soc *soc, struct dp_intr *int_ctx,
 	if (qdf_unlikely(dp_srng_access_start(int_ctx, soc, mon_status_srng)))
 		goto done;
 
+	/* HW tail caught up with the SW head, every posted buffer is filled */
+	if (qdf_unlikely(hal_srng_src_num_avail(hal_soc, mon_status_srng, 0) >=
+			 hal_srng_get_num_entries(hal_soc, mon_status_srng) - 1))
+		mon_pdev->rx_mon_stats.status_ring_overrun++;
+
 	/* mon_status_ring_desc => WBM_BUFFER_RING STRUCT =>
 	 * BUFFER_ADDR_INFO STRUCT
 	 */
 	while (qdf_likely((rxdma_mon_status_ring_entry =
-		hal_srng_src_peek_n_get_next(hal_soc, mon_status_srng))
-			&& quota--)) {
+		hal_srng_src_peek_n_get_next(hal_soc, mon_status_srng)))) {
 		struct hal_buf_info hbi;
 		qdf_nbuf_t status_nbuf;
 		struct dp_rx_desc *rx_desc;
@@ -538,6 +544,17 @@ dp_rx_mon_status_srng_process(struct dp_soc *soc, struct dp_intr *int_ctx,
 		uint64_t buf_addr;
 		struct rx_desc_pool *rx_desc_pool;
 
+		if (qdf_unlikely(!quota--)) {
+			/* a DMA stall polls the same entry until the quota
+			 * is spent, account it apart from a busy ring
+			 */
+			if (dma_not_done)
+				mon_pdev->rx_mon_stats.status_dma_not_done++;
+			else
+				mon_pdev->rx_mon_stats.status_quota_exhausted++;
+			break;
+		}
+
 		rx_desc_pool = &soc->rx_desc_status[mac_id];
 		buf_addr =
 			(HAL_RX_BUFFER_ADDR_31_0_GET(
@@ -588,8 +605,10 @@ dp_rx_mon_status_srng_process(struct dp_soc *soc, struct dp_intr *int_ctx,
 				 */
 				reap_status = dp_rx_mon_handle_status_buf_done(pdev,
 									mon_status_srng);
-				if (reap_status == DP_MON_STATUS_NO_DMA)
+				if (reap_status == DP_MON_STATUS_NO_DMA) {
+					dma_not_done = true;
 					continue;
+				}
 				else if (reap_status == DP_MON_STATUS_REPLENISH) {
 					if (!rx_desc->unmapped) {
 						qdf_nbuf_unmap_nbytes_single(
@@ -598,7 +617,8 @@ dp_rx_mon_status_srng_process(struct dp_soc *soc, struct dp_intr *int_ctx,
 							rx_desc_pool->buf_size);
 						rx_desc->unmapped = 1;
 					}
-					qdf_nbuf_free(status_nbuf);
+					dp_rx_mon_status_buf_recycle(pdev,
+								     status_nbuf);
 					goto buf_replenish;
 				}
 			}
@@ -637,6 +657,7 @@ dp_rx_mon_status_srng_process(struct dp_soc *soc, struct dp_intr *int_ctx,
 		}
 
 buf_replenish:
+		dma_not_done = false;
 		status_nbuf = dp_rx_nbuf_prepare(soc, pdev);
 
 		/*
@@ -711,6 +711,19 @@ dp_print_pdev_rx_mon_stats(struct dp_pdev *pdev)
 		       rx_mon_stats->status_ppdu_drop);
 	DP_PRINT_STATS("ppdus dropped frm dest ring = %d",
 		       rx_mon_stats->dest_ppdu_drop);
+	DP_PRINT_STATS("status ring overrun = %u quota exhausted = %u dma not done = %u",
+		       rx_mon_stats->status_ring_overrun,
+		       rx_mon_stats->status_quota_exhausted,
+		       rx_mon_stats->status_dma_not_done);
+#ifdef DP_MON_PPDU_BATCH
+	DP_PRINT_STATS("ppdu batch flush = %u overrun = %u nbuf alloc fail = %u",
+		       rx_mon_stats->ppdu_batch_flush,
+		       rx_mon_stats->ppdu_batch_overrun,
+		       rx_mon_stats->ppdu_batch_nbuf_alloc_fail);
+	DP_PRINT_STATS("status buf recycled = %u pool miss = %u",
+		       rx_mon_stats->status_buf_recycled,
+		       rx_mon_stats->status_buf_pool_miss);
+#endif
 	stat_ring_ppdu_ids =
 		(uint32_t *)qdf_mem_malloc(sizeof(uint32_t) * MAX_PPDU_ID_HIST);
 	dest_ring_ppdu_ids =
@@ -1935,6 +1948,7 @@ dp_peer_cal_clients_stats_update(struct dp_soc *soc,
 				 struct dp_peer *peer,
 				 void *arg)
 {
+	dp_peer_ring_stats_fold(peer);
 	dp_cal_client_update_peer_stats(&peer->stats);
 }
 
@@ -2264,6 +2278,7 @@ static inline void dp_send_stats_event(struct dp_pdev *pdev,
 				       struct dp_peer *peer,
 				       u_int16_t peer_id)
 {
+	dp_peer_ring_stats_fold(peer);
 	dp_wdi_event_handler(WDI_EVENT_UPDATE_DP_STATS, pdev->soc,
 			     &peer->stats, peer_id,
 			     UPDATE_PEER_STATS, pdev->pdev_id);
@@ -4672,6 +4687,10 @@ QDF_STATUS dp_mon_pdev_init(struct dp_pdev *pdev)
 	if (mon_ops->rx_mon_desc_pool_init)
 		mon_ops->rx_mon_desc_pool_init(pdev);
 
+	dp_rx_mon_status_buf_pool_init(pdev);
+	/* PPDU stats fall back to per PPDU delivery without the vector */
+	dp_rx_mon_ppdu_batch_attach(pdev);
+
 	/* allocate buffers and replenish the monitor RxDMA ring */
 	if (mon_ops->rx_mon_buffers_alloc) {
 		if (mon_ops->rx_mon_buffers_alloc(pdev)) {
@@ -4686,6 +4705,8 @@ QDF_STATUS dp_mon_pdev_init(struct dp_pdev *pdev)
 	return QDF_STATUS_SUCCESS;
 
 fail2:
+	dp_rx_mon_ppdu_batch_detach(pdev);
+	dp_rx_mon_status_buf_pool_deinit(pdev);
 	if (mon_ops->rx_mon_desc_pool_deinit)
 		mon_ops->rx_mon_desc_pool_deinit(pdev);
 
@@ -4719,6 +4740,8 @@ QDF_STATUS dp_mon_pdev_deinit(struct dp_pdev *pdev)
 
 	if (mon_ops->rx_mon_buffers_free)
 		mon_ops->rx_mon_buffers_free(pdev);
+	dp_rx_mon_ppdu_batch_detach(pdev);
+	dp_rx_mon_status_buf_pool_deinit(pdev);
 	if (mon_ops->rx_mon_desc_pool_deinit)
 		mon_ops->rx_mon_desc_pool_deinit(pdev);
 	if (mon_ops->mon_rings_deinit)
@@ -581,6 +581,33 @@ struct dp_mon_ops {
 	void (*mon_register_feature_ops)(struct dp_soc *soc);
 };
 
+#ifdef DP_MON_PPDU_BATCH
+/* PPDU indications collected per status ring pass before delivery */
+#define DP_MON_PPDU_BATCH_SIZE 16
+/* Upper bound on unmapped status buffers parked for reuse */
+#define DP_MON_STATUS_BUF_POOL_SIZE 256
+
+/**
+ * struct dp_mon_ppdu_batch - preallocated PPDU indication vector
+ * @ppdu: array of DP_MON_PPDU_BATCH_SIZE indications
+ * @num_ppdu: number of indications filled in the current pass
+ */
+struct dp_mon_ppdu_batch {
+	struct cdp_rx_indication_ppdu *ppdu;
+	uint32_t num_ppdu;
+};
+
+/**
+ * struct dp_mon_status_buf_pool - recycled monitor status buffers
+ * @lock: protects @bufq against the reap timer and the interrupt context
+ * @bufq: unmapped status nbufs ready to be mapped and posted again
+ */
+struct dp_mon_status_buf_pool {
+	qdf_spinlock_t lock;
+	qdf_nbuf_queue_t bufq;
+};
+#endif
+
 struct dp_mon_soc {
 	/* Holds all monitor related fields extracted from dp_soc */
 	/* Holds pointer to monitor ops */
@@ -798,6 +825,10 @@ struct  dp_mon_pdev {
 	bool reset_scan_spcl_vap_stats_enable;
 #endif
 	bool is_tlv_hdr_64_bit;
+#ifdef DP_MON_PPDU_BATCH
+	struct dp_mon_ppdu_batch ppdu_batch;
+	struct dp_mon_status_buf_pool status_buf_pool;
+#endif
 };
 
 struct  dp_mon_vdev {
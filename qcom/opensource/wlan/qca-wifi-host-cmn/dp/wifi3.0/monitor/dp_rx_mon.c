@@ -917,6 +917,7 @@ static void dp_rx_stats_update(struct dp_pdev *pdev,
 			dp_rx_rate_stats_update(peer, ppdu, i);
 
 #if defined(FEATURE_PERPKT_INFO) && WDI_EVENT_ENABLE
+		dp_peer_ring_stats_fold(peer);
 		dp_wdi_event_handler(WDI_EVENT_UPDATE_DP_STATS, pdev->soc,
 				     &peer->stats, ppdu->peer_id,
 				     UPDATE_PEER_STATS, pdev->pdev_id);
@@ -925,6 +926,177 @@ static void dp_rx_stats_update(struct dp_pdev *pdev,
 	}
 }
 
+#ifdef DP_MON_PPDU_BATCH
+QDF_STATUS dp_rx_mon_ppdu_batch_attach(struct dp_pdev *pdev)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_ppdu_batch *batch = &mon_pdev->ppdu_batch;
+
+	if (batch->ppdu)
+		return QDF_STATUS_SUCCESS;
+
+	batch->ppdu = qdf_mem_valloc(DP_MON_PPDU_BATCH_SIZE *
+				     sizeof(*batch->ppdu));
+	if (!batch->ppdu) {
+		dp_mon_err("%pK: PPDU batch alloc failed", pdev->soc);
+		return QDF_STATUS_E_NOMEM;
+	}
+
+	batch->num_ppdu = 0;
+
+	return QDF_STATUS_SUCCESS;
+}
+
+void dp_rx_mon_ppdu_batch_detach(struct dp_pdev *pdev)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_ppdu_batch *batch = &mon_pdev->ppdu_batch;
+
+	if (!batch->ppdu)
+		return;
+
+	qdf_mem_vfree(batch->ppdu);
+	batch->ppdu = NULL;
+	batch->num_ppdu = 0;
+}
+
+#ifdef WDI_EVENT_ENABLE
+static inline bool dp_rx_mon_wdi_subscribed(struct dp_pdev *pdev,
+					    enum WDI_EVENT event)
+{
+	return pdev->wdi_event_list &&
+	       pdev->wdi_event_list[event - WDI_EVENT_BASE];
+}
+#else
+static inline bool dp_rx_mon_wdi_subscribed(struct dp_pdev *pdev,
+					    enum WDI_EVENT event)
+{
+	return false;
+}
+#endif
+
+/**
+ * dp_rx_mon_ppdu_batch_deliver_nbuf() - Deliver one batched PPDU to the
+ *	per PPDU WDI_EVENT_RX_PPDU_DESC subscribers
+ * @soc: core txrx main context
+ * @pdev: pdev strcuture
+ * @cdp_rx_ppdu: batched PPDU indication
+ *
+ * Return: true if the indication was handed over, false if dropped
+ */
+static bool
+dp_rx_mon_ppdu_batch_deliver_nbuf(struct dp_soc *soc, struct dp_pdev *pdev,
+				  struct cdp_rx_indication_ppdu *cdp_rx_ppdu)
+{
+	qdf_nbuf_t ppdu_nbuf;
+
+	ppdu_nbuf = qdf_nbuf_alloc(soc->osdev,
+				   sizeof(struct cdp_rx_indication_ppdu),
+				   0, 0, FALSE);
+	if (!ppdu_nbuf)
+		return false;
+
+	if (!qdf_nbuf_put_tail(ppdu_nbuf,
+			       sizeof(struct cdp_rx_indication_ppdu))) {
+		qdf_nbuf_free(ppdu_nbuf);
+		return false;
+	}
+
+	qdf_mem_copy(qdf_nbuf_data(ppdu_nbuf), cdp_rx_ppdu,
+		     sizeof(struct cdp_rx_indication_ppdu));
+	dp_wdi_event_handler(WDI_EVENT_RX_PPDU_DESC, soc, ppdu_nbuf,
+			     cdp_rx_ppdu->peer_id, WDI_NO_VAL, pdev->pdev_id);
+
+	return true;
+}
+
+void dp_rx_mon_ppdu_batch_flush(struct dp_soc *soc, struct dp_pdev *pdev)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_ppdu_batch *batch = &mon_pdev->ppdu_batch;
+	struct cdp_pdev_mon_stats *rx_mon_stats = &mon_pdev->rx_mon_stats;
+	struct cdp_rx_indication_ppdu_batch ppdu_vec;
+	uint32_t i;
+
+	if (!batch->num_ppdu)
+		return;
+
+	ppdu_vec.num_ppdu = batch->num_ppdu;
+	ppdu_vec.ppdu = batch->ppdu;
+	dp_wdi_event_handler(WDI_EVENT_RX_PPDU_DESC_BATCH, soc, &ppdu_vec,
+			     HTT_INVALID_PEER, WDI_NO_VAL, pdev->pdev_id);
+
+	/* Subscribers of the per PPDU event still own an nbuf each */
+	if (dp_rx_mon_wdi_subscribed(pdev, WDI_EVENT_RX_PPDU_DESC)) {
+		for (i = 0; i < batch->num_ppdu; i++) {
+			if (!dp_rx_mon_ppdu_batch_deliver_nbuf(soc, pdev,
+							       &batch->ppdu[i]))
+				rx_mon_stats->ppdu_batch_nbuf_alloc_fail++;
+		}
+	}
+
+	rx_mon_stats->ppdu_batch_flush++;
+	batch->num_ppdu = 0;
+}
+
+/**
+ * dp_rx_mon_ppdu_batch_add() - Populate the next free batch entry
+ * @soc: core txrx main context
+ * @pdev: pdev strcuture
+ * @ppdu_info: structure for rx ppdu ring
+ *
+ * Batching only pays off for WDI_EVENT_RX_PPDU_DESC_BATCH subscribers,
+ * with per PPDU subscribers alone the PPDU takes the per PPDU path.
+ *
+ * Return: true if the PPDU was consumed by the batch, false if the
+ *	   caller has to fall back to per PPDU nbuf delivery
+ */
+static bool
+dp_rx_mon_ppdu_batch_add(struct dp_soc *soc, struct dp_pdev *pdev,
+			 struct hal_rx_ppdu_info *ppdu_info)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_ppdu_batch *batch = &mon_pdev->ppdu_batch;
+	struct cdp_rx_indication_ppdu *cdp_rx_ppdu;
+
+	/* M_copy correlates PPDU descs with the frames that follow them */
+	if (qdf_unlikely(!batch->ppdu || mon_pdev->mcopy_mode))
+		return false;
+
+	if (!dp_rx_mon_wdi_subscribed(pdev, WDI_EVENT_RX_PPDU_DESC_BATCH)) {
+		/* keep PPDUs of the last subscriber in order */
+		dp_rx_mon_ppdu_batch_flush(soc, pdev);
+		return false;
+	}
+
+	if (qdf_unlikely(batch->num_ppdu >= DP_MON_PPDU_BATCH_SIZE)) {
+		mon_pdev->rx_mon_stats.ppdu_batch_overrun++;
+		dp_rx_mon_ppdu_batch_flush(soc, pdev);
+	}
+
+	cdp_rx_ppdu = &batch->ppdu[batch->num_ppdu];
+
+	qdf_mem_zero(cdp_rx_ppdu, sizeof(struct cdp_rx_indication_ppdu));
+	dp_rx_mon_populate_cfr_info(pdev, ppdu_info, cdp_rx_ppdu);
+	dp_rx_populate_cdp_indication_ppdu(pdev, ppdu_info, cdp_rx_ppdu);
+	dp_rx_stats_update(pdev, cdp_rx_ppdu);
+
+	/* Same delivery rules as the per PPDU path, slot is reused if not */
+	if (cdp_rx_ppdu->peer_id != HTT_INVALID_PEER ||
+	    dp_cfr_rcc_mode_status(pdev))
+		batch->num_ppdu++;
+
+	return true;
+}
+#else
+static inline bool
+dp_rx_mon_ppdu_batch_add(struct dp_soc *soc, struct dp_pdev *pdev,
+			 struct hal_rx_ppdu_info *ppdu_info)
+{
+	return false;
+}
+#endif
+
 void
 dp_rx_handle_ppdu_stats(struct dp_soc *soc, struct dp_pdev *pdev,
 			struct hal_rx_ppdu_info *ppdu_info)
@@ -986,6 +1158,9 @@ dp_rx_handle_ppdu_stats(struct dp_soc *soc, struct dp_pdev *pdev,
 			return;
 	}
 
+	if (dp_rx_mon_ppdu_batch_add(soc, pdev, ppdu_info))
+		return;
+
 	ppdu_nbuf = qdf_nbuf_alloc(soc->osdev,
 				   sizeof(struct cdp_rx_indication_ppdu),
 				   0, 0, FALSE);
@@ -1274,6 +1449,86 @@ dp_rx_handle_smart_mesh_mode(struct dp_soc *soc, struct dp_pdev *pdev,
 	return 0;
 }
 
+#ifdef DP_MON_PPDU_BATCH
+void dp_rx_mon_status_buf_pool_init(struct dp_pdev *pdev)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_status_buf_pool *pool = &mon_pdev->status_buf_pool;
+
+	qdf_spinlock_create(&pool->lock);
+	qdf_nbuf_queue_init(&pool->bufq);
+}
+
+void dp_rx_mon_status_buf_pool_deinit(struct dp_pdev *pdev)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_status_buf_pool *pool = &mon_pdev->status_buf_pool;
+	qdf_nbuf_t nbuf;
+
+	qdf_spin_lock_bh(&pool->lock);
+	while ((nbuf = qdf_nbuf_queue_remove(&pool->bufq)))
+		qdf_nbuf_free(nbuf);
+	qdf_spin_unlock_bh(&pool->lock);
+
+	qdf_spinlock_destroy(&pool->lock);
+}
+
+void dp_rx_mon_status_buf_recycle(struct dp_pdev *pdev, qdf_nbuf_t nbuf)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_status_buf_pool *pool = &mon_pdev->status_buf_pool;
+
+	/* Buffers still referenced by a pktlog or capture consumer go back
+	 * to the kernel, only exclusively owned linear buffers are reused.
+	 */
+	if (qdf_nbuf_get_users(nbuf) != 1 || qdf_nbuf_is_cloned(nbuf) ||
+	    qdf_nbuf_is_nonlinear(nbuf) ||
+	    qdf_nbuf_queue_len(&pool->bufq) >= DP_MON_STATUS_BUF_POOL_SIZE)
+		goto free;
+
+	qdf_nbuf_reset(nbuf, RX_MON_STATUS_BUF_RESERVATION,
+		       RX_DATA_BUFFER_ALIGNMENT);
+	if (qdf_unlikely(qdf_nbuf_tailroom(nbuf) < RX_MON_STATUS_BUF_SIZE))
+		goto free;
+
+	qdf_spin_lock_bh(&pool->lock);
+	qdf_nbuf_queue_add(&pool->bufq, nbuf);
+	mon_pdev->rx_mon_stats.status_buf_recycled++;
+	qdf_spin_unlock_bh(&pool->lock);
+
+	return;
+
+free:
+	qdf_nbuf_free(nbuf);
+}
+
+/**
+ * dp_rx_mon_status_buf_pool_get() - Take a zeroed buffer from the pool
+ * @pdev: core txrx pdev context
+ *
+ * Return: unmapped status nbuf, or NULL when the pool is empty
+ */
+static qdf_nbuf_t dp_rx_mon_status_buf_pool_get(struct dp_pdev *pdev)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_status_buf_pool *pool = &mon_pdev->status_buf_pool;
+	qdf_nbuf_t nbuf;
+
+	qdf_spin_lock_bh(&pool->lock);
+	nbuf = qdf_nbuf_queue_remove(&pool->bufq);
+	if (!nbuf)
+		mon_pdev->rx_mon_stats.status_buf_pool_miss++;
+	qdf_spin_unlock_bh(&pool->lock);
+
+	return nbuf;
+}
+#else
+static inline qdf_nbuf_t dp_rx_mon_status_buf_pool_get(struct dp_pdev *pdev)
+{
+	return NULL;
+}
+#endif
+
 qdf_nbuf_t
 dp_rx_nbuf_prepare(struct dp_soc *soc, struct dp_pdev *pdev)
 {
@@ -1285,19 +1540,25 @@ dp_rx_nbuf_prepare(struct dp_soc *soc, struct dp_pdev *pdev)
 	for (nbuf_retry_count = 0; nbuf_retry_count <
 		QDF_NBUF_ALLOC_MAP_RETRY_THRESHOLD;
 			nbuf_retry_count++) {
-		/* Allocate a new skb using alloc_skb */
-		nbuf = qdf_nbuf_alloc_no_recycler(RX_MON_STATUS_BUF_SIZE,
-						  RX_MON_STATUS_BUF_RESERVATION,
-						  RX_DATA_BUFFER_ALIGNMENT);
-
+		/* Recycled buffers are already reset and zeroed */
+		nbuf = dp_rx_mon_status_buf_pool_get(pdev);
 		if (!nbuf) {
-			DP_STATS_INC(pdev, replenish.nbuf_alloc_fail, 1);
-			continue;
-		}
+			/* Allocate a new skb using alloc_skb */
+			nbuf = qdf_nbuf_alloc_no_recycler(
+					RX_MON_STATUS_BUF_SIZE,
+					RX_MON_STATUS_BUF_RESERVATION,
+					RX_DATA_BUFFER_ALIGNMENT);
+
+			if (!nbuf) {
+				DP_STATS_INC(pdev, replenish.nbuf_alloc_fail,
+					     1);
+				continue;
+			}
 
-		buf = qdf_nbuf_data(nbuf);
+			buf = qdf_nbuf_data(nbuf);
 
-		memset(buf, 0, RX_MON_STATUS_BUF_SIZE);
+			memset(buf, 0, RX_MON_STATUS_BUF_SIZE);
+		}
 
 		ret = qdf_nbuf_map_nbytes_single(soc->osdev, nbuf,
 						 QDF_DMA_FROM_DEVICE,
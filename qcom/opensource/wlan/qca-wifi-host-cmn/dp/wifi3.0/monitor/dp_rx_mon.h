@@ -443,6 +443,94 @@ dp_rx_handle_smart_mesh_mode(struct dp_soc *soc, struct dp_pdev *pdev,
 qdf_nbuf_t
 dp_rx_nbuf_prepare(struct dp_soc *soc, struct dp_pdev *pdev);
 
+#ifdef DP_MON_PPDU_BATCH
+/**
+ * dp_rx_mon_status_buf_pool_init() - Initialize status buffer recycle pool
+ * @pdev: core txrx pdev context
+ *
+ * Return: none
+ */
+void dp_rx_mon_status_buf_pool_init(struct dp_pdev *pdev);
+
+/**
+ * dp_rx_mon_status_buf_pool_deinit() - Free buffers parked in the pool
+ * @pdev: core txrx pdev context
+ *
+ * Return: none
+ */
+void dp_rx_mon_status_buf_pool_deinit(struct dp_pdev *pdev);
+
+/**
+ * dp_rx_mon_status_buf_recycle() - Return a consumed status buffer
+ * @pdev: core txrx pdev context
+ * @nbuf: unmapped status buffer
+ *
+ * The buffer is parked for dp_rx_nbuf_prepare() when it is exclusively
+ * owned by the monitor path and the pool has room, otherwise it is freed.
+ *
+ * Return: none
+ */
+void dp_rx_mon_status_buf_recycle(struct dp_pdev *pdev, qdf_nbuf_t nbuf);
+#else
+static inline void dp_rx_mon_status_buf_pool_init(struct dp_pdev *pdev)
+{
+}
+
+static inline void dp_rx_mon_status_buf_pool_deinit(struct dp_pdev *pdev)
+{
+}
+
+static inline void
+dp_rx_mon_status_buf_recycle(struct dp_pdev *pdev, qdf_nbuf_t nbuf)
+{
+	qdf_nbuf_free(nbuf);
+}
+#endif
+
+#if defined(DP_MON_PPDU_BATCH) && defined(QCA_ENHANCED_STATS_SUPPORT)
+/**
+ * dp_rx_mon_ppdu_batch_attach() - Allocate the PPDU indication vector
+ * @pdev: core txrx pdev context
+ *
+ * Return: QDF_STATUS_SUCCESS or QDF_STATUS_E_NOMEM
+ */
+QDF_STATUS dp_rx_mon_ppdu_batch_attach(struct dp_pdev *pdev);
+
+/**
+ * dp_rx_mon_ppdu_batch_detach() - Free the PPDU indication vector
+ * @pdev: core txrx pdev context
+ *
+ * Return: none
+ */
+void dp_rx_mon_ppdu_batch_detach(struct dp_pdev *pdev);
+
+/**
+ * dp_rx_mon_ppdu_batch_flush() - Deliver PPDU indications collected so far
+ * @soc: core txrx main context
+ * @pdev: core txrx pdev context
+ *
+ * Called once at the end of every status ring pass, and early when the
+ * vector fills up.
+ *
+ * Return: none
+ */
+void dp_rx_mon_ppdu_batch_flush(struct dp_soc *soc, struct dp_pdev *pdev);
+#else
+static inline QDF_STATUS dp_rx_mon_ppdu_batch_attach(struct dp_pdev *pdev)
+{
+	return QDF_STATUS_SUCCESS;
+}
+
+static inline void dp_rx_mon_ppdu_batch_detach(struct dp_pdev *pdev)
+{
+}
+
+static inline void
+dp_rx_mon_ppdu_batch_flush(struct dp_soc *soc, struct dp_pdev *pdev)
+{
+}
+#endif
+
 #if defined(WLAN_CFR_ENABLE) && defined(WLAN_ENH_CFR_ENABLE)
 
 /*
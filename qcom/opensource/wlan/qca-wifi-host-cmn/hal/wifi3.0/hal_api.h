@@ -2503,6 +2503,35 @@ static inline void hal_srng_src_hw_init(struct hal_soc *hal,
 	hal->ops->hal_srng_src_hw_init(hal, srng);
 }
 
+/**
+ * hal_srng_set_intr_thresholds() - Update interrupt timer and batch counter
+ * thresholds of an initialized SRNG
+ * @hal_soc_hdl: Opaque HAL SOC handle
+ * @hal_ring_hdl: Ring handle
+ * @timer_us: interrupt timer threshold in microseconds
+ * @batch_cnt: interrupt batch counter threshold in ring entries
+ *
+ * Return: None
+ */
+static inline void
+hal_srng_set_intr_thresholds(hal_soc_handle_t hal_soc_hdl,
+			     hal_ring_handle_t hal_ring_hdl,
+			     uint32_t timer_us, uint32_t batch_cnt)
+{
+	struct hal_soc *hal = (struct hal_soc *)hal_soc_hdl;
+	struct hal_srng *srng = (struct hal_srng *)hal_ring_hdl;
+
+	if (!hal || !srng || !srng->initialized ||
+	    !hal->ops->hal_srng_set_intr_thres)
+		return;
+
+	if (srng->intr_timer_thres_us == timer_us &&
+	    srng->intr_batch_cntr_thres_entries == batch_cnt)
+		return;
+
+	hal->ops->hal_srng_set_intr_thres(hal, srng, timer_us, batch_cnt);
+}
+
 /**
  * hal_get_hw_hptp()  - Get HW head and tail pointer value for any ring
  * @hal_soc: Opaque HAL SOC handle
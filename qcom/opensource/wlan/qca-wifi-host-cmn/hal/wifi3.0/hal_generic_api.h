@@ -451,6 +451,55 @@ void hal_srng_dst_hw_init_generic(struct hal_soc *hal,
 
 }
 
+/**
+ * hal_srng_set_intr_thres_generic() - Reprogram interrupt moderation of an
+ * active SRNG
+ * @hal: HAL SOC handle
+ * @srng: SRNG ring pointer
+ * @timer_us: interrupt timer threshold in microseconds
+ * @batch_cnt: interrupt batch counter threshold in ring entries
+ *
+ * Only the interrupt setup register is rewritten; ring base, pointers and
+ * MSI configuration done by hal_srng_{src,dst}_hw_init_generic() are left
+ * untouched, so this can be called while the ring is being serviced.
+ *
+ * Return: None
+ */
+static inline
+void hal_srng_set_intr_thres_generic(struct hal_soc *hal,
+				     struct hal_srng *srng,
+				     uint32_t timer_us, uint32_t batch_cnt)
+{
+	uint32_t reg_val = 0;
+
+	srng->intr_timer_thres_us = timer_us;
+	srng->intr_batch_cntr_thres_entries = batch_cnt;
+
+	if (srng->ring_dir == HAL_SRNG_SRC_RING) {
+		/* Same HK v1 WAR as hal_srng_src_hw_init_generic() */
+		if (timer_us)
+			reg_val |= SRNG_SM(SRNG_SRC_FLD(CONSUMER_INT_SETUP_IX0,
+					   INTERRUPT_TIMER_THRESHOLD),
+					   timer_us);
+		if (batch_cnt)
+			reg_val |= SRNG_SM(SRNG_SRC_FLD(CONSUMER_INT_SETUP_IX0,
+					   BATCH_COUNTER_THRESHOLD),
+					   batch_cnt * srng->entry_size);
+		SRNG_SRC_REG_WRITE(srng, CONSUMER_INT_SETUP_IX0, reg_val);
+		return;
+	}
+
+	if (timer_us)
+		reg_val |= SRNG_SM(SRNG_DST_FLD(PRODUCER_INT_SETUP,
+				   INTERRUPT_TIMER_THRESHOLD),
+				   timer_us >> 3);
+	if (batch_cnt)
+		reg_val |= SRNG_SM(SRNG_DST_FLD(PRODUCER_INT_SETUP,
+				   BATCH_COUNTER_THRESHOLD),
+				   batch_cnt * srng->entry_size);
+	SRNG_DST_REG_WRITE(srng, PRODUCER_INT_SETUP, reg_val);
+}
+
 /**
  * hal_srng_hw_reg_offset_init_generic() - Initialize the HW srng reg offset
  * @hal_soc: HAL Soc handle
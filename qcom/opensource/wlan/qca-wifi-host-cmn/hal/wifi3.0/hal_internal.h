@@ -430,6 +430,7 @@ struct hal_reg_write_q_elem {
  * @dequeues: writes dequeued from delayed work (not written yet)
  * @coalesces: writes not enqueued since srng is already queued up
  * @direct: writes not enqueued and written to register directly
+ * @direct_coalesces: direct writes skipped since srng is already queued up
  * @dequeue_delay: dequeue operation be delayed
  */
 struct hal_reg_write_srng_stats {
@@ -437,6 +438,7 @@ struct hal_reg_write_srng_stats {
 	uint32_t dequeues;
 	uint32_t coalesces;
 	uint32_t direct;
+	uint32_t direct_coalesces;
 	uint32_t dequeue_delay;
 };
 
@@ -456,6 +458,22 @@ enum hal_reg_sched_delay {
 	REG_WRITE_SCHED_DELAY_HIST_MAX,
 };
 
+/**
+ * enum hal_reg_write_coalesce - ENUM for write coalesce histogram
+ * @REG_WRITE_COALESCE_NONE: index for writes with no update coalesced
+ * @REG_WRITE_COALESCE_SUB_4: index for writes with < 4 updates coalesced
+ * @REG_WRITE_COALESCE_SUB_16: index for writes with < 16 updates coalesced
+ * @REG_WRITE_COALESCE_GT_16: index for writes with >= 16 updates coalesced
+ * @REG_WRITE_COALESCE_HIST_MAX: Max value (size of histogram array)
+ */
+enum hal_reg_write_coalesce {
+	REG_WRITE_COALESCE_NONE,
+	REG_WRITE_COALESCE_SUB_4,
+	REG_WRITE_COALESCE_SUB_16,
+	REG_WRITE_COALESCE_GT_16,
+	REG_WRITE_COALESCE_HIST_MAX,
+};
+
 /**
  * struct hal_reg_write_soc_stats - soc stats to keep track of register writes
  * @enqueues: writes enqueued to delayed work
@@ -466,6 +484,8 @@ enum hal_reg_sched_delay {
  * @q_depth: current queue depth in delayed register write queue
  * @max_q_depth: maximum queue for delayed register write queue
  * @sched_delay: = kernel work sched delay + bus wakeup delay, histogram
+ * @write_latency: enqueue to register write completion delay, histogram
+ * @coalesce: updates coalesced into a single register write, histogram
  * @dequeue_delay: dequeue operation be delayed
  */
 struct hal_reg_write_soc_stats {
@@ -477,6 +497,8 @@ struct hal_reg_write_soc_stats {
 	qdf_atomic_t q_depth;
 	uint32_t max_q_depth;
 	uint32_t sched_delay[REG_WRITE_SCHED_DELAY_HIST_MAX];
+	uint32_t write_latency[REG_WRITE_SCHED_DELAY_HIST_MAX];
+	uint32_t coalesce[REG_WRITE_COALESCE_HIST_MAX];
 	uint32_t dequeue_delay;
 };
 #endif
@@ -636,6 +658,8 @@ struct hal_srng {
 #if defined(FEATURE_HAL_DELAYED_REG_WRITE)
 	/* flag to indicate whether srng is already queued for delayed write */
 	uint8_t reg_write_in_progress;
+	/* updates coalesced into the currently queued delayed write */
+	uint16_t reg_write_coalesced;
 	/* last dequeue elem time stamp */
 	qdf_time_t last_dequeue_time;
 
@@ -731,6 +755,10 @@ struct hal_hw_txrx_ops {
 				     struct hal_srng *srng);
 	void (*hal_srng_src_hw_init)(struct hal_soc *hal,
 				     struct hal_srng *srng);
+	void (*hal_srng_set_intr_thres)(struct hal_soc *hal,
+					struct hal_srng *srng,
+					uint32_t timer_us,
+					uint32_t batch_cnt);
 	void (*hal_get_hw_hptp)(struct hal_soc *hal,
 				hal_ring_handle_t hal_ring_hdl,
 				uint32_t *headp, uint32_t *tailp,
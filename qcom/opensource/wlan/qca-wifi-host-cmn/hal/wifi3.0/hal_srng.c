@@ -526,9 +526,10 @@ static inline
 char *hal_fill_reg_write_srng_stats(struct hal_srng *srng,
 				    char *buf, qdf_size_t size)
 {
-	qdf_scnprintf(buf, size, "enq %u deq %u coal %u direct %u",
+	qdf_scnprintf(buf, size, "enq %u deq %u coal %u direct %u dcoal %u",
 		      srng->wstats.enqueues, srng->wstats.dequeues,
-		      srng->wstats.coalesces, srng->wstats.direct);
+		      srng->wstats.coalesces, srng->wstats.direct,
+		      srng->wstats.direct_coalesces);
 	return buf;
 }
 
@@ -564,10 +565,12 @@ void hal_dump_reg_write_srng_stats(hal_soc_handle_t hal_soc_hdl)
 
 void hal_dump_reg_write_stats(hal_soc_handle_t hal_soc_hdl)
 {
-	uint32_t *hist;
+	uint32_t *hist, *lat_hist, *coal_hist;
 	struct hal_soc *hal = (struct hal_soc *)hal_soc_hdl;
 
 	hist = hal->stats.wstats.sched_delay;
+	lat_hist = hal->stats.wstats.write_latency;
+	coal_hist = hal->stats.wstats.coalesce;
 	hal_debug("wstats: enq %u deq %u coal %u direct %u q_depth %u max_q %u sched-delay hist %u %u %u %u",
 		  qdf_atomic_read(&hal->stats.wstats.enqueues),
 		  hal->stats.wstats.dequeues,
@@ -579,6 +582,15 @@ void hal_dump_reg_write_stats(hal_soc_handle_t hal_soc_hdl)
 		  hist[REG_WRITE_SCHED_DELAY_SUB_1000us],
 		  hist[REG_WRITE_SCHED_DELAY_SUB_5000us],
 		  hist[REG_WRITE_SCHED_DELAY_GT_5000us]);
+	hal_debug("wstats: write-latency hist %u %u %u %u coalesce hist %u %u %u %u",
+		  lat_hist[REG_WRITE_SCHED_DELAY_SUB_100us],
+		  lat_hist[REG_WRITE_SCHED_DELAY_SUB_1000us],
+		  lat_hist[REG_WRITE_SCHED_DELAY_SUB_5000us],
+		  lat_hist[REG_WRITE_SCHED_DELAY_GT_5000us],
+		  coal_hist[REG_WRITE_COALESCE_NONE],
+		  coal_hist[REG_WRITE_COALESCE_SUB_4],
+		  coal_hist[REG_WRITE_COALESCE_SUB_16],
+		  coal_hist[REG_WRITE_COALESCE_GT_16]);
 }
 
 int hal_get_reg_write_pending_work(void *hal_soc)
@@ -601,11 +613,38 @@ int hal_get_reg_write_pending_work(void *hal_soc)
 #define HAL_REG_WRITE_QUEUE_LEN 32
 #endif
 
+/**
+ * hal_reg_write_fill_coalesce_hist() - fill reg write coalesce histogram
+ * @hal: hal_soc pointer
+ * @coalesced: number of updates coalesced into one register write
+ *
+ * Return: None
+ */
+static inline void hal_reg_write_fill_coalesce_hist(struct hal_soc *hal,
+						    uint16_t coalesced)
+{
+	uint32_t *hist;
+
+	hist = hal->stats.wstats.coalesce;
+
+	if (!coalesced)
+		hist[REG_WRITE_COALESCE_NONE]++;
+	else if (coalesced < 4)
+		hist[REG_WRITE_COALESCE_SUB_4]++;
+	else if (coalesced < 16)
+		hist[REG_WRITE_COALESCE_SUB_16]++;
+	else
+		hist[REG_WRITE_COALESCE_GT_16]++;
+}
+
 /**
  * hal_process_reg_write_q_elem() - process a regiter write queue element
  * @hal: hal_soc pointer
  * @q_elem: pointer to hal regiter write queue element
  *
+ * All the updates coalesced into @q_elem since it was enqueued are
+ * written in one go, as the latest hp/tp is read under the srng lock.
+ *
  * Return: The value which was written to the address
  */
 static uint32_t
@@ -619,6 +658,8 @@ hal_process_reg_write_q_elem(struct hal_soc *hal,
 
 	srng->reg_write_in_progress = false;
 	srng->wstats.dequeues++;
+	hal_reg_write_fill_coalesce_hist(hal, srng->reg_write_coalesced);
+	srng->reg_write_coalesced = 0;
 
 	if (srng->ring_dir == HAL_SRNG_SRC_RING) {
 		q_elem->dequeue_val = srng->u.src_ring.hp;
@@ -642,19 +683,15 @@ hal_process_reg_write_q_elem(struct hal_soc *hal,
 }
 
 /**
- * hal_reg_write_fill_sched_delay_hist() - fill reg write delay histogram in hal
- * @hal: hal_soc pointer
- * @delay: delay in us
+ * hal_reg_write_fill_delay_hist() - fill a reg write delay histogram
+ * @hist: histogram of REG_WRITE_SCHED_DELAY_HIST_MAX buckets
+ * @delay_us: delay in us
  *
  * Return: None
  */
-static inline void hal_reg_write_fill_sched_delay_hist(struct hal_soc *hal,
-						       uint64_t delay_us)
+static inline void hal_reg_write_fill_delay_hist(uint32_t *hist,
+						 uint64_t delay_us)
 {
-	uint32_t *hist;
-
-	hist = hal->stats.wstats.sched_delay;
-
 	if (delay_us < 100)
 		hist[REG_WRITE_SCHED_DELAY_SUB_100us]++;
 	else if (delay_us < 1000)
@@ -665,6 +702,41 @@ static inline void hal_reg_write_fill_sched_delay_hist(struct hal_soc *hal,
 		hist[REG_WRITE_SCHED_DELAY_GT_5000us]++;
 }
 
+/**
+ * hal_reg_write_fill_sched_delay_hist() - fill reg write delay histogram in hal
+ * @hal: hal_soc pointer
+ * @delay: delay in us
+ *
+ * Return: None
+ */
+static inline void hal_reg_write_fill_sched_delay_hist(struct hal_soc *hal,
+						       uint64_t delay_us)
+{
+	hal_reg_write_fill_delay_hist(hal->stats.wstats.sched_delay, delay_us);
+}
+
+/**
+ * hal_reg_write_fill_latency_hist() - fill reg write latency histogram in hal
+ * @hal: hal_soc pointer
+ * @q_elem: pointer to hal register write queue element, already written
+ *
+ * Latency is measured from enqueue of the first coalesced update to the
+ * completion of the register write.
+ *
+ * Return: None
+ */
+static inline void
+hal_reg_write_fill_latency_hist(struct hal_soc *hal,
+				struct hal_reg_write_q_elem *q_elem)
+{
+	uint64_t latency_us;
+
+	latency_us = qdf_log_timestamp_to_usecs(qdf_get_log_timestamp() -
+						q_elem->enqueue_time);
+	hal_reg_write_fill_delay_hist(hal->stats.wstats.write_latency,
+				      latency_us);
+}
+
 #ifdef SHADOW_WRITE_DELAY
 
 #define SHADOW_WRITE_MIN_DELTA_US	5
@@ -777,6 +849,7 @@ static void hal_reg_write_work(void *arg)
 					  q_elem->srng->ring_id, q_elem->addr);
 
 		write_val = hal_process_reg_write_q_elem(hal, q_elem);
+		hal_reg_write_fill_latency_hist(hal, q_elem);
 		hal_verbose_debug("read_idx %u srng 0x%x, addr 0x%pK dequeue_val %u sched delay %llu us",
 				  hal->read_idx, ring_id, addr, write_val, delta_us);
 
@@ -839,6 +912,7 @@ static void hal_reg_write_enqueue(struct hal_soc *hal_soc,
 				  srng->ring_id, addr, value);
 		qdf_atomic_inc(&hal_soc->stats.wstats.coalesces);
 		srng->wstats.coalesces++;
+		srng->reg_write_coalesced++;
 		return;
 	}
 
@@ -984,6 +1058,33 @@ void hal_record_suspend_write(uint8_t ring_id, uint32_t value, uint32_t count)
 }
 #endif
 
+/**
+ * hal_reg_write_coalesce_direct() - coalesce a direct write into queued one
+ * @hal_soc: hal_soc pointer
+ * @srng: srng pointer
+ *
+ * A delayed write already queued for @srng writes the latest hp/tp, read
+ * under the srng lock, when the worker runs. A direct write in between is
+ * redundant and only costs an extra MMIO access.
+ *
+ * This function executes from within the SRNG LOCK
+ *
+ * Return: true if the write is coalesced and must be skipped
+ */
+static inline bool hal_reg_write_coalesce_direct(struct hal_soc *hal_soc,
+						 struct hal_srng *srng)
+{
+	if (!srng->reg_write_in_progress)
+		return false;
+
+	qdf_atomic_inc(&hal_soc->stats.wstats.coalesces);
+	srng->wstats.coalesces++;
+	srng->wstats.direct_coalesces++;
+	srng->reg_write_coalesced++;
+
+	return true;
+}
+
 #ifdef QCA_WIFI_QCA6750
 void hal_delayed_reg_write(struct hal_soc *hal_soc,
 			   struct hal_srng *srng,
@@ -1016,6 +1117,8 @@ void hal_delayed_reg_write(struct hal_soc *hal_soc,
 		    hal_is_reg_write_tput_level_high(hal_soc) ||
 		    PLD_MHI_STATE_L0 ==
 		    pld_get_mhi_state(hal_soc->qdf_dev->dev)) {
+			if (hal_reg_write_coalesce_direct(hal_soc, srng))
+				break;
 			hal_write_address_32_mb(hal_soc, addr, value, false);
 			qdf_atomic_inc(&hal_soc->stats.wstats.direct);
 			srng->wstats.direct++;
@@ -1034,9 +1137,11 @@ void hal_delayed_reg_write(struct hal_soc *hal_soc,
 {
 	if (hal_is_reg_write_tput_level_high(hal_soc) ||
 	    pld_is_device_awake(hal_soc->qdf_dev->dev)) {
-		qdf_atomic_inc(&hal_soc->stats.wstats.direct);
-		srng->wstats.direct++;
-		hal_write_address_32_mb(hal_soc, addr, value, false);
+		if (!hal_reg_write_coalesce_direct(hal_soc, srng)) {
+			qdf_atomic_inc(&hal_soc->stats.wstats.direct);
+			srng->wstats.direct++;
+			hal_write_address_32_mb(hal_soc, addr, value, false);
+		}
 	} else {
 		hal_reg_write_enqueue(hal_soc, srng, addr, value);
 	}
@@ -1665,6 +1665,7 @@ static void hal_hw_txrx_ops_attach_qca5018(struct hal_soc *hal_soc)
 	/* init and setup */
 	hal_soc->ops->hal_srng_dst_hw_init = hal_srng_dst_hw_init_generic;
 	hal_soc->ops->hal_srng_src_hw_init = hal_srng_src_hw_init_generic;
+	hal_soc->ops->hal_srng_set_intr_thres = hal_srng_set_intr_thres_generic;
 	hal_soc->ops->hal_get_hw_hptp = hal_get_hw_hptp_generic;
 	hal_soc->ops->hal_reo_setup = hal_reo_setup_generic_li;
 	hal_soc->ops->hal_get_window_address = hal_get_window_address_5018;
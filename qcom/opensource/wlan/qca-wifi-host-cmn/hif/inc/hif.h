@@ -919,6 +919,29 @@ QDF_STATUS hif_send_head(struct hif_opaque_softc *hif_ctx, uint8_t PipeID,
 				  qdf_nbuf_t wbuf, uint32_t data_attr);
 void hif_send_complete_check(struct hif_opaque_softc *hif_ctx, uint8_t PipeID,
 			     int force);
+
+/**
+ * hif_send_batch_begin() - Start batching doorbells of sends on a pipe
+ * @hif_ctx: HIF opaque context
+ * @PipeID: upload pipe
+ *
+ * Messages queued with hif_send_head() on @PipeID until the matching
+ * hif_send_batch_end() are handed to the target with a single doorbell
+ * where the bus supports it. Begin/end calls may nest and must always be
+ * paired.
+ *
+ * Return: None
+ */
+void hif_send_batch_begin(struct hif_opaque_softc *hif_ctx, uint8_t PipeID);
+
+/**
+ * hif_send_batch_end() - Ring the doorbell for the messages batched on a pipe
+ * @hif_ctx: HIF opaque context
+ * @PipeID: upload pipe
+ *
+ * Return: None
+ */
+void hif_send_batch_end(struct hif_opaque_softc *hif_ctx, uint8_t PipeID);
 void hif_shut_down_device(struct hif_opaque_softc *hif_ctx);
 void hif_get_default_pipe(struct hif_opaque_softc *hif_ctx, uint8_t *ULPipe,
 			  uint8_t *DLPipe);
@@ -1660,6 +1683,57 @@ void hif_print_napi_stats(struct hif_opaque_softc *hif_ctx);
  */
 void hif_clear_napi_stats(struct hif_opaque_softc *hif_ctx);
 
+/**
+ * typedef hif_exec_moderation_cb() - program interrupt moderation of the
+ * rings serviced by an ext group
+ * @cb_ctx: context registered with hif_register_ext_group()
+ * @timer_pct: interrupt timer threshold in percent of the value each ring
+ *	was configured with
+ * @batch_pct: interrupt batch counter threshold in percent of the value
+ *	each ring was configured with
+ *
+ * 100/100 restores the configured thresholds of every ring.
+ */
+typedef void (*hif_exec_moderation_cb)(void *cb_ctx, uint32_t timer_pct,
+				       uint32_t batch_pct);
+
+#ifdef HIF_EXEC_DIM
+/**
+ * hif_exec_register_moderation_cb() - register the callback used by the
+ * adaptive interrupt moderation of all registered ext groups
+ * @hif_ctx: HIF opaque context
+ * @cb: callback programming the ring interrupt thresholds
+ *
+ * Return: None
+ */
+void hif_exec_register_moderation_cb(struct hif_opaque_softc *hif_ctx,
+				     hif_exec_moderation_cb cb);
+
+/**
+ * hif_exec_set_latency_mode() - select the interrupt moderation profile
+ * @hif_ctx: HIF opaque context
+ * @low_latency: true to use the low latency profile, false for bulk
+ *
+ * The new profile is applied by each ext group on its next poll.
+ *
+ * Return: None
+ */
+void hif_exec_set_latency_mode(struct hif_opaque_softc *hif_ctx,
+			       bool low_latency);
+#else
+static inline
+void hif_exec_register_moderation_cb(struct hif_opaque_softc *hif_ctx,
+				     hif_exec_moderation_cb cb)
+{
+}
+
+static inline
+void hif_exec_set_latency_mode(struct hif_opaque_softc *hif_ctx,
+			       bool low_latency)
+{
+}
+#endif /* HIF_EXEC_DIM */
+
 #ifdef __cplusplus
 }
 #endif
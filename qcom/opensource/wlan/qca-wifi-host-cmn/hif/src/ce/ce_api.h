@@ -228,6 +228,27 @@ QDF_STATUS ce_sendlist_send(struct CE_handle *copyeng,
 			    struct ce_sendlist *sendlist,
 			    unsigned int transfer_id);
 
+/**
+ * ce_send_batch_begin() - Start deferring src ring doorbells of a copy engine
+ * @copyeng: which copy engine to use
+ *
+ * Descriptors posted by ce_send() and ce_sendlist_send() until the matching
+ * ce_send_batch_end() are made visible to the target with a single head
+ * pointer update. Calls may nest. Copy engines whose service does not
+ * support batching keep ringing the doorbell for every send.
+ *
+ * Return: None
+ */
+void ce_send_batch_begin(struct CE_handle *copyeng);
+
+/**
+ * ce_send_batch_end() - Ring the src ring doorbell for a batch of sends
+ * @copyeng: which copy engine to use
+ *
+ * Return: None
+ */
+void ce_send_batch_end(struct CE_handle *copyeng);
+
 /*==================Recv=====================================================*/
 
 /**
@@ -591,6 +612,7 @@ struct ce_ops {
 			    int *num_shadow_registers_configured);
 	int (*ce_get_index_info)(struct hif_softc *scn, void *ce_state,
 				 struct ce_index *info);
+	void (*ce_send_batch_flush)(struct CE_state *CE_state);
 };
 
 int hif_ce_bus_early_suspend(struct hif_softc *scn);
@@ -154,6 +154,18 @@ struct CE_state {
 	qdf_lro_ctx_t lro_data;
 
 	void (*service)(struct hif_softc *scn, int CE_id);
+
+	/*
+	 * Src ring doorbell batching, protected by ce_index_lock.
+	 * While src_batch_depth is non zero, sends only advance the SW head
+	 * pointer and the HW head pointer is written once by
+	 * ce_send_batch_end() for all src_batch_pending messages.
+	 */
+	uint16_t src_batch_depth;
+	uint16_t src_batch_pending;
+	/* Number of src ring head pointer writes and messages they covered */
+	uint32_t src_doorbells;
+	uint32_t src_doorbell_msgs;
 #ifdef WLAN_TRACEPOINTS
 	/* CE tasklet sched time in nanoseconds */
 	unsigned long long ce_tasklet_sched_time;
@@ -441,6 +453,8 @@ union ce_srng_desc {
  * @HIF_RX_DESC_PRE_NBUF_ALLOC: record the packet before nbuf allocation
  * @HIF_RX_DESC_PRE_NBUF_MAP: record the packet before nbuf map
  * @HIF_RX_DESC_POST_NBUF_MAP: record the packet after nbuf map
+ * @HIF_CE_SRC_RING_DOORBELL: record a batched src ring head pointer update,
+ *	the index field holds the number of messages it covers
  */
 enum hif_ce_event_type {
 	HIF_RX_DESC_POST,
@@ -480,6 +494,8 @@ enum hif_ce_event_type {
 	HIF_RX_DESC_PRE_NBUF_MAP,
 	HIF_RX_DESC_POST_NBUF_MAP,
 
+	HIF_CE_SRC_RING_DOORBELL,
+
 	HIF_EVENT_TYPE_MAX,
 };
 
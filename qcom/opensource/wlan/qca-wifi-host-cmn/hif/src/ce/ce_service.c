@@ -483,6 +483,39 @@ ce_send(struct CE_handle *copyeng,
 }
 qdf_export_symbol(ce_send);
 
+void ce_send_batch_begin(struct CE_handle *copyeng)
+{
+	struct CE_state *CE_state = (struct CE_state *)copyeng;
+	struct HIF_CE_state *hif_state = HIF_GET_CE_STATE(CE_state->scn);
+
+	if (!hif_state->ce_services->ce_send_batch_flush)
+		return;
+
+	qdf_spin_lock_bh(&CE_state->ce_index_lock);
+	CE_state->src_batch_depth++;
+	qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+}
+
+void ce_send_batch_end(struct CE_handle *copyeng)
+{
+	struct CE_state *CE_state = (struct CE_state *)copyeng;
+	struct HIF_CE_state *hif_state = HIF_GET_CE_STATE(CE_state->scn);
+
+	if (!hif_state->ce_services->ce_send_batch_flush)
+		return;
+
+	qdf_spin_lock_bh(&CE_state->ce_index_lock);
+	if (qdf_unlikely(!CE_state->src_batch_depth)) {
+		qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+		QDF_BUG(0);
+		return;
+	}
+
+	if (!--CE_state->src_batch_depth && CE_state->src_batch_pending)
+		hif_state->ce_services->ce_send_batch_flush(CE_state);
+	qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+}
+
 unsigned int ce_sendlist_sizeof(void)
 {
 	return sizeof(struct ce_sendlist);
@@ -1703,6 +1736,8 @@ static const char *ce_event_type_to_str(enum hif_ce_event_type type)
 		return "HIF_RX_NBUF_MAP_FAILURE";
 	case HIF_RX_NBUF_ENQUEUE_FAILURE:
 		return "HIF_RX_NBUF_ENQUEUE_FAILURE";
+	case HIF_CE_SRC_RING_DOORBELL:
+		return "HIF_CE_SRC_RING_DOORBELL";
 	default:
 		return "invalid";
 	}
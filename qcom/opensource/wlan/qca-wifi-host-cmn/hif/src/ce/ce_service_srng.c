@@ -96,6 +96,8 @@ void hif_display_ctrl_traffic_pipes_state(struct hif_opaque_softc *hif_ctx)
 	CE_state = scn->ce_id_to_state[3];
 	hal_get_sw_hptp(scn->hal_soc, CE_state->src_ring->srng_ctx, &tp, &hp);
 	hif_info_high("CE-3 Source ring current snapshot HP:%u TP:%u", hp, tp);
+	hif_info_high("CE-3 Source ring doorbells:%u msgs:%u",
+		      CE_state->src_doorbells, CE_state->src_doorbell_msgs);
 }
 
 #if defined(HIF_CONFIG_SLUB_DEBUG_ON) || defined(HIF_CE_DEBUG_DATA_BUF)
@@ -157,6 +159,96 @@ void hif_record_ce_srng_desc_event(struct hif_softc *scn, int ce_id,
 }
 #endif /* HIF_CONFIG_SLUB_DEBUG_ON || HIF_CE_DEBUG_DATA_BUF */
 
+/**
+ * ce_srng_src_desc_post() - Fill the next src ring descriptor
+ * @CE_state: copy engine state
+ * @per_transfer_context: context returned on send completion
+ * @buffer: physical address of the buffer
+ * @nbytes: length of the buffer
+ * @transfer_id: transfer id reflected to the destination
+ * @flags: CE_SEND_FLAG_*
+ *
+ * Must be called between hal_srng_access_start() and
+ * ce_srng_src_ring_doorbell() on the src ring, with ce_index_lock held.
+ *
+ * Return: QDF_STATUS_SUCCESS if a descriptor was filled
+ */
+static QDF_STATUS
+ce_srng_src_desc_post(struct CE_state *CE_state, void *per_transfer_context,
+		      qdf_dma_addr_t buffer, uint32_t nbytes,
+		      uint32_t transfer_id, uint32_t flags)
+{
+	struct CE_ring_state *src_ring = CE_state->src_ring;
+	unsigned int write_index = src_ring->write_index;
+	struct hif_softc *scn = CE_state->scn;
+	struct ce_srng_src_desc *src_desc;
+	uint64_t dma_addr = buffer;
+
+	src_desc = hal_srng_src_get_next_reaped(scn->hal_soc,
+						src_ring->srng_ctx);
+	if (!src_desc)
+		return QDF_STATUS_E_INVAL;
+
+	/* Update low 32 bits source descriptor address */
+	src_desc->buffer_addr_lo = (uint32_t)(dma_addr & 0xFFFFFFFF);
+	src_desc->buffer_addr_hi = (uint32_t)((dma_addr >> 32) & 0xFF);
+
+	src_desc->meta_data = transfer_id;
+
+	/*
+	 * Set the swap bit if:
+	 * typical sends on this CE are swapped (host is big-endian)
+	 * and this send doesn't disable the swapping
+	 * (data is not bytestream)
+	 */
+	src_desc->byte_swap =
+		(((CE_state->attr_flags & CE_ATTR_BYTE_SWAP_DATA)
+		  != 0) & ((flags & CE_SEND_FLAG_SWAP_DISABLE) == 0));
+	src_desc->gather = ((flags & CE_SEND_FLAG_GATHER) != 0);
+	src_desc->nbytes = nbytes;
+
+	src_ring->per_transfer_context[write_index] = per_transfer_context;
+
+	hif_record_ce_srng_desc_event(scn, CE_state->id,
+				      HIF_CE_SRC_RING_BUFFER_POST,
+				      (union ce_srng_desc *)src_desc,
+				      per_transfer_context,
+				      write_index, nbytes,
+				      src_ring->srng_ctx);
+
+	src_ring->write_index = CE_RING_IDX_INCR(src_ring->nentries_mask,
+						 write_index);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * ce_srng_src_ring_doorbell() - End src ring access for posted messages
+ * @CE_state: copy engine state
+ * @num_msgs: number of messages posted since hal_srng_access_start()
+ *
+ * Writes the head pointer to HW, unless a doorbell batch is open on the
+ * copy engine in which case the write is left to ce_send_batch_end().
+ *
+ * Return: None
+ */
+static void
+ce_srng_src_ring_doorbell(struct CE_state *CE_state, uint32_t num_msgs)
+{
+	struct hif_softc *scn = CE_state->scn;
+	void *srng_ctx = CE_state->src_ring->srng_ctx;
+
+	if (CE_state->src_batch_depth) {
+		hal_srng_access_end_reap(scn->hal_soc, srng_ctx);
+		CE_state->src_batch_pending += num_msgs;
+		return;
+	}
+
+	hal_srng_access_end(scn->hal_soc, srng_ctx);
+	CE_state->src_doorbells++;
+	CE_state->src_doorbell_msgs += num_msgs;
+}
+
 static QDF_STATUS
 ce_send_nolock_srng(struct CE_handle *copyeng,
 			   void *per_transfer_context,
@@ -169,9 +261,6 @@ ce_send_nolock_srng(struct CE_handle *copyeng,
 	QDF_STATUS status;
 	struct CE_state *CE_state = (struct CE_state *)copyeng;
 	struct CE_ring_state *src_ring = CE_state->src_ring;
-	unsigned int nentries_mask = src_ring->nentries_mask;
-	unsigned int write_index = src_ring->write_index;
-	uint64_t dma_addr = buffer;
 	struct hif_softc *scn = CE_state->scn;
 
 	if (Q_TARGET_ACCESS_BEGIN(scn) < 0)
@@ -182,60 +271,21 @@ ce_send_nolock_srng(struct CE_handle *copyeng,
 		Q_TARGET_ACCESS_END(scn);
 		return QDF_STATUS_E_FAILURE;
 	}
-	{
-		enum hif_ce_event_type event_type = HIF_CE_SRC_RING_BUFFER_POST;
-		struct ce_srng_src_desc *src_desc;
-
-		if (hal_srng_access_start(scn->hal_soc, src_ring->srng_ctx)) {
-			Q_TARGET_ACCESS_END(scn);
-			return QDF_STATUS_E_FAILURE;
-		}
-
-		src_desc = hal_srng_src_get_next_reaped(scn->hal_soc,
-				src_ring->srng_ctx);
-		if (!src_desc) {
-			Q_TARGET_ACCESS_END(scn);
-			return QDF_STATUS_E_INVAL;
-		}
-
-		/* Update low 32 bits source descriptor address */
-		src_desc->buffer_addr_lo =
-			(uint32_t)(dma_addr & 0xFFFFFFFF);
-		src_desc->buffer_addr_hi =
-			(uint32_t)((dma_addr >> 32) & 0xFF);
-
-		src_desc->meta_data = transfer_id;
-
-		/*
-		 * Set the swap bit if:
-		 * typical sends on this CE are swapped (host is big-endian)
-		 * and this send doesn't disable the swapping
-		 * (data is not bytestream)
-		 */
-		src_desc->byte_swap =
-			(((CE_state->attr_flags & CE_ATTR_BYTE_SWAP_DATA)
-			  != 0) & ((flags & CE_SEND_FLAG_SWAP_DISABLE) == 0));
-		src_desc->gather = ((flags & CE_SEND_FLAG_GATHER) != 0);
-		src_desc->nbytes = nbytes;
-
-		src_ring->per_transfer_context[write_index] =
-			per_transfer_context;
-		write_index = CE_RING_IDX_INCR(nentries_mask, write_index);
 
-		hal_srng_access_end(scn->hal_soc, src_ring->srng_ctx);
-
-		/* src_ring->write index hasn't been updated event though
-		 * the register has allready been written to.
-		 */
-		hif_record_ce_srng_desc_event(scn, CE_state->id, event_type,
-					      (union ce_srng_desc *)src_desc,
-					      per_transfer_context,
-					      src_ring->write_index, nbytes,
-					      src_ring->srng_ctx);
+	if (hal_srng_access_start(scn->hal_soc, src_ring->srng_ctx)) {
+		Q_TARGET_ACCESS_END(scn);
+		return QDF_STATUS_E_FAILURE;
+	}
 
-		src_ring->write_index = write_index;
-		status = QDF_STATUS_SUCCESS;
+	status = ce_srng_src_desc_post(CE_state, per_transfer_context, buffer,
+				       nbytes, transfer_id, flags);
+	if (QDF_IS_STATUS_ERROR(status)) {
+		hal_srng_access_end_reap(scn->hal_soc, src_ring->srng_ctx);
+		Q_TARGET_ACCESS_END(scn);
+		return status;
 	}
+
+	ce_srng_src_ring_doorbell(CE_state, 1);
 	Q_TARGET_ACCESS_END(scn);
 	return status;
 }
@@ -250,64 +300,110 @@ ce_sendlist_send_srng(struct CE_handle *copyeng,
 	struct CE_state *CE_state = (struct CE_state *)copyeng;
 	struct CE_ring_state *src_ring = CE_state->src_ring;
 	unsigned int num_items = sl->num_items;
-	unsigned int sw_index;
-	unsigned int write_index;
 	struct hif_softc *scn = CE_state->scn;
+	struct ce_sendlist_item *item;
+	uint32_t flags;
+	void *ctx;
+	int i;
 
 	QDF_ASSERT((num_items > 0) && (num_items < src_ring->nentries));
 
 	qdf_spin_lock_bh(&CE_state->ce_index_lock);
-	sw_index = src_ring->sw_index;
-	write_index = src_ring->write_index;
-
-	if (hal_srng_src_num_avail(scn->hal_soc, src_ring->srng_ctx, false) >=
-	    num_items) {
-		struct ce_sendlist_item *item;
-		int i;
-
-		/* handle all but the last item uniformly */
-		for (i = 0; i < num_items - 1; i++) {
-			item = &sl->item[i];
-			/* TBDXXX: Support extensible sendlist_types? */
-			QDF_ASSERT(item->send_type == CE_SIMPLE_BUFFER_TYPE);
-			status = ce_send_nolock_srng(copyeng,
-					CE_SENDLIST_ITEM_CTXT,
-				(qdf_dma_addr_t) item->data,
-				item->u.nbytes, transfer_id,
-				item->flags | CE_SEND_FLAG_GATHER,
-				item->user_flags);
-			QDF_ASSERT(status == QDF_STATUS_SUCCESS);
-		}
-		/* provide valid context pointer for final item */
+
+	if (Q_TARGET_ACCESS_BEGIN(scn) < 0) {
+		qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	/*
+	 * Probably not worth the additional complexity to support
+	 * partial sends with continuation or notification.  We expect
+	 * to use large rings and small sendlists. If we can't handle
+	 * the entire request at once, punt it back to the caller.
+	 */
+	if (hal_srng_src_num_avail(scn->hal_soc, src_ring->srng_ctx, false) <
+	    num_items)
+		goto out;
+
+	/* Reserve all the descriptors under one ring access */
+	if (hal_srng_access_start(scn->hal_soc, src_ring->srng_ctx)) {
+		status = QDF_STATUS_E_FAILURE;
+		goto out;
+	}
+
+	for (i = 0; i < num_items; i++) {
 		item = &sl->item[i];
 		/* TBDXXX: Support extensible sendlist_types? */
 		QDF_ASSERT(item->send_type == CE_SIMPLE_BUFFER_TYPE);
-		status = ce_send_nolock_srng(copyeng, per_transfer_context,
-					(qdf_dma_addr_t) item->data,
-					item->u.nbytes,
-					transfer_id, item->flags,
-					item->user_flags);
+
+		/* provide valid context pointer for final item only */
+		if (i < num_items - 1) {
+			ctx = CE_SENDLIST_ITEM_CTXT;
+			flags = item->flags | CE_SEND_FLAG_GATHER;
+		} else {
+			ctx = per_transfer_context;
+			flags = item->flags;
+		}
+
+		status = ce_srng_src_desc_post(CE_state, ctx,
+					       (qdf_dma_addr_t)item->data,
+					       item->u.nbytes, transfer_id,
+					       flags);
 		QDF_ASSERT(status == QDF_STATUS_SUCCESS);
-		QDF_NBUF_UPDATE_TX_PKT_COUNT((qdf_nbuf_t)per_transfer_context,
-					QDF_NBUF_TX_PKT_CE);
-		DPTRACE(qdf_dp_trace((qdf_nbuf_t)per_transfer_context,
-			QDF_DP_TRACE_CE_PACKET_PTR_RECORD,
-			QDF_TRACE_DEFAULT_PDEV_ID,
-			(uint8_t *)(((qdf_nbuf_t)per_transfer_context)->data),
-			sizeof(((qdf_nbuf_t)per_transfer_context)->data), QDF_TX));
-	} else {
-		/*
-		 * Probably not worth the additional complexity to support
-		 * partial sends with continuation or notification.  We expect
-		 * to use large rings and small sendlists. If we can't handle
-		 * the entire request at once, punt it back to the caller.
-		 */
 	}
+
+	/* One head pointer update for the whole gather list */
+	ce_srng_src_ring_doorbell(CE_state, 1);
+
+	QDF_NBUF_UPDATE_TX_PKT_COUNT((qdf_nbuf_t)per_transfer_context,
+				     QDF_NBUF_TX_PKT_CE);
+	DPTRACE(qdf_dp_trace((qdf_nbuf_t)per_transfer_context,
+		QDF_DP_TRACE_CE_PACKET_PTR_RECORD,
+		QDF_TRACE_DEFAULT_PDEV_ID,
+		(uint8_t *)(((qdf_nbuf_t)per_transfer_context)->data),
+		sizeof(((qdf_nbuf_t)per_transfer_context)->data), QDF_TX));
+out:
+	Q_TARGET_ACCESS_END(scn);
 	qdf_spin_unlock_bh(&CE_state->ce_index_lock);
 
 	return status;
 }
 
+/**
+ * ce_send_batch_flush_srng() - Write the src ring head pointer for the
+ *				messages posted during a doorbell batch
+ * @CE_state: copy engine state
+ *
+ * Called with ce_index_lock held once the last batch on the copy engine ends.
+ *
+ * Return: None
+ */
+static void ce_send_batch_flush_srng(struct CE_state *CE_state)
+{
+	struct CE_ring_state *src_ring = CE_state->src_ring;
+	struct hif_softc *scn = CE_state->scn;
+	uint32_t num_msgs = CE_state->src_batch_pending;
+
+	CE_state->src_batch_pending = 0;
+
+	if (Q_TARGET_ACCESS_BEGIN(scn) < 0)
+		return;
+
+	if (hal_srng_access_start(scn->hal_soc, src_ring->srng_ctx)) {
+		Q_TARGET_ACCESS_END(scn);
+		return;
+	}
+
+	hal_srng_access_end(scn->hal_soc, src_ring->srng_ctx);
+	CE_state->src_doorbells++;
+	CE_state->src_doorbell_msgs += num_msgs;
+
+	hif_record_ce_srng_desc_event(scn, CE_state->id,
+				      HIF_CE_SRC_RING_DOORBELL, NULL, NULL,
+				      num_msgs, 0, src_ring->srng_ctx);
+	Q_TARGET_ACCESS_END(scn);
+}
+
 #define SLOTS_PER_DATAPATH_TX 2
 
 #ifndef AH_NEED_TX_DATA_SWAP
@@ -1076,6 +1172,7 @@ static struct ce_ops ce_service_srng = {
 	.ce_recv_buf_enqueue = ce_recv_buf_enqueue_srng,
 	.ce_per_engine_handler_adjust = ce_per_engine_handler_adjust_srng,
 	.ce_send_nolock = ce_send_nolock_srng,
+	.ce_send_batch_flush = ce_send_batch_flush_srng,
 	.watermark_int = ce_check_int_watermark_srng,
 	.ce_completed_send_next_nolock = ce_completed_send_next_nolock_srng,
 	.ce_recv_entries_done_nolock = ce_recv_entries_done_nolock_srng,
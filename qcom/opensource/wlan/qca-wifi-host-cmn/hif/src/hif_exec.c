@@ -276,6 +276,231 @@ void hif_clear_napi_stats(struct hif_opaque_softc *hif_ctx)
 
 qdf_export_symbol(hif_clear_napi_stats);
 
+#ifdef HIF_EXEC_DIM
+/* Poll work is accumulated over this window before a decision is taken */
+#define HIF_EXEC_DIM_WINDOW_NS (10 * 1000 * 1000)
+/* Below this much work per ms the group is idle, go back to level 0 */
+#define HIF_EXEC_DIM_IDLE_RATE 8
+
+/**
+ * struct hif_exec_dim_level - ring interrupt moderation of one level
+ * @timer_pct: interrupt timer threshold in percent of the ring's
+ *	configured value
+ * @batch_pct: interrupt batch counter threshold in percent of the ring's
+ *	configured value
+ */
+struct hif_exec_dim_level {
+	uint16_t timer_pct;
+	uint16_t batch_pct;
+};
+
+/* Level 0 restores the thresholds each ring was configured with */
+static const struct hif_exec_dim_level hif_exec_dim_bulk_tbl[] = {
+	{100, 100}, {150, 200}, {200, 400}, {300, 800},
+};
+
+static const struct hif_exec_dim_level hif_exec_dim_low_latency_tbl[] = {
+	{100, 100}, {125, 200},
+};
+
+static const struct {
+	const struct hif_exec_dim_level *tbl;
+	uint8_t num_levels;
+} hif_exec_dim_profiles[HIF_EXEC_DIM_PROFILE_MAX] = {
+	[HIF_EXEC_DIM_PROFILE_BULK] = {
+		hif_exec_dim_bulk_tbl, QDF_ARRAY_SIZE(hif_exec_dim_bulk_tbl)},
+	[HIF_EXEC_DIM_PROFILE_LOW_LATENCY] = {
+		hif_exec_dim_low_latency_tbl,
+		QDF_ARRAY_SIZE(hif_exec_dim_low_latency_tbl)},
+};
+
+static const char * const hif_exec_dim_profile_str[] = {
+	[HIF_EXEC_DIM_PROFILE_BULK] = "bulk",
+	[HIF_EXEC_DIM_PROFILE_LOW_LATENCY] = "low-latency",
+};
+
+/**
+ * hif_exec_dim_apply() - program the moderation of the current level
+ * @hif_ext_group: hif ext group
+ *
+ * Return: None
+ */
+static void hif_exec_dim_apply(struct hif_exec_context *hif_ext_group)
+{
+	struct hif_exec_dim *dim = &hif_ext_group->dim;
+	const struct hif_exec_dim_level *lvl;
+
+	lvl = &hif_exec_dim_profiles[dim->profile].tbl[dim->level];
+	dim->moderation_cb(hif_ext_group->context, lvl->timer_pct,
+			   lvl->batch_pct);
+}
+
+/**
+ * hif_exec_dim_update() - account the work of one poll and retune the ring
+ *	interrupt moderation at the end of each window
+ * @hif_ext_group: hif ext group
+ * @work_done: work reported by the group handler
+ * @budget: internal budget the handler was called with
+ *
+ * Called from the poll context before interrupts are re-enabled, so the new
+ * thresholds take effect for the next interrupt of the group.
+ *
+ * Return: None
+ */
+static inline
+void hif_exec_dim_update(struct hif_exec_context *hif_ext_group,
+			 int work_done, int budget)
+{
+	struct hif_exec_dim *dim = &hif_ext_group->dim;
+	uint8_t req_profile, num_levels, level;
+	uint64_t now, elapsed;
+	uint32_t rate, avg_work;
+
+	if (!dim->moderation_cb)
+		return;
+
+	req_profile = qdf_atomic_read(&dim->req_profile);
+	if (qdf_unlikely(req_profile != dim->profile)) {
+		dim->profile = req_profile;
+		dim->level = 0;
+		dim->win_work = 0;
+		dim->win_polls = 0;
+		dim->win_start_ns = qdf_time_sched_clock();
+		hif_exec_dim_apply(hif_ext_group);
+		return;
+	}
+
+	dim->win_work += work_done;
+	dim->win_polls++;
+
+	now = qdf_time_sched_clock();
+	elapsed = now - dim->win_start_ns;
+	if (elapsed < HIF_EXEC_DIM_WINDOW_NS)
+		return;
+
+	/* an idle group may come back after a long gap, clamp the divisor */
+	elapsed = qdf_min(qdf_do_div(elapsed, 1000), (uint64_t)U32_MAX);
+	rate = qdf_do_div((uint64_t)dim->win_work * 1000, elapsed);
+	avg_work = dim->win_work / dim->win_polls;
+	num_levels = hif_exec_dim_profiles[dim->profile].num_levels;
+	level = dim->level;
+
+	if (rate < HIF_EXEC_DIM_IDLE_RATE)
+		level = 0;
+	else if (avg_work < (budget >> 3) && level + 1 < num_levels)
+		/* many interrupts each carrying little work: coalesce more */
+		level++;
+	else if ((avg_work > (budget >> 1) ||
+		  rate < (dim->last_rate >> 1)) && level)
+		/* polls are already full or the load dropped: back off */
+		level--;
+
+	dim->last_rate = rate;
+	dim->last_avg_work = avg_work;
+	dim->win_work = 0;
+	dim->win_polls = 0;
+	dim->win_start_ns = now;
+
+	if (level == dim->level)
+		return;
+
+	if (level > dim->level)
+		dim->level_ups++;
+	else
+		dim->level_downs++;
+
+	dim->level = level;
+	hif_exec_dim_apply(hif_ext_group);
+}
+
+/**
+ * hif_exec_dim_print_stats() - print the moderation state of the ext groups
+ * @hif_state: hif context
+ *
+ * Return: None
+ */
+static void hif_exec_dim_print_stats(struct HIF_CE_state *hif_state)
+{
+	struct hif_exec_context *hif_ext_group;
+	const struct hif_exec_dim_level *lvl;
+	struct hif_exec_dim *dim;
+	int i;
+
+	QDF_TRACE(QDF_MODULE_ID_HIF, QDF_TRACE_LEVEL_INFO_HIGH,
+		  "DIM[#] |profile    |lvl |timer(%%) |batch(%%) |rate(/ms) |avg  |ups    |downs");
+
+	for (i = 0; i < hif_state->hif_num_extgroup; i++) {
+		hif_ext_group = hif_state->hif_ext_group[i];
+		if (!hif_ext_group || !hif_ext_group->dim.moderation_cb)
+			continue;
+
+		dim = &hif_ext_group->dim;
+		lvl = &hif_exec_dim_profiles[dim->profile].tbl[dim->level];
+		QDF_TRACE(QDF_MODULE_ID_HIF, QDF_TRACE_LEVEL_INFO_HIGH,
+			  "DIM[%d]: %-11s %3u %8u %9u %9u %5u %7u %7u",
+			  i, hif_exec_dim_profile_str[dim->profile],
+			  dim->level, lvl->timer_pct, lvl->batch_pct,
+			  dim->last_rate, dim->last_avg_work,
+			  dim->level_ups, dim->level_downs);
+	}
+}
+
+static inline void hif_exec_dim_init(struct hif_exec_context *hif_ext_group)
+{
+	qdf_atomic_init(&hif_ext_group->dim.req_profile);
+}
+
+void hif_exec_register_moderation_cb(struct hif_opaque_softc *hif_ctx,
+				     hif_exec_moderation_cb cb)
+{
+	struct HIF_CE_state *hif_state = HIF_GET_CE_STATE(hif_ctx);
+	int i;
+
+	for (i = 0; i < hif_state->hif_num_extgroup; i++) {
+		if (!hif_state->hif_ext_group[i] ||
+		    hif_state->hif_ext_group[i]->type != HIF_EXEC_NAPI_TYPE)
+			continue;
+
+		hif_state->hif_ext_group[i]->dim.moderation_cb = cb;
+	}
+}
+
+qdf_export_symbol(hif_exec_register_moderation_cb);
+
+void hif_exec_set_latency_mode(struct hif_opaque_softc *hif_ctx,
+			       bool low_latency)
+{
+	struct HIF_CE_state *hif_state = HIF_GET_CE_STATE(hif_ctx);
+	int profile = low_latency ? HIF_EXEC_DIM_PROFILE_LOW_LATENCY :
+				    HIF_EXEC_DIM_PROFILE_BULK;
+	int i;
+
+	if (!hif_state)
+		return;
+
+	for (i = 0; i < hif_state->hif_num_extgroup; i++) {
+		if (hif_state->hif_ext_group[i])
+			qdf_atomic_set(&hif_state->hif_ext_group[i]->
+				       dim.req_profile, profile);
+	}
+}
+
+qdf_export_symbol(hif_exec_set_latency_mode);
+#else
+static inline void hif_exec_dim_update(struct hif_exec_context *hif_ext_group,
+				       int work_done, int budget)
+{
+}
+
+static inline void hif_exec_dim_print_stats(struct HIF_CE_state *hif_state)
+{
+}
+
+static inline void hif_exec_dim_init(struct hif_exec_context *hif_ext_group)
+{
+}
+#endif /* HIF_EXEC_DIM */
+
 #ifdef WLAN_FEATURE_RX_SOFTIRQ_TIME_LIMIT
 /**
  * hif_get_poll_times_hist_str() - Get HIF poll times histogram string
@@ -432,6 +657,7 @@ void hif_print_napi_stats(struct hif_opaque_softc *hif_ctx)
 		}
 	}
 
+	hif_exec_dim_print_stats(hif_state);
 	hif_print_napi_latency_stats(hif_state);
 }
 
@@ -484,6 +710,7 @@ void hif_print_napi_stats(struct hif_opaque_softc *hif_ctx)
 		}
 	}
 
+	hif_exec_dim_print_stats(hif_state);
 	hif_print_napi_latency_stats(hif_state);
 }
 qdf_export_symbol(hif_print_napi_stats);
@@ -634,6 +861,8 @@ static int hif_exec_poll(struct napi_struct *napi, int budget)
 
 	actual_dones = work_done;
 
+	hif_exec_dim_update(hif_ext_group, actual_dones, normalized_budget);
+
 	if (hif_is_force_napi_complete_required(hif_ext_group)) {
 		force_complete = true;
 		if (work_done >= normalized_budget)
@@ -1034,6 +1263,7 @@ QDF_STATUS hif_register_ext_group(struct hif_opaque_softc *hif_ctx,
 	hif_ext_group->context_name = context_name;
 	hif_ext_group->type = type;
 	hif_init_force_napi_complete(hif_ext_group);
+	hif_exec_dim_init(hif_ext_group);
 
 	hif_state->hif_num_extgroup++;
 	return QDF_STATUS_SUCCESS;
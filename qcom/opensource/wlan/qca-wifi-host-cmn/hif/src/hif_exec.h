@@ -50,6 +50,50 @@ struct hif_execution_ops {
 	void (*kill)(struct hif_exec_context *);
 };
 
+#ifdef HIF_EXEC_DIM
+/**
+ * enum hif_exec_dim_profile - interrupt moderation profiles
+ * @HIF_EXEC_DIM_PROFILE_BULK: favour fewer interrupts under load
+ * @HIF_EXEC_DIM_PROFILE_LOW_LATENCY: stay close to the configured thresholds,
+ *	used when the WLM latency level is ultra low
+ * @HIF_EXEC_DIM_PROFILE_MAX: number of profiles
+ */
+enum hif_exec_dim_profile {
+	HIF_EXEC_DIM_PROFILE_BULK,
+	HIF_EXEC_DIM_PROFILE_LOW_LATENCY,
+	HIF_EXEC_DIM_PROFILE_MAX,
+};
+
+/**
+ * struct hif_exec_dim - adaptive interrupt moderation state of an ext group
+ * @moderation_cb: programs the ring thresholds of the group, NULL disables
+ *	moderation for the group
+ * @req_profile: profile requested through hif_exec_set_latency_mode()
+ * @profile: profile currently applied by the poll context
+ * @level: index into the moderation table of @profile
+ * @win_start_ns: start of the current measurement window
+ * @win_work: work done in the current window
+ * @win_polls: number of polls in the current window
+ * @last_rate: work per millisecond of the last window
+ * @last_avg_work: average work per poll of the last window
+ * @level_ups: number of moves towards more coalescing
+ * @level_downs: number of moves towards less coalescing
+ */
+struct hif_exec_dim {
+	hif_exec_moderation_cb moderation_cb;
+	qdf_atomic_t req_profile;
+	uint8_t profile;
+	uint8_t level;
+	uint64_t win_start_ns;
+	uint32_t win_work;
+	uint32_t win_polls;
+	uint32_t last_rate;
+	uint32_t last_avg_work;
+	uint32_t level_ups;
+	uint32_t level_downs;
+};
+#endif
+
 /**
  * hif_exec_context: only ever allocated as a subtype eg.
  *					hif_tasklet_exec_context
@@ -904,6 +904,16 @@ void hif_send_complete_check(struct hif_opaque_softc *scn,
 	/* NO-OP*/
 }
 
+void hif_send_batch_begin(struct hif_opaque_softc *scn, uint8_t pipe)
+{
+	/* NO-OP*/
+}
+
+void hif_send_batch_end(struct hif_opaque_softc *scn, uint8_t pipe)
+{
+	/* NO-OP*/
+}
+
 /* diagnostic command defnitions */
 #define USB_CTRL_DIAG_CC_READ       0
 #define USB_CTRL_DIAG_CC_WRITE      1
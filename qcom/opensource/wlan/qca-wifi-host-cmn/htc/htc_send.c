@@ -742,6 +742,8 @@ static QDF_STATUS htc_issue_packets(HTC_TARGET *target,
 	void *ctx = NULL;
 	bool rt_put_in_resp;
 	int32_t sys_state = HIF_SYSTEM_PM_STATE_ON;
+	bool doorbell_batch = false;
+	uint32_t rt_put_deferred = 0;
 
 	update_ep_padding_credit =
 			pEndpoint->EpCallBacks.ep_padding_credit_update;
@@ -751,6 +753,13 @@ static QDF_STATUS htc_issue_packets(HTC_TARGET *target,
 	AR_DEBUG_PRINTF(ATH_DEBUG_SEND,
 			("+htc_issue_packets: Queue: %pK, Pkts %d\n", pPktQueue,
 			 HTC_PACKET_QUEUE_DEPTH(pPktQueue)));
+
+	/* Hand a burst of queued messages to the target with one doorbell */
+	if (HTC_PACKET_QUEUE_DEPTH(pPktQueue) > 1) {
+		hif_send_batch_begin(target->hif_dev, pEndpoint->UL_PipeID);
+		doorbell_batch = true;
+	}
+
 	while (true) {
 		rt_put_in_resp = false;
 		if (HTC_TX_BUNDLE_ENABLED(target) &&
@@ -858,6 +867,12 @@ static QDF_STATUS htc_issue_packets(HTC_TARGET *target,
 		}
 
 		if (pPacket->PktInfo.AsTx.Tag == HTC_TX_PACKET_SYSTEM_SUSPEND) {
+			/* flush earlier messages before the bus suspends */
+			if (doorbell_batch) {
+				hif_send_batch_end(target->hif_dev,
+						   pEndpoint->UL_PipeID);
+				doorbell_batch = false;
+			}
 			sys_state = hif_system_pm_get_state(target->hif_dev);
 			hif_system_pm_set_state_suspending(target->hif_dev);
 		}
@@ -971,15 +986,30 @@ static QDF_STATUS htc_issue_packets(HTC_TARGET *target,
 			break;
 		}
 		if (rt_put) {
+			rt_put = false;
+			/* keep the bus up until the batch doorbell is rung */
+			if (doorbell_batch) {
+				rt_put_deferred++;
+				continue;
+			}
 			hif_pm_runtime_put(target->hif_dev,
 					   RTPM_ID_HTC);
 			hif_pm_runtime_update_stats(
 					target->hif_dev, RTPM_ID_HTC,
 					HIF_PM_HTC_STATS_PUT_HTT_NO_RESPONSE);
-			rt_put = false;
 		}
 	}
 
+	if (doorbell_batch)
+		hif_send_batch_end(target->hif_dev, pEndpoint->UL_PipeID);
+
+	while (rt_put_deferred--) {
+		hif_pm_runtime_put(target->hif_dev, RTPM_ID_HTC);
+		hif_pm_runtime_update_stats(
+				target->hif_dev, RTPM_ID_HTC,
+				HIF_PM_HTC_STATS_PUT_HTT_NO_RESPONSE);
+	}
+
 	if (qdf_unlikely(QDF_IS_STATUS_ERROR(status))) {
 		if (((status == QDF_STATUS_E_RESOURCES) &&
 		     (pEndpoint->num_requeues_warn > MAX_REQUEUE_WARN)) ||
@@ -1759,7 +1759,8 @@ static inline qdf_nbuf_t qdf_nbuf_next(qdf_nbuf_t buf)
 
 #ifdef NBUF_MEMORY_DEBUG
 
-#define QDF_NET_BUF_TRACK_MAX_SIZE    (1024)
+/* Slots in the nbuf tracking table, a few times the nbufs expected in use */
+#define QDF_NET_BUF_TRACK_MAX_SIZE    (32768)
 
 void qdf_net_buf_debug_init(void);
 void qdf_net_buf_debug_exit(void);
@@ -4245,10 +4246,10 @@ static inline void qdf_nbuf_frag_count_dec(qdf_nbuf_t buf)
 
 #ifdef MEMORY_DEBUG
 /**
- * qdf_nbuf_acquire_track_lock - acquire the nbuf spinlock at the
- * specified index
- * @index: index to get the lock
- * @irq_flag: lock flag for using nbuf lock
+ * qdf_nbuf_acquire_track_lock - enter the nbuf track table read side
+ * section for the specified index
+ * @index: index of the table entry to be read
+ * @irq_flag: unused, the table is read without a lock
  *
  * Return: none
  */
@@ -4256,10 +4257,10 @@ void qdf_nbuf_acquire_track_lock(uint32_t index,
 				 unsigned long irq_flag);
 
 /**
- * qdf_nbuf_release_track_lock - release the nbuf spinlock at the
- * specified index
- * @index: index of the lock to be released
- * @irq_flag: lock flag for using nbuf lock
+ * qdf_nbuf_release_track_lock - leave the nbuf track table read side
+ * section for the specified index
+ * @index: index of the table entry that was read
+ * @irq_flag: unused, the table is read without a lock
  *
  * Return: none
  */
@@ -4271,7 +4272,8 @@ void qdf_nbuf_release_track_lock(uint32_t index,
  * table at the specified index
  * @index: index to get the table entry
  *
- * Return: the QDF_NBUF_TRACK entry at the specified index in the table
+ * Return: the QDF_NBUF_TRACK entry at the specified index in the table, or
+ * NULL if the slot is free. Entries are not chained through p_next.
  */
 QDF_NBUF_TRACK *qdf_nbuf_get_track_tbl(uint32_t index);
 #endif /* MEMORY_DEBUG */
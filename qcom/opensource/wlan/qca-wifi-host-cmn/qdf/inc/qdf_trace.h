@@ -424,6 +424,9 @@ struct qdf_dp_trace_data_buf {
  * @data: buffer to store data
  * @size: Length of the valid data stored in this record
  * @pid : process id which stored the data in this record
+ * @pdev_id: pdev id
+ * @seq: global sequence number, orders records across the per CPU rings.
+ *       0 while the record is being written.
  */
 struct qdf_dp_trace_record_s {
 	uint64_t time;
@@ -432,6 +435,9 @@ struct qdf_dp_trace_record_s {
 	uint8_t size;
 	uint32_t pid;
 	uint8_t pdev_id;
+#ifdef CONFIG_DP_TRACE_PER_CPU
+	uint32_t seq;
+#endif
 };
 
 /**
@@ -782,7 +782,6 @@ qdf_print_major_nbuf_allocs(uint32_t threshold,
 	uint32_t nbuf_iter;
 	unsigned long irq_flag = 0;
 	QDF_NBUF_TRACK *p_node;
-	QDF_NBUF_TRACK *p_prev;
 	struct __qdf_mem_info table[QDF_MEM_STAT_TABLE_SIZE];
 	struct qdf_mem_header meta;
 	bool is_full;
@@ -799,7 +798,7 @@ qdf_print_major_nbuf_allocs(uint32_t threshold,
 	     nbuf_iter++) {
 		qdf_nbuf_acquire_track_lock(nbuf_iter, irq_flag);
 		p_node = qdf_nbuf_get_track_tbl(nbuf_iter);
-		while (p_node) {
+		if (p_node) {
 			meta.line = p_node->line_num;
 			meta.size = p_node->size;
 			meta.caller = NULL;
@@ -814,9 +813,6 @@ qdf_print_major_nbuf_allocs(uint32_t threshold,
 					     print_priv, threshold);
 				qdf_mem_zero(table, sizeof(table));
 			}
-
-			p_prev = p_node;
-			p_node = p_node->p_next;
 		}
 		qdf_nbuf_release_track_lock(nbuf_iter, irq_flag);
 	}
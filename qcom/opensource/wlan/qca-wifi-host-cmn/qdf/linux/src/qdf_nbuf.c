@@ -2393,14 +2393,34 @@ qdf_export_symbol(__qdf_nbuf_is_bcast_pkt);
 
 #ifdef NBUF_MEMORY_DEBUG
 
-static spinlock_t g_qdf_net_buf_track_lock[QDF_NET_BUF_TRACK_MAX_SIZE];
+/*
+ * Tracked nbufs live in a lock-free set-associative table: a nbuf hashes to
+ * two groups of QDF_NET_BUF_TRACK_GROUP_SLOTS slots and is stored in the
+ * first free slot of either. A slot is claimed by a cmpxchg of its nbuf
+ * pointer and released by clearing it, so adding and removing a nbuf only
+ * touches the one or two cache lines of its groups and takes no lock.
+ */
+#define QDF_NET_BUF_TRACK_GROUP_SLOTS 4
+#define QDF_NET_BUF_TRACK_GROUPS \
+	(QDF_NET_BUF_TRACK_MAX_SIZE / QDF_NET_BUF_TRACK_GROUP_SLOTS)
+
+/**
+ * struct qdf_net_buf_track_slot - tracking table slot
+ * @net_buf: tracked nbuf, NULL if the slot is free
+ * @node: tracking cookie of @net_buf, published once it is filled in
+ */
+struct qdf_net_buf_track_slot {
+	qdf_nbuf_t net_buf;
+	QDF_NBUF_TRACK *node;
+};
 
-static QDF_NBUF_TRACK *gp_qdf_net_buf_track_tbl[QDF_NET_BUF_TRACK_MAX_SIZE];
+static struct qdf_net_buf_track_slot
+qdf_net_buf_track_tbl[QDF_NET_BUF_TRACK_MAX_SIZE] ____cacheline_aligned;
 static struct kmem_cache *nbuf_tracking_cache;
 static QDF_NBUF_TRACK *qdf_net_buf_track_free_list;
 static spinlock_t qdf_net_buf_track_free_list_lock;
 static uint32_t qdf_net_buf_track_free_list_count;
-static uint32_t qdf_net_buf_track_used_list_count;
+static atomic_t qdf_net_buf_track_used_list_count;
 static uint32_t qdf_net_buf_track_max_used;
 static uint32_t qdf_net_buf_track_max_free;
 static uint32_t qdf_net_buf_track_max_allocated;
@@ -2416,13 +2436,12 @@ static uint32_t qdf_net_buf_track_fail_count;
  */
 static inline void update_max_used(void)
 {
+	int used = atomic_read(&qdf_net_buf_track_used_list_count);
 	int sum;
 
-	if (qdf_net_buf_track_max_used <
-	    qdf_net_buf_track_used_list_count)
-		qdf_net_buf_track_max_used = qdf_net_buf_track_used_list_count;
-	sum = qdf_net_buf_track_free_list_count +
-		qdf_net_buf_track_used_list_count;
+	if (qdf_net_buf_track_max_used < used)
+		qdf_net_buf_track_max_used = used;
+	sum = qdf_net_buf_track_free_list_count + used;
 	if (qdf_net_buf_track_max_allocated < sum)
 		qdf_net_buf_track_max_allocated = sum;
 }
@@ -2441,10 +2460,98 @@ static inline void update_max_free(void)
 		qdf_net_buf_track_max_free = qdf_net_buf_track_free_list_count;
 }
 
+/* FREEQ_POOLSIZE initial and minimum desired freelist poolsize */
+#define FREEQ_POOLSIZE 2048
+
+/*
+ * Tracking cookies are cached per CPU so that allocating and freeing one
+ * does not take the global freelist lock. The global freelist is only
+ * touched to move QDF_NBUF_TRACK_PCPU_BATCH cookies at a time when a CPU
+ * cache runs empty or overflows.
+ */
+#define QDF_NBUF_TRACK_PCPU_CACHE_SIZE 64
+#define QDF_NBUF_TRACK_PCPU_BATCH (QDF_NBUF_TRACK_PCPU_CACHE_SIZE / 2)
+
+/**
+ * struct qdf_nbuf_track_pcpu_cache - per CPU cache of tracking cookies
+ * @head: singly linked list of free cookies
+ * @count: number of cookies in @head
+ */
+struct qdf_nbuf_track_pcpu_cache {
+	QDF_NBUF_TRACK *head;
+	uint32_t count;
+};
+
+static DEFINE_PER_CPU(struct qdf_nbuf_track_pcpu_cache, qdf_nbuf_track_pcpu);
+
+/**
+ * qdf_nbuf_track_pcpu_refill() - move a batch of cookies to a CPU cache
+ * @cache: CPU cache, with local interrupts disabled
+ *
+ * Return: none
+ */
+static void qdf_nbuf_track_pcpu_refill(struct qdf_nbuf_track_pcpu_cache *cache)
+{
+	QDF_NBUF_TRACK *node;
+
+	spin_lock(&qdf_net_buf_track_free_list_lock);
+	while (qdf_net_buf_track_free_list &&
+	       cache->count < QDF_NBUF_TRACK_PCPU_BATCH) {
+		node = qdf_net_buf_track_free_list;
+		qdf_net_buf_track_free_list = node->p_next;
+		qdf_net_buf_track_free_list_count--;
+		node->p_next = cache->head;
+		cache->head = node;
+		cache->count++;
+	}
+	update_max_used();
+	spin_unlock(&qdf_net_buf_track_free_list_lock);
+}
+
+/**
+ * qdf_nbuf_track_pcpu_drain() - return cookies from a CPU cache
+ * @cache: CPU cache, with local interrupts disabled
+ * @keep: number of cookies to leave in @cache
+ *
+ * Try to shrink the freelist if free_list_count > than FREEQ_POOLSIZE
+ * only shrink the freelist if it is bigger than twice the number of
+ * nbufs in use. If the driver is stalling in a consistent bursty
+ * fasion, this will keep 3/4 of thee allocations from the free list
+ * while also allowing the system to recover memory as less frantic
+ * traffic occurs.
+ *
+ * Return: none
+ */
+static void qdf_nbuf_track_pcpu_drain(struct qdf_nbuf_track_pcpu_cache *cache,
+				      uint32_t keep)
+{
+	QDF_NBUF_TRACK *node;
+	uint32_t used = atomic_read(&qdf_net_buf_track_used_list_count);
+
+	spin_lock(&qdf_net_buf_track_free_list_lock);
+	while (cache->count > keep) {
+		node = cache->head;
+		cache->head = node->p_next;
+		cache->count--;
+
+		if (qdf_net_buf_track_free_list_count > FREEQ_POOLSIZE &&
+		    qdf_net_buf_track_free_list_count > used << 1) {
+			kmem_cache_free(nbuf_tracking_cache, node);
+		} else {
+			node->p_next = qdf_net_buf_track_free_list;
+			qdf_net_buf_track_free_list = node;
+			qdf_net_buf_track_free_list_count++;
+		}
+	}
+	update_max_free();
+	spin_unlock(&qdf_net_buf_track_free_list_lock);
+}
+
 /**
  * qdf_nbuf_track_alloc() - allocate a cookie to track nbufs allocated by wlan
  *
- * This function pulls from a freelist if possible and uses kmem_cache_alloc.
+ * This function pulls from the local CPU cache, refilled in batches from
+ * the global freelist, and falls back to kmem_cache_alloc.
  * This function also ads fexibility to adjust the allocation and freelist
  * scheems.
  *
@@ -2454,18 +2561,21 @@ static QDF_NBUF_TRACK *qdf_nbuf_track_alloc(void)
 {
 	int flags = GFP_KERNEL;
 	unsigned long irq_flag;
+	struct qdf_nbuf_track_pcpu_cache *cache;
 	QDF_NBUF_TRACK *new_node = NULL;
 
-	spin_lock_irqsave(&qdf_net_buf_track_free_list_lock, irq_flag);
-	qdf_net_buf_track_used_list_count++;
-	if (qdf_net_buf_track_free_list) {
-		new_node = qdf_net_buf_track_free_list;
-		qdf_net_buf_track_free_list =
-			qdf_net_buf_track_free_list->p_next;
-		qdf_net_buf_track_free_list_count--;
+	atomic_inc(&qdf_net_buf_track_used_list_count);
+
+	local_irq_save(irq_flag);
+	cache = this_cpu_ptr(&qdf_nbuf_track_pcpu);
+	if (!cache->count)
+		qdf_nbuf_track_pcpu_refill(cache);
+	if (cache->head) {
+		new_node = cache->head;
+		cache->head = new_node->p_next;
+		cache->count--;
 	}
-	update_max_used();
-	spin_unlock_irqrestore(&qdf_net_buf_track_free_list_lock, irq_flag);
+	local_irq_restore(irq_flag);
 
 	if (new_node)
 		return new_node;
@@ -2476,47 +2586,54 @@ static QDF_NBUF_TRACK *qdf_nbuf_track_alloc(void)
 	return kmem_cache_alloc(nbuf_tracking_cache, flags);
 }
 
-/* FREEQ_POOLSIZE initial and minimum desired freelist poolsize */
-#define FREEQ_POOLSIZE 2048
-
 /**
  * qdf_nbuf_track_free() - free the nbuf tracking cookie.
  *
  * Matches calls to qdf_nbuf_track_alloc.
- * Either frees the tracking cookie to kernel or an internal
- * freelist based on the size of the freelist.
+ * Returns the tracking cookie to the local CPU cache. An overflowing
+ * cache is drained in a batch to the internal freelist or the kernel,
+ * based on the size of the freelist.
  *
  * Return: none
  */
 static void qdf_nbuf_track_free(QDF_NBUF_TRACK *node)
 {
 	unsigned long irq_flag;
+	struct qdf_nbuf_track_pcpu_cache *cache;
 
 	if (!node)
 		return;
 
-	/* Try to shrink the freelist if free_list_count > than FREEQ_POOLSIZE
-	 * only shrink the freelist if it is bigger than twice the number of
-	 * nbufs in use. If the driver is stalling in a consistent bursty
-	 * fasion, this will keep 3/4 of thee allocations from the free list
-	 * while also allowing the system to recover memory as less frantic
-	 * traffic occurs.
-	 */
+	atomic_dec(&qdf_net_buf_track_used_list_count);
 
-	spin_lock_irqsave(&qdf_net_buf_track_free_list_lock, irq_flag);
+	local_irq_save(irq_flag);
+	cache = this_cpu_ptr(&qdf_nbuf_track_pcpu);
+	node->p_next = cache->head;
+	cache->head = node;
+	cache->count++;
+	if (cache->count >= QDF_NBUF_TRACK_PCPU_CACHE_SIZE)
+		qdf_nbuf_track_pcpu_drain(cache, QDF_NBUF_TRACK_PCPU_BATCH);
+	local_irq_restore(irq_flag);
+}
 
-	qdf_net_buf_track_used_list_count--;
-	if (qdf_net_buf_track_free_list_count > FREEQ_POOLSIZE &&
-	   (qdf_net_buf_track_free_list_count >
-	    qdf_net_buf_track_used_list_count << 1)) {
-		kmem_cache_free(nbuf_tracking_cache, node);
-	} else {
-		node->p_next = qdf_net_buf_track_free_list;
-		qdf_net_buf_track_free_list = node;
-		qdf_net_buf_track_free_list_count++;
-	}
-	update_max_free();
-	spin_unlock_irqrestore(&qdf_net_buf_track_free_list_lock, irq_flag);
+/**
+ * qdf_nbuf_track_pcpu_flush() - return all CPU cached cookies
+ *
+ * Must only be called while no other CPU is tracking nbufs, i.e. at init
+ * and exit, as the remote CPU caches are accessed without their owners.
+ *
+ * Return: none
+ */
+static void qdf_nbuf_track_pcpu_flush(void)
+{
+	unsigned long irq_flag;
+	int cpu;
+
+	local_irq_save(irq_flag);
+	for_each_possible_cpu(cpu)
+		qdf_nbuf_track_pcpu_drain(per_cpu_ptr(&qdf_nbuf_track_pcpu,
+						      cpu), 0);
+	local_irq_restore(irq_flag);
 }
 
 /**
@@ -2547,6 +2664,7 @@ static void qdf_nbuf_track_prefill(void)
 		qdf_nbuf_track_free(head);
 		head = node;
 	}
+	qdf_nbuf_track_pcpu_flush();
 
 	/* prefilled buffers should not count as used */
 	qdf_net_buf_track_max_used = 0;
@@ -2566,9 +2684,10 @@ static void qdf_nbuf_track_prefill(void)
 static void qdf_nbuf_track_memory_manager_create(void)
 {
 	spin_lock_init(&qdf_net_buf_track_free_list_lock);
+	atomic_set(&qdf_net_buf_track_used_list_count, 0);
 	nbuf_tracking_cache = kmem_cache_create("qdf_nbuf_tracking_cache",
 						sizeof(QDF_NBUF_TRACK),
-						0, 0, NULL);
+						0, SLAB_TYPESAFE_BY_RCU, NULL);
 
 	qdf_nbuf_track_prefill();
 }
@@ -2587,6 +2706,8 @@ static void qdf_nbuf_track_memory_manager_destroy(void)
 	QDF_NBUF_TRACK *node, *tmp;
 	unsigned long irq_flag;
 
+	qdf_nbuf_track_pcpu_flush();
+
 	spin_lock_irqsave(&qdf_net_buf_track_free_list_lock, irq_flag);
 	node = qdf_net_buf_track_free_list;
 
@@ -2632,9 +2753,9 @@ static void qdf_nbuf_track_memory_manager_destroy(void)
 		qdf_info("%d unfreed tracking memory lost in freelist",
 			 qdf_net_buf_track_free_list_count);
 
-	if (qdf_net_buf_track_used_list_count != 0)
+	if (atomic_read(&qdf_net_buf_track_used_list_count) != 0)
 		qdf_info("%d unfreed tracking memory still in use",
-			 qdf_net_buf_track_used_list_count);
+			 atomic_read(&qdf_net_buf_track_used_list_count));
 
 	spin_unlock_irqrestore(&qdf_net_buf_track_free_list_lock, irq_flag);
 	kmem_cache_destroy(nbuf_tracking_cache);
@@ -2667,8 +2788,8 @@ void qdf_net_buf_debug_init(void)
 	qdf_nbuf_track_memory_manager_create();
 
 	for (i = 0; i < QDF_NET_BUF_TRACK_MAX_SIZE; i++) {
-		gp_qdf_net_buf_track_tbl[i] = NULL;
-		spin_lock_init(&g_qdf_net_buf_track_lock[i]);
+		qdf_net_buf_track_tbl[i].net_buf = NULL;
+		qdf_net_buf_track_tbl[i].node = NULL;
 	}
 }
 qdf_export_symbol(qdf_net_buf_debug_init);
@@ -2686,32 +2807,28 @@ void qdf_net_buf_debug_exit(void)
 {
 	uint32_t i;
 	uint32_t count = 0;
-	unsigned long irq_flag;
 	QDF_NBUF_TRACK *p_node;
-	QDF_NBUF_TRACK *p_prev;
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
 	for (i = 0; i < QDF_NET_BUF_TRACK_MAX_SIZE; i++) {
-		spin_lock_irqsave(&g_qdf_net_buf_track_lock[i], irq_flag);
-		p_node = gp_qdf_net_buf_track_tbl[i];
-		while (p_node) {
-			p_prev = p_node;
-			p_node = p_node->p_next;
-			count++;
-			qdf_info("SKB buf memory Leak@ Func %s, @Line %d, size %zu, nbuf %pK",
-				 p_prev->func_name, p_prev->line_num,
-				 p_prev->size, p_prev->net_buf);
-			qdf_info("SKB leak map %s, line %d, unmap %s line %d mapped=%d",
-				 p_prev->map_func_name,
-				 p_prev->map_line_num,
-				 p_prev->unmap_func_name,
-				 p_prev->unmap_line_num,
-				 p_prev->is_nbuf_mapped);
-			qdf_nbuf_track_free(p_prev);
-		}
-		spin_unlock_irqrestore(&g_qdf_net_buf_track_lock[i], irq_flag);
+		p_node = qdf_net_buf_track_tbl[i].node;
+		if (!p_node)
+			continue;
+		count++;
+		qdf_info("SKB buf memory Leak@ Func %s, @Line %d, size %zu, nbuf %pK",
+			 p_node->func_name, p_node->line_num,
+			 p_node->size, p_node->net_buf);
+		qdf_info("SKB leak map %s, line %d, unmap %s line %d mapped=%d",
+			 p_node->map_func_name,
+			 p_node->map_line_num,
+			 p_node->unmap_func_name,
+			 p_node->unmap_line_num,
+			 p_node->is_nbuf_mapped);
+		qdf_net_buf_track_tbl[i].node = NULL;
+		qdf_net_buf_track_tbl[i].net_buf = NULL;
+		qdf_nbuf_track_free(p_node);
 	}
 
 	qdf_nbuf_track_memory_manager_destroy();
@@ -2728,38 +2845,71 @@ qdf_export_symbol(qdf_net_buf_debug_exit);
 
 /**
  * qdf_net_buf_debug_hash() - hash network buffer pointer
+ * @net_buf: network buffer
+ * @group: filled with the first slot of each of the two candidate groups
  *
- * Return: hash value
+ * Return: none
  */
-static uint32_t qdf_net_buf_debug_hash(qdf_nbuf_t net_buf)
+static void qdf_net_buf_debug_hash(qdf_nbuf_t net_buf, uint32_t group[2])
 {
-	uint32_t i;
+	/*
+	 * skbs come from slab caches and share their low address bits, a
+	 * multiplicative hash spreads them over all the groups.
+	 */
+	uint32_t hash = hash_ptr(net_buf, 32);
+	uint32_t first = hash & (QDF_NET_BUF_TRACK_GROUPS - 1);
+	uint32_t second = (hash >> 16) & (QDF_NET_BUF_TRACK_GROUPS - 1);
 
-	i = (uint32_t) (((uintptr_t) net_buf) >> 4);
-	i += (uint32_t) (((uintptr_t) net_buf) >> 14);
-	i &= (QDF_NET_BUF_TRACK_MAX_SIZE - 1);
+	if (second == first)
+		second ^= 1;
 
-	return i;
+	group[0] = first * QDF_NET_BUF_TRACK_GROUP_SLOTS;
+	group[1] = second * QDF_NET_BUF_TRACK_GROUP_SLOTS;
 }
 
 /**
  * qdf_net_buf_debug_look_up() - look up network buffer in debug hash table
  *
- * Return: If skb is found in hash table then return pointer to network buffer
+ * Return: If skb is found in hash table then return pointer to its slot
  *	else return %NULL
  */
-static QDF_NBUF_TRACK *qdf_net_buf_debug_look_up(qdf_nbuf_t net_buf)
-{
-	uint32_t i;
-	QDF_NBUF_TRACK *p_node;
+static struct qdf_net_buf_track_slot *
+qdf_net_buf_debug_look_up(qdf_nbuf_t net_buf)
+{
+	uint32_t group[2];
+	uint32_t i, j;
+	struct qdf_net_buf_track_slot *slot;
+
+	qdf_net_buf_debug_hash(net_buf, group);
+	for (i = 0; i < 2; i++) {
+		slot = &qdf_net_buf_track_tbl[group[i]];
+		for (j = 0; j < QDF_NET_BUF_TRACK_GROUP_SLOTS; j++)
+			if (READ_ONCE(slot[j].net_buf) == net_buf)
+				return &slot[j];
+	}
 
-	i = qdf_net_buf_debug_hash(net_buf);
-	p_node = gp_qdf_net_buf_track_tbl[i];
+	return NULL;
+}
 
-	while (p_node) {
-		if (p_node->net_buf == net_buf)
-			return p_node;
-		p_node = p_node->p_next;
+/**
+ * qdf_net_buf_debug_claim_slot() - claim a free slot for network buffer
+ *
+ * Return: the claimed slot, or %NULL if both groups of @net_buf are full
+ */
+static struct qdf_net_buf_track_slot *
+qdf_net_buf_debug_claim_slot(qdf_nbuf_t net_buf)
+{
+	uint32_t group[2];
+	uint32_t i, j;
+	struct qdf_net_buf_track_slot *slot;
+
+	qdf_net_buf_debug_hash(net_buf, group);
+	for (i = 0; i < 2; i++) {
+		slot = &qdf_net_buf_track_tbl[group[i]];
+		for (j = 0; j < QDF_NET_BUF_TRACK_GROUP_SLOTS; j++)
+			if (!READ_ONCE(slot[j].net_buf) &&
+			    !cmpxchg(&slot[j].net_buf, NULL, net_buf))
+				return &slot[j];
 	}
 
 	return NULL;
@@ -2773,77 +2923,79 @@ static QDF_NBUF_TRACK *qdf_net_buf_debug_look_up(qdf_nbuf_t net_buf)
 void qdf_net_buf_debug_add_node(qdf_nbuf_t net_buf, size_t size,
 				const char *func_name, uint32_t line_num)
 {
-	uint32_t i;
-	unsigned long irq_flag;
+	struct qdf_net_buf_track_slot *slot;
 	QDF_NBUF_TRACK *p_node;
 	QDF_NBUF_TRACK *new_node;
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
-	new_node = qdf_nbuf_track_alloc();
-
-	i = qdf_net_buf_debug_hash(net_buf);
-	spin_lock_irqsave(&g_qdf_net_buf_track_lock[i], irq_flag);
+	slot = qdf_net_buf_debug_look_up(net_buf);
+	if (slot) {
+		p_node = READ_ONCE(slot->node);
+		if (p_node)
+			qdf_print("Double allocation of skb ! Already allocated from %pK %s %d current alloc from %pK %s %d",
+				  p_node->net_buf, p_node->func_name,
+				  p_node->line_num, net_buf, func_name,
+				  line_num);
+		return;
+	}
 
-	p_node = qdf_net_buf_debug_look_up(net_buf);
+	new_node = qdf_nbuf_track_alloc();
+	if (!new_node)
+		goto fail;
 
-	if (p_node) {
-		qdf_print("Double allocation of skb ! Already allocated from %pK %s %d current alloc from %pK %s %d",
-			  p_node->net_buf, p_node->func_name, p_node->line_num,
-			  net_buf, func_name, line_num);
+	new_node->p_next = NULL;
+	new_node->net_buf = net_buf;
+	qdf_str_lcopy(new_node->func_name, func_name, QDF_MEM_FUNC_NAME_SIZE);
+	new_node->line_num = line_num;
+	new_node->is_nbuf_mapped = false;
+	new_node->map_line_num = 0;
+	new_node->unmap_line_num = 0;
+	new_node->map_func_name[0] = '\0';
+	new_node->unmap_func_name[0] = '\0';
+	new_node->size = size;
+	new_node->time = qdf_get_log_timestamp();
+
+	slot = qdf_net_buf_debug_claim_slot(net_buf);
+	if (!slot) {
 		qdf_nbuf_track_free(new_node);
-	} else {
-		p_node = new_node;
-		if (p_node) {
-			p_node->net_buf = net_buf;
-			qdf_str_lcopy(p_node->func_name, func_name,
-				      QDF_MEM_FUNC_NAME_SIZE);
-			p_node->line_num = line_num;
-			p_node->is_nbuf_mapped = false;
-			p_node->map_line_num = 0;
-			p_node->unmap_line_num = 0;
-			p_node->map_func_name[0] = '\0';
-			p_node->unmap_func_name[0] = '\0';
-			p_node->size = size;
-			p_node->time = qdf_get_log_timestamp();
-			qdf_mem_skb_inc(size);
-			p_node->p_next = gp_qdf_net_buf_track_tbl[i];
-			gp_qdf_net_buf_track_tbl[i] = p_node;
-		} else {
-			qdf_net_buf_track_fail_count++;
-			qdf_print(
-				  "Mem alloc failed ! Could not track skb from %s %d of size %zu",
-				  func_name, line_num, size);
-		}
+		goto fail;
 	}
 
-	spin_unlock_irqrestore(&g_qdf_net_buf_track_lock[i], irq_flag);
+	qdf_mem_skb_inc(size);
+	/* table walkers only read a cookie once it is filled in */
+	smp_store_release(&slot->node, new_node);
+	return;
+
+fail:
+	qdf_net_buf_track_fail_count++;
+	qdf_print("Mem alloc failed ! Could not track skb from %s %d of size %zu",
+		  func_name, line_num, size);
 }
 qdf_export_symbol(qdf_net_buf_debug_add_node);
 
+/*
+ * The update helpers below run on behalf of the nbuf owner, which is the
+ * only one that can add or delete the nbuf, so its cookie is stable.
+ */
 void qdf_net_buf_debug_update_node(qdf_nbuf_t net_buf, const char *func_name,
 				   uint32_t line_num)
 {
-	uint32_t i;
-	unsigned long irq_flag;
+	struct qdf_net_buf_track_slot *slot;
 	QDF_NBUF_TRACK *p_node;
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
-	i = qdf_net_buf_debug_hash(net_buf);
-	spin_lock_irqsave(&g_qdf_net_buf_track_lock[i], irq_flag);
-
-	p_node = qdf_net_buf_debug_look_up(net_buf);
+	slot = qdf_net_buf_debug_look_up(net_buf);
+	p_node = slot ? READ_ONCE(slot->node) : NULL;
 
 	if (p_node) {
 		qdf_str_lcopy(p_node->func_name, kbasename(func_name),
 			      QDF_MEM_FUNC_NAME_SIZE);
 		p_node->line_num = line_num;
 	}
-
-	spin_unlock_irqrestore(&g_qdf_net_buf_track_lock[i], irq_flag);
 }
 
 qdf_export_symbol(qdf_net_buf_debug_update_node);
@@ -2852,17 +3004,14 @@ void qdf_net_buf_debug_update_map_node(qdf_nbuf_t net_buf,
 				       const char *func_name,
 				       uint32_t line_num)
 {
-	uint32_t i;
-	unsigned long irq_flag;
+	struct qdf_net_buf_track_slot *slot;
 	QDF_NBUF_TRACK *p_node;
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
-	i = qdf_net_buf_debug_hash(net_buf);
-	spin_lock_irqsave(&g_qdf_net_buf_track_lock[i], irq_flag);
-
-	p_node = qdf_net_buf_debug_look_up(net_buf);
+	slot = qdf_net_buf_debug_look_up(net_buf);
+	p_node = slot ? READ_ONCE(slot->node) : NULL;
 
 	if (p_node) {
 		qdf_str_lcopy(p_node->map_func_name, func_name,
@@ -2870,24 +3019,20 @@ void qdf_net_buf_debug_update_map_node(qdf_nbuf_t net_buf,
 		p_node->map_line_num = line_num;
 		p_node->is_nbuf_mapped = true;
 	}
-	spin_unlock_irqrestore(&g_qdf_net_buf_track_lock[i], irq_flag);
 }
 
 void qdf_net_buf_debug_update_unmap_node(qdf_nbuf_t net_buf,
 					 const char *func_name,
 					 uint32_t line_num)
 {
-	uint32_t i;
-	unsigned long irq_flag;
+	struct qdf_net_buf_track_slot *slot;
 	QDF_NBUF_TRACK *p_node;
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
-	i = qdf_net_buf_debug_hash(net_buf);
-	spin_lock_irqsave(&g_qdf_net_buf_track_lock[i], irq_flag);
-
-	p_node = qdf_net_buf_debug_look_up(net_buf);
+	slot = qdf_net_buf_debug_look_up(net_buf);
+	p_node = slot ? READ_ONCE(slot->node) : NULL;
 
 	if (p_node) {
 		qdf_str_lcopy(p_node->unmap_func_name, func_name,
@@ -2895,7 +3040,6 @@ void qdf_net_buf_debug_update_unmap_node(qdf_nbuf_t net_buf,
 		p_node->unmap_line_num = line_num;
 		p_node->is_nbuf_mapped = false;
 	}
-	spin_unlock_irqrestore(&g_qdf_net_buf_track_lock[i], irq_flag);
 }
 
 /**
@@ -2905,44 +3049,20 @@ void qdf_net_buf_debug_update_unmap_node(qdf_nbuf_t net_buf,
  */
 void qdf_net_buf_debug_delete_node(qdf_nbuf_t net_buf)
 {
-	uint32_t i;
-	QDF_NBUF_TRACK *p_head;
+	struct qdf_net_buf_track_slot *slot;
 	QDF_NBUF_TRACK *p_node = NULL;
-	unsigned long irq_flag;
-	QDF_NBUF_TRACK *p_prev;
 
 	if (is_initial_mem_debug_disabled)
 		return;
 
-	i = qdf_net_buf_debug_hash(net_buf);
-	spin_lock_irqsave(&g_qdf_net_buf_track_lock[i], irq_flag);
-
-	p_head = gp_qdf_net_buf_track_tbl[i];
-
-	/* Unallocated SKB */
-	if (!p_head)
-		goto done;
-
-	p_node = p_head;
-	/* Found at head of the table */
-	if (p_head->net_buf == net_buf) {
-		gp_qdf_net_buf_track_tbl[i] = p_node->p_next;
-		goto done;
+	slot = qdf_net_buf_debug_look_up(net_buf);
+	if (slot) {
+		p_node = READ_ONCE(slot->node);
+		WRITE_ONCE(slot->node, NULL);
+		/* the cookie is unhooked before the slot can be claimed again */
+		smp_store_release(&slot->net_buf, NULL);
 	}
 
-	/* Search in collision list */
-	while (p_node) {
-		p_prev = p_node;
-		p_node = p_node->p_next;
-		if ((p_node) && (p_node->net_buf == net_buf)) {
-			p_prev->p_next = p_node->p_next;
-			break;
-		}
-	}
-
-done:
-	spin_unlock_irqrestore(&g_qdf_net_buf_track_lock[i], irq_flag);
-
 	if (p_node) {
 		qdf_mem_skb_dec(p_node->size);
 		qdf_nbuf_track_free(p_node);
@@ -5466,23 +5586,26 @@ qdf_export_symbol(qdf_net_buf_debug_release_frag);
 #endif /* NBUF_FRAG_MEMORY_DEBUG */
 
 #ifdef MEMORY_DEBUG
+/*
+ * Table walkers run under RCU: a cookie they read may be freed and reused
+ * meanwhile, but the tracking cache is SLAB_TYPESAFE_BY_RCU so its memory
+ * stays a QDF_NBUF_TRACK until the walker is done.
+ */
 void qdf_nbuf_acquire_track_lock(uint32_t index,
 				 unsigned long irq_flag)
 {
-	spin_lock_irqsave(&g_qdf_net_buf_track_lock[index],
-			  irq_flag);
+	rcu_read_lock();
 }
 
 void qdf_nbuf_release_track_lock(uint32_t index,
 				 unsigned long irq_flag)
 {
-	spin_unlock_irqrestore(&g_qdf_net_buf_track_lock[index],
-			       irq_flag);
+	rcu_read_unlock();
 }
 
 QDF_NBUF_TRACK *qdf_nbuf_get_track_tbl(uint32_t index)
 {
-	return gp_qdf_net_buf_track_tbl[index];
+	return smp_load_acquire(&qdf_net_buf_track_tbl[index].node);
 }
 #endif /* MEMORY_DEBUG */
 
@@ -52,6 +52,11 @@ qdf_declare_param(qdf_log_flush_timer_period, uint);
 #include <wlan_connectivity_logging.h>
 #endif
 
+#ifdef CONFIG_DP_TRACE_PER_CPU
+#include <linux/percpu.h>
+#include <linux/log2.h>
+#endif
+
 /* Global qdf print id */
 
 /* Preprocessor definitions and constants */
@@ -98,6 +103,40 @@ static struct qdf_dp_trace_record_s
 #endif
 static spinlock_t l_dp_trace_lock;
 
+#ifdef CONFIG_DP_TRACE_PER_CPU
+/* Lower bound on the records kept per CPU */
+#define QDF_DP_TRACE_CPU_MIN_RECORDS 64
+
+/**
+ * struct qdf_dp_trace_cpu_ring - per CPU DP trace ring
+ * @tbl: records of this CPU, a slice of g_qdf_dp_trace_cpu_tbl
+ * @tail: free running count of records reserved on this CPU
+ * @merge_pos: read cursor while merging, walks down from the newest record
+ * @merge_end: oldest position still valid when the merge started
+ * @tx_count: TX packets seen by qdf_dp_trace_set_track() on this CPU
+ * @rx_count: RX packets seen by qdf_dp_trace_set_track() on this CPU
+ *
+ * Writers only touch the ring of the CPU they run on, the global order is
+ * kept by the sequence number stamped in each record. g_qdf_dp_trace_tbl is
+ * not written in this mode, it is rebuilt from the rings by
+ * qdf_dp_trace_merge_cpu_rings() for the dump helpers.
+ */
+struct qdf_dp_trace_cpu_ring {
+	struct qdf_dp_trace_record_s *tbl;
+	uint32_t tail;
+	uint32_t merge_pos;
+	uint32_t merge_end;
+	uint32_t tx_count;
+	uint32_t rx_count;
+};
+
+static DEFINE_PER_CPU(struct qdf_dp_trace_cpu_ring, qdf_dp_trace_cpu_ring);
+static struct qdf_dp_trace_record_s *g_qdf_dp_trace_cpu_tbl;
+/* records per CPU ring, power of 2 */
+static uint32_t g_qdf_dp_trace_cpu_records;
+static qdf_atomic_t g_qdf_dp_trace_seq;
+#endif
+
 /*
  * all the options to configure/control DP trace are
  * defined in this structure
@@ -694,6 +733,269 @@ static inline void free_g_qdf_dp_trace_tbl_buffer(void)
 { }
 #endif
 
+#ifdef CONFIG_DP_TRACE_PER_CPU
+/**
+ * qdf_dp_trace_cpu_rings_alloc() - allocate the per CPU DP trace rings
+ *
+ * The global record budget is split across the possible CPUs, so merging
+ * all rings fits in g_qdf_dp_trace_tbl unless the per CPU floor kicks in.
+ *
+ * Return: QDF_STATUS_SUCCESS on success
+ */
+static QDF_STATUS qdf_dp_trace_cpu_rings_alloc(void)
+{
+	struct qdf_dp_trace_cpu_ring *ring;
+	uint32_t records;
+	int cpu;
+
+	records = MAX_QDF_DP_TRACE_RECORDS / num_possible_cpus();
+	if (records < QDF_DP_TRACE_CPU_MIN_RECORDS)
+		records = QDF_DP_TRACE_CPU_MIN_RECORDS;
+	records = rounddown_pow_of_two(records);
+
+	g_qdf_dp_trace_cpu_tbl = qdf_mem_valloc(nr_cpu_ids * records *
+						sizeof(*g_qdf_dp_trace_cpu_tbl));
+	if (!g_qdf_dp_trace_cpu_tbl)
+		return QDF_STATUS_E_NOMEM;
+
+	g_qdf_dp_trace_cpu_records = records;
+	for_each_possible_cpu(cpu) {
+		ring = per_cpu_ptr(&qdf_dp_trace_cpu_ring, cpu);
+		qdf_mem_zero(ring, sizeof(*ring));
+		ring->tbl = &g_qdf_dp_trace_cpu_tbl[cpu * records];
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * qdf_dp_trace_cpu_rings_free() - free the per CPU DP trace rings
+ *
+ * Return: None
+ */
+static void qdf_dp_trace_cpu_rings_free(void)
+{
+	struct qdf_dp_trace_cpu_ring *ring;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		ring = per_cpu_ptr(&qdf_dp_trace_cpu_ring, cpu);
+		ring->tbl = NULL;
+	}
+
+	qdf_mem_vfree(g_qdf_dp_trace_cpu_tbl);
+	g_qdf_dp_trace_cpu_tbl = NULL;
+}
+
+/**
+ * qdf_dp_trace_cpu_rings_clear() - drop all records from the per CPU rings
+ *
+ * Return: None
+ */
+static void qdf_dp_trace_cpu_rings_clear(void)
+{
+	struct qdf_dp_trace_cpu_ring *ring;
+	int cpu;
+
+	if (!g_qdf_dp_trace_cpu_tbl)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		ring = per_cpu_ptr(&qdf_dp_trace_cpu_ring, cpu);
+		ring->tail = 0;
+	}
+
+	memset(g_qdf_dp_trace_cpu_tbl, 0,
+	       nr_cpu_ids * g_qdf_dp_trace_cpu_records *
+	       sizeof(*g_qdf_dp_trace_cpu_tbl));
+}
+
+/**
+ * qdf_dp_trace_cpu_reserve() - reserve the next record on the local CPU ring
+ * @seq: filled with the global sequence number of the record
+ *
+ * The sequence number and the slot are taken with local interrupts off so
+ * each CPU ring stays in sequence order, no lock is shared between CPUs.
+ * The record is marked in progress until qdf_dp_trace_cpu_commit().
+ *
+ * Return: record to fill
+ */
+static struct qdf_dp_trace_record_s *qdf_dp_trace_cpu_reserve(uint32_t *seq)
+{
+	struct qdf_dp_trace_cpu_ring *ring;
+	struct qdf_dp_trace_record_s *rec;
+	unsigned long flags;
+	uint32_t pos;
+
+	local_irq_save(flags);
+	ring = this_cpu_ptr(&qdf_dp_trace_cpu_ring);
+	do {
+		*seq = (uint32_t)qdf_atomic_inc_return(&g_qdf_dp_trace_seq);
+	} while (qdf_unlikely(!*seq));
+	pos = ring->tail++;
+	local_irq_restore(flags);
+
+	rec = &ring->tbl[pos & (g_qdf_dp_trace_cpu_records - 1)];
+	WRITE_ONCE(rec->seq, 0);
+	smp_wmb();
+
+	return rec;
+}
+
+/**
+ * qdf_dp_trace_cpu_commit() - publish a record filled after reservation
+ * @rec: record
+ * @seq: sequence number from qdf_dp_trace_cpu_reserve()
+ *
+ * Return: None
+ */
+static inline void
+qdf_dp_trace_cpu_commit(struct qdf_dp_trace_record_s *rec, uint32_t seq)
+{
+	smp_wmb();
+	WRITE_ONCE(rec->seq, seq);
+}
+
+/**
+ * qdf_dp_trace_cpu_ring_peek() - sequence number of the newest record not
+ *  merged yet from a CPU ring
+ * @ring: CPU ring
+ * @max_seq: sequence number at merge start, newer records are skipped
+ *
+ * Records in progress or already overwritten are stepped over. Sequence
+ * numbers are compared with a signed difference as they wrap.
+ *
+ * Return: sequence number, 0 once the ring is exhausted
+ */
+static uint32_t qdf_dp_trace_cpu_ring_peek(struct qdf_dp_trace_cpu_ring *ring,
+					   uint32_t max_seq)
+{
+	struct qdf_dp_trace_record_s *rec;
+	uint32_t seq;
+
+	while (ring->merge_pos != ring->merge_end) {
+		rec = &ring->tbl[(ring->merge_pos - 1) &
+				 (g_qdf_dp_trace_cpu_records - 1)];
+		seq = READ_ONCE(rec->seq);
+		if (seq && (int32_t)(seq - max_seq) <= 0)
+			return seq;
+		ring->merge_pos--;
+	}
+
+	return 0;
+}
+
+/**
+ * qdf_dp_trace_merge_cpu_rings() - rebuild g_qdf_dp_trace_tbl from the per
+ *  CPU rings
+ *
+ * The newest records across all CPUs are copied in sequence order to the end
+ * of g_qdf_dp_trace_tbl and head/tail/num are set to describe them, so the
+ * dump helpers walk the result as a single ring. Writers keep running, a
+ * record rewritten while being copied is dropped. The per CPU packet counts
+ * are summed into tx_count/rx_count on the way.
+ *
+ * Caller holds l_dp_trace_lock.
+ *
+ * Return: None
+ */
+static void qdf_dp_trace_merge_cpu_rings(void)
+{
+	struct qdf_dp_trace_cpu_ring *ring;
+	struct qdf_dp_trace_cpu_ring *best;
+	struct qdf_dp_trace_record_s *src;
+	struct qdf_dp_trace_record_s *dst;
+	uint32_t idx = MAX_QDF_DP_TRACE_RECORDS;
+	uint32_t tx_count = 0, rx_count = 0;
+	uint32_t seq, best_seq, max_seq, tail;
+	int cpu;
+
+	if (!g_qdf_dp_trace_cpu_tbl)
+		return;
+
+	max_seq = (uint32_t)qdf_atomic_read(&g_qdf_dp_trace_seq);
+	for_each_possible_cpu(cpu) {
+		ring = per_cpu_ptr(&qdf_dp_trace_cpu_ring, cpu);
+		tail = READ_ONCE(ring->tail);
+		ring->merge_pos = tail;
+		/* slots never written still have seq 0 and are skipped */
+		ring->merge_end = tail - g_qdf_dp_trace_cpu_records;
+		tx_count += ring->tx_count;
+		rx_count += ring->rx_count;
+	}
+	g_qdf_dp_trace_data.tx_count = tx_count;
+	g_qdf_dp_trace_data.rx_count = rx_count;
+
+	while (idx) {
+		best = NULL;
+		best_seq = 0;
+		for_each_possible_cpu(cpu) {
+			ring = per_cpu_ptr(&qdf_dp_trace_cpu_ring, cpu);
+			seq = qdf_dp_trace_cpu_ring_peek(ring, max_seq);
+			if (seq && (!best || (int32_t)(seq - best_seq) > 0)) {
+				best_seq = seq;
+				best = ring;
+			}
+		}
+
+		if (!best)
+			break;
+
+		src = &best->tbl[(best->merge_pos - 1) &
+				 (g_qdf_dp_trace_cpu_records - 1)];
+		dst = &g_qdf_dp_trace_tbl[idx - 1];
+		/* pairs with the smp_wmb() in qdf_dp_trace_cpu_commit() */
+		smp_rmb();
+		*dst = *src;
+		/* pairs with the smp_wmb() in qdf_dp_trace_cpu_reserve() */
+		smp_rmb();
+		if (READ_ONCE(src->seq) == best_seq)
+			idx--;
+		best->merge_pos--;
+	}
+
+	if (idx == MAX_QDF_DP_TRACE_RECORDS) {
+		g_qdf_dp_trace_data.head = INVALID_QDF_DP_TRACE_ADDR;
+		g_qdf_dp_trace_data.tail = INVALID_QDF_DP_TRACE_ADDR;
+		g_qdf_dp_trace_data.num = 0;
+		return;
+	}
+
+	g_qdf_dp_trace_data.head = idx;
+	g_qdf_dp_trace_data.tail = MAX_QDF_DP_TRACE_RECORDS - 1;
+	g_qdf_dp_trace_data.num = MAX_QDF_DP_TRACE_RECORDS - idx;
+}
+#else
+static inline QDF_STATUS qdf_dp_trace_cpu_rings_alloc(void)
+{
+	return QDF_STATUS_SUCCESS;
+}
+
+static inline void qdf_dp_trace_cpu_rings_free(void)
+{
+}
+
+static inline void qdf_dp_trace_cpu_rings_clear(void)
+{
+}
+
+static inline void qdf_dp_trace_merge_cpu_rings(void)
+{
+}
+#endif /* CONFIG_DP_TRACE_PER_CPU */
+
+/**
+ * qdf_dp_trace_snapshot() - bring g_qdf_dp_trace_tbl up to date for a dump
+ *
+ * Return: None
+ */
+static void qdf_dp_trace_snapshot(void)
+{
+	spin_lock_bh(&l_dp_trace_lock);
+	qdf_dp_trace_merge_cpu_rings();
+	spin_unlock_bh(&l_dp_trace_lock);
+}
+
 #define QDF_DP_TRACE_PREPEND_STR_SIZE 100
 /*
  * one dp trace record can't be greater than 300 bytes.
@@ -739,6 +1041,12 @@ void qdf_dp_trace_init(bool live_mode_config, uint8_t thresh,
 				"Failed!!! DP Trace buffer allocation");
 		return;
 	}
+	if (qdf_dp_trace_cpu_rings_alloc() != QDF_STATUS_SUCCESS) {
+		QDF_TRACE_ERROR(QDF_MODULE_ID_QDF,
+				"Failed!!! DP Trace per CPU buffer allocation");
+		free_g_qdf_dp_trace_tbl_buffer();
+		return;
+	}
 	qdf_dp_trace_spin_lock_init();
 	qdf_dp_trace_clear_buffer();
 	g_qdf_dp_trace_data.enable = true;
@@ -795,6 +1103,7 @@ void qdf_dp_trace_deinit(void)
 	g_qdf_dp_trace_data.no_of_record = 0;
 	spin_unlock_bh(&l_dp_trace_lock);
 
+	qdf_dp_trace_cpu_rings_free();
 	free_g_qdf_dp_trace_tbl_buffer();
 }
 /**
@@ -946,6 +1255,29 @@ uint32_t qdf_dp_get_proto_bitmap(void)
  *
  * Return: None
  */
+#ifdef CONFIG_DP_TRACE_PER_CPU
+void qdf_dp_trace_set_track(qdf_nbuf_t nbuf, enum qdf_proto_dir dir)
+{
+	uint32_t count = 0;
+	uint8_t no_of_record = g_qdf_dp_trace_data.no_of_record;
+
+	if (!g_qdf_dp_trace_data.enable)
+		return;
+
+	/* every nth packet per CPU, same sampling rate without the lock */
+	if (QDF_TX == dir)
+		count = this_cpu_inc_return(qdf_dp_trace_cpu_ring.tx_count);
+	else if (QDF_RX == dir)
+		count = this_cpu_inc_return(qdf_dp_trace_cpu_ring.rx_count);
+
+	if (no_of_record != 0 && (count % no_of_record == 0)) {
+		if (QDF_TX == dir)
+			QDF_NBUF_CB_TX_DP_TRACE(nbuf) = 1;
+		else if (QDF_RX == dir)
+			QDF_NBUF_CB_RX_DP_TRACE(nbuf) = 1;
+	}
+}
+#else
 void qdf_dp_trace_set_track(qdf_nbuf_t nbuf, enum qdf_proto_dir dir)
 {
 	uint32_t count = 0;
@@ -968,6 +1300,7 @@ void qdf_dp_trace_set_track(qdf_nbuf_t nbuf, enum qdf_proto_dir dir)
 	}
 	spin_unlock_bh(&l_dp_trace_lock);
 }
+#endif
 qdf_export_symbol(qdf_dp_trace_set_track);
 
 /* Number of bytes to be grouped together while printing DP-Trace data */
@@ -1354,6 +1687,34 @@ end:
 	rec->size = data_to_copy;
 }
 
+/**
+ * qdf_dp_trace_live_mode_check() - check if a record is printed live
+ * @print: true to print the record regardless of live mode
+ * @info: record info, QDF_DP_TRACE_RECORD_INFO_THROTTLED is set in it when
+ *        this record turns live mode off
+ *
+ * Return: true if the record is to be printed
+ */
+static bool qdf_dp_trace_live_mode_check(bool print, u8 *info)
+{
+	if (print || g_qdf_dp_trace_data.force_live_mode)
+		return true;
+
+	if (g_qdf_dp_trace_data.live_mode != 1)
+		return false;
+
+	g_qdf_dp_trace_data.print_pkt_cnt++;
+	if (g_qdf_dp_trace_data.print_pkt_cnt >
+			g_qdf_dp_trace_data.high_tput_thresh) {
+		g_qdf_dp_trace_data.live_mode = 0;
+		g_qdf_dp_trace_data.verbosity =
+				QDF_DP_TRACE_VERBOSITY_ULTRA_LOW;
+		*info |= QDF_DP_TRACE_RECORD_INFO_THROTTLED;
+	}
+
+	return true;
+}
+
 /**
  * qdf_dp_add_record() - add dp trace record
  * @code: dptrace code
@@ -1367,6 +1728,44 @@ end:
  *
  * Return: none
  */
+#ifdef CONFIG_DP_TRACE_PER_CPU
+static void qdf_dp_add_record(enum QDF_DP_TRACE_ID code, uint8_t pdev_id,
+			      uint8_t *data, uint8_t data_size,
+			      uint8_t *meta_data, uint8_t metadata_size,
+			      bool print)
+
+{
+	struct qdf_dp_trace_record_s *rec;
+	bool print_this_record;
+	uint32_t seq;
+	u8 info = 0;
+
+	if (code >= QDF_DP_TRACE_MAX) {
+		QDF_TRACE_ERROR(QDF_MODULE_ID_QDF,
+				"invalid record code %u, max code %u",
+				code, QDF_DP_TRACE_MAX);
+		return;
+	}
+
+	/* live mode accounting is a throttle, a lost update is harmless */
+	print_this_record = qdf_dp_trace_live_mode_check(print, &info);
+
+	rec = qdf_dp_trace_cpu_reserve(&seq);
+	rec->code = code;
+	rec->pdev_id = pdev_id;
+	rec->size = 0;
+	qdf_dp_fill_record_data(rec, data, data_size,
+				meta_data, metadata_size);
+	rec->time = qdf_get_log_timestamp();
+	rec->pid = (in_interrupt() ? 0 : current->pid);
+	qdf_dp_trace_cpu_commit(rec, seq);
+
+	info |= QDF_DP_TRACE_RECORD_INFO_LIVE;
+	if (print_this_record)
+		qdf_dp_trace_cb_table[code](rec, (uint16_t)seq,
+					    QDF_TRACE_DEFAULT_PDEV_ID, info);
+}
+#else
 static void qdf_dp_add_record(enum QDF_DP_TRACE_ID code, uint8_t pdev_id,
 			      uint8_t *data, uint8_t data_size,
 			      uint8_t *meta_data, uint8_t metadata_size,
@@ -1387,19 +1786,7 @@ static void qdf_dp_add_record(enum QDF_DP_TRACE_ID code, uint8_t pdev_id,
 
 	spin_lock_bh(&l_dp_trace_lock);
 
-	if (print || g_qdf_dp_trace_data.force_live_mode) {
-		print_this_record = true;
-	} else if (g_qdf_dp_trace_data.live_mode == 1) {
-		print_this_record = true;
-		g_qdf_dp_trace_data.print_pkt_cnt++;
-		if (g_qdf_dp_trace_data.print_pkt_cnt >
-				g_qdf_dp_trace_data.high_tput_thresh) {
-			g_qdf_dp_trace_data.live_mode = 0;
-			g_qdf_dp_trace_data.verbosity =
-					QDF_DP_TRACE_VERBOSITY_ULTRA_LOW;
-			info |= QDF_DP_TRACE_RECORD_INFO_THROTTLED;
-		}
-	}
+	print_this_record = qdf_dp_trace_live_mode_check(print, &info);
 
 	g_qdf_dp_trace_data.num++;
 
@@ -1449,6 +1836,7 @@ static void qdf_dp_add_record(enum QDF_DP_TRACE_ID code, uint8_t pdev_id,
 		qdf_dp_trace_cb_table[rec->code] (rec, index,
 					QDF_TRACE_DEFAULT_PDEV_ID, info);
 }
+#endif /* CONFIG_DP_TRACE_PER_CPU */
 
 /**
  * qdf_get_rate_limit_by_type() - Get the rate limit by pkt type
@@ -2690,10 +3078,12 @@ void qdf_dp_trace_clear_buffer(void)
 	g_qdf_dp_trace_data.num = 0;
 	g_qdf_dp_trace_data.dump_counter = 0;
 	g_qdf_dp_trace_data.num_records_to_dump = MAX_QDF_DP_TRACE_RECORDS;
-	if (g_qdf_dp_trace_data.enable)
+	if (g_qdf_dp_trace_data.enable) {
 		memset(g_qdf_dp_trace_tbl, 0,
 		       MAX_QDF_DP_TRACE_RECORDS *
 		       sizeof(struct qdf_dp_trace_record_s));
+		qdf_dp_trace_cpu_rings_clear();
+	}
 }
 qdf_export_symbol(qdf_dp_trace_clear_buffer);
 
@@ -2902,7 +3292,7 @@ uint32_t qdf_dpt_get_curr_pos_debugfs(qdf_debugfs_file_t file,
 {
 	uint32_t i = 0;
 	uint32_t tail;
-	uint32_t count = g_qdf_dp_trace_data.num;
+	uint32_t count;
 
 	if (!g_qdf_dp_trace_data.enable) {
 		QDF_TRACE(QDF_MODULE_ID_QDF, QDF_TRACE_LEVEL_DEBUG,
@@ -2910,6 +3300,10 @@ uint32_t qdf_dpt_get_curr_pos_debugfs(qdf_debugfs_file_t file,
 		return QDF_STATUS_E_EMPTY;
 	}
 
+	if (state != QDF_DPT_DEBUGFS_STATE_SHOW_IN_PROGRESS)
+		qdf_dp_trace_snapshot();
+
+	count = g_qdf_dp_trace_data.num;
 	if (!count) {
 		QDF_TRACE(QDF_MODULE_ID_QDF, QDF_TRACE_LEVEL_DEBUG,
 		  "%s: no packets", __func__);
@@ -3158,6 +3552,7 @@ void qdf_dp_trace_dump_all(uint32_t count, uint8_t pdev_id)
 		g_qdf_dp_trace_data.high_tput_thresh,
 		g_qdf_dp_trace_data.thresh_time_limit);
 
+	qdf_dp_trace_snapshot();
 	qdf_dp_trace_dump_stats();
 
 	DPTRACE_PRINT("DPT: Total Records: %d, Head: %d, Tail: %d",
@@ -37,6 +37,55 @@
 #ifdef CFR_USE_FIXED_FOLDER
 static wdi_event_subscribe g_cfr_subscribe;
 
+#ifdef DP_MON_PPDU_BATCH
+/* Monitor status batches PPDU indications, only CFR captures need an nbuf */
+#define CFR_PPDU_DESC_EVENT WDI_EVENT_RX_PPDU_DESC_BATCH
+
+static void target_cfr_callback(void *pdev_obj, enum WDI_EVENT event,
+				void *data, u_int16_t peer_id,
+				uint32_t status)
+{
+	struct wlan_objmgr_pdev *pdev;
+	struct cdp_rx_indication_ppdu_batch *ppdu_vec;
+	struct cdp_rx_indication_ppdu *cdp_rx_ppdu;
+	qdf_nbuf_t nbuf;
+	uint32_t i;
+
+	pdev = (struct wlan_objmgr_pdev *)pdev_obj;
+	if (qdf_unlikely((!pdev || !data))) {
+		cfr_err("Invalid pdev %pK or data %pK for event %d",
+			pdev, data, event);
+		return;
+	}
+
+	if (event != WDI_EVENT_RX_PPDU_DESC_BATCH) {
+		cfr_debug("event is %d", event);
+		return;
+	}
+
+	/* The vector is reused by DP on return, copy out the captures */
+	ppdu_vec = (struct cdp_rx_indication_ppdu_batch *)data;
+	for (i = 0; i < ppdu_vec->num_ppdu; i++) {
+		cdp_rx_ppdu = &ppdu_vec->ppdu[i];
+		if (!cdp_rx_ppdu->cfr_info.bb_captured_channel)
+			continue;
+
+		nbuf = qdf_nbuf_alloc(NULL, sizeof(*cdp_rx_ppdu), 0, 0, false);
+		if (!nbuf) {
+			cfr_err("ppdu_id 0x%04x nbuf alloc fail",
+				cdp_rx_ppdu->ppdu_id);
+			continue;
+		}
+
+		qdf_nbuf_put_tail(nbuf, sizeof(*cdp_rx_ppdu));
+		qdf_mem_copy(qdf_nbuf_data(nbuf), cdp_rx_ppdu,
+			     sizeof(*cdp_rx_ppdu));
+		wlan_cfr_rx_tlv_process(pdev, (void *)nbuf);
+	}
+}
+#else
+#define CFR_PPDU_DESC_EVENT WDI_EVENT_RX_PPDU_DESC
+
 static void target_cfr_callback(void *pdev_obj, enum WDI_EVENT event,
 				void *data, u_int16_t peer_id,
 				uint32_t status)
@@ -65,6 +114,7 @@ static void target_cfr_callback(void *pdev_obj, enum WDI_EVENT event,
 
 	qdf_nbuf_free(nbuf);
 }
+#endif
 
 QDF_STATUS
 target_if_cfr_subscribe_ppdu_desc(struct wlan_objmgr_pdev *pdev,
@@ -104,13 +154,13 @@ target_if_cfr_subscribe_ppdu_desc(struct wlan_objmgr_pdev *pdev,
 	cdp_enable_mon_reap_timer(soc, 0, is_subscribe);
 	if (is_subscribe) {
 		if (cdp_wdi_event_sub(soc, 0, &g_cfr_subscribe,
-				      WDI_EVENT_RX_PPDU_DESC)) {
+				      CFR_PPDU_DESC_EVENT)) {
 			cfr_err("wdi event sub fail");
 			return QDF_STATUS_E_FAILURE;
 		}
 	} else {
 		if (cdp_wdi_event_unsub(soc, 0, &g_cfr_subscribe,
-					WDI_EVENT_RX_PPDU_DESC)) {
+					CFR_PPDU_DESC_EVENT)) {
 			cfr_err("wdi event unsub fail");
 			return QDF_STATUS_E_FAILURE;
 		}
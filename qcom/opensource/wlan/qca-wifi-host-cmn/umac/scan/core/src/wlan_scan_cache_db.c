@@ -260,6 +260,8 @@ static QDF_STATUS scm_del_scan_node_from_db(struct scan_dbs *scan_db,
 	if (!scan_node)
 		return QDF_STATUS_E_INVAL;
 
+	qdf_list_remove_node(&scan_db->ssid_hash_tbl[scan_node->ssid_hash],
+			     &scan_node->ssid_node);
 	hash_idx = SCAN_GET_HASH(scan_node->entry->bssid.bytes);
 	scm_del_scan_node(&scan_db->scan_hash_tbl[hash_idx], scan_node);
 	scan_db->num_entries--;
@@ -353,6 +355,37 @@ static void scm_scan_entry_del(struct scan_dbs *scan_db,
 	scm_scan_entry_put_ref(scan_db, scan_node, false);
 }
 
+/**
+ * scm_get_ssid_hash() - get the ssid index bucket of an ssid
+ * @ssid: ssid
+ *
+ * Return: bucket in scan_dbs->ssid_hash_tbl
+ */
+static uint8_t scm_get_ssid_hash(struct wlan_ssid *ssid)
+{
+	uint32_t hash = 0;
+	uint8_t i;
+
+	for (i = 0; i < ssid->length; i++)
+		hash = hash * 31 + ssid->ssid[i];
+
+	return hash % SCAN_SSID_HASH_SIZE;
+}
+
+/**
+ * scm_get_entry_ssid_hash() - get the ssid index bucket of a scan entry
+ * @entry: scan entry
+ *
+ * Return: bucket in scan_dbs->ssid_hash_tbl
+ */
+static uint8_t scm_get_entry_ssid_hash(struct scan_cache_entry *entry)
+{
+	if (!entry->ssid.length || util_scan_entry_is_hidden_ap(entry))
+		return SCAN_SSID_HIDDEN_IDX;
+
+	return scm_get_ssid_hash(&entry->ssid);
+}
+
 /**
  * scm_add_scan_node() - API to add scan node
  * @scan_db: data base
@@ -373,6 +406,12 @@ static void scm_add_scan_node(struct scan_dbs *scan_db,
 	hash_idx =
 		SCAN_GET_HASH(scan_node->entry->bssid.bytes);
 
+	/* precompute the keys used by the result filters */
+	scan_node->ssid_hash = scm_get_entry_ssid_hash(scan_node->entry);
+	scan_node->band =
+		wlan_reg_freq_to_band(scan_node->entry->channel.chan_freq);
+	scan_node->db_node = NULL;
+
 	qdf_atomic_init(&scan_node->ref_cnt);
 	scan_node->cookie = SCAN_NODE_ACTIVE_COOKIE;
 	scm_scan_entry_get_ref(scan_node);
@@ -382,6 +421,8 @@ static void scm_add_scan_node(struct scan_dbs *scan_db,
 	else
 		qdf_list_insert_before(&scan_db->scan_hash_tbl[hash_idx],
 				       &scan_node->node, &dup_node->node);
+	qdf_list_insert_back(&scan_db->ssid_hash_tbl[scan_node->ssid_hash],
+			     &scan_node->ssid_node);
 
 	scan_db->num_entries++;
 }
@@ -468,6 +509,57 @@ scm_get_next_node(struct scan_dbs *scan_db,
 	return next_node;
 }
 
+/**
+ * scm_get_next_ssid_node() - API get the next scan node from an ssid
+ * index list
+ * @scan_db: scan data base
+ * @list: ssid hash list
+ * @cur_node: current node pointer
+ *
+ * Same as scm_get_next_node() but walks the ssid index, in which nodes
+ * are linked through ssid_node.
+ *
+ * Return: next scan cache node
+ */
+static struct scan_cache_node *
+scm_get_next_ssid_node(struct scan_dbs *scan_db,
+		       qdf_list_t *list, struct scan_cache_node *cur_node)
+{
+	struct scan_cache_node *next_node = NULL;
+	struct scan_cache_node *scan_node;
+	qdf_list_node_t *next_list = NULL;
+	qdf_list_node_t *temp_list = NULL;
+
+	qdf_spin_lock_bh(&scan_db->scan_db_lock);
+	if (cur_node)
+		qdf_list_peek_next(list, &cur_node->ssid_node, &next_list);
+	else
+		qdf_list_peek_front(list, &next_list);
+
+	/* skip the nodes which are logically deleted */
+	while (next_list) {
+		scan_node = qdf_container_of(next_list,
+					     struct scan_cache_node, ssid_node);
+		if (scan_node->cookie == SCAN_NODE_ACTIVE_COOKIE) {
+			next_node = scan_node;
+			break;
+		}
+		qdf_list_peek_next(list, next_list, &temp_list);
+		next_list = temp_list;
+		temp_list = NULL;
+	}
+
+	/* Decrement the ref count of the previous node */
+	if (cur_node)
+		scm_scan_entry_put_ref(scan_db, cur_node, false);
+	/* Increase the ref count of the obtained node */
+	if (next_node)
+		scm_scan_entry_get_ref(next_node);
+	qdf_spin_unlock_bh(&scan_db->scan_db_lock);
+
+	return next_node;
+}
+
 /**
  * scm_check_and_age_out() - check and age out the old entries
  * @scan_db: scan db
@@ -1244,53 +1336,155 @@ QDF_STATUS scm_handle_bcn_probe(struct scheduler_msg *msg)
 	return __scm_handle_bcn_probe(msg->bodyptr);
 }
 
+/**
+ * scm_scan_prefilter_match() - cheap reject based on the precomputed keys
+ * @db_node: scan db node
+ * @filter: filter to be applied
+ *
+ * Return: false if the entry can not match @filter
+ */
+static inline bool
+scm_scan_prefilter_match(struct scan_cache_node *db_node,
+			 struct scan_filter *filter)
+{
+	if (filter->ignore_6ghz_channel && db_node->band == REG_BAND_6G)
+		return false;
+
+	return true;
+}
+
+/**
+ * scm_scan_add_result_node() - add a db entry to a scan result list
+ * @scan_db: scan db
+ * @db_node: scan db node
+ * @security: negotiated security, copied into a copy of the entry
+ * @scan_list: scan list to which entry is added
+ * @view: add a reference to the db entry instead of a copy of it
+ *
+ * Return: QDF_STATUS
+ */
+static QDF_STATUS
+scm_scan_add_result_node(struct scan_dbs *scan_db,
+			 struct scan_cache_node *db_node,
+			 struct security_info *security,
+			 qdf_list_t *scan_list, bool view)
+{
+	struct scan_cache_node *scan_node;
+
+	scan_node = qdf_mem_malloc_atomic(sizeof(*scan_node));
+	if (!scan_node)
+		return QDF_STATUS_E_NOMEM;
+
+	if (view) {
+		/* the db node is held until the view is purged */
+		scm_scan_entry_get_ref(db_node);
+		scan_node->db_node = db_node;
+		scan_node->scan_db = scan_db;
+		scan_node->entry = db_node->entry;
+		qdf_list_insert_front(scan_list, &scan_node->node);
+
+		return QDF_STATUS_SUCCESS;
+	}
+
+	scan_node->entry =
+		util_scan_copy_cache_entry(db_node->entry);
+
+	if (!scan_node->entry) {
+		qdf_mem_free(scan_node);
+		return QDF_STATUS_E_NOMEM;
+	}
+
+	qdf_mem_copy(&scan_node->entry->neg_sec_info,
+		security, sizeof(scan_node->entry->neg_sec_info));
+
+	qdf_list_insert_front(scan_list, &scan_node->node);
+
+	return QDF_STATUS_SUCCESS;
+}
+
 /**
  * scm_scan_apply_filter_get_entry() - apply filter and get the
  * scan entry
  * @psoc: psoc pointer
- * @db_entry: scan entry
+ * @scan_db: scan db
+ * @db_node: scan db node
  * @filter: filter to be applied
  * @scan_list: scan list to which entry is added
+ * @view: add a reference to the db entry instead of a copy of it
  *
  * Return: QDF_STATUS
  */
 static QDF_STATUS
 scm_scan_apply_filter_get_entry(struct wlan_objmgr_psoc *psoc,
-	struct scan_cache_entry *db_entry,
+	struct scan_dbs *scan_db,
+	struct scan_cache_node *db_node,
 	struct scan_filter *filter,
-	qdf_list_t *scan_list)
+	qdf_list_t *scan_list, bool view)
 {
-	struct scan_cache_node *scan_node = NULL;
 	struct security_info security = {0};
 	bool match;
 
 	if (!filter)
 		match = true;
 	else
-		match = scm_filter_match(psoc, db_entry,
-					filter, &security);
+		match = scm_scan_prefilter_match(db_node, filter) &&
+			scm_filter_match(psoc, db_node->entry,
+					 filter, &security);
 
 	if (!match)
 		return QDF_STATUS_SUCCESS;
 
-	scan_node = qdf_mem_malloc_atomic(sizeof(*scan_node));
-	if (!scan_node)
-		return QDF_STATUS_E_NOMEM;
+	return scm_scan_add_result_node(scan_db, db_node, &security,
+					scan_list, view);
+}
 
-	scan_node->entry =
-		util_scan_copy_cache_entry(db_entry);
+/**
+ * scm_get_ssid_results() - get scan results through the ssid index
+ * @psoc: psoc ptr
+ * @scan_db: scan db
+ * @filter: filter to be applied, with at least one ssid
+ * @scan_list: scan list to which entry is added
+ * @view: add references to the db entries instead of copies
+ *
+ * Only the buckets of the filter ssids and the hidden bucket are walked,
+ * each bucket at most once.
+ *
+ * Return: void
+ */
+static void scm_get_ssid_results(struct wlan_objmgr_psoc *psoc,
+				 struct scan_dbs *scan_db,
+				 struct scan_filter *filter,
+				 qdf_list_t *scan_list, bool view)
+{
+	uint8_t buckets[WLAN_SCAN_FILTER_NUM_SSID + 1];
+	uint8_t num_buckets = 0;
+	uint8_t i, j, idx;
+	struct scan_cache_node *cur_node;
+	qdf_list_t *list;
 
-	if (!scan_node->entry) {
-		qdf_mem_free(scan_node);
-		return QDF_STATUS_E_NOMEM;
+	for (i = 0; i < filter->num_of_ssid; i++) {
+		idx = scm_get_ssid_hash(&filter->ssid_list[i]);
+		for (j = 0; j < num_buckets; j++)
+			if (buckets[j] == idx)
+				break;
+		if (j == num_buckets)
+			buckets[num_buckets++] = idx;
 	}
+	buckets[num_buckets++] = SCAN_SSID_HIDDEN_IDX;
 
-	qdf_mem_copy(&scan_node->entry->neg_sec_info,
-		&security, sizeof(scan_node->entry->neg_sec_info));
-
-	qdf_list_insert_front(scan_list, &scan_node->node);
-
-	return QDF_STATUS_SUCCESS;
+	for (i = 0; i < num_buckets; i++) {
+		list = &scan_db->ssid_hash_tbl[buckets[i]];
+		if (!qdf_list_size(list))
+			continue;
+		cur_node = scm_get_next_ssid_node(scan_db, list, NULL);
+		while (cur_node) {
+			scm_scan_apply_filter_get_entry(psoc, scan_db,
+							cur_node, filter,
+							scan_list, view);
+			cur_node = scm_get_next_ssid_node(scan_db, list,
+							  cur_node);
+		}
+	}
 }
 
 /**
@@ -1299,17 +1493,24 @@ scm_scan_apply_filter_get_entry(struct wlan_objmgr_psoc *psoc,
  * @scan_db: scan db
  * @filter: filter to be applied
  * @scan_list: scan list to which entry is added
+ * @view: add references to the db entries instead of copies
  *
  * Return: void
  */
 static void scm_get_results(struct wlan_objmgr_psoc *psoc,
 	struct scan_dbs *scan_db, struct scan_filter *filter,
-	qdf_list_t *scan_list)
+	qdf_list_t *scan_list, bool view)
 {
 	int i, count;
 	struct scan_cache_node *cur_node;
 	struct scan_cache_node *next_node = NULL;
 
+	if (filter && filter->num_of_ssid &&
+	    filter->num_of_ssid <= WLAN_SCAN_FILTER_NUM_SSID) {
+		scm_get_ssid_results(psoc, scan_db, filter, scan_list, view);
+		return;
+	}
+
 	for (i = 0 ; i < SCAN_HASH_SIZE; i++) {
 		cur_node = scm_get_next_node(scan_db,
 			   &scan_db->scan_hash_tbl[i], NULL);
@@ -1317,8 +1518,8 @@ static void scm_get_results(struct wlan_objmgr_psoc *psoc,
 		if (!count)
 			continue;
 		while (cur_node) {
-			scm_scan_apply_filter_get_entry(psoc,
-				cur_node->entry, filter, scan_list);
+			scm_scan_apply_filter_get_entry(psoc, scan_db,
+				cur_node, filter, scan_list, view);
 			next_node = scm_get_next_node(scan_db,
 				&scan_db->scan_hash_tbl[i], cur_node);
 			cur_node = next_node;
@@ -1347,7 +1548,13 @@ QDF_STATUS scm_purge_scan_results(qdf_list_t *scan_list)
 		status = qdf_list_remove_node(scan_list,
 					cur_lst);
 		if (QDF_IS_STATUS_SUCCESS(status)) {
-			util_scan_free_cache_entry(cur_node->entry);
+			/* view nodes hold the db node instead of a copy */
+			if (cur_node->db_node)
+				scm_scan_entry_put_ref(cur_node->scan_db,
+						       cur_node->db_node,
+						       true);
+			else
+				util_scan_free_cache_entry(cur_node->entry);
 			qdf_mem_free(cur_node);
 		}
 		cur_lst = next_lst;
@@ -1360,8 +1567,17 @@ QDF_STATUS scm_purge_scan_results(qdf_list_t *scan_list)
 	return status;
 }
 
-qdf_list_t *scm_get_scan_result(struct wlan_objmgr_pdev *pdev,
-	struct scan_filter *filter)
+/**
+ * scm_get_scan_result_list() - fetches scan result as copies or as a view
+ * @pdev: pdev info
+ * @filter: Filters
+ * @view: reference the db entries instead of copying them
+ *
+ * Return: scan list
+ */
+static qdf_list_t *scm_get_scan_result_list(struct wlan_objmgr_pdev *pdev,
+					    struct scan_filter *filter,
+					    bool view)
 {
 	struct wlan_objmgr_psoc *psoc;
 	struct scan_dbs *scan_db;
@@ -1392,11 +1608,23 @@ qdf_list_t *scm_get_scan_result(struct wlan_objmgr_pdev *pdev,
 	qdf_list_create(tmp_list,
 			MAX_SCAN_CACHE_SIZE);
 	scm_age_out_entries(psoc, scan_db);
-	scm_get_results(psoc, scan_db, filter, tmp_list);
+	scm_get_results(psoc, scan_db, filter, tmp_list, view);
 
 	return tmp_list;
 }
 
+qdf_list_t *scm_get_scan_result(struct wlan_objmgr_pdev *pdev,
+	struct scan_filter *filter)
+{
+	return scm_get_scan_result_list(pdev, filter, false);
+}
+
+qdf_list_t *scm_get_scan_result_view(struct wlan_objmgr_pdev *pdev,
+				     struct scan_filter *filter)
+{
+	return scm_get_scan_result_list(pdev, filter, true);
+}
+
 /**
  * scm_iterate_db_and_call_func() - iterate and call the func
  * @scan_db: scan db
@@ -1664,9 +1892,49 @@ QDF_STATUS scm_scan_register_bcn_cb(struct wlan_objmgr_psoc *psoc,
 	return QDF_STATUS_SUCCESS;
 }
 
+/**
+ * scm_db_init_tbls() - init the lock and the hash tables of a scan db
+ * @scan_db: scan db
+ *
+ * Return: void
+ */
+static void scm_db_init_tbls(struct scan_dbs *scan_db)
+{
+	int j;
+
+	scan_db->num_entries = 0;
+	qdf_spinlock_create(&scan_db->scan_db_lock);
+	for (j = 0; j < SCAN_HASH_SIZE; j++)
+		qdf_list_create(&scan_db->scan_hash_tbl[j],
+			MAX_SCAN_CACHE_SIZE);
+	for (j = 0; j < SCAN_SSID_TBL_SIZE; j++)
+		qdf_list_create(&scan_db->ssid_hash_tbl[j],
+				MAX_SCAN_CACHE_SIZE);
+}
+
+/**
+ * scm_db_deinit_tbls() - flush a scan db and destroy its lock and tables
+ * @psoc: psoc, only used to match filters, may be NULL
+ * @scan_db: scan db
+ *
+ * Return: void
+ */
+static void scm_db_deinit_tbls(struct wlan_objmgr_psoc *psoc,
+			       struct scan_dbs *scan_db)
+{
+	int j;
+
+	scm_flush_scan_entries(psoc, scan_db, NULL);
+	for (j = 0; j < SCAN_HASH_SIZE; j++)
+		qdf_list_destroy(&scan_db->scan_hash_tbl[j]);
+	for (j = 0; j < SCAN_SSID_TBL_SIZE; j++)
+		qdf_list_destroy(&scan_db->ssid_hash_tbl[j]);
+	qdf_spinlock_destroy(&scan_db->scan_db_lock);
+}
+
 QDF_STATUS scm_db_init(struct wlan_objmgr_psoc *psoc)
 {
-	int i, j;
+	int i;
 	struct scan_dbs *scan_db;
 
 	if (!psoc) {
@@ -1681,18 +1949,14 @@ QDF_STATUS scm_db_init(struct wlan_objmgr_psoc *psoc)
 			scm_err("scan_db is NULL %d", i);
 			continue;
 		}
-		scan_db->num_entries = 0;
-		qdf_spinlock_create(&scan_db->scan_db_lock);
-		for (j = 0; j < SCAN_HASH_SIZE; j++)
-			qdf_list_create(&scan_db->scan_hash_tbl[j],
-				MAX_SCAN_CACHE_SIZE);
+		scm_db_init_tbls(scan_db);
 	}
 	return QDF_STATUS_SUCCESS;
 }
 
 QDF_STATUS scm_db_deinit(struct wlan_objmgr_psoc *psoc)
 {
-	int i, j;
+	int i;
 	struct scan_dbs *scan_db;
 
 	if (!psoc) {
@@ -1708,15 +1972,75 @@ QDF_STATUS scm_db_deinit(struct wlan_objmgr_psoc *psoc)
 			continue;
 		}
 
-		scm_flush_scan_entries(psoc, scan_db, NULL);
-		for (j = 0; j < SCAN_HASH_SIZE; j++)
-			qdf_list_destroy(&scan_db->scan_hash_tbl[j]);
-		qdf_spinlock_destroy(&scan_db->scan_db_lock);
+		scm_db_deinit_tbls(psoc, scan_db);
 	}
 
 	return QDF_STATUS_SUCCESS;
 }
 
+#ifdef WLAN_SCAN_DB_TEST
+QDF_STATUS scm_private_db_init(struct scan_dbs *scan_db)
+{
+	if (!scan_db)
+		return QDF_STATUS_E_INVAL;
+
+	scm_db_init_tbls(scan_db);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+void scm_private_db_deinit(struct scan_dbs *scan_db)
+{
+	if (scan_db)
+		scm_db_deinit_tbls(NULL, scan_db);
+}
+
+QDF_STATUS scm_private_db_add_entry(struct scan_dbs *scan_db,
+				    struct scan_cache_entry *entry)
+{
+	struct scan_cache_node *scan_node;
+
+	if (scan_db->num_entries >= MAX_SCAN_CACHE_SIZE)
+		return QDF_STATUS_E_RESOURCES;
+
+	scan_node = qdf_mem_malloc(sizeof(*scan_node));
+	if (!scan_node)
+		return QDF_STATUS_E_NOMEM;
+
+	scan_node->entry = entry;
+	qdf_spin_lock_bh(&scan_db->scan_db_lock);
+	scm_add_scan_node(scan_db, scan_node, NULL);
+	qdf_spin_unlock_bh(&scan_db->scan_db_lock);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+qdf_list_t *scm_private_db_get_ssid_result(struct scan_dbs *scan_db,
+					   struct wlan_ssid *ssid, bool view)
+{
+	struct security_info security = {0};
+	struct scan_cache_node *cur_node;
+	qdf_list_t *scan_list;
+	qdf_list_t *list;
+
+	scan_list = qdf_mem_malloc_atomic(sizeof(*scan_list));
+	if (!scan_list)
+		return NULL;
+	qdf_list_create(scan_list, MAX_SCAN_CACHE_SIZE);
+
+	list = &scan_db->ssid_hash_tbl[scm_get_ssid_hash(ssid)];
+	cur_node = scm_get_next_ssid_node(scan_db, list, NULL);
+	while (cur_node) {
+		if (util_is_ssid_match(ssid, &cur_node->entry->ssid))
+			scm_scan_add_result_node(scan_db, cur_node, &security,
+						 scan_list, view);
+		cur_node = scm_get_next_ssid_node(scan_db, list, cur_node);
+	}
+
+	return scan_list;
+}
+#endif
+
 #ifdef FEATURE_6G_SCAN_CHAN_SORT_ALGO
 QDF_STATUS scm_channel_list_db_init(struct wlan_objmgr_psoc *psoc)
 {
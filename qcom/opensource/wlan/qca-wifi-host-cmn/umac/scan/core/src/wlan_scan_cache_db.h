@@ -34,17 +34,29 @@
 #define SCAN_GET_HASH(addr) \
 	(((const uint8_t *)(addr))[QDF_MAC_ADDR_SIZE - 1] % SCAN_HASH_SIZE)
 
+/*
+ * Secondary ssid index. Hidden entries, and entries without an ssid, are
+ * kept in a dedicated bucket which is walked for every ssid lookup as
+ * they can still match a filter (e.g. OWE transition mode).
+ */
+#define SCAN_SSID_HASH_SIZE 64
+#define SCAN_SSID_HIDDEN_IDX SCAN_SSID_HASH_SIZE
+#define SCAN_SSID_TBL_SIZE (SCAN_SSID_HASH_SIZE + 1)
+
 #define ADJACENT_CHANNEL_RSSI_THRESHOLD -80
 
 /**
  * struct scan_dbs - scan cache data base definition
  * @num_entries: number of scan entries
  * @scan_hash_tbl: link list of bssid hashed scan cache entries for a pdev
+ * @ssid_hash_tbl: link list of ssid hashed scan cache entries for a pdev,
+ *                 entries are linked through scan_cache_node->ssid_node
  */
 struct scan_dbs {
 	uint32_t num_entries;
 	qdf_spinlock_t scan_db_lock;
 	qdf_list_t scan_hash_tbl[SCAN_HASH_SIZE];
+	qdf_list_t ssid_hash_tbl[SCAN_SSID_TBL_SIZE];
 };
 
 /**
@@ -115,6 +127,22 @@ qdf_list_t *scm_get_scan_result(struct wlan_objmgr_pdev *pdev,
  */
 QDF_STATUS scm_purge_scan_results(qdf_list_t *scan_result);
 
+/**
+ * scm_get_scan_result_view() - fetches a zero copy view of the scan result
+ * @pdev: pdev info
+ * @filter: Filters
+ *
+ * Same as scm_get_scan_result() but the result nodes reference the scan
+ * db entries instead of copies of them. Each referenced db entry is held
+ * until the view is released with scm_purge_scan_results(). The
+ * entries are shared with the scan db and must be treated as read only,
+ * and neg_sec_info is not populated for them.
+ *
+ * Return: scan list
+ */
+qdf_list_t *scm_get_scan_result_view(struct wlan_objmgr_pdev *pdev,
+				     struct scan_filter *filter);
+
 /**
  * scm_update_scan_mlme_info() - updates scan entry with mlme data
  * @pdev: pdev object
@@ -197,6 +225,53 @@ QDF_STATUS scm_db_init(struct wlan_objmgr_psoc *psoc);
  */
 QDF_STATUS scm_db_deinit(struct wlan_objmgr_psoc *psoc);
 
+#ifdef WLAN_SCAN_DB_TEST
+/**
+ * scm_private_db_init() - init a scan db not attached to any pdev
+ * @scan_db: scan db
+ *
+ * Used by the scan db benchmark. Entries of a private db are never
+ * reported to the OS and never aged out.
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS scm_private_db_init(struct scan_dbs *scan_db);
+
+/**
+ * scm_private_db_deinit() - flush and deinit a private scan db
+ * @scan_db: scan db
+ *
+ * Return: void
+ */
+void scm_private_db_deinit(struct scan_dbs *scan_db);
+
+/**
+ * scm_private_db_add_entry() - add an entry to a private scan db
+ * @scan_db: scan db
+ * @entry: entry, owned by the db on success
+ *
+ * No duplicate lookup is done and a full db is not flushed.
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS scm_private_db_add_entry(struct scan_dbs *scan_db,
+				    struct scan_cache_entry *entry);
+
+/**
+ * scm_private_db_get_ssid_result() - get the entries of an ssid
+ * @scan_db: scan db
+ * @ssid: ssid
+ * @view: reference the db entries instead of copying them
+ *
+ * Walks the ssid index like scm_get_scan_result() does for an ssid
+ * filter, matching the ssid only. Release with scm_purge_scan_results().
+ *
+ * Return: scan list
+ */
+qdf_list_t *scm_private_db_get_ssid_result(struct scan_dbs *scan_db,
+					   struct wlan_ssid *ssid, bool view);
+#endif
+
 #ifdef FEATURE_6G_SCAN_CHAN_SORT_ALGO
 
 /**
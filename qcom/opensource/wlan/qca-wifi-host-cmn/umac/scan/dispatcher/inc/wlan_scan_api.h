@@ -322,6 +322,24 @@ static inline qdf_list_t *wlan_scan_get_result(struct wlan_objmgr_pdev *pdev,
 	return scm_get_scan_result(pdev, filter);
 }
 
+/**
+ * wlan_scan_get_result_view() - The Public API to get a zero copy view of
+ * the scan results
+ * @pdev: pdev info
+ * @filter: Filters
+ *
+ * The returned entries are shared with the scan db and are read only.
+ * Release the list with wlan_scan_purge_results().
+ *
+ * Return: scan list pointer
+ */
+static inline qdf_list_t *
+wlan_scan_get_result_view(struct wlan_objmgr_pdev *pdev,
+			  struct scan_filter *filter)
+{
+	return scm_get_scan_result_view(pdev, filter);
+}
+
 /**
  * wlan_scan_update_mlme_by_bssinfo() - The Public API to update mlme
  * info in the scan entry
@@ -129,6 +129,7 @@ typedef uint32_t wlan_scan_id;
 struct wlan_objmgr_vdev;
 struct wlan_objmgr_pdev;
 struct wlan_objmgr_psoc;
+struct scan_dbs;
 
 /**
  * struct channel_info - BSS channel information
@@ -312,12 +313,23 @@ struct bss_info {
  * @ref_cnt: ref count if in use
  * @cookie: cookie to check if entry is logically active
  * @entry: scan entry pointer
+ * @ssid_node: node pointers in the ssid index of the scan db
+ * @ssid_hash: ssid index bucket of the entry, computed on insertion
+ * @band: band of the entry, computed on insertion
+ * @db_node: scan db node referenced by a result view node, NULL when
+ *           @entry is a private copy owned by this node
+ * @scan_db: scan db holding @db_node, used to drop the reference
  */
 struct scan_cache_node {
 	qdf_list_node_t node;
 	qdf_atomic_t ref_cnt;
 	uint32_t cookie;
 	struct scan_cache_entry *entry;
+	qdf_list_node_t ssid_node;
+	uint8_t ssid_hash;
+	uint8_t band;
+	struct scan_cache_node *db_node;
+	struct scan_dbs *scan_db;
 };
 
 /**
@@ -932,178 +932,425 @@ static void util_scan_parse_eht_ie(struct scan_cache_entry *scan_params,
 }
 #endif
 
+/*
+ * Element dispatch tables. IEs which only need a length check before
+ * their location is recorded in struct ie_list are described here and
+ * handled without per IE code; decoding of the IE body is left to the
+ * consumers of ie_list. IEs needing more work keep their own handlers.
+ */
+#define UTIL_SCAN_IE_VALID		BIT(0)
+/* keep the frame, just don't record an IE of invalid length */
+#define UTIL_SCAN_IE_IGNORE_INVALID	BIT(1)
+
+#define UTIL_SCAN_IE_ANY_LEN		0xff
+#define UTIL_SCAN_IE_ANY_SUBTYPE	0xff
+/* element IDs and extension element IDs are both 8 bit */
+#define UTIL_SCAN_IE_TBL_SIZE		256
+
+/**
+ * struct util_scan_ie_desc - length rules and location of a recorded IE
+ * @min_len: minimum IE length
+ * @max_len: maximum IE length
+ * @flags: UTIL_SCAN_IE_* flags
+ * @offset: offset of the IE pointer in struct ie_list
+ */
+struct util_scan_ie_desc {
+	uint8_t min_len;
+	uint8_t max_len;
+	uint8_t flags;
+	uint16_t offset;
+};
+
+#define UTIL_SCAN_IE(_field, _min, _max, _flags) { \
+	.min_len = (_min), \
+	.max_len = (_max), \
+	.flags = UTIL_SCAN_IE_VALID | (_flags), \
+	.offset = offsetof(struct ie_list, _field), \
+}
+
+#define UTIL_SCAN_IE_FIXED(_field, _len, _flags) \
+	UTIL_SCAN_IE(_field, _len, _len, _flags)
+
+static const struct util_scan_ie_desc util_scan_ie_tbl[UTIL_SCAN_IE_TBL_SIZE] = {
+	[WLAN_ELEMID_SSID] =
+		UTIL_SCAN_IE(ssid, 0, sizeof(struct ie_ssid) -
+			     sizeof(struct ie_header), 0),
+	[WLAN_ELEMID_RATES] =
+		UTIL_SCAN_IE(rates, 0, WLAN_SUPPORTED_RATES_IE_MAX_LEN, 0),
+	[WLAN_ELEMID_COUNTRY] =
+		UTIL_SCAN_IE(country, WLAN_COUNTRY_IE_MIN_LEN,
+			     UTIL_SCAN_IE_ANY_LEN, 0),
+	/*
+	 * Expected QBSS IE length is 5Bytes; For some old cisco AP, QBSS IE
+	 * length is 4Bytes, which doesn't match with latest spec, So ignore
+	 * QBSS IE in such case.
+	 */
+	[WLAN_ELEMID_QBSS_LOAD] =
+		UTIL_SCAN_IE_FIXED(qbssload, sizeof(struct qbss_load_ie) -
+				   sizeof(struct ie_header),
+				   UTIL_SCAN_IE_IGNORE_INVALID),
+	[WLAN_ELEMID_CHANSWITCHANN] =
+		UTIL_SCAN_IE_FIXED(csa, WLAN_CSA_IE_MAX_LEN, 0),
+	[WLAN_ELEMID_IBSSDFS] =
+		UTIL_SCAN_IE(ibssdfs, WLAN_IBSSDFS_IE_MIN_LEN,
+			     UTIL_SCAN_IE_ANY_LEN, 0),
+	[WLAN_ELEMID_QUIET] =
+		UTIL_SCAN_IE_FIXED(quiet, WLAN_QUIET_IE_MAX_LEN, 0),
+	/*
+	 * For security cert TC, RSNIE length can be 1 but if beacon is
+	 * dropped, old entry will remain in scan cache and cause cert TC
+	 * failure as connection with old entry with valid RSN IE will pass.
+	 * So instead of dropping the frame, do not store the RSN pointer so
+	 * that old entry is overwritten.
+	 */
+	[WLAN_ELEMID_RSN] =
+		UTIL_SCAN_IE(rsn, WLAN_RSN_IE_MIN_LEN, UTIL_SCAN_IE_ANY_LEN,
+			     UTIL_SCAN_IE_IGNORE_INVALID),
+	[WLAN_ELEMID_XRATES] =
+		UTIL_SCAN_IE(xrates, 0, WLAN_EXT_SUPPORTED_RATES_IE_MAX_LEN, 0),
+	[WLAN_ELEMID_EXTCHANSWITCHANN] =
+		UTIL_SCAN_IE_FIXED(xcsa, WLAN_XCSA_IE_MAX_LEN, 0),
+	[WLAN_ELEMID_SECCHANOFFSET] =
+		UTIL_SCAN_IE_FIXED(secchanoff, WLAN_SECCHANOFF_IE_MAX_LEN, 0),
+	[WLAN_ELEMID_WAPI] =
+		UTIL_SCAN_IE(wapi, WLAN_WAPI_IE_MIN_LEN,
+			     UTIL_SCAN_IE_ANY_LEN, 0),
+	[WLAN_ELEMID_XCAPS] =
+		UTIL_SCAN_IE(extcaps, 0, WLAN_EXTCAP_IE_MAX_LEN, 0),
+	[WLAN_ELEMID_VHTCAP] =
+		UTIL_SCAN_IE_FIXED(vhtcap, sizeof(struct wlan_ie_vhtcaps) -
+				   sizeof(struct ie_header), 0),
+	[WLAN_ELEMID_VHTOP] =
+		UTIL_SCAN_IE_FIXED(vhtop, sizeof(struct wlan_ie_vhtop) -
+				   sizeof(struct ie_header), 0),
+	[WLAN_ELEMID_OP_MODE_NOTIFY] =
+		UTIL_SCAN_IE_FIXED(opmode, WLAN_OPMODE_IE_MAX_LEN, 0),
+	[WLAN_ELEMID_MOBILITY_DOMAIN] =
+		UTIL_SCAN_IE_FIXED(mdie, WLAN_MOBILITY_DOMAIN_IE_MAX_LEN, 0),
+	[WLAN_ELEMID_FILS_INDICATION] =
+		UTIL_SCAN_IE(fils_indication, WLAN_FILS_INDICATION_IE_MIN_LEN,
+			     UTIL_SCAN_IE_ANY_LEN, 0),
+	[WLAN_ELEMID_RSNXE] =
+		UTIL_SCAN_IE(rsnxe, 1, UTIL_SCAN_IE_ANY_LEN, 0),
+};
+
+static const struct util_scan_ie_desc util_scan_extn_ie_tbl[UTIL_SCAN_IE_TBL_SIZE] = {
+	[WLAN_EXTN_ELEMID_MAX_CHAN_SWITCH_TIME] =
+		UTIL_SCAN_IE_FIXED(mcst, WLAN_MAX_CHAN_SWITCH_TIME_IE_LEN, 0),
+	[WLAN_EXTN_ELEMID_SRP] =
+		UTIL_SCAN_IE(srp, 0, WLAN_MAX_SRP_IE_LEN, 0),
+	[WLAN_EXTN_ELEMID_HECAP] =
+		UTIL_SCAN_IE(hecap, 0, UTIL_SCAN_IE_ANY_LEN, 0),
+	[WLAN_EXTN_ELEMID_HEOP] =
+		UTIL_SCAN_IE(heop, 0, WLAN_MAX_HEOP_IE_LEN, 0),
+	[WLAN_EXTN_ELEMID_ESP] =
+		UTIL_SCAN_IE(esp, 0, UTIL_SCAN_IE_ANY_LEN, 0),
+	[WLAN_EXTN_ELEMID_MUEDCA] =
+		UTIL_SCAN_IE(muedca, 0, WLAN_MAX_MUEDCA_IE_LEN, 0),
+	[WLAN_EXTN_ELEMID_HE_6G_CAP] =
+		UTIL_SCAN_IE(hecap_6g, 0, WLAN_MAX_HE_6G_CAP_IE_LEN, 0),
+#ifdef WLAN_FEATURE_11BE
+	[WLAN_EXTN_ELEMID_EHTCAP] =
+		UTIL_SCAN_IE(ehtcap, 0, UTIL_SCAN_IE_ANY_LEN, 0),
+	[WLAN_EXTN_ELEMID_EHTOP] =
+		UTIL_SCAN_IE(ehtop, 0, UTIL_SCAN_IE_ANY_LEN, 0),
+#endif
+};
+
+/**
+ * util_scan_record_ie() - check the IE length and record its location
+ * @scan_params: scan entry
+ * @desc: IE descriptor
+ * @ie: IE to record
+ *
+ * Return: QDF_STATUS_E_INVAL if the IE length is invalid and the frame
+ * must be dropped, QDF_STATUS_SUCCESS otherwise
+ */
+static inline QDF_STATUS
+util_scan_record_ie(struct scan_cache_entry *scan_params,
+		    const struct util_scan_ie_desc *desc,
+		    struct ie_header *ie)
+{
+	if (ie->ie_len < desc->min_len || ie->ie_len > desc->max_len) {
+		if (desc->flags & UTIL_SCAN_IE_IGNORE_INVALID)
+			return QDF_STATUS_SUCCESS;
+		return QDF_STATUS_E_INVAL;
+	}
+
+	*(uint8_t **)((uint8_t *)&scan_params->ie_list + desc->offset) =
+		(uint8_t *)ie;
+
+	return QDF_STATUS_SUCCESS;
+}
+
 static QDF_STATUS
 util_scan_parse_extn_ie(struct scan_cache_entry *scan_params,
 	struct ie_header *ie)
 {
 	struct extn_ie_header *extn_ie = (struct extn_ie_header *) ie;
+	const struct util_scan_ie_desc *desc;
+	QDF_STATUS status;
 
-	switch (extn_ie->ie_extn_id) {
-	case WLAN_EXTN_ELEMID_MAX_CHAN_SWITCH_TIME:
-		if (extn_ie->ie_len != WLAN_MAX_CHAN_SWITCH_TIME_IE_LEN)
-			return QDF_STATUS_E_INVAL;
-		scan_params->ie_list.mcst  = (uint8_t *)ie;
-		break;
-	case WLAN_EXTN_ELEMID_SRP:
-		if (extn_ie->ie_len > WLAN_MAX_SRP_IE_LEN)
-			return QDF_STATUS_E_INVAL;
-		scan_params->ie_list.srp   = (uint8_t *)ie;
-		break;
-	case WLAN_EXTN_ELEMID_HECAP:
-		scan_params->ie_list.hecap = (uint8_t *)ie;
-		break;
-	case WLAN_EXTN_ELEMID_HEOP:
-		if (extn_ie->ie_len > WLAN_MAX_HEOP_IE_LEN)
-			return QDF_STATUS_E_INVAL;
-		scan_params->ie_list.heop  = (uint8_t *)ie;
-		break;
-	case WLAN_EXTN_ELEMID_ESP:
-		scan_params->ie_list.esp = (uint8_t *)ie;
-		break;
-	case WLAN_EXTN_ELEMID_MUEDCA:
-		if (extn_ie->ie_len > WLAN_MAX_MUEDCA_IE_LEN)
+	desc = &util_scan_extn_ie_tbl[extn_ie->ie_extn_id];
+	if (desc->flags & UTIL_SCAN_IE_VALID) {
+		status = util_scan_record_ie(scan_params, desc, ie);
+		if (QDF_IS_STATUS_ERROR(status))
+			return status;
+	}
+	util_scan_parse_eht_ie(scan_params, extn_ie);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static QDF_STATUS
+util_scan_parse_wps_ie(struct scan_cache_entry *scan_params,
+		       struct ie_header *ie)
+{
+	scan_params->ie_list.wps = (uint8_t *)ie;
+	/* WCN IE should be a subset of WPS IE */
+	if (is_wcn_oui((uint8_t *)ie))
+		scan_params->ie_list.wcn = (uint8_t *)ie;
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static QDF_STATUS
+util_scan_parse_vendor_htcap_ie(struct scan_cache_entry *scan_params,
+				struct ie_header *ie)
+{
+	/* we only care if there isn't already an HT IE (ANA) */
+	if (scan_params->ie_list.htcap)
+		return QDF_STATUS_SUCCESS;
+
+	if (ie->ie_len != (WLAN_VENDOR_HT_IE_OFFSET_LEN +
+			   sizeof(struct htcap_cmn_ie)))
+		return QDF_STATUS_E_INVAL;
+	scan_params->ie_list.htcap =
+		(uint8_t *)&(((struct wlan_vendor_ie_htcap *)ie)->ie);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static QDF_STATUS
+util_scan_parse_vendor_htinfo_ie(struct scan_cache_entry *scan_params,
+				 struct ie_header *ie)
+{
+	/* we only care if there isn't already an HT IE (ANA) */
+	if (scan_params->ie_list.htinfo)
+		return QDF_STATUS_SUCCESS;
+
+	if (ie->ie_len != WLAN_VENDOR_HT_IE_OFFSET_LEN +
+			  sizeof(struct wlan_ie_htinfo_cmn))
+		return QDF_STATUS_E_INVAL;
+	scan_params->ie_list.htinfo =
+		(uint8_t *)&(((struct wlan_vendor_ie_htinfo *)ie)->hi_ie);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static QDF_STATUS
+util_scan_parse_interop_vht_ie(struct scan_cache_entry *scan_params,
+			       struct ie_header *ie)
+{
+	uint8_t *vendor_ie = (uint8_t *)(ie);
+
+	if (!is_interop_vht(vendor_ie) || scan_params->ie_list.vhtcap)
+		return QDF_STATUS_SUCCESS;
+
+	if (ie->ie_len < ((WLAN_VENDOR_VHTCAP_IE_OFFSET +
+			 sizeof(struct wlan_ie_vhtcaps)) -
+			 sizeof(struct ie_header)))
+		return QDF_STATUS_E_INVAL;
+	vendor_ie = ((uint8_t *)(ie)) + WLAN_VENDOR_VHTCAP_IE_OFFSET;
+	if (vendor_ie[1] != (sizeof(struct wlan_ie_vhtcaps)) -
+			      sizeof(struct ie_header))
+		return QDF_STATUS_E_INVAL;
+	/* location where Interop Vht Cap IE and VHT OP IE Present */
+	scan_params->ie_list.vhtcap = (((uint8_t *)(ie)) +
+					WLAN_VENDOR_VHTCAP_IE_OFFSET);
+	if (ie->ie_len > ((WLAN_VENDOR_VHTCAP_IE_OFFSET +
+			 sizeof(struct wlan_ie_vhtcaps)) -
+			 sizeof(struct ie_header))) {
+		if (ie->ie_len < ((WLAN_VENDOR_VHTOP_IE_OFFSET +
+				  sizeof(struct wlan_ie_vhtop)) -
+				  sizeof(struct ie_header)))
 			return QDF_STATUS_E_INVAL;
-		scan_params->ie_list.muedca = (uint8_t *)ie;
-		break;
-	case WLAN_EXTN_ELEMID_HE_6G_CAP:
-		if (extn_ie->ie_len > WLAN_MAX_HE_6G_CAP_IE_LEN)
+		vendor_ie = ((uint8_t *)(ie)) +
+			    WLAN_VENDOR_VHTOP_IE_OFFSET;
+		if (vendor_ie[1] != (sizeof(struct wlan_ie_vhtop) -
+				     sizeof(struct ie_header)))
 			return QDF_STATUS_E_INVAL;
-		scan_params->ie_list.hecap_6g = (uint8_t *)ie;
-		break;
-#ifdef WLAN_FEATURE_11BE
-	case WLAN_EXTN_ELEMID_EHTCAP:
-		scan_params->ie_list.ehtcap = (uint8_t *)ie;
-		break;
-	case WLAN_EXTN_ELEMID_EHTOP:
-		scan_params->ie_list.ehtop  = (uint8_t *)ie;
-		break;
-#endif
-	default:
-		break;
+		scan_params->ie_list.vhtop = (((uint8_t *)(ie)) +
+					   WLAN_VENDOR_VHTOP_IE_OFFSET);
 	}
-	util_scan_parse_eht_ie(scan_params, extn_ie);
 
 	return QDF_STATUS_SUCCESS;
 }
 
+/* OUI and type, as read little endian from the vendor IE body */
+#define UTIL_SCAN_VENDOR_KEY(_oui, _type) \
+	((uint32_t)(_oui) | ((uint32_t)(_type) << OUI_TYPE_BITS))
+/* same, for OUI and type given as one big endian value */
+#define UTIL_SCAN_VENDOR_KEY_BE(_val) \
+	((((uint32_t)(_val) >> 24) & 0xff) | \
+	 (((uint32_t)(_val) >> 8) & 0xff00) | \
+	 (((uint32_t)(_val) << 8) & 0xff0000) | \
+	 (((uint32_t)(_val) & 0xff) << 24))
+/* P2P_WFA_OUI in little endian */
+#define UTIL_SCAN_WFA_OUI 0x9a6f50
+
+/**
+ * struct util_scan_vendor_ie_desc - dispatch entry for a vendor IE
+ * @key: OUI and type, see UTIL_SCAN_VENDOR_KEY()
+ * @min_len: minimum IE length for the entry to match
+ * @subtype: OUI subtype to match, UTIL_SCAN_IE_ANY_SUBTYPE for any
+ * @max_len: maximum IE length, longer IEs fail the frame
+ * @ie_off: offset in the IE of the location recorded in ie_list
+ * @offset: offset of the IE pointer in struct ie_list
+ * @parse: handler for IEs which need more than the length check
+ */
+struct util_scan_vendor_ie_desc {
+	uint32_t key;
+	uint8_t min_len;
+	uint8_t subtype;
+	uint8_t max_len;
+	uint8_t ie_off;
+	uint16_t offset;
+	QDF_STATUS (*parse)(struct scan_cache_entry *scan_params,
+			    struct ie_header *ie);
+};
+
+#define UTIL_SCAN_VENDOR_IE(_key, _min, _subtype, _max, _field) { \
+	.key = (_key), \
+	.min_len = (_min), \
+	.subtype = (_subtype), \
+	.max_len = (_max), \
+	.offset = offsetof(struct ie_list, _field), \
+}
+
+#define UTIL_SCAN_VENDOR_IE_DATA(_key, _min, _max, _field) { \
+	.key = (_key), \
+	.min_len = (_min), \
+	.subtype = UTIL_SCAN_IE_ANY_SUBTYPE, \
+	.max_len = (_max), \
+	.ie_off = sizeof(struct ie_header), \
+	.offset = offsetof(struct ie_list, _field), \
+}
+
+#define UTIL_SCAN_VENDOR_IE_HANDLER(_key, _min, _parse) { \
+	.key = (_key), \
+	.min_len = (_min), \
+	.subtype = UTIL_SCAN_IE_ANY_SUBTYPE, \
+	.parse = (_parse), \
+}
+
+/* first matching entry wins, keep the order of the legacy checks */
+static const struct util_scan_vendor_ie_desc util_scan_vendor_ie_tbl[] = {
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(WLAN_WPA_OUI,
+						 WLAN_WPA_OUI_TYPE),
+			    4, UTIL_SCAN_IE_ANY_SUBTYPE,
+			    UTIL_SCAN_IE_ANY_LEN, wpa),
+	UTIL_SCAN_VENDOR_IE_HANDLER(UTIL_SCAN_VENDOR_KEY_BE(WSC_OUI),
+				    4, util_scan_parse_wps_ie),
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(WME_OUI, WME_OUI_TYPE),
+			    6, WME_PARAM_OUI_SUBTYPE,
+			    WLAN_VENDOR_WME_IE_LEN, wmeparam),
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(WME_OUI, WME_OUI_TYPE),
+			    6, WME_INFO_OUI_SUBTYPE,
+			    UTIL_SCAN_IE_ANY_LEN, wmeinfo),
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(ATH_OUI, ATH_OUI_TYPE),
+			    4, UTIL_SCAN_IE_ANY_SUBTYPE,
+			    WLAN_VENDOR_ATHCAPS_IE_LEN, athcaps),
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(ATH_OUI,
+						 ATH_OUI_EXTCAP_TYPE),
+			    4, UTIL_SCAN_IE_ANY_SUBTYPE,
+			    WLAN_VENDOR_ATH_EXTCAP_IE_LEN, athextcaps),
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(SFA_OUI, SFA_OUI_TYPE),
+			    5, UTIL_SCAN_IE_ANY_SUBTYPE,
+			    WLAN_VENDOR_SFA_IE_LEN, sfa),
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(UTIL_SCAN_WFA_OUI,
+						 P2P_WFA_VER),
+			    4, UTIL_SCAN_IE_ANY_SUBTYPE,
+			    UTIL_SCAN_IE_ANY_LEN, p2p),
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(QCA_OUI, QCA_OUI_WHC_TYPE),
+			    5, QCA_OUI_WHC_AP_INFO_SUBTYPE,
+			    UTIL_SCAN_IE_ANY_LEN, sonadv),
+	UTIL_SCAN_VENDOR_IE_HANDLER(UTIL_SCAN_VENDOR_KEY_BE((VENDOR_HT_OUI << 8) |
+							   VENDOR_HT_CAP_ID),
+				    4, util_scan_parse_vendor_htcap_ie),
+	UTIL_SCAN_VENDOR_IE_HANDLER(UTIL_SCAN_VENDOR_KEY_BE((VENDOR_HT_OUI << 8) |
+							   VENDOR_HT_INFO_ID),
+				    4, util_scan_parse_vendor_htinfo_ie),
+	UTIL_SCAN_VENDOR_IE_HANDLER(UTIL_SCAN_VENDOR_KEY_BE((VHT_INTEROP_OUI << 8) |
+							   VHT_INTEROP_TYPE),
+				    13, util_scan_parse_interop_vht_ie),
+	/*
+	 * Bandwidth-NSS map has sub-type & version.
+	 * hence record data just after version byte
+	 */
+	{
+		.key = UTIL_SCAN_VENDOR_KEY(ATH_OUI, ATH_OUI_BW_NSS_MAP_TYPE),
+		.min_len = WLAN_BWNSS_MAP_OFFSET + 1,
+		.subtype = UTIL_SCAN_IE_ANY_SUBTYPE,
+		.max_len = UTIL_SCAN_IE_ANY_LEN,
+		.ie_off = 8,
+		.offset = offsetof(struct ie_list, bwnss_map),
+	},
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY_BE(MBO_OCE_OUI),
+			    4, UTIL_SCAN_IE_ANY_SUBTYPE,
+			    UTIL_SCAN_IE_ANY_LEN, mbo_oce),
+	UTIL_SCAN_VENDOR_IE(UTIL_SCAN_VENDOR_KEY(QCA_OUI,
+						 QCA_OUI_EXTENDER_TYPE),
+			    5, UTIL_SCAN_IE_ANY_SUBTYPE,
+			    UTIL_SCAN_IE_ANY_LEN, extender),
+	UTIL_SCAN_VENDOR_IE_DATA(UTIL_SCAN_VENDOR_KEY(ADAPTIVE_11R_OUI,
+						      ADAPTIVE_11R_OUI_TYPE),
+				 OUI_LENGTH + 1, MAX_ADAPTIVE_11R_IE_LEN,
+				 adaptive_11r),
+	UTIL_SCAN_VENDOR_IE_DATA(UTIL_SCAN_VENDOR_KEY(SAE_SINGLE_PMK_OUI,
+						      SAE_SINGLE_PMK_TYPE),
+				 OUI_LENGTH + 1, MAX_SAE_SINGLE_PMK_IE_LEN,
+				 single_pmk),
+};
+
 static QDF_STATUS
 util_scan_parse_vendor_ie(struct scan_cache_entry *scan_params,
 	struct ie_header *ie)
 {
+	const struct util_scan_vendor_ie_desc *desc;
+	uint8_t *frm = (uint8_t *)ie;
+	uint32_t key;
+	uint8_t i;
+
 	if (!scan_params->ie_list.vendor)
 		scan_params->ie_list.vendor = (uint8_t *)ie;
 
-	if (is_wpa_oui((uint8_t *)ie)) {
-		scan_params->ie_list.wpa = (uint8_t *)ie;
-	} else if (is_wps_oui((uint8_t *)ie)) {
-		scan_params->ie_list.wps = (uint8_t *)ie;
-		/* WCN IE should be a subset of WPS IE */
-		if (is_wcn_oui((uint8_t *)ie))
-			scan_params->ie_list.wcn = (uint8_t *)ie;
-	} else if (is_wme_param((uint8_t *)ie)) {
-		if (ie->ie_len > WLAN_VENDOR_WME_IE_LEN)
-			return QDF_STATUS_E_INVAL;
+	if (ie->ie_len < OUI_LENGTH)
+		return QDF_STATUS_SUCCESS;
 
-		scan_params->ie_list.wmeparam = (uint8_t *)ie;
-	} else if (is_wme_info((uint8_t *)ie)) {
-		scan_params->ie_list.wmeinfo = (uint8_t *)ie;
-	} else if (is_atheros_oui((uint8_t *)ie)) {
-		if (ie->ie_len > WLAN_VENDOR_ATHCAPS_IE_LEN)
-			return QDF_STATUS_E_INVAL;
+	/* read OUI and type once, then dispatch on it */
+	key = LE_READ_4(frm + sizeof(struct ie_header));
+	for (i = 0; i < QDF_ARRAY_SIZE(util_scan_vendor_ie_tbl); i++) {
+		desc = &util_scan_vendor_ie_tbl[i];
+		if (desc->key != key || ie->ie_len < desc->min_len)
+			continue;
+		if (desc->subtype != UTIL_SCAN_IE_ANY_SUBTYPE &&
+		    frm[sizeof(struct ie_header) + OUI_LENGTH] !=
+		    desc->subtype)
+			continue;
 
-		scan_params->ie_list.athcaps = (uint8_t *)ie;
-	} else if (is_atheros_extcap_oui((uint8_t *)ie)) {
-		if (ie->ie_len > WLAN_VENDOR_ATH_EXTCAP_IE_LEN)
-			return QDF_STATUS_E_INVAL;
+		if (desc->parse)
+			return desc->parse(scan_params, ie);
 
-		scan_params->ie_list.athextcaps = (uint8_t *)ie;
-	} else if (is_sfa_oui((uint8_t *)ie)) {
-		if (ie->ie_len > WLAN_VENDOR_SFA_IE_LEN)
+		if (ie->ie_len > desc->max_len)
 			return QDF_STATUS_E_INVAL;
 
-		scan_params->ie_list.sfa = (uint8_t *)ie;
-	} else if (is_p2p_oui((uint8_t *)ie)) {
-		scan_params->ie_list.p2p = (uint8_t *)ie;
-	} else if (is_qca_son_oui((uint8_t *)ie,
-				  QCA_OUI_WHC_AP_INFO_SUBTYPE)) {
-
-		scan_params->ie_list.sonadv = (uint8_t *)ie;
-	} else if (is_ht_cap((uint8_t *)ie)) {
-		/* we only care if there isn't already an HT IE (ANA) */
-		if (!scan_params->ie_list.htcap) {
-			if (ie->ie_len != (WLAN_VENDOR_HT_IE_OFFSET_LEN +
-					   sizeof(struct htcap_cmn_ie)))
-				return QDF_STATUS_E_INVAL;
-			scan_params->ie_list.htcap =
-			 (uint8_t *)&(((struct wlan_vendor_ie_htcap *)ie)->ie);
-		}
-	} else if (is_ht_info((uint8_t *)ie)) {
-		/* we only care if there isn't already an HT IE (ANA) */
-		if (!scan_params->ie_list.htinfo) {
-			if (ie->ie_len != WLAN_VENDOR_HT_IE_OFFSET_LEN +
-					  sizeof(struct wlan_ie_htinfo_cmn))
-				return QDF_STATUS_E_INVAL;
-			scan_params->ie_list.htinfo =
-			  (uint8_t *)&(((struct wlan_vendor_ie_htinfo *)
-			  ie)->hi_ie);
-		}
-	} else if (is_interop_vht((uint8_t *)ie) &&
-	    !(scan_params->ie_list.vhtcap)) {
-		uint8_t *vendor_ie = (uint8_t *)(ie);
-
-		if (ie->ie_len < ((WLAN_VENDOR_VHTCAP_IE_OFFSET +
-				 sizeof(struct wlan_ie_vhtcaps)) -
-				 sizeof(struct ie_header)))
-			return QDF_STATUS_E_INVAL;
-		vendor_ie = ((uint8_t *)(ie)) + WLAN_VENDOR_VHTCAP_IE_OFFSET;
-		if (vendor_ie[1] != (sizeof(struct wlan_ie_vhtcaps)) -
-				      sizeof(struct ie_header))
-			return QDF_STATUS_E_INVAL;
-		/* location where Interop Vht Cap IE and VHT OP IE Present */
-		scan_params->ie_list.vhtcap = (((uint8_t *)(ie)) +
-						WLAN_VENDOR_VHTCAP_IE_OFFSET);
-		if (ie->ie_len > ((WLAN_VENDOR_VHTCAP_IE_OFFSET +
-				 sizeof(struct wlan_ie_vhtcaps)) -
-				 sizeof(struct ie_header))) {
-			if (ie->ie_len < ((WLAN_VENDOR_VHTOP_IE_OFFSET +
-					  sizeof(struct wlan_ie_vhtop)) -
-					  sizeof(struct ie_header)))
-				return QDF_STATUS_E_INVAL;
-			vendor_ie = ((uint8_t *)(ie)) +
-				    WLAN_VENDOR_VHTOP_IE_OFFSET;
-			if (vendor_ie[1] != (sizeof(struct wlan_ie_vhtop) -
-					     sizeof(struct ie_header)))
-				return QDF_STATUS_E_INVAL;
-			scan_params->ie_list.vhtop = (((uint8_t *)(ie)) +
-						   WLAN_VENDOR_VHTOP_IE_OFFSET);
-		}
-	} else if (is_bwnss_oui((uint8_t *)ie)) {
-		/*
-		 * Bandwidth-NSS map has sub-type & version.
-		 * hence copy data just after version byte
-		 */
-		if (ie->ie_len > WLAN_BWNSS_MAP_OFFSET)
-			scan_params->ie_list.bwnss_map = (((uint8_t *)ie) + 8);
-	} else if (is_mbo_oce_oui((uint8_t *)ie)) {
-		scan_params->ie_list.mbo_oce = (uint8_t *)ie;
-	} else if (is_extender_oui((uint8_t *)ie)) {
-		scan_params->ie_list.extender = (uint8_t *)ie;
-	} else if (is_adaptive_11r_oui((uint8_t *)ie)) {
-		if ((ie->ie_len < OUI_LENGTH) ||
-		    (ie->ie_len > MAX_ADAPTIVE_11R_IE_LEN))
-			return QDF_STATUS_E_INVAL;
+		*(uint8_t **)((uint8_t *)&scan_params->ie_list +
+			      desc->offset) = frm + desc->ie_off;
 
-		scan_params->ie_list.adaptive_11r = (uint8_t *)ie +
-						sizeof(struct ie_header);
-	} else if (is_sae_single_pmk_oui((uint8_t *)ie)) {
-		if ((ie->ie_len < OUI_LENGTH) ||
-		    (ie->ie_len > MAX_SAE_SINGLE_PMK_IE_LEN)) {
-			scm_debug("Invalid sae single pmk OUI");
-			return QDF_STATUS_E_INVAL;
-		}
-		scan_params->ie_list.single_pmk = (uint8_t *)ie +
-						sizeof(struct ie_header);
+		return QDF_STATUS_SUCCESS;
 	}
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -1112,6 +1359,7 @@ util_scan_populate_bcn_ie_list(struct wlan_objmgr_pdev *pdev,
 			       struct scan_cache_entry *scan_params,
 			       qdf_freq_t *chan_freq, uint8_t band_mask)
 {
+	const struct util_scan_ie_desc *desc;
 	struct ie_header *ie, *sub_ie;
 	uint32_t ie_len, sub_ie_len;
 	QDF_STATUS status;
@@ -1157,18 +1405,15 @@ util_scan_populate_bcn_ie_list(struct wlan_objmgr_pdev *pdev,
 			return QDF_STATUS_E_INVAL;
 		}
 
+		desc = &util_scan_ie_tbl[ie->ie_id];
+		if (desc->flags & UTIL_SCAN_IE_VALID) {
+			status = util_scan_record_ie(scan_params, desc, ie);
+			if (QDF_IS_STATUS_ERROR(status))
+				goto err_status;
+			goto next_ie;
+		}
+
 		switch (ie->ie_id) {
-		case WLAN_ELEMID_SSID:
-			if (ie->ie_len > (sizeof(struct ie_ssid) -
-					  sizeof(struct ie_header)))
-				goto err;
-			scan_params->ie_list.ssid = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_RATES:
-			if (ie->ie_len > WLAN_SUPPORTED_RATES_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.rates = (uint8_t *)ie;
-			break;
 		case WLAN_ELEMID_DSPARMS:
 			if (ie->ie_len != WLAN_DS_PARAM_IE_MAX_LEN)
 				return QDF_STATUS_E_INVAL;
@@ -1194,39 +1439,6 @@ util_scan_populate_bcn_ie_list(struct wlan_objmgr_pdev *pdev,
 			scan_params->dtim_period =
 				((struct wlan_tim_ie *)ie)->tim_period;
 			break;
-		case WLAN_ELEMID_COUNTRY:
-			if (ie->ie_len < WLAN_COUNTRY_IE_MIN_LEN)
-				goto err;
-			scan_params->ie_list.country = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_QBSS_LOAD:
-			if (ie->ie_len != sizeof(struct qbss_load_ie) -
-					  sizeof(struct ie_header)) {
-				/*
-				 * Expected QBSS IE length is 5Bytes; For some
-				 * old cisco AP, QBSS IE length is 4Bytes, which
-				 * doesn't match with latest spec, So ignore
-				 * QBSS IE in such case.
-				 */
-				break;
-			}
-			scan_params->ie_list.qbssload = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_CHANSWITCHANN:
-			if (ie->ie_len != WLAN_CSA_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.csa = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_IBSSDFS:
-			if (ie->ie_len < WLAN_IBSSDFS_IE_MIN_LEN)
-				goto err;
-			scan_params->ie_list.ibssdfs = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_QUIET:
-			if (ie->ie_len != WLAN_QUIET_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.quiet = (uint8_t *)ie;
-			break;
 		case WLAN_ELEMID_ERP:
 			if (ie->ie_len != (sizeof(struct erp_ie) -
 					    sizeof(struct ie_header)))
@@ -1239,33 +1451,6 @@ util_scan_populate_bcn_ie_list(struct wlan_objmgr_pdev *pdev,
 				(uint8_t *)&(((struct htcap_ie *)ie)->ie);
 			}
 			break;
-		case WLAN_ELEMID_RSN:
-			/*
-			 * For security cert TC, RSNIE length can be 1 but if
-			 * beacon is dropped, old entry will remain in scan
-			 * cache and cause cert TC failure as connection with
-			 * old entry with valid RSN IE will pass.
-			 * So instead of dropping the frame, do not store the
-			 * RSN pointer so that old entry is overwritten.
-			 */
-			if (ie->ie_len >= WLAN_RSN_IE_MIN_LEN)
-				scan_params->ie_list.rsn = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_XRATES:
-			if (ie->ie_len > WLAN_EXT_SUPPORTED_RATES_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.xrates = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_EXTCHANSWITCHANN:
-			if (ie->ie_len != WLAN_XCSA_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.xcsa = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_SECCHANOFFSET:
-			if (ie->ie_len != WLAN_SECCHANOFF_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.secchanoff = (uint8_t *)ie;
-			break;
 		case WLAN_ELEMID_HTINFO_ANA:
 			if (ie->ie_len != sizeof(struct wlan_ie_htinfo_cmn))
 				goto err;
@@ -1284,38 +1469,6 @@ util_scan_populate_bcn_ie_list(struct wlan_objmgr_pdev *pdev,
 				return QDF_STATUS_E_INVAL;
 			}
 			break;
-		case WLAN_ELEMID_WAPI:
-			if (ie->ie_len < WLAN_WAPI_IE_MIN_LEN)
-				goto err;
-			scan_params->ie_list.wapi = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_XCAPS:
-			if (ie->ie_len > WLAN_EXTCAP_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.extcaps = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_VHTCAP:
-			if (ie->ie_len != (sizeof(struct wlan_ie_vhtcaps) -
-					   sizeof(struct ie_header)))
-				goto err;
-			scan_params->ie_list.vhtcap = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_VHTOP:
-			if (ie->ie_len != (sizeof(struct wlan_ie_vhtop) -
-					   sizeof(struct ie_header)))
-				goto err;
-			scan_params->ie_list.vhtop = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_OP_MODE_NOTIFY:
-			if (ie->ie_len != WLAN_OPMODE_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.opmode = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_MOBILITY_DOMAIN:
-			if (ie->ie_len != WLAN_MOBILITY_DOMAIN_IE_MAX_LEN)
-				goto err;
-			scan_params->ie_list.mdie = (uint8_t *)ie;
-			break;
 		case WLAN_ELEMID_VENDOR:
 			status = util_scan_parse_vendor_ie(scan_params,
 							   ie);
@@ -1342,16 +1495,6 @@ util_scan_populate_bcn_ie_list(struct wlan_objmgr_pdev *pdev,
 				goto err_status;
 			}
 			break;
-		case WLAN_ELEMID_FILS_INDICATION:
-			if (ie->ie_len < WLAN_FILS_INDICATION_IE_MIN_LEN)
-				goto err;
-			scan_params->ie_list.fils_indication = (uint8_t *)ie;
-			break;
-		case WLAN_ELEMID_RSNXE:
-			if (!ie->ie_len)
-				goto err;
-			scan_params->ie_list.rsnxe = (uint8_t *)ie;
-			break;
 		case WLAN_ELEMID_EXTN_ELEM:
 			status = util_scan_parse_extn_ie(scan_params, ie);
 			if (QDF_IS_STATUS_ERROR(status))
@@ -1369,6 +1512,7 @@ util_scan_populate_bcn_ie_list(struct wlan_objmgr_pdev *pdev,
 			break;
 		}
 
+next_ie:
 		/* Consume info element */
 		ie_len -= ie->ie_len;
 		/* Go to next IE */
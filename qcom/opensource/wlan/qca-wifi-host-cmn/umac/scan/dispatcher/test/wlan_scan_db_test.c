@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Benchmark for the scan db. Synthetic entries, spread over a set of
+ * ssids, are added to a private scan db which is not attached to any
+ * pdev, so nothing is reported to the OS and the live scan db is left
+ * alone. Ssid lookups are then timed with the copying and the view
+ * result paths, and the private db is flushed again.
+ */
+
+#include "qdf_mem.h"
+#include "qdf_mc_timer.h"
+#include "qdf_time.h"
+#include "qdf_trace.h"
+#include "qdf_util.h"
+#include "wlan_mgmt_txrx_utils_api.h"
+#include "wlan_scan_utils_api.h"
+#include "../../core/src/wlan_scan_cache_db.h"
+#include "wlan_scan_db_test.h"
+
+#define WLAN_SCAN_DB_UT_NUM_SSID	32
+#define WLAN_SCAN_DB_UT_PER_SSID	8
+#define WLAN_SCAN_DB_UT_NUM_BSS	\
+	(WLAN_SCAN_DB_UT_NUM_SSID * WLAN_SCAN_DB_UT_PER_SSID)
+#define WLAN_SCAN_DB_UT_QUERY_ITER	1024
+#define WLAN_SCAN_DB_UT_CHAN_FREQ	2437
+
+/* "scandbNN" is patched in for the ssid, NN being the ssid index */
+static const uint8_t wlan_scan_db_ut_ies[] = {
+	/* SSID */
+	0x00, 0x08, 's', 'c', 'a', 'n', 'd', 'b', '0', '0',
+	/* supported rates */
+	0x01, 0x08, 0x82, 0x84, 0x8b, 0x96, 0x0c, 0x12, 0x18, 0x24,
+	/* DS params, channel 6 */
+	0x03, 0x01, 0x06,
+	/* RSN, CCMP/CCMP/PSK */
+	0x30, 0x14, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x04, 0x01, 0x00,
+	0x00, 0x0f, 0xac, 0x04, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x02,
+	0x0c, 0x00,
+};
+
+#define WLAN_SCAN_DB_UT_SSID_OFF	2
+#define WLAN_SCAN_DB_UT_SSID_LEN	8
+
+/**
+ * wlan_scan_db_ut_ssid() - ssid of a synthetic BSS
+ * @idx: ssid index
+ * @ssid: ssid to fill
+ *
+ * Return: None
+ */
+static void wlan_scan_db_ut_ssid(uint32_t idx, struct wlan_ssid *ssid)
+{
+	qdf_mem_copy(ssid->ssid,
+		     &wlan_scan_db_ut_ies[WLAN_SCAN_DB_UT_SSID_OFF],
+		     WLAN_SCAN_DB_UT_SSID_LEN);
+	ssid->ssid[WLAN_SCAN_DB_UT_SSID_LEN - 2] = '0' + idx / 10;
+	ssid->ssid[WLAN_SCAN_DB_UT_SSID_LEN - 1] = '0' + idx % 10;
+	ssid->length = WLAN_SCAN_DB_UT_SSID_LEN;
+}
+
+/**
+ * wlan_scan_db_ut_add() - add one synthetic BSS to the private scan db
+ * @scan_db: private scan db
+ * @idx: BSS index
+ *
+ * Return: QDF_STATUS
+ */
+static QDF_STATUS wlan_scan_db_ut_add(struct scan_dbs *scan_db, uint32_t idx)
+{
+	uint32_t hdr_len = sizeof(struct wlan_frame_hdr) +
+			   offsetof(struct wlan_bcn_frame, ie);
+	uint32_t frame_len = hdr_len + sizeof(wlan_scan_db_ut_ies);
+	struct scan_cache_entry *entry;
+	struct wlan_frame_hdr *hdr;
+	struct wlan_bcn_frame *fixed;
+	QDF_STATUS status;
+	uint8_t *frame;
+
+	entry = qdf_mem_malloc(sizeof(*entry));
+	if (!entry)
+		return QDF_STATUS_E_NOMEM;
+
+	frame = qdf_mem_malloc(frame_len);
+	if (!frame) {
+		qdf_mem_free(entry);
+		return QDF_STATUS_E_NOMEM;
+	}
+	entry->raw_frame.ptr = frame;
+	entry->raw_frame.len = frame_len;
+
+	/* locally administered 02:00:00:5d:<ssid>:<bss> */
+	hdr = (struct wlan_frame_hdr *)frame;
+	hdr->i_fc[0] = MGMT_SUBTYPE_BEACON;
+	qdf_mem_set(hdr->i_addr1, QDF_MAC_ADDR_SIZE, 0xff);
+	hdr->i_addr3[0] = 0x02;
+	hdr->i_addr3[3] = 0x5d;
+	hdr->i_addr3[4] = idx / WLAN_SCAN_DB_UT_PER_SSID;
+	hdr->i_addr3[5] = idx % WLAN_SCAN_DB_UT_PER_SSID;
+	qdf_mem_copy(hdr->i_addr2, hdr->i_addr3, QDF_MAC_ADDR_SIZE);
+
+	fixed = (struct wlan_bcn_frame *)(frame + sizeof(*hdr));
+	fixed->beacon_interval = qdf_cpu_to_le16(100);
+	fixed->capability.value = qdf_cpu_to_le16(0x0411);
+	qdf_mem_copy(&fixed->ie, wlan_scan_db_ut_ies,
+		     sizeof(wlan_scan_db_ut_ies));
+	wlan_scan_db_ut_ssid(idx / WLAN_SCAN_DB_UT_PER_SSID, &entry->ssid);
+	qdf_mem_copy(frame + hdr_len + WLAN_SCAN_DB_UT_SSID_OFF,
+		     entry->ssid.ssid, entry->ssid.length);
+
+	qdf_mem_copy(entry->bssid.bytes, hdr->i_addr3, QDF_MAC_ADDR_SIZE);
+	entry->ie_list.ssid = frame + hdr_len;
+	entry->frm_subtype = MGMT_SUBTYPE_BEACON;
+	entry->channel.chan_freq = WLAN_SCAN_DB_UT_CHAN_FREQ;
+	entry->rssi_raw = -56;
+	entry->snr = 40;
+	entry->scan_entry_time = qdf_mc_timer_get_system_time();
+
+	status = scm_private_db_add_entry(scan_db, entry);
+	if (QDF_IS_STATUS_ERROR(status))
+		util_scan_free_cache_entry(entry);
+
+	return status;
+}
+
+/**
+ * wlan_scan_db_ut_query() - time ssid lookups
+ * @scan_db: private scan db
+ * @view: use the view path instead of copies
+ * @name: name used in the report
+ *
+ * Return: number of errors
+ */
+static uint32_t wlan_scan_db_ut_query(struct scan_dbs *scan_db, bool view,
+				      const char *name)
+{
+	struct wlan_ssid ssid;
+	qdf_list_t *list;
+	uint32_t errors = 0;
+	uint32_t iter, i;
+	int64_t start;
+	uint64_t us;
+
+	start = qdf_ktime_to_ns(qdf_ktime_get());
+	for (iter = 0; iter < WLAN_SCAN_DB_UT_QUERY_ITER; iter++) {
+		i = iter % WLAN_SCAN_DB_UT_NUM_SSID;
+		wlan_scan_db_ut_ssid(i, &ssid);
+
+		list = scm_private_db_get_ssid_result(scan_db, &ssid, view);
+		if (!list) {
+			errors++;
+			continue;
+		}
+
+		if (qdf_list_size(list) != WLAN_SCAN_DB_UT_PER_SSID) {
+			qdf_nofl_alert("FAIL: %s ssid %u -> %u entries; expected %u",
+				       name, i, qdf_list_size(list),
+				       WLAN_SCAN_DB_UT_PER_SSID);
+			errors++;
+		}
+		scm_purge_scan_results(list);
+	}
+	us = qdf_do_div(qdf_ktime_to_ns(qdf_ktime_get()) - start, 1000);
+	if (!us)
+		us = 1;
+
+	qdf_nofl_info("scan db bench: %s %llu lookups/sec", name,
+		      qdf_do_div((uint64_t)WLAN_SCAN_DB_UT_QUERY_ITER *
+				 1000000, (uint32_t)us));
+
+	return errors;
+}
+
+uint32_t wlan_scan_db_unit_test(void)
+{
+	struct scan_dbs *scan_db;
+	uint32_t errors = 0;
+	int64_t start;
+	uint64_t us;
+	uint32_t i;
+
+	scan_db = qdf_mem_malloc(sizeof(*scan_db));
+	if (!scan_db)
+		return 1;
+
+	scm_private_db_init(scan_db);
+
+	start = qdf_ktime_to_ns(qdf_ktime_get());
+	for (i = 0; i < WLAN_SCAN_DB_UT_NUM_BSS; i++) {
+		if (QDF_IS_STATUS_ERROR(wlan_scan_db_ut_add(scan_db, i))) {
+			qdf_nofl_alert("FAIL: adding BSS %u", i);
+			errors++;
+		}
+	}
+	us = qdf_do_div(qdf_ktime_to_ns(qdf_ktime_get()) - start, 1000);
+	if (!us)
+		us = 1;
+
+	qdf_nofl_info("scan db bench: %u entries, %llu inserts/sec",
+		      WLAN_SCAN_DB_UT_NUM_BSS,
+		      qdf_do_div((uint64_t)WLAN_SCAN_DB_UT_NUM_BSS * 1000000,
+				 (uint32_t)us));
+
+	errors += wlan_scan_db_ut_query(scan_db, false, "copy");
+	errors += wlan_scan_db_ut_query(scan_db, true, "view");
+
+	scm_private_db_deinit(scan_db);
+	qdf_mem_free(scan_db);
+
+	return errors;
+}
@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Fuzz and benchmark for the beacon/probe response IE parser. A small
+ * corpus of beacons is fed through util_scan_unpack_beacon_frame() on
+ * pdev 0 of psoc 0, first as is, then with random corruption, and then
+ * in a timed loop that reports frames/sec for each corpus frame.
+ */
+
+#include "qdf_mem.h"
+#include "qdf_time.h"
+#include "qdf_trace.h"
+#include "qdf_util.h"
+#include "wlan_objmgr_global_obj.h"
+#include "wlan_objmgr_psoc_obj.h"
+#include "wlan_objmgr_pdev_obj.h"
+#include "wlan_mgmt_txrx_utils_api.h"
+#include "wlan_reg_services_api.h"
+#include "wlan_scan_api.h"
+#include "wlan_scan_utils_api.h"
+#include "wlan_scan_ie_test.h"
+
+#define WLAN_SCAN_IE_UT_FRAME_MAX	512
+#define WLAN_SCAN_IE_UT_FUZZ_ITER	4096
+#define WLAN_SCAN_IE_UT_FUZZ_FLIPS	8
+#define WLAN_SCAN_IE_UT_BENCH_ITER	2048
+
+/**
+ * struct wlan_scan_ie_ut_frame - corpus beacon
+ * @name: name used in the report
+ * @chan_freq: frequency the beacon is received on
+ * @ies: IEs following the fixed beacon fields
+ * @ie_len: length of @ies
+ */
+struct wlan_scan_ie_ut_frame {
+	const char *name;
+	qdf_freq_t chan_freq;
+	const uint8_t *ies;
+	uint16_t ie_len;
+};
+
+/* 2.4 GHz WPA2 AP with HT and WMM */
+static const uint8_t wlan_scan_ie_ut_ies_2g[] = {
+	/* SSID */
+	0x00, 0x08, 'c', 'o', 'r', 'p', 'u', 's', '2', 'g',
+	/* supported rates */
+	0x01, 0x08, 0x82, 0x84, 0x8b, 0x96, 0x0c, 0x12, 0x18, 0x24,
+	/* DS params, channel 6 */
+	0x03, 0x01, 0x06,
+	/* TIM */
+	0x05, 0x04, 0x00, 0x01, 0x00, 0x00,
+	/* country */
+	0x07, 0x06, 'U', 'S', 0x20, 0x01, 0x0b, 0x1e,
+	/* ERP */
+	0x2a, 0x01, 0x00,
+	/* RSN, CCMP/CCMP/PSK */
+	0x30, 0x14, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x04, 0x01, 0x00,
+	0x00, 0x0f, 0xac, 0x04, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x02,
+	0x0c, 0x00,
+	/* extended supported rates */
+	0x32, 0x04, 0x30, 0x48, 0x60, 0x6c,
+	/* HT capabilities */
+	0x2d, 0x1a, 0xef, 0x19, 0x1b, 0xff, 0xff, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	/* HT information, primary channel 6 */
+	0x3d, 0x16, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00,
+	/* extended capabilities */
+	0x7f, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,
+	/* WMM parameter */
+	0xdd, 0x18, 0x00, 0x50, 0xf2, 0x02, 0x01, 0x01, 0x80, 0x00,
+	0x03, 0xa4, 0x00, 0x00, 0x27, 0xa4, 0x00, 0x00, 0x42, 0x43,
+	0x5e, 0x00, 0x62, 0x32, 0x2f, 0x00,
+};
+
+/* 5 GHz WPA3 AP with VHT and HE */
+static const uint8_t wlan_scan_ie_ut_ies_5g[] = {
+	/* SSID */
+	0x00, 0x08, 'c', 'o', 'r', 'p', 'u', 's', '5', 'g',
+	/* supported rates */
+	0x01, 0x08, 0x8c, 0x12, 0x98, 0x24, 0xb0, 0x48, 0x60, 0x6c,
+	/* TIM */
+	0x05, 0x04, 0x00, 0x01, 0x00, 0x00,
+	/* country */
+	0x07, 0x06, 'U', 'S', 0x20, 0x24, 0x04, 0x17,
+	/* RSN, CCMP/CCMP/SAE, MFP required */
+	0x30, 0x14, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x04, 0x01, 0x00,
+	0x00, 0x0f, 0xac, 0x04, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x08,
+	0xcc, 0x00,
+	/* HT capabilities */
+	0x2d, 0x1a, 0xef, 0x09, 0x1b, 0xff, 0xff, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	/* HT information, primary channel 36 */
+	0x3d, 0x16, 0x24, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00,
+	/* VHT capabilities */
+	0xbf, 0x0c, 0xb2, 0x79, 0x91, 0x33, 0xfa, 0xff, 0x0c, 0x03,
+	0xfa, 0xff, 0x0c, 0x03,
+	/* VHT operation, 80 MHz centred on 42 */
+	0xc0, 0x05, 0x01, 0x2a, 0x00, 0xfc, 0xff,
+	/* transmit power envelope */
+	0xc3, 0x04, 0x02, 0x28, 0x28, 0x28,
+	/* extended capabilities */
+	0x7f, 0x08, 0x04, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x40,
+	/* HE capabilities */
+	0xff, 0x16, 0x23, 0x0d, 0x01, 0x08, 0x1a, 0x40, 0x00, 0x04,
+	0x70, 0x0c, 0x89, 0x7f, 0x03, 0x80, 0x04, 0x00, 0x00, 0x00,
+	0xfa, 0xff, 0xfa, 0xff,
+	/* HE operation */
+	0xff, 0x07, 0x24, 0xf4, 0x3f, 0x00, 0x01, 0xfc, 0xff,
+	/* RSNXE, SAE hash to element */
+	0xf4, 0x01, 0x20,
+	/* WMM parameter */
+	0xdd, 0x18, 0x00, 0x50, 0xf2, 0x02, 0x01, 0x01, 0x80, 0x00,
+	0x03, 0xa4, 0x00, 0x00, 0x27, 0xa4, 0x00, 0x00, 0x42, 0x43,
+	0x5e, 0x00, 0x62, 0x32, 0x2f, 0x00,
+};
+
+static const struct wlan_scan_ie_ut_frame wlan_scan_ie_ut_corpus[] = {
+	{ "2g_wpa2_ht", 2437, wlan_scan_ie_ut_ies_2g,
+	  sizeof(wlan_scan_ie_ut_ies_2g) },
+	{ "5g_wpa3_he", 5180, wlan_scan_ie_ut_ies_5g,
+	  sizeof(wlan_scan_ie_ut_ies_5g) },
+};
+
+static const uint8_t wlan_scan_ie_ut_bssid[QDF_MAC_ADDR_SIZE] = {
+	0x02, 0x00, 0x00, 0x5c, 0xa1, 0x01
+};
+
+/**
+ * wlan_scan_ie_ut_build() - build a beacon from a corpus entry
+ * @corpus: corpus entry
+ * @frame: buffer of WLAN_SCAN_IE_UT_FRAME_MAX bytes
+ *
+ * Return: length of the frame
+ */
+static uint16_t
+wlan_scan_ie_ut_build(const struct wlan_scan_ie_ut_frame *corpus,
+		      uint8_t *frame)
+{
+	struct wlan_frame_hdr *hdr = (struct wlan_frame_hdr *)frame;
+	struct wlan_bcn_frame *bcn;
+
+	qdf_mem_zero(frame, WLAN_SCAN_IE_UT_FRAME_MAX);
+	hdr->i_fc[0] = MGMT_SUBTYPE_BEACON;
+	qdf_mem_set(hdr->i_addr1, QDF_MAC_ADDR_SIZE, 0xff);
+	qdf_mem_copy(hdr->i_addr2, wlan_scan_ie_ut_bssid, QDF_MAC_ADDR_SIZE);
+	qdf_mem_copy(hdr->i_addr3, wlan_scan_ie_ut_bssid, QDF_MAC_ADDR_SIZE);
+
+	bcn = (struct wlan_bcn_frame *)(frame + sizeof(*hdr));
+	bcn->beacon_interval = qdf_cpu_to_le16(100);
+	bcn->capability.value = qdf_cpu_to_le16(0x0431);
+	qdf_mem_copy(&bcn->ie, corpus->ies, corpus->ie_len);
+
+	return sizeof(*hdr) + offsetof(struct wlan_bcn_frame, ie) +
+		corpus->ie_len;
+}
+
+/**
+ * wlan_scan_ie_ut_check_entry() - check an entry's IE pointers
+ * @entry: scan entry built by the parser
+ *
+ * Every IE recorded in ie_list has to point into the entry's own copy
+ * of the frame.
+ *
+ * Return: number of pointers outside the frame
+ */
+static uint32_t wlan_scan_ie_ut_check_entry(struct scan_cache_entry *entry)
+{
+	uint8_t **ie = (uint8_t **)&entry->ie_list;
+	uint8_t *start = entry->raw_frame.ptr;
+	uint8_t *end = start + entry->raw_frame.len;
+	uint32_t errors = 0;
+	uint32_t i;
+
+	for (i = 0; i < sizeof(entry->ie_list) / sizeof(*ie); i++) {
+		if (ie[i] && (ie[i] < start || ie[i] >= end)) {
+			qdf_nofl_alert("FAIL: ie_list slot %u outside the frame",
+				       i);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+/**
+ * wlan_scan_ie_ut_parse() - parse one frame and check the result
+ * @pdev: pdev to parse on
+ * @frame: beacon
+ * @len: length of @frame
+ * @chan_freq: rx frequency
+ * @num_entries: set to the number of entries built
+ *
+ * Return: number of errors found in the entries
+ */
+static uint32_t wlan_scan_ie_ut_parse(struct wlan_objmgr_pdev *pdev,
+				      uint8_t *frame, uint16_t len,
+				      qdf_freq_t chan_freq,
+				      uint32_t *num_entries)
+{
+	struct mgmt_rx_event_params rx_param = {0};
+	struct scan_cache_node *node;
+	qdf_list_node_t *cur = NULL, *next = NULL;
+	qdf_list_t *list;
+	uint32_t errors = 0;
+
+	*num_entries = 0;
+	rx_param.chan_freq = chan_freq;
+	rx_param.snr = 40;
+	rx_param.rssi = -56;
+
+	list = util_scan_unpack_beacon_frame(pdev, frame, len,
+					     MGMT_SUBTYPE_BEACON, &rx_param);
+	if (!list)
+		return 0;
+
+	qdf_list_peek_front(list, &cur);
+	while (cur) {
+		node = qdf_container_of(cur, struct scan_cache_node, node);
+		errors += wlan_scan_ie_ut_check_entry(node->entry);
+		(*num_entries)++;
+		next = NULL;
+		qdf_list_peek_next(list, cur, &next);
+		cur = next;
+	}
+	wlan_scan_purge_results(list);
+
+	return errors;
+}
+
+static uint32_t wlan_scan_ie_ut_check_corpus(struct wlan_objmgr_pdev *pdev,
+					     uint8_t *frame)
+{
+	const struct wlan_scan_ie_ut_frame *corpus;
+	uint32_t errors = 0;
+	uint32_t entries;
+	uint16_t len;
+	uint32_t i;
+
+	for (i = 0; i < QDF_ARRAY_SIZE(wlan_scan_ie_ut_corpus); i++) {
+		corpus = &wlan_scan_ie_ut_corpus[i];
+		/* the parser drops beacons on channels the pdev lacks */
+		if (!wlan_reg_is_freq_present_in_cur_chan_list(
+						pdev, corpus->chan_freq))
+			continue;
+
+		len = wlan_scan_ie_ut_build(corpus, frame);
+		errors += wlan_scan_ie_ut_parse(pdev, frame, len,
+						corpus->chan_freq, &entries);
+		if (entries != 1) {
+			qdf_nofl_alert("FAIL: corpus %s -> %u entries; expected 1",
+				       corpus->name, entries);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+/*
+ * Corrupt random bytes of the IEs, IE length fields included, and cut
+ * the frame short now and then. The parser may reject the frame but it
+ * must not read past it or record an IE outside of it.
+ */
+static uint32_t wlan_scan_ie_ut_fuzz(struct wlan_objmgr_pdev *pdev,
+				     uint8_t *frame)
+{
+	const struct wlan_scan_ie_ut_frame *corpus;
+	uint32_t hdr_len = sizeof(struct wlan_frame_hdr) +
+			   offsetof(struct wlan_bcn_frame, ie);
+	uint32_t rnd[WLAN_SCAN_IE_UT_FUZZ_FLIPS + 1];
+	uint32_t errors = 0;
+	uint32_t parsed = 0;
+	uint32_t entries;
+	uint32_t iter, i, flips;
+	uint16_t len;
+
+	for (iter = 0; iter < WLAN_SCAN_IE_UT_FUZZ_ITER; iter++) {
+		qdf_get_random_bytes(rnd, sizeof(rnd));
+		corpus = &wlan_scan_ie_ut_corpus[iter %
+				QDF_ARRAY_SIZE(wlan_scan_ie_ut_corpus)];
+		len = wlan_scan_ie_ut_build(corpus, frame);
+
+		flips = 1 + rnd[0] % WLAN_SCAN_IE_UT_FUZZ_FLIPS;
+		for (i = 1; i <= flips; i++)
+			frame[hdr_len + (rnd[i] >> 8) % corpus->ie_len] =
+				rnd[i] & 0xff;
+
+		/* truncate one frame in four */
+		if (!(rnd[0] & (3 << 16)))
+			len = hdr_len + (rnd[0] >> 24) % corpus->ie_len;
+
+		errors += wlan_scan_ie_ut_parse(pdev, frame, len,
+						corpus->chan_freq, &entries);
+		if (entries)
+			parsed++;
+	}
+
+	qdf_nofl_info("scan ie fuzz: %u frames, %u accepted, %u errors",
+		      WLAN_SCAN_IE_UT_FUZZ_ITER, parsed, errors);
+
+	return errors;
+}
+
+static void wlan_scan_ie_ut_bench(struct wlan_objmgr_pdev *pdev,
+				  uint8_t *frame)
+{
+	const struct wlan_scan_ie_ut_frame *corpus;
+	struct mgmt_rx_event_params rx_param = {0};
+	qdf_list_t *list;
+	int64_t start;
+	uint64_t us;
+	uint32_t iter, i;
+	uint16_t len;
+
+	for (i = 0; i < QDF_ARRAY_SIZE(wlan_scan_ie_ut_corpus); i++) {
+		corpus = &wlan_scan_ie_ut_corpus[i];
+		len = wlan_scan_ie_ut_build(corpus, frame);
+		rx_param.chan_freq = corpus->chan_freq;
+
+		start = qdf_ktime_to_ns(qdf_ktime_get());
+		for (iter = 0; iter < WLAN_SCAN_IE_UT_BENCH_ITER; iter++) {
+			list = util_scan_unpack_beacon_frame(
+					pdev, frame, len,
+					MGMT_SUBTYPE_BEACON, &rx_param);
+			if (list)
+				wlan_scan_purge_results(list);
+		}
+		us = qdf_do_div(qdf_ktime_to_ns(qdf_ktime_get()) - start,
+				1000);
+		if (!us)
+			us = 1;
+
+		qdf_nofl_info("scan ie bench: %s %u bytes, %llu frames/sec",
+			      corpus->name, len,
+			      qdf_do_div((uint64_t)WLAN_SCAN_IE_UT_BENCH_ITER *
+					 1000000, (uint32_t)us));
+	}
+}
+
+uint32_t wlan_scan_ie_unit_test(void)
+{
+	struct wlan_objmgr_psoc *psoc;
+	struct wlan_objmgr_pdev *pdev;
+	uint32_t errors = 0;
+	uint8_t *frame;
+
+	psoc = wlan_objmgr_get_psoc_by_id(0, WLAN_SCAN_ID);
+	if (!psoc) {
+		qdf_nofl_alert("FAIL: scan ie test needs psoc 0");
+		return 1;
+	}
+
+	pdev = wlan_objmgr_get_pdev_by_id(psoc, 0, WLAN_SCAN_ID);
+	if (!pdev) {
+		qdf_nofl_alert("FAIL: scan ie test needs pdev 0");
+		wlan_objmgr_psoc_release_ref(psoc, WLAN_SCAN_ID);
+		return 1;
+	}
+
+	frame = qdf_mem_malloc(WLAN_SCAN_IE_UT_FRAME_MAX);
+	if (!frame) {
+		errors++;
+		goto release;
+	}
+
+	errors += wlan_scan_ie_ut_check_corpus(pdev, frame);
+	errors += wlan_scan_ie_ut_fuzz(pdev, frame);
+	wlan_scan_ie_ut_bench(pdev, frame);
+
+	qdf_mem_free(frame);
+
+release:
+	wlan_objmgr_pdev_release_ref(pdev, WLAN_SCAN_ID);
+	wlan_objmgr_psoc_release_ref(psoc, WLAN_SCAN_ID);
+
+	return errors;
+}
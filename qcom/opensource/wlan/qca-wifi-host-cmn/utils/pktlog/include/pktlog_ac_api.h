@@ -128,6 +128,19 @@ struct ath_pktlog_info {
 	uint32_t trigger_interval;
 	uint32_t start_time_thruput;
 	uint32_t start_time_per;
+
+	/*
+	 * Ring mode state, the copies in buf->ring are for the reader only.
+	 * ring_head and ring_tail hold PKTLOG_RING_POS() values, ring_writers
+	 * counts the lockless writers between reserve and commit.
+	 */
+	bool ring_mode;
+	uint32_t ring_size;
+	atomic64_t ring_head;
+	atomic64_t ring_tail;
+	qdf_atomic_t ring_writers;
+	qdf_atomic_t ring_overwritten;
+	qdf_atomic_t ring_dropped;
 };
 #endif /* _PKTLOG_INFO */
 #else                           /* REMOVE_PKT_LOG */
@@ -56,9 +56,61 @@ struct ath_pktlog_arg {
 };
 
 void pktlog_getbuf_intsafe(struct ath_pktlog_arg *plarg);
+
+/**
+ * pktlog_getbuf() - reserve a record in the pktlog buffer
+ * @pl_dev: pktlog device
+ * @pl_info: pktlog info
+ * @log_size: size of the record payload
+ * @pl_hdr: pktlog header to store ahead of the payload
+ * @ring_rec: set to true if the record was reserved in ring mode, to be
+ *	passed to pktlog_commit()
+ *
+ * In ring mode the record is dropped, and NULL returned, when the ring is
+ * full and its oldest record is still being written.
+ *
+ * Return: payload buffer of the record, NULL if none could be reserved
+ */
 char *pktlog_getbuf(struct pktlog_dev_t *pl_dev,
 		    struct ath_pktlog_info *pl_info,
-		    size_t log_size, struct ath_pktlog_hdr *pl_hdr);
+		    size_t log_size, struct ath_pktlog_hdr *pl_hdr,
+		    bool *ring_rec);
+
+/**
+ * pktlog_commit() - publish a record obtained from pktlog_getbuf()
+ * @pl_info: pktlog info
+ * @buf: buffer returned by pktlog_getbuf(), may be NULL
+ * @ring_rec: @ring_rec returned by the same pktlog_getbuf() call
+ *
+ * Must be called once the payload has been copied into @buf. For a ring
+ * record this clears the busy flag so that the mmap reader may consume
+ * it; for a linear mode record it is a no-op. The mode is the one the
+ * record was reserved in, even if the buffer switched mode since.
+ *
+ * Return: None
+ */
+void pktlog_commit(struct ath_pktlog_info *pl_info, char *buf, bool ring_rec);
+
+/**
+ * pktlog_ring_start() - switch the pktlog buffer to ring mode
+ * @pl_info: pktlog info
+ *
+ * Caller must hold pktlog_mutex and pl_info->buf must be allocated.
+ *
+ * Return: None
+ */
+void pktlog_ring_start(struct ath_pktlog_info *pl_info);
+
+/**
+ * pktlog_ring_stop() - switch the pktlog buffer back to linear mode
+ * @pl_info: pktlog info
+ *
+ * Waits for the lockless ring writers still running, so it may sleep.
+ * Caller must hold pktlog_mutex.
+ *
+ * Return: None
+ */
+void pktlog_ring_stop(struct ath_pktlog_info *pl_info);
 
 #ifdef PKTLOG_HAS_SPECIFIC_DATA
 /**
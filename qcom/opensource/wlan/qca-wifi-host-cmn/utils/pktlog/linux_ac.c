@@ -31,6 +31,7 @@
 #include <linux/init.h>
 #include <linux/module.h>
 #include <linux/vmalloc.h>
+#include <linux/mm.h>
 #include <linux/proc_fs.h>
 #include <pktlog_ac_i.h>
 #include <pktlog_ac_fmt.h>
@@ -60,6 +61,12 @@
 #define PKTLOG_PROCSYS_DIR_PERM 0555
 #define PKTLOG_PROCSYS_PERM     0644
 
+/*
+ * Smallest ring accepted for mmap, keeps the largest possible record
+ * (16 bit size plus headers) well below half the ring
+ */
+#define PKTLOG_RING_MIN_SIZE    (256 * 1024)
+
 #ifndef __MOD_INC_USE_COUNT
 #define PKTLOG_MOD_INC_USE_COUNT	do {			\
 	if (!try_module_get(THIS_MODULE)) {			\
@@ -84,18 +91,21 @@ static int pktlog_open(struct inode *i, struct file *f);
 static int pktlog_release(struct inode *i, struct file *f);
 static ssize_t pktlog_read(struct file *file, char *buf, size_t nbytes,
 			   loff_t *ppos);
+static int pktlog_mmap(struct file *file, struct vm_area_struct *vma);
 
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0))
 static const struct proc_ops pktlog_fops = {
 	.proc_open = pktlog_open,
 	.proc_release = pktlog_release,
 	.proc_read = pktlog_read,
+	.proc_mmap = pktlog_mmap,
 };
 #else
 static struct file_operations pktlog_fops = {
 	open:  pktlog_open,
 	release:pktlog_release,
 	read : pktlog_read,
+	mmap : pktlog_mmap,
 };
 #endif
 
@@ -678,6 +688,14 @@ static int __pktlog_release(struct inode *i, struct file *f)
 		ASSERT(0);
 		return -EINVAL;
 	}
+	if (pl_info->ring_mode) {
+		/* Logging may have been resumed by mmap, stop it first */
+		pktlog_ring_stop(pl_info);
+		if (pl_info->log_state) {
+			pl_dev->pl_funcs->pktlog_disable(scn);
+			pl_info->log_state = 0;
+		}
+	}
 	pl_info->curr_pkt_state = PKTLOG_OPR_IN_PROGRESS_READ_COMPLETE;
 	/*clear pktlog buffer.*/
 	pktlog_clearbuff(scn, true);
@@ -895,6 +913,12 @@ __pktlog_read(struct file *file, char *buf, size_t nbytes, loff_t *ppos)
 		return 0;
 	}
 
+	if (pl_info->ring_mode) {
+		/* The buffer is being consumed through mmap */
+		qdf_spin_unlock_bh(&pl_info->log_lock);
+		return -EBUSY;
+	}
+
 	if (pl_info->log_state) {
 		/* Read is not allowed when write is going on
 		 * When issuing cat command, ensure to send
@@ -1046,6 +1070,110 @@ pktlog_read(struct file *file, char *buf, size_t nbytes, loff_t *ppos)
 	return err_size;
 }
 
+static int __pktlog_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct hif_opaque_softc *scn;
+	struct pktlog_dev_t *pl_dev;
+	struct ath_pktlog_info *pl_info;
+	unsigned long size = vma->vm_end - vma->vm_start;
+	unsigned long addr, offset;
+	int ret;
+
+	scn = cds_get_context(QDF_MODULE_ID_HIF);
+	pl_dev = get_pktlog_handle();
+	if (!scn || !pl_dev || !pl_dev->pl_info)
+		return -ENODEV;
+
+	pl_info = pl_dev->pl_info;
+
+	/* The ring is written by the driver only */
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+
+	if (vma->vm_pgoff)
+		return -EINVAL;
+
+	mutex_lock(&pl_info->pktlog_mutex);
+	if (!pl_info->buf ||
+	    rounddown_pow_of_two(pl_info->buf_size) < PKTLOG_RING_MIN_SIZE) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	if (size > PAGE_ALIGN(sizeof(*pl_info->buf) + pl_info->buf_size)) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	/*
+	 * vm_insert_page() takes a reference on every page so the mapping
+	 * stays valid even if the buffer is later resized or freed.
+	 */
+	for (addr = vma->vm_start, offset = 0; addr < vma->vm_end;
+	     addr += PAGE_SIZE, offset += PAGE_SIZE) {
+		ret = vm_insert_page(vma, addr,
+				     vmalloc_to_page((char *)pl_info->buf +
+						     offset));
+		if (ret)
+			goto out;
+	}
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0))
+	vm_flags_mod(vma, VM_DONTEXPAND | VM_DONTDUMP, VM_MAYWRITE);
+#else
+	vma->vm_flags |= VM_DONTEXPAND | VM_DONTDUMP;
+	vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+
+	ret = 0;
+	if (pl_info->ring_mode)
+		goto out;
+
+	/*
+	 * Open disabled logging to take a snapshot; switch the buffer to
+	 * ring mode and resume logging with the state saved at open.
+	 */
+	pl_info->curr_pkt_state = PKTLOG_OPR_IN_PROGRESS_READ_COMPLETE;
+	ret = pktlog_clearbuff(scn, true);
+	if (ret) {
+		pl_info->curr_pkt_state =
+			PKTLOG_OPR_IN_PROGRESS_READ_START_PKTLOG_DISABLED;
+		goto out;
+	}
+
+	pktlog_ring_start(pl_info);
+
+	if (pl_info->init_saved_state) {
+		ret = __pktlog_enable(scn, pl_info->init_saved_state,
+				      cds_is_packet_log_enabled(), 0, 1);
+		if (ret)
+			qdf_print("pktlog cannot be enabled. ret value %d",
+				  ret);
+	}
+
+	/* Keep sysctl and other readers away while the ring is mapped */
+	pl_info->curr_pkt_state = PKTLOG_OPR_IN_PROGRESS_READ_START;
+out:
+	mutex_unlock(&pl_info->pktlog_mutex);
+	return ret;
+}
+
+static int pktlog_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct qdf_op_sync *op_sync;
+	int errno;
+
+	errno = qdf_op_protect(&op_sync);
+	if (errno)
+		return errno;
+
+	errno = __pktlog_mmap(file, vma);
+
+	qdf_op_unprotect(op_sync);
+
+	return errno;
+}
+
 int pktlogmod_init(void *context)
 {
 	int ret;
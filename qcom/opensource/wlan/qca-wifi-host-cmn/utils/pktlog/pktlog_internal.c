@@ -36,11 +36,17 @@
 #include "ol_htt_tx_api.h"
 #include "ol_tx_desc.h"
 #include "qdf_mem.h"
+#include "qdf_threads.h"
 #include "htt.h"
 #include "htt_internal.h"
 #include "pktlog_ac_i.h"
 #include "wma_api.h"
 #include "wlan_logging_sock_svc.h"
+#include <linux/log2.h>
+#include <linux/atomic.h>
+
+/* Poll interval while pktlog_ring_stop() waits for lockless writers */
+#define PKTLOG_RING_DRAIN_WAIT_US 10
 
 #ifdef PKTLOG_HAS_SPECIFIC_DATA
 void
@@ -70,6 +76,315 @@ pktlog_arg_get_specific_data(struct ath_pktlog_arg *plarg)
 }
 #endif /* PKTLOG_HAS_SPECIFIC_DATA */
 
+/**
+ * pktlog_fill_hdr() - fill the pktlog header of a record from @plarg
+ * @log_hdr: pktlog header inside the log buffer
+ * @plarg: pktlog argument describing the record
+ *
+ * Return: None
+ */
+static void pktlog_fill_hdr(struct ath_pktlog_hdr *log_hdr,
+			    struct ath_pktlog_arg *plarg)
+{
+	log_hdr->flags = plarg->flags;
+#ifdef HELIUMPLUS
+	log_hdr->macId = plarg->macId;
+	log_hdr->log_type = plarg->log_type;
+#else
+	log_hdr->log_type = plarg->log_type;
+#endif
+	log_hdr->size = (uint16_t)plarg->log_size;
+	log_hdr->missed_cnt = plarg->missed_cnt;
+	log_hdr->timestamp = plarg->timestamp;
+	pktlog_hdr_set_specific_data(log_hdr,
+				     pktlog_arg_get_specific_data(plarg));
+}
+
+void pktlog_ring_start(struct ath_pktlog_info *pl_info)
+{
+	struct ath_pktlog_ring *ring = &pl_info->buf->ring;
+
+	/* Linear writers hold log_lock, ring writers were drained by stop */
+	qdf_spin_lock_bh(&pl_info->log_lock);
+	pl_info->ring_size = rounddown_pow_of_two(pl_info->buf_size);
+	atomic64_set(&pl_info->ring_head, 0);
+	atomic64_set(&pl_info->ring_tail, 0);
+	qdf_atomic_set(&pl_info->ring_overwritten, 0);
+	qdf_atomic_set(&pl_info->ring_dropped, 0);
+
+	ring->data_offset = offsetof(struct ath_pktlog_buf, log_data);
+	ring->size = pl_info->ring_size;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->overwritten = 0;
+	ring->dropped = 0;
+	qdf_wmb();
+	ring->magic = PKTLOG_RING_MAGIC;
+	pl_info->ring_mode = true;
+	qdf_spin_unlock_bh(&pl_info->log_lock);
+}
+
+void pktlog_ring_stop(struct ath_pktlog_info *pl_info)
+{
+	bool ring_mode;
+
+	qdf_spin_lock_bh(&pl_info->log_lock);
+	ring_mode = pl_info->ring_mode;
+	pl_info->ring_mode = false;
+	qdf_spin_unlock_bh(&pl_info->log_lock);
+
+	if (!ring_mode)
+		return;
+
+	/* Ring writers do not take log_lock, wait for those still running */
+	qdf_mb();
+	while (qdf_atomic_read(&pl_info->ring_writers))
+		qdf_sleep_us(PKTLOG_RING_DRAIN_WAIT_US);
+
+	if (pl_info->buf)
+		pl_info->buf->ring.magic = 0;
+}
+
+/**
+ * pktlog_ring_enter() - account a lockless writer if the ring is active
+ * @pl_info: pktlog info
+ *
+ * Pairs with pktlog_ring_stop(): either the writer sees ring mode cleared
+ * or the stop sees the writer and waits for its pktlog_ring_exit().
+ *
+ * Return: true if the caller may reserve a ring record
+ */
+static bool pktlog_ring_enter(struct ath_pktlog_info *pl_info)
+{
+	if (!pl_info->ring_mode)
+		return false;
+
+	qdf_atomic_inc(&pl_info->ring_writers);
+	qdf_mb();
+	if (pl_info->ring_mode)
+		return true;
+
+	qdf_atomic_dec(&pl_info->ring_writers);
+	return false;
+}
+
+/**
+ * pktlog_ring_exit() - release a writer accounted by pktlog_ring_enter()
+ * @pl_info: pktlog info
+ *
+ * Return: None
+ */
+static void pktlog_ring_exit(struct ath_pktlog_info *pl_info)
+{
+	qdf_mb();
+	qdf_atomic_dec(&pl_info->ring_writers);
+}
+
+/**
+ * pktlog_ring_publish() - advance a position of the reader control block
+ * @pos: head or tail of struct ath_pktlog_ring
+ * @val: new PKTLOG_RING_POS() value
+ *
+ * Writers publish concurrently and may do so out of order, so the
+ * position only ever moves forward.
+ *
+ * Return: None
+ */
+static void pktlog_ring_publish(volatile uint64_t *pos, uint64_t val)
+{
+	uint64_t cur = *pos;
+	uint64_t old;
+
+	while ((int32_t)(PKTLOG_RING_POS_OFFSET(val) -
+			 PKTLOG_RING_POS_OFFSET(cur)) > 0) {
+		old = cmpxchg64((uint64_t *)pos, cur, val);
+		if (old == cur)
+			break;
+		cur = old;
+	}
+}
+
+/**
+ * pktlog_ring_drop() - count a record that could not be reserved
+ * @pl_info: pktlog info
+ *
+ * Return: None
+ */
+static void pktlog_ring_drop(struct ath_pktlog_info *pl_info)
+{
+	pl_info->buf->ring.dropped =
+		qdf_atomic_inc_return(&pl_info->ring_dropped);
+}
+
+/**
+ * pktlog_ring_evict() - evict the oldest record of the ring
+ * @pl_info: pktlog info
+ * @tail: ring_tail value the caller found too close to the head
+ *
+ * A record is evicted only once its writer committed it. The seq check
+ * catches a record whose space was reserved but whose header is not
+ * written yet, the bytes there still belong to an older lap.
+ *
+ * Return: false if the oldest record is still being written
+ */
+static bool pktlog_ring_evict(struct ath_pktlog_info *pl_info,
+			      uint64_t tail)
+{
+	struct ath_pktlog_ring_rec *rec;
+	uint32_t offset = PKTLOG_RING_POS_OFFSET(tail);
+	uint32_t seq = PKTLOG_RING_POS_SEQ(tail);
+	uint32_t flags, len;
+	uint64_t new_tail;
+
+	rec = (struct ath_pktlog_ring_rec *)
+		(pl_info->buf->log_data + (offset & (pl_info->ring_size - 1)));
+	if (rec->seq != seq)
+		return false;
+
+	qdf_rmb();
+	flags = rec->flags;
+	if (rec->seq_inv != ~seq || (flags & PKTLOG_RING_REC_BUSY))
+		return false;
+
+	qdf_rmb();
+	len = rec->len;
+	if (!(flags & PKTLOG_RING_REC_PAD))
+		seq++;
+	new_tail = PKTLOG_RING_POS(seq, offset + PKTLOG_RING_REC_SIZE(len));
+
+	/* Lost the race to another writer: it evicted this record already */
+	if (atomic64_cmpxchg(&pl_info->ring_tail, tail, new_tail) != tail)
+		return true;
+
+	if (!(flags & PKTLOG_RING_REC_PAD))
+		pl_info->buf->ring.overwritten =
+			qdf_atomic_inc_return(&pl_info->ring_overwritten);
+
+	return true;
+}
+
+/**
+ * pktlog_ring_write_hdr() - start a record in the ring
+ * @rec: record header inside the ring
+ * @seq: sequence number of the record
+ * @len: bytes following the record header
+ * @flags: final flags of the record, PKTLOG_RING_REC_BUSY for a record
+ *	completed later by pktlog_commit()
+ *
+ * The busy flag is set before the new seq is visible, so an evicting
+ * writer or the reader that matches the seq also sees the record busy.
+ *
+ * Return: None
+ */
+static void pktlog_ring_write_hdr(struct ath_pktlog_ring_rec *rec,
+				  uint32_t seq, uint32_t len, uint32_t flags)
+{
+	rec->flags = PKTLOG_RING_REC_BUSY;
+	qdf_wmb();
+	rec->seq_inv = ~seq;
+	rec->seq = seq;
+	rec->len = len;
+	if (flags == PKTLOG_RING_REC_BUSY)
+		return;
+
+	qdf_wmb();
+	rec->flags = flags;
+}
+
+/**
+ * pktlog_ring_reserve() - reserve a record in the mmap ring
+ * @plarg: pktlog argument, plarg->buf is set to the payload on success
+ *
+ * Lockless: space is claimed with a cmpxchg on ring_head, and the oldest
+ * records are evicted with a cmpxchg on ring_tail when the ring is full.
+ * Eviction stops at a record that is still being written; the new record
+ * is then dropped and counted instead. The new tail is published before
+ * any of the reclaimed bytes are reused so that a reader copying one of
+ * the evicted records can detect the overwrite. The record is left busy
+ * until pktlog_commit(). Caller must be inside pktlog_ring_enter().
+ *
+ * Return: None
+ */
+static void pktlog_ring_reserve(struct ath_pktlog_arg *plarg)
+{
+	struct ath_pktlog_info *pl_info = plarg->pl_info;
+	struct ath_pktlog_ring *ring = &pl_info->buf->ring;
+	struct ath_pktlog_ring_rec *rec;
+	uint32_t size = pl_info->ring_size;
+	uint32_t mask = size - 1;
+	uint32_t len, need, pad, offset, seq;
+	uint64_t head, tail, new_head;
+
+	len = sizeof(struct ath_pktlog_hdr) + plarg->log_size;
+	need = PKTLOG_RING_REC_SIZE(len);
+	if (need > size / 2) {
+		pktlog_ring_drop(pl_info);
+		return;
+	}
+
+	for (;;) {
+		head = atomic64_read(&pl_info->ring_head);
+		tail = atomic64_read(&pl_info->ring_tail);
+		offset = PKTLOG_RING_POS_OFFSET(head);
+		seq = PKTLOG_RING_POS_SEQ(head);
+
+		/* head moved on since it was read, tail followed it */
+		if ((int32_t)(PKTLOG_RING_POS_OFFSET(tail) - offset) > 0)
+			continue;
+
+		pad = 0;
+		if ((offset & mask) + need > size)
+			pad = size - (offset & mask);
+
+		if (offset + pad + need - PKTLOG_RING_POS_OFFSET(tail) > size) {
+			if (!pktlog_ring_evict(pl_info, tail)) {
+				pktlog_ring_drop(pl_info);
+				return;
+			}
+			continue;
+		}
+
+		new_head = PKTLOG_RING_POS(seq + 1, offset + pad + need);
+		if (atomic64_cmpxchg(&pl_info->ring_head, head,
+				     new_head) == head)
+			break;
+	}
+
+	pktlog_ring_publish(&ring->tail, atomic64_read(&pl_info->ring_tail));
+	qdf_wmb();
+
+	if (pad) {
+		rec = (struct ath_pktlog_ring_rec *)
+			(pl_info->buf->log_data + (offset & mask));
+		pktlog_ring_write_hdr(rec, seq, pad - sizeof(*rec),
+				      PKTLOG_RING_REC_PAD);
+		offset += pad;
+	}
+
+	rec = (struct ath_pktlog_ring_rec *)
+		(pl_info->buf->log_data + (offset & mask));
+	pktlog_ring_write_hdr(rec, seq, len, PKTLOG_RING_REC_BUSY);
+	pktlog_fill_hdr((struct ath_pktlog_hdr *)(rec + 1), plarg);
+	plarg->buf = (char *)(rec + 1) + sizeof(struct ath_pktlog_hdr);
+
+	qdf_wmb();
+	pktlog_ring_publish(&ring->head, new_head);
+}
+
+void pktlog_commit(struct ath_pktlog_info *pl_info, char *buf, bool ring_rec)
+{
+	struct ath_pktlog_ring_rec *rec;
+
+	if (!buf || !ring_rec)
+		return;
+
+	rec = (struct ath_pktlog_ring_rec *)
+		(buf - sizeof(struct ath_pktlog_hdr) - sizeof(*rec));
+	qdf_wmb();
+	rec->flags = 0;
+	pktlog_ring_exit(pl_info);
+}
+
 void pktlog_getbuf_intsafe(struct ath_pktlog_arg *plarg)
 {
 	struct ath_pktlog_buf *log_buf;
@@ -78,12 +393,7 @@ void pktlog_getbuf_intsafe(struct ath_pktlog_arg *plarg)
 	int32_t cur_wr_offset;
 	char *log_ptr;
 	struct ath_pktlog_info *pl_info;
-	uint16_t log_type;
 	size_t log_size;
-	uint32_t flags;
-#ifdef HELIUMPLUS
-	uint8_t mac_id;
-#endif
 
 	if (!plarg) {
 		qdf_info("Invalid parg");
@@ -91,21 +401,17 @@ void pktlog_getbuf_intsafe(struct ath_pktlog_arg *plarg)
 	}
 
 	pl_info = plarg->pl_info;
-#ifdef HELIUMPLUS
-	mac_id = plarg->macId;
-	log_type = plarg->log_type;
-#else
-	log_type = plarg->log_type;
-#endif
 	log_size = plarg->log_size;
 	log_buf = pl_info->buf;
-	flags = plarg->flags;
 
 	if (!log_buf) {
 		qdf_info("Invalid log_buf");
 		return;
 	}
 
+	/* The ring took over the buffer while waiting for log_lock */
+	if (pl_info->ring_mode)
+		return;
 
 	buf_size = pl_info->buf_size;
 	cur_wr_offset = log_buf->wr_offset;
@@ -123,18 +429,7 @@ void pktlog_getbuf_intsafe(struct ath_pktlog_arg *plarg)
 
 	log_hdr = (struct ath_pktlog_hdr *)(log_buf->log_data + cur_wr_offset);
 
-	log_hdr->flags = flags;
-#ifdef HELIUMPLUS
-	log_hdr->macId = mac_id;
-	log_hdr->log_type = log_type;
-#else
-	log_hdr->log_type = log_type;
-#endif
-	log_hdr->size = (uint16_t) log_size;
-	log_hdr->missed_cnt = plarg->missed_cnt;
-	log_hdr->timestamp = plarg->timestamp;
-	pktlog_hdr_set_specific_data(log_hdr,
-				     pktlog_arg_get_specific_data(plarg));
+	pktlog_fill_hdr(log_hdr, plarg);
 	cur_wr_offset += sizeof(*log_hdr);
 
 	if ((buf_size - cur_wr_offset) < log_size) {
@@ -163,7 +458,8 @@ void pktlog_getbuf_intsafe(struct ath_pktlog_arg *plarg)
 
 char *pktlog_getbuf(struct pktlog_dev_t *pl_dev,
 		    struct ath_pktlog_info *pl_info,
-		    size_t log_size, struct ath_pktlog_hdr *pl_hdr)
+		    size_t log_size, struct ath_pktlog_hdr *pl_hdr,
+		    bool *ring_rec)
 {
 	struct ath_pktlog_arg plarg = { 0, };
 	uint8_t flags = 0;
@@ -182,6 +478,21 @@ char *pktlog_getbuf(struct pktlog_dev_t *pl_dev,
 	pktlog_arg_set_specific_data(&plarg,
 				     pktlog_hdr_get_specific_data(pl_hdr));
 
+	/* Ring records are reserved without log_lock */
+	*ring_rec = false;
+	if (pktlog_ring_enter(pl_info)) {
+		if (pl_info->buf)
+			pktlog_ring_reserve(&plarg);
+
+		if (!plarg.buf) {
+			pktlog_ring_exit(pl_info);
+			return NULL;
+		}
+
+		*ring_rec = true;
+		return plarg.buf;
+	}
+
 	if (flags & PHFLAGS_INTERRUPT_CONTEXT) {
 		/*
 		 * We are already in interrupt context, no need to make it
@@ -199,6 +199,7 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 	 */
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_info *pl_info;
 	uint32_t *pl_tgt_hdr;
 	struct ol_fw_data *fw_data;
@@ -270,9 +271,11 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 		size_t log_size = sizeof(frm_hdr) + pl_hdr.size;
 		void *txdesc_hdr_ctl = (void *)
 				pktlog_getbuf(pl_dev, pl_info,
-					      log_size, &pl_hdr);
+					      log_size, &pl_hdr, &ring_rec);
+
+		if (!txdesc_hdr_ctl)
+			return A_ERROR;
 
-		qdf_assert(txdesc_hdr_ctl);
 		qdf_assert(pl_hdr.size < (370 * sizeof(u_int32_t)));
 
 		qdf_mem_copy(txdesc_hdr_ctl, &frm_hdr, sizeof(frm_hdr));
@@ -281,6 +284,7 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 			     sizeof(struct ath_pktlog_hdr)),
 			     pl_hdr.size);
 		pl_hdr.size = log_size;
+		pktlog_commit(pl_info, txdesc_hdr_ctl, ring_rec);
 		cds_pkt_stats_to_logger_thread(&pl_hdr, NULL,
 					       txdesc_hdr_ctl);
 	}
@@ -291,13 +295,17 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 
 		txstat_log.ds_status = (void *)
 				       pktlog_getbuf(pl_dev, pl_info,
-						     log_size, &pl_hdr);
-		qdf_assert(txstat_log.ds_status);
+						     log_size, &pl_hdr,
+						     &ring_rec);
+		if (!txstat_log.ds_status)
+			return A_ERROR;
+
 		qdf_mem_copy(txstat_log.ds_status,
 			     ((void *)fw_data->data +
 			      sizeof(struct ath_pktlog_hdr)),
 			     pl_hdr.size);
 		/* TODO: MCL specific API */
+		pktlog_commit(pl_info, txstat_log.ds_status, ring_rec);
 		cds_pkt_stats_to_logger_thread(&pl_hdr, NULL,
 					       txstat_log.ds_status);
 	}
@@ -312,6 +320,7 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 	 */
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_info *pl_info;
 	uint32_t *pl_tgt_hdr;
 	struct ol_fw_data *fw_data;
@@ -411,17 +420,6 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 		struct ath_pktlog_txctl txctl_log;
 		size_t log_size = sizeof(txctl_log.priv);
 
-		txctl_log.txdesc_hdr_ctl = (void *)pktlog_getbuf(pl_dev,
-								 pl_info,
-								 log_size,
-								 &pl_hdr);
-
-		if (!txctl_log.txdesc_hdr_ctl) {
-			qdf_nofl_info
-				("failed to get txctl_log.txdesc_hdr_ctl buf");
-			return A_ERROR;
-		}
-
 		/*
 		 * frm hdr is currently Valid only for local frames
 		 * Add capability to include the fmr hdr for remote frames
@@ -437,14 +435,27 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 			qdf_assert(0);
 			return A_ERROR;
 		}
+
+		txctl_log.txdesc_hdr_ctl = (void *)pktlog_getbuf(pl_dev,
+								 pl_info,
+								 log_size,
+								 &pl_hdr,
+								 &ring_rec);
+
+		if (!txctl_log.txdesc_hdr_ctl) {
+			qdf_nofl_info
+				("failed to get txctl_log.txdesc_hdr_ctl buf");
+			return A_ERROR;
+		}
+
 		qdf_mem_copy((void *)&txctl_log.priv.txdesc_ctl,
 			     ((void *)fw_data->data +
 			      sizeof(struct ath_pktlog_hdr)),
 			     pl_hdr.size);
-		qdf_assert(txctl_log.txdesc_hdr_ctl);
 		qdf_mem_copy(txctl_log.txdesc_hdr_ctl, &txctl_log.priv,
 			     sizeof(txctl_log.priv));
 		pl_hdr.size = log_size;
+		pktlog_commit(pl_info, txctl_log.txdesc_hdr_ctl, ring_rec);
 		cds_pkt_stats_to_logger_thread(&pl_hdr, NULL,
 					       txctl_log.txdesc_hdr_ctl);
 		/* Add Protocol information and HT specific information */
@@ -456,13 +467,17 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 
 		txstat_log.ds_status = (void *)
 				       pktlog_getbuf(pl_dev, pl_info,
-						     log_size, &pl_hdr);
-		qdf_assert(txstat_log.ds_status);
+						     log_size, &pl_hdr,
+						     &ring_rec);
+		if (!txstat_log.ds_status)
+			return A_ERROR;
+
 		qdf_mem_copy(txstat_log.ds_status,
 			     ((void *)fw_data->data +
 			      sizeof(struct ath_pktlog_hdr)),
 			     pl_hdr.size);
 
+		pktlog_commit(pl_info, txstat_log.ds_status, ring_rec);
 		cds_pkt_stats_to_logger_thread(&pl_hdr, NULL,
 					       txstat_log.ds_status);
 	}
@@ -479,13 +494,18 @@ A_STATUS process_tx_info(struct cdp_pdev *txrx_pdev, void *data)
 						&pl_msdu_info, fw_data->data);
 
 		pl_msdu_info.ath_msdu_info = pktlog_getbuf(pl_dev, pl_info,
-							   log_size, &pl_hdr);
+							   log_size, &pl_hdr,
+							   &ring_rec);
+		if (!pl_msdu_info.ath_msdu_info)
+			return A_ERROR;
+
 		qdf_mem_copy((void *)&pl_msdu_info.priv.msdu_id_info,
 			     ((void *)fw_data->data +
 			      sizeof(struct ath_pktlog_hdr)),
 			     sizeof(pl_msdu_info.priv.msdu_id_info));
 		qdf_mem_copy(pl_msdu_info.ath_msdu_info, &pl_msdu_info.priv,
 			     sizeof(pl_msdu_info.priv));
+		pktlog_commit(pl_info, pl_msdu_info.ath_msdu_info, ring_rec);
 		cds_pkt_stats_to_logger_thread(&pl_hdr, NULL,
 					       pl_msdu_info.ath_msdu_info);
 	}
@@ -500,6 +520,7 @@ A_STATUS process_rx_info_remote(void *pdev, void *data)
 	struct ath_pktlog_info *pl_info;
 	struct htt_host_rx_desc_base *rx_desc;
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_rx_info rxstat_log;
 	size_t log_size;
 	struct ol_rx_remote_data *r_data = (struct ol_rx_remote_data *)data;
@@ -545,9 +566,16 @@ A_STATUS process_rx_info_remote(void *pdev, void *data)
 		pktlog_hdr_set_specific_data(&pl_hdr, 0xDEADAA);
 
 		rxstat_log.rx_desc = (void *)pktlog_getbuf(pl_dev, pl_info,
-							   log_size, &pl_hdr);
+							   log_size, &pl_hdr,
+							   &ring_rec);
+		if (!rxstat_log.rx_desc) {
+			msdu = qdf_nbuf_next(msdu);
+			continue;
+		}
+
 		qdf_mem_copy(rxstat_log.rx_desc, (void *)rx_desc +
 			     sizeof(struct htt_host_fw_desc_base), pl_hdr.size);
+		pktlog_commit(pl_info, rxstat_log.rx_desc, ring_rec);
 		cds_pkt_stats_to_logger_thread(&pl_hdr, NULL,
 					       rxstat_log.rx_desc);
 		msdu = qdf_nbuf_next(msdu);
@@ -562,6 +590,7 @@ A_STATUS process_rx_info(void *pdev, void *data)
 	struct ath_pktlog_info *pl_info;
 	struct ath_pktlog_rx_info rxstat_log;
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	size_t log_size;
 	uint32_t *pl_tgt_hdr;
 	struct ol_fw_data *fw_data;
@@ -624,10 +653,15 @@ A_STATUS process_rx_info(void *pdev, void *data)
 
 	log_size = pl_hdr.size;
 	rxstat_log.rx_desc = (void *)pktlog_getbuf(pl_dev, pl_info,
-						   log_size, &pl_hdr);
+						   log_size, &pl_hdr,
+						   &ring_rec);
+	if (!rxstat_log.rx_desc)
+		return A_ERROR;
+
 	qdf_mem_copy(rxstat_log.rx_desc,
 		     (void *)fw_data->data + sizeof(struct ath_pktlog_hdr),
 		     pl_hdr.size);
+	pktlog_commit(pl_info, rxstat_log.rx_desc, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, rxstat_log.rx_desc);
 
 	return A_OK;
@@ -639,6 +673,7 @@ A_STATUS process_rx_info(void *pdev, void *data)
 	struct ath_pktlog_info *pl_info;
 	struct ath_pktlog_rx_info rxstat_log;
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	size_t log_size;
 	uint32_t *pl_tgt_hdr;
 	struct ol_fw_data *fw_data;
@@ -694,10 +729,15 @@ A_STATUS process_rx_info(void *pdev, void *data)
 
 	log_size = pl_hdr.size;
 	rxstat_log.rx_desc = (void *)pktlog_getbuf(pl_dev, pl_info,
-						   log_size, &pl_hdr);
+						   log_size, &pl_hdr,
+						   &ring_rec);
+	if (!rxstat_log.rx_desc)
+		return A_ERROR;
+
 	qdf_mem_copy(rxstat_log.rx_desc,
 		     (void *)fw_data->data + sizeof(struct ath_pktlog_hdr),
 		     pl_hdr.size);
+	pktlog_commit(pl_info, rxstat_log.rx_desc, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, rxstat_log.rx_desc);
 
 	return A_OK;
@@ -709,6 +749,7 @@ A_STATUS process_rate_find(void *pdev, void *data)
 {
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_info *pl_info;
 	size_t log_size;
 	uint32_t len;
@@ -771,16 +812,19 @@ A_STATUS process_rate_find(void *pdev, void *data)
 	pl_hdr.timestamp = *(pl_tgt_hdr + ATH_PKTLOG_HDR_TIMESTAMP_OFFSET);
 	pl_info = pl_dev->pl_info;
 	log_size = pl_hdr.size;
-	rcf_log.rcFind = (void *)pktlog_getbuf(pl_dev, pl_info,
-					       log_size, &pl_hdr);
-
 	if (sizeof(struct ath_pktlog_hdr) + pl_hdr.size > len) {
 		qdf_assert(0);
 		return A_ERROR;
 	}
+	rcf_log.rcFind = (void *)pktlog_getbuf(pl_dev, pl_info,
+					       log_size, &pl_hdr, &ring_rec);
+	if (!rcf_log.rcFind)
+		return A_ERROR;
+
 	qdf_mem_copy(rcf_log.rcFind,
 		     ((char *)fw_data->data + sizeof(struct ath_pktlog_hdr)),
 		     pl_hdr.size);
+	pktlog_commit(pl_info, rcf_log.rcFind, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, rcf_log.rcFind);
 
 	return A_OK;
@@ -791,6 +835,7 @@ A_STATUS process_rate_find(void *pdev, void *data)
 {
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_info *pl_info;
 	size_t log_size;
 	uint32_t len;
@@ -847,16 +892,19 @@ A_STATUS process_rate_find(void *pdev, void *data)
 	pl_hdr.timestamp = *(pl_tgt_hdr + ATH_PKTLOG_HDR_TIMESTAMP_OFFSET);
 	pl_info = pl_dev->pl_info;
 	log_size = pl_hdr.size;
-	rcf_log.rcFind = (void *)pktlog_getbuf(pl_dev, pl_info,
-					       log_size, &pl_hdr);
-
 	if (sizeof(struct ath_pktlog_hdr) + pl_hdr.size > len) {
 		qdf_assert(0);
 		return A_ERROR;
 	}
+	rcf_log.rcFind = (void *)pktlog_getbuf(pl_dev, pl_info,
+					       log_size, &pl_hdr, &ring_rec);
+	if (!rcf_log.rcFind)
+		return A_ERROR;
+
 	qdf_mem_copy(rcf_log.rcFind,
 		     ((char *)fw_data->data + sizeof(struct ath_pktlog_hdr)),
 		     pl_hdr.size);
+	pktlog_commit(pl_info, rcf_log.rcFind, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, rcf_log.rcFind);
 
 	return A_OK;
@@ -868,6 +916,7 @@ A_STATUS process_rate_update(void *pdev, void *data)
 {
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	size_t log_size;
 	struct ath_pktlog_info *pl_info;
 	struct ath_pktlog_rc_update rcu_log;
@@ -929,16 +978,21 @@ A_STATUS process_rate_update(void *pdev, void *data)
 	 * for pktlog is implemented in the firmware.
 	 * Currently derived from the TX PPDU status
 	 */
-	rcu_log.txRateCtrl = (void *)pktlog_getbuf(pl_dev, pl_info,
-						   log_size, &pl_hdr);
 	if (sizeof(struct ath_pktlog_hdr) + pl_hdr.size > len) {
 		qdf_assert(0);
 		return A_ERROR;
 	}
+	rcu_log.txRateCtrl = (void *)pktlog_getbuf(pl_dev, pl_info,
+						   log_size, &pl_hdr,
+						   &ring_rec);
+	if (!rcu_log.txRateCtrl)
+		return A_ERROR;
+
 	qdf_mem_copy(rcu_log.txRateCtrl,
 		     ((char *)fw_data->data +
 		      sizeof(struct ath_pktlog_hdr)),
 		     pl_hdr.size);
+	pktlog_commit(pl_info, rcu_log.txRateCtrl, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, rcu_log.txRateCtrl);
 	return A_OK;
 }
@@ -947,6 +1001,7 @@ A_STATUS process_rate_update(void *pdev, void *data)
 {
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	size_t log_size;
 	struct ath_pktlog_info *pl_info;
 	struct ath_pktlog_rc_update rcu_log;
@@ -1002,16 +1057,21 @@ A_STATUS process_rate_update(void *pdev, void *data)
 	 * for pktlog is implemented in the firmware.
 	 * Currently derived from the TX PPDU status
 	 */
-	rcu_log.txRateCtrl = (void *)pktlog_getbuf(pl_dev, pl_info,
-						   log_size, &pl_hdr);
 	if (sizeof(struct ath_pktlog_hdr) + pl_hdr.size > len) {
 		qdf_assert(0);
 		return A_ERROR;
 	}
+	rcu_log.txRateCtrl = (void *)pktlog_getbuf(pl_dev, pl_info,
+						   log_size, &pl_hdr,
+						   &ring_rec);
+	if (!rcu_log.txRateCtrl)
+		return A_ERROR;
+
 	qdf_mem_copy(rcu_log.txRateCtrl,
 		     ((char *)fw_data->data +
 		      sizeof(struct ath_pktlog_hdr)),
 		     pl_hdr.size);
+	pktlog_commit(pl_info, rcu_log.txRateCtrl, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, rcu_log.txRateCtrl);
 	return A_OK;
 }
@@ -1022,6 +1082,7 @@ A_STATUS process_sw_event(void *pdev, void *data)
 {
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_info *pl_info;
 	size_t log_size;
 	uint32_t len;
@@ -1092,16 +1153,20 @@ A_STATUS process_sw_event(void *pdev, void *data)
 		*(pl_tgt_hdr + ATH_PKTLOG_HDR_TYPE_SPECIFIC_DATA_OFFSET);
 	pl_info = pl_dev->pl_info;
 	log_size = pl_hdr.size;
-	sw_event.sw_event = (void *)pktlog_getbuf(pl_dev, pl_info,
-					       log_size, &pl_hdr);
 	if (sizeof(struct ath_pktlog_hdr) + pl_hdr.size > len) {
 		qdf_assert(0);
 		return A_ERROR;
 	}
+	sw_event.sw_event = (void *)pktlog_getbuf(pl_dev, pl_info,
+					       log_size, &pl_hdr, &ring_rec);
+	if (!sw_event.sw_event)
+		return A_ERROR;
+
 	qdf_mem_copy(sw_event.sw_event,
 		     ((char *)fw_data->data + sizeof(struct ath_pktlog_hdr)),
 		     pl_hdr.size);
 
+	pktlog_commit(pl_info, sw_event.sw_event, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, sw_event.sw_event);
 
 	return A_OK;
@@ -1111,6 +1176,7 @@ A_STATUS process_sw_event(void *pdev, void *data)
 {
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_info *pl_info;
 	size_t log_size;
 	uint32_t len;
@@ -1178,16 +1244,20 @@ A_STATUS process_sw_event(void *pdev, void *data)
 
 	pl_info = pl_dev->pl_info;
 	log_size = pl_hdr.size;
-	sw_event.sw_event = (void *)pktlog_getbuf(pl_dev, pl_info,
-					       log_size, &pl_hdr);
 	if (sizeof(struct ath_pktlog_hdr) + pl_hdr.size > len) {
 		qdf_assert(0);
 		return A_ERROR;
 	}
+	sw_event.sw_event = (void *)pktlog_getbuf(pl_dev, pl_info,
+					       log_size, &pl_hdr, &ring_rec);
+	if (!sw_event.sw_event)
+		return A_ERROR;
+
 	qdf_mem_copy(sw_event.sw_event,
 		     ((char *)fw_data->data + sizeof(struct ath_pktlog_hdr)),
 		     pl_hdr.size);
 
+	pktlog_commit(pl_info, sw_event.sw_event, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, sw_event.sw_event);
 
 	return A_OK;
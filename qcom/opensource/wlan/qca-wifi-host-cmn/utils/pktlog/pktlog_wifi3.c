@@ -24,6 +24,7 @@ process_offload_pktlog_wifi3(struct cdp_pdev *pdev, void *data)
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_info *pl_info;
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	uint32_t *pl_tgt_hdr;
 	void *txdesc_hdr_ctl = NULL;
 	size_t log_size = 0;
@@ -70,7 +71,8 @@ process_offload_pktlog_wifi3(struct cdp_pdev *pdev, void *data)
 	pl_info = pl_dev->pl_info;
 	log_size = pl_hdr.size;
 	txdesc_hdr_ctl =
-		(void *)pktlog_getbuf(pl_dev, pl_info, log_size, &pl_hdr);
+		(void *)pktlog_getbuf(pl_dev, pl_info, log_size, &pl_hdr,
+				      &ring_rec);
 	if (!txdesc_hdr_ctl) {
 		QDF_TRACE(QDF_MODULE_ID_DP, QDF_TRACE_LEVEL_ERROR,
 			  "Failed to allocate pktlog descriptor");
@@ -81,6 +83,7 @@ process_offload_pktlog_wifi3(struct cdp_pdev *pdev, void *data)
 	qdf_mem_copy(txdesc_hdr_ctl,
 		     ((void *)data + sizeof(struct ath_pktlog_hdr)),
 		     pl_hdr.size);
+	pktlog_commit(pl_info, txdesc_hdr_ctl, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, txdesc_hdr_ctl);
 
 	return A_OK;
@@ -90,6 +93,7 @@ int process_rx_desc_remote_wifi3(void *pdev, void *data)
 {
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_rx_info rxstat_log;
 	size_t log_size;
 	struct ath_pktlog_info *pl_info;
@@ -109,7 +113,7 @@ int process_rx_desc_remote_wifi3(void *pdev, void *data)
 	pl_hdr.timestamp = 0;
 	log_size = pl_hdr.size;
 	rxstat_log.rx_desc = (void *)pktlog_getbuf(pl_dev, pl_info,
-						  log_size, &pl_hdr);
+						  log_size, &pl_hdr, &ring_rec);
 
 	if (!rxstat_log.rx_desc) {
 		QDF_TRACE(QDF_MODULE_ID_QDF, QDF_TRACE_LEVEL_DEBUG,
@@ -118,6 +122,7 @@ int process_rx_desc_remote_wifi3(void *pdev, void *data)
 	}
 
 	qdf_mem_copy(rxstat_log.rx_desc, qdf_nbuf_data(log_nbuf), pl_hdr.size);
+	pktlog_commit(pl_info, rxstat_log.rx_desc, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL,
 				       rxstat_log.rx_desc);
 	return 0;
@@ -130,6 +135,7 @@ process_pktlog_lite_wifi3(void *context, void *log_data,
 	struct pktlog_dev_t *pl_dev = get_pktlog_handle();
 	struct ath_pktlog_info *pl_info;
 	struct ath_pktlog_hdr pl_hdr;
+	bool ring_rec;
 	struct ath_pktlog_rx_info rxstat_log;
 	size_t log_size;
 	qdf_nbuf_t log_nbuf = (qdf_nbuf_t)log_data;
@@ -148,7 +154,8 @@ process_pktlog_lite_wifi3(void *context, void *log_data,
 	pl_hdr.timestamp = 0;
 	log_size = pl_hdr.size;
 	rxstat_log.rx_desc = (void *)pktlog_getbuf(pl_dev, pl_info,
-						   log_size, &pl_hdr);
+						   log_size, &pl_hdr,
+						   &ring_rec);
 	if (!rxstat_log.rx_desc) {
 		QDF_TRACE(QDF_MODULE_ID_QDF, QDF_TRACE_LEVEL_DEBUG,
 			  "%s: Rx descriptor is NULL", __func__);
@@ -157,6 +164,7 @@ process_pktlog_lite_wifi3(void *context, void *log_data,
 
 	qdf_mem_copy(rxstat_log.rx_desc, qdf_nbuf_data(log_nbuf), pl_hdr.size);
 
+	pktlog_commit(pl_info, rxstat_log.rx_desc, ring_rec);
 	cds_pkt_stats_to_logger_thread(&pl_hdr, NULL, rxstat_log.rx_desc);
 	return 0;
 }
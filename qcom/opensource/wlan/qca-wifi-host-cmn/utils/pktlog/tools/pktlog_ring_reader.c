@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Reference userspace reader for the pktlog ring mode, see the "Ring mode"
+ * section of pktlog_ac_fmt.h for the protocol.
+ *
+ * The records are written to the output file in the same layout as a
+ * read() of the proc entry (struct ath_pktlog_bufhdr followed by
+ * struct ath_pktlog_hdr + payload records), so the existing post
+ * processing scripts can decode it.
+ *
+ * Build, from the wlan directory:
+ *	cc -O2 -Iqcacld-3.0/uapi/linux -Ifw-api/fw \
+ *		qca-wifi-host-cmn/utils/pktlog/tools/pktlog_ring_reader.c \
+ *		-o pktlog_ring_reader
+ *
+ * Usage: pktlog_ring_reader <proc file> <output file> [seconds]
+ *	e.g. pktlog_ring_reader /proc/ath_pktlog/cld /data/pktlog.dat 60
+ *
+ * The ring stays active, and read() of the proc entry returns -EBUSY,
+ * until the reader exits and closes the proc file.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#include "pktlog_ac_fmt.h"
+
+/* Poll interval when the reader caught up with the writers */
+#define RING_READER_POLL_US 1000
+
+#define ring_rmb() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
+static volatile sig_atomic_t ring_reader_stop;
+
+/**
+ * struct ring_reader - state of the reader
+ * @ring: control block inside the mapping
+ * @data: ring data inside the mapping
+ * @mask: ring size - 1
+ * @pos: free running offset of the next record to consume
+ * @seq: sequence number expected at @pos
+ * @records: records written to the output file
+ * @lost: records overwritten before the reader got to them
+ * @resyncs: number of times the reader was lapped by the writers
+ */
+struct ring_reader {
+	struct ath_pktlog_ring *ring;
+	char *data;
+	uint32_t mask;
+	uint32_t pos;
+	uint32_t seq;
+	uint64_t records;
+	uint64_t lost;
+	uint64_t resyncs;
+};
+
+static void ring_reader_sig(int sig)
+{
+	ring_reader_stop = 1;
+}
+
+/**
+ * ring_read_pos() - read head or tail of the control block
+ * @pos: position to read
+ *
+ * 64 bit loads are not single copy atomic on 32 bit readers, read until
+ * two consecutive loads agree.
+ *
+ * Return: PKTLOG_RING_POS() value
+ */
+static uint64_t ring_read_pos(volatile uint64_t *pos)
+{
+	uint64_t val, again;
+
+	val = *pos;
+	while ((again = *pos) != val)
+		val = again;
+
+	return val;
+}
+
+static int ring_lapped(struct ring_reader *rd)
+{
+	uint64_t tail = ring_read_pos(&rd->ring->tail);
+
+	return (int32_t)(PKTLOG_RING_POS_OFFSET(tail) - rd->pos) > 0;
+}
+
+static void ring_resync(struct ring_reader *rd)
+{
+	uint64_t tail = ring_read_pos(&rd->ring->tail);
+	uint32_t seq = PKTLOG_RING_POS_SEQ(tail);
+
+	if (rd->records || rd->resyncs)
+		rd->lost += (uint32_t)(seq - rd->seq);
+	rd->pos = PKTLOG_RING_POS_OFFSET(tail);
+	rd->seq = seq;
+}
+
+/**
+ * ring_consume() - copy the next record to @out
+ * @rd: reader state
+ * @out: output file
+ * @copy: scratch buffer of at least the ring size
+ *
+ * Return: 1 if a record was consumed, 0 if the writers have not
+ *	published the next one yet, -1 on output error
+ */
+static int ring_consume(struct ring_reader *rd, FILE *out, char *copy)
+{
+	struct ath_pktlog_ring_rec *rec;
+	uint32_t flags, len;
+
+	rec = (struct ath_pktlog_ring_rec *)(rd->data + (rd->pos & rd->mask));
+	if (rec->seq != rd->seq)
+		goto not_ready;
+
+	ring_rmb();
+	flags = rec->flags;
+	if (rec->seq_inv != ~rd->seq || (flags & PKTLOG_RING_REC_BUSY))
+		goto not_ready;
+
+	ring_rmb();
+	len = rec->len;
+	if (len > rd->mask)
+		goto overwritten;
+
+	memcpy(copy, rec + 1, len);
+	ring_rmb();
+	if (ring_lapped(rd))
+		goto overwritten;
+
+	rd->pos += PKTLOG_RING_REC_SIZE(len);
+	if (flags & PKTLOG_RING_REC_PAD)
+		return 1;
+
+	rd->seq++;
+	rd->records++;
+	if (fwrite(copy, 1, len, out) != len)
+		return -1;
+
+	return 1;
+
+not_ready:
+	if (!ring_lapped(rd))
+		return 0;
+overwritten:
+	rd->resyncs++;
+	ring_resync(rd);
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	struct ath_pktlog_bufhdr bufhdr = {
+		.magic_num = PKTLOG_MAGIC_NUM,
+		.version = CUR_PKTLOG_VER,
+	};
+	struct ring_reader rd = { 0 };
+	struct ath_pktlog_ring *ring;
+	long page_size = sysconf(_SC_PAGESIZE);
+	time_t end = 0;
+	size_t map_size;
+	char *copy;
+	void *map;
+	FILE *out;
+	int fd, ret;
+
+	if (argc < 3) {
+		fprintf(stderr,
+			"usage: %s <proc file> <output file> [seconds]\n",
+			argv[0]);
+		return 1;
+	}
+
+	if (argc > 3)
+		end = time(NULL) + atoi(argv[3]);
+
+	fd = open(argv[1], O_RDONLY);
+	if (fd < 0) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	/* The first mapping switches the driver to ring mode */
+	map = mmap(NULL, page_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+
+	ring = &((struct ath_pktlog_buf *)map)->ring;
+	if (ring->magic != PKTLOG_RING_MAGIC) {
+		fprintf(stderr, "ring mode not active\n");
+		return 1;
+	}
+
+	map_size = (ring->data_offset + ring->size + page_size - 1) &
+		   ~(page_size - 1);
+	munmap(map, page_size);
+	map = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+
+	rd.ring = &((struct ath_pktlog_buf *)map)->ring;
+	rd.data = (char *)map + rd.ring->data_offset;
+	rd.mask = rd.ring->size - 1;
+	ring_resync(&rd);
+
+	copy = malloc(rd.ring->size);
+	out = fopen(argv[2], "wb");
+	if (!copy || !out) {
+		perror(argv[2]);
+		return 1;
+	}
+
+	if (fwrite(&bufhdr, sizeof(bufhdr), 1, out) != 1) {
+		perror(argv[2]);
+		return 1;
+	}
+
+	signal(SIGINT, ring_reader_sig);
+	signal(SIGTERM, ring_reader_sig);
+
+	while (!ring_reader_stop && (!end || time(NULL) < end)) {
+		if (rd.ring->magic != PKTLOG_RING_MAGIC)
+			break;
+
+		ret = ring_consume(&rd, out, copy);
+		if (ret < 0) {
+			perror(argv[2]);
+			break;
+		}
+
+		if (!ret)
+			usleep(RING_READER_POLL_US);
+	}
+
+	fprintf(stderr,
+		"records %llu lost %llu resyncs %llu overwritten %u dropped %u\n",
+		(unsigned long long)rd.records, (unsigned long long)rd.lost,
+		(unsigned long long)rd.resyncs, rd.ring->overwritten,
+		rd.ring->dropped);
+
+	fclose(out);
+	free(copy);
+	munmap(map, map_size);
+	close(fd);
+
+	return 0;
+}
@@ -48,6 +48,24 @@ struct wbuff_alloc_request {
 	uint16_t size;
 };
 
+/**
+ * struct wbuff_pool_stats - usage statistics of a wbuff pool slot
+ * @hit: allocations served from the per CPU cache
+ * @miss: allocations which refilled the per CPU cache from the shared pool
+ * @fallback: allocations not served, requester falls back to nbuf alloc
+ * @replenished: buffers added to the pool by low watermark replenish
+ * @total: number of buffers currently owned by the pool
+ * @free: number of buffers currently free in the shared pool
+ */
+struct wbuff_pool_stats {
+	uint32_t hit;
+	uint32_t miss;
+	uint32_t fallback;
+	uint32_t replenished;
+	uint16_t total;
+	uint16_t free;
+};
+
 /* Opaque handle for wbuff */
 struct wbuff_mod_handle;
 
@@ -114,6 +132,26 @@ qdf_nbuf_t wbuff_buff_get(struct wbuff_mod_handle *hdl, uint32_t len,
  */
 qdf_nbuf_t wbuff_buff_put(qdf_nbuf_t buf);
 
+/**
+ * wbuff_get_pool_stats() - get usage statistics of a pool of a module
+ * @hdl: wbuff_handle corresponding to the module
+ * @pslot: pool slot identifier
+ * @stats: buffer to fill the statistics in
+ *
+ * Return: QDF_STATUS_SUCCESS - @stats filled
+ *         QDF_STATUS_E_INVAL - invalid handle or pool slot
+ */
+QDF_STATUS wbuff_get_pool_stats(struct wbuff_mod_handle *hdl, uint8_t pslot,
+				struct wbuff_pool_stats *stats);
+
+/**
+ * wbuff_stats_print() - print usage statistics of all pools of a module
+ * @hdl: wbuff_handle corresponding to the module
+ *
+ * Return: None
+ */
+void wbuff_stats_print(struct wbuff_mod_handle *hdl);
+
 #else
 
 static inline QDF_STATUS wbuff_module_init(void)
@@ -151,5 +189,16 @@ wbuff_buff_put(qdf_nbuf_t buf)
 	return buf;
 }
 
+static inline QDF_STATUS
+wbuff_get_pool_stats(struct wbuff_mod_handle *hdl, uint8_t pslot,
+		     struct wbuff_pool_stats *stats)
+{
+	return QDF_STATUS_E_NOSUPPORT;
+}
+
+static inline void wbuff_stats_print(struct wbuff_mod_handle *hdl)
+{
+}
+
 #endif
 #endif /* _WBUFF_H */
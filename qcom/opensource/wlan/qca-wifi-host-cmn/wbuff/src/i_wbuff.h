@@ -25,6 +25,9 @@
 #define _I_WBUFF_H
 
 #include <qdf_nbuf.h>
+#include <qdf_atomic.h>
+#include <qdf_defer.h>
+#include <qdf_util.h>
 
 /* Number of modules supported by wbuff */
 #define WBUFF_MAX_MODULES 4
@@ -57,6 +60,16 @@
 #define WBUFF_PSLOT_SHIFT 1
 #define WBUFF_PSLOT_BITMASK 0xE
 
+/* Max number of buffers cached per CPU for each pool */
+#define WBUFF_PCPU_CACHE_MAX 8
+/* Number of buffers moved between shared pool and a CPU cache at once */
+#define WBUFF_PCPU_BATCH 4
+
+/* Shared pool low watermark, as a right shift of the registered size */
+#define WBUFF_LOW_WATERMARK_SHIFT 2
+/* Max number of buffers allocated per replenish work run */
+#define WBUFF_REPLENISH_BATCH 16
+
 /* Comparison array for maximum allocation per pool*/
 uint16_t wbuff_alloc_max[WBUFF_MAX_POOLS] = {WBUFF_POOL_0_MAX,
 					     WBUFF_POOL_1_MAX,
@@ -71,6 +84,22 @@ struct wbuff_handle {
 	uint8_t id;
 };
 
+/**
+ * struct wbuff_pcpu_cache - per CPU buffer cache of a wbuff module
+ * @lock: Lock for accessing the cache, only contended on CPU migration
+ * @pool: cached buffers per pool slot
+ * @count: number of buffers in @pool per pool slot
+ * @hit: allocations served from this cache per pool slot
+ * @miss: allocations which had to refill from the shared pool
+ */
+struct wbuff_pcpu_cache {
+	qdf_spinlock_t lock;
+	qdf_nbuf_t pool[WBUFF_MAX_POOLS];
+	uint16_t count[WBUFF_MAX_POOLS];
+	uint32_t hit[WBUFF_MAX_POOLS];
+	uint32_t miss[WBUFF_MAX_POOLS];
+};
+
 /**
  * struct wbuff_module - allocation holder for wbuff registered module
  * @registered: To identify whether module is registered
@@ -81,15 +110,31 @@ struct wbuff_handle {
  * @reserve: nbuf headroom to start with
  * @align: alignment for the nbuf
  * @pool[]: pools for all available buffers for the module
+ * @free: number of buffers in the shared @pool per pool slot
+ * @total: number of buffers owned by wbuff per pool slot
+ * @size: registered number of buffers per pool slot
+ * @fallback: allocations returned empty as the pool slot ran dry
+ * @replenished: buffers added to the pool slot by @replenish_work
+ * @replenish_work: work to refill pool slots below low watermark
+ * @replenish_pending: @replenish_work is scheduled and not yet run
+ * @pcpu: per CPU buffer caches
  */
 struct wbuff_module {
 	bool registered;
-	uint16_t pending_returns;
+	qdf_atomic_t pending_returns;
 	qdf_spinlock_t lock;
 	struct wbuff_handle handle;
 	int reserve;
 	int align;
 	qdf_nbuf_t pool[WBUFF_MAX_POOLS];
+	uint16_t free[WBUFF_MAX_POOLS];
+	uint16_t total[WBUFF_MAX_POOLS];
+	uint16_t size[WBUFF_MAX_POOLS];
+	uint32_t fallback[WBUFF_MAX_POOLS];
+	uint32_t replenished[WBUFF_MAX_POOLS];
+	qdf_work_t replenish_work;
+	bool replenish_pending;
+	struct wbuff_pcpu_cache pcpu[QDF_MAX_AVAILABLE_CPU];
 };
 
 /**
@@ -170,10 +170,188 @@ static bool wbuff_is_valid_handle(struct wbuff_handle *handle)
 	return false;
 }
 
+/**
+ * wbuff_get_pcpu_cache() - get the buffer cache of the current CPU
+ * @mod: wbuff module
+ *
+ * Return: per CPU cache of @mod
+ */
+static inline struct wbuff_pcpu_cache *
+wbuff_get_pcpu_cache(struct wbuff_module *mod)
+{
+	int cpu = qdf_get_cpu();
+
+	if (qdf_unlikely(cpu >= QDF_MAX_AVAILABLE_CPU))
+		cpu %= QDF_MAX_AVAILABLE_CPU;
+
+	return &mod->pcpu[cpu];
+}
+
+/**
+ * wbuff_need_replenish() - check if a pool slot needs to be replenished
+ * @mod: wbuff module
+ * @pslot: pool slot
+ *
+ * Caller must hold mod->lock. Marks the replenish work as pending when
+ * replenish is needed, so the work is scheduled only once per run.
+ *
+ * Return: true if replenish work has to be scheduled
+ */
+static bool wbuff_need_replenish(struct wbuff_module *mod, uint8_t pslot)
+{
+	if (mod->replenish_pending || !mod->size[pslot])
+		return false;
+
+	if (mod->free[pslot] >= (mod->size[pslot] >> WBUFF_LOW_WATERMARK_SHIFT))
+		return false;
+
+	if (mod->total[pslot] >= wbuff_alloc_max[pslot])
+		return false;
+
+	mod->replenish_pending = true;
+
+	return true;
+}
+
+/**
+ * wbuff_pcpu_refill() - refill a per CPU cache from the shared pool
+ * @mod: wbuff module
+ * @cache: per CPU cache of @mod
+ * @pslot: pool slot
+ *
+ * Caller must hold cache->lock. Moves up to WBUFF_PCPU_BATCH buffers
+ * under a single acquisition of mod->lock.
+ *
+ * Return: true if replenish work has to be scheduled
+ */
+static bool wbuff_pcpu_refill(struct wbuff_module *mod,
+			      struct wbuff_pcpu_cache *cache, uint8_t pslot)
+{
+	qdf_nbuf_t buf;
+	bool replenish;
+
+	qdf_spin_lock_bh(&mod->lock);
+	while (mod->pool[pslot] && cache->count[pslot] < WBUFF_PCPU_BATCH) {
+		buf = mod->pool[pslot];
+		mod->pool[pslot] = qdf_nbuf_next(buf);
+		mod->free[pslot]--;
+		qdf_nbuf_set_next(buf, cache->pool[pslot]);
+		cache->pool[pslot] = buf;
+		cache->count[pslot]++;
+	}
+	if (!cache->count[pslot])
+		mod->fallback[pslot]++;
+	replenish = wbuff_need_replenish(mod, pslot);
+	qdf_spin_unlock_bh(&mod->lock);
+
+	return replenish;
+}
+
+/**
+ * wbuff_pcpu_flush() - return buffers from a per CPU cache to shared pool
+ * @mod: wbuff module
+ * @cache: per CPU cache of @mod
+ * @pslot: pool slot
+ *
+ * Caller must hold cache->lock. Trims the cache down to
+ * WBUFF_PCPU_CACHE_MAX - WBUFF_PCPU_BATCH buffers and splices the trimmed
+ * chain into the shared pool under a single acquisition of mod->lock.
+ *
+ * Return: None
+ */
+static void wbuff_pcpu_flush(struct wbuff_module *mod,
+			     struct wbuff_pcpu_cache *cache, uint8_t pslot)
+{
+	qdf_nbuf_t first, last;
+	uint16_t cnt = 1;
+
+	first = cache->pool[pslot];
+	last = first;
+	while (cache->count[pslot] - cnt >
+	       WBUFF_PCPU_CACHE_MAX - WBUFF_PCPU_BATCH) {
+		last = qdf_nbuf_next(last);
+		cnt++;
+	}
+	cache->pool[pslot] = qdf_nbuf_next(last);
+	cache->count[pslot] -= cnt;
+
+	qdf_spin_lock_bh(&mod->lock);
+	qdf_nbuf_set_next(last, mod->pool[pslot]);
+	mod->pool[pslot] = first;
+	mod->free[pslot] += cnt;
+	qdf_spin_unlock_bh(&mod->lock);
+}
+
+/**
+ * wbuff_replenish_work() - replenish pool slots below low watermark
+ * @arg: wbuff module
+ *
+ * Buffers are allocated outside of mod->lock and spliced into the shared
+ * pool in one go. Pools never grow beyond wbuff_alloc_max.
+ *
+ * Return: None
+ */
+static void wbuff_replenish_work(void *arg)
+{
+	struct wbuff_module *mod = arg;
+	qdf_nbuf_t first, last, buf;
+	uint32_t len;
+	uint16_t need, cnt;
+	uint8_t pslot;
+
+	qdf_spin_lock_bh(&mod->lock);
+	mod->replenish_pending = false;
+	qdf_spin_unlock_bh(&mod->lock);
+
+	for (pslot = 0; pslot < WBUFF_MAX_POOLS; pslot++) {
+		qdf_spin_lock_bh(&mod->lock);
+		if (!mod->registered || !mod->size[pslot] ||
+		    mod->free[pslot] >=
+		    (mod->size[pslot] >> WBUFF_LOW_WATERMARK_SHIFT) ||
+		    mod->total[pslot] >= wbuff_alloc_max[pslot]) {
+			qdf_spin_unlock_bh(&mod->lock);
+			continue;
+		}
+		need = qdf_min(wbuff_alloc_max[pslot] - mod->total[pslot],
+			       WBUFF_REPLENISH_BATCH);
+		qdf_spin_unlock_bh(&mod->lock);
+
+		len = wbuff_get_len_from_pool_slot(pslot);
+		first = NULL;
+		last = NULL;
+		for (cnt = 0; cnt < need; cnt++) {
+			buf = wbuff_prepare_nbuf(mod->handle.id, pslot, len,
+						 mod->reserve, mod->align);
+			if (!buf)
+				break;
+			qdf_nbuf_set_next(buf, first);
+			first = buf;
+			if (!last)
+				last = buf;
+		}
+		if (!first)
+			continue;
+
+		qdf_spin_lock_bh(&mod->lock);
+		if (!mod->registered) {
+			qdf_spin_unlock_bh(&mod->lock);
+			qdf_nbuf_list_free(first);
+			continue;
+		}
+		qdf_nbuf_set_next(last, mod->pool[pslot]);
+		mod->pool[pslot] = first;
+		mod->free[pslot] += cnt;
+		mod->total[pslot] += cnt;
+		mod->replenished[pslot] += cnt;
+		qdf_spin_unlock_bh(&mod->lock);
+	}
+}
+
 QDF_STATUS wbuff_module_init(void)
 {
 	struct wbuff_module *mod = NULL;
 	uint8_t mslot = 0, pslot = 0;
+	int cpu;
 
 	if (!qdf_nbuf_is_dev_scratch_supported()) {
 		wbuff.initialized = false;
@@ -185,6 +363,11 @@ QDF_STATUS wbuff_module_init(void)
 		qdf_spinlock_create(&mod->lock);
 		for (pslot = 0; pslot < WBUFF_MAX_POOLS; pslot++)
 			mod->pool[pslot] = NULL;
+		for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++)
+			qdf_spinlock_create(&mod->pcpu[cpu].lock);
+		qdf_atomic_init(&mod->pending_returns);
+		qdf_create_work(0, &mod->replenish_work, wbuff_replenish_work,
+				mod);
 		mod->registered = false;
 	}
 	wbuff.initialized = true;
@@ -196,6 +379,7 @@ QDF_STATUS wbuff_module_deinit(void)
 {
 	struct wbuff_module *mod = NULL;
 	uint8_t mslot = 0;
+	int cpu;
 
 	if (!wbuff.initialized)
 		return QDF_STATUS_E_INVAL;
@@ -206,6 +390,9 @@ QDF_STATUS wbuff_module_deinit(void)
 		if (mod->registered)
 			wbuff_module_deregister((struct wbuff_mod_handle *)
 						&mod->handle);
+		qdf_destroy_work(0, &mod->replenish_work);
+		for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++)
+			qdf_spinlock_destroy(&mod->pcpu[cpu].lock);
 		qdf_spinlock_destroy(&mod->lock);
 	}
 
@@ -238,11 +425,14 @@ wbuff_module_register(struct wbuff_alloc_request *req, uint8_t num,
 	mod = &wbuff.mod[mslot];
 
 	mod->handle.id = mslot;
+	mod->reserve = reserve;
+	mod->align = align;
 
 	for (alloc = 0; alloc < num; alloc++) {
 		pslot = req[alloc].slot;
 		psize = req[alloc].size;
 		len = wbuff_get_len_from_pool_slot(pslot);
+		mod->size[pslot] = psize;
 		/**
 		 * Allocate pool_cnt number of buffers for
 		 * the pool given by pslot
@@ -259,10 +449,10 @@ wbuff_module_register(struct wbuff_alloc_request *req, uint8_t num,
 				qdf_nbuf_set_next(buf, mod->pool[pslot]);
 				mod->pool[pslot] = buf;
 			}
+			mod->free[pslot]++;
+			mod->total[pslot]++;
 		}
 	}
-	mod->reserve = reserve;
-	mod->align = align;
 
 	return (struct wbuff_mod_handle *)&mod->handle;
 }
@@ -271,8 +461,9 @@ QDF_STATUS wbuff_module_deregister(struct wbuff_mod_handle *hdl)
 {
 	struct wbuff_handle *handle;
 	struct wbuff_module *mod = NULL;
+	struct wbuff_pcpu_cache *cache;
 	uint8_t mslot = 0, pslot = 0;
-	qdf_nbuf_t first = NULL, buf = NULL;
+	int cpu;
 
 	handle = (struct wbuff_handle *)hdl;
 
@@ -282,16 +473,38 @@ QDF_STATUS wbuff_module_deregister(struct wbuff_mod_handle *hdl)
 	mslot = handle->id;
 	mod = &wbuff.mod[mslot];
 
+	wbuff_stats_print(hdl);
+
 	qdf_spin_lock_bh(&mod->lock);
-	for (pslot = 0; pslot < WBUFF_MAX_POOLS; pslot++) {
-		first = mod->pool[pslot];
-		while (first) {
-			buf = first;
-			first = qdf_nbuf_next(buf);
-			qdf_nbuf_free(buf);
+	mod->registered = false;
+	qdf_spin_unlock_bh(&mod->lock);
+
+	qdf_flush_work(&mod->replenish_work);
+
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++) {
+		cache = &mod->pcpu[cpu];
+		qdf_spin_lock_bh(&cache->lock);
+		for (pslot = 0; pslot < WBUFF_MAX_POOLS; pslot++) {
+			qdf_nbuf_list_free(cache->pool[pslot]);
+			cache->pool[pslot] = NULL;
+			cache->count[pslot] = 0;
+			cache->hit[pslot] = 0;
+			cache->miss[pslot] = 0;
 		}
+		qdf_spin_unlock_bh(&cache->lock);
 	}
-	mod->registered = false;
+
+	qdf_spin_lock_bh(&mod->lock);
+	for (pslot = 0; pslot < WBUFF_MAX_POOLS; pslot++) {
+		qdf_nbuf_list_free(mod->pool[pslot]);
+		mod->pool[pslot] = NULL;
+		mod->free[pslot] = 0;
+		mod->total[pslot] = 0;
+		mod->size[pslot] = 0;
+		mod->fallback[pslot] = 0;
+		mod->replenished[pslot] = 0;
+	}
+	mod->replenish_pending = false;
 	qdf_spin_unlock_bh(&mod->lock);
 
 	return QDF_STATUS_SUCCESS;
@@ -302,9 +515,11 @@ qdf_nbuf_t wbuff_buff_get(struct wbuff_mod_handle *hdl, uint32_t len,
 {
 	struct wbuff_handle *handle;
 	struct wbuff_module *mod = NULL;
+	struct wbuff_pcpu_cache *cache;
 	uint8_t mslot = 0;
 	uint8_t pslot = 0;
 	qdf_nbuf_t buf = NULL;
+	bool replenish = false;
 
 	handle = (struct wbuff_handle *)hdl;
 
@@ -315,14 +530,26 @@ qdf_nbuf_t wbuff_buff_get(struct wbuff_mod_handle *hdl, uint32_t len,
 	mslot = handle->id;
 	pslot = wbuff_get_pool_slot_from_len(len);
 	mod = &wbuff.mod[mslot];
-
-	qdf_spin_lock_bh(&mod->lock);
-	if (mod->pool[pslot]) {
-		buf = mod->pool[pslot];
-		mod->pool[pslot] = qdf_nbuf_next(buf);
-		mod->pending_returns++;
+	cache = wbuff_get_pcpu_cache(mod);
+
+	qdf_spin_lock_bh(&cache->lock);
+	if (cache->pool[pslot]) {
+		cache->hit[pslot]++;
+	} else {
+		cache->miss[pslot]++;
+		replenish = wbuff_pcpu_refill(mod, cache, pslot);
 	}
-	qdf_spin_unlock_bh(&mod->lock);
+	if (cache->pool[pslot]) {
+		buf = cache->pool[pslot];
+		cache->pool[pslot] = qdf_nbuf_next(buf);
+		cache->count[pslot]--;
+		qdf_atomic_inc(&mod->pending_returns);
+	}
+	qdf_spin_unlock_bh(&cache->lock);
+
+	if (replenish)
+		qdf_sched_work(0, &mod->replenish_work);
+
 	if (buf) {
 		qdf_nbuf_set_next(buf, NULL);
 		qdf_net_buf_debug_update_node(buf, func_name, line_num);
@@ -334,6 +561,8 @@ qdf_nbuf_t wbuff_buff_get(struct wbuff_mod_handle *hdl, uint32_t len,
 qdf_nbuf_t wbuff_buff_put(qdf_nbuf_t buf)
 {
 	qdf_nbuf_t buffer = buf;
+	struct wbuff_module *mod;
+	struct wbuff_pcpu_cache *cache;
 	unsigned long slot_info = 0;
 	uint8_t mslot = 0, pslot = 0;
 
@@ -350,16 +579,74 @@ qdf_nbuf_t wbuff_buff_put(qdf_nbuf_t buf)
 	if (mslot >= WBUFF_MAX_MODULES || pslot >= WBUFF_MAX_POOLS)
 		return NULL;
 
-	qdf_nbuf_reset(buffer, wbuff.mod[mslot].reserve, wbuff.mod[mslot].
-		       align);
-	qdf_spin_lock_bh(&wbuff.mod[mslot].lock);
-	if (wbuff.mod[mslot].registered) {
-		qdf_nbuf_set_next(buffer, wbuff.mod[mslot].pool[pslot]);
-		wbuff.mod[mslot].pool[pslot] = buffer;
-		wbuff.mod[mslot].pending_returns--;
+	mod = &wbuff.mod[mslot];
+	qdf_nbuf_reset(buffer, mod->reserve, mod->align);
+	cache = wbuff_get_pcpu_cache(mod);
+
+	qdf_spin_lock_bh(&cache->lock);
+	if (mod->registered) {
+		qdf_nbuf_set_next(buffer, cache->pool[pslot]);
+		cache->pool[pslot] = buffer;
+		cache->count[pslot]++;
+		qdf_atomic_dec(&mod->pending_returns);
 		buffer = NULL;
+		if (cache->count[pslot] > WBUFF_PCPU_CACHE_MAX)
+			wbuff_pcpu_flush(mod, cache, pslot);
 	}
-	qdf_spin_unlock_bh(&wbuff.mod[mslot].lock);
+	qdf_spin_unlock_bh(&cache->lock);
 
 	return buffer;
 }
+
+QDF_STATUS wbuff_get_pool_stats(struct wbuff_mod_handle *hdl, uint8_t pslot,
+				struct wbuff_pool_stats *stats)
+{
+	struct wbuff_handle *handle;
+	struct wbuff_module *mod;
+	int cpu;
+
+	handle = (struct wbuff_handle *)hdl;
+
+	if (!wbuff.initialized || !wbuff_is_valid_handle(handle) ||
+	    pslot >= WBUFF_MAX_POOLS || !stats)
+		return QDF_STATUS_E_INVAL;
+
+	mod = &wbuff.mod[handle->id];
+
+	qdf_mem_zero(stats, sizeof(*stats));
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++) {
+		stats->hit += mod->pcpu[cpu].hit[pslot];
+		stats->miss += mod->pcpu[cpu].miss[pslot];
+	}
+
+	qdf_spin_lock_bh(&mod->lock);
+	stats->fallback = mod->fallback[pslot];
+	stats->replenished = mod->replenished[pslot];
+	stats->total = mod->total[pslot];
+	stats->free = mod->free[pslot];
+	qdf_spin_unlock_bh(&mod->lock);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+void wbuff_stats_print(struct wbuff_mod_handle *hdl)
+{
+	struct wbuff_handle *handle;
+	struct wbuff_pool_stats stats;
+	uint8_t pslot;
+
+	handle = (struct wbuff_handle *)hdl;
+
+	for (pslot = 0; pslot < WBUFF_MAX_POOLS; pslot++) {
+		if (wbuff_get_pool_stats(hdl, pslot, &stats) !=
+		    QDF_STATUS_SUCCESS)
+			return;
+		if (!stats.total && !stats.fallback)
+			continue;
+		qdf_info("mod %u pool %u: hit %u miss %u fallback %u replenished %u total %u free %u pending %d",
+			 handle->id, pslot, stats.hit, stats.miss,
+			 stats.fallback, stats.replenished, stats.total,
+			 stats.free,
+			 qdf_atomic_read(&wbuff.mod[handle->id].pending_returns));
+	}
+}
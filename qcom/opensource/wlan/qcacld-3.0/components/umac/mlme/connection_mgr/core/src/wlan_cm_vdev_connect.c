@@ -264,7 +264,8 @@ QDF_STATUS cm_get_rssi_snr_by_bssid(struct wlan_objmgr_pdev *pdev,
 	qdf_mem_copy(scan_filter->bssid_list[0].bytes,
 		     bssid, sizeof(struct qdf_mac_addr));
 	scan_filter->ignore_auth_enc_type = true;
-	list = wlan_scan_get_result(pdev, scan_filter);
+	/* only rssi and snr are read, no need to copy the entry */
+	list = wlan_scan_get_result_view(pdev, scan_filter);
 	qdf_mem_free(scan_filter);
 
 	if (!list || (list && !qdf_list_size(list))) {
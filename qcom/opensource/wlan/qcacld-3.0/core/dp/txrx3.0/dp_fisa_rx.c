@@ -24,7 +24,10 @@
 #include <linux/skbuff.h>
 #include "hif.h"
 
-static void dp_rx_fisa_flush_flow_wrap(struct dp_fisa_rx_sw_ft *sw_ft);
+static void dp_rx_fisa_flush_flow_wrap(struct dp_fisa_rx_sw_ft *sw_ft,
+				       enum dp_fisa_flush_reason reason);
+static void dp_rx_fisa_evict_ft_entry(struct dp_rx_fst *fisa_hdl,
+				      struct dp_fisa_rx_sw_ft *sw_ft_entry);
 
 /*
  * Used by FW to route RX packets to host REO2SW1 ring if IPA hit
@@ -268,11 +271,16 @@ dp_rx_fisa_setup_hw_fse(struct dp_rx_fst *fisa_hdl,
 			struct cdp_rx_flow_tuple_info *rx_flow_info,
 			uint32_t flow_steer_info)
 {
+	struct dp_fisa_rx_sw_ft *sw_ft_entry;
 	struct hal_rx_flow flow;
 	void *hw_fse;
 
+	sw_ft_entry = &(((struct dp_fisa_rx_sw_ft *)
+				fisa_hdl->base)[hashed_flow_idx]);
+	sw_ft_entry->metadata = ++fisa_hdl->meta_counter;
+
 	flow.reo_destination_indication = flow_steer_info;
-	flow.fse_metadata = 0xDEADBEEF;
+	flow.fse_metadata = sw_ft_entry->metadata;
 	flow.tuple_info.dest_ip_127_96 = rx_flow_info->dest_ip_127_96;
 	flow.tuple_info.dest_ip_95_64 = rx_flow_info->dest_ip_95_64;
 	flow.tuple_info.dest_ip_63_32 =	rx_flow_info->dest_ip_63_32;
@@ -486,6 +494,79 @@ static bool is_same_flow(struct cdp_rx_flow_tuple_info *tuple1,
 		return true;
 }
 
+/**
+ * dp_rx_fisa_populate_ft_entry() - Populate a free SW and HW FT entry
+ * @vdev: Handle DP vdev to save in SW flow table
+ * @fisa_hdl: handle to FISA context
+ * @sw_ft_entry: free SW FT entry to populate
+ * @nbuf: nbuf belonging to new flow
+ * @rx_flow_tuple_info: flow tuple of the new flow
+ * @proto_params: L4 protocol of the new flow
+ * @flow_hash: flow hash of the new flow
+ * @hashed_flow_idx: index of @sw_ft_entry in the flow table
+ * @reo_dest_indication: Reo destination indication for nbuf
+ *
+ * Return: None
+ */
+static void
+dp_rx_fisa_populate_ft_entry(struct dp_vdev *vdev,
+			     struct dp_rx_fst *fisa_hdl,
+			     struct dp_fisa_rx_sw_ft *sw_ft_entry,
+			     qdf_nbuf_t nbuf,
+			     struct cdp_rx_flow_tuple_info *rx_flow_tuple_info,
+			     struct hal_proto_params *proto_params,
+			     uint32_t flow_hash, uint32_t hashed_flow_idx,
+			     uint32_t reo_dest_indication)
+{
+	/* Add SW FT entry */
+	dp_rx_fisa_update_sw_ft_entry(sw_ft_entry, flow_hash, vdev,
+				      fisa_hdl->soc_hdl, hashed_flow_idx);
+
+	/* Add HW FT entry */
+	sw_ft_entry->hw_fse = dp_rx_fisa_setup_hw_fse(fisa_hdl,
+						      hashed_flow_idx,
+						      rx_flow_tuple_info,
+						      reo_dest_indication);
+	sw_ft_entry->is_populated = true;
+	sw_ft_entry->napi_id = QDF_NBUF_CB_RX_CTX_ID(nbuf);
+	sw_ft_entry->reo_dest_indication = reo_dest_indication;
+	sw_ft_entry->flow_id_toeplitz = QDF_NBUF_CB_RX_FLOW_ID(nbuf);
+	sw_ft_entry->flow_init_ts = qdf_get_log_timestamp();
+
+	qdf_mem_copy(&sw_ft_entry->rx_flow_tuple_info, rx_flow_tuple_info,
+		     sizeof(struct cdp_rx_flow_tuple_info));
+
+	sw_ft_entry->is_flow_tcp = proto_params->tcp_proto;
+	sw_ft_entry->is_flow_udp = proto_params->udp_proto;
+
+	fisa_hdl->add_flow_count++;
+}
+
+/**
+ * dp_rx_fisa_get_ft_entry_last_ts() - Get time a flow was last active
+ * @sw_ft_entry: SW FT entry of the flow
+ *
+ * Return: last aggregation time, or add time if never aggregated
+ */
+static inline qdf_time_t
+dp_rx_fisa_get_ft_entry_last_ts(struct dp_fisa_rx_sw_ft *sw_ft_entry)
+{
+	return qdf_max(sw_ft_entry->last_accessed_ts,
+		       sw_ft_entry->flow_init_ts);
+}
+
+/**
+ * dp_rx_fisa_is_flow_cold() - Check if a flow is idle enough to be evicted
+ * @last_ts: time the flow was last active
+ *
+ * Return: true if the flow can be evicted
+ */
+static inline bool dp_rx_fisa_is_flow_cold(qdf_time_t last_ts)
+{
+	return qdf_log_timestamp_to_usecs(qdf_get_log_timestamp() - last_ts) >=
+		FISA_FLOW_EVICT_IDLE_US;
+}
+
 /**
  * dp_rx_fisa_add_ft_entry() - Add new flow to HW and SW FT if it is not added
  * @vdev: Handle DP vdev to save in SW flow table
@@ -495,6 +576,10 @@ static bool is_same_flow(struct cdp_rx_flow_tuple_info *tuple1,
  * @flow_idx_hash: Hashed flow index
  * @reo_dest_indication: Reo destination indication for nbuf
  *
+ * When all the entries in the skid range are taken, the least recently
+ * active flow of the range is evicted if it has been idle long enough,
+ * rather than failing to add the new flow.
+ *
  * Return: pointer to sw FT entry on success, NULL otherwise
  */
 static struct dp_fisa_rx_sw_ft *
@@ -511,8 +596,10 @@ dp_rx_fisa_add_ft_entry(struct dp_vdev *vdev,
 	uint32_t skid_count = 0, max_skid_length;
 	struct cdp_rx_flow_tuple_info rx_flow_tuple_info;
 	bool is_fst_updated = false;
-	uint32_t reo_id = QDF_NBUF_CB_RX_CTX_ID(nbuf);
 	struct hal_proto_params proto_params;
+	qdf_time_t lru_ft_entry_time = 0, last_ts;
+	uint32_t lru_ft_entry_idx = 0;
+	uint8_t lru_reo_id;
 
 	if (hal_rx_get_proto_params(fisa_hdl->soc_hdl->hal_soc, rx_tlv_hdr,
 				    &proto_params))
@@ -536,47 +623,22 @@ dp_rx_fisa_add_ft_entry(struct dp_vdev *vdev,
 	do {
 		sw_ft_entry = &(((struct dp_fisa_rx_sw_ft *)
 					fisa_hdl->base)[hashed_flow_idx]);
-		if (!sw_ft_entry->is_populated) {
-			/* Add SW FT entry */
-			dp_rx_fisa_update_sw_ft_entry(sw_ft_entry,
-						      flow_hash, vdev,
-						      fisa_hdl->soc_hdl,
-						      hashed_flow_idx);
-			if (!rx_flow_tuple_info.tuple_populated)
-				get_flow_tuple_from_nbuf(fisa_hdl->soc_hdl,
-							 &rx_flow_tuple_info,
-							 nbuf, rx_tlv_hdr);
-
-			/* Add HW FT entry */
-			sw_ft_entry->hw_fse =
-				dp_rx_fisa_setup_hw_fse(fisa_hdl,
-							hashed_flow_idx,
-							&rx_flow_tuple_info,
-							reo_dest_indication);
-			sw_ft_entry->is_populated = true;
-			sw_ft_entry->napi_id = reo_id;
-			sw_ft_entry->reo_dest_indication = reo_dest_indication;
-			sw_ft_entry->flow_id_toeplitz =
-						QDF_NBUF_CB_RX_FLOW_ID(nbuf);
-			sw_ft_entry->flow_init_ts = qdf_get_log_timestamp();
-
-			qdf_mem_copy(&sw_ft_entry->rx_flow_tuple_info,
-				     &rx_flow_tuple_info,
-				     sizeof(struct cdp_rx_flow_tuple_info));
-
-			sw_ft_entry->is_flow_tcp = proto_params.tcp_proto;
-			sw_ft_entry->is_flow_udp = proto_params.udp_proto;
-
-			is_fst_updated = true;
-			fisa_hdl->add_flow_count++;
-			break;
-		}
-		/* else */
 		if (!rx_flow_tuple_info.tuple_populated)
 			get_flow_tuple_from_nbuf(fisa_hdl->soc_hdl,
 						 &rx_flow_tuple_info,
 						 nbuf, rx_tlv_hdr);
 
+		if (!sw_ft_entry->is_populated) {
+			dp_rx_fisa_populate_ft_entry(vdev, fisa_hdl,
+						     sw_ft_entry, nbuf,
+						     &rx_flow_tuple_info,
+						     &proto_params, flow_hash,
+						     hashed_flow_idx,
+						     reo_dest_indication);
+			is_fst_updated = true;
+			break;
+		}
+		/* else */
 		if (is_same_flow(&sw_ft_entry->rx_flow_tuple_info,
 				 &rx_flow_tuple_info)) {
 			sw_ft_entry->vdev = vdev;
@@ -593,30 +655,40 @@ dp_rx_fisa_add_ft_entry(struct dp_vdev *vdev,
 		/* hash collision move to the next FT entry */
 		dp_fisa_debug("Hash collision %d", fisa_hdl->hash_collision_cnt);
 		fisa_hdl->hash_collision_cnt++;
-#ifdef NOT_YET /* assist Flow eviction algorithm */
-	/* uint32_t lru_ft_entry_time = 0xffffffff, lru_ft_entry_idx = 0; */
-		if (fisa_hdl->hw_ft_entry->timestamp < lru_ft_entry_time) {
-			lru_ft_entry_time = fisa_hdl->hw_ft_entry->timestamp;
+
+		last_ts = dp_rx_fisa_get_ft_entry_last_ts(sw_ft_entry);
+		if (!skid_count || last_ts < lru_ft_entry_time) {
+			lru_ft_entry_time = last_ts;
 			lru_ft_entry_idx = hashed_flow_idx;
 		}
-#endif
 		skid_count++;
 		hashed_flow_idx++;
 		hashed_flow_idx &= fisa_hdl->hash_mask;
 	} while (skid_count <= max_skid_length);
 
-	/*
-	 * fisa_hdl->flow_eviction_cnt++;
-	 * if (skid_count > max_skid_length)
-	 * Remove LRU flow from HW FT
-	 * Remove LRU flow from SW FT
-	 */
-	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
-
 	if (skid_count > max_skid_length) {
-		dp_fisa_debug("Max skid length reached flow cannot be added, evict exiting flow");
-		return NULL;
+		if (!dp_rx_fisa_is_flow_cold(lru_ft_entry_time)) {
+			qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
+			DP_STATS_INC(fisa_hdl, lru_evict_skipped, 1);
+			dp_fisa_debug("Max skid length reached, no cold flow to evict");
+			return NULL;
+		}
+
+		/* Remove LRU flow from SW and HW FT, add the new flow */
+		sw_ft_entry = &(((struct dp_fisa_rx_sw_ft *)
+					fisa_hdl->base)[lru_ft_entry_idx]);
+		lru_reo_id = sw_ft_entry->napi_id;
+		dp_rx_fisa_acquire_ft_lock(fisa_hdl, lru_reo_id);
+		dp_rx_fisa_evict_ft_entry(fisa_hdl, sw_ft_entry);
+		dp_rx_fisa_populate_ft_entry(vdev, fisa_hdl, sw_ft_entry, nbuf,
+					     &rx_flow_tuple_info,
+					     &proto_params, flow_hash,
+					     lru_ft_entry_idx,
+					     reo_dest_indication);
+		dp_rx_fisa_release_ft_lock(fisa_hdl, lru_reo_id);
+		is_fst_updated = true;
 	}
+	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
 
 	/**
 	 * Send HTT cache invalidation command to firmware to
@@ -695,11 +767,15 @@ dp_rx_fisa_restore_pkt_hist(struct dp_fisa_rx_sw_ft *ft_entry,
 #endif
 
 /**
- * dp_fisa_rx_delete_flow() - Delete a flow from SW and HW FST, currently
- * only applicable when FST is in CMEM
+ * dp_fisa_rx_delete_flow() - Replace the LRU flow in SW and HW FST with a new
+ * flow, currently only applicable when FST is in CMEM
  * @fisa_hdl: handle to FISA context
  * @elem: details of the flow which is being added
- * @hashed_flow_idx: hashed flow idx of the deleting flow
+ * @hashed_flow_idx: hashed flow idx of the flow being replaced
+ *
+ * The flow at @hashed_flow_idx is flushed with DP_FISA_FLUSH_EVICT as flush
+ * reason, its SW FT entry is cleared (keeping the packet history) and the
+ * slot is reprogrammed in SW and CMEM FST with the flow in @elem.
  *
  * Return: None
  */
@@ -719,7 +795,7 @@ dp_fisa_rx_delete_flow(struct dp_rx_fst *fisa_hdl,
 	dp_rx_fisa_acquire_ft_lock(fisa_hdl, reo_id);
 
 	/* Flush the flow before deletion */
-	dp_rx_fisa_flush_flow_wrap(sw_ft_entry);
+	dp_rx_fisa_flush_flow_wrap(sw_ft_entry, DP_FISA_FLUSH_EVICT);
 
 	dp_rx_fisa_save_pkt_hist(sw_ft_entry, &pkt_hist);
 	/* Clear the sw_ft_entry */
@@ -750,6 +826,38 @@ dp_fisa_rx_delete_flow(struct dp_rx_fst *fisa_hdl,
 	dp_rx_fisa_release_ft_lock(fisa_hdl, reo_id);
 }
 
+/**
+ * dp_rx_fisa_evict_ft_entry() - Evict a flow from the DDR SW and HW FT
+ * @fisa_hdl: handle to FISA context
+ * @sw_ft_entry: SW FT entry of the flow to be evicted
+ *
+ * Caller must hold dp_rx_fst_lock and the FT lock of the flow REO. Packets
+ * of the evicted flow still in flight are rejected by the FSE metadata
+ * check in dp_fisa_rx_get_sw_ft_entry().
+ *
+ * Return: None
+ */
+static void dp_rx_fisa_evict_ft_entry(struct dp_rx_fst *fisa_hdl,
+				      struct dp_fisa_rx_sw_ft *sw_ft_entry)
+{
+	struct fisa_pkt_hist pkt_hist;
+
+	/* Flush the flow before eviction */
+	dp_rx_fisa_flush_flow_wrap(sw_ft_entry, DP_FISA_FLUSH_EVICT);
+
+	if (sw_ft_entry->hw_fse)
+		hal_rx_flow_delete_entry(fisa_hdl->hal_rx_fst,
+					 sw_ft_entry->hw_fse);
+
+	dp_rx_fisa_save_pkt_hist(sw_ft_entry, &pkt_hist);
+	/* Clear the sw_ft_entry */
+	memset(sw_ft_entry, 0, sizeof(*sw_ft_entry));
+	dp_rx_fisa_restore_pkt_hist(sw_ft_entry, &pkt_hist);
+
+	fisa_hdl->del_flow_count++;
+	DP_STATS_INC(fisa_hdl, lru_evict, 1);
+}
+
 /**
  * dp_fisa_rx_get_hw_ft_timestamp() - Get timestamp maintained in the HW FSE
  * @fisa_hdl: handle to FISA context
@@ -1309,7 +1417,7 @@ dp_rx_fisa_aggr_udp(struct dp_rx_fst *fisa_hdl,
 		fisa_flow->adjusted_cumulative_ip_length -=
 			(udp_len - sizeof(struct udphdr));
 		fisa_flow->cur_aggr--;
-		dp_rx_fisa_flush_flow_wrap(fisa_flow);
+		dp_rx_fisa_flush_flow_wrap(fisa_flow, DP_FISA_FLUSH_GSO_SIZE);
 		/* napi_flush_cumulative_ip_length  not include current msdu */
 		fisa_flow->napi_flush_cumulative_ip_length -= udp_len;
 		head_skb = NULL;
@@ -1372,7 +1480,7 @@ dp_rx_fisa_aggr_udp(struct dp_rx_fst *fisa_hdl,
 	 * then flush the aggregate
 	 */
 	if (udp_len < qdf_ntohs(fisa_flow->head_skb_udp_hdr->len))
-		dp_rx_fisa_flush_flow_wrap(fisa_flow);
+		dp_rx_fisa_flush_flow_wrap(fisa_flow, DP_FISA_FLUSH_GSO_SIZE);
 
 	return FISA_AGGR_DONE;
 }
@@ -1614,14 +1722,19 @@ dp_rx_fisa_flush_tcp_flow(struct dp_vdev *vdev,
  * dp_rx_fisa_flush_flow() - Flush all aggregated nbuf of the flow
  * @vdev: handle to dp_vdev
  * @fisa_flow: Flow for which aggregates to be flushed
+ * @reason: reason for the flush, accounted per flow
  *
  * Return: None
  */
 static void dp_rx_fisa_flush_flow(struct dp_vdev *vdev,
-				  struct dp_fisa_rx_sw_ft *flow)
+				  struct dp_fisa_rx_sw_ft *flow,
+				  enum dp_fisa_flush_reason reason)
 {
 	dp_fisa_debug("dp_rx_fisa_flush_flow");
 
+	if (flow->head_skb)
+		flow->flush_reason[reason]++;
+
 	if (flow->is_flow_udp)
 		dp_rx_fisa_flush_udp_flow(vdev, flow);
 	else
@@ -1674,6 +1787,74 @@ static bool dp_fisa_aggregation_should_stop(
 	return false;
 }
 
+/**
+ * dp_rx_fisa_update_flow_rate() - Measure the flow rate and adapt the
+ *				   aggregation limit of the flow
+ * @fisa_flow: Handle SW flow entry
+ * @rx_tlv_hdr: RX TLV header of the incoming nbuf
+ *
+ * Bytes are accumulated over a FISA_FLOW_RATE_WINDOW_US window. Low rate
+ * flows are delivered without aggregation to keep latency low, while high
+ * rate flows use the full HW aggregation size. Caller holds the FT lock.
+ *
+ * Return: None
+ */
+static void dp_rx_fisa_update_flow_rate(struct dp_fisa_rx_sw_ft *fisa_flow,
+					uint8_t *rx_tlv_hdr)
+{
+	qdf_time_t now = qdf_get_log_timestamp();
+	uint64_t elapsed_us;
+	uint64_t bits;
+
+	fisa_flow->rate_win_bytes +=
+		hal_rx_msdu_start_msdu_len_get(fisa_flow->soc_hdl->hal_soc,
+					       rx_tlv_hdr);
+
+	if (!fisa_flow->rate_win_start_ts) {
+		fisa_flow->rate_win_start_ts = now;
+		return;
+	}
+
+	elapsed_us = qdf_log_timestamp_to_usecs(now -
+						fisa_flow->rate_win_start_ts);
+	if (elapsed_us < FISA_FLOW_RATE_WINDOW_US)
+		return;
+
+	/* bits per usec is Mbps */
+	bits = (uint64_t)fisa_flow->rate_win_bytes * 8;
+	qdf_do_div(bits, elapsed_us);
+	fisa_flow->rate_mbps = bits;
+
+	if (fisa_flow->rate_mbps < FISA_FLOW_LOW_RATE_MBPS) {
+		fisa_flow->rate_class = DP_FISA_RATE_CLASS_LOW;
+		fisa_flow->aggr_limit = FISA_FLOW_LOW_RATE_AGGR_COUNT;
+	} else if (fisa_flow->rate_mbps < FISA_FLOW_HIGH_RATE_MBPS) {
+		fisa_flow->rate_class = DP_FISA_RATE_CLASS_MEDIUM;
+		fisa_flow->aggr_limit = FISA_FLOW_MED_RATE_AGGR_COUNT;
+	} else {
+		fisa_flow->rate_class = DP_FISA_RATE_CLASS_HIGH;
+		fisa_flow->aggr_limit = FISA_FLOW_MAX_AGGR_COUNT;
+	}
+
+	fisa_flow->rate_win_start_ts = now;
+	fisa_flow->rate_win_bytes = 0;
+}
+
+/**
+ * dp_rx_fisa_get_aggr_limit() - Get the current aggregation limit of a flow
+ * @fisa_flow: Handle SW flow entry
+ *
+ * Return: max number of msdus to be aggregated before flushing
+ */
+static inline uint16_t
+dp_rx_fisa_get_aggr_limit(struct dp_fisa_rx_sw_ft *fisa_flow)
+{
+	if (!fisa_flow->aggr_limit)
+		return FISA_FLOW_MAX_AGGR_COUNT;
+
+	return fisa_flow->aggr_limit;
+}
+
 /**
  * dp_add_nbuf_to_fisa_flow() - Aggregate incoming nbuf
  * @fisa_hdl: handle to fisa context
@@ -1723,6 +1904,8 @@ static int dp_add_nbuf_to_fisa_flow(struct dp_rx_fst *fisa_hdl,
 		return FISA_AGGR_NOT_ELIGIBLE;
 	}
 
+	dp_rx_fisa_update_flow_rate(fisa_flow, rx_tlv_hdr);
+
 	hal_cumulative_ip_len = hal_rx_get_fisa_cumulative_ip_length(
 								hal_soc_hdl,
 								rx_tlv_hdr);
@@ -1737,7 +1920,7 @@ static int dp_add_nbuf_to_fisa_flow(struct dp_rx_fst *fisa_hdl,
 		 */
 		dp_fisa_debug("no fgc nbuf %pK, flush %pK napi %d", nbuf,
 			      fisa_flow, QDF_NBUF_CB_RX_CTX_ID(nbuf));
-		dp_rx_fisa_flush_flow(vdev, fisa_flow);
+		dp_rx_fisa_flush_flow(vdev, fisa_flow, DP_FISA_FLUSH_NEW_AGGR);
 		/* Clear of previoud context values */
 		fisa_flow->napi_flush_cumulative_l4_checksum = 0;
 		fisa_flow->napi_flush_cumulative_ip_length = 0;
@@ -1769,7 +1952,8 @@ static int dp_add_nbuf_to_fisa_flow(struct dp_rx_fst *fisa_hdl,
 		 * Flush the flow and do not aggregate until next start new
 		 * aggreagtion
 		 */
-		dp_rx_fisa_flush_flow(vdev, fisa_flow);
+		dp_rx_fisa_flush_flow(vdev, fisa_flow,
+				      DP_FISA_FLUSH_HW_INVALID);
 		fisa_flow->do_not_aggregate = true;
 		fisa_flow->cur_aggr = 0;
 		fisa_flow->napi_flush_cumulative_ip_length = 0;
@@ -1836,6 +2020,12 @@ static int dp_add_nbuf_to_fisa_flow(struct dp_rx_fst *fisa_hdl,
 		dp_rx_fisa_aggr_tcp(fisa_hdl, fisa_flow, nbuf);
 	}
 
+	/* cur_aggr does not include the head_skb */
+	if (fisa_flow->head_skb &&
+	    fisa_flow->cur_aggr + 1 >= dp_rx_fisa_get_aggr_limit(fisa_flow))
+		dp_rx_fisa_flush_flow_wrap(fisa_flow,
+					   DP_FISA_FLUSH_AGGR_LIMIT);
+
 	dp_rx_fisa_release_ft_lock(fisa_hdl, napi_id);
 	fisa_flow->last_accessed_ts = qdf_get_log_timestamp();
 
@@ -1892,7 +2082,8 @@ QDF_STATUS dp_rx_fisa_flush_by_vdev_ctx_id(struct dp_soc *soc,
 		    sw_ft_entry[i].napi_id == rx_ctx_id) {
 			dp_fisa_debug("flushing %d %pk vdev %pK napi id:%d", i,
 				      &sw_ft_entry[i], vdev, rx_ctx_id);
-			dp_rx_fisa_flush_flow_wrap(&sw_ft_entry[i]);
+			dp_rx_fisa_flush_flow_wrap(&sw_ft_entry[i],
+						   DP_FISA_FLUSH_VDEV);
 		}
 	}
 	dp_rx_fisa_release_ft_lock(fisa_hdl, rx_ctx_id);
@@ -2000,7 +2191,8 @@ QDF_STATUS dp_fisa_rx(struct dp_soc *soc, struct dp_vdev *vdev,
 			if (fisa_flow) {
 				dp_rx_fisa_acquire_ft_lock(dp_fisa_rx_hdl,
 							   fisa_flow->napi_id);
-				dp_rx_fisa_flush_flow(vdev, fisa_flow);
+				dp_rx_fisa_flush_flow(vdev, fisa_flow,
+						      DP_FISA_FLUSH_FRAG);
 				dp_rx_fisa_release_ft_lock(dp_fisa_rx_hdl,
 							   fisa_flow->napi_id);
 			}
@@ -2048,6 +2240,9 @@ QDF_STATUS dp_rx_dump_fisa_stats(struct dp_soc *soc)
 		rx_fst->add_flow_count,
 		rx_fst->del_flow_count,
 		rx_fst->hash_collision_cnt);
+	dp_info("#lru evicted %u lru evict skipped %u",
+		rx_fst->stats.lru_evict,
+		rx_fst->stats.lru_evict_skipped);
 
 	for (i = 0; i < ft_size; i++, sw_ft_entry++) {
 		if (!sw_ft_entry->is_populated)
@@ -2067,6 +2262,23 @@ QDF_STATUS dp_rx_dump_fisa_stats(struct dp_soc *soc)
 			sw_ft_entry->bytes_aggregated,
 			qdf_do_div(sw_ft_entry->bytes_aggregated,
 				   sw_ft_entry->flush_count));
+		dp_info("Flow[%d] aggr-ratio %u rate %u Mbps class %d aggr-limit %u",
+			sw_ft_entry->flow_id,
+			sw_ft_entry->flush_count ?
+			sw_ft_entry->aggr_count / sw_ft_entry->flush_count : 0,
+			sw_ft_entry->rate_mbps,
+			sw_ft_entry->rate_class,
+			dp_rx_fisa_get_aggr_limit(sw_ft_entry));
+		dp_info("Flow[%d] flush new-aggr %u hw-invalid %u aggr-limit %u gso-size %u napi %u vdev %u frag %u evict %u",
+			sw_ft_entry->flow_id,
+			sw_ft_entry->flush_reason[DP_FISA_FLUSH_NEW_AGGR],
+			sw_ft_entry->flush_reason[DP_FISA_FLUSH_HW_INVALID],
+			sw_ft_entry->flush_reason[DP_FISA_FLUSH_AGGR_LIMIT],
+			sw_ft_entry->flush_reason[DP_FISA_FLUSH_GSO_SIZE],
+			sw_ft_entry->flush_reason[DP_FISA_FLUSH_NAPI],
+			sw_ft_entry->flush_reason[DP_FISA_FLUSH_VDEV],
+			sw_ft_entry->flush_reason[DP_FISA_FLUSH_FRAG],
+			sw_ft_entry->flush_reason[DP_FISA_FLUSH_EVICT]);
 	}
 	return QDF_STATUS_SUCCESS;
 }
@@ -2075,10 +2287,12 @@ QDF_STATUS dp_rx_dump_fisa_stats(struct dp_soc *soc)
  * dp_rx_fisa_flush_flow_wrap() - flush fisa flow by invoking
  *				  dp_rx_fisa_flush_flow()
  * @sw_ft: fisa flow for which aggregates to be flushed
+ * @reason: reason for the flush
  *
  * Return: None.
  */
-static void dp_rx_fisa_flush_flow_wrap(struct dp_fisa_rx_sw_ft *sw_ft)
+static void dp_rx_fisa_flush_flow_wrap(struct dp_fisa_rx_sw_ft *sw_ft,
+				       enum dp_fisa_flush_reason reason)
 {
 	/* Save the ip_len and checksum as hardware assist is
 	 * always based on his start of aggregation
@@ -2090,8 +2304,7 @@ static void dp_rx_fisa_flush_flow_wrap(struct dp_fisa_rx_sw_ft *sw_ft)
 	dp_fisa_debug("napi_flush_cumulative_ip_length 0x%x",
 		      sw_ft->napi_flush_cumulative_ip_length);
 
-	dp_rx_fisa_flush_flow(sw_ft->vdev,
-			      sw_ft);
+	dp_rx_fisa_flush_flow(sw_ft->vdev, sw_ft, reason);
 	sw_ft->cur_aggr = 0;
 }
 
@@ -2109,7 +2322,8 @@ QDF_STATUS dp_rx_fisa_flush_by_ctx_id(struct dp_soc *soc, int napi_id)
 		    sw_ft_entry[i].is_populated) {
 			dp_fisa_debug("flushing %d %pK napi_id %d", i,
 				      &sw_ft_entry[i], napi_id);
-			dp_rx_fisa_flush_flow_wrap(&sw_ft_entry[i]);
+			dp_rx_fisa_flush_flow_wrap(&sw_ft_entry[i],
+						   DP_FISA_FLUSH_NAPI);
 		}
 	}
 	dp_rx_fisa_release_ft_lock(fisa_hdl, napi_id);
@@ -2142,7 +2356,8 @@ QDF_STATUS dp_rx_fisa_flush_by_vdev_id(struct dp_soc *soc, uint8_t vdev_id)
 			dp_fisa_debug("flushing %d %pk vdev %pK", i,
 				      &sw_ft_entry[i], vdev);
 
-			dp_rx_fisa_flush_flow_wrap(&sw_ft_entry[i]);
+			dp_rx_fisa_flush_flow_wrap(&sw_ft_entry[i],
+						   DP_FISA_FLUSH_VDEV);
 		}
 		dp_rx_fisa_release_ft_lock(fisa_hdl, reo_id);
 	}
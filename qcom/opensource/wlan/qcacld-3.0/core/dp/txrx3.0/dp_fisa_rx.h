@@ -37,6 +37,18 @@
 #define FISA_FLOW_MAX_CUMULATIVE_IP_LEN \
 	(FISA_MAX_SINGLE_CUMULATIVE_IP_LEN * FISA_FLOW_MAX_AGGR_COUNT)
 
+/* window over which the rate of a flow is measured */
+#define FISA_FLOW_RATE_WINDOW_US	100000
+/* flows below this rate are treated as latency sensitive */
+#define FISA_FLOW_LOW_RATE_MBPS		20
+/* flows at or above this rate are treated as bulk */
+#define FISA_FLOW_HIGH_RATE_MBPS	400
+/* max msdus per aggregate for each rate class */
+#define FISA_FLOW_LOW_RATE_AGGR_COUNT	1
+#define FISA_FLOW_MED_RATE_AGGR_COUNT	(FISA_FLOW_MAX_AGGR_COUNT / 2)
+/* flow idle time after which it may be evicted from FST for a new flow */
+#define FISA_FLOW_EVICT_IDLE_US		500000
+
 #define IPSEC_PORT 500
 #define IPSEC_NAT_PORT 4500
 
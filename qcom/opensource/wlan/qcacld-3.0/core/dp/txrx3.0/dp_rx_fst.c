@@ -148,7 +148,6 @@ static void dp_rx_fst_cmem_deinit(struct dp_rx_fst *fst)
 {
 	struct dp_fisa_rx_fst_update_elem *elem;
 	qdf_list_node_t *node;
-	int i;
 
 	qdf_cancel_work(&fst->fst_update_work);
 	qdf_flush_work(&fst->fst_update_work);
@@ -166,9 +165,6 @@ static void dp_rx_fst_cmem_deinit(struct dp_rx_fst *fst)
 
 	qdf_list_destroy(&fst->fst_update_list);
 	qdf_event_destroy(&fst->cmem_resp_event);
-
-	for (i = 0; i < MAX_REO_DEST_RINGS; i++)
-		qdf_spinlock_destroy(&fst->dp_rx_sw_ft_lock[i]);
 }
 
 /**
@@ -179,8 +175,6 @@ static void dp_rx_fst_cmem_deinit(struct dp_rx_fst *fst)
  */
 static QDF_STATUS dp_rx_fst_cmem_init(struct dp_rx_fst *fst)
 {
-	int i;
-
 	fst->fst_update_wq =
 		qdf_alloc_high_prior_ordered_workqueue("dp_rx_fst_update_wq");
 	if (!fst->fst_update_wq) {
@@ -193,9 +187,6 @@ static QDF_STATUS dp_rx_fst_cmem_init(struct dp_rx_fst *fst)
 	qdf_list_create(&fst->fst_update_list, 128);
 	qdf_event_create(&fst->cmem_resp_event);
 
-	for (i = 0; i < MAX_REO_DEST_RINGS; i++)
-		qdf_spinlock_create(&fst->dp_rx_sw_ft_lock[i]);
-
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -328,6 +319,8 @@ QDF_STATUS dp_rx_fst_attach(struct dp_soc *soc, struct dp_pdev *pdev)
 	}
 
 	qdf_spinlock_create(&fst->dp_rx_fst_lock);
+	for (i = 0; i < MAX_REO_DEST_RINGS; i++)
+		qdf_spinlock_create(&fst->dp_rx_sw_ft_lock[i]);
 
 	status = qdf_timer_init(soc->osdev, &fst->fse_cache_flush_timer,
 				dp_fisa_fse_cache_flush_timer, (void *)soc,
@@ -341,6 +334,10 @@ QDF_STATUS dp_rx_fst_attach(struct dp_soc *soc, struct dp_pdev *pdev)
 	qdf_atomic_init(&fst->fse_cache_flush_posted);
 
 	fst->fse_cache_flush_allow = true;
+	/* Cold flows are evicted from the DDR FST as well, the per REO FT
+	 * locks and the FSE metadata check guard the evicted entries.
+	 */
+	fst->flow_deletion_supported = true;
 	fst->soc_hdl = soc;
 	soc->rx_fst = fst;
 	soc->fisa_enable = true;
@@ -353,6 +350,8 @@ QDF_STATUS dp_rx_fst_attach(struct dp_soc *soc, struct dp_pdev *pdev)
 	return QDF_STATUS_SUCCESS;
 
 timer_init_fail:
+	for (i = 0; i < MAX_REO_DEST_RINGS; i++)
+		qdf_spinlock_destroy(&fst->dp_rx_sw_ft_lock[i]);
 	qdf_spinlock_destroy(&fst->dp_rx_fst_lock);
 	hal_rx_fst_detach(fst->hal_rx_fst, soc->osdev);
 free_hist:
@@ -387,7 +386,6 @@ static void dp_rx_fst_check_cmem_support(struct dp_soc *soc)
 	hal_rx_fst_detach(fst->hal_rx_fst, soc->osdev);
 	fst->hal_rx_fst = NULL;
 	fst->hal_rx_fst_base_paddr = 0;
-	fst->flow_deletion_supported = true;
 	fst->fst_in_cmem = true;
 }
 
@@ -444,6 +442,7 @@ QDF_STATUS dp_rx_flow_send_fst_fw_setup(struct dp_soc *soc,
 void dp_rx_fst_detach(struct dp_soc *soc, struct dp_pdev *pdev)
 {
 	struct dp_rx_fst *dp_fst;
+	int i;
 
 	dp_fst = soc->rx_fst;
 	if (qdf_likely(dp_fst)) {
@@ -456,6 +455,8 @@ void dp_rx_fst_detach(struct dp_soc *soc, struct dp_pdev *pdev)
 		dp_rx_sw_ft_hist_deinit((struct dp_fisa_rx_sw_ft *)dp_fst->base,
 					dp_fst->max_entries);
 		dp_context_free_mem(soc, DP_FISA_RX_FT_TYPE, dp_fst->base);
+		for (i = 0; i < MAX_REO_DEST_RINGS; i++)
+			qdf_spinlock_destroy(&dp_fst->dp_rx_sw_ft_lock[i]);
 		qdf_spinlock_destroy(&dp_fst->dp_rx_fst_lock);
 		qdf_mem_free(dp_fst);
 	}
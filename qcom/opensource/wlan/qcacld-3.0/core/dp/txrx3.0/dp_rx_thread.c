@@ -167,6 +167,43 @@ static void dp_rx_tm_thread_dump_stats(struct dp_rx_thread *rx_thread)
 		rx_thread->stats.dropped_enq_fail);
 }
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEALING
+/**
+ * dp_rx_tm_thread_dump_steal_stats() - display work stealing stats and
+ *					utilisation of a rx_thread
+ * @rx_thread - rx_thread pointer for which the stats need to be
+ *            displayed
+ *
+ * Returns: None
+ */
+static void dp_rx_tm_thread_dump_steal_stats(struct dp_rx_thread *rx_thread)
+{
+	uint64_t elapsed_us;
+	uint64_t util = 0;
+
+	elapsed_us = qdf_log_timestamp_to_usecs(qdf_get_log_timestamp() -
+						rx_thread->start_ts);
+	if (elapsed_us) {
+		util = rx_thread->stats.busy_time_us * 100;
+		qdf_do_div(util, elapsed_us);
+	}
+
+	dp_info("thread:%u - steals:%u stolen:%u given:%u forwarded:%u busy:%llu us util:%llu%%",
+		rx_thread->id,
+		rx_thread->stats.steals,
+		rx_thread->stats.nbuf_stolen,
+		rx_thread->stats.nbuf_given,
+		rx_thread->stats.nbuf_forwarded,
+		rx_thread->stats.busy_time_us,
+		util);
+}
+#else
+static inline void
+dp_rx_tm_thread_dump_steal_stats(struct dp_rx_thread *rx_thread)
+{
+}
+#endif
+
 QDF_STATUS dp_rx_tm_dump_stats(struct dp_rx_tm_handle *rx_tm_hdl)
 {
 	int i;
@@ -175,6 +212,7 @@ QDF_STATUS dp_rx_tm_dump_stats(struct dp_rx_tm_handle *rx_tm_hdl)
 		if (!rx_tm_hdl->rx_thread[i])
 			continue;
 		dp_rx_tm_thread_dump_stats(rx_tm_hdl->rx_thread[i]);
+		dp_rx_tm_thread_dump_steal_stats(rx_tm_hdl->rx_thread[i]);
 	}
 	return QDF_STATUS_SUCCESS;
 }
@@ -256,6 +294,120 @@ QDF_STATUS dp_check_and_update_pending(struct dp_rx_tm_handle_cmn
 }
 #endif
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEALING
+/**
+ * dp_rx_tm_flow_bucket() - get flow bucket of a nbuf
+ * @nbuf - nbuf for which the flow bucket is needed
+ *
+ * Returns: flow bucket derived from the flow hash of the nbuf
+ */
+static inline uint8_t dp_rx_tm_flow_bucket(qdf_nbuf_t nbuf)
+{
+	return QDF_NBUF_CB_RX_FLOW_ID(nbuf) & (DP_RX_TM_FLOW_BUCKETS - 1);
+}
+
+/**
+ * dp_rx_tm_nbuf_list_len() - number of packets in a queued nbuf_list
+ * @nbuf_list - nbuf_list as stored in the thread queue
+ *
+ * Returns: number of packets, aggregated frames counted per segment
+ */
+static inline uint32_t dp_rx_tm_nbuf_list_len(qdf_nbuf_t nbuf_list)
+{
+	return QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list) +
+	       qdf_nbuf_get_gso_segs(nbuf_list);
+}
+
+/**
+ * dp_rx_tm_pending_add() - account a nbuf_list queued into nbuf_queue
+ * @rx_thread - rx_thread owning the nbuf_queue
+ * @nbuf_list - nbuf_list as stored in the thread queue
+ *
+ * Returns: None
+ */
+static inline void dp_rx_tm_pending_add(struct dp_rx_thread *rx_thread,
+					qdf_nbuf_t nbuf_list)
+{
+	qdf_atomic_add(dp_rx_tm_nbuf_list_len(nbuf_list),
+		       &rx_thread->nbuf_pending);
+}
+
+/**
+ * dp_rx_tm_pending_sub() - account a nbuf_list removed from nbuf_queue
+ * @rx_thread - rx_thread owning the nbuf_queue
+ * @nbuf_list - nbuf_list as stored in the thread queue
+ *
+ * Returns: None
+ */
+static inline void dp_rx_tm_pending_sub(struct dp_rx_thread *rx_thread,
+					qdf_nbuf_t nbuf_list)
+{
+	qdf_atomic_sub(dp_rx_tm_nbuf_list_len(nbuf_list),
+		       &rx_thread->nbuf_pending);
+}
+
+/**
+ * dp_rx_tm_pending() - packets queued in the nbuf_queue of a rx_thread
+ * @rx_thread - rx_thread to be checked
+ *
+ * Unlike the queue length this does not depend on how many flow bucket
+ * runs the packets were split into at enqueue.
+ *
+ * Returns: number of packets
+ */
+static inline uint32_t dp_rx_tm_pending(struct dp_rx_thread *rx_thread)
+{
+	return qdf_atomic_read(&rx_thread->nbuf_pending);
+}
+
+/**
+ * dp_rx_tm_wake_idle_thread() - wake up an idle rx_thread to steal work
+ * @rx_thread - rx_thread whose queue is building up
+ *
+ * Returns: None
+ */
+static void dp_rx_tm_wake_idle_thread(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread *idle_thread;
+	int i;
+
+	if (dp_rx_tm_pending(rx_thread) < DP_RX_TM_STEAL_PENDING_THRESH)
+		return;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		idle_thread = rx_tm_hdl->rx_thread[i];
+		if (!idle_thread || idle_thread == rx_thread)
+			continue;
+
+		if (qdf_nbuf_queue_head_qlen(&idle_thread->nbuf_queue) ||
+		    idle_thread->steal_bucket != DP_RX_TM_INVALID_BUCKET ||
+		    qdf_atomic_test_bit(RX_POST_EVENT,
+					&idle_thread->event_flag))
+			continue;
+
+		qdf_set_bit(RX_POST_EVENT, &idle_thread->event_flag);
+		qdf_wake_up_interruptible(&idle_thread->wait_q);
+		return;
+	}
+}
+#else
+static inline void dp_rx_tm_pending_add(struct dp_rx_thread *rx_thread,
+					qdf_nbuf_t nbuf_list)
+{
+}
+
+static inline void dp_rx_tm_pending_sub(struct dp_rx_thread *rx_thread,
+					qdf_nbuf_t nbuf_list)
+{
+}
+
+static inline void dp_rx_tm_wake_idle_thread(struct dp_rx_thread *rx_thread)
+{
+}
+#endif
+
 /**
  * dp_rx_tm_thread_enqueue() - enqueue nbuf list into rx_thread
  * @rx_thread - rx_thread in which the nbuf needs to be queued
@@ -322,6 +474,7 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 		qdf_nbuf_set_next(head_ptr, NULL);
 		/* count aggregated RX frame into enqueued stats */
 		nbuf_queued += qdf_nbuf_get_gso_segs(head_ptr);
+		dp_rx_tm_pending_add(rx_thread, head_ptr);
 		qdf_nbuf_queue_head_enqueue_tail(&rx_thread->nbuf_queue,
 						 head_ptr);
 		head_ptr = next_ptr_list;
@@ -343,6 +496,7 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 	}
 	qdf_nbuf_set_next(head_ptr, NULL);
 
+	dp_rx_tm_pending_add(rx_thread, head_ptr);
 	qdf_nbuf_queue_head_enqueue_tail(&rx_thread->nbuf_queue, head_ptr);
 
 enq_done:
@@ -363,6 +517,8 @@ enq_done:
 	qdf_set_bit(RX_POST_EVENT, &rx_thread->event_flag);
 	qdf_wake_up_interruptible(wait_q_ptr);
 
+	dp_rx_tm_wake_idle_thread(rx_thread);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -413,6 +569,570 @@ static void dp_rx_thread_adjust_nbuf_list(qdf_nbuf_t head)
 	}
 }
 
+/**
+ * dp_rx_thread_deliver_nbuf_list() - deliver a nbuf_list to the stack
+ * @rx_thread - rx_thread delivering the nbuf_list
+ * @soc - ol_txrx_soc_handle object
+ * @nbuf_list - nbuf_list to be delivered
+ *
+ * Returns: number of packets in the nbuf_list
+ */
+static uint32_t dp_rx_thread_deliver_nbuf_list(struct dp_rx_thread *rx_thread,
+					       ol_txrx_soc_handle soc,
+					       qdf_nbuf_t nbuf_list)
+{
+	uint8_t vdev_id;
+	ol_txrx_rx_fp stack_fn;
+	ol_osif_vdev_handle osif_vdev;
+	uint32_t num_list_elements;
+
+	num_list_elements = QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
+	/* count aggregated RX frame into stats */
+	num_list_elements += qdf_nbuf_get_gso_segs(nbuf_list);
+	rx_thread->stats.nbuf_dequeued += num_list_elements;
+
+	vdev_id = QDF_NBUF_CB_RX_VDEV_ID(nbuf_list);
+	cdp_get_os_rx_handles_from_vdev(soc, vdev_id, &stack_fn,
+					&osif_vdev);
+	dp_debug("rx_thread %pK sending packet %pK to stack",
+		 rx_thread, nbuf_list);
+	if (!stack_fn || !osif_vdev ||
+	    QDF_STATUS_SUCCESS != stack_fn(osif_vdev, nbuf_list)) {
+		rx_thread->stats.dropped_invalid_os_rx_handles +=
+						num_list_elements;
+		qdf_nbuf_list_free(nbuf_list);
+	} else {
+		rx_thread->stats.nbuf_sent_to_stack +=
+						num_list_elements;
+	}
+
+	return num_list_elements;
+}
+
+#ifdef WLAN_DP_RX_THREAD_WORK_STEALING
+/*
+ * Work stealing: an idle rx_thread steals all the nbuf_lists of one flow
+ * bucket from the queue of the busiest thread and delivers them through
+ * its own NAPI. Packets of a flow stay in order as:
+ * - a bucket being delivered by the victim is never stolen,
+ * - the victim flushes its GRO before the thief delivers stolen lists,
+ * - lists of a stolen bucket dequeued later by the victim are forwarded
+ *   to the thief until the thief has flushed its GRO and released it.
+ */
+static void dp_rx_thread_gro_flush(struct dp_rx_thread *rx_thread,
+				   enum dp_rx_gro_flush_code gro_flush_code);
+
+/**
+ * dp_rx_tm_thread_enqueue_flows() - enqueue nbuf list into rx_thread
+ *				     split into per flow bucket lists
+ * @rx_thread - rx_thread in which the nbuf needs to be queued
+ * @nbuf_list - list of packets to be queued into the thread
+ *
+ * Each queued nbuf_list holds packets of a single flow bucket so that
+ * it can be stolen without reordering other flows.
+ *
+ * Returns: None
+ */
+static void dp_rx_tm_thread_enqueue_flows(struct dp_rx_thread *rx_thread,
+					  qdf_nbuf_t nbuf_list)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	qdf_nbuf_t run_head, nbuf, next;
+	uint32_t run_len;
+	uint8_t bucket;
+
+	if (rx_tm_hdl->num_dp_rx_threads < 2) {
+		dp_rx_tm_thread_enqueue(rx_thread, nbuf_list);
+		return;
+	}
+
+	while (nbuf_list) {
+		run_head = nbuf_list;
+		bucket = dp_rx_tm_flow_bucket(run_head);
+		run_len = 1;
+		nbuf = run_head;
+		next = qdf_nbuf_next(nbuf);
+		while (next && dp_rx_tm_flow_bucket(next) == bucket) {
+			nbuf = next;
+			next = qdf_nbuf_next(nbuf);
+			run_len++;
+		}
+		qdf_nbuf_set_next(nbuf, NULL);
+		nbuf_list = next;
+
+		QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(run_head) = run_len;
+		dp_rx_tm_thread_enqueue(rx_thread, run_head);
+	}
+}
+
+/**
+ * dp_rx_thread_dequeue_head() - dequeue the head of the rx_thread queue
+ * @rx_thread - rx_thread from which the nbuf needs to be dequeued
+ *
+ * The flow bucket being delivered is recorded under the queue lock, so
+ * that it cannot be stolen while the thread delivers it.
+ *
+ * Returns: nbuf_list at the head of the queue, NULL if the queue is empty
+ */
+static qdf_nbuf_t dp_rx_thread_dequeue_head(struct dp_rx_thread *rx_thread)
+{
+	qdf_nbuf_t head = NULL, nbuf_list, tmp_nbuf_list;
+
+	qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
+	if (qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue)) {
+		QDF_NBUF_QUEUE_WALK_SAFE(&rx_thread->nbuf_queue, nbuf_list,
+					 tmp_nbuf_list) {
+			qdf_nbuf_unlink_no_lock(nbuf_list,
+						&rx_thread->nbuf_queue);
+			dp_rx_tm_pending_sub(rx_thread, nbuf_list);
+			head = nbuf_list;
+			break;
+		}
+	}
+	rx_thread->cur_bucket = head ? dp_rx_tm_flow_bucket(head) :
+				       DP_RX_TM_INVALID_BUCKET;
+	qdf_nbuf_queue_head_unlock(&rx_thread->nbuf_queue);
+
+	return head;
+}
+
+/**
+ * dp_rx_thread_forward_stolen() - forward a nbuf_list of a stolen flow
+ *				   bucket to the thread which stole it
+ * @rx_thread - rx_thread which dequeued the nbuf_list
+ * @nbuf_list - nbuf_list as stored in the thread queue
+ *
+ * Returns: true if the nbuf_list was forwarded, false if it is to be
+ *	    delivered by @rx_thread
+ */
+static bool dp_rx_thread_forward_stolen(struct dp_rx_thread *rx_thread,
+					qdf_nbuf_t nbuf_list)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	uint8_t bucket = dp_rx_tm_flow_bucket(nbuf_list);
+	uint8_t thief_id = rx_thread->stolen_by[bucket];
+	struct dp_rx_thread *thief;
+	bool forwarded = false;
+
+	if (qdf_likely(!thief_id))
+		return false;
+
+	thief = rx_tm_hdl->rx_thread[thief_id - 1];
+
+	qdf_spin_lock_bh(&thief->steal_lock);
+	if (rx_thread->stolen_by[bucket] == thief_id) {
+		qdf_nbuf_queue_add(&thief->steal_q, nbuf_list);
+		forwarded = true;
+	}
+	qdf_spin_unlock_bh(&thief->steal_lock);
+
+	if (!forwarded)
+		return false;
+
+	rx_thread->stats.nbuf_forwarded += dp_rx_tm_nbuf_list_len(nbuf_list);
+	qdf_set_bit(RX_POST_EVENT, &thief->event_flag);
+	qdf_wake_up_interruptible(&thief->wait_q);
+
+	return true;
+}
+
+/**
+ * dp_rx_thread_steal_ack() - acknowledge steals from the rx_thread queue
+ * @rx_thread - rx_thread from which flow buckets were stolen
+ *
+ * Packets of the stolen flows which are held in the GRO of @rx_thread
+ * are flushed before the thieves are allowed to deliver.
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_steal_ack(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread *thief;
+	unsigned long thieves = 0;
+	int i;
+
+	if (qdf_likely(!rx_thread->steal_req))
+		return;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (qdf_atomic_test_and_clear_bit(i, &rx_thread->steal_req))
+			thieves |= (1UL << i);
+	}
+
+	dp_rx_thread_gro_flush(rx_thread, DP_RX_GRO_NORMAL_FLUSH);
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (!(thieves & (1UL << i)))
+			continue;
+
+		thief = rx_tm_hdl->rx_thread[i];
+		qdf_atomic_set(&thief->steal_ready, 1);
+		qdf_set_bit(RX_POST_EVENT, &thief->event_flag);
+		qdf_wake_up_interruptible(&thief->wait_q);
+	}
+}
+
+/**
+ * dp_rx_thread_try_steal() - steal a flow bucket from the busiest thread
+ * @rx_thread - idle rx_thread looking for work
+ *
+ * The oldest flow bucket of the busiest thread which is neither being
+ * delivered nor already stolen is moved as a whole to the steal_q of
+ * @rx_thread.
+ *
+ * Returns: true if a flow bucket was stolen
+ */
+static bool dp_rx_thread_try_steal(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread *victim = NULL, *tmp;
+	qdf_nbuf_t nbuf_list, tmp_nbuf_list;
+	qdf_nbuf_queue_t stolen_q;
+	uint32_t pending, max_pending = DP_RX_TM_STEAL_PENDING_THRESH - 1;
+	uint32_t num_stolen = 0;
+	uint8_t bucket = DP_RX_TM_INVALID_BUCKET;
+	uint8_t cur;
+	int i;
+
+	if (rx_thread->steal_bucket != DP_RX_TM_INVALID_BUCKET ||
+	    qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue))
+		return false;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		tmp = rx_tm_hdl->rx_thread[i];
+		if (!tmp || tmp == rx_thread)
+			continue;
+
+		pending = dp_rx_tm_pending(tmp);
+		if (pending > max_pending) {
+			max_pending = pending;
+			victim = tmp;
+		}
+	}
+
+	if (!victim)
+		return false;
+
+	qdf_atomic_set(&rx_thread->steal_ready, 0);
+	rx_thread->steal_victim = victim->id;
+	qdf_nbuf_queue_init(&stolen_q);
+
+	qdf_nbuf_queue_head_lock(&victim->nbuf_queue);
+	QDF_NBUF_QUEUE_WALK_SAFE(&victim->nbuf_queue, nbuf_list,
+				 tmp_nbuf_list) {
+		cur = dp_rx_tm_flow_bucket(nbuf_list);
+		if (bucket == DP_RX_TM_INVALID_BUCKET) {
+			if (cur == victim->cur_bucket || victim->stolen_by[cur])
+				continue;
+			bucket = cur;
+		} else if (cur != bucket) {
+			continue;
+		}
+
+		qdf_nbuf_unlink_no_lock(nbuf_list, &victim->nbuf_queue);
+		dp_rx_tm_pending_sub(victim, nbuf_list);
+		num_stolen += dp_rx_tm_nbuf_list_len(nbuf_list);
+		qdf_nbuf_queue_add(&stolen_q, nbuf_list);
+	}
+
+	if (bucket != DP_RX_TM_INVALID_BUCKET) {
+		qdf_spin_lock_bh(&rx_thread->steal_lock);
+		qdf_nbuf_queue_append(&rx_thread->steal_q, &stolen_q);
+		rx_thread->steal_bucket = bucket;
+		victim->stolen_by[bucket] = rx_thread->id + 1;
+		qdf_spin_unlock_bh(&rx_thread->steal_lock);
+	}
+	qdf_nbuf_queue_head_unlock(&victim->nbuf_queue);
+
+	if (bucket == DP_RX_TM_INVALID_BUCKET)
+		return false;
+
+	rx_thread->stats.steals++;
+	rx_thread->stats.nbuf_stolen += num_stolen;
+	victim->stats.nbuf_given += num_stolen;
+
+	qdf_atomic_set_bit(rx_thread->id, &victim->steal_req);
+	qdf_set_bit(RX_POST_EVENT, &victim->event_flag);
+	qdf_wake_up_interruptible(&victim->wait_q);
+
+	return true;
+}
+
+/**
+ * dp_rx_thread_steal_q_dequeue() - dequeue a stolen nbuf_list
+ * @rx_thread - rx_thread owning the steal_q
+ *
+ * Returns: nbuf_list ready to be delivered, NULL if steal_q is empty
+ */
+static qdf_nbuf_t dp_rx_thread_steal_q_dequeue(struct dp_rx_thread *rx_thread)
+{
+	qdf_nbuf_t head;
+
+	qdf_spin_lock_bh(&rx_thread->steal_lock);
+	head = qdf_nbuf_queue_remove(&rx_thread->steal_q);
+	qdf_spin_unlock_bh(&rx_thread->steal_lock);
+
+	dp_rx_thread_adjust_nbuf_list(head);
+
+	return head;
+}
+
+/**
+ * dp_rx_thread_steal_release() - give a stolen flow bucket back to victim
+ * @rx_thread - rx_thread owning the stolen flow bucket
+ *
+ * Returns: true if released, false if more lists were forwarded meanwhile
+ */
+static bool dp_rx_thread_steal_release(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread *victim;
+	bool released = false;
+
+	victim = rx_tm_hdl->rx_thread[rx_thread->steal_victim];
+
+	qdf_spin_lock_bh(&rx_thread->steal_lock);
+	if (!qdf_nbuf_queue_len(&rx_thread->steal_q)) {
+		victim->stolen_by[rx_thread->steal_bucket] = 0;
+		rx_thread->steal_bucket = DP_RX_TM_INVALID_BUCKET;
+		released = true;
+	}
+	qdf_spin_unlock_bh(&rx_thread->steal_lock);
+
+	return released;
+}
+
+/**
+ * dp_rx_thread_steal_work() - deliver stolen packets and steal more work
+ * @rx_thread - rx_thread to be processed
+ * @soc - ol_txrx_soc_handle object
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_steal_work(struct dp_rx_thread *rx_thread,
+				    ol_txrx_soc_handle soc)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	qdf_nbuf_t nbuf_list = NULL;
+	uint32_t budget = DP_RX_TM_STEAL_BUDGET;
+
+	if (rx_thread->steal_bucket == DP_RX_TM_INVALID_BUCKET) {
+		dp_rx_thread_try_steal(rx_thread);
+		return;
+	}
+
+	if (!qdf_atomic_read(&rx_thread->steal_ready))
+		return;
+
+	qdf_atomic_inc(&rx_tm_hdl->steals_in_progress);
+	while (budget--) {
+		nbuf_list = dp_rx_thread_steal_q_dequeue(rx_thread);
+		if (!nbuf_list)
+			break;
+		/* bottom halves off keep the thread on napi_owner_cpu */
+		local_bh_disable();
+		rx_thread->napi_owner_cpu = qdf_get_cpu();
+		dp_rx_thread_deliver_nbuf_list(rx_thread, soc, nbuf_list);
+		rx_thread->napi_owner_cpu = -1;
+		local_bh_enable();
+	}
+	qdf_atomic_dec(&rx_tm_hdl->steals_in_progress);
+
+	dp_rx_thread_gro_flush(rx_thread, DP_RX_GRO_NORMAL_FLUSH);
+
+	/* Victim keeps forwarding the flow, serve own queue in between */
+	if (nbuf_list) {
+		qdf_set_bit(RX_POST_EVENT, &rx_thread->event_flag);
+		return;
+	}
+
+	/* Stolen packets left GRO above, the victim can own the bucket */
+	if (dp_rx_thread_steal_release(rx_thread))
+		dp_rx_thread_try_steal(rx_thread);
+	else
+		qdf_set_bit(RX_POST_EVENT, &rx_thread->event_flag);
+}
+
+/**
+ * dp_rx_thread_flush_steal_q_by_vdev_id() - flush stolen rx packets by
+ *					     vdev_id
+ * @rx_thread - rx_thread owning the steal_q
+ * @vdev_id: vdev id for which packets are to be flushed
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_flush_steal_q_by_vdev_id(struct dp_rx_thread *rx_thread,
+						  uint8_t vdev_id)
+{
+	qdf_nbuf_queue_t keep_q, flush_q;
+	qdf_nbuf_t nbuf_list;
+
+	qdf_nbuf_queue_init(&keep_q);
+	qdf_nbuf_queue_init(&flush_q);
+
+	qdf_spin_lock_bh(&rx_thread->steal_lock);
+	while ((nbuf_list = qdf_nbuf_queue_remove(&rx_thread->steal_q))) {
+		if (QDF_NBUF_CB_RX_VDEV_ID(nbuf_list) == vdev_id)
+			qdf_nbuf_queue_add(&flush_q, nbuf_list);
+		else
+			qdf_nbuf_queue_add(&keep_q, nbuf_list);
+	}
+	qdf_nbuf_queue_append(&rx_thread->steal_q, &keep_q);
+	qdf_spin_unlock_bh(&rx_thread->steal_lock);
+
+	while ((nbuf_list = qdf_nbuf_queue_remove(&flush_q))) {
+		dp_rx_thread_adjust_nbuf_list(nbuf_list);
+		rx_thread->stats.rx_flushed +=
+			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
+		qdf_nbuf_list_free(nbuf_list);
+	}
+}
+
+/**
+ * dp_rx_thread_steal_init() - initialize work stealing state of a thread
+ * @rx_thread - rx_thread to be initialized
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_steal_init(struct dp_rx_thread *rx_thread)
+{
+	qdf_spinlock_create(&rx_thread->steal_lock);
+	qdf_nbuf_queue_init(&rx_thread->steal_q);
+	qdf_atomic_init(&rx_thread->steal_ready);
+	qdf_atomic_init(&rx_thread->nbuf_pending);
+	rx_thread->napi_owner_cpu = -1;
+	rx_thread->steal_bucket = DP_RX_TM_INVALID_BUCKET;
+	rx_thread->cur_bucket = DP_RX_TM_INVALID_BUCKET;
+	rx_thread->start_ts = qdf_get_log_timestamp();
+}
+
+/**
+ * dp_rx_thread_steal_deinit() - free stolen packets left in a thread
+ * @rx_thread - rx_thread to be de-initialized
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_steal_deinit(struct dp_rx_thread *rx_thread)
+{
+	qdf_nbuf_t nbuf_list;
+
+	while ((nbuf_list = qdf_nbuf_queue_remove(&rx_thread->steal_q))) {
+		dp_rx_thread_adjust_nbuf_list(nbuf_list);
+		qdf_nbuf_list_free(nbuf_list);
+	}
+	qdf_spinlock_destroy(&rx_thread->steal_lock);
+}
+
+/**
+ * dp_rx_tm_get_stealing_thread() - get the rx_thread delivering stolen
+ *				    packets on the current cpu
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ *
+ * Stolen packets are delivered through the NAPI of the thief, not through
+ * the one of the thread selected for their RX context. The thief records
+ * the cpu it delivers on in napi_owner_cpu with bottom halves disabled, so
+ * nothing else on that cpu can ask for a NAPI context meanwhile.
+ *
+ * Return: rx_thread owning the NAPI on this cpu, NULL if no thread is
+ *	   delivering stolen packets on it
+ */
+static struct dp_rx_thread *
+dp_rx_tm_get_stealing_thread(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	struct dp_rx_thread *rx_thread;
+	int cpu;
+	int i;
+
+	if (qdf_likely(!qdf_atomic_read(&rx_tm_hdl->steals_in_progress)))
+		return NULL;
+
+	cpu = qdf_get_cpu();
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		rx_thread = rx_tm_hdl->rx_thread[i];
+		if (rx_thread && READ_ONCE(rx_thread->napi_owner_cpu) == cpu)
+			return rx_thread;
+	}
+
+	return NULL;
+}
+
+static inline uint64_t dp_rx_thread_busy_ts_get(void)
+{
+	return qdf_get_log_timestamp();
+}
+
+static inline void dp_rx_thread_busy_time_update(struct dp_rx_thread *rx_thread,
+						 uint64_t busy_ts)
+{
+	rx_thread->stats.busy_time_us +=
+		qdf_log_timestamp_to_usecs(qdf_get_log_timestamp() - busy_ts);
+}
+#else
+static inline void dp_rx_tm_thread_enqueue_flows(struct dp_rx_thread *rx_thread,
+						 qdf_nbuf_t nbuf_list)
+{
+	dp_rx_tm_thread_enqueue(rx_thread, nbuf_list);
+}
+
+static inline qdf_nbuf_t
+dp_rx_thread_dequeue_head(struct dp_rx_thread *rx_thread)
+{
+	return qdf_nbuf_queue_head_dequeue(&rx_thread->nbuf_queue);
+}
+
+static inline bool dp_rx_thread_forward_stolen(struct dp_rx_thread *rx_thread,
+					       qdf_nbuf_t nbuf_list)
+{
+	return false;
+}
+
+static inline void dp_rx_thread_steal_ack(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void dp_rx_thread_steal_work(struct dp_rx_thread *rx_thread,
+					   ol_txrx_soc_handle soc)
+{
+}
+
+static inline void
+dp_rx_thread_flush_steal_q_by_vdev_id(struct dp_rx_thread *rx_thread,
+				      uint8_t vdev_id)
+{
+}
+
+static inline void dp_rx_thread_steal_init(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void dp_rx_thread_steal_deinit(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline struct dp_rx_thread *
+dp_rx_tm_get_stealing_thread(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	return NULL;
+}
+
+static inline uint64_t dp_rx_thread_busy_ts_get(void)
+{
+	return 0;
+}
+
+static inline void dp_rx_thread_busy_time_update(struct dp_rx_thread *rx_thread,
+						 uint64_t busy_ts)
+{
+}
+#endif /* WLAN_DP_RX_THREAD_WORK_STEALING */
+
 /**
  * dp_rx_tm_thread_dequeue() - dequeue nbuf list from rx_thread
  * @rx_thread - rx_thread from which the nbuf needs to be dequeued
@@ -423,7 +1143,9 @@ static qdf_nbuf_t dp_rx_tm_thread_dequeue(struct dp_rx_thread *rx_thread)
 {
 	qdf_nbuf_t head;
 
-	head = qdf_nbuf_queue_head_dequeue(&rx_thread->nbuf_queue);
+	do {
+		head = dp_rx_thread_dequeue_head(rx_thread);
+	} while (head && dp_rx_thread_forward_stolen(rx_thread, head));
 	dp_rx_thread_adjust_nbuf_list(head);
 
 	dp_debug("Dequeued %pK nbuf_list", head);
@@ -462,11 +1184,7 @@ static inline bool dp_rx_thread_should_yield(struct dp_rx_thread *rx_thread,
 static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 {
 	qdf_nbuf_t nbuf_list;
-	uint8_t vdev_id;
-	ol_txrx_rx_fp stack_fn;
-	ol_osif_vdev_handle osif_vdev;
 	ol_txrx_soc_handle soc;
-	uint32_t num_list_elements = 0;
 	uint32_t iterates = 0;
 
 	struct dp_txrx_handle_cmn *txrx_handle_cmn;
@@ -486,34 +1204,17 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 
 	nbuf_list = dp_rx_tm_thread_dequeue(rx_thread);
 	while (nbuf_list) {
-		num_list_elements =
-			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
-		/* count aggregated RX frame into stats */
-		num_list_elements += qdf_nbuf_get_gso_segs(nbuf_list);
-		rx_thread->stats.nbuf_dequeued += num_list_elements;
-		iterates += num_list_elements;
-
-		vdev_id = QDF_NBUF_CB_RX_VDEV_ID(nbuf_list);
-		cdp_get_os_rx_handles_from_vdev(soc, vdev_id, &stack_fn,
-						&osif_vdev);
-		dp_debug("rx_thread %pK sending packet %pK to stack",
-			 rx_thread, nbuf_list);
-		if (!stack_fn || !osif_vdev ||
-		    QDF_STATUS_SUCCESS != stack_fn(osif_vdev, nbuf_list)) {
-			rx_thread->stats.dropped_invalid_os_rx_handles +=
-							num_list_elements;
-			qdf_nbuf_list_free(nbuf_list);
-		} else {
-			rx_thread->stats.nbuf_sent_to_stack +=
-							num_list_elements;
-		}
+		iterates += dp_rx_thread_deliver_nbuf_list(rx_thread, soc,
+							   nbuf_list);
 		if (qdf_unlikely(dp_rx_thread_should_yield(rx_thread,
 							   iterates))) {
 			rx_thread->stats.rx_nbufq_loop_yield++;
 			break;
 		}
+		dp_rx_thread_steal_ack(rx_thread);
 		nbuf_list = dp_rx_tm_thread_dequeue(rx_thread);
 	}
+	dp_rx_thread_steal_ack(rx_thread);
 
 	dp_debug("exit: qlen  %u",
 		 qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue));
@@ -573,6 +1274,7 @@ dp_rx_should_flush(struct dp_rx_thread *rx_thread)
 static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 {
 	enum dp_rx_gro_flush_code gro_flush_code;
+	uint64_t busy_ts;
 
 	while (true) {
 		if (qdf_atomic_test_and_clear_bit(RX_SHUTDOWN_EVENT,
@@ -588,7 +1290,12 @@ static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 			break;
 		}
 
+		busy_ts = dp_rx_thread_busy_ts_get();
 		dp_rx_thread_process_nbufq(rx_thread);
+		dp_rx_thread_steal_work(rx_thread,
+					dp_rx_tm_get_soc_handle(
+						rx_thread->rtm_handle_cmn));
+		dp_rx_thread_busy_time_update(rx_thread, busy_ts);
 
 		gro_flush_code = dp_rx_should_flush(rx_thread);
 		/* Only flush when gro_flush_code is either
@@ -831,6 +1538,7 @@ static QDF_STATUS dp_rx_tm_thread_init(struct dp_rx_thread *rx_thread,
 	qdf_event_create(&rx_thread->vdev_del_event);
 	qdf_atomic_init(&rx_thread->gro_flush_ind);
 	qdf_init_waitqueue_head(&rx_thread->wait_q);
+	dp_rx_thread_steal_init(rx_thread);
 	qdf_scnprintf(thread_name, sizeof(thread_name), "dp_rx_thread_%u", id);
 	dp_info("%s %u", thread_name, id);
 
@@ -869,6 +1577,7 @@ static QDF_STATUS dp_rx_tm_thread_deinit(struct dp_rx_thread *rx_thread)
 	qdf_event_destroy(&rx_thread->resume_event);
 	qdf_event_destroy(&rx_thread->shutdown_event);
 	qdf_event_destroy(&rx_thread->vdev_del_event);
+	dp_rx_thread_steal_deinit(rx_thread);
 
 	if (cdp_cfg_get(dp_rx_tm_get_soc_handle(rx_thread->rtm_handle_cmn),
 			cfg_dp_gro_enable))
@@ -947,6 +1656,9 @@ QDF_STATUS dp_rx_tm_init(struct dp_rx_tm_handle *rx_tm_hdl,
 
 	rx_tm_hdl->num_dp_rx_threads = num_dp_rx_threads;
 	rx_tm_hdl->state = DP_RX_THREADS_INVALID;
+#ifdef WLAN_DP_RX_THREAD_WORK_STEALING
+	qdf_atomic_init(&rx_tm_hdl->steals_in_progress);
+#endif
 
 	dp_info("initializing %u threads", num_dp_rx_threads);
 
@@ -1116,6 +1828,7 @@ QDF_STATUS dp_rx_thread_flush_by_vdev_id(struct dp_rx_thread *rx_thread,
 		if (QDF_NBUF_CB_RX_VDEV_ID(nbuf_list) == vdev_id) {
 			qdf_nbuf_unlink_no_lock(nbuf_list,
 						&rx_thread->nbuf_queue);
+			dp_rx_tm_pending_sub(rx_thread, nbuf_list);
 			DP_RX_HEAD_APPEND(nbuf_list_head, nbuf_list);
 		}
 	}
@@ -1135,6 +1848,8 @@ QDF_STATUS dp_rx_thread_flush_by_vdev_id(struct dp_rx_thread *rx_thread,
 		nbuf_list_head = nbuf_list_next;
 	}
 
+	dp_rx_thread_flush_steal_q_by_vdev_id(rx_thread, vdev_id);
+
 	qdf_event_reset(&rx_thread->vdev_del_event);
 	qdf_set_bit(RX_VDEV_DEL_EVENT, &rx_thread->event_flag);
 	qdf_wake_up_interruptible(&rx_thread->wait_q);
@@ -1379,8 +2094,8 @@ QDF_STATUS dp_rx_tm_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
 	selected_thread_id =
 		dp_rx_tm_select_thread(rx_tm_hdl,
 				       QDF_NBUF_CB_RX_CTX_ID(nbuf_list));
-	dp_rx_tm_thread_enqueue(rx_tm_hdl->rx_thread[selected_thread_id],
-				nbuf_list);
+	dp_rx_tm_thread_enqueue_flows(rx_tm_hdl->rx_thread[selected_thread_id],
+				      nbuf_list);
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -1397,10 +2112,31 @@ dp_rx_tm_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl, int rx_ctx_id,
 	return QDF_STATUS_SUCCESS;
 }
 
+uint32_t dp_rx_tm_get_thread_pending(struct dp_rx_tm_handle *rx_tm_hdl,
+				     int rx_ctx_id)
+{
+	struct dp_rx_thread *rx_thread;
+
+	if (qdf_unlikely(!rx_tm_hdl->num_dp_rx_threads))
+		return 0;
+
+	rx_thread = rx_tm_hdl->rx_thread[dp_rx_tm_select_thread(rx_tm_hdl,
+								rx_ctx_id)];
+	if (qdf_unlikely(!rx_thread))
+		return 0;
+
+	return qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue);
+}
+
 struct napi_struct *dp_rx_tm_get_napi_context(struct dp_rx_tm_handle *rx_tm_hdl,
 					      uint8_t rx_ctx_id)
 {
 	uint8_t selected_thread_id;
+	struct dp_rx_thread *rx_thread;
+
+	rx_thread = dp_rx_tm_get_stealing_thread(rx_tm_hdl);
+	if (rx_thread)
+		return &rx_thread->napi;
 
 	selected_thread_id = dp_rx_tm_select_thread(rx_tm_hdl, rx_ctx_id);
 
@@ -31,6 +31,16 @@
 /* Number of DP RX threads supported */
 #define DP_MAX_RX_THREADS WLAN_CFG_NUM_REO_DEST_RING
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEALING
+/* Number of flow buckets, a stolen batch holds all lists of one bucket */
+#define DP_RX_TM_FLOW_BUCKETS 64
+#define DP_RX_TM_INVALID_BUCKET 0xff
+/* Queued packets at which a busy thread wakes up an idle sibling */
+#define DP_RX_TM_STEAL_PENDING_THRESH 128
+/* Stolen nbuf_lists delivered before the thief serves its own queue */
+#define DP_RX_TM_STEAL_BUDGET 64
+#endif
+
 /*
  * struct dp_rx_tm_handle_cmn - Opaque handle for rx_threads to store
  * rx_tm_handle. This handle will be common for all the threads.
@@ -55,6 +65,11 @@ struct dp_rx_tm_handle_cmn;
  * @dropped_others: packets dropped due to other reasons
  * @dropped_enq_fail: packets dropped due to pending queue full
  * @rx_nbufq_loop_yield: rx loop yield counter
+ * @steals: number of flow batches stolen by the thread
+ * @nbuf_stolen: packets stolen by the thread from other threads
+ * @nbuf_given: packets stolen from the thread by other threads
+ * @nbuf_forwarded: packets forwarded to the thread owning a stolen flow
+ * @busy_time_us: time spent by the thread delivering packets
  */
 struct dp_rx_thread_stats {
 	unsigned int nbuf_queued[DP_RX_TM_MAX_REO_RINGS];
@@ -71,6 +86,13 @@ struct dp_rx_thread_stats {
 	unsigned int dropped_others;
 	unsigned int dropped_enq_fail;
 	unsigned int rx_nbufq_loop_yield;
+#ifdef WLAN_DP_RX_THREAD_WORK_STEALING
+	unsigned int steals;
+	unsigned int nbuf_stolen;
+	unsigned int nbuf_given;
+	unsigned int nbuf_forwarded;
+	uint64_t busy_time_us;
+#endif
 };
 
 /**
@@ -107,6 +129,19 @@ enum dp_rx_refill_thread_state {
  *		    structures via APIs.
  * @napi: napi to deliver packet to stack via GRO
  * @netdev: dummy netdev to initialize the napi structure with
+ * @start_ts: time the thread was started, used for utilisation stats
+ * @cur_bucket: flow bucket of the list being delivered from nbuf_queue
+ * @stolen_by: per flow bucket, id + 1 of the thread which stole it
+ * @steal_req: bitmap of threads waiting for this thread to flush GRO
+ *	       after stealing from it
+ * @steal_lock: lock protecting steal_q and the release of a stolen bucket
+ * @steal_q: stolen nbuf_lists of the flow bucket owned by the thread
+ * @steal_bucket: flow bucket currently owned by the thread
+ * @steal_victim: thread the owned flow bucket was stolen from
+ * @steal_ready: victim flushed its GRO, steal_q can be delivered
+ * @nbuf_pending: packets queued in nbuf_queue, aggregates counted per segment
+ * @napi_owner_cpu: cpu on which the thread delivers stolen packets through
+ *		    its NAPI with bottom halves disabled, -1 otherwise
  */
 struct dp_rx_thread {
 	uint8_t id;
@@ -125,6 +160,19 @@ struct dp_rx_thread {
 	struct napi_struct napi;
 	qdf_wait_queue_head_t wait_q;
 	struct net_device netdev;
+#ifdef WLAN_DP_RX_THREAD_WORK_STEALING
+	uint64_t start_ts;
+	uint8_t cur_bucket;
+	uint8_t stolen_by[DP_RX_TM_FLOW_BUCKETS];
+	unsigned long steal_req;
+	qdf_spinlock_t steal_lock;
+	qdf_nbuf_queue_t steal_q;
+	uint8_t steal_bucket;
+	uint8_t steal_victim;
+	qdf_atomic_t steal_ready;
+	qdf_atomic_t nbuf_pending;
+	int napi_owner_cpu;
+#endif
 };
 
 /**
@@ -175,6 +223,7 @@ enum dp_rx_thread_state {
  * @state: state of the rx_threads. All of them should be in the same state.
  * @rx_thread: array of pointers of type struct dp_rx_thread
  * @allow_dropping: flag to indicate frame dropping is enabled
+ * @steals_in_progress: number of threads delivering stolen packets
  */
 struct dp_rx_tm_handle {
 	uint8_t num_dp_rx_threads;
@@ -182,6 +231,9 @@ struct dp_rx_tm_handle {
 	enum dp_rx_thread_state state;
 	struct dp_rx_thread **rx_thread;
 	qdf_atomic_t allow_dropping;
+#ifdef WLAN_DP_RX_THREAD_WORK_STEALING
+	qdf_atomic_t steals_in_progress;
+#endif
 };
 
 /**
@@ -252,6 +304,19 @@ QDF_STATUS dp_rx_tm_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
 QDF_STATUS dp_rx_tm_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_handle,
 				  int rx_ctx_id,
 				  enum dp_rx_gro_flush_code flush_code);
+
+/**
+ * dp_rx_tm_get_thread_pending() - nbuf lists pending in a RX Context's thread
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @rx_ctx_id: RX Thread Contex Id whose thread is to be checked
+ *
+ * Lockless, only reads the length counter of the thread nbuf queue.
+ *
+ * Return: number of nbuf lists queued for the thread
+ */
+uint32_t dp_rx_tm_get_thread_pending(struct dp_rx_tm_handle *rx_tm_hdl,
+				     int rx_ctx_id);
+
 /**
  * dp_rx_refill_thread_suspend() - Suspend RX refill thread
  * @refill_thread: pointer to dp_rx_refill_thread object
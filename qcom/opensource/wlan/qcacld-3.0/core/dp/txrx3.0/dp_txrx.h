@@ -323,6 +323,32 @@ ret:
 	return qdf_status;
 }
 
+/**
+ * dp_rx_get_thread_pending() - nbuf lists pending in the DP RX thread of a
+ *  RX CTX Id
+ * @soc: ol_txrx_soc_handle object
+ * @rx_ctx_id: Context Id of the thread to check
+ *
+ * Lockless and cheap enough for the per reap path, unlike
+ * dp_rx_tm_get_pending() which walks all the threads.
+ *
+ * Return: number of nbuf lists queued for the thread
+ */
+static inline
+uint32_t dp_rx_get_thread_pending(ol_txrx_soc_handle soc, int rx_ctx_id)
+{
+	struct dp_txrx_handle *dp_ext_hdl;
+
+	if (!soc)
+		return 0;
+
+	dp_ext_hdl = cdp_soc_get_dp_txrx_handle(soc);
+	if (!dp_ext_hdl)
+		return 0;
+
+	return dp_rx_tm_get_thread_pending(&dp_ext_hdl->rx_tm_hdl, rx_ctx_id);
+}
+
 /**
  * dp_txrx_ext_dump_stats() - dump txrx external module stats
  * @soc: ol_txrx_soc_handle object
@@ -455,6 +481,12 @@ QDF_STATUS dp_rx_gro_flush_ind(ol_txrx_soc_handle soc, int rx_ctx_id,
 	return QDF_STATUS_SUCCESS;
 }
 
+static inline
+uint32_t dp_rx_get_thread_pending(ol_txrx_soc_handle soc, int rx_ctx_id)
+{
+	return 0;
+}
+
 static inline QDF_STATUS dp_txrx_ext_dump_stats(ol_txrx_soc_handle soc,
 						uint8_t stats_id)
 {
@@ -27,6 +27,7 @@
 #include "qca_vendor.h"
 #include "wlan_hdd_bus_bandwidth.h"
 #include "wlan_hdd_main.h"
+#include "osif_sync.h"
 
 /**
  * bus_bw_table_default - default table which provides bus bandwidth level
@@ -207,6 +208,277 @@ bbm_get_bus_bw_level_vote(struct hdd_adapter *adapter,
 	return vote_lvl;
 }
 
+/**
+ * bbm_get_tput_vote() - Select bus bw vote level for a throughput level
+ *  across the connected adapters
+ * @hdd_ctx: HDD context
+ * @tput_level: throughput level
+ *
+ * Returns: Bus bw level
+ */
+static enum bus_bw_level
+bbm_get_tput_vote(struct hdd_context *hdd_ctx, enum tput_level tput_level)
+{
+	struct hdd_adapter *adapter;
+	struct hdd_adapter *next_adapter;
+	enum bus_bw_level next_vote = BUS_BW_LEVEL_NONE;
+	enum bus_bw_level tmp_vote;
+
+	hdd_for_each_adapter_dev_held_safe(hdd_ctx, adapter, next_adapter,
+					   NET_DEV_HOLD_BUS_BW_MGR) {
+		tmp_vote = bbm_get_bus_bw_level_vote(adapter, tput_level);
+		if (tmp_vote > next_vote)
+			next_vote = tmp_vote;
+		hdd_adapter_dev_put_debug(adapter, NET_DEV_HOLD_BUS_BW_MGR);
+	}
+
+	return next_vote;
+}
+
+#ifdef FEATURE_BBM_PREDICTIVE_VOTE
+/**
+ * bbm_predict_metric_to_level() - Map a datapath hint to a throughput level
+ * @src: hint source
+ * @metric: source specific load metric
+ *
+ * Returns: predicted throughput level, TPUT_LEVEL_NONE if under watermark
+ */
+static enum tput_level
+bbm_predict_metric_to_level(enum bbm_predict_src src, uint32_t metric)
+{
+	switch (src) {
+	case BBM_PREDICT_SRC_RX_PENDING:
+		if (metric >= BBM_PREDICT_RX_PENDING_HIGH_WM)
+			return TPUT_LEVEL_ULTRA_HIGH;
+		if (metric >= BBM_PREDICT_RX_PENDING_LOW_WM)
+			return TPUT_LEVEL_VERY_HIGH;
+		break;
+	case BBM_PREDICT_SRC_RX_AGGR:
+		if (metric >= BBM_PREDICT_RX_AGGR_HIGH_SEGS)
+			return TPUT_LEVEL_VERY_HIGH;
+		if (metric >= BBM_PREDICT_RX_AGGR_LOW_SEGS)
+			return TPUT_LEVEL_HIGH;
+		break;
+	case BBM_PREDICT_SRC_TX_FLOW_CTRL:
+		return TPUT_LEVEL_VERY_HIGH;
+	default:
+		break;
+	}
+
+	return TPUT_LEVEL_NONE;
+}
+
+void hdd_bbm_predict_hint(struct hdd_context *hdd_ctx,
+			  enum bbm_predict_src src, uint32_t metric)
+{
+	struct bbm_context *bbm_ctx = hdd_ctx->bbm_ctx;
+	struct bbm_predict *pred;
+	enum tput_level level;
+	qdf_time_t now;
+
+	if (qdf_unlikely(!bbm_ctx))
+		return;
+
+	level = bbm_predict_metric_to_level(src, metric);
+	if (level == TPUT_LEVEL_NONE)
+		return;
+
+	pred = &bbm_ctx->predict;
+
+	/* holding the level only needs one hint per evaluation */
+	if (level <= pred->level) {
+		now = qdf_system_ticks();
+		if (qdf_system_time_after(pred->hint_next[src], now))
+			return;
+		pred->hint_next[src] = now +
+			qdf_system_msecs_to_ticks(BBM_PREDICT_HINT_INTERVAL_MS);
+	}
+
+	/* avoid dirtying the shared line when the level is already hinted */
+	if (!qdf_atomic_test_bit(level, &pred->hint_map))
+		qdf_atomic_set_bit(level, &pred->hint_map);
+
+	if (level > pred->level) {
+		pred->hint_src = src;
+		qdf_sched_work(0, &pred->work);
+	}
+}
+
+/**
+ * bbm_apply_predictive_policy() - Fold the pending datapath hints into the
+ *  predictive policy vote
+ * @hdd_ctx: HDD context
+ * @decay: true on the periodic sample, lets an expired level step down
+ *
+ * A hint at or above the current level is applied at once and re-arms the
+ * hold time. Once the hold time expires the level drops one step per periodic
+ * sample, but never below the highest level hinted in that period.
+ *
+ * Returns: None
+ */
+static void
+bbm_apply_predictive_policy(struct hdd_context *hdd_ctx, bool decay)
+{
+	struct bbm_context *bbm_ctx = hdd_ctx->bbm_ctx;
+	struct bbm_predict *pred = &bbm_ctx->predict;
+	enum tput_level hint = TPUT_LEVEL_NONE;
+	enum tput_level level;
+	uint64_t now = qdf_get_log_timestamp();
+
+	for (level = TPUT_LEVEL_MAX - 1; level > TPUT_LEVEL_NONE; level--) {
+		if (qdf_atomic_test_and_clear_bit(level, &pred->hint_map) &&
+		    hint == TPUT_LEVEL_NONE)
+			hint = level;
+	}
+
+	if (hint != TPUT_LEVEL_NONE && hint >= pred->level) {
+		if (hint > pred->level) {
+			pred->src = pred->hint_src;
+			pred->raises++;
+		}
+		pred->level = hint;
+		pred->hold_expiry = now +
+			qdf_usecs_to_log_timestamp(BBM_PREDICT_HOLD_US);
+	} else if (decay && pred->level != TPUT_LEVEL_NONE &&
+		   now >= pred->hold_expiry) {
+		pred->level--;
+		if (pred->level < hint)
+			pred->level = hint;
+		pred->decays++;
+	}
+
+	if (pred->level == TPUT_LEVEL_NONE)
+		bbm_ctx->per_policy_vote[BBM_PREDICTIVE_POLICY] =
+							BUS_BW_LEVEL_NONE;
+	else
+		bbm_ctx->per_policy_vote[BBM_PREDICTIVE_POLICY] =
+				bbm_get_tput_vote(hdd_ctx, pred->level);
+}
+
+/**
+ * bbm_predict_reset() - Drop the predictive vote and pending hints
+ * @bbm_ctx: bus bw mgr context
+ *
+ * Returns: None
+ */
+static void bbm_predict_reset(struct bbm_context *bbm_ctx)
+{
+	struct bbm_predict *pred = &bbm_ctx->predict;
+	qdf_time_t now = qdf_system_ticks();
+	int i;
+
+	for (i = 0; i < BBM_PREDICT_SRC_MAX; i++)
+		pred->hint_next[i] = now;
+	pred->hint_map = 0;
+	pred->level = TPUT_LEVEL_NONE;
+	pred->src = BBM_PREDICT_SRC_NONE;
+	bbm_ctx->per_policy_vote[BBM_PREDICTIVE_POLICY] = BUS_BW_LEVEL_NONE;
+}
+
+/**
+ * bbm_predict_work_handler() - Re-vote on a predictive ramp up
+ * @context: HDD context
+ *
+ * Returns: None
+ */
+static void bbm_predict_work_handler(void *context)
+{
+	struct hdd_context *hdd_ctx = context;
+	struct bbm_params param = {0};
+	struct qdf_op_sync *op_sync;
+
+	if (qdf_op_protect(&op_sync))
+		return;
+
+	if (hdd_ctx->bbm_ctx && !hdd_ctx->is_wiphy_suspended) {
+		param.policy = BBM_PREDICTIVE_POLICY;
+		hdd_bbm_apply_independent_policy(hdd_ctx, &param);
+	}
+
+	qdf_op_unprotect(op_sync);
+}
+
+/**
+ * bbm_predict_init() - Initialize predictive policy state
+ * @hdd_ctx: HDD context
+ * @bbm_ctx: bus bw mgr context
+ *
+ * Returns: qdf status
+ */
+static QDF_STATUS bbm_predict_init(struct hdd_context *hdd_ctx,
+				   struct bbm_context *bbm_ctx)
+{
+	bbm_predict_reset(bbm_ctx);
+
+	return qdf_create_work(0, &bbm_ctx->predict.work,
+			       bbm_predict_work_handler, hdd_ctx);
+}
+
+/**
+ * bbm_predict_deinit() - De-initialize predictive policy state
+ * @bbm_ctx: bus bw mgr context
+ *
+ * Returns: None
+ */
+static void bbm_predict_deinit(struct bbm_context *bbm_ctx)
+{
+	qdf_destroy_work(0, &bbm_ctx->predict.work);
+}
+
+static inline enum tput_level
+bbm_predict_get_level(struct bbm_context *bbm_ctx)
+{
+	return bbm_ctx->predict.level;
+}
+
+static inline uint8_t bbm_predict_get_src(struct bbm_context *bbm_ctx)
+{
+	return bbm_ctx->predict.src;
+}
+
+static void bbm_predict_display(struct bbm_context *bbm_ctx)
+{
+	struct bbm_predict *pred = &bbm_ctx->predict;
+
+	hdd_nofl_debug("BBM predictive level %d src %u raises %u decays %u",
+		       pred->level, pred->src, pred->raises, pred->decays);
+}
+#else
+static inline void
+bbm_apply_predictive_policy(struct hdd_context *hdd_ctx, bool decay)
+{
+}
+
+static inline void bbm_predict_reset(struct bbm_context *bbm_ctx)
+{
+}
+
+static inline QDF_STATUS bbm_predict_init(struct hdd_context *hdd_ctx,
+					  struct bbm_context *bbm_ctx)
+{
+	return QDF_STATUS_SUCCESS;
+}
+
+static inline void bbm_predict_deinit(struct bbm_context *bbm_ctx)
+{
+}
+
+static inline enum tput_level
+bbm_predict_get_level(struct bbm_context *bbm_ctx)
+{
+	return TPUT_LEVEL_NONE;
+}
+
+static inline uint8_t bbm_predict_get_src(struct bbm_context *bbm_ctx)
+{
+	return BBM_PREDICT_SRC_NONE;
+}
+
+static inline void bbm_predict_display(struct bbm_context *bbm_ctx)
+{
+}
+#endif /* FEATURE_BBM_PREDICTIVE_VOTE */
+
 /**
  * bbm_apply_tput_policy() - Apply tput BBM policy by considering
  *  throughput level and connection modes across adapters
@@ -218,10 +490,6 @@ bbm_get_bus_bw_level_vote(struct hdd_adapter *adapter,
 static void
 bbm_apply_tput_policy(struct hdd_context *hdd_ctx, enum tput_level tput_level)
 {
-	struct hdd_adapter *adapter;
-	struct hdd_adapter *next_adapter;
-	enum bus_bw_level next_vote = BUS_BW_LEVEL_NONE;
-	enum bus_bw_level tmp_vote;
 	struct bbm_context *bbm_ctx = hdd_ctx->bbm_ctx;
 
 	if (tput_level == TPUT_LEVEL_NONE) {
@@ -229,20 +497,20 @@ bbm_apply_tput_policy(struct hdd_context *hdd_ctx, enum tput_level tput_level)
 		 * This is to handle the scenario where bus bw periodic work
 		 * is force cancelled
 		 */
-		if (!hdd_is_any_adapter_connected(hdd_ctx))
-			bbm_ctx->per_policy_vote[BBM_TPUT_POLICY] = next_vote;
+		if (!hdd_is_any_adapter_connected(hdd_ctx)) {
+			bbm_ctx->tput_level = tput_level;
+			bbm_ctx->per_policy_vote[BBM_TPUT_POLICY] =
+							BUS_BW_LEVEL_NONE;
+			bbm_predict_reset(bbm_ctx);
+		}
 		return;
 	}
 
-	hdd_for_each_adapter_dev_held_safe(hdd_ctx, adapter, next_adapter,
-					   NET_DEV_HOLD_BUS_BW_MGR) {
-		tmp_vote = bbm_get_bus_bw_level_vote(adapter, tput_level);
-		if (tmp_vote > next_vote)
-			next_vote = tmp_vote;
-		hdd_adapter_dev_put_debug(adapter, NET_DEV_HOLD_BUS_BW_MGR);
-	}
+	bbm_ctx->tput_level = tput_level;
+	bbm_ctx->per_policy_vote[BBM_TPUT_POLICY] =
+				bbm_get_tput_vote(hdd_ctx, tput_level);
 
-	bbm_ctx->per_policy_vote[BBM_TPUT_POLICY] = next_vote;
+	bbm_apply_predictive_policy(hdd_ctx, true);
 }
 
 /**
@@ -269,6 +537,37 @@ bbm_apply_driver_mode_policy(struct bbm_context *bbm_ctx,
 	}
 }
 
+/**
+ * bbm_record_vote() - Add a bus bw vote change to the vote history
+ * @bbm_ctx: bus bw mgr context
+ * @policy: policy whose evaluation changed the vote
+ * @prev_vote: bus bw level before the change
+ * @next_vote: bus bw level after the change
+ *
+ * Caller holds bbm_lock.
+ *
+ * Returns: None
+ */
+static void bbm_record_vote(struct bbm_context *bbm_ctx,
+			    enum bbm_policy policy,
+			    enum bus_bw_level prev_vote,
+			    enum bus_bw_level next_vote)
+{
+	struct bbm_vote_record *rec;
+
+	rec = &bbm_ctx->vote_history[bbm_ctx->vote_history_idx];
+	rec->qtime = qdf_get_log_timestamp();
+	rec->policy = policy;
+	rec->prev_vote = prev_vote;
+	rec->next_vote = next_vote;
+	rec->tput_level = bbm_ctx->tput_level;
+	rec->pred_level = bbm_predict_get_level(bbm_ctx);
+	rec->pred_src = bbm_predict_get_src(bbm_ctx);
+
+	bbm_ctx->vote_history_idx = (bbm_ctx->vote_history_idx + 1) %
+				    BBM_VOTE_HISTORY_SIZE;
+}
+
 /**
  * bbm_apply_non_persistent_policy() - Apply non persistent policy and set
  *  the bus bandwidth
@@ -281,20 +580,30 @@ static void
 bbm_apply_non_persistent_policy(struct hdd_context *hdd_ctx,
 				enum bbm_non_per_flag flag)
 {
+	struct bbm_context *bbm_ctx = hdd_ctx->bbm_ctx;
+
 	switch (flag) {
 	case BBM_APPS_RESUME:
 		if (hdd_is_any_adapter_connected(hdd_ctx)) {
-			hdd_ctx->bbm_ctx->curr_vote_level = BUS_BW_LEVEL_RESUME;
+			bbm_record_vote(bbm_ctx, BBM_NON_PERSISTENT_POLICY,
+					bbm_ctx->curr_vote_level,
+					BUS_BW_LEVEL_RESUME);
+			bbm_ctx->curr_vote_level = BUS_BW_LEVEL_RESUME;
 			pld_request_bus_bandwidth(hdd_ctx->parent_dev,
 			       bbm_convert_to_pld_bus_lvl(BUS_BW_LEVEL_RESUME));
 		} else {
-			hdd_ctx->bbm_ctx->curr_vote_level = BUS_BW_LEVEL_NONE;
+			bbm_record_vote(bbm_ctx, BBM_NON_PERSISTENT_POLICY,
+					bbm_ctx->curr_vote_level,
+					BUS_BW_LEVEL_NONE);
+			bbm_ctx->curr_vote_level = BUS_BW_LEVEL_NONE;
 			pld_request_bus_bandwidth(hdd_ctx->parent_dev,
 				 bbm_convert_to_pld_bus_lvl(BUS_BW_LEVEL_NONE));
 		}
 		return;
 	case BBM_APPS_SUSPEND:
-		hdd_ctx->bbm_ctx->curr_vote_level = BUS_BW_LEVEL_NONE;
+		bbm_record_vote(bbm_ctx, BBM_NON_PERSISTENT_POLICY,
+				bbm_ctx->curr_vote_level, BUS_BW_LEVEL_NONE);
+		bbm_ctx->curr_vote_level = BUS_BW_LEVEL_NONE;
 		pld_request_bus_bandwidth(hdd_ctx->parent_dev,
 			    bbm_convert_to_pld_bus_lvl(BUS_BW_LEVEL_NONE));
 		return;
@@ -358,11 +667,12 @@ bbm_apply_user_policy(struct bbm_context *bbm_ctx, bool set,
 /**
  * bbm_request_bus_bandwidth() - Set bus bandwidth level
  * @hdd_ctx: HDD context
+ * @policy: policy which triggered the request, for the vote history
  *
  * Returns: None
  */
 static void
-bbm_request_bus_bandwidth(struct hdd_context *hdd_ctx)
+bbm_request_bus_bandwidth(struct hdd_context *hdd_ctx, enum bbm_policy policy)
 {
 	enum bbm_policy i;
 	enum bus_bw_level next_vote = BUS_BW_LEVEL_NONE;
@@ -378,6 +688,8 @@ bbm_request_bus_bandwidth(struct hdd_context *hdd_ctx)
 		pld_vote = bbm_convert_to_pld_bus_lvl(next_vote);
 		hdd_debug("Bus bandwidth vote level change from %d to %d pld_vote: %d",
 			  bbm_ctx->curr_vote_level, next_vote, pld_vote);
+		bbm_record_vote(bbm_ctx, policy, bbm_ctx->curr_vote_level,
+				next_vote);
 		bbm_ctx->curr_vote_level = next_vote;
 		pld_request_bus_bandwidth(hdd_ctx->parent_dev, pld_vote);
 	}
@@ -421,17 +733,52 @@ void hdd_bbm_apply_independent_policy(struct hdd_context *hdd_ctx,
 		if (QDF_IS_STATUS_ERROR(status))
 			goto done;
 		break;
+	case BBM_PREDICTIVE_POLICY:
+		bbm_apply_predictive_policy(hdd_ctx, false);
+		break;
 	default:
 		hdd_debug("BBM policy %d not handled", params->policy);
 		goto done;
 	}
 
-	bbm_request_bus_bandwidth(hdd_ctx);
+	bbm_request_bus_bandwidth(hdd_ctx, params->policy);
 
 done:
 	qdf_mutex_release(&bbm_ctx->bbm_lock);
 }
 
+void hdd_bbm_display_vote_history(struct hdd_context *hdd_ctx)
+{
+	struct bbm_context *bbm_ctx = hdd_ctx->bbm_ctx;
+	struct bbm_vote_record *rec;
+	uint32_t idx;
+	uint32_t i;
+
+	if (!bbm_ctx)
+		return;
+
+	qdf_mutex_acquire(&bbm_ctx->bbm_lock);
+
+	bbm_predict_display(bbm_ctx);
+	hdd_nofl_debug("BBM vote history: [timestamp]: policy, prev -> next, tput level, predicted level, predict src");
+
+	/* oldest record first */
+	idx = bbm_ctx->vote_history_idx;
+	for (i = 0; i < BBM_VOTE_HISTORY_SIZE; i++) {
+		rec = &bbm_ctx->vote_history[idx];
+		idx = (idx + 1) % BBM_VOTE_HISTORY_SIZE;
+		if (!rec->qtime)
+			continue;
+
+		hdd_nofl_debug("[%15llu]: %u, %u -> %u, %u, %u, %u",
+			       rec->qtime, rec->policy, rec->prev_vote,
+			       rec->next_vote, rec->tput_level,
+			       rec->pred_level, rec->pred_src);
+	}
+
+	qdf_mutex_release(&bbm_ctx->bbm_lock);
+}
+
 int hdd_bbm_context_init(struct hdd_context *hdd_ctx)
 {
 	struct bbm_context *bbm_ctx;
@@ -447,10 +794,16 @@ int hdd_bbm_context_init(struct hdd_context *hdd_ctx)
 	if (QDF_IS_STATUS_ERROR(status))
 		goto free_ctx;
 
+	status = bbm_predict_init(hdd_ctx, bbm_ctx);
+	if (QDF_IS_STATUS_ERROR(status))
+		goto destroy_lock;
+
 	hdd_ctx->bbm_ctx = bbm_ctx;
 
 	return 0;
 
+destroy_lock:
+	qdf_mutex_destroy(&bbm_ctx->bbm_lock);
 free_ctx:
 	qdf_mem_free(bbm_ctx);
 
@@ -465,6 +818,7 @@ void hdd_bbm_context_deinit(struct hdd_context *hdd_ctx)
 		return;
 
 	hdd_ctx->bbm_ctx = NULL;
+	bbm_predict_deinit(bbm_ctx);
 	qdf_mutex_destroy(&bbm_ctx->bbm_lock);
 
 	qdf_mem_free(bbm_ctx);
@@ -102,6 +102,9 @@ enum bbm_non_per_flag {
  *  is set without taking other policy vote levels into consideration.
  * @BBM_SELECT_TABLE_POLICY: policy where bus bw table is selected based on
  *  the latency level.
+ * @BBM_PREDICTIVE_POLICY: throughput level predicted from datapath hints
+ *  (ring backlog, aggregate sizes, tx flow control) ahead of the periodic
+ *  throughput sample. Ramps up immediately and decays stepwise.
  */
 enum bbm_policy {
 	BBM_DRIVER_MODE_POLICY,
@@ -109,9 +112,27 @@ enum bbm_policy {
 	BBM_USER_POLICY,
 	BBM_NON_PERSISTENT_POLICY,
 	BBM_SELECT_TABLE_POLICY,
+	BBM_PREDICTIVE_POLICY,
 	BBM_MAX_POLICY,
 };
 
+/**
+ * enum bbm_predict_src - datapath source of a predictive BBM hint
+ *
+ * @BBM_PREDICT_SRC_NONE: no hint
+ * @BBM_PREDICT_SRC_RX_PENDING: frames pending in the DP RX thread queues
+ * @BBM_PREDICT_SRC_RX_AGGR: segments in a receive offload aggregate
+ * @BBM_PREDICT_SRC_TX_FLOW_CTRL: tx queues paused on tx descriptor low
+ *  watermark
+ */
+enum bbm_predict_src {
+	BBM_PREDICT_SRC_NONE,
+	BBM_PREDICT_SRC_RX_PENDING,
+	BBM_PREDICT_SRC_RX_AGGR,
+	BBM_PREDICT_SRC_TX_FLOW_CTRL,
+	BBM_PREDICT_SRC_MAX,
+};
+
 /**
  * enum wlm_ll_level - WLM latency levels
  *
@@ -134,6 +155,9 @@ enum wlm_ll_level {
  * @wlm_level: latency level. valid for BBM_WLM_POLICY.
  * @user_level: user bus bandwidth vote. valid for BBM_USER_POLICY.
  * @set: set or reset user level. valid for BBM_USER_POLICY.
+ *
+ * BBM_PREDICTIVE_POLICY takes no info, the level is built from the hints
+ * posted via hdd_bbm_predict_hint().
  */
 union bbm_policy_info {
 	enum QDF_GLOBAL_MODE driver_mode;
@@ -160,6 +184,67 @@ struct bbm_params {
 typedef const enum bus_bw_level
 	bus_bw_table_type[QCA_WLAN_802_11_MODE_INVALID][TPUT_LEVEL_MAX];
 
+#define BBM_VOTE_HISTORY_SIZE 64
+
+/**
+ * struct bbm_vote_record - one bus bw vote change
+ * @qtime: log timestamp of the change, same clock as the tx/rx histogram
+ * @policy: policy whose evaluation changed the vote
+ * @prev_vote: bus bw level before the change
+ * @next_vote: bus bw level after the change
+ * @tput_level: last level applied by the throughput policy
+ * @pred_level: current level of the predictive policy
+ * @pred_src: hint source which last raised the predictive level
+ */
+struct bbm_vote_record {
+	uint64_t qtime;
+	uint8_t policy;
+	uint8_t prev_vote;
+	uint8_t next_vote;
+	uint8_t tput_level;
+	uint8_t pred_level;
+	uint8_t pred_src;
+};
+
+#ifdef FEATURE_BBM_PREDICTIVE_VOTE
+/* nbuf lists pending in a DP RX thread treated as a ring backlog */
+#define BBM_PREDICT_RX_PENDING_HIGH_WM 1024
+#define BBM_PREDICT_RX_PENDING_LOW_WM 256
+/* Segments per receive offload aggregate */
+#define BBM_PREDICT_RX_AGGR_HIGH_SEGS 32
+#define BBM_PREDICT_RX_AGGR_LOW_SEGS 16
+/* Time a predicted level is held after the last hint backing it */
+#define BBM_PREDICT_HOLD_US (300 * 1000)
+/* Minimum interval between two hints of a source not raising the level */
+#define BBM_PREDICT_HINT_INTERVAL_MS 10
+
+/**
+ * struct bbm_predict - predictive BBM policy state
+ * @hint_map: bitmap of tput levels hinted since the last evaluation, set
+ *  locklessly from the datapath
+ * @hint_src: source of the most recent hint which raised the level
+ * @hint_next: per source, time in ticks before which a hint not raising
+ *  the level is dropped
+ * @level: tput level currently voted by the predictive policy
+ * @src: source of the hint which set @level
+ * @hold_expiry: log timestamp after which @level starts to decay
+ * @work: work evaluating the hints on ramp up, bbm_lock can sleep
+ * @raises: number of immediate ramp ups
+ * @decays: number of decay steps
+ */
+struct bbm_predict {
+	unsigned long hint_map;
+	uint8_t hint_src;
+	qdf_time_t hint_next[BBM_PREDICT_SRC_MAX];
+	enum tput_level level;
+	uint8_t src;
+	uint64_t hold_expiry;
+	qdf_work_t work;
+	uint32_t raises;
+	uint32_t decays;
+};
+#endif
+
 /**
  * struct bbm_context: Bus Bandwidth Manager context
  *
@@ -167,12 +252,22 @@ typedef const enum bus_bw_level
  * @curr_vote_level: current vote level
  * @per_policy_vote: per BBM policy related vote
  * @bbm_lock: BBM API lock
+ * @tput_level: last level applied by the throughput policy
+ * @predict: predictive policy state
+ * @vote_history: ring of bus bw vote changes
+ * @vote_history_idx: next slot to fill in @vote_history
  */
 struct bbm_context {
 	bus_bw_table_type *curr_bus_bw_lookup_table;
 	enum bus_bw_level curr_vote_level;
 	enum bus_bw_level per_policy_vote[BBM_MAX_POLICY];
 	qdf_mutex_t bbm_lock;
+	enum tput_level tput_level;
+#ifdef FEATURE_BBM_PREDICTIVE_VOTE
+	struct bbm_predict predict;
+#endif
+	struct bbm_vote_record vote_history[BBM_VOTE_HISTORY_SIZE];
+	uint32_t vote_history_idx;
 };
 
 #ifdef FEATURE_BUS_BANDWIDTH_MGR
@@ -205,6 +300,14 @@ void hdd_bbm_context_deinit(struct hdd_context *hdd_ctx);
  */
 void hdd_bbm_apply_independent_policy(struct hdd_context *hdd_ctx,
 				      struct bbm_params *params);
+
+/**
+ * hdd_bbm_display_vote_history() - Print the bus bw vote history
+ * @hdd_ctx: HDD context
+ *
+ * Returns: None
+ */
+void hdd_bbm_display_vote_history(struct hdd_context *hdd_ctx);
 #else
 static inline int hdd_bbm_context_init(struct hdd_context *hdd_ctx)
 {
@@ -220,5 +323,35 @@ void hdd_bbm_apply_independent_policy(struct hdd_context *hdd_ctx,
 				      struct bbm_params *params)
 {
 }
+
+static inline void hdd_bbm_display_vote_history(struct hdd_context *hdd_ctx)
+{
+}
+#endif
+
+#if defined(FEATURE_BUS_BANDWIDTH_MGR) && defined(FEATURE_BBM_PREDICTIVE_VOTE)
+/**
+ * hdd_bbm_predict_hint() - Post a datapath load hint to the predictive policy
+ * @hdd_ctx: HDD context
+ * @src: hint source
+ * @metric: source specific load metric, nbuf lists pending in the DP RX
+ *  thread for BBM_PREDICT_SRC_RX_PENDING, segments for
+ *  BBM_PREDICT_SRC_RX_AGGR and unused for BBM_PREDICT_SRC_TX_FLOW_CTRL
+ *
+ * Lockless and callable from softirq. Metrics under the source watermarks are
+ * ignored. A hint above the currently predicted level schedules an immediate
+ * re-vote, other hints only hold the current level against decay and are
+ * rate limited to one per BBM_PREDICT_HINT_INTERVAL_MS per source.
+ *
+ * Returns: None
+ */
+void hdd_bbm_predict_hint(struct hdd_context *hdd_ctx,
+			  enum bbm_predict_src src, uint32_t metric);
+#else
+static inline
+void hdd_bbm_predict_hint(struct hdd_context *hdd_ctx,
+			  enum bbm_predict_src src, uint32_t metric)
+{
+}
 #endif
 #endif
@@ -9121,11 +9121,12 @@ static int hdd_config_total_beacon_miss_count(struct hdd_adapter *adapter,
 static inline
 void wlan_hdd_set_wlm_mode(struct hdd_context *hdd_ctx, uint16_t latency_level)
 {
-	if (latency_level ==
-		QCA_WLAN_VENDOR_ATTR_CONFIG_LATENCY_LEVEL_ULTRALOW)
-		wlan_hdd_set_pm_qos_request(hdd_ctx, true);
-	else
-		wlan_hdd_set_pm_qos_request(hdd_ctx, false);
+	bool ultra_low = latency_level ==
+		QCA_WLAN_VENDOR_ATTR_CONFIG_LATENCY_LEVEL_ULTRALOW;
+
+	wlan_hdd_set_pm_qos_request(hdd_ctx, ultra_low);
+	hif_exec_set_latency_mode(cds_get_context(QDF_MODULE_ID_HIF),
+				  ultra_low);
 }
 #else
 static inline
@@ -11849,6 +11849,8 @@ void wlan_hdd_display_tx_rx_histogram(struct hdd_context *hdd_ctx)
 				       hist->is_tx_pm_qos_high ? "HIGH" : "LOW");
 		}
 	}
+
+	hdd_bbm_display_vote_history(hdd_ctx);
 }
 
 /**
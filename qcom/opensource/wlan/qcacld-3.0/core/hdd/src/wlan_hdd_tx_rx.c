@@ -2140,10 +2140,36 @@ static inline void hdd_tsf_timestamp_rx(struct hdd_context *hdd_ctx,
 }
 #endif
 
+#if defined(FEATURE_BUS_BANDWIDTH_MGR) && defined(FEATURE_BBM_PREDICTIVE_VOTE)
+/**
+ * hdd_rx_thread_predict_hint() - Post the backlog of a DP RX thread to the
+ *  predictive bus bandwidth policy
+ * @hdd_ctx: HDD context
+ * @soc: ol_txrx_soc_handle object
+ * @rx_ctx_id: RX CTX Id of the thread which finished a reap
+ *
+ * Return: None
+ */
+static inline void hdd_rx_thread_predict_hint(struct hdd_context *hdd_ctx,
+					      ol_txrx_soc_handle soc,
+					      int rx_ctx_id)
+{
+	hdd_bbm_predict_hint(hdd_ctx, BBM_PREDICT_SRC_RX_PENDING,
+			     dp_rx_get_thread_pending(soc, rx_ctx_id));
+}
+#else
+static inline void hdd_rx_thread_predict_hint(struct hdd_context *hdd_ctx,
+					      ol_txrx_soc_handle soc,
+					      int rx_ctx_id)
+{
+}
+#endif
+
 QDF_STATUS hdd_rx_thread_gro_flush_ind_cbk(void *adapter, int rx_ctx_id)
 {
 	struct hdd_adapter *hdd_adapter = adapter;
 	enum dp_rx_gro_flush_code gro_flush_code = DP_RX_GRO_NORMAL_FLUSH;
+	ol_txrx_soc_handle soc = cds_get_context(QDF_MODULE_ID_SOC);
 
 	if (qdf_unlikely((!hdd_adapter) || (!hdd_adapter->hdd_ctx))) {
 		hdd_err("Null params being passed");
@@ -2153,13 +2179,15 @@ QDF_STATUS hdd_rx_thread_gro_flush_ind_cbk(void *adapter, int rx_ctx_id)
 	if (hdd_adapter->runtime_disable_rx_thread)
 		return QDF_STATUS_SUCCESS;
 
+	/* end of a reap, rx thread backlog tells how far behind we are */
+	hdd_rx_thread_predict_hint(hdd_adapter->hdd_ctx, soc, rx_ctx_id);
+
 	if (hdd_is_low_tput_gro_enable(hdd_adapter->hdd_ctx)) {
 		hdd_adapter->hdd_stats.tx_rx_stats.rx_gro_flush_skip++;
 		gro_flush_code = DP_RX_GRO_LOW_TPUT_FLUSH;
 	}
 
-	return dp_rx_gro_flush_ind(cds_get_context(QDF_MODULE_ID_SOC),
-				   rx_ctx_id, gro_flush_code);
+	return dp_rx_gro_flush_ind(soc, rx_ctx_id, gro_flush_code);
 }
 
 QDF_STATUS hdd_rx_pkt_thread_enqueue_cbk(void *adapter,
@@ -2471,6 +2499,7 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 	bool is_eapol, send_over_nl;
 	bool is_dhcp;
 	struct hdd_tx_rx_stats *stats;
+	uint16_t gso_segs;
 
 	/* Sanity check on inputs */
 	if (unlikely((!adapter_context) || (!rxBuf))) {
@@ -2597,7 +2626,11 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 		++stats->per_cpu[cpu_index].rx_packets;
 		++adapter->stats.rx_packets;
 		/* count aggregated RX frame into stats */
-		adapter->stats.rx_packets += qdf_nbuf_get_gso_segs(skb);
+		gso_segs = qdf_nbuf_get_gso_segs(skb);
+		adapter->stats.rx_packets += gso_segs;
+		if (gso_segs)
+			hdd_bbm_predict_hint(hdd_ctx, BBM_PREDICT_SRC_RX_AGGR,
+					     gso_segs);
 		adapter->stats.rx_bytes += skb->len;
 
 		/* Incr GW Rx count for NUD tracking based on GW mac addr */
@@ -3005,6 +3038,13 @@ void wlan_hdd_netif_queue_control(struct hdd_adapter *adapter,
 	if (hdd_adapter_is_link_adapter(adapter))
 		return;
 
+	/* tx descriptors ran below the low watermark, the bus is lagging */
+	if (reason == WLAN_DATA_FLOW_CONTROL &&
+	    (action == WLAN_STOP_ALL_NETIF_QUEUE ||
+	     action == WLAN_STOP_NON_PRIORITY_QUEUE))
+		hdd_bbm_predict_hint(adapter->hdd_ctx,
+				     BBM_PREDICT_SRC_TX_FLOW_CTRL, 0);
+
 	switch (action) {
 
 	case WLAN_NETIF_CARRIER_ON:
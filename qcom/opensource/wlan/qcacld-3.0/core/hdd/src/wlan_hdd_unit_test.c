@@ -23,6 +23,7 @@
  * debugfs unit_test_host
  */
 #include "wlan_hdd_main.h"
+#include "dp_rx_defrag_test.h"
 #include "qdf_delayed_work_test.h"
 #include "qdf_hashtable_test.h"
 #include "qdf_periodic_work_test.h"
@@ -35,6 +36,8 @@
 #include "qdf_types_test.h"
 #include "wlan_dsc_test.h"
 #include "wlan_hdd_unit_test.h"
+#include "wlan_scan_db_test.h"
+#include "wlan_scan_ie_test.h"
 
 typedef uint32_t (*hdd_ut_callback)(void);
 
@@ -44,6 +47,7 @@ struct hdd_ut_entry {
 };
 
 struct hdd_ut_entry hdd_ut_entries[] = {
+	{ .name = "dp_rx_defrag", .callback = dp_rx_defrag_unit_test },
 	{ .name = "dsc", .callback = dsc_unit_test },
 	{ .name = "qdf_delayed_work", .callback = qdf_delayed_work_unit_test },
 	{ .name = "qdf_ht", .callback = qdf_ht_unit_test },
@@ -54,6 +58,8 @@ struct hdd_ut_entry hdd_ut_entries[] = {
 	{ .name = "qdf_talloc", .callback = qdf_talloc_unit_test },
 	{ .name = "qdf_tracker", .callback = qdf_tracker_unit_test },
 	{ .name = "qdf_types", .callback = qdf_types_unit_test },
+	{ .name = "scan_db", .callback = wlan_scan_db_unit_test },
+	{ .name = "scan_ie", .callback = wlan_scan_ie_unit_test },
 };
 
 #define hdd_for_each_ut_entry(cursor) \
@@ -268,6 +268,105 @@ struct ath_pktlog_bufhdr {
 	uint32_t version;       /* Set to CUR_PKTLOG_VER */
 };
 
+/*
+ * Ring mode
+ *
+ * When the pktlog proc entry is mmap()ed (read only) the driver stops
+ * using the linear rd_offset/wr_offset scheme and instead writes records
+ * into a ring placed at log_data[]. Writers on any CPU reserve records
+ * without a lock; the reader consumes them directly out of the mapping
+ * without any per record syscall. The ring is only valid while the proc
+ * file descriptor stays open.
+ *
+ * Every record starts with struct ath_pktlog_ring_rec, followed by the
+ * usual struct ath_pktlog_hdr and its payload, so existing pktlog parsers
+ * can be reused on the record body. Records are PKTLOG_RING_ALIGN aligned
+ * and never straddle the end of the ring; the tail is filled with a
+ * PKTLOG_RING_REC_PAD record instead.
+ *
+ * head and tail pack a record sequence number (upper 32 bits) and a free
+ * running byte offset (lower 32 bits); the position inside the ring is
+ * (offset & (size - 1)). tail names the oldest record still in the ring
+ * and is always published before any of the bytes in front of it are
+ * reused. When the ring is full and the oldest record is still being
+ * written, the new record is dropped instead of overwriting it.
+ *
+ * A reader keeps its own pos and expected seq:
+ *
+ *	resync:	t = ring->tail;
+ *		pos = PKTLOG_RING_POS_OFFSET(t);
+ *		seq = PKTLOG_RING_POS_SEQ(t);
+ *	loop:	rec = data + (pos & (size - 1));
+ *		if (rec->seq != seq) or, after rmb(), rec->seq_inv != ~seq
+ *		or rec->flags is BUSY:
+ *			if ((int32_t)(OFFSET(ring->tail) - pos) > 0)
+ *				goto resync;	(lapped)
+ *			wait and retry;		(not written yet)
+ *		rmb(); copy the record; rmb();
+ *		if ((int32_t)(OFFSET(ring->tail) - pos) > 0)
+ *			discard the copy, goto resync;	(overwritten)
+ *		if (!(copied flags & PKTLOG_RING_REC_PAD))
+ *			seq++;
+ *		pos += PKTLOG_RING_REC_SIZE(copied len);
+ *
+ * On 32 bit readers head and tail must be read until two consecutive
+ * reads return the same value. A PAD record carries the seq of the record
+ * that follows it and no data. A jump of the tail seq past the reader's
+ * seq means records were overwritten before the reader got to them;
+ * overwritten and dropped count the records lost to ring wrap and those
+ * dropped because they did not fit or the oldest record was still busy.
+ */
+#define PKTLOG_RING_MAGIC		0x504c5247
+#define PKTLOG_RING_ALIGN		16
+#define PKTLOG_RING_REC_BUSY		0x1
+#define PKTLOG_RING_REC_PAD		0x2
+#define PKTLOG_RING_REC_SIZE(_len) \
+	(((_len) + sizeof(struct ath_pktlog_ring_rec) + \
+	  PKTLOG_RING_ALIGN - 1) & ~(PKTLOG_RING_ALIGN - 1))
+#define PKTLOG_RING_POS(_seq, _offset) \
+	(((uint64_t)(_seq) << 32) | (uint32_t)(_offset))
+#define PKTLOG_RING_POS_SEQ(_pos)	((uint32_t)((_pos) >> 32))
+#define PKTLOG_RING_POS_OFFSET(_pos)	((uint32_t)(_pos))
+
+/**
+ * struct ath_pktlog_ring_rec - ring mode record header
+ * @seq: sequence number of the record, PAD records carry the seq of the
+ *	record that follows them
+ * @len: bytes following this header, excluding alignment padding
+ * @flags: PKTLOG_RING_REC_* flags
+ * @seq_inv: ~@seq, together with @seq it tells a record header apart from
+ *	stale bytes of an older lap
+ */
+struct ath_pktlog_ring_rec {
+	volatile uint32_t seq;
+	uint32_t len;
+	volatile uint32_t flags;
+	uint32_t seq_inv;
+};
+
+/**
+ * struct ath_pktlog_ring - ring mode control block, written by the driver
+ * @magic: PKTLOG_RING_MAGIC while the ring is live, 0 once it is stopped
+ * @data_offset: offset of the ring data from the start of the mapping
+ * @size: size of the ring data in bytes, always a power of two
+ * @dropped: records dropped because they did not fit in the ring or the
+ *	oldest record was still being written
+ * @head: PKTLOG_RING_POS() of the next record to be reserved
+ * @tail: PKTLOG_RING_POS() of the oldest record still in the ring
+ * @overwritten: records overwritten by ring wrap
+ * @reserved: reserved, keeps the block 8 byte aligned
+ */
+struct ath_pktlog_ring {
+	volatile uint32_t magic;
+	uint32_t data_offset;
+	uint32_t size;
+	volatile uint32_t dropped;
+	volatile uint64_t head;
+	volatile uint64_t tail;
+	volatile uint32_t overwritten;
+	uint32_t reserved;
+};
+
 struct ath_pktlog_buf {
 	struct ath_pktlog_bufhdr bufhdr;
 	int32_t rd_offset;
@@ -280,6 +379,15 @@ struct ath_pktlog_buf {
 	uint32_t msg_index;
 	/* Offset for read */
 	loff_t offset;
+	/*
+	 * Ring mode control block, see PKTLOG_RING_MAGIC.
+	 * Layout note: this member was inserted ahead of log_data[], which
+	 * moved log_data by sizeof(struct ath_pktlog_ring). The read() output
+	 * (bufhdr followed by the records) is unchanged, so existing post
+	 * processing scripts are not affected. mmap readers must locate the
+	 * ring data through ring.data_offset, never through offsetof().
+	 */
+	struct ath_pktlog_ring ring;
 	char log_data[0];
 };
 